@@ -0,0 +1,385 @@
+/**
+ * @file benchmarks.cpp
+ * @author Ryan Curtin
+ *
+ * Timed, repeatable workloads for mlpack's hot methods, doubling as a
+ * performance regression gate.  Each benchmark runs several times on
+ * synthetic data generated from a fixed random seed; the best time is
+ * compared against a stored per-machine baseline, and a benchmark slower
+ * than its baseline by more than the allowed tolerance fails the gate, so a
+ * regression shows up here before it shows up in production.  The number of
+ * allocations each benchmark makes is reported alongside the times.
+ *
+ * Baselines are stored in a simple CSV file (machine,benchmark,seconds); the
+ * first run on a machine records them, and --update overwrites them with the
+ * current results.  Build and run with 'make benchmark'.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/profiler.hpp>
+#include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/core/optimizers/lbfgs/test_functions.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+
+#include <cfloat>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+#ifndef _WIN32
+  #include <unistd.h> // gethostname().
+#endif
+
+using namespace mlpack;
+using namespace mlpack::bound;
+using namespace mlpack::tree;
+using namespace mlpack::neighbor;
+using namespace std;
+
+PROGRAM_INFO("MLPACK Benchmark Gate", "This program runs a set of timed "
+    "benchmarks and compares each against a baseline stored for this machine "
+    "in the baseline file.  A benchmark that is slower than its baseline by "
+    "more than the given tolerance fails the gate, and the program exits with "
+    "a nonzero status.  Benchmarks without a stored baseline record one.");
+
+PARAM_STRING("baseline_file", "File holding per-machine benchmark baselines.",
+    "B", "benchmark_baselines.csv");
+PARAM_DOUBLE("tolerance", "Allowed fractional slowdown over the baseline "
+    "before the gate fails.", "t", 0.25);
+PARAM_FLAG("update", "Overwrite the stored baselines with this run's "
+    "results.", "u");
+
+//! Number of allocations made so far; see the operator new overloads below.
+static size_t allocationCount = 0;
+
+// Count allocations made by the benchmarked code.  These overloads are local
+// to the benchmark binary and do not affect the library.
+void* operator new(std::size_t size)
+{
+  ++allocationCount;
+  void* memory = malloc(size);
+  if (memory == NULL)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+  ++allocationCount;
+  void* memory = malloc(size);
+  if (memory == NULL)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void operator delete(void* memory) throw()
+{
+  free(memory);
+}
+
+void operator delete[](void* memory) throw()
+{
+  free(memory);
+}
+
+//! Return the number of seconds the given functor takes, best of three runs
+//! (the best run is the least disturbed by other load on the machine).  The
+//! allocations made by the first run are stored in the given counter.
+template<typename BenchmarkType>
+double TimeBenchmark(BenchmarkType& benchmark, size_t& allocations)
+{
+  double best = DBL_MAX;
+  for (size_t run = 0; run < 3; ++run)
+  {
+    const size_t allocationsBefore = allocationCount;
+    const uint64_t start = util::Profiler::Timestamp();
+    benchmark.Run();
+    const uint64_t stop = util::Profiler::Timestamp();
+
+    if (run == 0)
+      allocations = allocationCount - allocationsBefore;
+
+    const double seconds = (double) (stop - start) * 1e-9;
+    if (seconds < best)
+      best = seconds;
+  }
+
+  return best;
+}
+
+//! Micro-benchmark: HRectBound::MinDistance() between two bounds.
+struct MinDistanceBenchmark
+{
+  HRectBound<2> a;
+  HRectBound<2> b;
+
+  MinDistanceBenchmark() : a(10), b(10)
+  {
+    a |= arma::randu<arma::mat>(10, 100);
+    b |= arma::randu<arma::mat>(10, 100) + 2.0;
+  }
+
+  void Run()
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i < 2000000; ++i)
+      sum += a.MinDistance(b);
+
+    // Keep the loop from being optimized away.
+    if (sum < 0.0)
+      Log::Fatal << "Unreachable." << endl;
+  }
+};
+
+//! Meso-benchmark: kd-tree construction.
+struct TreeBuildBenchmark
+{
+  arma::mat dataset;
+
+  TreeBuildBenchmark() : dataset(arma::randu<arma::mat>(10, 20000)) { }
+
+  void Run()
+  {
+    arma::mat data = dataset; // The build reorders the dataset.
+    BinarySpaceTree<HRectBound<2> > tree(data);
+  }
+};
+
+//! Meso-benchmark: dual-tree k-nearest-neighbor search, 1000 queries.
+struct DualTreeSearchBenchmark
+{
+  arma::mat referenceSet;
+  arma::mat querySet;
+
+  DualTreeSearchBenchmark() :
+      referenceSet(arma::randu<arma::mat>(10, 10000)),
+      querySet(arma::randu<arma::mat>(10, 1000)) { }
+
+  void Run()
+  {
+    AllkNN allknn(referenceSet, querySet);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    allknn.Search(5, neighbors, distances);
+  }
+};
+
+//! Meso-benchmark: one EM pass of GMM fitting.
+struct EMPassBenchmark
+{
+  arma::mat observations;
+
+  EMPassBenchmark() : observations(arma::randn<arma::mat>(5, 2000)) { }
+
+  void Run()
+  {
+    gmm::EMFit<> fitter(1); // A single EM iteration.
+    gmm::GMM<gmm::EMFit<> > gmm(3, 5, fitter);
+    gmm.Estimate(observations);
+  }
+};
+
+//! Meso-benchmark: one Lloyd iteration of k-means.
+struct LloydIterationBenchmark
+{
+  arma::mat dataset;
+
+  LloydIterationBenchmark() : dataset(arma::randu<arma::mat>(10, 10000)) { }
+
+  void Run()
+  {
+    kmeans::KMeans<> k(1); // A single Lloyd iteration.
+    arma::Col<size_t> assignments;
+    k.Cluster(dataset, 10, assignments);
+  }
+};
+
+//! Meso-benchmark: Elkan's triangle-inequality-accelerated k-means, run to
+//! convergence.
+struct ElkanKMeansBenchmark
+{
+  arma::mat dataset;
+
+  ElkanKMeansBenchmark() : dataset(arma::randu<arma::mat>(10, 20000)) { }
+
+  void Run()
+  {
+    kmeans::KMeans<metric::EuclideanDistance, kmeans::RandomPartition,
+        kmeans::MaxVarianceNewCluster, kmeans::ElkanKMeans> k;
+    arma::Col<size_t> assignments;
+    arma::mat centroids;
+    k.Cluster(dataset, 10, assignments, centroids);
+  }
+};
+
+//! Meso-benchmark: L-BFGS on the 100-dimensional generalized Rosenbrock
+//! function.
+struct LBFGSBenchmark
+{
+  void Run()
+  {
+    optimization::test::GeneralizedRosenbrockFunction function(100);
+    optimization::L_BFGS<optimization::test::GeneralizedRosenbrockFunction>
+        lbfgs(function, 10, 10000);
+
+    arma::mat coordinates = function.GetInitialPoint();
+    lbfgs.Optimize(coordinates);
+  }
+};
+
+//! Get a name for this machine, for keying the baseline file.
+string MachineName()
+{
+#ifndef _WIN32
+  char name[256];
+  if (gethostname(name, sizeof(name)) == 0)
+  {
+    name[sizeof(name) - 1] = '\0';
+    return string(name);
+  }
+#else
+  const char* name = getenv("COMPUTERNAME");
+  if (name != NULL)
+    return string(name);
+#endif
+  return string("unknown");
+}
+
+int main(int argc, char* argv[])
+{
+  CLI::ParseCommandLine(argc, argv);
+
+  const string baselineFile = CLI::GetParam<string>("baseline_file");
+  const double tolerance = CLI::GetParam<double>("tolerance");
+  const bool update = CLI::HasParam("update");
+
+  if (tolerance < 0)
+    Log::Fatal << "Tolerance must be non-negative!" << endl;
+
+  math::RandomSeed(12345); // Benchmarks use fixed datasets.
+
+  const string machine = MachineName();
+
+  // Load the baselines for this machine; lines belonging to other machines
+  // are kept so the file can be shared in one place.
+  map<string, double> baselines;
+  vector<string> otherMachineLines;
+  ifstream in(baselineFile.c_str());
+  string line;
+  while (getline(in, line))
+  {
+    const size_t firstComma = line.find(',');
+    const size_t secondComma = line.find(',', firstComma + 1);
+    if (firstComma == string::npos || secondComma == string::npos)
+      continue; // Not a baseline line.
+
+    if (line.substr(0, firstComma) == machine)
+      baselines[line.substr(firstComma + 1, secondComma - firstComma - 1)] =
+          atof(line.c_str() + secondComma + 1);
+    else
+      otherMachineLines.push_back(line);
+  }
+  in.close();
+
+  // Run the benchmarks.
+  vector<string> names;
+  vector<double> times;
+  vector<size_t> allocations;
+  size_t allocs;
+
+  MinDistanceBenchmark minDistance;
+  names.push_back("min_distance");
+  times.push_back(TimeBenchmark(minDistance, allocs));
+  allocations.push_back(allocs);
+
+  TreeBuildBenchmark treeBuild;
+  names.push_back("tree_build");
+  times.push_back(TimeBenchmark(treeBuild, allocs));
+  allocations.push_back(allocs);
+
+  DualTreeSearchBenchmark dualTree;
+  names.push_back("dual_tree_knn");
+  times.push_back(TimeBenchmark(dualTree, allocs));
+  allocations.push_back(allocs);
+
+  EMPassBenchmark emPass;
+  names.push_back("em_pass");
+  times.push_back(TimeBenchmark(emPass, allocs));
+  allocations.push_back(allocs);
+
+  LloydIterationBenchmark lloyd;
+  names.push_back("lloyd_iteration");
+  times.push_back(TimeBenchmark(lloyd, allocs));
+  allocations.push_back(allocs);
+
+  ElkanKMeansBenchmark elkan;
+  names.push_back("kmeans_elkan");
+  times.push_back(TimeBenchmark(elkan, allocs));
+  allocations.push_back(allocs);
+
+  LBFGSBenchmark lbfgs;
+  names.push_back("lbfgs_rosenbrock");
+  times.push_back(TimeBenchmark(lbfgs, allocs));
+  allocations.push_back(allocs);
+
+  // Compare against the baselines and report.  Only times are gated; the
+  // allocation counts are informational.
+  size_t failures = 0;
+  bool baselinesChanged = false;
+  cout << "Benchmark gate for machine '" << machine << "' (tolerance "
+      << (tolerance * 100.0) << "%):" << endl;
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    cout << "  " << names[i] << ": " << times[i] << "s, " << allocations[i]
+        << " allocations";
+
+    if (baselines.count(names[i]) == 0)
+    {
+      cout << " (no baseline; recorded)" << endl;
+      baselines[names[i]] = times[i];
+      baselinesChanged = true;
+    }
+    else if (times[i] > baselines[names[i]] * (1.0 + tolerance))
+    {
+      cout << " REGRESSION (baseline " << baselines[names[i]] << "s)" << endl;
+      ++failures;
+    }
+    else
+    {
+      cout << " ok (baseline " << baselines[names[i]] << "s)" << endl;
+      if (update)
+      {
+        baselines[names[i]] = times[i];
+        baselinesChanged = true;
+      }
+    }
+  }
+
+  // Write the baseline file back if anything changed.
+  if (baselinesChanged)
+  {
+    ofstream out(baselineFile.c_str());
+    if (!out.is_open())
+      Log::Fatal << "Cannot write baseline file '" << baselineFile << "'!"
+          << endl;
+
+    for (size_t i = 0; i < otherMachineLines.size(); ++i)
+      out << otherMachineLines[i] << endl;
+    for (map<string, double>::const_iterator it = baselines.begin();
+        it != baselines.end(); ++it)
+      out << machine << "," << (*it).first << "," << (*it).second << endl;
+
+    cout << "Baselines written to '" << baselineFile << "'." << endl;
+  }
+
+  if (failures > 0)
+  {
+    cout << failures << " benchmark(s) regressed!" << endl;
+    return 1;
+  }
+
+  return 0;
+}
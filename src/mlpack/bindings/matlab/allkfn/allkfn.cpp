@@ -31,14 +31,9 @@ void mexFunction(int nlhs, mxArray *plhs[],
   size_t numPoints = mxGetN(prhs[0]);
   size_t numDimensions = mxGetM(prhs[0]);
 
-  // Create the reference matrix.
-  arma::mat referenceData(numDimensions, numPoints);
-  // setting the values.
-  double * mexDataPoints = mxGetPr(prhs[0]);
-  for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-  {
-    referenceData(i) = mexDataPoints[i];
-  }
+  // Create the reference matrix in one shot.  Building the kd-tree reorders
+  // the columns of the dataset in place, so a private copy is required.
+  arma::mat referenceData(mxGetPr(prhs[0]), numDimensions, numPoints);
 
   // getting the leafsize
   int lsInt = (int) mxGetScalar(prhs[3]);
@@ -52,10 +47,10 @@ void mexFunction(int nlhs, mxArray *plhs[],
   // single mode?
   bool singleMode = (mxGetScalar(prhs[5]) == 1.0);
 
-  // the query matrix
-  double * mexQueryPoints = mxGetPr(prhs[2]);
-  arma::mat queryData;
+  // The query matrix gets the same treatment; when there is no query data
+  // this copies an empty matrix.
   bool hasQueryData = ((mxGetM(prhs[2]) != 0) && (mxGetN(prhs[2]) != 0));
+  arma::mat queryData(mxGetPr(prhs[2]), mxGetM(prhs[2]), mxGetN(prhs[2]));
 
   // Sanity check on k value: must be greater than 0, must be less than the
   // number of reference points.
@@ -105,16 +100,6 @@ void mexFunction(int nlhs, mxArray *plhs[],
 
   if (hasQueryData)
   {
-    // setting the values.
-    mexDataPoints = mxGetPr(prhs[2]);
-    numPoints = mxGetN(prhs[2]);
-    numDimensions = mxGetM(prhs[2]);
-    queryData = arma::mat(numDimensions, numPoints);
-    for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-    {
-      queryData(i) = mexDataPoints[i];
-    }
-
     if (naive && leafSize < queryData.n_cols)
       leafSize = queryData.n_cols;
 
@@ -134,10 +119,18 @@ void mexFunction(int nlhs, mxArray *plhs[],
 
   allkfn->Search(k, neighbors, distances);
 
+  // constructing matrices to return to matlab
+  plhs[0] = mxCreateDoubleMatrix(distances.n_rows, distances.n_cols, mxREAL);
+  plhs[1] = mxCreateDoubleMatrix(neighbors.n_rows, neighbors.n_cols, mxREAL);
+
   // We have to map back to the original indices from before the tree
-  // construction.
-  arma::mat distancesOut(distances.n_rows, distances.n_cols);
-  arma::Mat<size_t> neighborsOut(neighbors.n_rows, neighbors.n_cols);
+  // construction; the results are mapped directly into the MATLAB output
+  // buffers, so no intermediate copy is made.  The neighbor indices are
+  // converted to doubles as they are written.
+  arma::mat distancesOut(mxGetPr(plhs[0]), distances.n_rows, distances.n_cols,
+      false, true);
+  arma::mat neighborsOut(mxGetPr(plhs[1]), neighbors.n_rows, neighbors.n_cols,
+      false, true);
 
   // Do the actual remapping.
   if (hasQueryData)
@@ -173,22 +166,5 @@ void mexFunction(int nlhs, mxArray *plhs[],
   if (queryTree)
     delete queryTree;
 
-  // constructing matrix to return to matlab
-  plhs[0] = mxCreateDoubleMatrix(distances.n_rows, distances.n_cols, mxREAL);
-  plhs[1] = mxCreateDoubleMatrix(neighbors.n_rows, neighbors.n_cols, mxREAL);
-
-  // setting the values
-  double * out = mxGetPr(plhs[0]);
-  for (int i = 0, n = distances.n_rows * distances.n_cols; i < n; ++i)
-  {
-    out[i] = distances(i);
-  }
-  out = mxGetPr(plhs[1]);
-  for (int i = 0, n = neighbors.n_rows * neighbors.n_cols; i < n; ++i)
-  {
-    out[i] = neighbors(i);
-  }
-
-  // More clean up.
   delete allkfn;
 }
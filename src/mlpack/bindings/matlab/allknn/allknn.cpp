@@ -34,14 +34,15 @@ void mexFunction(int nlhs, mxArray *plhs[],
   size_t numPoints = mxGetN(prhs[0]);
   size_t numDimensions = mxGetM(prhs[0]);
 
-  // feeding the referenceData matrix
-  arma::mat referenceData(numDimensions, numPoints);
-  // setting the values.
-  double * mexDataPoints = mxGetPr(prhs[0]);
-  for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-  {
-    referenceData(i) = mexDataPoints[i];
-  }
+  // cover-tree?
+  bool usesCoverTree = (mxGetScalar(prhs[6]) == 1.0);
+
+  // Wrap the reference matrix.  Building a kd-tree reorders the columns of
+  // the dataset in place, so that path needs a private copy (made in one
+  // shot); the cover tree leaves the dataset untouched, so there the MATLAB
+  // memory is used directly and nothing is copied.
+  arma::mat referenceData(mxGetPr(prhs[0]), numDimensions, numPoints,
+      !usesCoverTree, true);
 
   // getting the leafsize
   int lsInt = (int) mxGetScalar(prhs[3]);
@@ -55,13 +56,11 @@ void mexFunction(int nlhs, mxArray *plhs[],
   // single mode?
   bool singleMode = (mxGetScalar(prhs[5]) == 1.0);
 
-  // the query matrix
-  double * mexQueryPoints = mxGetPr(prhs[2]);
-  arma::mat queryData;
+  // The query matrix gets the same treatment as the reference matrix; when
+  // there is no query data this wraps an empty matrix.
   bool hasQueryData = ((mxGetM(prhs[2]) != 0) && (mxGetN(prhs[2]) != 0));
-
-  // cover-tree?
-  bool usesCoverTree = (mxGetScalar(prhs[6]) == 1.0);
+  arma::mat queryData(mxGetPr(prhs[2]), mxGetM(prhs[2]), mxGetN(prhs[2]),
+      !usesCoverTree, true);
 
   // Sanity check on k value: must be greater than 0, must be less than the
   // number of reference points.
@@ -97,7 +96,7 @@ void mexFunction(int nlhs, mxArray *plhs[],
   arma::mat distances;
 
   //if (!CLI::HasParam("cover_tree"))
-  if (usesCoverTree)
+  if (!usesCoverTree)
   {
     // Because we may construct it differently, we need a pointer.
     AllkNN* allknn = NULL;
@@ -117,16 +116,6 @@ void mexFunction(int nlhs, mxArray *plhs[],
 
     if (hasQueryData)
     {
-      // setting the values.
-      mexDataPoints = mxGetPr(prhs[2]);
-      numPoints = mxGetN(prhs[2]);
-      numDimensions = mxGetM(prhs[2]);
-      queryData = arma::mat(numDimensions, numPoints);
-      for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-      {
-        queryData(i) = mexDataPoints[i];
-      }
-
       if (naive && leafSize < queryData.n_cols)
         leafSize = queryData.n_cols;
 
@@ -220,16 +209,6 @@ void mexFunction(int nlhs, mxArray *plhs[],
     // See if we have query data.
     if (hasQueryData)
     {
-      // setting the values.
-      mexDataPoints = mxGetPr(prhs[2]);
-      numPoints = mxGetN(prhs[2]);
-      numDimensions = mxGetM(prhs[2]);
-      queryData = arma::mat(numDimensions, numPoints);
-      for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-      {
-        queryData(i) = mexDataPoints[i];
-      }
-
       // Build query tree.
       if (!singleMode)
       {
@@ -264,13 +243,13 @@ void mexFunction(int nlhs, mxArray *plhs[],
   plhs[0] = mxCreateDoubleMatrix(distances.n_rows, distances.n_cols, mxREAL);
   plhs[1] = mxCreateDoubleMatrix(neighbors.n_rows, neighbors.n_cols, mxREAL);
 
-  // setting the values
-  double * out = mxGetPr(plhs[0]);
-  for (int i = 0, n = distances.n_rows * distances.n_cols; i < n; ++i)
-  {
-    out[i] = distances(i);
-  }
-  out = mxGetPr(plhs[1]);
+  // Copy the distances into the MATLAB buffer in one shot; the neighbor
+  // indices must be converted to doubles one element at a time.
+  arma::mat mexDistances(mxGetPr(plhs[0]), distances.n_rows, distances.n_cols,
+      false, true);
+  mexDistances = distances;
+
+  double * out = mxGetPr(plhs[1]);
   for (int i = 0, n = neighbors.n_rows * neighbors.n_cols; i < n; ++i)
   {
     out[i] = neighbors(i);
@@ -22,13 +22,11 @@ void mexFunction(int nlhs, mxArray *plhs[],
     mexErrMsgTxt("Output required.");
   }
 
-  // loading the data
-  double * mexDataPoints = mxGetPr(prhs[0]);
+  // Load the data in one shot.  PCA overwrites the dataset with the
+  // transformed points, so a private copy is required.
   size_t numPoints = mxGetN(prhs[0]);
   size_t numDimensions = mxGetM(prhs[0]);
-  arma::mat dataset(numDimensions, numPoints);
-  for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-    dataset(i) = mexDataPoints[i];
+  arma::mat dataset(mxGetPr(prhs[0]), numDimensions, numPoints);
 
   // Find out what dimension we want.
   size_t newDimension = dataset.n_rows; // No reduction, by default.
@@ -54,9 +52,10 @@ void mexFunction(int nlhs, mxArray *plhs[],
   PCA p(scale);
   p.Apply(dataset, newDimension);
 
-  // Now returning results to matlab
+  // Now returning results to matlab; the transformed points are copied into
+  // the MATLAB output buffer in one shot.
   plhs[0] = mxCreateDoubleMatrix(dataset.n_rows, dataset.n_cols, mxREAL);
-  double * values = mxGetPr(plhs[0]);
-  for (int i = 0; i < dataset.n_rows * dataset.n_cols; ++i)
-    values[i] = dataset(i);
+  arma::mat output(mxGetPr(plhs[0]), dataset.n_rows, dataset.n_cols,
+      false, true);
+  output = dataset;
 }
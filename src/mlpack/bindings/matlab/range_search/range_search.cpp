@@ -55,17 +55,14 @@ void mexFunction(int nlhs, mxArray *plhs[],
 
   // checking for query data
   bool hasQueryData = ((mxGetM(prhs[3]) != 0) && (mxGetN(prhs[3]) != 0));
-  arma::mat queryData;
 
-  // setting the dataset values.
-  double * mexDataPoints = mxGetPr(prhs[0]);
+  // Create the reference and query matrices in one shot each.  Building the
+  // kd-trees reorders the columns of the datasets in place, so private copies
+  // are required; when there is no query data an empty matrix is copied.
   size_t numPoints = mxGetN(prhs[0]);
   size_t numDimensions = mxGetM(prhs[0]);
-  arma::mat referenceData(numDimensions, numPoints);
-  for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-  {
-    referenceData(i) = mexDataPoints[i];
-  }
+  arma::mat referenceData(mxGetPr(prhs[0]), numDimensions, numPoints);
+  arma::mat queryData(mxGetPr(prhs[3]), mxGetM(prhs[3]), mxGetN(prhs[3]));
 
   //if (!data::Load(referenceFile.c_str(), referenceData))
   //  Log::Fatal << "Reference file " << referenceFile << "not found." << endl;
@@ -131,16 +128,6 @@ void mexFunction(int nlhs, mxArray *plhs[],
     //if (!data::Load(queryFile.c_str(), queryData))
     //  Log::Fatal << "Query file " << queryFile << " not found" << endl;
 
-    // setting the values.
-    mexDataPoints = mxGetPr(prhs[3]);
-    numPoints = mxGetN(prhs[3]);
-    numDimensions = mxGetM(prhs[3]);
-    queryData = arma::mat(numDimensions, numPoints);
-    for (int i = 0, n = numPoints * numDimensions; i < n; ++i)
-    {
-      queryData(i) = mexDataPoints[i];
-    }
-
     if (naive && leafSize < queryData.n_cols)
       leafSize = queryData.n_cols;
 
@@ -146,18 +146,24 @@
 
 // Now the core mlpack classes.
 #include <mlpack/core/util/arma_traits.hpp>
+#include <mlpack/core/util/first_touch.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/ostream_extra.hpp>
+#include <mlpack/core/util/profiler.hpp>
 #include <mlpack/core/data/load.hpp>
 #include <mlpack/core/data/save.hpp>
 #include <mlpack/core/data/normalize_labels.hpp>
+#include <mlpack/core/data/streaming_loader.hpp>
+#include <mlpack/core/data/streaming_writer.hpp>
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/coreset.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/lin_alg.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <mlpack/core/math/round.hpp>
 #include <mlpack/core/util/save_restore_utility.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
 #include <mlpack/core/dists/gaussian_distribution.hpp>
 #include <mlpack/core/dists/laplace_distribution.hpp>
@@ -165,6 +171,8 @@
 // Include kernel traits.
 #include <mlpack/core/kernels/kernel_traits.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/kernels/kernel_matrix_cache.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/cosine_distance.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
@@ -44,6 +44,9 @@ namespace arma {
 
   // inplace_reshape()
   #include "fn_inplace_reshape.hpp"
+
+  // ScratchMat
+  #include "scratch_mat.hpp"
 };
 
 #endif
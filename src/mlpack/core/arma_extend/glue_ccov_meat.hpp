@@ -61,13 +61,16 @@ glue_ccov::direct_ccov(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const u
     }
   else
     {
-    arma_debug_assert_same_size(A, B, "ccov()");
+    arma_debug_check( (A.n_cols != B.n_cols), "ccov(): the number of columns in A and B must match" );
 
     const uword N = A.n_cols;
     const eT norm_val = (norm_type == 0) ? ( (N > 1) ? eT(N-1) : eT(1) ) : eT(N);
 
-    out = A * trans(B);
-    out -= (sum(A) * trans(sum(B))) / eT(N);
+    const Col<eT> A_acc = sum(A, 1);
+    const Col<eT> B_acc = sum(B, 1);
+
+    op_ccov::blocked_cross_product(out, A, B);
+    out -= (A_acc * trans(B_acc)) / eT(N);
     out /= norm_val;
     }
   }
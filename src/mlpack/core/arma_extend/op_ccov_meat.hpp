@@ -21,6 +21,52 @@
 
 
 
+template<typename eT>
+inline
+void
+op_ccov::blocked_cross_product(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B)
+  {
+  arma_extra_debug_sigprint();
+
+  // Accumulate A * B' as a sum of rank-k updates over blocks of columns.
+  // Each thread accumulates blocks into its own partial output, so the
+  // inputs are read exactly once and only the small n_rows x n_rows
+  // partial results are merged at the end.
+  const uword N          = A.n_cols;
+  const uword block_size = 256;
+
+  out.zeros(A.n_rows, B.n_rows);
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+    {
+    Mat<eT> partial(A.n_rows, B.n_rows);
+    partial.zeros();
+
+    // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for(long i = 0; i < (long) N; i += (long) block_size)
+      {
+      const uword first = uword(i);
+      const uword last  = ((first + block_size) < N) ? (first + block_size - 1) : (N - 1);
+
+      partial += A.cols(first, last) * trans(B.cols(first, last));
+      }
+
+#ifdef _OPENMP
+    #pragma omp critical (ccovAccumulate)
+#endif
+      {
+      out += partial;
+      }
+    }
+  }
+
+
+
 template<typename eT>
 inline
 void
@@ -46,7 +92,7 @@ op_ccov::direct_ccov(Mat<eT>& out, const Mat<eT>& A, const uword norm_type)
 
     const Col<eT> acc = sum(A, 1);
 
-    out = A * trans(A);
+    op_ccov::blocked_cross_product(out, A, A);
     out -= (acc * trans(acc)) / eT(N);
     out /= norm_val;
     }
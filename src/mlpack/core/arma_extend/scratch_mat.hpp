@@ -0,0 +1,157 @@
+// ScratchMat: a matrix whose memory comes from a reusable per-thread pool.
+//
+// Hot loops that construct short-lived arma::mat/arma::vec temporaries pay a
+// heap allocation and free on every pass, and in parallel code those calls
+// serialize on the global allocator.  A ScratchMat instead borrows a buffer
+// from a pool owned by the calling thread and wraps it with the advanced
+// no-copy Mat constructor; the buffer goes back to the pool on destruction,
+// so a loop in steady state performs no allocations at all, and threads never
+// contend because no pool is ever shared.
+//
+// Usage, in place of a loop-local temporary:
+//
+//   ScratchMat<double> scratch(dims, points);
+//   arma::mat& tmp = scratch.M;   // Aliases pooled memory; do not resize.
+//
+// The wrapped matrix uses the strict advanced constructor, so any attempt to
+// resize it will throw; scratch buffers are for fixed-size temporaries.
+// Buffers are recycled in LIFO order and grown monotonically, so a pool
+// quickly reaches a steady state sized by the largest temporaries its thread
+// uses.  Each thread's pool is allocated on first use and intentionally never
+// freed (thread-local storage of non-POD types is not portable here); with
+// pooled OpenMP threads this is a constant, bounded cost.
+
+//! \addtogroup scratch_mat
+//! @{
+
+
+
+// Thread-local storage specifier for POD types; without compiler support the
+// pool degrades to a single shared instance, which is only safe serially.
+#if defined(__GNUC__)
+  #define ARMA_EXTEND_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+  #define ARMA_EXTEND_THREAD_LOCAL __declspec(thread)
+#else
+  #define ARMA_EXTEND_THREAD_LOCAL
+#endif
+
+
+
+//! The per-thread free list of scratch buffers.
+template<typename eT>
+class scratch_pool
+  {
+  public:
+
+  //! One pooled buffer; 'capacity' is in elements, not bytes.
+  struct buffer
+    {
+    eT*   memory;
+    uword capacity;
+    };
+
+  //! Get the calling thread's pool, creating it on first use.
+  inline
+  static
+  scratch_pool&
+  get()
+    {
+    static ARMA_EXTEND_THREAD_LOCAL scratch_pool* instance = NULL;
+
+    if(instance == NULL)
+      {
+      instance = new scratch_pool();  // Intentionally never freed.
+      }
+
+    return *instance;
+    }
+
+  //! Take a buffer of at least n_elem elements out of the pool, allocating
+  //! one if nothing in the free list is large enough.
+  inline
+  buffer*
+  acquire(const uword n_elem)
+    {
+    // Prefer the most recently released buffer (LIFO: it is the one most
+    // likely to still be in cache), as long as it is large enough.
+    for(uword i = free_list.size(); i > 0; --i)
+      {
+      if(free_list[i - 1]->capacity >= n_elem)
+        {
+        buffer* out = free_list[i - 1];
+        free_list.erase(free_list.begin() + (i - 1));
+        return out;
+        }
+      }
+
+    buffer* out = new buffer();
+    out->capacity = (std::max)(n_elem, uword(64));
+    out->memory   = new eT[out->capacity];
+    return out;
+    }
+
+  //! Return a buffer to the pool.
+  inline
+  void
+  release(buffer* in)
+    {
+    free_list.push_back(in);
+    }
+
+
+  private:
+
+  std::vector<buffer*> free_list;
+  };
+
+
+
+//! A fixed-size matrix backed by pooled per-thread memory.  See the comments
+//! at the top of this file for usage.
+template<typename eT>
+class ScratchMat
+  {
+  public:
+
+  inline
+  ScratchMat(const uword in_rows, const uword in_cols)
+    : pooled(scratch_pool<eT>::get().acquire(in_rows * in_cols))
+    , M(pooled->memory, in_rows, in_cols, false, true)
+    {
+    }
+
+  inline
+  ~ScratchMat()
+    {
+    scratch_pool<eT>::get().release(pooled);
+    }
+
+  //! Implicit conversion, so a ScratchMat can be passed wherever a Mat is
+  //! expected.
+  inline operator       Mat<eT>&()       { return M; }
+  inline operator const Mat<eT>&() const { return M; }
+
+
+  private:
+
+  //! The borrowed buffer ('pooled' must precede 'M'; M aliases its memory).
+  typename scratch_pool<eT>::buffer* pooled;
+
+
+  public:
+
+  //! The wrapped matrix, aliasing pooled memory; do not resize it.
+  Mat<eT> M;
+
+
+  private:
+
+  //! A scratch matrix owns its buffer until destruction; it cannot be copied.
+  ScratchMat(const ScratchMat&);
+  ScratchMat& operator=(const ScratchMat&);
+  };
+
+
+
+//! @}
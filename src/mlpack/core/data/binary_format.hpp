@@ -0,0 +1,115 @@
+/**
+ * @file binary_format.hpp
+ * @author Ryan Curtin
+ *
+ * Definitions for the mlpack native binary dataset format (.mlb files).  The
+ * format is a small fixed header followed by the raw column-major matrix
+ * payload, so a dataset can be loaded with a single bulk read directly into
+ * its final in-memory layout -- there is no parsing or transposition cost.
+ *
+ * The header layout is:
+ *
+ *  - 4 bytes: magic string "MLPK"
+ *  - u32: format version (currently 1)
+ *  - u32: element type code (see NativeBinaryTypeCode)
+ *  - u64: number of rows (dimensions)
+ *  - u64: number of columns (points)
+ *
+ * followed by (rows * columns) elements in column-major order.  Because the
+ * payload is stored exactly as mlpack holds it in memory (one point per
+ * column), the 'transpose' parameter of data::Load() and data::Save() does
+ * not apply to this format.
+ *
+ * Version 2 of the format stores the payload zlib-compressed.  The header is
+ * the same as above (with the version field set to 2), followed by:
+ *
+ *  - u64: uncompressed bytes per block (the last block may be shorter)
+ *  - u64: number of blocks
+ *  - (number of blocks) u64 values: the compressed size of each block
+ *
+ * and then the concatenated compressed blocks.  The payload is split into
+ * fixed-size blocks that are compressed (and decompressed) independently, so
+ * both directions parallelize across blocks.  Version 2 files can only be
+ * written and read when mlpack is built with zlib (MLPACK_HAS_ZLIB); version
+ * 1 files are always supported.
+ */
+#ifndef __MLPACK_CORE_DATA_BINARY_FORMAT_HPP
+#define __MLPACK_CORE_DATA_BINARY_FORMAT_HPP
+
+#include <mlpack/core/arma_extend/arma_extend.hpp> // Includes Armadillo.
+
+#ifdef MLPACK_HAS_ZLIB
+  #include <zlib.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+//! Magic string at the beginning of a native binary dataset file.
+const char NativeBinaryMagic[4] = { 'M', 'L', 'P', 'K' };
+
+//! Version of the native binary dataset format that we write when the payload
+//! is stored raw.
+const arma::u32 NativeBinaryVersion = 1;
+
+//! Version of the native binary dataset format that we write when the payload
+//! is stored zlib-compressed.
+const arma::u32 NativeBinaryVersionCompressed = 2;
+
+//! Uncompressed bytes per compression block.  Blocks are compressed
+//! independently, so this is also the granularity of parallelism; 1MB costs
+//! little compression ratio while giving plenty of blocks to spread across
+//! threads.
+const arma::u64 NativeBinaryBlockBytes = 1048576;
+
+/**
+ * Map an element type to its code in the native binary format header.  The
+ * unspecialized value of 0 denotes an unsupported element type; loading or
+ * saving such a matrix will fail with an error.
+ */
+template<typename eT>
+struct NativeBinaryTypeCode
+{
+  static const arma::u32 value = 0;
+};
+
+template<>
+struct NativeBinaryTypeCode<double>
+{
+  static const arma::u32 value = 1;
+};
+
+template<>
+struct NativeBinaryTypeCode<float>
+{
+  static const arma::u32 value = 2;
+};
+
+template<>
+struct NativeBinaryTypeCode<int>
+{
+  static const arma::u32 value = 3;
+};
+
+template<>
+struct NativeBinaryTypeCode<unsigned int>
+{
+  static const arma::u32 value = 4;
+};
+
+template<>
+struct NativeBinaryTypeCode<long>
+{
+  static const arma::u32 value = 5;
+};
+
+template<>
+struct NativeBinaryTypeCode<unsigned long>
+{
+  static const arma::u32 value = 6;
+};
+
+}; // namespace data
+}; // namespace mlpack
+
+#endif
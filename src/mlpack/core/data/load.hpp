@@ -32,6 +32,14 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * In addition, the mlpack native binary dataset format (see
+ * binary_format.hpp) is supported, denoted by .mlb.  That format stores the
+ * matrix in mlpack's own column-major orientation, so the 'transpose'
+ * parameter does not apply to it and loading has no parse cost.  Files whose
+ * payload was saved compressed (see data::Save()) are detected and
+ * decompressed transparently; loading them requires mlpack to be built with
+ * zlib.
+ *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
@@ -54,6 +62,47 @@ bool Load(const std::string& filename,
           bool fatal = false,
           bool transpose = true);
 
+/**
+ * Loads a rectangular slab of a named two-dimensional dataset from an HDF5
+ * file.  Only the chunks that overlap the requested slab are read and
+ * decompressed, so a slice of a dataset far larger than RAM can be loaded
+ * without ever touching the rest of the file.
+ *
+ * The row and column ranges are inclusive and refer to the dataset as it is
+ * stored in the file (the row-major view that tools like h5dump present).
+ * With the default 'transpose' value of true, each selected dataset row
+ * becomes one column of the output matrix -- the usual mlpack orientation of
+ * one point per column -- and because that is exactly how a row-major slab
+ * lands in column-major memory, no transposition cost is paid at all.
+ *
+ * The dataset is opened with an enlarged chunk cache so that every chunk the
+ * slab touches is decompressed exactly once, even when the slab cuts across
+ * chunk boundaries.
+ *
+ * If Armadillo was compiled without HDF5 support, this will always fail.
+ *
+ * @param filename Name of the HDF5 file to load from.
+ * @param datasetName Name of the dataset inside the file.
+ * @param matrix Matrix to load the slab into.
+ * @param beginRow First dataset row of the slab (inclusive).
+ * @param endRow Last dataset row of the slab (inclusive).
+ * @param beginCol First dataset column of the slab (inclusive).
+ * @param endCol Last dataset column of the slab (inclusive).
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true (default), dataset rows become matrix columns.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          const std::string& datasetName,
+          arma::Mat<eT>& matrix,
+          const size_t beginRow,
+          const size_t endRow,
+          const size_t beginCol,
+          const size_t endCol,
+          const bool fatal = false,
+          const bool transpose = true);
+
 }; // namespace data
 }; // namespace mlpack
 
@@ -9,13 +9,340 @@
 
 // In case it hasn't already been included.
 #include "load.hpp"
+#include "binary_format.hpp"
 
 #include <algorithm>
+#include <cstdlib>
+#include <vector>
 #include <mlpack/core/util/timers.hpp>
 
 namespace mlpack {
 namespace data {
 
+/**
+ * Parse a CSV file directly into a transposed (column-major) matrix.  The
+ * entire file is read into memory in one call; then each line is parsed
+ * independently -- in parallel, if OpenMP is available -- and written straight
+ * into its final column of the matrix.  This avoids both Armadillo's
+ * single-threaded parser and the intermediate matrix plus trans() copy that
+ * would otherwise double peak memory usage.
+ *
+ * If the file does not look like well-formed numeric CSV (ragged rows, fields
+ * that are not numbers), this returns false and the caller should rewind the
+ * stream and fall back to the Armadillo loader.
+ *
+ * @param stream Stream to read CSV data from, positioned at the beginning.
+ * @param matrix Matrix to store parsed data in (one column per CSV line).
+ */
+template<typename eT>
+bool LoadCSVTransposed(std::fstream& stream, arma::Mat<eT>& matrix)
+{
+  // Read the entire file into memory with a single read.
+  stream.seekg(0, std::ios::end);
+  const std::streampos streamSize = stream.tellg();
+  stream.seekg(0, std::ios::beg);
+  if (streamSize <= 0)
+    return false;
+
+  std::string buffer((size_t) streamSize, '\0');
+  stream.read(&buffer[0], streamSize);
+  if (!stream)
+    return false;
+
+  // Find the extent of each non-empty line, so that lines can be parsed
+  // independently.
+  std::vector<size_t> lineBegin;
+  std::vector<size_t> lineEnd;
+  size_t pos = 0;
+  while (pos < buffer.size())
+  {
+    size_t eol = buffer.find('\n', pos);
+    if (eol == std::string::npos)
+      eol = buffer.size();
+
+    size_t end = eol;
+    if ((end > pos) && (buffer[end - 1] == '\r')) // Strip DOS line endings.
+      --end;
+
+    if (end > pos)
+    {
+      lineBegin.push_back(pos);
+      lineEnd.push_back(end);
+    }
+
+    pos = eol + 1;
+  }
+
+  if (lineBegin.empty())
+    return false;
+
+  // The first line determines the dimensionality.
+  size_t dims = 1;
+  for (size_t i = lineBegin[0]; i < lineEnd[0]; ++i)
+    if (buffer[i] == ',')
+      ++dims;
+
+  // Each CSV line becomes one column of the transposed matrix, so the parsed
+  // values land directly in their final memory locations.
+  const size_t points = lineBegin.size();
+  matrix.set_size(dims, points);
+
+  bool failed = false;
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+  #endif
+  for (long col = 0; col < (long) points; ++col)
+  {
+    const char* ptr = buffer.c_str() + lineBegin[col];
+    const char* const end = buffer.c_str() + lineEnd[col];
+
+    size_t row = 0;
+    while (row < dims)
+    {
+      char* next;
+      const double value = strtod(ptr, &next);
+      if (next == ptr || next > end) // Not a number, or ran past the line.
+        break;
+
+      matrix(row, (size_t) col) = (eT) value;
+      ++row;
+
+      // Skip the delimiter and any surrounding whitespace.
+      ptr = next;
+      while ((ptr < end) &&
+          ((*ptr == ',') || (*ptr == ' ') || (*ptr == '\t')))
+        ++ptr;
+    }
+
+    // A ragged or non-numeric row means we cannot use the fast path.  All
+    // racing writes store the same value, so no synchronization is needed.
+    if ((row != dims) || (ptr != end))
+      failed = true;
+  }
+
+  return !failed;
+}
+
+/**
+ * Load a matrix from a file in the mlpack native binary format (see
+ * binary_format.hpp).  The header is validated, then the column-major payload
+ * is read with a single bulk read() directly into the final matrix layout, so
+ * there is no parse or transposition cost at all.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the data into.
+ * @param fatal If true, an error terminates the program.
+ */
+template<typename eT>
+bool LoadNativeBinary(const std::string& filename,
+                      arma::Mat<eT>& matrix,
+                      const bool fatal)
+{
+  std::ifstream stream(filename.c_str(),
+      std::ifstream::in | std::ifstream::binary);
+  if (!stream.is_open())
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "'; load failed."
+          << std::endl;
+
+    return false;
+  }
+
+  // Read and validate the header.
+  char magic[4];
+  arma::u32 version;
+  arma::u32 typeCode;
+  arma::u64 rows;
+  arma::u64 cols;
+  stream.read(magic, 4);
+  stream.read((char*) &version, sizeof(version));
+  stream.read((char*) &typeCode, sizeof(typeCode));
+  stream.read((char*) &rows, sizeof(rows));
+  stream.read((char*) &cols, sizeof(cols));
+
+  bool headerOk = stream.good();
+  if (headerOk)
+    headerOk = (magic[0] == NativeBinaryMagic[0]) &&
+               (magic[1] == NativeBinaryMagic[1]) &&
+               (magic[2] == NativeBinaryMagic[2]) &&
+               (magic[3] == NativeBinaryMagic[3]) &&
+               ((version == NativeBinaryVersion) ||
+                (version == NativeBinaryVersionCompressed));
+
+  if (!headerOk)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "'" << filename << "' is not an mlpack binary dataset "
+          << "file!" << std::endl;
+    else
+      Log::Warn << "'" << filename << "' is not an mlpack binary dataset "
+          << "file; load failed." << std::endl;
+
+    return false;
+  }
+
+  if (typeCode != NativeBinaryTypeCode<eT>::value)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Element type of '" << filename << "' (code " << typeCode
+          << ") does not match the matrix element type (code "
+          << NativeBinaryTypeCode<eT>::value << ")!" << std::endl;
+    else
+      Log::Warn << "Element type of '" << filename << "' (code " << typeCode
+          << ") does not match the matrix element type (code "
+          << NativeBinaryTypeCode<eT>::value << "); load failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Loading '" << filename << "' as mlpack binary dataset.  "
+      << std::flush;
+
+  matrix.set_size((size_t) rows, (size_t) cols);
+
+  if (version == NativeBinaryVersion)
+  {
+    // The payload is already in its final layout; read it in one call.
+    stream.read((char*) matrix.memptr(),
+        (std::streamsize) (matrix.n_elem * sizeof(eT)));
+  }
+  else
+  {
+#ifndef MLPACK_HAS_ZLIB
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "'" << filename << "' is compressed, but mlpack was "
+          << "built without zlib support!" << std::endl;
+    else
+      Log::Warn << "'" << filename << "' is compressed, but mlpack was built "
+          << "without zlib support; load failed." << std::endl;
+
+    return false;
+#else
+    // Read the compression header and the block size table.
+    arma::u64 blockBytes;
+    arma::u64 numBlocks;
+    stream.read((char*) &blockBytes, sizeof(blockBytes));
+    stream.read((char*) &numBlocks, sizeof(numBlocks));
+
+    const arma::u64 payloadBytes = (arma::u64) matrix.n_elem * sizeof(eT);
+    bool tableOk = stream.good() && (blockBytes > 0) &&
+        (numBlocks == ((payloadBytes + blockBytes - 1) / blockBytes));
+
+    std::vector<arma::u64> blockSizes((size_t) numBlocks);
+    std::vector<arma::u64> blockOffsets((size_t) numBlocks);
+    arma::u64 compressedBytes = 0;
+    if (tableOk)
+    {
+      for (size_t i = 0; i < (size_t) numBlocks; ++i)
+      {
+        stream.read((char*) &blockSizes[i], sizeof(blockSizes[i]));
+        blockOffsets[i] = compressedBytes;
+        compressedBytes += blockSizes[i];
+      }
+
+      tableOk = stream.good();
+    }
+
+    if (!tableOk)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "The compression header of '" << filename << "' is "
+            << "corrupt!" << std::endl;
+      else
+        Log::Warn << "The compression header of '" << filename << "' is "
+            << "corrupt; load failed." << std::endl;
+
+      return false;
+    }
+
+    // Read all of the compressed blocks with one bulk read, then decompress
+    // them in parallel straight into their final positions in the matrix.
+    std::vector<unsigned char> compressed((size_t) compressedBytes);
+    if (compressedBytes > 0)
+      stream.read((char*) &compressed[0], (std::streamsize) compressedBytes);
+
+    if (!stream)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Loading from '" << filename << "' failed; the file is "
+            << "truncated." << std::endl;
+      else
+        Log::Warn << "Loading from '" << filename << "' failed; the file is "
+            << "truncated." << std::endl;
+
+      return false;
+    }
+
+    const unsigned char* compressedPtr =
+        (compressedBytes > 0) ? &compressed[0] : NULL;
+    unsigned char* payload = (unsigned char*) matrix.memptr();
+    int failures = 0;
+
+    // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+#endif
+    for (long i = 0; i < (long) numBlocks; ++i)
+    {
+      const arma::u64 offset = (arma::u64) i * blockBytes;
+      const arma::u64 rawBytes = ((payloadBytes - offset) < blockBytes) ?
+          (payloadBytes - offset) : blockBytes;
+
+      uLongf destBytes = (uLongf) rawBytes;
+      if ((uncompress((Bytef*) (payload + offset), &destBytes,
+          (const Bytef*) (compressedPtr + blockOffsets[i]),
+          (uLong) blockSizes[i]) != Z_OK) || (destBytes != (uLongf) rawBytes))
+        ++failures;
+    }
+
+    if (failures > 0)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Decompression of '" << filename << "' failed; the "
+            << "file is corrupt!" << std::endl;
+      else
+        Log::Warn << "Decompression of '" << filename << "' failed; the file "
+            << "is corrupt.  Load failed." << std::endl;
+
+      return false;
+    }
+#endif
+  }
+
+  if (!stream)
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Loading from '" << filename << "' failed; the file is "
+          << "truncated." << std::endl;
+    else
+      Log::Warn << "Loading from '" << filename << "' failed; the file is "
+          << "truncated." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ".\n";
+
+  Timer::Stop("loading_data");
+  return true;
+}
+
 template<typename eT>
 bool Load(const std::string& filename,
           arma::Mat<eT>& matrix,
@@ -44,6 +371,12 @@ bool Load(const std::string& filename,
   std::transform(extension.begin(), extension.end(), extension.begin(),
       ::tolower);
 
+  // The mlpack native binary format has its own load path, since it does not
+  // go through Armadillo at all.  The payload is stored in mlpack's own
+  // column-major orientation, so the transpose parameter does not apply.
+  if (extension == "mlb")
+    return LoadNativeBinary(filename, matrix, fatal);
+
   // Catch nonexistent files by opening the stream ourselves.
   std::fstream stream;
   stream.open(filename.c_str(), std::fstream::in);
@@ -201,7 +534,28 @@ bool Load(const std::string& filename,
     Log::Info << "Loading '" << filename << "' as " << stringType << ".  "
         << std::flush;
 
-  const bool success = matrix.load(stream, loadType);
+  bool success;
+  bool transposed = false; // True if the loader produced column-major output.
+  if ((loadType == arma::csv_ascii) && transpose)
+  {
+    // Parse the CSV directly into the final transposed layout, avoiding the
+    // intermediate matrix and the full-matrix trans() copy below.
+    success = LoadCSVTransposed(stream, matrix);
+    if (success)
+    {
+      transposed = true;
+    }
+    else
+    {
+      // The fast parser rejected the file; Armadillo's parser is more lenient
+      // (e.g. it accepts empty fields), so rewind and let it try.
+      stream.clear();
+      stream.seekg(0, std::ios::beg);
+      success = matrix.load(stream, loadType);
+    }
+  }
+  else
+    success = matrix.load(stream, loadType);
 
   if (!success)
   {
@@ -215,11 +569,15 @@ bool Load(const std::string& filename,
     return false;
   }
   else
-    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
-        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
-
-  // Now transpose the matrix, if necessary.
-  if (transpose)
+    Log::Info << "Size is "
+        << ((transpose && !transposed) ? matrix.n_cols : matrix.n_rows)
+        << " x "
+        << ((transpose && !transposed) ? matrix.n_rows : matrix.n_cols)
+        << ".\n";
+
+  // Now transpose the matrix, if necessary (and if the loader did not already
+  // produce transposed output).
+  if (transpose && !transposed)
     matrix = trans(matrix);
 
   Timer::Stop("loading_data");
@@ -228,6 +586,151 @@ bool Load(const std::string& filename,
   return success;
 }
 
+template<typename eT>
+bool Load(const std::string& filename,
+          const std::string& datasetName,
+          arma::Mat<eT>& matrix,
+          const size_t beginRow,
+          const size_t endRow,
+          const size_t beginCol,
+          const size_t endCol,
+          const bool fatal,
+          const bool transpose)
+{
+#ifndef ARMA_USE_HDF5
+  if (fatal)
+    Log::Fatal << "Attempted to load dataset '" << datasetName << "' from '"
+        << filename << "', but Armadillo was compiled without HDF5 support.  "
+        << "Load failed." << std::endl;
+  else
+    Log::Warn << "Attempted to load dataset '" << datasetName << "' from '"
+        << filename << "', but Armadillo was compiled without HDF5 support.  "
+        << "Load failed." << std::endl;
+
+  return false;
+#else
+  // Invalid ranges are a programming error, not a data error.
+  if ((endRow < beginRow) || (endCol < beginCol))
+    Log::Fatal << "data::Load(): invalid slab; end of range is before "
+        << "beginning of range!" << std::endl;
+
+  Timer::Start("loading_data");
+
+  hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (file < 0)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "'; load failed."
+          << std::endl;
+
+    return false;
+  }
+
+  // Open the dataset with an enlarged chunk cache (64 MB), so that every
+  // chunk the slab touches is decompressed exactly once even when the slab
+  // cuts across chunk boundaries.  The HDF5 default of 1 MB can cause the
+  // same chunk to be evicted and decompressed repeatedly for wide slabs.
+  hid_t accessPlist = H5Pcreate(H5P_DATASET_ACCESS);
+  H5Pset_chunk_cache(accessPlist, 10007, 64 * 1024 * 1024, 1.0);
+
+  hid_t dataset = H5Dopen(file, datasetName.c_str(), accessPlist);
+  if (dataset < 0)
+  {
+    H5Pclose(accessPlist);
+    H5Fclose(file);
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot open dataset '" << datasetName << "' in file '"
+          << filename << "'!" << std::endl;
+    else
+      Log::Warn << "Cannot open dataset '" << datasetName << "' in file '"
+          << filename << "'; load failed." << std::endl;
+
+    return false;
+  }
+
+  hid_t fileSpace = H5Dget_space(dataset);
+  hsize_t dims[2] = { 0, 0 };
+  bool extentOk = (H5Sget_simple_extent_ndims(fileSpace) == 2);
+  if (extentOk)
+  {
+    H5Sget_simple_extent_dims(fileSpace, dims, NULL);
+    extentOk = (endRow < dims[0]) && (endCol < dims[1]);
+  }
+
+  if (!extentOk)
+  {
+    H5Sclose(fileSpace);
+    H5Dclose(dataset);
+    H5Pclose(accessPlist);
+    H5Fclose(file);
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Requested slab (rows " << beginRow << "-" << endRow
+          << ", columns " << beginCol << "-" << endCol << ") does not fit in "
+          << "dataset '" << datasetName << "', which is two-dimensional with "
+          << "size " << dims[0] << " x " << dims[1] << "!" << std::endl;
+    else
+      Log::Warn << "Requested slab (rows " << beginRow << "-" << endRow
+          << ", columns " << beginCol << "-" << endCol << ") does not fit in "
+          << "dataset '" << datasetName << "', which is two-dimensional with "
+          << "size " << dims[0] << " x " << dims[1] << "; load failed."
+          << std::endl;
+
+    return false;
+  }
+
+  // Select the slab in the file, and describe the matching memory layout.
+  hsize_t offset[2] = { beginRow, beginCol };
+  hsize_t count[2] = { endRow - beginRow + 1, endCol - beginCol + 1 };
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL, count, NULL);
+  hid_t memSpace = H5Screate_simple(2, count, NULL);
+
+  // A row-major slab of r rows and c columns, read contiguously, is exactly a
+  // column-major c x r matrix: dataset row i lands in matrix column i.  So
+  // the slab is read directly into its final (transposed) layout.
+  matrix.set_size((size_t) count[1], (size_t) count[0]);
+
+  hid_t memType = arma::hdf5_misc::get_hdf5_type<eT>();
+  herr_t status = H5Dread(dataset, memType, memSpace, fileSpace, H5P_DEFAULT,
+      matrix.memptr());
+  H5Tclose(memType);
+
+  H5Sclose(memSpace);
+  H5Sclose(fileSpace);
+  H5Dclose(dataset);
+  H5Pclose(accessPlist);
+  H5Fclose(file);
+
+  if (status < 0)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Reading slab from '" << filename << "' failed."
+          << std::endl;
+    else
+      Log::Warn << "Reading slab from '" << filename << "' failed."
+          << std::endl;
+
+    return false;
+  }
+
+  // If the dataset's own orientation was requested, undo the free transpose.
+  if (!transpose)
+    matrix = trans(matrix);
+
+  Log::Info << "Loaded slab of dataset '" << datasetName << "' from '"
+      << filename << "'.  Size is " << matrix.n_rows << " x " << matrix.n_cols
+      << ".\n";
+
+  Timer::Stop("loading_data");
+  return true;
+#endif
+}
+
 }; // namespace data
 }; // namespace mlpack
 
@@ -10,6 +10,7 @@
 #define __MLPACK_CORE_DATA_NORMALIZE_LABELS_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <boost/unordered_map.hpp>
 
 namespace mlpack {
 namespace data {
@@ -18,16 +19,27 @@ namespace data {
  * Given a set of labels of a particular datatype, convert them to unsigned
  * labels in the range [0, n) where n is the number of different labels.  Also,
  * a reverse mapping from the new label to the old value is stored in the
- * 'mapping' vector.
+ * 'mapping' vector.  Each label is resolved with a single hash lookup, so the
+ * pass is linear in the number of points even when the number of distinct
+ * labels is very large.
+ *
+ * If 'extend' is set to true, any labels already present in 'mapping' keep
+ * their existing unsigned values and only unseen labels are appended.  This
+ * allows several label vectors (such as a training and a test set) to share
+ * one dictionary: normalize the first with 'extend' left false, then pass the
+ * resulting mapping back in with 'extend' set to true for the others.
  *
  * @param labelsIn Input labels of arbitrary datatype.
  * @param labels Vector that unsigned labels will be stored in.
  * @param mapping Reverse mapping to convert new labels back to old labels.
+ * @param extend If true, reuse and extend an existing mapping instead of
+ *     building a new one (default false).
  */
 template<typename eT>
 void NormalizeLabels(const arma::Col<eT>& labelsIn,
                      arma::Col<size_t>& labels,
-                     arma::Col<eT>& mapping);
+                     arma::Col<eT>& mapping,
+                     const bool extend = false);
 
 /**
  * Given a set of labels that have been mapped to the range [0, n), map them
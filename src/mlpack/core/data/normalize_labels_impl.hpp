@@ -23,39 +23,51 @@ namespace data {
  * @param labelsIn Input labels of arbitrary datatype.
  * @param labels Vector that unsigned labels will be stored in.
  * @param mapping Reverse mapping to convert new labels back to old labels.
+ * @param extend If true, reuse and extend an existing mapping instead of
+ *     building a new one.
  */
 template<typename eT>
 void NormalizeLabels(const arma::Col<eT>& labelsIn,
                      arma::Col<size_t>& labels,
-                     arma::Col<eT>& mapping)
+                     arma::Col<eT>& mapping,
+                     const bool extend)
 {
-  // Loop over the input labels, and develop the mapping.  We'll first naively
-  // resize the mapping to the maximum possible size, and then when we fill it,
-  // we'll resize it back down to its actual size.
-  mapping.set_size(labelsIn.n_elem);
+  if (!extend)
+    mapping.set_size(0);
+
+  // Build a hash table from label value to unsigned label, seeded with any
+  // existing mapping, so that each input label is resolved with one lookup
+  // instead of a linear scan over the labels seen so far.
+  boost::unordered_map<eT, size_t> lookup;
+  lookup.rehash(mapping.n_elem + labelsIn.n_elem);
+  for (size_t j = 0; j < mapping.n_elem; ++j)
+    lookup[mapping[j]] = j;
+
+  // We'll first naively resize the mapping to the maximum possible size, and
+  // then when we fill it, we'll resize it back down to its actual size.
+  const size_t oldLabels = mapping.n_elem;
+  mapping.resize(oldLabels + labelsIn.n_elem);
   labels.set_size(labelsIn.n_elem);
-  size_t curLabel = 0;
+
+  size_t curLabel = oldLabels;
   for (size_t i = 0; i < labelsIn.n_elem; ++i)
   {
-    bool found = false;
-    for (size_t j = 0; j < curLabel; ++j)
-    {
-      // Is the label already in the list of labels we have seen?
-      if (labelsIn[i] == mapping[j])
-      {
-        labels[i] = j;
-        found = true;
-        break;
-      }
-    }
+    // insert() hashes once and tells us whether the label was new; if it was
+    // already present, the iterator points at its existing unsigned label.
+    std::pair<typename boost::unordered_map<eT, size_t>::iterator, bool>
+        result = lookup.insert(std::make_pair(labelsIn[i], curLabel));
 
-    // Do we need to add this new label?
-    if (!found)
+    if (result.second)
     {
+      // This is a label we haven't seen before.
       mapping[curLabel] = labelsIn[i];
       labels[i] = curLabel;
       ++curLabel;
     }
+    else
+    {
+      labels[i] = (*result.first).second;
+    }
   }
 
   // Resize mapping back down to necessary size.
@@ -76,9 +88,14 @@ void RevertLabels(const arma::Col<size_t>& labels,
                   arma::Col<eT>& labelsOut)
 {
   // We already have the mapping, so we just need to loop over each element.
+  // The iterations are independent, so for large label vectors the gather can
+  // be spread across threads.  The loop index is signed for OpenMP.
   labelsOut.set_size(labels.n_elem);
 
-  for (size_t i = 0; i < labels.n_elem; ++i)
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long i = 0; i < (long) labels.n_elem; ++i)
     labelsOut[i] = mapping[labels[i]];
 }
 
@@ -32,6 +32,17 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
  *
+ * In addition, the mlpack native binary dataset format (see
+ * binary_format.hpp) is supported, denoted by .mlb.  That format stores the
+ * matrix in mlpack's own column-major orientation, so the 'transpose'
+ * parameter does not apply to it and a later load has no parse cost.  When
+ * mlpack is built with zlib, the 'compressionLevel' parameter selects
+ * transparent compression of the payload: 0 (the default) stores it raw, and
+ * 1 through 9 are zlib levels trading compression speed for size.  The
+ * payload is compressed block-wise in parallel, and data::Load() detects and
+ * decompresses such files automatically.  Compression is silently ignored for
+ * the other (Armadillo-backed) formats.
+ *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, an error will cause the program to
  * exit.  If the 'transpose' parameter is set to true, the matrix will be
@@ -43,13 +54,16 @@ namespace data /** Functions to load and save matrices. */ {
  * @param matrix Matrix to save into file.
  * @param fatal If an error should be reported as fatal (default false).
  * @param transpose If true, transpose the matrix before saving.
+ * @param compressionLevel zlib compression level (1-9) for the mlpack binary
+ *     dataset format, or 0 for no compression (default 0).
  * @return Boolean value indicating success or failure of save.
  */
 template<typename eT>
 bool Save(const std::string& filename,
           const arma::Mat<eT>& matrix,
           bool fatal = false,
-          bool transpose = true);
+          bool transpose = true,
+          const size_t compressionLevel = 0);
 
 }; // namespace data
 }; // namespace mlpack
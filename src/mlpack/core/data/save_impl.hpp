@@ -9,15 +9,178 @@
 
 // In case it hasn't already been included.
 #include "save.hpp"
+#include "binary_format.hpp"
 
 namespace mlpack {
 namespace data {
 
+/**
+ * Save a matrix to a file in the mlpack native binary format (see
+ * binary_format.hpp): a small header, then the raw column-major payload
+ * written with a single bulk write().  The matrix is stored exactly as held
+ * in memory (one point per column), so it can later be loaded with zero parse
+ * cost and no transposition.
+ *
+ * If a nonzero compression level is given and mlpack is built with zlib, the
+ * payload is instead split into fixed-size blocks which are zlib-compressed
+ * in parallel (version 2 of the format).  Without zlib a warning is given and
+ * the matrix is saved uncompressed.
+ *
+ * @param filename Name of the file to save to.
+ * @param matrix Matrix to save.
+ * @param fatal If true, an error terminates the program.
+ * @param compressionLevel zlib compression level (1-9), or 0 to store the
+ *     payload raw.
+ */
+template<typename eT>
+bool SaveNativeBinary(const std::string& filename,
+                      const arma::Mat<eT>& matrix,
+                      const bool fatal,
+                      const size_t compressionLevel = 0)
+{
+  size_t level = compressionLevel;
+#ifndef MLPACK_HAS_ZLIB
+  if (level > 0)
+  {
+    Log::Warn << "data::Save(): mlpack was built without zlib support; "
+        << "saving '" << filename << "' uncompressed." << std::endl;
+    level = 0;
+  }
+#endif
+
+  if (NativeBinaryTypeCode<eT>::value == 0)
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "The matrix element type is not supported by the mlpack "
+          << "binary dataset format.  Save failed." << std::endl;
+    else
+      Log::Warn << "The matrix element type is not supported by the mlpack "
+          << "binary dataset format; save failed." << std::endl;
+
+    return false;
+  }
+
+  std::ofstream stream(filename.c_str(),
+      std::ofstream::out | std::ofstream::binary);
+  if (!stream.is_open())
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "' for writing. "
+          << "Save failed." << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "' for writing; save "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Saving mlpack binary dataset to '" << filename << "'."
+      << std::endl;
+
+  const arma::u32 version = (level > 0) ? NativeBinaryVersionCompressed :
+      NativeBinaryVersion;
+  const arma::u32 typeCode = NativeBinaryTypeCode<eT>::value;
+  const arma::u64 rows = matrix.n_rows;
+  const arma::u64 cols = matrix.n_cols;
+
+  stream.write(NativeBinaryMagic, 4);
+  stream.write((const char*) &version, sizeof(version));
+  stream.write((const char*) &typeCode, sizeof(typeCode));
+  stream.write((const char*) &rows, sizeof(rows));
+  stream.write((const char*) &cols, sizeof(cols));
+
+  if (level == 0)
+  {
+    stream.write((const char*) matrix.memptr(),
+        (std::streamsize) (matrix.n_elem * sizeof(eT)));
+  }
+#ifdef MLPACK_HAS_ZLIB
+  else
+  {
+    // Split the payload into fixed-size blocks and compress each block
+    // independently; since the blocks don't depend on each other, the
+    // compression parallelizes across them.
+    const arma::u64 payloadBytes = (arma::u64) matrix.n_elem * sizeof(eT);
+    const arma::u64 blockBytes = NativeBinaryBlockBytes;
+    const arma::u64 numBlocks = (payloadBytes + blockBytes - 1) / blockBytes;
+
+    const unsigned char* payload = (const unsigned char*) matrix.memptr();
+    std::vector<std::vector<unsigned char> > blocks((size_t) numBlocks);
+    int failures = 0;
+
+    // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+#endif
+    for (long i = 0; i < (long) numBlocks; ++i)
+    {
+      const arma::u64 offset = (arma::u64) i * blockBytes;
+      const arma::u64 rawBytes = ((payloadBytes - offset) < blockBytes) ?
+          (payloadBytes - offset) : blockBytes;
+
+      uLongf compressedBytes = compressBound((uLong) rawBytes);
+      blocks[i].resize((size_t) compressedBytes);
+
+      if (compress2((Bytef*) &blocks[i][0], &compressedBytes,
+          (const Bytef*) (payload + offset), (uLong) rawBytes,
+          (int) level) == Z_OK)
+        blocks[i].resize((size_t) compressedBytes);
+      else
+        ++failures;
+    }
+
+    if (failures > 0)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << "Compression of '" << filename << "' failed."
+            << std::endl;
+      else
+        Log::Warn << "Compression of '" << filename << "' failed; save "
+            << "failed." << std::endl;
+
+      return false;
+    }
+
+    // Write the compression header and the block size table, then the blocks
+    // themselves.
+    stream.write((const char*) &blockBytes, sizeof(blockBytes));
+    stream.write((const char*) &numBlocks, sizeof(numBlocks));
+    for (size_t i = 0; i < (size_t) numBlocks; ++i)
+    {
+      const arma::u64 blockSize = (arma::u64) blocks[i].size();
+      stream.write((const char*) &blockSize, sizeof(blockSize));
+    }
+
+    for (size_t i = 0; i < (size_t) numBlocks; ++i)
+      stream.write((const char*) &blocks[i][0],
+          (std::streamsize) blocks[i].size());
+  }
+#endif
+
+  if (!stream)
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
 template<typename eT>
 bool Save(const std::string& filename,
           const arma::Mat<eT>& matrix,
           bool fatal,
-          bool transpose)
+          bool transpose,
+          const size_t compressionLevel)
 {
   Timer::Start("saving_data");
 
@@ -39,6 +202,18 @@ bool Save(const std::string& filename,
   // Get the actual extension.
   std::string extension = filename.substr(ext + 1);
 
+  // The mlpack native binary format has its own save path, since it does not
+  // go through Armadillo at all.  The payload is stored in mlpack's own
+  // column-major orientation, so the transpose parameter does not apply.
+  if (extension == "mlb")
+    return SaveNativeBinary(filename, matrix, fatal, compressionLevel);
+
+  // The Armadillo-backed formats do not support transparent compression.
+  if (compressionLevel > 0)
+    Log::Warn << "data::Save(): compression is only supported by the mlpack "
+        << "binary dataset format (.mlb); saving '" << filename << "' "
+        << "uncompressed." << std::endl;
+
   // Catch errors opening the file.
   std::fstream stream;
   stream.open(filename.c_str(), std::fstream::out);
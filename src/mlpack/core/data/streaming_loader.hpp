@@ -0,0 +1,124 @@
+/**
+ * @file streaming_loader.hpp
+ * @author Ryan Curtin
+ *
+ * Defines the StreamingLoader class, which yields a dataset from disk in
+ * fixed-size column batches instead of materializing the whole matrix in RAM.
+ */
+#ifndef __MLPACK_CORE_DATA_STREAMING_LOADER_HPP
+#define __MLPACK_CORE_DATA_STREAMING_LOADER_HPP
+
+#include <mlpack/core/util/log.hpp>
+#include <mlpack/core/arma_extend/arma_extend.hpp> // Includes Armadillo.
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The StreamingLoader class reads a dataset from disk incrementally, yielding
+ * fixed-size column batches (one point per column, as elsewhere in mlpack).
+ * This allows out-of-core training: a method that only needs to see a window
+ * of points at a time -- stochastic gradient descent, for instance -- can
+ * process datasets far larger than available memory.
+ *
+ * The loader reads the file in large blocks and keeps one block of raw input
+ * buffered ahead of the parser.  When OpenMP is available, the prefetch of the
+ * next block overlaps with the parsing of the current batch (double
+ * buffering); without OpenMP the reads simply happen inline.
+ *
+ * Currently CSV files (and whitespace-separated ASCII) are supported.  Usage
+ * is straightforward:
+ *
+ * @code
+ * StreamingLoader<> loader("dataset.csv", 1000);
+ * arma::mat batch;
+ * while (loader.Next(batch))
+ *   ProcessBatch(batch); // batch has up to 1000 columns.
+ * @endcode
+ *
+ * @tparam eT Element type of the matrix to load into (default double).
+ */
+template<typename eT = double>
+class StreamingLoader
+{
+ public:
+  /**
+   * Open the given file for streaming.  If the file cannot be opened, a fatal
+   * error is reported.  The dimensionality of the dataset is determined from
+   * the first line of the file.
+   *
+   * @param filename Name of the file to stream points from.
+   * @param batchSize Maximum number of points (columns) per batch.
+   */
+  StreamingLoader(const std::string& filename, const size_t batchSize);
+
+  /**
+   * Fill the given matrix with the next batch of points.  The matrix is sized
+   * to (dimensionality x number of points in batch); every batch holds
+   * batchSize points except possibly the last.  Returns false (leaving the
+   * matrix empty) when the end of the file has been reached.
+   *
+   * @param batch Matrix to store the batch in (one point per column).
+   */
+  bool Next(arma::Mat<eT>& batch);
+
+  //! Rewind the loader to the beginning of the file.
+  void Reset();
+
+  //! Return the dimensionality of the points in the file.
+  size_t Dimensionality() const { return dims; }
+  //! Return the maximum number of points per batch.
+  size_t BatchSize() const { return batchSize; }
+
+ private:
+  //! Size of a raw read block, in bytes.
+  static const size_t blockSize = 1048576;
+
+  /**
+   * Read the next raw block of the file into the prefetch buffer, if the
+   * buffer is empty and the file is not exhausted.
+   */
+  void PrefetchBlock();
+
+  /**
+   * Append buffered (or freshly read) raw data to the pending parse buffer.
+   * Returns false if no more data could be obtained.
+   */
+  bool FillPending();
+
+  /**
+   * Parse the given complete lines of the pending buffer into the batch
+   * matrix.  Reports a fatal error on malformed input.
+   */
+  void ParseLines(const std::vector<std::pair<size_t, size_t> >& lines,
+                  arma::Mat<eT>& batch);
+
+  //! Stream the points are read from.
+  std::ifstream stream;
+  //! Name of the file (for error reporting).
+  std::string filename;
+  //! Maximum number of points per batch.
+  size_t batchSize;
+  //! Dimensionality of the dataset (0 until the first line is seen).
+  size_t dims;
+
+  //! Raw bytes read from the file but not yet parsed.
+  std::string pending;
+  //! Prefetched raw block (the second buffer).
+  std::string prefetch;
+  //! Whether the prefetch buffer holds unconsumed data.
+  bool prefetchValid;
+  //! Whether the end of the file has been reached.
+  bool endOfFile;
+};
+
+}; // namespace data
+}; // namespace mlpack
+
+// Include implementation.
+#include "streaming_loader_impl.hpp"
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @file streaming_loader_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the StreamingLoader class.
+ */
+#ifndef __MLPACK_CORE_DATA_STREAMING_LOADER_IMPL_HPP
+#define __MLPACK_CORE_DATA_STREAMING_LOADER_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "streaming_loader.hpp"
+
+#include <cstdlib>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+StreamingLoader<eT>::StreamingLoader(const std::string& filename,
+                                     const size_t batchSize) :
+    filename(filename),
+    batchSize(batchSize),
+    dims(0),
+    prefetchValid(false),
+    endOfFile(false)
+{
+  if (batchSize == 0)
+    Log::Fatal << "StreamingLoader: batch size must be greater than 0!"
+        << std::endl;
+
+  stream.open(filename.c_str(), std::ifstream::in);
+  if (!stream.is_open())
+    Log::Fatal << "StreamingLoader: cannot open file '" << filename << "'!"
+        << std::endl;
+}
+
+template<typename eT>
+void StreamingLoader<eT>::PrefetchBlock()
+{
+  if (prefetchValid || endOfFile)
+    return;
+
+  prefetch.resize(blockSize);
+  stream.read(&prefetch[0], blockSize);
+  const std::streamsize bytes = stream.gcount();
+  prefetch.resize((size_t) bytes);
+
+  if (bytes > 0)
+    prefetchValid = true;
+  if ((size_t) bytes < blockSize)
+    endOfFile = true;
+}
+
+template<typename eT>
+bool StreamingLoader<eT>::FillPending()
+{
+  // Use the prefetched block if one is ready; otherwise read directly.
+  if (!prefetchValid)
+    PrefetchBlock();
+
+  if (!prefetchValid)
+    return false; // Nothing left in the file.
+
+  pending += prefetch;
+  prefetch.clear();
+  prefetchValid = false;
+  return true;
+}
+
+template<typename eT>
+void StreamingLoader<eT>::ParseLines(
+    const std::vector<std::pair<size_t, size_t> >& lines,
+    arma::Mat<eT>& batch)
+{
+  bool failed = false;
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+  #endif
+  for (long col = 0; col < (long) lines.size(); ++col)
+  {
+    const char* ptr = pending.c_str() + lines[col].first;
+    const char* const end = pending.c_str() + lines[col].second;
+
+    size_t row = 0;
+    while (row < dims)
+    {
+      char* next;
+      const double value = strtod(ptr, &next);
+      if (next == ptr || next > end) // Not a number, or ran past the line.
+        break;
+
+      batch(row, (size_t) col) = (eT) value;
+      ++row;
+
+      // Skip the delimiter and any surrounding whitespace.
+      ptr = next;
+      while ((ptr < end) &&
+          ((*ptr == ',') || (*ptr == ' ') || (*ptr == '\t')))
+        ++ptr;
+    }
+
+    if ((row != dims) || (ptr != end))
+      failed = true; // All racing writes store the same value.
+  }
+
+  if (failed)
+    Log::Fatal << "StreamingLoader: malformed line in '" << filename << "'; "
+        << "each line must hold " << dims << " numeric values!" << std::endl;
+}
+
+template<typename eT>
+bool StreamingLoader<eT>::Next(arma::Mat<eT>& batch)
+{
+  // Collect the extents of up to batchSize complete lines, reading more raw
+  // data as necessary.
+  std::vector<std::pair<size_t, size_t> > lines;
+  size_t pos = 0;
+  while (lines.size() < batchSize)
+  {
+    size_t eol = pending.find('\n', pos);
+    if (eol == std::string::npos)
+    {
+      if (FillPending())
+        continue; // More data arrived; rescan from the same position.
+
+      // End of file: treat any trailing bytes as a final unterminated line.
+      eol = pending.size();
+      if (eol == pos)
+        break;
+    }
+
+    size_t end = eol;
+    if ((end > pos) && (pending[end - 1] == '\r')) // Strip DOS line endings.
+      --end;
+
+    if (end > pos)
+      lines.push_back(std::make_pair(pos, end));
+
+    pos = (eol == pending.size()) ? eol : eol + 1;
+  }
+
+  if (lines.empty())
+  {
+    batch.set_size(dims, 0);
+    return false;
+  }
+
+  // The first line of the file determines the dimensionality.
+  if (dims == 0)
+  {
+    dims = 1;
+    for (size_t i = lines[0].first; i < lines[0].second; ++i)
+      if (pending[i] == ',')
+        ++dims;
+  }
+
+  batch.set_size(dims, lines.size());
+
+  // Parse the batch; when OpenMP is available, overlap the parse with the
+  // read of the next raw block (double buffering).
+#ifdef _OPENMP
+  #pragma omp parallel sections
+  {
+    #pragma omp section
+    ParseLines(lines, batch);
+
+    #pragma omp section
+    PrefetchBlock();
+  }
+#else
+  ParseLines(lines, batch);
+  PrefetchBlock();
+#endif
+
+  // Drop the consumed raw data.
+  pending.erase(0, pos);
+
+  return true;
+}
+
+template<typename eT>
+void StreamingLoader<eT>::Reset()
+{
+  stream.clear();
+  stream.seekg(0, std::ios::beg);
+  pending.clear();
+  prefetch.clear();
+  prefetchValid = false;
+  endOfFile = false;
+}
+
+}; // namespace data
+}; // namespace mlpack
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file streaming_writer.hpp
+ * @author Ryan Curtin
+ *
+ * Defines the StreamingWriter class, which appends a dataset to disk in
+ * column batches instead of materializing the whole matrix in RAM first.
+ */
+#ifndef __MLPACK_CORE_DATA_STREAMING_WRITER_HPP
+#define __MLPACK_CORE_DATA_STREAMING_WRITER_HPP
+
+#include <mlpack/core/util/log.hpp>
+#include <mlpack/core/arma_extend/arma_extend.hpp> // Includes Armadillo.
+#include <fstream>
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The StreamingWriter class writes a dataset to disk incrementally, one
+ * column batch at a time, so a program never has to hold its full output in
+ * memory.  It is the output-side counterpart of StreamingLoader: each column
+ * of an appended batch becomes one row of the output file, which is the same
+ * transposition data::Save() applies, so files written here load back with
+ * data::Load() (or stream back through StreamingLoader).
+ *
+ * Appended batches are double buffered: each Append() formats the new batch
+ * into one buffer while the previously formatted one is written to disk, so
+ * when OpenMP is available the disk write overlaps with the formatting (and,
+ * since Append() returns before its own batch reaches the disk, with the
+ * caller's next round of computation).  Without OpenMP the write happens
+ * inline.
+ *
+ * Currently CSV files (and whitespace-separated ASCII, chosen by the file
+ * extension as in data::Save()) are supported.  Usage:
+ *
+ * @code
+ * StreamingWriter<> writer("results.csv");
+ * arma::mat batch;
+ * while (ComputeBatch(batch)) // batch holds one point per column.
+ *   writer.Append(batch);
+ * @endcode
+ *
+ * @tparam eT Element type of the matrix being written (default double).
+ */
+template<typename eT = double>
+class StreamingWriter
+{
+ public:
+  /**
+   * Open the given file for writing, truncating it if it exists.  If the
+   * file cannot be opened, a fatal error is reported.  The separator is
+   * chosen from the file extension: comma for .csv, whitespace otherwise.
+   *
+   * @param filename Name of the file to append batches to.
+   */
+  StreamingWriter(const std::string& filename);
+
+  //! Flush any pending batch and close the file.
+  ~StreamingWriter();
+
+  /**
+   * Append a batch of points (one per column) to the file; each column
+   * becomes one output row.  Every batch must have the same number of rows.
+   * The batch is formatted while the previous one is written out, so the
+   * data has not necessarily reached the disk when this returns; it has
+   * after Flush() or destruction.
+   *
+   * @param batch Matrix of points to append.
+   */
+  void Append(const arma::Mat<eT>& batch);
+
+  //! Write any pending formatted batch to the file.
+  void Flush();
+
+  //! Return the number of points appended so far.
+  size_t PointsWritten() const { return pointsWritten; }
+
+ private:
+  //! Format the given batch into the given buffer, one column per line.
+  void Format(const arma::Mat<eT>& batch, std::string& buffer) const;
+
+  //! Stream the batches are written to.
+  std::ofstream stream;
+  //! Name of the file (for error reporting).
+  std::string filename;
+  //! Separator between the values of a point.
+  char separator;
+
+  //! Dimensionality of the points (0 until the first batch is seen).
+  size_t dims;
+  //! Number of points appended so far.
+  size_t pointsWritten;
+
+  //! Formatted batch not yet written to the file (the second buffer).
+  std::string pending;
+};
+
+}; // namespace data
+}; // namespace mlpack
+
+// Include implementation.
+#include "streaming_writer_impl.hpp"
+
+#endif
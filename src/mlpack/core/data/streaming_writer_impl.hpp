@@ -0,0 +1,128 @@
+/**
+ * @file streaming_writer_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the StreamingWriter class.
+ */
+#ifndef __MLPACK_CORE_DATA_STREAMING_WRITER_IMPL_HPP
+#define __MLPACK_CORE_DATA_STREAMING_WRITER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_writer.hpp"
+
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+StreamingWriter<eT>::StreamingWriter(const std::string& filename) :
+    filename(filename),
+    separator(' '),
+    dims(0),
+    pointsWritten(0)
+{
+  // Pick the separator from the extension, as data::Save() does.
+  if ((filename.length() > 4) &&
+      (filename.substr(filename.length() - 4) == ".csv"))
+    separator = ',';
+
+  stream.open(filename.c_str(), std::ios::out | std::ios::trunc);
+  if (!stream.is_open())
+    Log::Fatal << "StreamingWriter: cannot open file '" << filename
+        << "' for writing!" << std::endl;
+}
+
+template<typename eT>
+StreamingWriter<eT>::~StreamingWriter()
+{
+  Flush();
+  stream.close();
+}
+
+template<typename eT>
+void StreamingWriter<eT>::Append(const arma::Mat<eT>& batch)
+{
+  if (batch.n_cols == 0)
+    return;
+
+  if (dims == 0)
+    dims = batch.n_rows;
+  else if (batch.n_rows != dims)
+    Log::Fatal << "StreamingWriter: batch dimensionality (" << batch.n_rows
+        << ") does not match earlier batches (" << dims << ")!" << std::endl;
+
+  std::string formatted;
+
+  // Write the previously formatted batch out while this one is formatted;
+  // when OpenMP is available the two sections run concurrently, so the disk
+  // write overlaps with the formatting.
+#ifdef _OPENMP
+  #pragma omp parallel sections
+#endif
+  {
+#ifdef _OPENMP
+    #pragma omp section
+#endif
+    {
+      if (!pending.empty())
+      {
+        stream.write(pending.c_str(), pending.length());
+        pending.clear();
+      }
+    }
+
+#ifdef _OPENMP
+    #pragma omp section
+#endif
+    {
+      Format(batch, formatted);
+    }
+  }
+
+  // The freshly formatted batch becomes the pending one.
+  pending.swap(formatted);
+  pointsWritten += batch.n_cols;
+}
+
+template<typename eT>
+void StreamingWriter<eT>::Flush()
+{
+  if (!pending.empty())
+  {
+    stream.write(pending.c_str(), pending.length());
+    pending.clear();
+  }
+  stream.flush();
+
+  if (!stream)
+    Log::Fatal << "StreamingWriter: error writing to '" << filename << "'!"
+        << std::endl;
+}
+
+template<typename eT>
+void StreamingWriter<eT>::Format(const arma::Mat<eT>& batch,
+                                 std::string& buffer) const
+{
+  std::ostringstream formatted;
+  formatted.precision(16);
+
+  // One column per output line, as data::Save() transposes.
+  for (size_t col = 0; col < batch.n_cols; ++col)
+  {
+    for (size_t row = 0; row < batch.n_rows; ++row)
+    {
+      if (row > 0)
+        formatted << separator;
+      formatted << batch(row, col);
+    }
+    formatted << '\n';
+  }
+
+  buffer = formatted.str();
+}
+
+}; // namespace data
+}; // namespace mlpack
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file diagonal_gaussian_distribution.cpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the diagonal-covariance Gaussian distribution class.
+ */
+#include "diagonal_gaussian_distribution.hpp"
+
+using namespace mlpack;
+using namespace mlpack::distribution;
+
+double DiagonalGaussianDistribution::Probability(
+    const arma::vec& observation) const
+{
+  return exp(LogProbability(observation));
+}
+
+double DiagonalGaussianDistribution::LogProbability(
+    const arma::vec& observation) const
+{
+  if (invCovStale)
+    InvertCovariance();
+
+  // Because the covariance is diagonal, the Mahalanobis distance is simply
+  // the sum of the squared deviations weighted by the inverse variances.
+  const arma::vec diff = observation - mean;
+
+  return -0.5 * mean.n_elem * log(2 * M_PI) - 0.5 * logDetCov -
+      0.5 * arma::dot(diff % diff, invCov);
+}
+
+/**
+ * Recompute the cached inverse and log-determinant of the covariance.
+ */
+void DiagonalGaussianDistribution::InvertCovariance() const
+{
+  invCov = 1.0 / covariance;
+  logDetCov = arma::accu(arma::log(covariance));
+
+  invCovStale = false;
+}
+
+arma::vec DiagonalGaussianDistribution::Random() const
+{
+  // Scale each dimension of a standard normal sample by its standard
+  // deviation; no Cholesky factorization is necessary.
+  return arma::sqrt(covariance) % arma::randn<arma::vec>(mean.n_elem) + mean;
+}
+
+/**
+ * Estimate the diagonal Gaussian distribution directly from the given
+ * observations.
+ *
+ * @param observations List of observations.
+ */
+void DiagonalGaussianDistribution::Estimate(const arma::mat& observations)
+{
+  if (observations.n_cols == 0)
+  {
+    // This will end up just being empty.
+    mean.zeros(0);
+    covariance.zeros(0);
+    invCovStale = true;
+    return;
+  }
+
+  // Calculate and normalize the mean.
+  mean = arma::sum(observations, 1 /* rowwise */) / observations.n_cols;
+
+  // Each variance is the normalized sum of squared deviations in its own
+  // dimension, with the (1 / (n - 1)) so that it is the unbiased estimator.
+  arma::mat diffs = observations -
+      (mean * arma::ones<arma::rowvec>(observations.n_cols));
+  covariance = arma::sum(diffs % diffs, 1 /* rowwise */) /
+      (observations.n_cols - 1);
+
+  // Ensure that every variance is positive.
+  if (covariance.min() <= 1e-50)
+  {
+    Log::Debug << "DiagonalGaussianDistribution::Estimate(): variance vector "
+        << "is not positive. Adding perturbation." << std::endl;
+
+    double perturbation = 1e-30;
+    while (covariance.min() <= 1e-50)
+    {
+      covariance += perturbation;
+      perturbation *= 10; // Slow, but we don't want to add too much.
+    }
+  }
+
+  // The covariance has changed, so the cached inverse is out of date.
+  invCovStale = true;
+}
+
+/**
+ * Estimate the diagonal Gaussian distribution from the given observations,
+ * taking into account the probability of each observation actually being from
+ * this distribution.
+ */
+void DiagonalGaussianDistribution::Estimate(const arma::mat& observations,
+                                            const arma::vec& probabilities)
+{
+  if (observations.n_cols == 0)
+  {
+    // This will end up just being empty.
+    mean.zeros(0);
+    covariance.zeros(0);
+    invCovStale = true;
+    return;
+  }
+
+  const double sumProb = arma::accu(probabilities);
+
+  if (sumProb == 0)
+  {
+    // Nothing in this Gaussian!  At least set the variances so that they are
+    // invertible.
+    mean.zeros(observations.n_rows);
+    covariance.set_size(observations.n_rows);
+    covariance.fill(1e-50);
+    invCovStale = true;
+    return;
+  }
+
+  // Calculate the probability-weighted mean.
+  mean = (observations * probabilities) / sumProb;
+
+  // Each variance is the probability-weighted sum of squared deviations in
+  // its own dimension.  This is probably biased, but I don't know how to
+  // unbias it.
+  arma::mat diffs = observations -
+      (mean * arma::ones<arma::rowvec>(observations.n_cols));
+  covariance = ((diffs % diffs) * probabilities) / sumProb;
+
+  // Ensure that every variance is positive.
+  if (covariance.min() <= 1e-50)
+  {
+    Log::Debug << "DiagonalGaussianDistribution::Estimate(): variance vector "
+        << "is not positive. Adding perturbation." << std::endl;
+
+    double perturbation = 1e-30;
+    while (covariance.min() <= 1e-50)
+    {
+      covariance += perturbation;
+      perturbation *= 10; // Slow, but we don't want to add too much.
+    }
+  }
+
+  // The covariance has changed, so the cached inverse is out of date.
+  invCovStale = true;
+}
+
+/**
+ * Returns a string representation of this object.
+ */
+std::string DiagonalGaussianDistribution::ToString() const
+{
+  std::ostringstream convert;
+  convert << "DiagonalGaussianDistribution [" << this << "]" << std::endl;
+
+  // Secondary ostringstream so things can be indented right.
+  std::ostringstream data;
+  data << "Mean: " << std::endl << mean;
+  data << "Covariance (diagonal): " << std::endl << covariance;
+
+  convert << util::Indent(data.str());
+  return convert.str();
+}
+
+/**
+ * Save to SaveRestoreUtility.
+ */
+void DiagonalGaussianDistribution::Save(util::SaveRestoreUtility& sr) const
+{
+  sr.SaveParameter(Type(), "type");
+  sr.SaveParameter(mean, "mean");
+  sr.SaveParameter(covariance, "covariance");
+}
+
+/**
+ * Load from SaveRestoreUtility.
+ */
+void DiagonalGaussianDistribution::Load(const util::SaveRestoreUtility& sr)
+{
+  sr.LoadParameter(mean, "mean");
+  sr.LoadParameter(covariance, "covariance");
+  invCovStale = true;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file diagonal_gaussian_distribution.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the multivariate Gaussian distribution with a diagonal
+ * covariance matrix.
+ */
+#ifndef __MLPACK_CORE_DISTS_DIAGONAL_GAUSSIAN_DISTRIBUTION_HPP
+#define __MLPACK_CORE_DISTS_DIAGONAL_GAUSSIAN_DISTRIBUTION_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace distribution {
+
+/**
+ * A single multivariate Gaussian distribution with a diagonal covariance
+ * matrix.  Because the covariance is diagonal, it is stored as a vector of
+ * per-dimension variances, and every operation (probability evaluation,
+ * sampling, estimation) costs O(d) per observation instead of the O(d^2) of
+ * the full-covariance GaussianDistribution.  This makes it the preferred
+ * component type for mixture models over data whose dimensions are assumed
+ * independent (as in most speech models).
+ */
+class DiagonalGaussianDistribution
+{
+ private:
+  //! Mean of the distribution.
+  arma::vec mean;
+  //! Per-dimension variances of the distribution (the diagonal of the
+  //! covariance matrix).
+  arma::vec covariance;
+  //! Cached elementwise inverse of the variances.  This is computed lazily
+  //! (and is therefore mutable), since the covariance may be modified through
+  //! the non-const Covariance() accessor.
+  mutable arma::vec invCov;
+  //! Cached log-determinant of the covariance.
+  mutable double logDetCov;
+  //! If true, invCov and logDetCov must be recomputed before use (the
+  //! covariance may have been modified since they were last computed).
+  mutable bool invCovStale;
+
+ public:
+  /**
+   * Default constructor, which creates a Gaussian with zero dimension.
+   */
+  DiagonalGaussianDistribution() : logDetCov(0.0), invCovStale(true)
+  { /* Nothing to do. */ }
+
+  /**
+   * Create a diagonal Gaussian distribution with zero mean and unit variance
+   * in each dimension.
+   */
+  DiagonalGaussianDistribution(const size_t dimension) :
+      mean(arma::zeros<arma::vec>(dimension)),
+      covariance(arma::ones<arma::vec>(dimension)),
+      logDetCov(0.0),
+      invCovStale(true)
+  { /* Nothing to do. */ }
+
+  /**
+   * Create a diagonal Gaussian distribution with the given mean and vector of
+   * per-dimension variances.
+   */
+  DiagonalGaussianDistribution(const arma::vec& mean,
+                               const arma::vec& covariance) :
+      mean(mean),
+      covariance(covariance),
+      logDetCov(0.0),
+      invCovStale(true)
+  { /* Nothing to do. */ }
+
+  //! Return the dimensionality of this distribution.
+  size_t Dimensionality() const { return mean.n_elem; }
+
+  /**
+   * Return the probability of the given observation.
+   */
+  double Probability(const arma::vec& observation) const;
+
+  /**
+   * Calculates the probability density function for each data point (column)
+   * in the given matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& x, arma::vec& probabilities) const;
+
+  /**
+   * Return the log-probability of the given observation.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
+  /**
+   * Calculates the log of the probability density function for each data
+   * point (column) in the given matrix.  The Mahalanobis term for each
+   * observation is a weighted sum of squared deviations, so the whole batch
+   * is handled with a single matrix-vector product.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log-probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
+  /**
+   * Return a randomly generated observation according to the probability
+   * distribution defined by this object.
+   *
+   * @return Random observation from this diagonal Gaussian distribution.
+   */
+  arma::vec Random() const;
+
+  /**
+   * Estimate the diagonal Gaussian distribution directly from the given
+   * observations.
+   *
+   * @param observations List of observations.
+   */
+  void Estimate(const arma::mat& observations);
+
+  /**
+   * Estimate the diagonal Gaussian distribution from the given observations,
+   * taking into account the probability of each observation actually being
+   * from this distribution.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities);
+
+  /**
+   * Return the mean.
+   */
+  const arma::vec& Mean() const { return mean; }
+
+  /**
+   * Return a modifiable copy of the mean.
+   */
+  arma::vec& Mean() { return mean; }
+
+  /**
+   * Return the vector of per-dimension variances.
+   */
+  const arma::vec& Covariance() const { return covariance; }
+
+  /**
+   * Return a modifiable copy of the vector of per-dimension variances.
+   * Because the variances may be modified through the returned reference,
+   * this marks the cached inverse and log-determinant stale; they will be
+   * recomputed the next time the distribution is evaluated or sampled.
+   */
+  arma::vec& Covariance()
+  {
+    invCovStale = true;
+    return covariance;
+  }
+
+  /**
+   * Returns a string representation of this object.
+   */
+  std::string ToString() const;
+
+  /*
+   * Save to or Load from SaveRestoreUtility
+   */
+  void Save(util::SaveRestoreUtility& n) const;
+  void Load(const util::SaveRestoreUtility& n);
+  static std::string const Type() { return "DiagonalGaussianDistribution"; }
+
+ private:
+  /**
+   * Recompute the cached inverse and log-determinant of the covariance.
+   * Called lazily before evaluation or sampling whenever the covariance may
+   * have been modified.
+   */
+  void InvertCovariance() const;
+};
+
+/**
+* Calculates the log of the probability density function for each data point
+* (column) in the given matrix.
+*
+* @param x List of observations.
+* @param logProbabilities Output log-probabilities for each input observation.
+*/
+inline void DiagonalGaussianDistribution::LogProbability(
+    const arma::mat& x,
+    arma::vec& logProbabilities) const
+{
+  if (invCovStale)
+    InvertCovariance();
+
+  // Column i of 'diffs' is the difference between x.col(i) and the mean.
+  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
+
+  // The Mahalanobis term for each observation is the sum of its squared
+  // deviations weighted by the inverse variances, so one matrix-vector
+  // product handles every observation at once.
+  logProbabilities = -0.5 * mean.n_elem * log(2 * M_PI) - 0.5 * logDetCov -
+      0.5 * (arma::trans(diffs % diffs) * invCov);
+}
+
+/**
+* Calculates the probability density function for each data point (column) in
+* the given matrix.
+*
+* @param x List of observations.
+* @param probabilities Output probabilities for each input observation.
+*/
+inline void DiagonalGaussianDistribution::Probability(
+    const arma::mat& x,
+    arma::vec& probabilities) const
+{
+  LogProbability(x, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+}; // namespace distribution
+}; // namespace mlpack
+
+#endif
@@ -9,29 +9,120 @@
 using namespace mlpack;
 using namespace mlpack::distribution;
 
+/**
+ * Rebuild the alias table from the current probabilities, using Vose's
+ * algorithm.  Each bin of the table either accepts its own observation (with
+ * probability aliasProb) or defers to its alias, so a sample needs only one
+ * table lookup instead of a linear scan over the probabilities.
+ */
+void DiscreteDistribution::BuildAliasTable() const
+{
+  const size_t n = probabilities.n_elem;
+
+  aliasProb.set_size(n);
+  aliasIndex.set_size(n);
+
+  // Scale the probabilities so that an exactly uniform distribution would
+  // give every bin a weight of 1, then split the bins into those with less
+  // and those with at least that much weight.
+  arma::vec scaled = probabilities * n;
+
+  std::vector<size_t> small;
+  std::vector<size_t> large;
+  small.reserve(n);
+  large.reserve(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    if (scaled[i] < 1.0)
+      small.push_back(i);
+    else
+      large.push_back(i);
+  }
+
+  // Each underfull bin is topped up by an overfull one, which becomes its
+  // alias; the overfull bin's remaining weight is then reclassified.
+  while (!small.empty() && !large.empty())
+  {
+    const size_t s = small.back();
+    small.pop_back();
+    const size_t l = large.back();
+    large.pop_back();
+
+    aliasProb[s] = scaled[s];
+    aliasIndex[s] = l;
+
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+    if (scaled[l] < 1.0)
+      small.push_back(l);
+    else
+      large.push_back(l);
+  }
+
+  // Any bins left over have weight 1 up to roundoff error; they always accept
+  // their own observation.
+  while (!large.empty())
+  {
+    aliasProb[large.back()] = 1.0;
+    aliasIndex[large.back()] = large.back();
+    large.pop_back();
+  }
+  while (!small.empty())
+  {
+    aliasProb[small.back()] = 1.0;
+    aliasIndex[small.back()] = small.back();
+    small.pop_back();
+  }
+
+  aliasStale = false;
+}
+
+/**
+ * Sample a single observation from the alias table, given a uniform random
+ * value in [0, n).
+ */
+size_t DiscreteDistribution::SampleAliasTable(const double randValue) const
+{
+  // The integer part of the random value selects the bin, and the fractional
+  // part serves as a second uniform variate deciding between the bin and its
+  // alias.
+  size_t bin = (size_t) randValue;
+  if (bin >= probabilities.n_elem) // Guard against roundoff.
+    bin = probabilities.n_elem - 1;
+
+  return ((randValue - bin) < aliasProb[bin]) ? bin : aliasIndex[bin];
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
  */
 arma::vec DiscreteDistribution::Random() const
 {
-  // Generate a random number.
-  double randObs = math::Random();
+  if (aliasStale)
+    BuildAliasTable();
+
   arma::vec result(1);
+  result[0] = SampleAliasTable(math::Random() * probabilities.n_elem);
+  return result;
+}
 
-  double sumProb = 0;
-  for (size_t obs = 0; obs < probabilities.n_elem; obs++)
-  {
-    if ((sumProb += probabilities[obs]) >= randObs)
-    {
-      result[0] = obs;
-      return result;
-    }
-  }
+/**
+ * Generate many random observations at once, one per column of the given
+ * matrix.
+ */
+void DiscreteDistribution::Random(const size_t numObservations,
+                                  arma::mat& observations) const
+{
+  if (aliasStale)
+    BuildAliasTable();
 
-  // This shouldn't happen.
-  result[0] = probabilities.n_elem - 1;
-  return result;
+  // Generate all the random values in one batch.
+  arma::vec randValues = probabilities.n_elem *
+      arma::randu<arma::vec>(numObservations);
+
+  observations.set_size(1, numObservations);
+  for (size_t i = 0; i < numObservations; i++)
+    observations(0, i) = SampleAliasTable(randValues[i]);
 }
 
 /**
@@ -66,6 +157,9 @@ void DiscreteDistribution::Estimate(const arma::mat& observations)
     probabilities /= sum;
   else
     probabilities.fill(1 / probabilities.n_elem); // Force normalization.
+
+  // The probabilities have changed, so the alias table is out of date.
+  aliasStale = true;
 }
 
 /**
@@ -102,6 +196,9 @@ void DiscreteDistribution::Estimate(const arma::mat& observations,
     probabilities /= sum;
   else
     probabilities.fill(1 / probabilities.n_elem); // Force normalization.
+
+  // The probabilities have changed, so the alias table is out of date.
+  aliasStale = true;
 }
 
 /**
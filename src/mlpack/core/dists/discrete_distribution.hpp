@@ -41,7 +41,7 @@ class DiscreteDistribution
   /**
    * Default constructor, which creates a distribution that has no observations.
    */
-  DiscreteDistribution() { /* nothing to do */ }
+  DiscreteDistribution() : aliasStale(true) { /* nothing to do */ }
 
   /**
    * Define the discrete distribution as having numObservations possible
@@ -52,7 +52,8 @@ class DiscreteDistribution
    *    can have.
    */
   DiscreteDistribution(const size_t numObservations) :
-      probabilities(arma::ones<arma::vec>(numObservations) / numObservations)
+      probabilities(arma::ones<arma::vec>(numObservations) / numObservations),
+      aliasStale(true)
   { /* nothing to do */ }
 
   /**
@@ -61,7 +62,7 @@ class DiscreteDistribution
    *
    * @param probabilities Probabilities of each possible observation.
    */
-  DiscreteDistribution(const arma::vec& probabilities)
+  DiscreteDistribution(const arma::vec& probabilities) : aliasStale(true)
   {
     // We must be sure that our distribution is normalized.
     double sum = accu(probabilities);
@@ -107,12 +108,24 @@ class DiscreteDistribution
   /**
    * Return a randomly generated observation (one-dimensional vector; one
    * observation) according to the probability distribution defined by this
-   * object.
+   * object.  Sampling is done in O(1) with the alias method; the alias table
+   * is rebuilt lazily whenever the probabilities have changed.
    *
    * @return Random observation.
    */
   arma::vec Random() const;
 
+  /**
+   * Generate many random observations at once, filling the given matrix with
+   * one observation per column.  This amortizes the random number generation
+   * over the whole batch in addition to the O(1) per-draw cost of the alias
+   * method.
+   *
+   * @param numObservations Number of observations to generate.
+   * @param observations Matrix to store the generated observations in.
+   */
+  void Random(const size_t numObservations, arma::mat& observations) const;
+
   /**
    * Estimate the probability distribution directly from the given observations.
    * If any of the observations is greater than numObservations, a crash is
@@ -136,8 +149,14 @@ class DiscreteDistribution
 
   //! Return the vector of probabilities.
   const arma::vec& Probabilities() const { return probabilities; }
-  //! Modify the vector of probabilities.
-  arma::vec& Probabilities() { return probabilities; }
+  //! Modify the vector of probabilities.  Because the probabilities may be
+  //! modified through the returned reference, this marks the cached alias
+  //! table stale; it will be rebuilt the next time Random() is called.
+  arma::vec& Probabilities()
+  {
+    aliasStale = true;
+    return probabilities;
+  }
 
   /*
    * Returns a string representation of this object.
@@ -148,11 +167,40 @@ class DiscreteDistribution
   /** Save to or Load from SaveRestoreUtility
    */
   void Save(util::SaveRestoreUtility& n) const;
-  void Load(const util::SaveRestoreUtility& n) { n.LoadParameter(probabilities, "probabilities"); }
+  void Load(const util::SaveRestoreUtility& n)
+  {
+    n.LoadParameter(probabilities, "probabilities");
+    aliasStale = true;
+  }
   static std::string const Type() { return "DiscreteDistribution"; }
 
  private:
+  /**
+   * Rebuild the alias table (Vose's algorithm) from the current
+   * probabilities.  Called lazily before sampling whenever the probabilities
+   * may have been modified.
+   */
+  void BuildAliasTable() const;
+
+  /**
+   * Sample a single observation from the alias table, given a uniform random
+   * value in [0, n) (where n is the number of observations).  The integer
+   * part selects the bin and the fractional part decides between the bin and
+   * its alias, so only one random number is needed per draw.
+   */
+  size_t SampleAliasTable(const double randValue) const;
+
   arma::vec probabilities;
+
+  //! Acceptance probability of each bin of the alias table.  This is built
+  //! lazily (and is therefore mutable), since the probabilities may be
+  //! modified through the non-const Probabilities() accessor.
+  mutable arma::vec aliasProb;
+  //! Alias observation of each bin of the alias table.
+  mutable arma::Col<size_t> aliasIndex;
+  //! If true, the alias table must be rebuilt before sampling (the
+  //! probabilities may have been modified since it was last built).
+  mutable bool aliasStale;
 };
 
 }; // namespace distribution
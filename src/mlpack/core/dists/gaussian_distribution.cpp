@@ -23,21 +23,57 @@ using namespace mlpack::distribution;
 
 double GaussianDistribution::Probability(const arma::vec& observation) const
 {
-  arma::vec diff = mean - observation;
+  return exp(LogProbability(observation));
+}
+
+double GaussianDistribution::LogProbability(const arma::vec& observation) const
+{
+  if (factorizationStale)
+    FactorCovariance();
 
-  arma::vec exponent = -0.5 * (trans(diff) * inv(covariance) * diff);
+  // With covariance = L L^T, the Mahalanobis distance is || L^-1 diff ||^2,
+  // which needs only a triangular solve against the cached factor.
+  const arma::vec diff = observation - mean;
+  const arma::vec z = arma::solve(arma::trimatl(covLower), diff);
 
-  // TODO: What if det(cov) < 0?
-  return pow(2 * M_PI, (double) observation.n_elem / -2.0) *
-      pow(det(covariance), -0.5) * exp(exponent[0]);
+  return -0.5 * mean.n_elem * log(2 * M_PI) - 0.5 * logDetCov -
+      0.5 * arma::dot(z, z);
 }
 
+/**
+ * Recompute the cached Cholesky factor and log-determinant of the covariance.
+ */
+void GaussianDistribution::FactorCovariance() const
+{
+  // arma::chol() returns the upper-triangular factor R with covariance =
+  // R^T R; we store the lower-triangular factor L = R^T.
+  covLower = trans(chol(covariance));
+
+  // The determinant of the covariance is the squared product of the diagonal
+  // entries of its Cholesky factor.
+  logDetCov = 2.0 * accu(log(covLower.diag()));
 
+  factorizationStale = false;
+}
 
 arma::vec GaussianDistribution::Random() const
 {
-  // Should we store chol(covariance) for easier calculation later?
-  return trans(chol(covariance)) * arma::randn<arma::vec>(mean.n_elem) + mean;
+  if (factorizationStale)
+    FactorCovariance();
+
+  return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
+}
+
+void GaussianDistribution::Random(const size_t numSamples,
+                                  arma::mat& samples) const
+{
+  if (factorizationStale)
+    FactorCovariance();
+
+  // One matrix product against the Cholesky factor correlates all of the
+  // draws at once.
+  samples = covLower * arma::randn<arma::mat>(mean.n_elem, numSamples) +
+      mean * arma::ones<arma::rowvec>(numSamples);
 }
 
 /**
@@ -56,6 +92,7 @@ void GaussianDistribution::Estimate(const arma::mat& observations)
   {
     mean.zeros(0);
     covariance.zeros(0);
+    factorizationStale = true;
     return;
   }
 
@@ -90,6 +127,9 @@ void GaussianDistribution::Estimate(const arma::mat& observations)
       perturbation *= 10; // Slow, but we don't want to add too much.
     }
   }
+
+  // The covariance has changed, so the cached factorization is out of date.
+  factorizationStale = true;
 }
 
 /**
@@ -109,6 +149,7 @@ void GaussianDistribution::Estimate(const arma::mat& observations,
   {
     mean.zeros(0);
     covariance.zeros(0);
+    factorizationStale = true;
     return;
   }
 
@@ -127,6 +168,7 @@ void GaussianDistribution::Estimate(const arma::mat& observations,
     // Nothing in this Gaussian!  At least set the covariance so that it's
     // invertible.
     covariance.diag() += 1e-50;
+    factorizationStale = true;
     return;
   }
 
@@ -156,6 +198,9 @@ void GaussianDistribution::Estimate(const arma::mat& observations,
       perturbation *= 10; // Slow, but we don't want to add too much.
     }
   }
+
+  // The covariance has changed, so the cached factorization is out of date.
+  factorizationStale = true;
 }
 
 /**
@@ -193,4 +238,5 @@ void GaussianDistribution::Load(const util::SaveRestoreUtility& sr)
 {
   sr.LoadParameter(mean, "mean");
   sr.LoadParameter(covariance, "covariance");
+  factorizationStale = true;
 }
@@ -23,12 +23,22 @@ class GaussianDistribution
   arma::vec mean;
   //! Covariance of the distribution.
   arma::mat covariance;
+  //! Lower-triangular Cholesky factor of the covariance.  This is computed
+  //! lazily (and is therefore mutable), since the covariance may be modified
+  //! through the non-const Covariance() accessor.
+  mutable arma::mat covLower;
+  //! Cached log-determinant of the covariance.
+  mutable double logDetCov;
+  //! If true, covLower and logDetCov must be recomputed before use (the
+  //! covariance may have been modified since they were last computed).
+  mutable bool factorizationStale;
 
  public:
   /**
    * Default constructor, which creates a Gaussian with zero dimension.
    */
-  GaussianDistribution() { /* nothing to do */ }
+  GaussianDistribution() : logDetCov(0.0), factorizationStale(true)
+  { /* nothing to do */ }
 
   /**
    * Create a Gaussian distribution with zero mean and identity covariance with
@@ -36,14 +46,20 @@ class GaussianDistribution
    */
   GaussianDistribution(const size_t dimension) :
       mean(arma::zeros<arma::vec>(dimension)),
-      covariance(arma::eye<arma::mat>(dimension, dimension))
+      covariance(arma::eye<arma::mat>(dimension, dimension)),
+      logDetCov(0.0),
+      factorizationStale(true)
   { /* Nothing to do. */ }
 
   /**
    * Create a Gaussian distribution with the given mean and covariance.
    */
   GaussianDistribution(const arma::vec& mean, const arma::mat& covariance) :
-      mean(mean), covariance(covariance) { /* Nothing to do. */ }
+      mean(mean),
+      covariance(covariance),
+      logDetCov(0.0),
+      factorizationStale(true)
+  { /* Nothing to do. */ }
 
   //! Return the dimensionality of this distribution.
   size_t Dimensionality() const { return mean.n_elem; }
@@ -61,7 +77,24 @@ class GaussianDistribution
    * @param probabilities Output probabilities for each input observation.
    */
   void Probability(const arma::mat& x, arma::vec& probabilities) const;
-  
+
+  /**
+   * Return the log-probability of the given observation.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
+  /**
+   * Calculates the log of the multivariate Gaussian probability density
+   * function for each data point (column) in the given matrix.  All
+   * observations are handled with a single triangular solve against the
+   * cached Cholesky factor, so this is the preferred entry point for batch
+   * evaluation (it is the inner loop of both GMM and HMM training).
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log-probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -70,6 +103,17 @@ class GaussianDistribution
    */
   arma::vec Random() const;
 
+  /**
+   * Generate the given number of random observations, one per column of the
+   * output matrix.  All of the draws are correlated with a single matrix
+   * product against the cached Cholesky factor, so this is much faster than
+   * calling Random() in a loop.
+   *
+   * @param numSamples Number of observations to generate.
+   * @param samples Matrix to store the observations in.
+   */
+  void Random(const size_t numSamples, arma::mat& samples) const;
+
   /**
    * Estimate the Gaussian distribution directly from the given observations.
    *
@@ -101,9 +145,16 @@ class GaussianDistribution
   const arma::mat& Covariance() const { return covariance; }
 
   /**
-   * Return a modifiable copy of the covariance.
+   * Return a modifiable copy of the covariance.  Because the covariance may
+   * be modified through the returned reference, this marks the cached
+   * Cholesky factorization stale; it will be recomputed the next time the
+   * distribution is evaluated or sampled.
    */
-  arma::mat& Covariance() { return covariance; }
+  arma::mat& Covariance()
+  {
+    factorizationStale = true;
+    return covariance;
+  }
 
   /**
    * Returns a string representation of this object.
@@ -116,11 +167,43 @@ class GaussianDistribution
   void Save(util::SaveRestoreUtility& n) const;
   void Load(const util::SaveRestoreUtility& n);
   static std::string const Type() { return "GaussianDistribution"; }
-  
-  
-    
+
+ private:
+  /**
+   * Recompute the cached Cholesky factor and log-determinant of the
+   * covariance.  Called lazily before evaluation or sampling whenever the
+   * covariance may have been modified.
+   */
+  void FactorCovariance() const;
 };
 
+/**
+* Calculates the log of the multivariate Gaussian probability density function
+* for each data point (column) in the given matrix.
+*
+* @param x List of observations.
+* @param logProbabilities Output log-probabilities for each input observation.
+*/
+inline void GaussianDistribution::LogProbability(
+    const arma::mat& x,
+    arma::vec& logProbabilities) const
+{
+  if (factorizationStale)
+    FactorCovariance();
+
+  // Column i of 'diffs' is the difference between x.col(i) and the mean.
+  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
+
+  // With covariance = L L^T, the Mahalanobis term for column d of diffs is
+  // || L^-1 d ||^2, so one triangular solve against the cached factor handles
+  // every observation at once; there is no need to invert the covariance or
+  // recompute its determinant.
+  arma::mat z = arma::solve(arma::trimatl(covLower), diffs);
+
+  logProbabilities = -0.5 * mean.n_elem * log(2 * M_PI) - 0.5 * logDetCov -
+      0.5 * arma::trans(arma::sum(z % z, 0 /* columnwise */));
+}
+
 /**
 * Calculates the multivariate Gaussian probability density function for each
 * data point (column) in the given matrix
@@ -131,22 +214,10 @@ class GaussianDistribution
 inline void GaussianDistribution::Probability(const arma::mat& x,
                                               arma::vec& probabilities) const
 {
-  // Column i of 'diffs' is the difference between x.col(i) and the mean.
-  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
-  
-  // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1 *
-  // diffs).  We just don't need any of the other elements.  We can calculate
-  // the right hand part of the equation (instead of the left side) so that
-  // later we are referencing columns, not rows -- that is faster.
-  arma::mat rhs = -0.5 * inv(covariance) * diffs;
-  arma::vec exponents(diffs.n_cols); // We will now fill this.
-  for (size_t i = 0; i < diffs.n_cols; i++)
-    exponents(i) = exp(accu(diffs.unsafe_col(i) % rhs.unsafe_col(i)));
-  
-  probabilities = pow(2 * M_PI, (double) mean.n_elem / -2.0) *
-  pow(arma::det(covariance), -0.5) * exponents;
+  LogProbability(x, probabilities);
+  probabilities = arma::exp(probabilities);
 }
-  
+
 
 }; // namespace distribution
 }; // namespace mlpack
@@ -71,6 +71,28 @@ double RegressionDistribution::Probability(const arma::vec& observation) const
   return err.Probability(observation(0)-fitted);
 }
 
+/**
+ * Evaluate probability density function for every observation (column) in the
+ * given matrix.
+ *
+ * @param observations List of observations.
+ * @param probs Output probabilities for each input observation.
+ */
+void RegressionDistribution::Probability(const arma::mat& observations,
+                                         arma::vec& probs) const
+{
+  // Compute the conditional means of the whole sequence with one prediction
+  // pass (a single matrix-vector product against the regression
+  // coefficients).
+  arma::vec fitted;
+  rf.Predict(observations.rows(1, observations.n_rows - 1), fitted);
+
+  // The residuals are the (univariate) observations of the error
+  // distribution.
+  arma::mat residuals = observations.row(0) - fitted.t();
+  err.Probability(residuals, probs);
+}
+
 void RegressionDistribution::Predict(const arma::mat& points,
                                      arma::vec& predictions) const
 {
@@ -80,6 +80,17 @@ class RegressionDistribution
   */
   double Probability(const arma::vec& observation) const;
 
+  /**
+   * Evaluate the probability density function for every observation (column)
+   * in the given matrix.  The conditional means of the whole sequence come
+   * out of a single prediction pass against the regression coefficients,
+   * which is much faster than evaluating each observation separately.
+   *
+   * @param observations List of observations.
+   * @param probs Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& observations, arma::vec& probs) const;
+
   /**
    * Calculate y_i for each data point in points.
    *
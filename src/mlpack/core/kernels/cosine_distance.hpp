@@ -53,6 +53,8 @@ class KernelTraits<CosineDistance>
  public:
   //! The cosine kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The cosine kernel does not provide a batched Evaluate().
+  static const bool IsVectorized = false;
 };
 
 }; // namespace kernel
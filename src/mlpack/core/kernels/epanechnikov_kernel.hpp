@@ -87,6 +87,8 @@ class KernelTraits<EpanechnikovKernel>
  public:
   //! The Epanechnikov kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Epanechnikov kernel does not provide a batched Evaluate().
+  static const bool IsVectorized = false;
 };
 
 }; // namespace kernel
@@ -75,6 +75,23 @@ class GaussianKernel
     return exp(gamma * std::pow(t, 2.0));
   }
 
+  /**
+   * Batched evaluation of the kernel; computes out[i] = K(x.col(i), y) for
+   * every column of x.  The squared distances are expanded as
+   * @f$ || x ||^2 + || y ||^2 - 2 x^T y @f$, so the dominant cost is a single
+   * matrix-vector product, followed by a vectorized exponential.
+   *
+   * @param x Matrix of points, one per column.
+   * @param y Vector to evaluate the kernel against.
+   * @param out Vector to store the kernel evaluations in.
+   */
+  void Evaluate(const arma::mat& x, const arma::vec& y, arma::vec& out) const
+  {
+    out = arma::trans(x) * y;
+    out = arma::exp(gamma * (arma::trans(arma::sum(x % x, 0)) +
+        arma::dot(y, y) - 2.0 * out));
+  }
+
   /**
    * Obtain the normalization constant of the Gaussian kernel.
    *
@@ -140,6 +157,8 @@ class KernelTraits<GaussianKernel>
  public:
   //! The Gaussian kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Gaussian kernel provides a batched Evaluate().
+  static const bool IsVectorized = true;
 };
 
 }; // namespace kernel
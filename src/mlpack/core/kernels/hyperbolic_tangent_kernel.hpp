@@ -55,6 +55,20 @@ class HyperbolicTangentKernel
     return tanh(scale * arma::dot(a, b) + offset);
   }
 
+  /**
+   * Batched evaluation of the kernel; computes out[i] = K(x.col(i), y) for
+   * every column of x with a single matrix-vector product for the dot
+   * products and a vectorized tanh() for the nonlinearity.
+   *
+   * @param x Matrix of points, one per column.
+   * @param y Vector to evaluate the kernel against.
+   * @param out Vector to store the kernel evaluations in.
+   */
+  void Evaluate(const arma::mat& x, const arma::vec& y, arma::vec& out) const
+  {
+    out = arma::tanh(scale * (arma::trans(x) * y) + offset);
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
@@ -80,6 +94,17 @@ class HyperbolicTangentKernel
   double offset;
 };
 
+//! Kernel traits for the hyperbolic tangent kernel.
+template<>
+class KernelTraits<HyperbolicTangentKernel>
+{
+ public:
+  //! The hyperbolic tangent kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The hyperbolic tangent kernel provides a batched Evaluate().
+  static const bool IsVectorized = true;
+};
+
 }; // namespace kernel
 }; // namespace mlpack
 
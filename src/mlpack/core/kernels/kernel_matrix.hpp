@@ -0,0 +1,199 @@
+/**
+ * @file kernel_matrix.hpp
+ * @author Ryan Curtin
+ *
+ * Utility functions to assemble pairwise kernel matrices.  These are shared by
+ * KernelPCA and the Nystroem method, where kernel matrix construction
+ * dominates the running time.
+ */
+#ifndef __MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define __MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the symmetric kernel matrix of the given data, so that
+ * kernelMatrix(i, j) holds the kernel evaluated on points i and j of the
+ * dataset.  Only the upper triangular part is evaluated; the lower triangular
+ * part is filled in by symmetry.  The evaluations are blocked into square
+ * tiles, so that the columns a tile touches stay resident in cache, and the
+ * tiles are divided among the threads when OpenMP is available.
+ *
+ * @param data Dataset to compute the kernel matrix of (one point per column).
+ * @param kernelMatrix Matrix to store the kernel matrix in.
+ * @param kernel Instantiated kernel to use.
+ */
+template<typename KernelType>
+void ComputeKernelMatrix(const arma::mat& data,
+                         arma::mat& kernelMatrix,
+                         KernelType& kernel)
+{
+  kernelMatrix.set_size(data.n_cols, data.n_cols);
+
+  // The number of columns in a tile; a pair of tiles should fit comfortably
+  // in L2 cache for reasonable dimensionalities.
+  const size_t blockSize = 64;
+  const size_t blocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  // Only the tiles on or above the diagonal need to be computed; they are
+  // flattened into a single list so that they can be divided among the
+  // threads.  The diagonal tiles contain fewer evaluations than the others,
+  // so the schedule is dynamic.  The loop index is signed for OpenMP.
+  const size_t totalTiles = (blocks * (blocks + 1)) / 2;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long t = 0; t < (long) totalTiles; t++)
+  {
+    // Unflatten the tile index into a (row, column) tile pair.
+    size_t bi = 0;
+    size_t offset = (size_t) t;
+    while (offset >= blocks - bi)
+    {
+      offset -= (blocks - bi);
+      bi++;
+    }
+    const size_t bj = bi + offset;
+
+    const size_t iEnd = std::min((bi + 1) * blockSize, (size_t) data.n_cols);
+    const size_t jEnd = std::min((bj + 1) * blockSize, (size_t) data.n_cols);
+
+    for (size_t i = bi * blockSize; i < iEnd; ++i)
+    {
+      // In a diagonal tile, only the upper triangular part is needed.
+      for (size_t j = std::max(i, bj * blockSize); j < jEnd; ++j)
+      {
+        kernelMatrix(i, j) = kernel.Evaluate(data.unsafe_col(i),
+                                             data.unsafe_col(j));
+      }
+    }
+  }
+
+  // Copy to the lower triangular part of the matrix.
+  for (size_t i = 1; i < data.n_cols; ++i)
+    for (size_t j = 0; j < i; ++j)
+      kernelMatrix(i, j) = kernelMatrix(j, i);
+}
+
+/**
+ * Compute the rectangular kernel matrix between two datasets, so that
+ * kernelMatrix(i, j) holds the kernel evaluated on point i of dataA and point
+ * j of dataB.  The evaluations are blocked into tiles for cache reuse, and
+ * the tiles are divided among the threads when OpenMP is available.
+ *
+ * @param dataA First dataset (one point per column).
+ * @param dataB Second dataset (one point per column).
+ * @param kernelMatrix Matrix to store the kernel matrix in.
+ * @param kernel Instantiated kernel to use.
+ */
+template<typename KernelType>
+void ComputeKernelMatrix(const arma::mat& dataA,
+                         const arma::mat& dataB,
+                         arma::mat& kernelMatrix,
+                         KernelType& kernel)
+{
+  kernelMatrix.set_size(dataA.n_cols, dataB.n_cols);
+
+  const size_t blockSize = 64;
+
+  // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long b = 0; b < (long) dataA.n_cols; b += (long) blockSize)
+  {
+    const size_t iEnd = std::min((size_t) b + blockSize,
+        (size_t) dataA.n_cols);
+
+    for (size_t bj = 0; bj < dataB.n_cols; bj += blockSize)
+    {
+      const size_t jEnd = std::min(bj + blockSize, (size_t) dataB.n_cols);
+
+      for (size_t i = (size_t) b; i < iEnd; ++i)
+        for (size_t j = bj; j < jEnd; ++j)
+          kernelMatrix(i, j) = kernel.Evaluate(dataA.unsafe_col(i),
+                                               dataB.unsafe_col(j));
+    }
+  }
+}
+
+/**
+ * Overload for the linear kernel: the whole kernel matrix is the Gram matrix
+ * of the data, so it reduces to a single matrix-matrix product.
+ */
+inline void ComputeKernelMatrix(const arma::mat& data,
+                                arma::mat& kernelMatrix,
+                                LinearKernel& /* kernel */)
+{
+  kernelMatrix = arma::trans(data) * data;
+}
+
+/**
+ * Overload for the linear kernel between two datasets; this also reduces to a
+ * single matrix-matrix product.
+ */
+inline void ComputeKernelMatrix(const arma::mat& dataA,
+                                const arma::mat& dataB,
+                                arma::mat& kernelMatrix,
+                                LinearKernel& /* kernel */)
+{
+  kernelMatrix = arma::trans(dataA) * dataB;
+}
+
+/**
+ * Overload for the Gaussian kernel: the squared distances are expanded as
+ * || x ||^2 + || y ||^2 - 2 x^T y, so the dominant cost is a single
+ * matrix-matrix product over the data, followed by cheap elementwise work on
+ * the result.
+ */
+inline void ComputeKernelMatrix(const arma::mat& data,
+                                arma::mat& kernelMatrix,
+                                GaussianKernel& kernel)
+{
+  // Squared norms of the points, and the Gram matrix in one gemm.
+  const arma::rowvec norms = arma::sum(data % data, 0);
+  kernelMatrix = arma::trans(data) * data;
+
+  const double gamma = kernel.Gamma();
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long j = 0; j < (long) kernelMatrix.n_cols; ++j)
+    for (size_t i = 0; i < kernelMatrix.n_rows; ++i)
+      kernelMatrix(i, j) = std::exp(gamma * (norms[i] + norms[j] -
+          2.0 * kernelMatrix(i, j)));
+}
+
+/**
+ * Overload for the Gaussian kernel between two datasets, using the same
+ * expansion of the squared distances around one matrix-matrix product.
+ */
+inline void ComputeKernelMatrix(const arma::mat& dataA,
+                                const arma::mat& dataB,
+                                arma::mat& kernelMatrix,
+                                GaussianKernel& kernel)
+{
+  // Squared norms of the points, and the cross Gram matrix in one gemm.
+  const arma::rowvec normsA = arma::sum(dataA % dataA, 0);
+  const arma::rowvec normsB = arma::sum(dataB % dataB, 0);
+  kernelMatrix = arma::trans(dataA) * dataB;
+
+  const double gamma = kernel.Gamma();
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long j = 0; j < (long) kernelMatrix.n_cols; ++j)
+    for (size_t i = 0; i < kernelMatrix.n_rows; ++i)
+      kernelMatrix(i, j) = std::exp(gamma * (normsA[i] + normsB[j] -
+          2.0 * kernelMatrix(i, j)));
+}
+
+}; // namespace kernel
+}; // namespace mlpack
+
+#endif
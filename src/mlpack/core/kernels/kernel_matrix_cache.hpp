@@ -0,0 +1,209 @@
+/**
+ * @file kernel_matrix_cache.hpp
+ * @author Ryan Curtin
+ *
+ * A disk-backed cache of kernel matrices, for workloads that recompute the
+ * kernel matrix of mostly-unchanged data over and over (such as nightly
+ * KernelPCA or Nystroem runs).
+ */
+#ifndef __MLPACK_CORE_KERNELS_KERNEL_MATRIX_CACHE_HPP
+#define __MLPACK_CORE_KERNELS_KERNEL_MATRIX_CACHE_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * A disk-backed cache around ComputeKernelMatrix().  Cache entries are keyed
+ * by the kernel type and parameters (taken from the kernel's ToString(), with
+ * the object address stripped) and a hash of the dataset contents, computed
+ * over blocks of columns.  On a hit the matrix is loaded from a cache file in
+ * Armadillo binary format instead of being recomputed; on a miss it is
+ * computed and stored for the next run.
+ *
+ * The cache directory must already exist, and entries are never evicted, so
+ * the caller is responsible for eventually cleaning the directory up.  Any
+ * change to the dataset or the kernel parameters changes the key, so stale
+ * entries are never returned -- they just stop being referenced.
+ *
+ * @tparam KernelType The kernel to evaluate; it must implement ToString().
+ */
+template<typename KernelType>
+class KernelMatrixCache
+{
+ public:
+  /**
+   * Create the cache.  This does not touch the disk; files are only read and
+   * written when Symmetric() or Rectangular() is called.
+   *
+   * @param directory Directory holding the cache files (must exist).
+   * @param kernel Instantiated kernel to use for computation.
+   */
+  KernelMatrixCache(const std::string& directory, KernelType& kernel) :
+      directory(directory),
+      kernel(kernel)
+  { /* Nothing to do. */ }
+
+  /**
+   * Get the symmetric kernel matrix of the given data (see
+   * ComputeKernelMatrix()), loading it from the cache when possible.
+   *
+   * @param data Dataset to compute the kernel matrix of.
+   * @param kernelMatrix Matrix to store the kernel matrix in.
+   */
+  void Symmetric(const arma::mat& data, arma::mat& kernelMatrix)
+  {
+    const std::string file = FileName(data);
+    if (Load(file, data.n_cols, data.n_cols, kernelMatrix))
+      return;
+
+    ComputeKernelMatrix(data, kernelMatrix, kernel);
+    Store(file, kernelMatrix);
+  }
+
+  /**
+   * Get the rectangular kernel matrix between the two given datasets (see
+   * ComputeKernelMatrix()), loading it from the cache when possible.
+   *
+   * @param dataA First dataset.
+   * @param dataB Second dataset.
+   * @param kernelMatrix Matrix to store the kernel matrix in.
+   */
+  void Rectangular(const arma::mat& dataA,
+                   const arma::mat& dataB,
+                   arma::mat& kernelMatrix)
+  {
+    const std::string file = FileName(dataA, &dataB);
+    if (Load(file, dataA.n_cols, dataB.n_cols, kernelMatrix))
+      return;
+
+    ComputeKernelMatrix(dataA, dataB, kernelMatrix, kernel);
+    Store(file, kernelMatrix);
+  }
+
+  /**
+   * Return the name of the cache file that holds the kernel matrix of the
+   * given dataset (or pair of datasets, for the rectangular case).  This is
+   * useful for removing entries.
+   *
+   * @param dataA First dataset.
+   * @param dataB Second dataset, for the rectangular case (or NULL).
+   */
+  std::string FileName(const arma::mat& dataA,
+                       const arma::mat* dataB = NULL) const
+  {
+    // The kernel's ToString() includes its parameters, but it also includes
+    // the address of the object; strip the address so that the key is stable
+    // across runs.
+    std::string signature = kernel.ToString();
+    const size_t open = signature.find(" [");
+    const size_t newline = signature.find('\n');
+    if ((open != std::string::npos) && (newline != std::string::npos) &&
+        (open < newline))
+      signature.erase(open, newline - open);
+
+    // Seed with the FNV-1a offset basis.
+    size_t hash = HashBytes(signature.c_str(), signature.length(),
+        (size_t) 0xcbf29ce484222325ULL);
+    hash = HashMatrix(dataA, hash);
+    if (dataB != NULL)
+      hash = HashMatrix(*dataB, hash);
+
+    std::ostringstream name;
+    name << directory << "/kernel_" << std::hex << hash << ".bin";
+    return name.str();
+  }
+
+  //! Get the cache directory.
+  const std::string& Directory() const { return directory; }
+
+ private:
+  /**
+   * Load a cache entry, returning false (without touching the log) if the
+   * file does not exist or cannot be read.  An entry of unexpected size --
+   * possible only through a hash collision or a corrupt file -- is treated as
+   * a miss as well.
+   */
+  bool Load(const std::string& file,
+            const size_t rows,
+            const size_t cols,
+            arma::mat& kernelMatrix) const
+  {
+    if (!kernelMatrix.quiet_load(file, arma::arma_binary))
+      return false;
+
+    if ((kernelMatrix.n_rows != rows) || (kernelMatrix.n_cols != cols))
+    {
+      Log::Warn << "KernelMatrixCache: entry '" << file << "' has the wrong "
+          << "size (" << kernelMatrix.n_rows << " x " << kernelMatrix.n_cols
+          << "); recomputing." << std::endl;
+      return false;
+    }
+
+    Log::Info << "KernelMatrixCache: loaded '" << file << "'." << std::endl;
+    return true;
+  }
+
+  //! Store a cache entry, warning (but not failing) if the file cannot be
+  //! written.
+  void Store(const std::string& file, const arma::mat& kernelMatrix) const
+  {
+    if (!kernelMatrix.quiet_save(file, arma::arma_binary))
+      Log::Warn << "KernelMatrixCache: could not write entry '" << file
+          << "'." << std::endl;
+    else
+      Log::Info << "KernelMatrixCache: stored '" << file << "'." << std::endl;
+  }
+
+  //! Mix the given bytes into an FNV-1a hash (truncated to size_t on 32-bit
+  //! platforms).
+  static size_t HashBytes(const void* buffer,
+                          const size_t length,
+                          size_t hash)
+  {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(
+        buffer);
+    for (size_t i = 0; i < length; ++i)
+    {
+      hash ^= (size_t) bytes[i];
+      hash *= (size_t) 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  //! Mix a matrix into the hash: first its dimensions, then its contents in
+  //! blocks of columns (each block is one contiguous streaming pass).
+  static size_t HashMatrix(const arma::mat& data, size_t hash)
+  {
+    const size_t rows = data.n_rows;
+    const size_t cols = data.n_cols;
+    hash = HashBytes(&rows, sizeof(size_t), hash);
+    hash = HashBytes(&cols, sizeof(size_t), hash);
+
+    const size_t blockSize = 64;
+    for (size_t begin = 0; begin < cols; begin += blockSize)
+    {
+      const size_t blockCols = std::min(blockSize, cols - begin);
+      hash = HashBytes(data.colptr(begin),
+          blockCols * rows * sizeof(double), hash);
+    }
+
+    return hash;
+  }
+
+  //! Directory holding the cache files.
+  std::string directory;
+  //! The kernel to evaluate on cache misses (and whose parameters form part
+  //! of the cache key).
+  KernelType& kernel;
+};
+
+}; // namespace kernel
+}; // namespace mlpack
+
+#endif
@@ -26,6 +26,14 @@ class KernelTraits
    * If true, then the kernel is normalized: K(x, x) = K(y, y) = 1 for all x.
    */
   static const bool IsNormalized = false;
+
+  /**
+   * If true, then the kernel provides the batched evaluation
+   * Evaluate(const arma::mat& x, const arma::vec& y, arma::vec& out), which
+   * computes out[i] = K(x.col(i), y) for every column of x with vectorized
+   * operations instead of one scalar Evaluate() call per pair.
+   */
+  static const bool IsVectorized = false;
 };
 
 }; // namespace kernel
@@ -72,6 +72,30 @@ class LaplacianKernel
     return exp(-t / bandwidth);
   }
 
+  /**
+   * Batched evaluation of the kernel; computes out[i] = K(x.col(i), y) for
+   * every column of x.  The squared distances are expanded as
+   * @f$ || x ||^2 + || y ||^2 - 2 x^T y @f$, so the dominant cost is a single
+   * matrix-vector product.
+   *
+   * @param x Matrix of points, one per column.
+   * @param y Vector to evaluate the kernel against.
+   * @param out Vector to store the kernel evaluations in.
+   */
+  void Evaluate(const arma::mat& x, const arma::vec& y, arma::vec& out) const
+  {
+    out = arma::trans(x) * y;
+    const arma::rowvec norms = arma::sum(x % x, 0);
+    const double yNorm = arma::dot(y, y);
+    for (size_t i = 0; i < out.n_elem; ++i)
+    {
+      // Guard against small negative values introduced by roundoff.
+      const double squaredDist = std::max(0.0,
+          norms[i] + yNorm - 2.0 * out[i]);
+      out[i] = exp(-sqrt(squaredDist) / bandwidth);
+    }
+  }
+
   //! Get the bandwidth.
   double Bandwidth() const { return bandwidth; }
   //! Modify the bandwidth.
@@ -98,6 +122,8 @@ class KernelTraits<LaplacianKernel>
  public:
   //! The Laplacian kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Laplacian kernel provides a batched Evaluate().
+  static const bool IsVectorized = true;
 };
 
 }; // namespace kernel
@@ -48,6 +48,19 @@ class LinearKernel
     return arma::dot(a, b);
   }
 
+  /**
+   * Batched evaluation of the kernel; computes out[i] = K(x.col(i), y) for
+   * every column of x as a single matrix-vector product.
+   *
+   * @param x Matrix of points, one per column.
+   * @param y Vector to evaluate the kernel against.
+   * @param out Vector to store the kernel evaluations in.
+   */
+  static void Evaluate(const arma::mat& x, const arma::vec& y, arma::vec& out)
+  {
+    out = arma::trans(x) * y;
+  }
+
   //! Return a string representation of the kernel.
   std::string ToString() const
   {
@@ -57,6 +70,17 @@ class LinearKernel
   }
 };
 
+//! Kernel traits for the linear kernel.
+template<>
+class KernelTraits<LinearKernel>
+{
+ public:
+  //! The linear kernel is not normalized: K(x, x) = || x ||^2.
+  static const bool IsNormalized = false;
+  //! The linear kernel provides a batched Evaluate().
+  static const bool IsVectorized = true;
+};
+
 }; // namespace kernel
 }; // namespace mlpack
 
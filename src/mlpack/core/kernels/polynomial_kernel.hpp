@@ -50,6 +50,20 @@ class PolynomialKernel
     return pow((arma::dot(a, b) + offset), degree);
   }
 
+  /**
+   * Batched evaluation of the kernel; computes out[i] = K(x.col(i), y) for
+   * every column of x with a single matrix-vector product for the dot
+   * products and a vectorized pow() for the polynomial.
+   *
+   * @param x Matrix of points, one per column.
+   * @param y Vector to evaluate the kernel against.
+   * @param out Vector to store the kernel evaluations in.
+   */
+  void Evaluate(const arma::mat& x, const arma::vec& y, arma::vec& out) const
+  {
+    out = arma::pow(arma::trans(x) * y + offset, degree);
+  }
+
   //! Get the degree of the polynomial.
   const double& Degree() const { return degree; }
   //! Modify the degree of the polynomial.
@@ -77,6 +91,17 @@ class PolynomialKernel
   double offset;
 };
 
+//! Kernel traits for the polynomial kernel.
+template<>
+class KernelTraits<PolynomialKernel>
+{
+ public:
+  //! The polynomial kernel is not normalized: K(x, x) != 1 in general.
+  static const bool IsNormalized = false;
+  //! The polynomial kernel provides a batched Evaluate().
+  static const bool IsVectorized = true;
+};
+
 }; // namespace kernel
 }; // namespace mlpack
 
@@ -10,10 +10,29 @@
  */
 #include "pspectrum_string_kernel.hpp"
 
+#include <algorithm>
+
 using namespace std;
 using namespace mlpack;
 using namespace mlpack::kernel;
 
+namespace {
+
+/**
+ * Map an alphanumeric character to a nonzero base-37 digit (case is folded),
+ * or to 0 if the character is not alphanumeric.
+ */
+inline size_t CharValue(const char c)
+{
+  if (isdigit(c))
+    return (size_t) (c - '0') + 1;
+  if (isalpha(c))
+    return (size_t) (tolower(c) - 'a') + 11;
+  return 0;
+}
+
+}; // namespace
+
 /**
  * Initialize the PSpectrumStringKernel with the given string datasets.  For
  * more information on this, see the general class documentation.
@@ -32,6 +51,12 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
   Log::Info << "Assembling counts of substrings of length " << p << "."
       << std::endl;
 
+  // The place value of the character leaving the rolling hash window (37^(p -
+  // 1), with wraparound for large p).
+  size_t highPow = 1;
+  for (size_t j = 1; j < p; ++j)
+    highPow *= 37;
+
   // Resize for number of datasets.
   counts.resize(datasets.size());
 
@@ -42,42 +67,81 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
     // Resize for number of strings in dataset.
     counts[dataset].resize(set.size());
 
-    // Inspect each string in the dataset.
-    for (size_t index = 0; index < set.size(); ++index)
+    // Each string is independent of the others, so the strings of a dataset
+    // can be divided among the threads.  The loop index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long index = 0; index < (long) set.size(); ++index)
     {
       // Convenience references.
       const std::string& str = set[index];
-      std::map<std::string, int>& mapping = counts[dataset][index];
+      CountTable& table = counts[dataset][index];
+
+      // Hash every window of length p, sliding the rolling hash one character
+      // at a time instead of rehashing the whole substring.
+      std::vector<size_t> hashes;
+      if (str.length() >= p)
+        hashes.reserve(str.length() - p + 1);
+
+      size_t hash = 0;
+      size_t validStart = 0; // First position not covering an invalid char.
+      for (size_t i = 0; i < str.length(); ++i)
+      {
+        const size_t incoming = CharValue(str[i]);
+        if (incoming == 0)
+          validStart = i + 1; // Only consider windows with alphanumerics.
+
+        // Slide the window: drop the outgoing character, take the new one in.
+        if (i >= p)
+          hash -= CharValue(str[i - p]) * highPow;
+        hash = hash * 37 + incoming;
 
-      size_t start = 0;
-      while ((start + p) <= str.length())
+        // The window [i - p + 1, i] is complete and alphanumeric throughout.
+        if ((i + 1 >= p) && (validStart + p <= i + 1))
+          hashes.push_back(hash);
+      }
+
+      // Collapse the sorted hashes into a flat table of (hash, count) pairs.
+      std::sort(hashes.begin(), hashes.end());
+
+      for (size_t j = 0; j < hashes.size(); ++j)
       {
-        string sub = str.substr(start, p);
-
-        // Convert all characters to lowercase.
-        bool invalid = false;
-        for (size_t j = 0; j < p; ++j)
-        {
-          if (!isalnum(sub[j]))
-          {
-            invalid = true;
-            break; // Only consider substrings with alphanumerics.
-          }
-
-          sub[j] = tolower(sub[j]);
-        }
-
-        // Increment position in string.
-        ++start;
-
-        if (!invalid)
-        {
-          // Add to the map.
-          ++mapping[sub];
-        }
+        if (!table.empty() && (table.back().first == hashes[j]))
+          ++table.back().second;
+        else
+          table.push_back(std::make_pair(hashes[j], 1));
       }
     }
   }
 
   Log::Info << "Substring extraction complete." << std::endl;
 }
+
+size_t mlpack::kernel::PSpectrumStringKernel::HashSubstring(
+    const std::string& substring)
+{
+  size_t hash = 0;
+  for (size_t i = 0; i < substring.length(); ++i)
+    hash = hash * 37 + CharValue(substring[i]);
+
+  return hash;
+}
+
+int mlpack::kernel::PSpectrumStringKernel::Count(
+    const size_t dataset,
+    const size_t index,
+    const std::string& substring) const
+{
+  const CountTable& table = counts[dataset][index];
+
+  // The table is sorted by hash, so the substring can be binary searched.
+  const std::pair<size_t, int> key(HashSubstring(substring), 0);
+  CountTable::const_iterator it = std::lower_bound(table.begin(), table.end(),
+      key);
+
+  if ((it != table.end()) && ((*it).first == key.first))
+    return (*it).second;
+
+  return 0;
+}
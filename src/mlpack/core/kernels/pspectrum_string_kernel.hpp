@@ -11,8 +11,8 @@
 #ifndef __MLPACK_CORE_KERNELS_PSPECTRUM_STRING_KERNEL_HPP
 #define __MLPACK_CORE_KERNELS_PSPECTRUM_STRING_KERNEL_HPP
 
-#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <mlpack/core.hpp>
@@ -55,10 +55,22 @@ namespace kernel {
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
  * very least, it will work with that.
+ *
+ * Internally, the substring counts of each string are stored as a flat array
+ * of (hash, count) pairs sorted by hash, where the hash is a base-37 rolling
+ * hash of the lowercased substring.  For p <= 12 (on systems with a 64-bit
+ * size_t) the hash is an exact encoding of the substring, so there are no
+ * collisions at all; for larger p the hash wraps around and two different
+ * substrings collide with vanishing probability.  A kernel evaluation is then
+ * a single merge pass over two sorted arrays.
  */
 class PSpectrumStringKernel
 {
  public:
+  //! The type of the substring count table built for each string: (hash,
+  //! count) pairs sorted by hash.
+  typedef std::vector<std::pair<size_t, int> > CountTable;
+
   /**
    * Initialize the PSpectrumStringKernel with the given string datasets.  For
    * more information on this, see the general class documentation.
@@ -83,11 +95,34 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
-  //! Access the lists of substrings.
-  const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
+  /**
+   * Return the number of times the given substring (of length p) occurs in
+   * the given string, or 0 if it does not occur.  This is a binary search in
+   * the string's count table; it is meant for inspection and testing, not for
+   * kernel evaluation (Evaluate() merges whole tables instead).
+   *
+   * @param dataset Index of the dataset the string belongs to.
+   * @param index Index of the string in the dataset.
+   * @param substring Substring to count the occurrences of.
+   */
+  int Count(const size_t dataset,
+            const size_t index,
+            const std::string& substring) const;
+
+  /**
+   * Compute the hash a substring is filed under in the count tables.  The
+   * hash is computed over the lowercased characters, so "ABC" and "abc" hash
+   * identically.
+   *
+   * @param substring Substring to hash.
+   */
+  static size_t HashSubstring(const std::string& substring);
+
+  //! Access the lists of substring counts.
+  const std::vector<std::vector<CountTable> >& Counts() const
   { return counts; }
-  //! Modify the lists of substrings.
-  std::vector<std::vector<std::map<std::string, int> > >& Counts()
+  //! Modify the lists of substring counts.
+  std::vector<std::vector<CountTable> >& Counts()
   { return counts; }
 
   //! Access the value of p.
@@ -113,9 +148,8 @@ class PSpectrumStringKernel
   //! The datasets.
   const std::vector<std::vector<std::string> >& datasets;
 
-  //! Mappings of the datasets to counts of substrings.  Such a huge structure
-  //! is not wonderful...
-  std::vector<std::vector<std::map<std::string, int> > > counts;
+  //! Sorted substring count tables for each string of each dataset.
+  std::vector<std::vector<CountTable> > counts;
 
   //! The value of p to use in calculation.
   size_t p;
@@ -101,6 +101,8 @@ class KernelTraits<SphericalKernel>
  public:
   //! The spherical kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The spherical kernel does not provide a batched Evaluate().
+  static const bool IsVectorized = false;
 };
 
 }; // namespace kernel
@@ -82,6 +82,8 @@ class KernelTraits<TriangularKernel>
  public:
   //! The triangular kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The triangular kernel does not provide a batched Evaluate().
+  static const bool IsVectorized = false;
 };
 
 }; // namespace kernel
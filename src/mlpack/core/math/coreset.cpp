@@ -0,0 +1,88 @@
+/**
+ * @file coreset.cpp
+ * @author Ryan Curtin
+ *
+ * Implementation of sensitivity-sampled weighted coreset construction.
+ */
+#include "coreset.hpp"
+#include "random.hpp"
+
+#include <algorithm>
+
+using namespace mlpack;
+using namespace mlpack::math;
+
+void mlpack::math::Coreset(const arma::mat& dataset,
+                           const size_t coresetSize,
+                           arma::mat& coreset,
+                           arma::vec& weights)
+{
+  const size_t n = dataset.n_cols;
+
+  // If the coreset would not be smaller than the dataset, there is nothing to
+  // summarize.
+  if (coresetSize >= n)
+  {
+    coreset = dataset;
+    weights.ones(n);
+    return;
+  }
+
+  const arma::vec mean = arma::mean(dataset, 1);
+
+  // Sensitivity pass: the squared distance of every point to the mean.  The
+  // points are divided among the threads.
+  arma::vec sqDistances(n);
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  // The loop index is signed for OpenMP.
+  for (long i = 0; i < (long) n; i++)
+  {
+    const arma::vec diff = dataset.col(i) - mean;
+    sqDistances[i] = arma::dot(diff, diff);
+  }
+
+  const double sumSqDistances = arma::accu(sqDistances);
+
+  // The sampling probability of each point, and its cumulative sum for the
+  // inversion sampling below.  If every point coincides with the mean, the
+  // distance term vanishes and the sampling is uniform.
+  arma::vec probabilities(n);
+  if (sumSqDistances > 0.0)
+    probabilities = 0.5 * (1.0 / n) + 0.5 * (sqDistances / sumSqDistances);
+  else
+    probabilities.fill(1.0 / n);
+
+  arma::vec cumulative(n);
+  double runningSum = 0.0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    runningSum += probabilities[i];
+    cumulative[i] = runningSum;
+  }
+  // Guard against the total falling a rounding error short of 1.
+  cumulative[n - 1] = 1.0;
+
+  // Sampling pass: draw coresetSize points with replacement by inverting the
+  // cumulative distribution.  The draws are divided among the threads; the
+  // generators behind math::Random() are thread-safe.
+  coreset.set_size(dataset.n_rows, coresetSize);
+  weights.set_size(coresetSize);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  // The loop index is signed for OpenMP.
+  for (long s = 0; s < (long) coresetSize; s++)
+  {
+    const double u = Random();
+    const size_t index = (size_t) (std::upper_bound(cumulative.begin(),
+        cumulative.end(), u) - cumulative.begin());
+
+    coreset.col(s) = dataset.col(index);
+    // The weight makes weighted sums over the coreset unbiased estimates of
+    // sums over the dataset.
+    weights[s] = 1.0 / (coresetSize * probabilities[index]);
+  }
+}
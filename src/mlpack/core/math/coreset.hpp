@@ -0,0 +1,54 @@
+/**
+ * @file coreset.hpp
+ * @author Ryan Curtin
+ *
+ * Construction of sensitivity-sampled weighted coresets.  A coreset is a
+ * small weighted subset of a dataset on which a clustering objective takes
+ * (approximately) the same value as on the full dataset, so a clustering
+ * method run on the coreset gives statistically equivalent results at a
+ * fraction of the cost.  Consumers take the points together with the
+ * weights: KMeans supports weighted points through KMeans::Weights(), and
+ * GMM/EMFit through the probabilities overload of Estimate().
+ */
+#ifndef __MLPACK_CORE_MATH_CORESET_HPP
+#define __MLPACK_CORE_MATH_CORESET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Build a weighted coreset of the given dataset by sensitivity sampling.
+ * The sensitivity of a point -- an upper bound on the fraction of the
+ * clustering objective the point can be responsible for -- is estimated
+ * from its squared distance to the dataset mean:
+ *
+ *   q(x) = 1/2 * (1/n) + 1/2 * d(x, mean)^2 / sum_y d(y, mean)^2
+ *
+ * and coresetSize points are then sampled with replacement with probability
+ * q(x), each receiving weight 1 / (coresetSize * q(x)) so that weighted
+ * sums over the coreset are unbiased estimates of sums over the dataset.
+ * Far-away points, which single-handedly decide where a centroid must go,
+ * are thus likely to be kept, while dense regions are represented by a few
+ * of their points with correspondingly larger weights.
+ *
+ * Both the sensitivity pass and the sampling pass run in parallel when
+ * OpenMP is available (the sampling draws come from the thread-safe
+ * generators behind math::Random()).  If coresetSize is not smaller than
+ * the number of points, the dataset is returned as-is with unit weights.
+ *
+ * @param dataset Dataset to summarize (one point per column).
+ * @param coresetSize Number of points to sample into the coreset.
+ * @param coreset Matrix to store the coreset points in (one per column).
+ * @param weights Vector to store the weight of each coreset point in.
+ */
+void Coreset(const arma::mat& dataset,
+             const size_t coresetSize,
+             arma::mat& coreset,
+             arma::vec& weights);
+
+}; // namespace math
+}; // namespace mlpack
+
+#endif // __MLPACK_CORE_MATH_CORESET_HPP
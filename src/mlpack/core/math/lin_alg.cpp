@@ -42,6 +42,24 @@ void mlpack::math::Center(const arma::mat& x, arma::mat& xCentered)
   xCentered = x - arma::repmat(rowMean, 1, x.n_cols);
 }
 
+/**
+ * Centers a matrix in-place, subtracting the mean over the columns from each
+ * column of the matrix.
+ */
+void mlpack::math::Center(arma::mat& x)
+{
+  // Get the mean of the elements in each row.
+  const arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+
+  // The columns are independent, so they can be processed in parallel; no
+  // copy of the matrix is made.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long i = 0; i < (long) x.n_cols; ++i)
+    x.col(i) -= rowMean;
+}
+
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
@@ -93,6 +111,83 @@ void mlpack::math::WhitenUsingEig(const arma::mat& x,
   xWhitened = whiteningMatrix * x;
 }
 
+/**
+ * Whitens a matrix in-place using the eigendecomposition of the covariance
+ * matrix.  The whitening matrix is applied one block of columns at a time, so
+ * the extra memory needed is one block rather than a full copy of the matrix.
+ */
+void mlpack::math::WhitenUsingEig(arma::mat& x, arma::mat& whiteningMatrix)
+{
+  arma::mat diag, eigenvectors;
+  arma::vec eigenvalues;
+
+  // Get eigenvectors of covariance of input matrix.
+  eig_sym(eigenvalues, eigenvectors, ccov(x));
+
+  // Generate diagonal matrix using 1 / sqrt(eigenvalues) for each value.
+  VectorPower(eigenvalues, -0.5);
+  diag.zeros(eigenvalues.n_elem, eigenvalues.n_elem);
+  diag.diag() = eigenvalues;
+
+  whiteningMatrix = diag * trans(eigenvectors);
+
+  // Apply the whitening matrix block by block.  The blocks are independent,
+  // so they can be processed in parallel.
+  const long blockSize = 1024;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long start = 0; start < (long) x.n_cols; start += blockSize)
+  {
+    const size_t end = std::min((size_t) (start + blockSize), (size_t)
+        x.n_cols) - 1;
+
+    const arma::mat block = whiteningMatrix * x.cols(start, end);
+    x.cols(start, end) = block;
+  }
+}
+
+/**
+ * Centers and whitens a matrix in-place in one fused pass.  The covariance is
+ * of the centered data regardless of centering, so the decomposition can be
+ * computed up front and each column block is only touched once.
+ */
+void mlpack::math::CenterAndWhitenUsingEig(arma::mat& x,
+                                           arma::mat& whiteningMatrix)
+{
+  // Get the mean of the elements in each row.
+  const arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+
+  arma::mat diag, eigenvectors;
+  arma::vec eigenvalues;
+
+  // ccov() centers the data itself, so the decomposition can be computed
+  // before the matrix is modified.
+  eig_sym(eigenvalues, eigenvectors, ccov(x));
+
+  // Generate diagonal matrix using 1 / sqrt(eigenvalues) for each value.
+  VectorPower(eigenvalues, -0.5);
+  diag.zeros(eigenvalues.n_elem, eigenvalues.n_elem);
+  diag.diag() = eigenvalues;
+
+  whiteningMatrix = diag * trans(eigenvectors);
+
+  // Center and whiten each block of columns in a single pass.
+  const long blockSize = 1024;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long start = 0; start < (long) x.n_cols; start += blockSize)
+  {
+    const size_t end = std::min((size_t) (start + blockSize), (size_t)
+        x.n_cols) - 1;
+
+    arma::mat block = x.cols(start, end);
+    block -= arma::repmat(rowMean, 1, block.n_cols);
+    x.cols(start, end) = whiteningMatrix * block;
+  }
+}
+
 /**
  * Overwrites a dimension-N vector to a random vector on the unit sphere in R^N.
  */
@@ -208,3 +303,88 @@ void mlpack::math::RemoveRows(const arma::mat& input,
     }
   }
 }
+
+/**
+ * Compute a rank-k truncated singular value decomposition of the given matrix
+ * using the randomized range finder of Halko, Martinsson and Tropp.
+ */
+void mlpack::math::RandomizedSvd(arma::mat& u,
+                                 arma::vec& s,
+                                 arma::mat& v,
+                                 const arma::mat& x,
+                                 const size_t rank,
+                                 const size_t powerIterations)
+{
+  // Oversample the range a little; the extra columns are cheap and improve
+  // the approximation considerably.
+  const size_t l = std::min(rank + 10,
+      (size_t) std::min(x.n_rows, x.n_cols));
+
+  // Find an orthonormal basis q that approximately spans the range of x, by
+  // applying x to a block of random vectors.
+  arma::mat q, r;
+  arma::qr_econ(q, r, x * arma::randn<arma::mat>(x.n_cols, l));
+
+  // Subsampled power iterations: applying (x x^T) sharpens the basis towards
+  // the dominant singular vectors.  Re-orthonormalize after every
+  // application, so that roundoff does not collapse the basis onto the
+  // largest singular vector.
+  for (size_t i = 0; i < powerIterations; ++i)
+  {
+    arma::qr_econ(q, r, arma::trans(x) * q);
+    arma::qr_econ(q, r, x * q);
+  }
+
+  // Project x into the basis and decompose the small projected matrix.
+  arma::mat b = arma::trans(q) * x;
+  arma::mat ub;
+  arma::svd_econ(ub, s, v, b);
+
+  // Map the left singular vectors back into the original space, and keep only
+  // the requested number of components.
+  u = q * ub.cols(0, rank - 1);
+  s = s.subvec(0, rank - 1);
+  v = v.cols(0, rank - 1);
+}
+
+/**
+ * Compute the top eigenvalues and eigenvectors of the given symmetric matrix
+ * using the randomized range finder of Halko, Martinsson and Tropp.
+ */
+void mlpack::math::RandomizedEigSym(arma::vec& eigval,
+                                    arma::mat& eigvec,
+                                    const arma::mat& x,
+                                    const size_t rank,
+                                    const size_t powerIterations)
+{
+  // Oversample the range a little; the extra columns are cheap and improve
+  // the approximation considerably.
+  const size_t l = std::min(rank + 10, (size_t) x.n_cols);
+
+  // Find an orthonormal basis q that approximately spans the range of x.
+  // Since x is symmetric, every application of x is also a power iteration
+  // step; re-orthonormalize after each one so that roundoff does not collapse
+  // the basis onto the dominant eigenvector.
+  arma::mat q, r;
+  arma::qr_econ(q, r, x * arma::randn<arma::mat>(x.n_cols, l));
+  for (size_t i = 0; i < powerIterations; ++i)
+    arma::qr_econ(q, r, x * q);
+
+  // Project x into the basis; the projected matrix is small and symmetric.
+  arma::mat b = arma::trans(q) * x * q;
+
+  arma::vec bEigval;
+  arma::mat bEigvec;
+  arma::eig_sym(bEigval, bEigvec, b);
+
+  // eig_sym() returns the eigenvalues in ascending order; take the largest
+  // `rank` of them, reversed into descending order, and map the eigenvectors
+  // back into the original space.
+  eigval.set_size(rank);
+  eigvec.set_size(x.n_rows, rank);
+  for (size_t i = 0; i < rank; ++i)
+  {
+    eigval[i] = bEigval[l - 1 - i];
+    eigvec.col(i) = q * bEigvec.col(l - 1 - i);
+  }
+}
@@ -31,6 +31,15 @@ void VectorPower(arma::vec& vec, const double power);
  */
 void Center(const arma::mat& x, arma::mat& xCentered);
 
+/**
+ * Centers a matrix in-place, subtracting the mean over the columns (a column
+ * vector) from each column of the matrix.  The columns are processed in
+ * parallel when OpenMP is available, and no copy of the matrix is made.
+ *
+ * @param x Matrix to center (will be modified)
+ */
+void Center(arma::mat& x);
+
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
@@ -48,6 +57,28 @@ void WhitenUsingEig(const arma::mat& x,
                     arma::mat& xWhitened,
                     arma::mat& whiteningMatrix);
 
+/**
+ * Whitens a matrix in-place using the eigendecomposition of the covariance
+ * matrix.  The whitening matrix is applied block of columns by block of
+ * columns, so the extra memory needed is one block rather than a full copy of
+ * the matrix, and the blocks are processed in parallel when OpenMP is
+ * available.
+ *
+ * @param x Matrix to whiten (will be modified)
+ * @param whiteningMatrix Matrix to write the whitening matrix into
+ */
+void WhitenUsingEig(arma::mat& x, arma::mat& whiteningMatrix);
+
+/**
+ * Centers and whitens a matrix in-place in one fused pass; equivalent to
+ * Center() followed by the in-place WhitenUsingEig(), but each column block is
+ * only touched once.
+ *
+ * @param x Matrix to center and whiten (will be modified)
+ * @param whiteningMatrix Matrix to write the whitening matrix into
+ */
+void CenterAndWhitenUsingEig(arma::mat& x, arma::mat& whiteningMatrix);
+
 /**
  * Overwrites a dimension-N vector to a random vector on the unit sphere in R^N.
  */
@@ -76,6 +107,102 @@ void RemoveRows(const arma::mat& input,
                 const std::vector<size_t>& rowsToRemove,
                 arma::mat& output);
 
+/**
+ * Compute a rank-k truncated singular value decomposition of the given matrix
+ * using the randomized range finder of Halko, Martinsson and Tropp ("Finding
+ * structure with randomness", 2011).  Only the given number of components is
+ * computed, so the cost is O(rank) passes over the matrix instead of a full
+ * decomposition.  The singular values are returned in descending order.
+ *
+ * @param u Matrix to store the left singular vectors in (one per column).
+ * @param s Vector to store the singular values in, in descending order.
+ * @param v Matrix to store the right singular vectors in (one per column).
+ * @param x Matrix to decompose.
+ * @param rank Number of singular values and vectors to compute.
+ * @param powerIterations Number of subsampled power iterations to perform;
+ *     more iterations give a better approximation of the range of x at the
+ *     cost of one pass over the matrix each.
+ */
+void RandomizedSvd(arma::mat& u,
+                   arma::vec& s,
+                   arma::mat& v,
+                   const arma::mat& x,
+                   const size_t rank,
+                   const size_t powerIterations = 2);
+
+/**
+ * Compute the top eigenvalues and eigenvectors of the given symmetric matrix
+ * using the randomized range finder of Halko, Martinsson and Tropp ("Finding
+ * structure with randomness", 2011).  Unlike arma::eig_sym(), the eigenvalues
+ * are returned in descending order, since the decomposition approximates the
+ * dominant part of the spectrum.
+ *
+ * @param eigval Vector to store the eigenvalues in, in descending order.
+ * @param eigvec Matrix to store the eigenvectors in (one per column).
+ * @param x Symmetric matrix to decompose.
+ * @param rank Number of eigenvalues and eigenvectors to compute.
+ * @param powerIterations Number of subsampled power iterations to perform;
+ *     more iterations give a better approximation of the range of x at the
+ *     cost of one pass over the matrix each.
+ */
+void RandomizedEigSym(arma::vec& eigval,
+                      arma::mat& eigvec,
+                      const arma::mat& x,
+                      const size_t rank,
+                      const size_t powerIterations = 2);
+
+/**
+ * Compute the matrix of pairwise squared Euclidean distances between the
+ * columns of a and the columns of b, so that distances(i, j) holds the squared
+ * distance between a.col(i) and b.col(j).  The squared distances are expanded
+ * as || a ||^2 + || b ||^2 - 2 a^T b, so the dominant cost is a single
+ * matrix-matrix product; this is far faster than evaluating each pair
+ * individually.  The function is templated on the matrix type, so it can also
+ * be used with arma::fmat for single-precision distances.
+ *
+ * Note that because of roundoff in the expansion, very small distances may
+ * differ slightly from their directly-computed values; negative values caused
+ * by roundoff are clamped to zero.
+ *
+ * @param a First set of points (one per column).
+ * @param b Second set of points (one per column).
+ * @param distances Matrix to store the squared distances in.
+ */
+template<typename MatType>
+void PairwiseDistances(const MatType& a, const MatType& b, MatType& distances)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Squared norms of the points, and the cross Gram matrix in one gemm.
+  const arma::Row<ElemType> aNorms = arma::sum(a % a, 0);
+  const arma::Row<ElemType> bNorms = arma::sum(b % b, 0);
+  distances = ElemType(-2) * arma::trans(a) * b;
+
+  // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long j = 0; j < (long) distances.n_cols; ++j)
+    for (size_t i = 0; i < distances.n_rows; ++i)
+      distances(i, j) = std::max(ElemType(0),
+          aNorms[i] + bNorms[j] + distances(i, j));
+}
+
+/**
+ * Compute the matrix of pairwise squared Euclidean distances between the
+ * columns of a single dataset, so that distances(i, j) holds the squared
+ * distance between a.col(i) and a.col(j).  See the two-matrix overload for
+ * details of the computation.
+ *
+ * @param a Set of points (one per column).
+ * @param distances Matrix to store the squared distances in.
+ */
+template<typename MatType>
+void PairwiseDistances(const MatType& a, MatType& distances)
+{
+  PairwiseDistances(a, a, distances);
+}
+
 }; // namespace math
 }; // namespace mlpack
 
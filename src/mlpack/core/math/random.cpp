@@ -32,5 +32,19 @@ namespace math {
   boost::normal_distribution<> randNormalDist;
 #endif
 
+#ifdef _OPENMP
+  // Base seed for the lazily created per-thread generators; see RandGen() in
+  // random.hpp.
+  size_t randBaseSeed = 0;
+
+  // The calling thread's own generator (NULL until its first use).
+  #if BOOST_VERSION >= 104700
+    boost::random::mt19937* threadRandGen = NULL;
+  #else
+    boost::mt19937* threadRandGen = NULL;
+  #endif
+  #pragma omp threadprivate(threadRandGen)
+#endif
+
 }; // namespace math
 }; // namespace mlpack
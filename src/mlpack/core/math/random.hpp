@@ -9,6 +9,10 @@
 #include <mlpack/prereqs.hpp>
 #include <boost/random.hpp>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
 
@@ -38,6 +42,47 @@ namespace math /** Miscellaneous math routines. */ {
   extern boost::normal_distribution<> randNormalDist;
 #endif
 
+// Convenience typedef for the generator type, whose name depends on the Boost
+// version.
+#if BOOST_VERSION >= 104700
+  typedef boost::random::mt19937 RandGenType;
+#else
+  typedef boost::mt19937 RandGenType;
+#endif
+
+#ifdef _OPENMP
+  // The base seed from which the per-thread generators derive their streams;
+  // set by RandomSeed().
+  extern size_t randBaseSeed;
+  // The calling thread's own generator; this is NULL until the thread first
+  // asks for a random number (and always NULL on the master thread, which
+  // uses the global generator).  See RandGen().
+  extern RandGenType* threadRandGen;
+  #pragma omp threadprivate(threadRandGen)
+#endif
+
+/**
+ * Get the random generator of the calling thread.  The master thread uses
+ * the global generator, so single-threaded behavior is unchanged; any other
+ * thread lazily creates its own generator, seeded from the base seed and the
+ * thread number, so that the random routines can be called from inside
+ * OpenMP parallel regions without the threads contending for (and
+ * corrupting) one shared generator.
+ */
+inline RandGenType& RandGen()
+{
+#ifdef _OPENMP
+  if (omp_get_thread_num() != 0)
+  {
+    if (threadRandGen == NULL)
+      threadRandGen = new RandGenType(
+          (uint32_t) (randBaseSeed + omp_get_thread_num()));
+    return *threadRandGen;
+  }
+#endif
+  return randGen;
+}
+
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
  * The seed is casted to a 32-bit integer before being given to the random
@@ -49,6 +94,14 @@ inline void RandomSeed(const size_t seed)
 {
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
+#ifdef _OPENMP
+  // Remember the base seed, so that the per-thread generators (see RandGen())
+  // derive distinct streams from it; reseed this thread's generator if it
+  // already exists.
+  randBaseSeed = seed;
+  if (threadRandGen != NULL)
+    threadRandGen->seed((uint32_t) (seed + omp_get_thread_num()));
+#endif
 #if ARMA_VERSION_MAJOR > 3 || \
     (ARMA_VERSION_MAJOR == 3 && ARMA_VERSION_MINOR >= 930)
   // Armadillo >= 3.930 has its own random number generator internally that we
@@ -63,7 +116,7 @@ inline void RandomSeed(const size_t seed)
 inline double Random()
 {
 #if BOOST_VERSION >= 103900
-  return randUniformDist(randGen);
+  return randUniformDist(RandGen());
 #else
   // Before Boost 1.39, we did not give the random object when we wanted a
   // random number; that gets given at construction time.
@@ -77,7 +130,7 @@ inline double Random()
 inline double Random(const double lo, const double hi)
 {
 #if BOOST_VERSION >= 103900
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * randUniformDist(RandGen());
 #else
   // Before Boost 1.39, we did not give the random object when we wanted a
   // random number; that gets given at construction time.
@@ -91,7 +144,7 @@ inline double Random(const double lo, const double hi)
 inline int RandInt(const int hiExclusive)
 {
 #if BOOST_VERSION >= 103900
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * randUniformDist(RandGen()));
 #else
   // Before Boost 1.39, we did not give the random object when we wanted a
   // random number; that gets given at construction time.
@@ -106,7 +159,7 @@ inline int RandInt(const int lo, const int hiExclusive)
 {
 #if BOOST_VERSION >= 103900
   return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+                               * randUniformDist(RandGen()));
 #else
   // Before Boost 1.39, we did not give the random object when we wanted a
   // random number; that gets given at construction time.
@@ -116,6 +169,74 @@ inline int RandInt(const int lo, const int hiExclusive)
 
 }
 
+/**
+ * Fill the given vector with uniform random numbers in [0, 1).  The calling
+ * thread's generator is fetched only once for the whole batch, so this is
+ * faster than calling Random() in a loop; combined with the per-thread
+ * generators (see RandGen()), different threads can fill batches concurrently
+ * without contending for one shared generator.
+ *
+ * @param n Number of values to generate.
+ * @param out Vector to fill with random values (will be resized).
+ */
+inline void RandomVec(const size_t n, arma::vec& out)
+{
+  out.set_size(n);
+#if BOOST_VERSION >= 103900
+  RandGenType& gen = RandGen();
+  for (size_t i = 0; i < n; ++i)
+    out[i] = randUniformDist(gen);
+#else
+  // Before Boost 1.39, we did not give the random object when we wanted a
+  // random number; that gets given at construction time.
+  for (size_t i = 0; i < n; ++i)
+    out[i] = randUniformDist();
+#endif
+}
+
+/**
+ * Fill the given vector with uniform random numbers in the specified range.
+ *
+ * @param lo Lower bound of the range (inclusive).
+ * @param hi Upper bound of the range (exclusive).
+ * @param n Number of values to generate.
+ * @param out Vector to fill with random values (will be resized).
+ */
+inline void RandomVec(const double lo,
+                      const double hi,
+                      const size_t n,
+                      arma::vec& out)
+{
+  RandomVec(n, out);
+  out = lo + (hi - lo) * out;
+}
+
+/**
+ * Fill the given vector with uniform random integers in [0, hiExclusive).
+ * Like RandomVec(), the calling thread's generator is fetched only once for
+ * the whole batch.
+ *
+ * @param hiExclusive Upper bound of the integers (exclusive).
+ * @param n Number of values to generate.
+ * @param out Vector to fill with random integers (will be resized).
+ */
+inline void RandIntVec(const int hiExclusive,
+                       const size_t n,
+                       arma::Col<size_t>& out)
+{
+  out.set_size(n);
+#if BOOST_VERSION >= 103900
+  RandGenType& gen = RandGen();
+  for (size_t i = 0; i < n; ++i)
+    out[i] = (size_t) std::floor((double) hiExclusive * randUniformDist(gen));
+#else
+  // Before Boost 1.39, we did not give the random object when we wanted a
+  // random number; that gets given at construction time.
+  for (size_t i = 0; i < n; ++i)
+    out[i] = (size_t) std::floor((double) hiExclusive * randUniformDist());
+#endif
+}
+
 /**
  * Generates a normally distributed random number with mean 0 and variance 1.
  */
@@ -136,6 +257,28 @@ inline double RandNormal(const double mean, const double variance)
   return variance * randNormalDist(randGen) + mean;
 }
 
+/**
+ * Fill the given vector with normally distributed random numbers with mean 0
+ * and variance 1.  A local distribution object is used, so that concurrent
+ * batches on different threads do not share the internal state of the global
+ * distribution.
+ *
+ * @param n Number of values to generate.
+ * @param out Vector to fill with random values (will be resized).
+ */
+inline void RandNormalVec(const size_t n, arma::vec& out)
+{
+  out.set_size(n);
+  RandGenType& gen = RandGen();
+#if BOOST_VERSION >= 104700
+  boost::random::normal_distribution<> dist;
+#else
+  boost::normal_distribution<> dist;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    out[i] = dist(gen);
+}
+
 }; // namespace math
 }; // namespace mlpack
 
@@ -10,18 +10,33 @@
 namespace mlpack {
 namespace math {
 
+template<typename T>
+class RangeType;
+
+//! 3.0.0 TODO: break reverse-compatibility by changing RangeType to Range.
+typedef RangeType<double> Range;
+
 /**
- * Simple real-valued range.  It contains an upper and lower bound.
+ * Simple real-valued range.  It contains an upper and lower bound.  The
+ * element type is a template parameter, so that single-precision bounds (and
+ * trees built on them) are possible; the Range typedef is provided for the
+ * common double-precision case.
+ *
+ * @tparam T Type of the bounds (e.g. double or float).
  */
-class Range
+template<typename T>
+class RangeType
 {
  private:
-  double lo; /// The lower bound.
-  double hi; /// The upper bound.
+  T lo; /// The lower bound.
+  T hi; /// The upper bound.
 
  public:
+  //! The type of the bounds.
+  typedef T ElemType;
+
   /** Initialize to an empty set (where lo > hi). */
-  inline Range();
+  inline RangeType();
 
   /***
    * Initialize a range to enclose only the given point (lo = point, hi =
@@ -29,7 +44,7 @@ class Range
    *
    * @param point Point that this range will enclose.
    */
-  inline Range(const double point);
+  inline RangeType(const T point);
 
   /**
    * Initializes to specified range.
@@ -37,41 +52,41 @@ class Range
    * @param lo Lower bound of the range.
    * @param hi Upper bound of the range.
    */
-  inline Range(const double lo, const double hi);
+  inline RangeType(const T lo, const T hi);
 
   //! Get the lower bound.
-  inline double Lo() const { return lo; }
+  inline T Lo() const { return lo; }
   //! Modify the lower bound.
-  inline double& Lo() { return lo; }
+  inline T& Lo() { return lo; }
 
   //! Get the upper bound.
-  inline double Hi() const { return hi; }
+  inline T Hi() const { return hi; }
   //! Modify the upper bound.
-  inline double& Hi() { return hi; }
+  inline T& Hi() { return hi; }
 
   /**
    * Gets the span of the range (hi - lo).
    */
-  inline double Width() const;
+  inline T Width() const;
 
   /**
    * Gets the midpoint of this range.
    */
-  inline double Mid() const;
+  inline T Mid() const;
 
   /**
    * Expands this range to include another range.
    *
    * @param rhs Range to include.
    */
-  inline Range& operator|=(const Range& rhs);
+  inline RangeType& operator|=(const RangeType& rhs);
 
   /**
    * Expands this range to include another range.
    *
    * @param rhs Range to include.
    */
-  inline Range operator|(const Range& rhs) const;
+  inline RangeType operator|(const RangeType& rhs) const;
 
   /**
    * Shrinks this range to be the overlap with another range; this makes an
@@ -79,7 +94,7 @@ class Range
    *
    * @param rhs Other range.
    */
-  inline Range& operator&=(const Range& rhs);
+  inline RangeType& operator&=(const RangeType& rhs);
 
   /**
    * Shrinks this range to be the overlap with another range; this makes an
@@ -87,42 +102,44 @@ class Range
    *
    * @param rhs Other range.
    */
-  inline Range operator&(const Range& rhs) const;
+  inline RangeType operator&(const RangeType& rhs) const;
 
   /**
-   * Scale the bounds by the given double.
+   * Scale the bounds by the given factor.
    *
    * @param d Scaling factor.
    */
-  inline Range& operator*=(const double d);
+  inline RangeType& operator*=(const T d);
 
   /**
-   * Scale the bounds by the given double.
+   * Scale the bounds by the given factor.
    *
    * @param d Scaling factor.
    */
-  inline Range operator*(const double d) const;
+  inline RangeType operator*(const T d) const;
 
   /**
-   * Scale the bounds by the given double.
+   * Scale the bounds by the given factor.
    *
    * @param d Scaling factor.
    */
-  friend inline Range operator*(const double d, const Range& r); // Symmetric.
+  template<typename TT>
+  friend inline RangeType<TT> operator*(const TT d,
+                                        const RangeType<TT>& r); // Symmetric.
 
   /**
    * Compare with another range for strict equality.
    *
    * @param rhs Other range.
    */
-  inline bool operator==(const Range& rhs) const;
+  inline bool operator==(const RangeType& rhs) const;
 
   /**
    * Compare with another range for strict equality.
    *
    * @param rhs Other range.
    */
-  inline bool operator!=(const Range& rhs) const;
+  inline bool operator!=(const RangeType& rhs) const;
 
   /**
    * Compare with another range.  For Range objects x and y, x < y means that x
@@ -130,7 +147,7 @@ class Range
    *
    * @param rhs Other range.
    */
-  inline bool operator<(const Range& rhs) const;
+  inline bool operator<(const RangeType& rhs) const;
 
   /**
    * Compare with another range.  For Range objects x and y, x < y means that x
@@ -138,14 +155,14 @@ class Range
    *
    * @param rhs Other range.
    */
-  inline bool operator>(const Range& rhs) const;
+  inline bool operator>(const RangeType& rhs) const;
 
   /**
    * Determines if a point is contained within the range.
    *
    * @param d Point to check.
    */
-  inline bool Contains(const double d) const;
+  inline bool Contains(const T d) const;
 
   /**
    * Determines if another range overlaps with this one.
@@ -154,7 +171,7 @@ class Range
    *
    * @return true if ranges overlap at all.
    */
-  inline bool Contains(const Range& r) const;
+  inline bool Contains(const RangeType& r) const;
 
   /**
    * Returns a string representation of an object.
@@ -1,51 +1,57 @@
 /**
  * @file range_impl.hpp
  *
- * Implementation of the (inlined) Range class.
+ * Implementation of the (inlined) RangeType class.
  */
 #ifndef __MLPACK_CORE_MATH_RANGE_IMPL_HPP
 #define __MLPACK_CORE_MATH_RANGE_IMPL_HPP
 
 #include "range.hpp"
-#include <float.h>
+#include <limits>
 #include <sstream>
 
 namespace mlpack {
 namespace math {
 
 /**
- * Initialize the range to 0.
+ * Initialize the range to an empty set.
  */
-inline Range::Range() :
-    lo(DBL_MAX), hi(-DBL_MAX) { /* nothing else to do */ }
+template<typename T>
+inline RangeType<T>::RangeType() :
+    lo(std::numeric_limits<T>::max()),
+    hi(-std::numeric_limits<T>::max()) { /* nothing else to do */ }
 
 /**
  * Initialize a range to enclose only the given point.
  */
-inline Range::Range(const double point) :
+template<typename T>
+inline RangeType<T>::RangeType(const T point) :
     lo(point), hi(point) { /* nothing else to do */ }
 
 /**
  * Initializes the range to the specified values.
  */
-inline Range::Range(const double lo, const double hi) :
+template<typename T>
+inline RangeType<T>::RangeType(const T lo, const T hi) :
     lo(lo), hi(hi) { /* nothing else to do */ }
 
 /**
  * Gets the span of the range, hi - lo.  Returns 0 if the range is negative.
  */
-inline double Range::Width() const
+template<typename T>
+inline T RangeType<T>::Width() const
 {
   if (lo < hi)
     return (hi - lo);
   else
-    return 0.0;
+    return 0;
 }
 
 /**
  * Gets the midpoint of this range.
  */
-inline double Range::Mid() const
+template<typename T>
+inline T RangeType<T>::Mid() const
 {
   return (hi + lo) / 2;
 }
@@ -53,7 +59,8 @@ inline double Range::Mid() const
 /**
  * Expands range to include the other range.
  */
-inline Range& Range::operator|=(const Range& rhs)
+template<typename T>
+inline RangeType<T>& RangeType<T>::operator|=(const RangeType& rhs)
 {
   if (rhs.lo < lo)
     lo = rhs.lo;
@@ -63,17 +70,19 @@ inline Range& Range::operator|=(const Range& rhs)
   return *this;
 }
 
-inline Range Range::operator|(const Range& rhs) const
+template<typename T>
+inline RangeType<T> RangeType<T>::operator|(const RangeType& rhs) const
 {
-  return Range((rhs.lo < lo) ? rhs.lo : lo,
-               (rhs.hi > hi) ? rhs.hi : hi);
+  return RangeType((rhs.lo < lo) ? rhs.lo : lo,
+                   (rhs.hi > hi) ? rhs.hi : hi);
 }
 
 /**
  * Shrinks range to be the overlap with another range, becoming an empty
  * set if there is no overlap.
  */
-inline Range& Range::operator&=(const Range& rhs)
+template<typename T>
+inline RangeType<T>& RangeType<T>::operator&=(const RangeType& rhs)
 {
   if (rhs.lo > lo)
     lo = rhs.lo;
@@ -83,16 +92,18 @@ inline Range& Range::operator&=(const Range& rhs)
   return *this;
 }
 
-inline Range Range::operator&(const Range& rhs) const
+template<typename T>
+inline RangeType<T> RangeType<T>::operator&(const RangeType& rhs) const
 {
-  return Range((rhs.lo > lo) ? rhs.lo : lo,
-               (rhs.hi < hi) ? rhs.hi : hi);
+  return RangeType((rhs.lo > lo) ? rhs.lo : lo,
+                   (rhs.hi < hi) ? rhs.hi : hi);
 }
 
 /**
- * Scale the bounds by the given double.
+ * Scale the bounds by the given factor.
  */
-inline Range& Range::operator*=(const double d)
+template<typename T>
+inline RangeType<T>& RangeType<T>::operator*=(const T d)
 {
   lo *= d;
   hi *= d;
@@ -100,7 +111,7 @@ inline Range& Range::operator*=(const double d)
   // Now if we've negated, we need to flip things around so the bound is valid.
   if (lo > hi)
   {
-    double tmp = hi;
+    T tmp = hi;
     hi = lo;
     lo = tmp;
   }
@@ -108,38 +119,42 @@ inline Range& Range::operator*=(const double d)
   return *this;
 }
 
-inline Range Range::operator*(const double d) const
+template<typename T>
+inline RangeType<T> RangeType<T>::operator*(const T d) const
 {
-  double nlo = lo * d;
-  double nhi = hi * d;
+  T nlo = lo * d;
+  T nhi = hi * d;
 
   if (nlo <= nhi)
-    return Range(nlo, nhi);
+    return RangeType(nlo, nhi);
   else
-    return Range(nhi, nlo);
+    return RangeType(nhi, nlo);
 }
 
 // Symmetric case.
-inline Range operator*(const double d, const Range& r)
+template<typename TT>
+inline RangeType<TT> operator*(const TT d, const RangeType<TT>& r)
 {
-  double nlo = r.lo * d;
-  double nhi = r.hi * d;
+  TT nlo = r.lo * d;
+  TT nhi = r.hi * d;
 
   if (nlo <= nhi)
-    return Range(nlo, nhi);
+    return RangeType<TT>(nlo, nhi);
   else
-    return Range(nhi, nlo);
+    return RangeType<TT>(nhi, nlo);
 }
 
 /**
  * Compare with another range for strict equality.
  */
-inline bool Range::operator==(const Range& rhs) const
+template<typename T>
+inline bool RangeType<T>::operator==(const RangeType& rhs) const
 {
   return (lo == rhs.lo) && (hi == rhs.hi);
 }
 
-inline bool Range::operator!=(const Range& rhs) const
+template<typename T>
+inline bool RangeType<T>::operator!=(const RangeType& rhs) const
 {
   return (lo != rhs.lo) || (hi != rhs.hi);
 }
@@ -148,12 +163,14 @@ inline bool Range::operator!=(const Range& rhs) const
  * Compare with another range.  For Range objects x and y, x < y means that x is
  * strictly less than y and does not overlap at all.
  */
-inline bool Range::operator<(const Range& rhs) const
+template<typename T>
+inline bool RangeType<T>::operator<(const RangeType& rhs) const
 {
   return hi < rhs.lo;
 }
 
-inline bool Range::operator>(const Range& rhs) const
+template<typename T>
+inline bool RangeType<T>::operator>(const RangeType& rhs) const
 {
   return lo > rhs.hi;
 }
@@ -161,7 +178,8 @@ inline bool Range::operator>(const Range& rhs) const
 /**
  * Determines if a point is contained within the range.
  */
-inline bool Range::Contains(const double d) const
+template<typename T>
+inline bool RangeType<T>::Contains(const T d) const
 {
   return d >= lo && d <= hi;
 }
@@ -169,7 +187,8 @@ inline bool Range::Contains(const double d) const
 /**
  * Determines if this range overlaps with another range.
  */
-inline bool Range::Contains(const Range& r) const
+template<typename T>
+inline bool RangeType<T>::Contains(const RangeType& r) const
 {
   return lo <= r.hi && hi >= r.lo;
 }
@@ -177,12 +196,14 @@ inline bool Range::Contains(const Range& r) const
 /**
  * Returns a string representation of an object.
  */
-std::string Range::ToString() const
+template<typename T>
+inline std::string RangeType<T>::ToString() const
 {
   std::ostringstream convert;
   convert << "[" << lo << ", " << hi << "]";
   return convert.str();
 }
+
 }; // namespace math
 }; // namespace mlpack
 
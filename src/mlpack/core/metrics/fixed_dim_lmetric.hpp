@@ -0,0 +1,69 @@
+/**
+ * @file fixed_dim_lmetric.hpp
+ * @author Ryan Curtin
+ *
+ * L-metric with the dimensionality fixed at compile time.  When the
+ * dimensionality of the data is known when the code is written (for instance,
+ * fixed-size embeddings), giving the compiler a constant trip count lets it
+ * fully unroll and vectorize the distance loop, which can be significantly
+ * faster than the generic runtime-length loop in LMetric.
+ */
+#ifndef __MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_HPP
+#define __MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * The L_p metric for vectors whose dimensionality is known at compile time.
+ * This computes exactly the same distances as LMetric<Power, TakeRoot>, but
+ * the loop over the dimensions has a constant trip count, so the compiler can
+ * unroll and vectorize it completely.
+ *
+ * This is a drop-in replacement for LMetric anywhere a MetricType template
+ * parameter is taken (NeighborSearch, KMeans, RangeSearch, and so forth):
+ *
+ * @code
+ * // All-nearest-neighbors on 128-dimensional points.
+ * NeighborSearch<NearestNeighborSort, FixedDimLMetric<128> > knn(data);
+ * @endcode
+ *
+ * The behavior is undefined if the vectors passed to Evaluate() do not have
+ * exactly Dimension elements (in debug mode, this is checked).
+ *
+ * @tparam Dimension Dimensionality of the vectors the metric will be
+ *    evaluated on.
+ * @tparam Power Power of metric; i.e. Power = 1 gives the L1-norm (Manhattan
+ *    distance).
+ * @tparam TakeRoot If true, the Power'th root of the result is taken before
+ *    it is returned.  Setting this to false causes the metric to not satisfy
+ *    the Triangle Inequality (be careful!).
+ */
+template<size_t Dimension, int Power = 2, bool TakeRoot = true>
+class FixedDimLMetric
+{
+ public:
+  /***
+   * Default constructor does nothing, but is required to satisfy the Kernel
+   * policy.
+   */
+  FixedDimLMetric() { }
+
+  /**
+   * Computes the distance between two points, which must each have exactly
+   * Dimension elements.
+   */
+  template<typename VecType1, typename VecType2>
+  static double Evaluate(const VecType1& a, const VecType2& b);
+  std::string ToString() const;
+};
+
+}; // namespace metric
+}; // namespace mlpack
+
+// Include implementation.
+#include "fixed_dim_lmetric_impl.hpp"
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file fixed_dim_lmetric_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the FixedDimLMetric class.
+ */
+#ifndef __MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_IMPL_HPP
+#define __MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_IMPL_HPP
+
+// In case it hasn't been included.
+#include "fixed_dim_lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+template<size_t Dimension, int Power, bool TakeRoot>
+template<typename VecType1, typename VecType2>
+double FixedDimLMetric<Dimension, Power, TakeRoot>::Evaluate(
+    const VecType1& a,
+    const VecType2& b)
+{
+  Log::Assert(a.n_elem == Dimension && b.n_elem == Dimension,
+      "FixedDimLMetric::Evaluate(): vector dimensionality does not match the "
+      "Dimension template parameter!");
+
+  // The trip count is a compile-time constant, so the compiler can fully
+  // unroll and vectorize this loop.  The branches on Power below are also
+  // resolved at compile time.
+  double sum = 0;
+  for (size_t i = 0; i < Dimension; i++)
+  {
+    const double d = fabs(a[i] - b[i]);
+    if (Power == 1)
+      sum += d;
+    else if (Power == 2)
+      sum += d * d;
+    else
+      sum += pow(d, Power);
+  }
+
+  // For the L1 metric the root is the identity.
+  if (!TakeRoot || Power == 1)
+    return sum;
+
+  if (Power == 2)
+    return sqrt(sum);
+
+  return pow(sum, (1.0 / Power));
+}
+
+// String conversion.
+template<size_t Dimension, int Power, bool TakeRoot>
+std::string FixedDimLMetric<Dimension, Power, TakeRoot>::ToString() const
+{
+  std::ostringstream convert;
+  convert << "FixedDimLMetric [" << this << "]" << std::endl;
+  convert << "  Dimension: " << Dimension << std::endl;
+  convert << "  Power: " << Power << std::endl;
+  convert << "  TakeRoot: " << (TakeRoot ? "true" : "false") << std::endl;
+  return convert.str();
+}
+
+}; // namespace metric
+}; // namespace mlpack
+
+#endif
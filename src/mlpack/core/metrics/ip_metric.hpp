@@ -30,6 +30,23 @@ class IPMetric
   template<typename Vec1Type, typename Vec2Type>
   double Evaluate(const Vec1Type& a, const Vec2Type& b);
 
+  /**
+   * Precompute and cache the self-kernel value k(x, x) of every point in the
+   * given dataset.  Evaluate() recognizes columns of a bound dataset by
+   * their memory address and looks their self-kernel value up instead of
+   * recomputing it, so the metric between two bound points costs one kernel
+   * evaluation instead of three.  Several datasets may be bound at once
+   * (typically a reference set and a query set).
+   *
+   * The dataset must outlive this metric and must not be modified or
+   * reallocated while it is bound (bind it again after a modification).
+   * Points that are not columns of any bound dataset have their self-kernel
+   * values computed as usual.
+   *
+   * @param dataset Dataset to cache the self-kernel values of.
+   */
+  void BindDataset(const arma::mat& dataset);
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
   //! Modify the kernel.
@@ -39,10 +56,21 @@ class IPMetric
    */
   std::string ToString() const;
  private:
+  /**
+   * Return k(point, point), looking it up in the cache if the point is a
+   * column of a bound dataset.
+   */
+  template<typename VecType>
+  double SelfKernel(const VecType& point);
+
   //! The locally stored kernel, if it is necessary.
   KernelType* localKernel;
   //! The reference to the kernel that is being used.
   KernelType& kernel;
+  //! The datasets whose self-kernel values are cached.
+  std::vector<const arma::mat*> boundSets;
+  //! The cached self-kernel values of each bound dataset.
+  std::vector<arma::vec> selfKernels;
 };
 
 }; // namespace metric
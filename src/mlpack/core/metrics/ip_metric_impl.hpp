@@ -47,10 +47,48 @@ template<typename Vec1Type, typename Vec2Type>
 inline double IPMetric<KernelType>::Evaluate(const Vec1Type& a,
                                              const Vec2Type& b)
 {
-  // This is the metric induced by the kernel function.
-  // Maybe we can do better by caching some of this?
-  return sqrt(kernel.Evaluate(a, a) + kernel.Evaluate(b, b) -
-      2 * kernel.Evaluate(a, b));
+  // This is the metric induced by the kernel function.  The self-kernel
+  // terms are looked up in the cache when the points belong to a bound
+  // dataset (see BindDataset()).
+  return sqrt(SelfKernel(a) + SelfKernel(b) - 2 * kernel.Evaluate(a, b));
+}
+
+template<typename KernelType>
+void IPMetric<KernelType>::BindDataset(const arma::mat& dataset)
+{
+  // If this dataset is already bound, recompute its cache in place.
+  size_t index = boundSets.size();
+  for (size_t i = 0; i < boundSets.size(); ++i)
+    if (boundSets[i] == &dataset)
+      index = i;
+
+  if (index == boundSets.size())
+  {
+    boundSets.push_back(&dataset);
+    selfKernels.push_back(arma::vec());
+  }
+
+  arma::vec& cache = selfKernels[index];
+  cache.set_size(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    cache[i] = kernel.Evaluate(dataset.unsafe_col(i), dataset.unsafe_col(i));
+}
+
+template<typename KernelType>
+template<typename VecType>
+inline double IPMetric<KernelType>::SelfKernel(const VecType& point)
+{
+  // A point belongs to a bound dataset if its memory lies inside that
+  // dataset's memory block; its column index then follows from the offset.
+  const double* pointMem = point.memptr();
+  for (size_t i = 0; i < boundSets.size(); ++i)
+  {
+    const arma::mat& set = *(boundSets[i]);
+    if ((pointMem >= set.memptr()) && (pointMem < set.memptr() + set.n_elem))
+      return selfKernels[i][(pointMem - set.memptr()) / set.n_rows];
+  }
+
+  return kernel.Evaluate(point, point);
 }
 
 // Convert object to string.
@@ -25,10 +25,18 @@ namespace metric {
  *
  * where Q is the covariance matrix.
  *
- * Because each evaluation multiplies (x_1 - x_2) by the covariance matrix, it
- * may be much quicker to use an LMetric and simply stretch the actual dataset
- * itself before performing any evaluations.  However, this class is provided
- * for convenience.
+ * The class holds the upper triangular Cholesky factor R of the covariance
+ * (Q = R^T R), which is recomputed whenever the covariance is set.  Each
+ * evaluation is then a triangular matrix-vector product,
+ * @f$ d(x, y) = || R (x - y) || @f$, which is about half the work of the full
+ * multiply.  If the covariance is not positive definite, the factorization
+ * does not exist and the full multiply is used instead.  Because the factor
+ * is computed when the covariance is set and never during Evaluate(), a
+ * metric whose covariance has been set can safely be shared between threads.
+ *
+ * Because the transform R is linear, it may be much quicker still to use an
+ * LMetric and simply stretch the actual dataset itself before performing any
+ * evaluations.  However, this class is provided for convenience.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -52,7 +60,7 @@ class MahalanobisDistance
    * Initialize the Mahalanobis distance with the empty matrix as covariance.
    * Don't call Evaluate() until you set the covariance with Covariance()!
    */
-  MahalanobisDistance() { }
+  MahalanobisDistance() : useChol(false) { }
 
   /**
    * Initialize the Mahalanobis distance with the identity matrix of the given
@@ -61,7 +69,11 @@ class MahalanobisDistance
    * @param dimensionality Dimesnsionality of the covariance matrix.
    */
   MahalanobisDistance(const size_t dimensionality) :
-      covariance(arma::eye<arma::mat>(dimensionality, dimensionality)) { }
+      covariance(arma::eye<arma::mat>(dimensionality, dimensionality)),
+      useChol(false)
+  {
+    UpdateCholesky();
+  }
 
   /**
    * Initialize the Mahalanobis distance with the given covariance matrix.  The
@@ -69,7 +81,12 @@ class MahalanobisDistance
    *
    * @param covariance The covariance matrix to use for this distance.
    */
-  MahalanobisDistance(const arma::mat& covariance) : covariance(covariance) { }
+  MahalanobisDistance(const arma::mat& covariance) :
+      covariance(covariance),
+      useChol(false)
+  {
+    UpdateCholesky();
+  }
 
   /**
    * Evaluate the distance between the two given points using this Mahalanobis
@@ -94,14 +111,29 @@ class MahalanobisDistance
   const arma::mat& Covariance() const { return covariance; }
 
   /**
-   * Modify the covariance matrix.
+   * Set a new covariance matrix.  The Cholesky factor is recomputed here, so
+   * that Evaluate() never modifies the metric.
    *
-   * @return Reference to the covariance matrix.
+   * @param newCovariance The covariance matrix to use for this distance.
    */
-  arma::mat& Covariance() { return covariance; }
+  void Covariance(const arma::mat& newCovariance)
+  {
+    covariance = newCovariance;
+    UpdateCholesky();
+  }
  private:
+  /**
+   * Recompute the Cholesky factor of the covariance.
+   */
+  void UpdateCholesky();
+
   //! The covariance matrix associated with this distance.
   arma::mat covariance;
+  //! Cached upper triangular Cholesky factor R of the covariance (Q = R^T R).
+  arma::mat chol;
+  //! False if the covariance has no Cholesky factorization (it is not
+  //! symmetric positive definite); then Evaluate() uses the full multiply.
+  bool useChol;
 };
 
 }; // namespace distance
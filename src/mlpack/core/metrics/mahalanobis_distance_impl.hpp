@@ -12,6 +12,25 @@
 namespace mlpack {
 namespace metric {
 
+/**
+ * Recompute the Cholesky factor of the covariance.  With the upper triangular
+ * factor R (Q = R^T R), the quadratic form m^T Q m is simply || R m ||^2,
+ * which is a triangular matrix-vector product per evaluation instead of the
+ * full multiply.  This runs whenever the covariance is set, never during
+ * Evaluate(), so evaluations do not modify the metric.
+ */
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::UpdateCholesky()
+{
+  // If the covariance is not symmetric positive definite, the factorization
+  // does not exist and each evaluation must fall back to the full multiply.
+  useChol = arma::chol(chol, covariance);
+  if (!useChol)
+    Log::Warn << "MahalanobisDistance::Covariance(): the covariance matrix is "
+        << "not symmetric positive definite; falling back to the full "
+        << "quadratic form." << std::endl;
+}
+
 /**
  * Specialization for non-rooted case.
  */
@@ -20,9 +39,15 @@ template<typename VecType1, typename VecType2>
 double MahalanobisDistance<false>::Evaluate(const VecType1& a,
                                             const VecType2& b)
 {
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1
-  return out[0];
+  if (!useChol)
+  {
+    arma::vec m = (a - b);
+    arma::mat out = trans(m) * covariance * m; // 1x1
+    return out[0];
+  }
+
+  arma::vec m = chol * (a - b);
+  return arma::dot(m, m);
 }
 /**
  * Specialization for rooted case.  This requires one extra evaluation of
@@ -35,11 +60,17 @@ double MahalanobisDistance<true>::Evaluate(const VecType1& a,
 {
   // Check if covariance matrix has been initialized.
   if (covariance.n_rows == 0)
-    covariance = arma::eye<arma::mat>(a.n_elem, a.n_elem);
+    Covariance(arma::eye<arma::mat>(a.n_elem, a.n_elem));
+
+  if (!useChol)
+  {
+    arma::vec m = (a - b);
+    arma::mat out = trans(m) * covariance * m; // 1x1
+    return sqrt(out[0]);
+  }
 
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1;
-  return sqrt(out[0]);
+  arma::vec m = chol * (a - b);
+  return sqrt(arma::dot(m, m));
 }
 
 // Convert object into string.
@@ -92,7 +92,11 @@ bool AugLagrangian<LagrangianFunction>::Optimize(arma::mat& coordinates,
 
 //    Log::Warn << trans(coordinates) * coordinates << std::endl;
 
-    if (!lbfgs.Optimize(coordinates))
+    // After the first outer iteration, resume the inner L-BFGS solve from the
+    // previous one: consecutive subproblems differ only in their penalty
+    // terms, so the stored curvature pairs (and the step scaling they give)
+    // are still good approximations and need not be re-learned.
+    if (!lbfgs.Optimize(coordinates, lbfgs.MaxIterations(), (it > 0)))
       Log::Warn << "L-BFGS reported an error during optimization."
           << std::endl;
 
@@ -109,15 +113,15 @@ bool AugLagrangian<LagrangianFunction>::Optimize(arma::mat& coordinates,
     // term is too high, and we update lambda otherwise.
 
     // First, calculate the current penalty.
-    double penalty = 0;
+    double newPenalty = 0;
     for (size_t i = 0; i < function.NumConstraints(); i++)
     {
-      penalty += std::pow(function.EvaluateConstraint(i, coordinates), 2);
+      newPenalty += std::pow(function.EvaluateConstraint(i, coordinates), 2);
 //      Log::Debug << "Constraint " << i << " is " <<
 //          function.EvaluateConstraint(i, coordinates) << std::endl;
     }
 
-    Log::Warn << "Penalty is " << penalty << " (threshold "
+    Log::Warn << "Penalty is " << newPenalty << " (threshold "
         << penaltyThreshold << ")." << std::endl;
 
     for (size_t i = 0; i < function.NumConstraints(); ++i)
@@ -128,7 +132,7 @@ bool AugLagrangian<LagrangianFunction>::Optimize(arma::mat& coordinates,
 //      Log::Debug << tmpgrad << std::endl;
     }
 
-    if (penalty < penaltyThreshold) // We update lambda.
+    if (newPenalty < penaltyThreshold) // We update lambda.
     {
       // We use the update: lambda_{k + 1} = lambda_k - sigma * c(coordinates),
       // but we have to write a loop to do this for each constraint.
@@ -139,17 +143,26 @@ bool AugLagrangian<LagrangianFunction>::Optimize(arma::mat& coordinates,
       // We also update the penalty threshold to be a factor of the current
       // penalty.  TODO: this factor should be a parameter (from CLI).  The
       // value of 0.25 is taken from Burer and Monteiro (2002).
-      penaltyThreshold = 0.25 * penalty;
+      penaltyThreshold = 0.25 * newPenalty;
       Log::Warn << "Lagrange multiplier estimates updated." << std::endl;
     }
     else
     {
-      // We multiply sigma by a constant value.  TODO: this factor should be a
-      // parameter (from CLI).  The value of 10 is taken from Burer and Monteiro
-      // (2002).
-      augfunc.Sigma() *= 10;
+      // Increase sigma, but only as much as the stagnation warrants: if the
+      // penalty still shrank meaningfully since the last outer iteration, a
+      // gentle increase suffices and keeps the next subproblem close to this
+      // one (which also keeps the resumed curvature pairs relevant).  The
+      // aggressive factor of 10 from Burer and Monteiro (2002) is reserved
+      // for true stagnation.  TODO: these factors should be parameters (from
+      // CLI).
+      if (newPenalty < 0.75 * penalty)
+        augfunc.Sigma() *= 2;
+      else
+        augfunc.Sigma() *= 10;
       Log::Warn << "Updated sigma to " << augfunc.Sigma() << "." << std::endl;
     }
+
+    penalty = newPenalty;
   }
 
   return false;
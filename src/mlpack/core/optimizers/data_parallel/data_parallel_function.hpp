@@ -0,0 +1,101 @@
+/**
+ * @file data_parallel_function.hpp
+ * @author Ryan Curtin
+ *
+ * Data-parallel adapter for decomposable objective functions.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_DATA_PARALLEL_FUNCTION_HPP
+#define __MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_DATA_PARALLEL_FUNCTION_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * This class adapts a decomposable objective function (one implementing the
+ * DecomposableFunctionType contract used by SGD) into the whole-objective
+ * FunctionType contract used by batch optimizers such as L_BFGS, evaluating
+ * the sum data-parallel.  Each worker thread owns a contiguous shard of the
+ * individual functions \f$ f_i \f$; Evaluate() and Gradient() compute the
+ * per-shard partial sums independently and then all-reduce them into the
+ * global result.  This is the synchronous data-parallel training scheme: the
+ * (shared) iterate plays the role of the broadcast step, and the combination
+ * of the per-shard partials plays the role of the gradient all-reduce.
+ *
+ * So, for example,
+ *
+ * @code
+ * LogisticRegressionFunction<> lrf(data, responses);
+ * DataParallelFunction<LogisticRegressionFunction<> > parallelLrf(lrf);
+ * L_BFGS<DataParallelFunction<LogisticRegressionFunction<> > >
+ *     lbfgs(parallelLrf);
+ * lbfgs.Optimize(parameters);
+ * @endcode
+ *
+ * trains a logistic regression model with every full-gradient pass divided
+ * among the threads.
+ *
+ * Because the individual Evaluate() and Gradient() calls are issued from
+ * several threads at once, the wrapped function must be safe to call
+ * concurrently for distinct i; this holds for functions that only read their
+ * dataset, such as the data-dependent objectives in the methods directory.
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type to
+ *     be adapted.
+ */
+template<typename DecomposableFunctionType>
+class DataParallelFunction
+{
+ public:
+  /**
+   * Construct the adapter with the given decomposable function.
+   *
+   * @param function Decomposable function to be adapted.
+   */
+  DataParallelFunction(DecomposableFunctionType& function);
+
+  /**
+   * Evaluate the whole objective (the sum of all individual functions) at
+   * the given coordinates, with the sum divided among the threads.
+   *
+   * @param coordinates Point to evaluate at.
+   * @return Value of the whole objective.
+   */
+  double Evaluate(const arma::mat& coordinates);
+
+  /**
+   * Evaluate the whole gradient (the sum of all individual gradients) at the
+   * given coordinates, with the sum divided among the threads.
+   *
+   * @param coordinates Point to evaluate the gradient at.
+   * @param gradient Matrix to store the gradient into.
+   */
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient);
+
+  //! Return the initial point of the wrapped function.
+  const arma::mat& GetInitialPoint() const
+  {
+    return function.GetInitialPoint();
+  }
+
+  //! Get the wrapped function.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the wrapped function.
+  DecomposableFunctionType& Function() { return function; }
+
+  // Convert the object into a string.
+  std::string ToString() const;
+
+ private:
+  //! The wrapped decomposable function.
+  DecomposableFunctionType& function;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+// Include implementation.
+#include "data_parallel_function_impl.hpp"
+
+#endif
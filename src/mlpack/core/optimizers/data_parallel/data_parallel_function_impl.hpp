@@ -0,0 +1,102 @@
+/**
+ * @file data_parallel_function_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the data-parallel adapter for decomposable objective
+ * functions.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_DATA_PARALLEL_FUNCTION_IMPL_HPP
+#define __MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_DATA_PARALLEL_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "data_parallel_function.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType>
+DataParallelFunction<DecomposableFunctionType>::DataParallelFunction(
+    DecomposableFunctionType& function) :
+    function(function)
+{ /* Nothing to do. */ }
+
+template<typename DecomposableFunctionType>
+double DataParallelFunction<DecomposableFunctionType>::Evaluate(
+    const arma::mat& coordinates)
+{
+  const size_t numFunctions = function.NumFunctions();
+  double objective = 0;
+
+  // Each thread sums its shard of the functions, and the partial sums are
+  // all-reduced at the end.  The loop index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    double threadObjective = 0;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (long i = 0; i < (long) numFunctions; ++i)
+      threadObjective += function.Evaluate(coordinates, i);
+
+#ifdef _OPENMP
+    #pragma omp critical (dataParallelReduce)
+#endif
+    objective += threadObjective;
+  }
+
+  return objective;
+}
+
+template<typename DecomposableFunctionType>
+void DataParallelFunction<DecomposableFunctionType>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient)
+{
+  const size_t numFunctions = function.NumFunctions();
+  gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+
+  // Each thread sums the gradients of its shard of the functions into its
+  // own workspace, and the partials are all-reduced at the end.  The loop
+  // index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    arma::mat threadGradient(coordinates.n_rows, coordinates.n_cols);
+    threadGradient.zeros();
+    arma::mat funcGradient(coordinates.n_rows, coordinates.n_cols);
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (long i = 0; i < (long) numFunctions; ++i)
+    {
+      function.Gradient(coordinates, i, funcGradient);
+      threadGradient += funcGradient;
+    }
+
+#ifdef _OPENMP
+    #pragma omp critical (dataParallelReduce)
+#endif
+    gradient += threadGradient;
+  }
+}
+
+// Convert the object to a string.
+template<typename DecomposableFunctionType>
+std::string DataParallelFunction<DecomposableFunctionType>::ToString() const
+{
+  std::ostringstream convert;
+  convert << "DataParallelFunction [" << this << "]" << std::endl;
+  convert << "  Function:" << std::endl;
+  convert << util::Indent(function.ToString(), 2);
+  return convert.str();
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
@@ -9,12 +9,13 @@
 #define __MLPACK_CORE_OPTIMIZERS_LBFGS_LBFGS_HPP
 
 #include <mlpack/core.hpp>
+#include <ctime>
 
 namespace mlpack {
 namespace optimization {
 
 /**
- * The generic L-BFGS optimizer, which uses a back-tracking line search
+ * The generic L-BFGS optimizer, which uses a cubic-interpolating line search
  * algorithm to minimize a function.  The parameters for the algorithm (number
  * of memory points, maximum step size, and so forth) are all configurable via
  * either the constructor or standalone modifier functions.  A function which
@@ -88,11 +89,24 @@ class L_BFGS
    * finishing point of the algorithm, and the final objective value is
    * returned.
    *
+   * If resume is true, the correction pairs stored by the previous Optimize()
+   * call are kept, so the Hessian approximation (and with it the initial step
+   * scaling) carries over instead of being rebuilt from scratch.  This is a
+   * warm start for sequences of closely related problems -- for example, the
+   * successive subproblems of an augmented Lagrangian outer loop, which
+   * differ only in their penalty terms.  The stored pairs describe the
+   * previous objective, so resuming across an unrelated problem will slow
+   * convergence rather than help it; the history is discarded automatically
+   * if the problem dimensionality has changed.
+   *
    * @param iterate Starting point (will be modified).
    * @param maxIterations Maximum number of iterations (0 specifies no limit).
+   * @param resume If true, keep the correction pairs of the previous call.
    * @return Objective value of the final point.
    */
-  double Optimize(arma::mat& iterate, const size_t maxIterations);
+  double Optimize(arma::mat& iterate,
+                  const size_t maxIterations,
+                  const bool resume = false);
 
   //! Return the function that is being optimized.
   const FunctionType& Function() const { return function; }
@@ -139,6 +153,37 @@ class L_BFGS
   //! Modify the maximum line search step size.
   double& MaxStep() { return maxStep; }
 
+  //! Get the checkpoint file ("" means checkpointing is disabled).
+  const std::string& CheckpointFile() const { return checkpointFile; }
+  //! Modify the checkpoint file.  If set, Optimize() periodically snapshots
+  //! the current iterate to this file in the SaveRestoreUtility format, so a
+  //! preempted run can be resumed with LoadCheckpoint().
+  std::string& CheckpointFile() { return checkpointFile; }
+
+  //! Get the number of iterations between checkpoints (0 disables the
+  //! iteration trigger).
+  size_t CheckpointIterations() const { return checkpointIterations; }
+  //! Modify the number of iterations between checkpoints.
+  size_t& CheckpointIterations() { return checkpointIterations; }
+
+  //! Get the number of seconds between checkpoints (0 disables the wall-clock
+  //! trigger).
+  size_t CheckpointSeconds() const { return checkpointSeconds; }
+  //! Modify the number of seconds between checkpoints.
+  size_t& CheckpointSeconds() { return checkpointSeconds; }
+
+  /**
+   * Load the iterate from a checkpoint written by a previous Optimize() run,
+   * so the optimization can be resumed by passing the loaded iterate back to
+   * Optimize().  Note that the stored correction pairs are not part of the
+   * checkpoint, so a resumed run rebuilds its Hessian approximation from
+   * scratch (a warm start, not an exact continuation).
+   *
+   * @param iterate Matrix to store the checkpointed iterate in.
+   * @return True if the checkpoint was read successfully, false otherwise.
+   */
+  bool LoadCheckpoint(arma::mat& iterate) const;
+
   // convert the obkect into a string
   std::string ToString() const;
 
@@ -152,6 +197,13 @@ class L_BFGS
   arma::cube s;
   //! Stores all the y matrices in memory.
   arma::cube y;
+  //! Cached values of 1 / (y^T s) for each stored correction pair; these only
+  //! change when a pair is overwritten, so they are computed once in
+  //! UpdateBasisSet() instead of every two-loop recursion.
+  arma::vec rho;
+  //! Preallocated workspace for the alpha coefficients of the two-loop
+  //! recursion, so SearchDirection() performs no allocations.
+  arma::vec alpha;
 
   //! Size of memory for this L-BFGS optimizer.
   size_t numBasis;
@@ -170,9 +222,20 @@ class L_BFGS
   //! Maximum step of the line search.
   double maxStep;
 
+  //! File the iterate is periodically checkpointed to ("" disables).
+  std::string checkpointFile;
+  //! Iterations between checkpoints (0 disables the iteration trigger).
+  size_t checkpointIterations;
+  //! Seconds between checkpoints (0 disables the wall-clock trigger).
+  size_t checkpointSeconds;
+
   //! Best point found so far.
   std::pair<arma::mat, double> minPointIterate;
 
+  //! Number of correction pairs stored so far; this persists across
+  //! Optimize() calls so that a resumed run can keep its curvature history.
+  size_t updateCount;
+
   /**
    * Evaluate the function at the given iterate point and store the result if it
    * is a new minimum.
@@ -200,15 +263,16 @@ class L_BFGS
   bool GradientNormTooSmall(const arma::mat& gradient);
 
   /**
-   * Perform a back-tracking line search along the search direction to
-   * calculate a step size satisfying the Wolfe conditions.  The parameter
-   * iterate will be modified if the method is successful.
+   * Perform a cubic-interpolating line search along the search direction to
+   * calculate a step size satisfying the strong Wolfe conditions.  The
+   * parameter iterate will be modified if the method is successful; on exit,
+   * functionValue corresponds to iterate whether or not a step was taken
+   * (gradient corresponds to iterate only on success).
    *
    * @param functionValue Value of the function at the initial point
    * @param iterate The initial point to begin the line search from
    * @param gradient The gradient at the initial point
    * @param searchDirection A vector specifying the search direction
-   * @param stepSize Variable the calculated step size will be stored in
    *
    * @return false if no step size is suitable, true otherwise.
    */
@@ -246,6 +310,21 @@ class L_BFGS
                       const arma::mat& oldIterate,
                       const arma::mat& gradient,
                       const arma::mat& oldGradient);
+
+  /**
+   * Write the current iterate to the checkpoint file if either checkpoint
+   * trigger has fired.  This is called between iterations, so the snapshot
+   * is always an accepted point.
+   *
+   * @param iterate Current point.
+   * @param functionValue Objective value at the current point.
+   * @param iterationNum Current iteration number.
+   * @param lastCheckpoint Time of the last checkpoint; updated on write.
+   */
+  void Checkpoint(const arma::mat& iterate,
+                  const double functionValue,
+                  const size_t iterationNum,
+                  std::time_t& lastCheckpoint) const;
 };
 
 }; // namespace optimization
@@ -45,7 +45,11 @@ L_BFGS<FunctionType>::L_BFGS(FunctionType& function,
     minGradientNorm(minGradientNorm),
     maxLineSearchTrials(maxLineSearchTrials),
     minStep(minStep),
-    maxStep(maxStep)
+    maxStep(maxStep),
+    checkpointFile(""),
+    checkpointIterations(0),
+    checkpointSeconds(0),
+    updateCount(0)
 {
   // Get the dimensions of the coordinates of the function; GetInitialPoint()
   // might return an arma::vec, but that's okay because then n_cols will simply
@@ -56,6 +60,8 @@ L_BFGS<FunctionType>::L_BFGS(FunctionType& function,
   newIterateTmp.set_size(rows, cols);
   s.set_size(rows, cols, numBasis);
   y.set_size(rows, cols, numBasis);
+  rho.set_size(numBasis);
+  alpha.set_size(numBasis);
 
   // Allocate the pair holding the min iterate information.
   minPointIterate.first.zeros(rows, cols);
@@ -126,14 +132,19 @@ bool L_BFGS<FunctionType>::GradientNormTooSmall(const arma::mat& gradient)
 }
 
 /**
- * Perform a back-tracking line search along the search direction to calculate a
- * step size satisfying the Wolfe conditions.
+ * Perform a line search along the search direction to calculate a step size
+ * satisfying the strong Wolfe conditions.  The next trial step is chosen as
+ * the minimizer of a cubic model fit through the two most recent probes
+ * (each probe's gradient is already in hand for the Wolfe test, so the model
+ * costs nothing extra); the classic multiplicative backtracking factors are
+ * kept as safeguards and as the fallback when the cubic has no usable
+ * minimizer.  On success, functionValue and gradient hold the values at the
+ * accepted point, so the caller need not re-evaluate anything.
  *
  * @param functionValue Value of the function at the initial point
  * @param iterate The initial point to begin the line search from
  * @param gradient The gradient at the initial point
  * @param searchDirection A vector specifying the search direction
- * @param stepSize Variable the calculated step size will be stored in
  *
  * @return false if no step size is suitable, true otherwise.
  */
@@ -169,10 +180,17 @@ bool L_BFGS<FunctionType>::LineSearch(double& functionValue,
   // The number of iteration in the search.
   size_t numIterations = 0;
 
-  // Armijo step size scaling factor for increase and decrease.
+  // Armijo step size scaling factors for increase and decrease, used to
+  // safeguard the interpolated step and as the fallback when the cubic model
+  // has no usable minimizer.
   const double inc = 2.1;
   const double dec = 0.5;
-  double width = 0;
+
+  // The previous probe of the line search (initially the starting point
+  // itself); the cubic model is fit through this probe and the current one.
+  double prevStep = 0.0;
+  double prevValue = initialFunctionValue;
+  double prevSlope = initialSearchDirectionDotGradient;
 
   while (true)
   {
@@ -184,33 +202,28 @@ bool L_BFGS<FunctionType>::LineSearch(double& functionValue,
     function.Gradient(newIterateTmp, gradient);
     numIterations++;
 
+    // The directional derivative at this probe; it is needed for the Wolfe
+    // test, and it is what makes the cubic model free.
+    const double slope = arma::dot(gradient, searchDirection);
+
+    // Decide whether to accept the probe, or in which direction to move.
+    bool decrease;
     if (functionValue > initialFunctionValue + stepSize *
         linearApproxFunctionValueDecrease)
     {
-      width = dec;
+      decrease = true; // Armijo condition failed; the step is too long.
+    }
+    else if (slope < wolfe * initialSearchDirectionDotGradient)
+    {
+      decrease = false; // Still descending steeply; the step is too short.
+    }
+    else if (slope > -wolfe * initialSearchDirectionDotGradient)
+    {
+      decrease = true; // Overshot the minimizer along the direction.
     }
     else
     {
-      // Check Wolfe's condition.
-      double searchDirectionDotGradient = arma::dot(gradient, searchDirection);
-
-      if (searchDirectionDotGradient < wolfe *
-          initialSearchDirectionDotGradient)
-      {
-        width = inc;
-      }
-      else
-      {
-        if (searchDirectionDotGradient > -wolfe *
-            initialSearchDirectionDotGradient)
-        {
-          width = dec;
-        }
-        else
-        {
-          break;
-        }
-      }
+      break; // The strong Wolfe conditions hold.
     }
 
     // Terminate when the step size gets too small or too big or it
@@ -218,11 +231,44 @@ bool L_BFGS<FunctionType>::LineSearch(double& functionValue,
     if ((stepSize < minStep) || (stepSize > maxStep) ||
         (numIterations >= maxLineSearchTrials))
     {
+      // Restore the function value of the (unmoved) iterate, so that the
+      // caller's cached objective stays correct.
+      functionValue = initialFunctionValue;
       return false;
     }
 
-    // Scale the step size.
-    stepSize *= width;
+    // Choose the next trial step as the minimizer of the cubic through the
+    // previous probe and this one (see section 3.3 of Nocedal and Wright,
+    // "Numerical Optimization").
+    double nextStep = stepSize * (decrease ? dec : inc);
+    const double d1 = prevSlope + slope - 3.0 *
+        (prevValue - functionValue) / (prevStep - stepSize);
+    const double radicand = d1 * d1 - prevSlope * slope;
+    if (radicand >= 0.0)
+    {
+      const double d2 = ((stepSize > prevStep) ? 1.0 : -1.0) *
+          std::sqrt(radicand);
+      const double cubicStep = stepSize - (stepSize - prevStep) *
+          ((slope + d2 - d1) / (slope - prevSlope + 2.0 * d2));
+
+      // Safeguard the interpolated step so that progress never stalls; a
+      // non-finite value (a degenerate cubic) keeps the fallback.
+      if (cubicStep == cubicStep)
+      {
+        if (decrease)
+          nextStep = std::max(0.1 * stepSize, std::min(0.9 * stepSize,
+              cubicStep));
+        else
+          nextStep = std::max(1.1 * stepSize, std::min(10.0 * stepSize,
+              cubicStep));
+      }
+    }
+
+    // This probe becomes the previous one for the next model fit.
+    prevStep = stepSize;
+    prevValue = functionValue;
+    prevSlope = slope;
+    stepSize = nextStep;
   }
 
   // Move to the new iterate.
@@ -248,19 +294,16 @@ void L_BFGS<FunctionType>::SearchDirection(const arma::mat& gradient,
   searchDirection = gradient;
 
   // See "A Recursive Formula to Compute H * g" in "Updating quasi-Newton
-  // matrices with limited storage" (Nocedal, 1980).
-
-  // Temporary variables.
-  arma::vec rho(numBasis);
-  arma::vec alpha(numBasis);
+  // matrices with limited storage" (Nocedal, 1980).  The rho and alpha
+  // workspaces are preallocated members, and the rho values are cached by
+  // UpdateBasisSet(), so this performs no allocations and each loop iteration
+  // reduces to one dot product and one axpy on the stored slices.
 
   size_t limit = (numBasis > iterationNum) ? 0 : (iterationNum - numBasis);
   for (size_t i = iterationNum; i != limit; i--)
   {
     int translatedPosition = (i + (numBasis - 1)) % numBasis;
-    rho[iterationNum - i] = 1.0 / arma::dot(y.slice(translatedPosition),
-                                            s.slice(translatedPosition));
-    alpha[iterationNum - i] = rho[iterationNum - i] *
+    alpha[iterationNum - i] = rho[translatedPosition] *
         arma::dot(s.slice(translatedPosition), searchDirection);
     searchDirection -= alpha[iterationNum - i] * y.slice(translatedPosition);
   }
@@ -270,7 +313,7 @@ void L_BFGS<FunctionType>::SearchDirection(const arma::mat& gradient,
   for (size_t i = limit; i < iterationNum; i++)
   {
     int translatedPosition = i % numBasis;
-    double beta = rho[iterationNum - i - 1] *
+    double beta = rho[translatedPosition] *
         arma::dot(y.slice(translatedPosition), searchDirection);
     searchDirection += (alpha[iterationNum - i - 1] - beta) *
         s.slice(translatedPosition);
@@ -303,6 +346,12 @@ void L_BFGS<FunctionType>::UpdateBasisSet(const size_t iterationNum,
   int overwritePos = iterationNum % numBasis;
   s.slice(overwritePos) = iterate - oldIterate;
   y.slice(overwritePos) = gradient - oldGradient;
+
+  // Cache 1 / (y^T s) for this correction pair; it does not change until the
+  // slot is overwritten, so SearchDirection() need not recompute it during
+  // every two-loop recursion.
+  rho[overwritePos] = 1.0 / arma::dot(y.slice(overwritePos),
+                                      s.slice(overwritePos));
 }
 
 /**
@@ -335,15 +384,24 @@ inline double L_BFGS<FunctionType>::Optimize(arma::mat& iterate)
  */
 template<typename FunctionType>
 double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
-                                      const size_t maxIterations)
+                                      const size_t maxIterations,
+                                      const bool resume)
 {
   // Ensure that the cubes holding past iterations' information are the right
   // size.  Also set the current best point value to the maximum.
   const size_t rows = function.GetInitialPoint().n_rows;
   const size_t cols = function.GetInitialPoint().n_cols;
 
+  // Unless this run resumes from the previous one, discard the stored
+  // correction pairs; they are also useless if the problem size has changed
+  // (set_size() would leave garbage in the cubes).
+  if (!resume || (s.n_rows != rows) || (s.n_cols != cols))
+    updateCount = 0;
+
   s.set_size(rows, cols, numBasis);
   y.set_size(rows, cols, numBasis);
+  rho.set_size(numBasis);
+  alpha.set_size(numBasis);
   minPointIterate.second = std::numeric_limits<double>::max();
 
   // The old iterate to be saved.
@@ -369,12 +427,18 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
   // The initial gradient value.
   function.Gradient(iterate, gradient);
 
+  // Time of the last checkpoint, for the wall-clock trigger.
+  std::time_t lastCheckpoint = std::time(NULL);
+
   // The main optimization loop.
   for (size_t itNum = 0; optimizeUntilConvergence || (itNum != maxIterations);
        ++itNum)
   {
-    Log::Debug << "L-BFGS iteration " << itNum << "; objective " <<
-        function.Evaluate(iterate) << "." << std::endl;
+    // Note that functionValue is already the objective at the current
+    // iterate; re-evaluating the function just for this message would be a
+    // full (and possibly expensive) extra evaluation every iteration.
+    Log::Debug << "L-BFGS iteration " << itNum << "; objective "
+        << functionValue << "." << std::endl;
 
     // Break when the norm of the gradient becomes too small.
     if (GradientNormTooSmall(gradient))
@@ -384,12 +448,14 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
       break;
     }
 
-    // Choose the scaling factor.
-    double scalingFactor = ChooseScalingFactor(itNum, gradient);
+    // Choose the scaling factor.  updateCount (not itNum) indexes the stored
+    // correction pairs, so a resumed run keeps using the pairs of the
+    // previous one.
+    double scalingFactor = ChooseScalingFactor(updateCount, gradient);
 
     // Build an approximation to the Hessian and choose the search
     // direction for the current iteration.
-    SearchDirection(gradient, itNum, scalingFactor, searchDirection);
+    SearchDirection(gradient, updateCount, scalingFactor, searchDirection);
 
     // Save the old iterate and the gradient before stepping.
     oldIterate = iterate;
@@ -412,11 +478,69 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
     }
 
     // Overwrite an old basis set.
-    UpdateBasisSet(itNum, iterate, oldIterate, gradient, oldGradient);
+    UpdateBasisSet(updateCount, iterate, oldIterate, gradient, oldGradient);
+    ++updateCount;
+
+    // The iterate is an accepted point, so this is a safe place to snapshot
+    // it.
+    Checkpoint(iterate, functionValue, itNum, lastCheckpoint);
 
   } // End of the optimization loop.
 
-  return function.Evaluate(iterate);
+  // functionValue already holds the objective at the final iterate: the line
+  // search leaves the accepted endpoint's value (and gradient) in place, and
+  // restores the old value when it fails without moving.  Re-evaluating here
+  // would cost a full extra data pass.
+  return functionValue;
+}
+
+template<typename FunctionType>
+bool L_BFGS<FunctionType>::LoadCheckpoint(arma::mat& iterate) const
+{
+  util::SaveRestoreUtility load;
+  if (!load.ReadFile(checkpointFile))
+  {
+    Log::Warn << "L_BFGS::LoadCheckpoint(): could not read checkpoint file '"
+        << checkpointFile << "'." << std::endl;
+    return false;
+  }
+
+  load.LoadParameter(iterate, "iterate");
+  return true;
+}
+
+template<typename FunctionType>
+void L_BFGS<FunctionType>::Checkpoint(const arma::mat& iterate,
+                                      const double functionValue,
+                                      const size_t iterationNum,
+                                      std::time_t& lastCheckpoint) const
+{
+  if (checkpointFile == "")
+    return; // Checkpointing is disabled.
+
+  // Has either the iteration trigger or the wall-clock trigger fired?
+  const bool iterationDue = (checkpointIterations > 0) &&
+      ((iterationNum + 1) % checkpointIterations == 0);
+  const bool timeDue = (checkpointSeconds > 0) &&
+      (std::difftime(std::time(NULL), lastCheckpoint) >=
+          (double) checkpointSeconds);
+  if (!iterationDue && !timeDue)
+    return;
+
+  util::SaveRestoreUtility save;
+  save.SaveParameter(iterate, "iterate");
+  save.SaveParameter(functionValue, "objective");
+  save.SaveParameter(iterationNum, "iteration");
+
+  if (!save.WriteFile(checkpointFile))
+    Log::Warn << "L_BFGS::Optimize(): error checkpointing iterate to '"
+        << checkpointFile << "'." << std::endl;
+  else
+    Log::Debug << "L_BFGS::Optimize(): iterate checkpointed to '"
+        << checkpointFile << "' at iteration " << iterationNum << "."
+        << std::endl;
+
+  lastCheckpoint = std::time(NULL);
 }
 
 // Convert the object to a string.
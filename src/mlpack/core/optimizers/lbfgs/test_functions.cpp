@@ -191,6 +191,23 @@ void GeneralizedRosenbrockFunction::Gradient(const arma::mat& coordinates,
   gradient[i + 1] = 200 * (coordinates[i + 1] - std::pow(coordinates[i], 2));
 }
 
+//! Calculate the summed gradient of a batch of the individual functions.
+void GeneralizedRosenbrockFunction::Gradient(const arma::mat& coordinates,
+                                             const size_t begin,
+                                             const size_t batchSize,
+                                             arma::mat& gradient) const
+{
+  gradient.zeros(n);
+
+  for (size_t i = begin; i < begin + batchSize; ++i)
+  {
+    gradient[i] += 400 * (std::pow(coordinates[i], 3) - coordinates[i] *
+        coordinates[i + 1]) + 2 * (coordinates[i] - 1);
+    gradient[i + 1] += 200 * (coordinates[i + 1] -
+        std::pow(coordinates[i], 2));
+  }
+}
+
 const arma::mat& GeneralizedRosenbrockFunction::GetInitialPoint() const
 {
   return initialPoint;
@@ -123,6 +123,12 @@ class GeneralizedRosenbrockFunction
   void Gradient(const arma::mat& coordinates,
                 const size_t i,
                 arma::mat& gradient) const;
+  //! Summed gradient of a batch of the individual functions (for mini-batch
+  //! SGD).
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
 
   const arma::mat& GetInitialPoint() const;
 
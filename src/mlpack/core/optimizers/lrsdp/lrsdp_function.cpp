@@ -11,6 +11,36 @@
 using namespace mlpack;
 using namespace mlpack::optimization;
 
+/**
+ * Evaluate Tr(A * R * R^T) - b without ever forming R * R^T.  For a dense
+ * constraint matrix, Tr(A * R * R^T) = accu((A * R) % R), which needs only
+ * one product with the low-rank factor.  For a sparse (mode 1) constraint,
+ * only the stored nonzero entries are visited; entry (i, j) of R * R^T is the
+ * dot product of rows i and j of R.
+ */
+static double ConstraintValue(const arma::mat& a,
+                              const size_t mode,
+                              const double b,
+                              const arma::mat& coordinates)
+{
+  double value = -b;
+
+  if (mode == 0)
+  {
+    value += accu((a * coordinates) % coordinates);
+  }
+  else
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      value += a(2, i) * dot(coordinates.row((arma::uword) a(0, i)),
+                             coordinates.row((arma::uword) a(1, i)));
+    }
+  }
+
+  return value;
+}
+
 LRSDPFunction::LRSDPFunction(const size_t numConstraints,
                              const arma::mat& initialPoint):
     a(numConstraints),
@@ -21,7 +51,10 @@ LRSDPFunction::LRSDPFunction(const size_t numConstraints,
 
 double LRSDPFunction::Evaluate(const arma::mat& coordinates) const
 {
-  return -accu(coordinates * trans(coordinates));
+  // accu(R * R^T) is the squared norm of the vector of column sums of R, so
+  // the n x n product never needs to be formed.
+  const arma::rowvec sums = arma::sum(coordinates, 0);
+  return -dot(sums, sums);
 }
 
 void LRSDPFunction::Gradient(const arma::mat& /* coordinates */,
@@ -34,17 +67,7 @@ void LRSDPFunction::Gradient(const arma::mat& /* coordinates */,
 double LRSDPFunction::EvaluateConstraint(const size_t index,
                                  const arma::mat& coordinates) const
 {
-  arma::mat rrt = coordinates * trans(coordinates);
-  if (aModes[index] == 0)
-    return trace(a[index] * rrt) - b[index];
-  else
-  {
-    double value = -b[index];
-    for (size_t i = 0; i < a[index].n_cols; ++i)
-      value += a[index](2, i) * rrt(a[index](0, i), a[index](1, i));
-
-    return value;
-  }
+  return ConstraintValue(a[index], aModes[index], b[index], coordinates);
 }
 
 void LRSDPFunction::GradientConstraint(const size_t /* index */,
@@ -83,29 +106,15 @@ double AugLagrangianFunction<LRSDPFunction>::Evaluate(
   //     sum_{i = 1}^{m} (y_i (Tr(A_i * (R R^T)) - b_i)) +
   //     (sigma / 2) * sum_{i = 1}^{m} (Tr(A_i * (R R^T)) - b_i)^2
 
-  // Let's start with the objective: Tr(C * (R R^T)).
-  // Simple, possibly slow solution.
-  arma::mat rrt = coordinates * trans(coordinates);
-  double objective = trace(function.C() * rrt);
+  // Let's start with the objective: Tr(C * (R R^T)).  The product R R^T is
+  // never formed; Tr(C * (R R^T)) = accu((C * R) % R).
+  double objective = accu((function.C() * coordinates) % coordinates);
 
   // Now each constraint.
   for (size_t i = 0; i < function.B().n_elem; ++i)
   {
-    // Take the trace subtracted by the b_i.
-    double constraint = -function.B()[i];
-
-    if (function.AModes()[i] == 0)
-    {
-      constraint += trace(function.A()[i] * rrt);
-    }
-    else
-    {
-      for (size_t j = 0; j < function.A()[i].n_cols; ++j)
-      {
-        constraint += function.A()[i](2, j) *
-            rrt(function.A()[i](0, j), function.A()[i](1, j));
-      }
-    }
+    const double constraint = ConstraintValue(function.A()[i],
+        function.AModes()[i], function.B()[i], coordinates);
 
     objective -= (lambda[i] * constraint);
     objective += (sigma / 2) * std::pow(constraint, 2.0);
@@ -125,25 +134,12 @@ void AugLagrangianFunction<LRSDPFunction>::Gradient(
   //   with
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
-  arma::mat rrt = coordinates * trans(coordinates);
   arma::mat s = function.C();
 
   for (size_t i = 0; i < function.B().n_elem; ++i)
   {
-    double constraint = -function.B()[i];
-
-    if (function.AModes()[i] == 0)
-    {
-      constraint += trace(function.A()[i] * rrt);
-    }
-    else
-    {
-      for (size_t j = 0; j < function.A()[i].n_cols; ++j)
-      {
-        constraint += function.A()[i](2, j) *
-            rrt(function.A()[i](0, j), function.A()[i](1, j));
-      }
-    }
+    const double constraint = ConstraintValue(function.A()[i],
+        function.AModes()[i], function.B()[i], coordinates);
 
     double y = lambda[i] - sigma * constraint;
 
@@ -156,7 +152,8 @@ void AugLagrangianFunction<LRSDPFunction>::Gradient(
       // We only need to subtract the entries which could be modified.
       for (size_t j = 0; j < function.A()[i].n_cols; ++j)
       {
-        s(function.A()[i](0, j), function.A()[i](1, j)) -= y;
+        s(function.A()[i](0, j), function.A()[i](1, j)) -=
+            y * function.A()[i](2, j);
       }
     }
   }
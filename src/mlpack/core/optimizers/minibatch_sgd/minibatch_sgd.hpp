@@ -0,0 +1,157 @@
+/**
+ * @file minibatch_sgd.hpp
+ * @author Ryan Curtin
+ *
+ * Mini-batch Stochastic Gradient Descent (mini-batch SGD).
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_HPP
+#define __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Mini-batch Stochastic Gradient Descent is a technique for minimizing a
+ * function which can be expressed as a sum of other functions.  That is,
+ * suppose we have
+ *
+ * \f[
+ * f(A) = \sum_{i = 0}^{n} f_i(A)
+ * \f]
+ *
+ * and our task is to minimize \f$ A \f$.  Whereas SGD considers one function
+ * \f$ f_i(A) \f$ at a time, mini-batch SGD considers contiguous batches of
+ * functions, producing the following update scheme:
+ *
+ * \f[
+ * A_{j + 1} = A_j + \frac{\alpha}{m} \sum_{i \in B_j} \nabla f_i(A)
+ * \f]
+ *
+ * where \f$ \alpha \f$ is a parameter which specifies the step size, and
+ * \f$ B_j \f$ is the batch of \f$ m \f$ functions visited at iteration
+ * \f$ j \f$ (the gradient is averaged over the batch, so the effective step
+ * size does not depend on the batch size).  The order in which the batches
+ * are visited may be shuffled each epoch.  Because the batch gradient is
+ * computed by a single call into the function type, an implementation can
+ * evaluate an entire batch with one matrix-matrix multiplication instead of
+ * one matrix-vector multiplication per point, which is usually far faster.
+ * The convergence criteria are the same as for SGD: the algorithm continues
+ * until the maximum number of iterations is reached, or until a full epoch
+ * improves the objective by less than the given tolerance.
+ *
+ * For mini-batch SGD to work, a DecomposableFunctionType template parameter
+ * is required.  This class must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates, const size_t i);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 const size_t batchSize,
+ *                 arma::mat& gradient);
+ *
+ * NumFunctions() should return the number of functions (\f$n\f$), and
+ * Gradient() should store the sum of the gradients of the batchSize functions
+ * beginning at index begin (that is, \f$ \sum_{i} \nabla f_i(A) \f$ for
+ * \f$ i \f$ from begin to begin + batchSize - 1).  This differs from the
+ * one-function-at-a-time Gradient() required by SGD, so a function type must
+ * provide the batched overload to be used with this class.
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type to be
+ *     minimized.
+ */
+template<typename DecomposableFunctionType>
+class MiniBatchSGD
+{
+ public:
+  /**
+   * Construct the mini-batch SGD optimizer with the given function and
+   * parameters.
+   *
+   * @param function Function to be optimized (minimized).
+   * @param batchSize Number of functions to visit in each batch.
+   * @param stepSize Step size for each iteration.
+   * @param maxIterations Maximum number of batch iterations allowed (0 means
+   *     no limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the batch order is shuffled; otherwise, each
+   *     batch is visited in linear order.
+   */
+  MiniBatchSGD(DecomposableFunctionType& function,
+               const size_t batchSize = 50,
+               const double stepSize = 0.01,
+               const size_t maxIterations = 100000,
+               const double tolerance = 1e-5,
+               const bool shuffle = true);
+
+  /**
+   * Optimize the given function using mini-batch stochastic gradient descent.
+   * The given starting point will be modified to store the finishing point of
+   * the algorithm, and the final objective value is returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  DecomposableFunctionType& Function() { return function; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the batches are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the batches are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  // Convert the object into a string.
+  std::string ToString() const;
+
+ private:
+  //! The instantiated function.
+  DecomposableFunctionType& function;
+
+  //! The number of functions to visit in each batch.
+  size_t batchSize;
+
+  //! The step size for each batch.
+  double stepSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the batches are shuffled when iterating.
+  bool shuffle;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+// Include implementation.
+#include "minibatch_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file minibatch_sgd_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of mini-batch stochastic gradient descent.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_IMPL_HPP
+#define __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "minibatch_sgd.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType>
+MiniBatchSGD<DecomposableFunctionType>::MiniBatchSGD(
+    DecomposableFunctionType& function,
+    const size_t batchSize,
+    const double stepSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle) :
+    function(function),
+    batchSize(batchSize),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType>
+double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
+{
+  // Find the number of functions to use, and the number of batches they are
+  // divided into (the last batch may be smaller than the others).
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+
+  // This is used only if shuffle is true; it holds the order in which the
+  // batches will be visited.  The batches themselves are always contiguous
+  // ranges of functions, so that the batched Gradient() call can be
+  // implemented with bulk linear algebra.
+  arma::vec visitationOrder;
+  if (shuffle)
+    visitationOrder = arma::shuffle(arma::linspace(0, (numBatches - 1),
+        numBatches));
+
+  // To keep track of where we are and how things are going.
+  size_t currentBatch = 0;
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Calculate the first objective function.
+  for (size_t i = 0; i < numFunctions; ++i)
+    overallObjective += function.Evaluate(iterate, i);
+
+  // Now iterate!
+  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  for (size_t i = 1; i != maxIterations; ++i, ++currentBatch)
+  {
+    // Is this iteration the start of an epoch?
+    if ((currentBatch % numBatches) == 0)
+    {
+      // Output current objective function.
+      Log::Info << "Mini-batch SGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (overallObjective != overallObjective)
+      {
+        Log::Warn << "Mini-batch SGD: converged to " << overallObjective
+            << "; terminating with failure.  Try a smaller step size?"
+            << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "Mini-batch SGD: minimized within tolerance " << tolerance
+            << "; terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      overallObjective = 0;
+      currentBatch = 0;
+
+      if (shuffle) // Determine order of visitation.
+        visitationOrder = arma::shuffle(visitationOrder);
+    }
+
+    // Find the batch of functions to visit on this iteration.
+    const size_t batch = shuffle ? (size_t) visitationOrder[currentBatch] :
+        currentBatch;
+    const size_t batchBegin = batch * batchSize;
+    const size_t thisBatchSize = std::min(batchSize,
+        numFunctions - batchBegin);
+
+    // Evaluate the gradient of the entire batch with one call, then update
+    // the iterate with the average gradient of the batch, so the effective
+    // step size does not depend on the batch size.
+    function.Gradient(iterate, batchBegin, thisBatchSize, gradient);
+    iterate -= (stepSize / thisBatchSize) * gradient;
+
+    // Now add the batch to the overall objective function.
+    for (size_t j = batchBegin; j < batchBegin + thisBatchSize; ++j)
+      overallObjective += function.Evaluate(iterate, j);
+  }
+
+  Log::Info << "Mini-batch SGD: maximum iterations (" << maxIterations
+      << ") reached; terminating optimization." << std::endl;
+  // Calculate final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < numFunctions; ++i)
+    overallObjective += function.Evaluate(iterate, i);
+  return overallObjective;
+}
+
+// Convert the object to a string.
+template<typename DecomposableFunctionType>
+std::string MiniBatchSGD<DecomposableFunctionType>::ToString() const
+{
+  std::ostringstream convert;
+  convert << "MiniBatchSGD [" << this << "]" << std::endl;
+  convert << "  Function:" << std::endl;
+  convert << util::Indent(function.ToString(), 2);
+  convert << "  Batch size: " << batchSize << std::endl;
+  convert << "  Step size: " << stepSize << std::endl;
+  convert << "  Maximum iterations: " << maxIterations << std::endl;
+  convert << "  Tolerance: " << tolerance << std::endl;
+  convert << "  Shuffle batches: " << (shuffle ? "true" : "false")
+      << std::endl;
+  return convert.str();
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
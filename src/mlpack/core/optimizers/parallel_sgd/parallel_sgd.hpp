@@ -0,0 +1,156 @@
+/**
+ * @file parallel_sgd.hpp
+ * @author Ryan Curtin
+ *
+ * Lock-free parallel Stochastic Gradient Descent (Hogwild-style).
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_HPP
+#define __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Parallel Stochastic Gradient Descent is a lock-free parallelization of SGD
+ * for minimizing a function which can be expressed as a sum of other
+ * functions.  Each thread repeatedly picks an individual function, computes
+ * its gradient, and applies the update
+ *
+ * \f[
+ * A_{j + 1} = A_j + \alpha \nabla f_i(A)
+ * \f]
+ *
+ * directly to the shared iterate, without any synchronization.  Threads may
+ * therefore overwrite parts of each other's updates; when the individual
+ * gradients are sparse (each \f$ f_i(A) \f$ touches only a few components of
+ * \f$ A \f$, as in logistic regression on sparse data), collisions are rare
+ * and the algorithm converges at essentially the serial rate while using all
+ * cores.  This is the Hogwild! scheme:
+ *
+ * @code
+ * @inproceedings{niu2011hogwild,
+ *   title={Hogwild!: A Lock-Free Approach to Parallelizing Stochastic
+ *       Gradient Descent},
+ *   author={Niu, F. and Recht, B. and R{\'e}, C. and Wright, S.J.},
+ *   booktitle={Advances in Neural Information Processing Systems 24 (NIPS
+ *       2011)},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The optimization proceeds in epochs; in each epoch every function is
+ * visited exactly once (in shuffled order, if desired), with the visits
+ * divided among the threads.  The convergence criteria are the same as for
+ * SGD: the algorithm continues until the maximum number of iterations
+ * (individual function visits) is reached, or until an epoch improves the
+ * objective by less than the given tolerance.  If OpenMP is not enabled, this
+ * reduces to a serial SGD pass.
+ *
+ * Note that for dense gradients the unsynchronized updates can degrade
+ * convergence; in that situation plain SGD (or MiniBatchSGD) is usually a
+ * better choice.
+ *
+ * For parallel SGD to work, a DecomposableFunctionType template parameter is
+ * required, with the same interface as for SGD:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates, const size_t i);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient);
+ *
+ * In addition, Evaluate() and Gradient() must be safe to call concurrently
+ * from multiple threads (this is trivially true if they only read the data
+ * they operate on).
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type to be
+ *     minimized.
+ */
+template<typename DecomposableFunctionType>
+class ParallelSGD
+{
+ public:
+  /**
+   * Construct the parallel SGD optimizer with the given function and
+   * parameters.
+   *
+   * @param function Function to be optimized (minimized).
+   * @param stepSize Step size for each iteration.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled; otherwise, each
+   *     function is visited in linear order.
+   */
+  ParallelSGD(DecomposableFunctionType& function,
+              const double stepSize = 0.01,
+              const size_t maxIterations = 100000,
+              const double tolerance = 1e-5,
+              const bool shuffle = true);
+
+  /**
+   * Optimize the given function using lock-free parallel stochastic gradient
+   * descent.  The given starting point will be modified to store the
+   * finishing point of the algorithm, and the final objective value is
+   * returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  DecomposableFunctionType& Function() { return function; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  // Convert the object into a string.
+  std::string ToString() const;
+
+ private:
+  //! The instantiated function.
+  DecomposableFunctionType& function;
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+// Include implementation.
+#include "parallel_sgd_impl.hpp"
+
+#endif
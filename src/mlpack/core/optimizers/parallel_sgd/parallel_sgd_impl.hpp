@@ -0,0 +1,153 @@
+/**
+ * @file parallel_sgd_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of lock-free parallel stochastic gradient descent.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_IMPL_HPP
+#define __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_sgd.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType>
+ParallelSGD<DecomposableFunctionType>::ParallelSGD(
+    DecomposableFunctionType& function,
+    const double stepSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle) :
+    function(function),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType>
+double ParallelSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
+{
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  // This is used only if shuffle is true.
+  arma::vec visitationOrder;
+  if (shuffle)
+    visitationOrder = arma::shuffle(arma::linspace(0, (numFunctions - 1),
+        numFunctions));
+
+  // To keep track of how things are going.
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Calculate the first objective function.
+  for (size_t i = 0; i < numFunctions; ++i)
+    overallObjective += function.Evaluate(iterate, i);
+
+  // Now iterate, one epoch (a full pass over the functions) at a time; the
+  // visits within an epoch are divided among the threads.
+  size_t iteration = 1;
+  while ((maxIterations == 0) || (iteration < maxIterations))
+  {
+    // Output current objective function.
+    Log::Info << "Parallel SGD: iteration " << iteration << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (overallObjective != overallObjective)
+    {
+      Log::Warn << "Parallel SGD: converged to " << overallObjective
+          << "; terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "Parallel SGD: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    lastObjective = overallObjective;
+
+    if (shuffle) // Determine order of visitation.
+      visitationOrder = arma::shuffle(visitationOrder);
+
+    // Cut the epoch short if it would overshoot the iteration limit.
+    size_t epochSize = numFunctions;
+    if ((maxIterations != 0) && (iteration + epochSize > maxIterations))
+      epochSize = maxIterations - iteration;
+
+#ifdef _OPENMP
+    // Visit the functions in parallel.  Each thread applies its updates to
+    // the shared iterate without any synchronization; this is the lock-free
+    // Hogwild scheme, and it relies on the individual gradients being sparse
+    // enough that collisions between threads are rare.
+    #pragma omp parallel
+    {
+      arma::mat gradient(iterate.n_rows, iterate.n_cols);
+
+      #pragma omp for schedule(static)
+      for (long j = 0; j < (long) epochSize; ++j)
+      {
+        const size_t selected = shuffle ? (size_t) visitationOrder[j] :
+            (size_t) j;
+
+        function.Gradient(iterate, selected, gradient);
+
+        // Apply only the nonzero components of the gradient.  A full-vector
+        // write would also rewrite the components this function does not
+        // touch, silently undoing concurrent updates made by other threads.
+        for (size_t k = 0; k < gradient.n_elem; ++k)
+          if (gradient[k] != 0.0)
+            iterate[k] -= stepSize * gradient[k];
+      }
+    }
+#else
+    // Without OpenMP, this is a plain serial SGD pass.
+    arma::mat gradient(iterate.n_rows, iterate.n_cols);
+    for (size_t j = 0; j < epochSize; ++j)
+    {
+      const size_t selected = shuffle ? (size_t) visitationOrder[j] : j;
+
+      function.Gradient(iterate, selected, gradient);
+      iterate -= stepSize * gradient;
+    }
+#endif
+
+    iteration += epochSize;
+
+    // Now recalculate the objective function.
+    overallObjective = 0;
+    for (size_t i = 0; i < numFunctions; ++i)
+      overallObjective += function.Evaluate(iterate, i);
+  }
+
+  Log::Info << "Parallel SGD: maximum iterations (" << maxIterations
+      << ") reached; terminating optimization." << std::endl;
+  return overallObjective;
+}
+
+// Convert the object to a string.
+template<typename DecomposableFunctionType>
+std::string ParallelSGD<DecomposableFunctionType>::ToString() const
+{
+  std::ostringstream convert;
+  convert << "ParallelSGD [" << this << "]" << std::endl;
+  convert << "  Function:" << std::endl;
+  convert << util::Indent(function.ToString(), 2);
+  convert << "  Step size: " << stepSize << std::endl;
+  convert << "  Maximum iterations: " << maxIterations << std::endl;
+  convert << "  Tolerance: " << tolerance << std::endl;
+  convert << "  Shuffle points: " << (shuffle ? "true" : "false") << std::endl;
+  return convert.str();
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
@@ -36,6 +36,12 @@ namespace optimization {
  * The system is considered "frozen" when its score fails to change more then
  * tolerance for maxToleranceSweep consecutive sweeps.
  *
+ * In addition to the single-chain Optimize(), OptimizeTempered() runs several
+ * replicas of the annealing chain at different temperatures, with periodic
+ * Metropolis swaps of the states of adjacent replicas.  The replicas are
+ * independent between swap attempts, so they are run on separate threads when
+ * OpenMP is available.
+ *
  * For SA to work, the FunctionType parameter must implement the following
  * two methods:
  *
@@ -98,6 +104,32 @@ class SA
    */
   double Optimize(arma::mat& iterate);
 
+  /**
+   * Optimize the given function using parallel tempering.  A number of
+   * replicas of the annealing chain are run at different temperatures: replica
+   * 0 starts at the base temperature of the optimizer, and each replica above
+   * it is hotter by a factor of temperingRatio (a geometric ladder).  Every
+   * swapPeriod iterations, the states of adjacent replicas in the ladder are
+   * swapped according to the Metropolis criterion, so good states found by the
+   * hot, exploratory replicas percolate down to the cold one.  Between swap
+   * attempts the replicas are independent, and are run on separate threads
+   * when OpenMP is available.  The cooling schedule is shared by all replicas
+   * and must therefore be stateless (the bundled ExponentialSchedule is).
+   *
+   * The given starting point will be modified to store the finishing point of
+   * the coldest replica, and its objective value is returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @param replicas Number of replicas in the temperature ladder.
+   * @param swapPeriod Iterations of each replica between swap attempts.
+   * @param temperingRatio Temperature ratio of adjacent replicas.
+   * @return Objective value of the final point of the coldest replica.
+   */
+  double OptimizeTempered(arma::mat& iterate,
+                          const size_t replicas = 4,
+                          const size_t swapPeriod = 100,
+                          const double temperingRatio = 2.0);
+
   //! Get the instantiated function to be optimized.
   const FunctionType& Function() const { return function; }
   //! Modify the instantiated function.
@@ -186,15 +218,25 @@ class SA
    * @param iterate Current optimization position.
    * @param accept Matrix representing which parameters have had accepted moves.
    * @param energy Current energy of the system.
+   * The temperature and move sizes are passed in rather than taken from the
+   * members so that each replica of OptimizeTempered() can maintain its own.
+   *
+   * @param iterate Current optimization position.
+   * @param accept Matrix representing which parameters have had accepted moves.
+   * @param energy Current energy of the system.
    * @param idx Current parameter to modify.
    * @param sweepCounter Current counter representing how many sweeps have been
    *      completed.
+   * @param temperature Temperature of the chain being moved.
+   * @param moveSize Move size of each parameter of the chain being moved.
    */
   void GenerateMove(arma::mat& iterate,
                     arma::mat& accept,
                     double& energy,
                     size_t& idx,
-                    size_t& sweepCounter);
+                    size_t& sweepCounter,
+                    const double temperature,
+                    arma::mat& moveSize);
 
   /**
    * MoveControl() uses a proportional feedback control to determine the size
@@ -213,8 +255,10 @@ class SA
    *
    * @param nMoves Number of moves since last call.
    * @param accept Matrix representing which parameters have had accepted moves.
+   * @param moveSize Move size of each parameter of the chain (will be
+   *      modified).
    */
-  void MoveControl(const size_t nMoves, arma::mat& accept);
+  void MoveControl(const size_t nMoves, arma::mat& accept, arma::mat& moveSize);
 };
 
 }; // namespace optimization
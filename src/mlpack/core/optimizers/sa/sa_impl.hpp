@@ -70,13 +70,15 @@ double SA<FunctionType, CoolingScheduleType>::Optimize(arma::mat &iterate)
 
   // Initial moves to get rid of dependency of initial states.
   for (size_t i = 0; i < initMoves; ++i)
-    GenerateMove(iterate, accept, energy, idx, sweepCounter);
+    GenerateMove(iterate, accept, energy, idx, sweepCounter, temperature,
+        moveSize);
 
   // Iterating and cooling.
   for (size_t i = 0; i != maxIterations; ++i)
   {
     oldEnergy = energy;
-    GenerateMove(iterate, accept, energy, idx, sweepCounter);
+    GenerateMove(iterate, accept, energy, idx, sweepCounter, temperature,
+        moveSize);
     temperature = coolingSchedule.NextTemperature(temperature, energy);
 
     // Determine if the optimization has entered (or continues to be in) a
@@ -101,6 +103,120 @@ double SA<FunctionType, CoolingScheduleType>::Optimize(arma::mat &iterate)
   return energy;
 }
 
+//! Optimize the function (minimize) using parallel tempering.
+template<
+    typename FunctionType,
+    typename CoolingScheduleType
+>
+double SA<FunctionType, CoolingScheduleType>::OptimizeTempered(
+    arma::mat& iterate,
+    const size_t replicas,
+    const size_t swapPeriod,
+    const double temperingRatio)
+{
+  // With a single replica there is nothing to swap with; fall back to the
+  // single-chain optimizer.
+  if (replicas < 2)
+    return Optimize(iterate);
+
+  math::RandomSeed(std::time(NULL));
+
+  // Per-replica state.  Replica 0 runs at the base temperature of the
+  // optimizer, and each replica above it is hotter by a factor of
+  // temperingRatio; every replica starts from the given point.
+  std::vector<arma::mat> iterates(replicas, iterate);
+  std::vector<arma::mat> moveSizes(replicas, moveSize);
+  std::vector<arma::mat> accepts(replicas,
+      arma::zeros<arma::mat>(iterate.n_rows, iterate.n_cols));
+  std::vector<size_t> idxs(replicas, 0);
+  std::vector<size_t> sweepCounters(replicas, 0);
+
+  arma::vec energies(replicas);
+  energies.fill(function.Evaluate(iterate));
+
+  arma::vec temperatures(replicas);
+  temperatures[0] = temperature;
+  for (size_t r = 1; r < replicas; ++r)
+    temperatures[r] = temperingRatio * temperatures[r - 1];
+
+  // Initial moves of every replica, to get rid of dependency of initial
+  // states.  The replicas are completely independent here, so they can run on
+  // separate threads; math::Random() draws from a thread-local generator
+  // inside parallel regions.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long r = 0; r < (long) replicas; ++r)
+  {
+    for (size_t k = 0; k < initMoves; ++k)
+      GenerateMove(iterates[r], accepts[r], energies[r], idxs[r],
+          sweepCounters[r], temperatures[r], moveSizes[r]);
+  }
+
+  size_t frozenCount = 0;
+  double oldColdEnergy = energies[0];
+
+  // Iterating and cooling, in rounds of swapPeriod iterations per replica.
+  for (size_t i = 0; maxIterations == 0 || i < maxIterations; i += swapPeriod)
+  {
+    // Between swap attempts the replicas are independent.  Each replica cools
+    // after every move, at the same rate as the single-chain optimizer; the
+    // shared cooling schedule is called concurrently and so must be stateless.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long r = 0; r < (long) replicas; ++r)
+    {
+      for (size_t k = 0; k < swapPeriod; ++k)
+      {
+        GenerateMove(iterates[r], accepts[r], energies[r], idxs[r],
+            sweepCounters[r], temperatures[r], moveSizes[r]);
+        temperatures[r] = coolingSchedule.NextTemperature(temperatures[r],
+            energies[r]);
+      }
+    }
+
+    // Attempt to swap the states of adjacent replicas in the ladder.  A swap
+    // is accepted with probability
+    // min{1, exp((1 / T_r - 1 / T_{r+1}) (E_r - E_{r+1}))}, which preserves
+    // the equilibrium distribution of each replica; the temperatures and move
+    // sizes stay attached to their rungs.
+    for (size_t r = 0; r + 1 < replicas; ++r)
+    {
+      const double logCriterion = (1.0 / temperatures[r] -
+          1.0 / temperatures[r + 1]) * (energies[r] - energies[r + 1]);
+      if (logCriterion >= 0. || std::exp(logCriterion) > math::Random())
+      {
+        std::swap(iterates[r], iterates[r + 1]);
+        std::swap(energies[r], energies[r + 1]);
+      }
+    }
+
+    // Determine if the coldest replica has entered (or continues to be in) a
+    // frozen state.
+    if (std::abs(energies[0] - oldColdEnergy) < tolerance)
+      frozenCount += swapPeriod;
+    else
+      frozenCount = 0;
+    oldColdEnergy = energies[0];
+
+    // Terminate, if possible.
+    if (frozenCount >= maxToleranceSweep * moveCtrlSweep * iterate.n_elem)
+    {
+      Log::Debug << "SA: coldest replica minimized within tolerance "
+          << tolerance << " for " << maxToleranceSweep << " sweeps after " << i
+          << " iterations; terminating optimization." << std::endl;
+      break;
+    }
+  }
+
+  // The coldest replica holds the result.
+  iterate = iterates[0];
+  temperature = temperatures[0];
+  moveSize = moveSizes[0];
+  return energies[0];
+}
+
 /**
  * GenerateMove proposes a move on element iterate(idx), and determines
  * it that move is acceptable or not according to the Metropolis criterion.
@@ -118,7 +234,9 @@ void SA<FunctionType, CoolingScheduleType>::GenerateMove(
     arma::mat& accept,
     double& energy,
     size_t& idx,
-    size_t& sweepCounter)
+    size_t& sweepCounter,
+    const double temperature,
+    arma::mat& moveSize)
 {
   const double prevEnergy = energy;
   const double prevValue = iterate(idx);
@@ -158,7 +276,7 @@ void SA<FunctionType, CoolingScheduleType>::GenerateMove(
 
   if (sweepCounter == moveCtrlSweep) // Do MoveControl().
   {
-    MoveControl(moveCtrlSweep, accept);
+    MoveControl(moveCtrlSweep, accept, moveSize);
     sweepCounter = 0;
   }
 }
@@ -182,7 +300,8 @@ template<
     typename CoolingScheduleType
 >
 void SA<FunctionType, CoolingScheduleType>::MoveControl(const size_t nMoves,
-                                                        arma::mat& accept)
+                                                        arma::mat& accept,
+                                                        arma::mat& moveSize)
 {
   arma::mat target;
   target.copy_size(accept);
@@ -12,6 +12,34 @@
 namespace mlpack {
 namespace optimization {
 
+//! Utility struct to detect whether a function type declares a nested
+//! GradientType typedef.
+template<typename FunctionType>
+struct HasGradientType
+{
+  template<typename T> static char Test(typename T::GradientType*);
+  template<typename T> static int Test(...);
+
+  static const bool value = (sizeof(Test<FunctionType>(0)) == sizeof(char));
+};
+
+//! Extract the gradient type of a function: the nested GradientType typedef
+//! if the function declares one, otherwise arma::mat.  A function may declare
+//! a sparse GradientType so that parameter updates touch only the nonzero
+//! coordinates of each per-point gradient.
+template<typename FunctionType,
+         bool Has = HasGradientType<FunctionType>::value>
+struct GradientTypeOf
+{
+  typedef arma::mat type;
+};
+
+template<typename FunctionType>
+struct GradientTypeOf<FunctionType, true>
+{
+  typedef typename FunctionType::GradientType type;
+};
+
 /**
  * Stochastic Gradient Descent is a technique for minimizing a function which
  * can be expressed as a sum of other functions.  That is, suppose we have
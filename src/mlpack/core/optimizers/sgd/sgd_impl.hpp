@@ -49,8 +49,10 @@ double SGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
   for (size_t i = 0; i < numFunctions; ++i)
     overallObjective += function.Evaluate(iterate, i);
 
-  // Now iterate!
-  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  // Now iterate!  The gradient type is taken from the function, so that a
+  // function with sparse per-point gradients gets sparse updates.
+  typename GradientTypeOf<DecomposableFunctionType>::type
+      gradient(iterate.n_rows, iterate.n_cols);
   for (size_t i = 1; i != maxIterations; ++i, ++currentFunction)
   {
     // Is this iteration the start of a sequence?
@@ -53,3 +53,17 @@ void SGDTestFunction::Gradient(const arma::mat& coordinates,
       break;
   }
 }
+
+void SGDTestFunction::Gradient(const arma::mat& coordinates,
+                               const size_t begin,
+                               const size_t batchSize,
+                               arma::mat& gradient) const
+{
+  gradient.zeros(3);
+  arma::mat funcGradient;
+  for (size_t i = begin; i < begin + batchSize; ++i)
+  {
+    Gradient(coordinates, i, funcGradient);
+    gradient += funcGradient;
+  }
+}
@@ -36,6 +36,13 @@ class SGDTestFunction
   void Gradient(const arma::mat& coordinates,
                 const size_t i,
                 arma::mat& gradient) const;
+
+  //! Evaluate the summed gradient of a batch of functions (for mini-batch
+  //! SGD).
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
 };
 
 }; // namespace test
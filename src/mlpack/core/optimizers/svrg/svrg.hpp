@@ -0,0 +1,161 @@
+/**
+ * @file svrg.hpp
+ * @author Ryan Curtin
+ *
+ * Stochastic Variance Reduced Gradient (SVRG).
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_SVRG_SVRG_HPP
+#define __MLPACK_CORE_OPTIMIZERS_SVRG_SVRG_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Stochastic Variance Reduced Gradient (SVRG) is a technique for minimizing a
+ * function which can be expressed as a sum of other functions.  That is,
+ * suppose we have
+ *
+ * \f[
+ * f(A) = \sum_{i = 0}^{n} f_i(A)
+ * \f]
+ *
+ * and our task is to minimize \f$ A \f$.  Plain SGD must decay its step size
+ * to converge, because the variance of the single-function gradient does not
+ * vanish at the optimum.  SVRG (see "Accelerating Stochastic Gradient Descent
+ * using Predictive Variance Reduction" by R. Johnson and T. Zhang) removes
+ * that variance by periodically taking a snapshot \f$ \tilde{A} \f$ of the
+ * iterate and computing the full gradient \f$ \tilde{\mu} = \frac{1}{n}
+ * \sum_i \nabla f_i(\tilde{A}) \f$ at it; the inner updates are then
+ *
+ * \f[
+ * A_{j + 1} = A_j - \alpha (\nabla f_i(A_j) - \nabla f_i(\tilde{A}) +
+ *     \tilde{\mu})
+ * \f]
+ *
+ * where \f$ \alpha \f$ is a constant step size.  The correction term has zero
+ * mean, so each update is still an unbiased gradient estimate, but its
+ * variance shrinks as the iterate and the snapshot approach the optimum; on
+ * smooth, strongly convex objectives this gives linear convergence with a
+ * constant step size.  The full-gradient pass over the \f$ n \f$ functions is
+ * computed in parallel when OpenMP is available.
+ *
+ * The algorithm terminates when the maximum number of iterations is reached,
+ * or when the objective between two successive snapshots improves by less
+ * than the given tolerance.
+ *
+ * For SVRG to work, a DecomposableFunctionType template parameter is
+ * required.  This class must implement the same functions as for SGD:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates, const size_t i);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient);
+ *
+ * Because the full-gradient pass calls Evaluate() and Gradient() from several
+ * threads at once, these functions must be safe to call concurrently for
+ * distinct i (which is the case for functions that only read their dataset,
+ * such as the data-dependent objectives in the methods directory).
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type to be
+ *     minimized.
+ */
+template<typename DecomposableFunctionType>
+class SVRG
+{
+ public:
+  /**
+   * Construct the SVRG optimizer with the given function and parameters.
+   *
+   * @param function Function to be optimized (minimized).
+   * @param stepSize Step size for each iteration.
+   * @param maxIterations Maximum number of inner iterations allowed (0 means
+   *     no limit).
+   * @param innerIterations Number of inner iterations between snapshots (0
+   *     means one per function, i.e., one epoch).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled between snapshots;
+   *     otherwise, each function is visited in linear order.
+   */
+  SVRG(DecomposableFunctionType& function,
+       const double stepSize = 0.01,
+       const size_t maxIterations = 100000,
+       const size_t innerIterations = 0,
+       const double tolerance = 1e-5,
+       const bool shuffle = true);
+
+  /**
+   * Optimize the given function using SVRG.  The given starting point will be
+   * modified to store the finishing point of the algorithm, and the final
+   * objective value is returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  DecomposableFunctionType& Function() { return function; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of inner iterations between snapshots (0 indicates one
+  //! epoch).
+  size_t InnerIterations() const { return innerIterations; }
+  //! Modify the number of inner iterations between snapshots (0 indicates one
+  //! epoch).
+  size_t& InnerIterations() { return innerIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  // Convert the object into a string.
+  std::string ToString() const;
+
+ private:
+  //! The instantiated function.
+  DecomposableFunctionType& function;
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The number of inner iterations between snapshots.
+  size_t innerIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+// Include implementation.
+#include "svrg_impl.hpp"
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file svrg_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of stochastic variance reduced gradient (SVRG).
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_SVRG_SVRG_IMPL_HPP
+#define __MLPACK_CORE_OPTIMIZERS_SVRG_SVRG_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "svrg.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType>
+SVRG<DecomposableFunctionType>::SVRG(DecomposableFunctionType& function,
+                                     const double stepSize,
+                                     const size_t maxIterations,
+                                     const size_t innerIterations,
+                                     const double tolerance,
+                                     const bool shuffle) :
+    function(function),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    innerIterations(innerIterations),
+    tolerance(tolerance),
+    shuffle(shuffle)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType>
+double SVRG<DecomposableFunctionType>::Optimize(arma::mat& iterate)
+{
+  // Find the number of functions to use, and the length of the inner loop.
+  const size_t numFunctions = function.NumFunctions();
+  const size_t snapshotGap = (innerIterations == 0) ? numFunctions :
+      innerIterations;
+
+  // This is used only if shuffle is true.
+  arma::vec visitationOrder;
+  if (shuffle)
+    visitationOrder = arma::shuffle(arma::linspace(0, (numFunctions - 1),
+        numFunctions));
+
+  // To keep track of how things are going.
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Workspaces for the snapshot and the gradients.
+  arma::mat snapshot;
+  arma::mat fullGradient(iterate.n_rows, iterate.n_cols);
+  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::mat snapshotGradient(iterate.n_rows, iterate.n_cols);
+
+  // Now iterate, one snapshot at a time.
+  size_t iteration = 1;
+  while ((maxIterations == 0) || (iteration < maxIterations))
+  {
+    // Take the snapshot, then compute the full gradient and the objective at
+    // it in one pass over the functions.  The pass is divided among the
+    // threads; each thread accumulates into its own workspace and the
+    // workspaces are combined at the end.  The loop index is signed for
+    // OpenMP.
+    snapshot = iterate;
+    fullGradient.zeros();
+    overallObjective = 0;
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      arma::mat threadGradient(iterate.n_rows, iterate.n_cols);
+      threadGradient.zeros();
+      double threadObjective = 0;
+      arma::mat funcGradient(iterate.n_rows, iterate.n_cols);
+
+#ifdef _OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (long i = 0; i < (long) numFunctions; ++i)
+      {
+        function.Gradient(snapshot, i, funcGradient);
+        threadGradient += funcGradient;
+        threadObjective += function.Evaluate(snapshot, i);
+      }
+
+#ifdef _OPENMP
+      #pragma omp critical (svrgFullGradient)
+#endif
+      {
+        fullGradient += threadGradient;
+        overallObjective += threadObjective;
+      }
+    }
+    fullGradient /= numFunctions;
+
+    // Output current objective function.
+    Log::Info << "SVRG: iteration " << iteration << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (overallObjective != overallObjective)
+    {
+      Log::Warn << "SVRG: converged to " << overallObjective << "; "
+          << "terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "SVRG: minimized within tolerance " << tolerance << "; "
+          << "terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    lastObjective = overallObjective;
+
+    if (shuffle) // Determine order of visitation.
+      visitationOrder = arma::shuffle(visitationOrder);
+
+    // Cut the inner loop short if it would overshoot the iteration limit.
+    size_t epochSize = snapshotGap;
+    if ((maxIterations != 0) && (iteration + epochSize > maxIterations))
+      epochSize = maxIterations - iteration;
+
+    // The inner loop: single-function steps with the variance correction.
+    // The correction has zero mean, so the update is still an unbiased
+    // estimate of the full gradient, but its variance vanishes as the
+    // iterate and the snapshot approach the optimum.
+    for (size_t j = 0; j < epochSize; ++j)
+    {
+      const size_t selected = shuffle ?
+          (size_t) visitationOrder[j % numFunctions] : (j % numFunctions);
+
+      function.Gradient(iterate, selected, gradient);
+      function.Gradient(snapshot, selected, snapshotGradient);
+
+      iterate -= stepSize * (gradient - snapshotGradient + fullGradient);
+    }
+
+    iteration += epochSize;
+  }
+
+  Log::Info << "SVRG: maximum iterations (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+  // Calculate final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < numFunctions; ++i)
+    overallObjective += function.Evaluate(iterate, i);
+  return overallObjective;
+}
+
+// Convert the object to a string.
+template<typename DecomposableFunctionType>
+std::string SVRG<DecomposableFunctionType>::ToString() const
+{
+  std::ostringstream convert;
+  convert << "SVRG [" << this << "]" << std::endl;
+  convert << "  Function:" << std::endl;
+  convert << util::Indent(function.ToString(), 2);
+  convert << "  Step size: " << stepSize << std::endl;
+  convert << "  Maximum iterations: " << maxIterations << std::endl;
+  convert << "  Inner iterations: " << innerIterations << std::endl;
+  convert << "  Tolerance: " << tolerance << std::endl;
+  convert << "  Shuffle points: " << (shuffle ? "true" : "false") << std::endl;
+  return convert.str();
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
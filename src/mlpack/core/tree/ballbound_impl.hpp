@@ -71,6 +71,8 @@ BallBound<VecType, TMetricType>& BallBound<VecType, TMetricType>::operator=(
   center = other.center;
   metric = other.metric;
   ownsMetric = false;
+
+  return *this;
 }
 
 //! Destructor to release allocated memory.
@@ -232,18 +234,19 @@ BallBound<VecType, TMetricType>::operator|=(const MatType& data)
     radius = 0;
   }
 
-  // Now iteratively add points.
+  // Now iteratively add points.  The metric is evaluated on the column
+  // directly and the center is shifted in place, so no per-point temporary
+  // vectors are created; tree building touches each column exactly once.
   for (size_t i = 0; i < data.n_cols; ++i)
   {
-    const double dist = metric->Evaluate(center, (VecType) data.col(i));
+    const double dist = metric->Evaluate(center, data.col(i));
 
     // See if the new point lies outside the bound.
     if (dist > radius)
     {
       // Move towards the new point and increase the radius just enough to
       // accomodate the new point.
-      arma::vec diff = data.col(i) - center;
-      center += ((dist - radius) / (2 * dist)) * diff;
+      center += ((dist - radius) / (2 * dist)) * (data.col(i) - center);
       radius = 0.5 * (dist + radius);
     }
   }
@@ -8,7 +8,9 @@
 
 #include <mlpack/core.hpp>
 #include "mean_split.hpp"
+#include "random_projection_split.hpp"
 
+#include "../node_arena.hpp"
 #include "../statistic.hpp"
 
 namespace mlpack {
@@ -60,8 +62,13 @@ class BinarySpaceTree
   size_t maxLeafSize;
   //! The bound object for this node.
   BoundType bound;
-  //! Any extra data contained in the node.
-  StatisticType stat;
+  //! Any extra data contained in the node.  Mutable so that lazily-built
+  //! statistic types (see StatisticTraits) can be initialized on first
+  //! access, even through a const node.
+  mutable StatisticType stat;
+  //! Whether the statistic has been initialized; always true for eagerly
+  //! built statistic types.
+  mutable bool statInitialized;
   //! The dimension this node split on if it is a parent.
   size_t splitDimension;
   //! The distance from the centroid of this node to the centroid of the parent.
@@ -73,6 +80,10 @@ class BinarySpaceTree
   double minimumBoundDistance;
   //! The dataset.
   MatType& dataset;
+  //! The arena that this tree's nodes are allocated from; only the root node
+  //! deletes the arena.  NULL if the children of this node are allocated
+  //! individually (as is done for copied trees).
+  NodeArena<BinarySpaceTree>* arena;
 
  public:
   //! So other classes can use TreeType::Mat.
@@ -83,6 +94,11 @@ class BinarySpaceTree
   template<typename RuleType>
   class SingleTreeTraverser;
 
+  //! A defeatist (no-backtrack) single-tree traverser for binary space trees;
+  //! see greedy_single_tree_traverser.hpp for implementation.
+  template<typename RuleType>
+  class GreedySingleTreeTraverser;
+
   //! A dual-tree traverser for binary space trees; see dual_tree_traverser.hpp.
   template<typename RuleType>
   class DualTreeTraverser;
@@ -202,6 +218,22 @@ class BinarySpaceTree
                   BinarySpaceTree* parent = NULL,
                   const size_t maxLeafSize = 20);
 
+  /**
+   * Construct this as the root node of a binary space tree read from a binary
+   * file previously written with SaveBinary().  The dataset must be the
+   * already-permuted dataset that the tree was saved with (the binary format
+   * stores only the tree structure, not the points).  No splitting is
+   * performed; the nodes are read directly into the arena, so loading is a
+   * single sequential pass over the file.
+   *
+   * This is only valid for bound types that expose their dimensions as
+   * math::Range objects via operator[] (such as HRectBound).
+   *
+   * @param data The (already-permuted) dataset the tree was built on.
+   * @param filename Name of the file to read the tree from.
+   */
+  BinarySpaceTree(MatType& data, const std::string& filename);
+
   /**
    * Create a binary space tree by copying the other tree.  Be careful!  This
    * can take a long time and use a lot of memory.
@@ -249,10 +281,32 @@ class BinarySpaceTree
   //! Return the bound object for this node.
   BoundType& Bound() { return bound; }
 
-  //! Return the statistic object for this node.
-  const StatisticType& Stat() const { return stat; }
-  //! Return the statistic object for this node.
-  StatisticType& Stat() { return stat; }
+  //! Return the statistic object for this node, building it first if the
+  //! statistic type is lazily built (see StatisticTraits) and this node has
+  //! not been touched yet.
+  const StatisticType& Stat() const
+  {
+    if (StatisticTraits<StatisticType>::BuildLazily && !statInitialized)
+    {
+      // Statistic constructors take a non-const node; building the statistic
+      // does not observably modify the node, hence the cast.
+      stat = StatisticType(const_cast<BinarySpaceTree&>(*this));
+      statInitialized = true;
+    }
+    return stat;
+  }
+  //! Return the statistic object for this node, building it first if the
+  //! statistic type is lazily built (see StatisticTraits) and this node has
+  //! not been touched yet.
+  StatisticType& Stat()
+  {
+    if (StatisticTraits<StatisticType>::BuildLazily && !statInitialized)
+    {
+      stat = StatisticType(*this);
+      statInitialized = true;
+    }
+    return stat;
+  }
 
   //! Return whether or not this node is a leaf (true if it has no children).
   bool IsLeaf() const;
@@ -265,6 +319,33 @@ class BinarySpaceTree
   //! Fills the tree to the specified level.
   size_t ExtendTree(const size_t level);
 
+  /**
+   * Compact the tree into depth-first order in a fresh arena, so that a
+   * traversal of the tree walks consecutive memory.  Construction order and
+   * depth-first order do not coincide in general (in particular after a
+   * parallel build), and this repacks the nodes so that they do.  Only the
+   * root of a tree may be flattened; the structure of the tree is unchanged,
+   * but all pointers and references to non-root nodes are invalidated.
+   *
+   * This is useful for read-only query serving, where a tree is built once
+   * and then queried many times.
+   */
+  void Flatten();
+
+  /**
+   * Write the built tree to the given file in a compact binary format: a
+   * small header followed by one fixed-size record per node, in depth-first
+   * order.  The dataset is not written; save it separately and pass it (with
+   * the same point ordering) to the loading constructor.  Only the root of a
+   * tree may be saved.
+   *
+   * This is only valid for bound types that expose their dimensions as
+   * math::Range objects via operator[] (such as HRectBound).
+   *
+   * @param filename Name of the file to write the tree to.
+   */
+  void SaveBinary(const std::string& filename) const;
+
   //! Gets the left child of this node.
   BinarySpaceTree* Left() const { return left; }
   //! Modify the left child of this node.
@@ -443,26 +524,87 @@ class BinarySpaceTree
  private:
   /**
    * Private copy constructor, available only to fill (pad) the tree to a
-   * specified level.
+   * specified level.  The arena is inherited from the parent, so the padding
+   * node records how it was allocated (see DestroyChild()).
    */
   BinarySpaceTree(const size_t begin,
                   const size_t count,
                   BoundType bound,
                   StatisticType stat,
+                  BinarySpaceTree* parent,
                   const int maxLeafSize = 20) :
       left(NULL),
       right(NULL),
+      parent(parent),
       begin(begin),
       count(count),
       bound(bound),
       stat(stat),
-      maxLeafSize(maxLeafSize) { }
+      statInitialized(true),
+      maxLeafSize(maxLeafSize),
+      dataset(parent->dataset),
+      arena(parent->arena) { }
 
   BinarySpaceTree* CopyMe()
   {
-    return new BinarySpaceTree(begin, count, bound, stat, maxLeafSize);
+    // Padding nodes for this tree must come from the arena if this node's
+    // children do, since they will be destructed through it.
+    return (arena != NULL)
+        ? new (arena->Allocate()) BinarySpaceTree(begin, count, bound, stat,
+              this, maxLeafSize)
+        : new BinarySpaceTree(begin, count, bound, stat, this, maxLeafSize);
+  }
+
+  /**
+   * Destruct one child of this node.  A child built by this tree was
+   * allocated from this tree's arena and shares its arena pointer, so only
+   * its destructor is run here; its memory is reclaimed when the root deletes
+   * the arena.  Any other child -- one attached by the caller with operator
+   * new, which is a root of its own with its own arena (or none at all) -- is
+   * deleted normally.
+   *
+   * @param child Child to destruct; if NULL, nothing happens.
+   */
+  void DestroyChild(BinarySpaceTree* child)
+  {
+    if (child == NULL)
+      return;
+
+    if (arena != NULL && child->arena == arena)
+      arena->Destroy(child);
+    else
+      delete child;
   }
 
+  /**
+   * Private constructor for Flatten(): copy a single node into the given
+   * arena, then copy the children in depth-first order so that the subtree
+   * occupies consecutive memory.
+   *
+   * @param other Node to copy.
+   * @param arena Arena to allocate the copied children from.
+   * @param parent Parent of the newly copied node.
+   */
+  BinarySpaceTree(const BinarySpaceTree& other,
+                  NodeArena<BinarySpaceTree>* arena,
+                  BinarySpaceTree* parent);
+
+  /**
+   * Private constructor for loading: create a child node whose contents will
+   * be read from the given stream (see ReadNode()).  The arena and maximum
+   * leaf size are inherited from the parent.
+   *
+   * @param data The (already-permuted) dataset the tree was built on.
+   * @param parent Parent of this node.
+   * @param stream Stream to read this node's record (and children) from.
+   */
+  BinarySpaceTree(MatType& data, BinarySpaceTree* parent, std::istream& stream);
+
+  //! Write this node's record to the stream, then the children (depth-first).
+  void WriteNode(std::ostream& stream) const;
+  //! Read this node's record from the stream, then the children (depth-first).
+  void ReadNode(std::istream& stream);
+
   /**
    * Splits the current node, assigning its left and right children recursively.
    *
@@ -13,9 +13,18 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/string_util.hpp>
 
+#include <fstream>
+
 namespace mlpack {
 namespace tree {
 
+// When OpenMP is available, subtrees whose point count is at least this large
+// are built as separate tasks; smaller subtrees are built serially to avoid
+// task-creation overhead dominating the work actually done.
+#ifdef _OPENMP
+  #define BINARY_SPACE_TREE_PARALLEL_BUILD_CUTOFF 10000
+#endif
+
 // Each of these overloads is kept as a separate function to keep the overhead
 // from the two std::vectors out, if possible.
 template<typename BoundType,
@@ -33,13 +42,23 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
     maxLeafSize(maxLeafSize),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(data)
+    dataset(data),
+    arena(new NodeArena<BinarySpaceTree>())
 {
-  // Do the actual splitting of this node.
+  // Do the actual splitting of this node.  If OpenMP is enabled, spawn a
+  // thread team here; SplitNode() will build large subtrees as parallel tasks.
+  #ifdef _OPENMP
+  #pragma omp parallel
+  #pragma omp single
+  #endif
   SplitNode(data);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Create the statistic depending on if we are a leaf or not.  For
+  // lazily-built statistic types this is skipped; the statistic will be built
+  // on the first call to Stat() instead.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
 }
 
 template<typename BoundType,
@@ -58,18 +77,28 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
     maxLeafSize(maxLeafSize),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(data)
+    dataset(data),
+    arena(new NodeArena<BinarySpaceTree>())
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
   for (size_t i = 0; i < data.n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
-  // Now do the actual splitting.
+  // Now do the actual splitting.  If OpenMP is enabled, spawn a thread team
+  // here; SplitNode() will build large subtrees as parallel tasks.
+  #ifdef _OPENMP
+  #pragma omp parallel
+  #pragma omp single
+  #endif
   SplitNode(data, oldFromNew);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Create the statistic depending on if we are a leaf or not.  For
+  // lazily-built statistic types this is skipped; the statistic will be built
+  // on the first call to Stat() instead.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
 }
 
 template<typename BoundType,
@@ -89,18 +118,28 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
     maxLeafSize(maxLeafSize),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(data)
+    dataset(data),
+    arena(new NodeArena<BinarySpaceTree>())
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
   for (size_t i = 0; i < data.n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
-  // Now do the actual splitting.
+  // Now do the actual splitting.  If OpenMP is enabled, spawn a thread team
+  // here; SplitNode() will build large subtrees as parallel tasks.
+  #ifdef _OPENMP
+  #pragma omp parallel
+  #pragma omp single
+  #endif
   SplitNode(data, oldFromNew);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Create the statistic depending on if we are a leaf or not.  For
+  // lazily-built statistic types this is skipped; the statistic will be built
+  // on the first call to Stat() instead.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
 
   // Map the newFromOld indices correctly.
   newFromOld.resize(data.n_cols);
@@ -125,13 +164,19 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
     count(count),
     maxLeafSize(maxLeafSize),
     bound(data.n_rows),
-    dataset(data)
+    dataset(data),
+    arena((parent == NULL) ? new NodeArena<BinarySpaceTree>()
+                            : parent->arena)
 {
   // Perform the actual splitting.
   SplitNode(data);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Create the statistic depending on if we are a leaf or not.  For
+  // lazily-built statistic types this is skipped; the statistic will be built
+  // on the first call to Stat() instead.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
 }
 
 template<typename BoundType,
@@ -152,7 +197,9 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
     count(count),
     maxLeafSize(maxLeafSize),
     bound(data.n_rows),
-    dataset(data)
+    dataset(data),
+    arena((parent == NULL) ? new NodeArena<BinarySpaceTree>()
+                            : parent->arena)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -161,8 +208,12 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
   // Perform the actual splitting.
   SplitNode(data, oldFromNew);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Create the statistic depending on if we are a leaf or not.  For
+  // lazily-built statistic types this is skipped; the statistic will be built
+  // on the first call to Stat() instead.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
 }
 
 template<typename BoundType,
@@ -184,7 +235,9 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
     count(count),
     maxLeafSize(maxLeafSize),
     bound(data.n_rows),
-    dataset(data)
+    dataset(data),
+    arena((parent == NULL) ? new NodeArena<BinarySpaceTree>()
+                            : parent->arena)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -193,8 +246,12 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
   // Perform the actual splitting.
   SplitNode(data, oldFromNew);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Create the statistic depending on if we are a leaf or not.  For
+  // lazily-built statistic types this is skipped; the statistic will be built
+  // on the first call to Stat() instead.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
 
   // Map the newFromOld indices correctly.
   newFromOld.resize(data.n_cols);
@@ -235,10 +292,12 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
     maxLeafSize(other.maxLeafSize),
     bound(other.bound),
     stat(other.stat),
+    statInitialized(other.statInitialized),
     splitDimension(other.splitDimension),
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    arena(NULL) // Copied children are allocated individually.
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -254,6 +313,279 @@ BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
   }
 }
 
+/**
+ * Construct the tree by reading it from a binary file written with
+ * SaveBinary().  No splitting is performed.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
+    MatType& data,
+    const std::string& filename) :
+    left(NULL),
+    right(NULL),
+    parent(NULL),
+    begin(0),
+    count(data.n_cols),
+    maxLeafSize(20),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(data),
+    arena(new NodeArena<BinarySpaceTree>())
+{
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+    Log::Fatal << "BinarySpaceTree: cannot open file '" << filename << "' to "
+        << "load tree from!" << std::endl;
+
+  // Check the header.
+  char magic[4];
+  uint32_t version;
+  uint64_t dim, leafSize;
+  stream.read(magic, 4);
+  stream.read((char*) &version, sizeof(version));
+  stream.read((char*) &dim, sizeof(dim));
+  stream.read((char*) &leafSize, sizeof(leafSize));
+
+  if (!stream || memcmp(magic, "BSTb", 4) != 0 || version != 1)
+    Log::Fatal << "BinarySpaceTree: file '" << filename << "' is not a binary "
+        << "tree file!" << std::endl;
+  if (dim != data.n_rows)
+    Log::Fatal << "BinarySpaceTree: tree in file '" << filename << "' was "
+        << "built on " << dim << "-dimensional data, but the given dataset "
+        << "has dimensionality " << data.n_rows << "!" << std::endl;
+
+  maxLeafSize = (size_t) leafSize;
+
+  // Read the nodes; this is a single sequential pass over the file.
+  ReadNode(stream);
+  if (!stream)
+    Log::Fatal << "BinarySpaceTree: file '" << filename << "' is truncated!"
+        << std::endl;
+
+  // Recompute the statistics, since they are not stored in the file.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
+}
+
+/**
+ * Private constructor for loading a child node from a stream.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
+    MatType& data,
+    BinarySpaceTree* parent,
+    std::istream& stream) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(0),
+    count(0),
+    maxLeafSize(parent->maxLeafSize),
+    bound(data.n_rows),
+    dataset(data),
+    arena(parent->arena)
+{
+  ReadNode(stream);
+
+  // Recompute the statistic, since it is not stored in the file.
+  if (!StatisticTraits<StatisticType>::BuildLazily)
+    stat = StatisticType(*this);
+  statInitialized = !StatisticTraits<StatisticType>::BuildLazily;
+}
+
+/**
+ * Write this node's fixed-size record to the stream, then the children in
+ * depth-first order.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::WriteNode(
+    std::ostream& stream) const
+{
+  const uint64_t nodeBegin = begin;
+  const uint64_t nodeCount = count;
+  const uint64_t nodeSplitDim = splitDimension;
+  stream.write((const char*) &nodeBegin, sizeof(nodeBegin));
+  stream.write((const char*) &nodeCount, sizeof(nodeCount));
+  stream.write((const char*) &nodeSplitDim, sizeof(nodeSplitDim));
+  stream.write((const char*) &parentDistance, sizeof(parentDistance));
+  stream.write((const char*) &furthestDescendantDistance,
+      sizeof(furthestDescendantDistance));
+
+  for (size_t d = 0; d < dataset.n_rows; ++d)
+  {
+    const double lo = bound[d].Lo();
+    const double hi = bound[d].Hi();
+    stream.write((const char*) &lo, sizeof(lo));
+    stream.write((const char*) &hi, sizeof(hi));
+  }
+
+  const uint8_t childFlags = ((left != NULL) ? 1 : 0) |
+      ((right != NULL) ? 2 : 0);
+  stream.write((const char*) &childFlags, sizeof(childFlags));
+
+  if (left != NULL)
+    left->WriteNode(stream);
+  if (right != NULL)
+    right->WriteNode(stream);
+}
+
+/**
+ * Read this node's fixed-size record from the stream, then the children in
+ * depth-first order.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::ReadNode(
+    std::istream& stream)
+{
+  uint64_t nodeBegin, nodeCount, nodeSplitDim;
+  stream.read((char*) &nodeBegin, sizeof(nodeBegin));
+  stream.read((char*) &nodeCount, sizeof(nodeCount));
+  stream.read((char*) &nodeSplitDim, sizeof(nodeSplitDim));
+  stream.read((char*) &parentDistance, sizeof(parentDistance));
+  stream.read((char*) &furthestDescendantDistance,
+      sizeof(furthestDescendantDistance));
+
+  begin = (size_t) nodeBegin;
+  count = (size_t) nodeCount;
+  splitDimension = (size_t) nodeSplitDim;
+
+  for (size_t d = 0; d < dataset.n_rows; ++d)
+  {
+    double lo, hi;
+    stream.read((char*) &lo, sizeof(lo));
+    stream.read((char*) &hi, sizeof(hi));
+    bound[d].Lo() = lo;
+    bound[d].Hi() = hi;
+  }
+
+  uint8_t childFlags;
+  stream.read((char*) &childFlags, sizeof(childFlags));
+
+  // Bail out before creating children if the stream has gone bad.
+  if (!stream)
+    return;
+
+  if (childFlags & 1)
+    left = new (arena->Allocate()) BinarySpaceTree(dataset, this, stream);
+  if (childFlags & 2)
+    right = new (arena->Allocate()) BinarySpaceTree(dataset, this, stream);
+}
+
+/**
+ * Write the built tree to the given file in a compact binary format.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::SaveBinary(
+    const std::string& filename) const
+{
+  // Only the root of a tree can be saved.
+  Log::Assert(parent == NULL);
+
+  std::ofstream stream(filename.c_str(), std::ios::binary | std::ios::trunc);
+  if (!stream.is_open())
+    Log::Fatal << "BinarySpaceTree::SaveBinary(): cannot open file '"
+        << filename << "' to save tree to!" << std::endl;
+
+  // Write the header.
+  const uint32_t version = 1;
+  const uint64_t dim = dataset.n_rows;
+  const uint64_t leafSize = maxLeafSize;
+  stream.write("BSTb", 4);
+  stream.write((const char*) &version, sizeof(version));
+  stream.write((const char*) &dim, sizeof(dim));
+  stream.write((const char*) &leafSize, sizeof(leafSize));
+
+  // Write the nodes in depth-first order.
+  WriteNode(stream);
+
+  if (!stream)
+    Log::Fatal << "BinarySpaceTree::SaveBinary(): error writing to file '"
+        << filename << "'!" << std::endl;
+}
+
+/**
+ * Copy a single node into the given arena for Flatten(); children are copied
+ * in depth-first order so the subtree occupies consecutive memory.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::BinarySpaceTree(
+    const BinarySpaceTree& other,
+    NodeArena<BinarySpaceTree>* arena,
+    BinarySpaceTree* parent) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(other.begin),
+    count(other.count),
+    maxLeafSize(other.maxLeafSize),
+    bound(other.bound),
+    stat(other.stat),
+    statInitialized(other.statInitialized),
+    splitDimension(other.splitDimension),
+    parentDistance(other.parentDistance),
+    furthestDescendantDistance(other.furthestDescendantDistance),
+    minimumBoundDistance(other.minimumBoundDistance),
+    dataset(other.dataset),
+    arena(arena)
+{
+  // Copy the left subtree in full before the right subtree, so that the nodes
+  // end up laid out in depth-first order.
+  if (other.left)
+    left = new (arena->Allocate()) BinarySpaceTree(*other.left, arena, this);
+  if (other.right)
+    right = new (arena->Allocate()) BinarySpaceTree(*other.right, arena, this);
+}
+
+/**
+ * Compact the tree into depth-first order in a fresh arena.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::Flatten()
+{
+  // Only the root of a tree can be flattened, because the whole tree shares
+  // one arena.
+  Log::Assert(parent == NULL);
+
+  // Copy all descendants into a new arena in depth-first order.
+  NodeArena<BinarySpaceTree>* newArena = new NodeArena<BinarySpaceTree>();
+  BinarySpaceTree* newLeft = (left == NULL) ? NULL :
+      new (newArena->Allocate()) BinarySpaceTree(*left, newArena, this);
+  BinarySpaceTree* newRight = (right == NULL) ? NULL :
+      new (newArena->Allocate()) BinarySpaceTree(*right, newArena, this);
+
+  // Tear down the old nodes, then take ownership of the new layout.
+  DestroyChild(left);
+  DestroyChild(right);
+  if (arena != NULL)
+    delete arena;
+
+  left = newLeft;
+  right = newRight;
+  arena = newArena;
+}
+
 /**
  * Deletes this node, deallocating the memory for the children and calling their
  * destructors in turn.  This will invalidate any pointers or references to any
@@ -266,10 +598,15 @@ template<typename BoundType,
 BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
   ~BinarySpaceTree()
 {
-  if (left)
-    delete left;
-  if (right)
-    delete right;
+  // DestroyChild() checks, for each child, whether it was allocated from this
+  // tree's arena (in which case only its destructor is run here, and the root
+  // frees all of the arena's memory at once) or attached by the caller with
+  // operator new (in which case it is deleted normally).
+  DestroyChild(left);
+  DestroyChild(right);
+
+  if (arena != NULL && parent == NULL)
+    delete arena;
 }
 
 /**
@@ -591,11 +928,30 @@ void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::SplitNode(
     return;
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree<BoundType, StatisticType, MatType>(data, begin,
-      splitCol - begin, this, maxLeafSize);
-  right = new BinarySpaceTree<BoundType, StatisticType, MatType>(data, splitCol,
-      begin + count - splitCol, this, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  The
+  // children operate on disjoint column ranges of the dataset, so when OpenMP
+  // is enabled and this node is large enough, build them as separate tasks.
+#ifdef _OPENMP
+  if (count >= BINARY_SPACE_TREE_PARALLEL_BUILD_CUTOFF)
+  {
+    #pragma omp task default(shared)
+    left = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, begin, splitCol - begin, this, maxLeafSize);
+    #pragma omp task default(shared)
+    right = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, splitCol, begin + count - splitCol, this,
+        maxLeafSize);
+    #pragma omp taskwait
+  }
+  else
+#endif
+  {
+    left = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, begin, splitCol - begin, this, maxLeafSize);
+    right = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, splitCol, begin + count - splitCol, this,
+        maxLeafSize);
+  }
 
   // Calculate parent distances for those two nodes.
   arma::vec centroid, leftCentroid, rightCentroid;
@@ -648,11 +1004,33 @@ void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::SplitNode(
     return;
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree<BoundType, StatisticType, MatType>(data, begin,
-      splitCol - begin, oldFromNew, this, maxLeafSize);
-  right = new BinarySpaceTree<BoundType, StatisticType, MatType>(data, splitCol,
-      begin + count - splitCol, oldFromNew, this, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  The
+  // children operate on disjoint ranges of the dataset and of oldFromNew, so
+  // when OpenMP is enabled and this node is large enough, build them as
+  // separate tasks.
+#ifdef _OPENMP
+  if (count >= BINARY_SPACE_TREE_PARALLEL_BUILD_CUTOFF)
+  {
+    #pragma omp task default(shared)
+    left = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, begin, splitCol - begin, oldFromNew, this,
+        maxLeafSize);
+    #pragma omp task default(shared)
+    right = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, splitCol, begin + count - splitCol, oldFromNew,
+        this, maxLeafSize);
+    #pragma omp taskwait
+  }
+  else
+#endif
+  {
+    left = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, begin, splitCol - begin, oldFromNew, this,
+        maxLeafSize);
+    right = new (arena->Allocate()) BinarySpaceTree<BoundType, StatisticType,
+        MatType>(data, splitCol, begin + count - splitCol, oldFromNew,
+        this, maxLeafSize);
+  }
 
   // Calculate parent distances for those two nodes.
   arma::vec centroid, leftCentroid, rightCentroid;
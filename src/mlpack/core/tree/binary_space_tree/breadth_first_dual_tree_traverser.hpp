@@ -11,6 +11,7 @@
 #define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_BREADTH_FIRST_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "binary_space_tree.hpp"
 
@@ -34,9 +35,16 @@ class BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
   /**
    * Traverse the two trees.  This does not reset the number of prunes.
    *
+   * The frontier of each level is held in a flat, preallocated buffer of
+   * plain frames (reused across levels and across calls, so steady-state
+   * traversal performs no per-frame allocation).  Each generation is
+   * processed best-score-first, and the scores of a generation -- which may
+   * have gone stale as earlier work tightened the candidate bounds -- are
+   * re-evaluated in one bulk pass before it is expanded, instead of each
+   * sibling pair being rescored at creation time.
+   *
    * @param queryNode The query node to be traversed.
    * @param referenceNode The reference node to be traversed.
-   * @param score The score of the current node combination.
    */
   void Traverse(BinarySpaceTree& queryNode,
                 BinarySpaceTree& referenceNode);
@@ -61,10 +69,46 @@ class BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
+
  private:
+  /**
+   * One entry of the breadth-first frontier: a node combination, the score it
+   * received when it was created, and the traversal information to restore
+   * before expanding it.  Kept flat so the frontier can live in a contiguous
+   * preallocated buffer.
+   */
+  struct QueueFrame
+  {
+    //! The query node of the combination.
+    BinarySpaceTree* queryNode;
+    //! The reference node of the combination.
+    BinarySpaceTree* referenceNode;
+    //! The score of the combination at creation time (may be stale).
+    double score;
+    //! The traversal information to restore before expanding the frame.
+    typename RuleType::TraversalInfoType traversalInfo;
+  };
+
+  //! Comparator for sorting a generation of frames best-score-first.
+  static bool FrameIsBetter(const QueueFrame& a, const QueueFrame& b)
+  {
+    return a.score < b.score;
+  }
+
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
 
+  //! The current generation of the frontier.  This is a member so its
+  //! capacity survives across levels and across calls to Traverse().
+  std::vector<QueueFrame> frontier;
+  //! The generation being built while the current one is expanded.
+  std::vector<QueueFrame> nextFrontier;
+
   //! The number of prunes.
   size_t numPrunes;
 
@@ -77,6 +121,9 @@ class BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
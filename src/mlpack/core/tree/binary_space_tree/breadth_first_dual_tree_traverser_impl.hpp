@@ -12,7 +12,8 @@
 // In case it hasn't been included yet.
 #include "breadth_first_dual_tree_traverser.hpp"
 
-#include <queue>
+#include <algorithm>
+#include <vector>
 
 namespace mlpack {
 namespace tree {
@@ -52,387 +53,150 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   typedef BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>
       TreeType;
 
-  std::queue<TreeType*> queryList;
-  std::queue<TreeType*> referenceList;
-  std::queue<typename RuleType::TraversalInfoType> traversalInfos;
-  queryList.push(&queryRoot);
-  referenceList.push(&referenceRoot);
-  traversalInfos.push(rule.TraversalInfo());
-
-  while (!queryList.empty())
+  // Seed the frontier with the root combination.  The frontier buffers are
+  // members, so whatever capacity they grew to on a previous call (or a
+  // previous level of this call) is still there and no allocation happens in
+  // the steady state.
+  frontier.clear();
+  nextFrontier.clear();
+
+  QueueFrame rootFrame;
+  rootFrame.queryNode = &queryRoot;
+  rootFrame.referenceNode = &referenceRoot;
+  rootFrame.score = 0.0; // The root combination is never pruned.
+  rootFrame.traversalInfo = rule.TraversalInfo();
+  frontier.push_back(rootFrame);
+
+  size_t depth = 0;
+  while (!frontier.empty())
   {
-    TreeType& queryNode = *queryList.front();
-    TreeType& referenceNode = *referenceList.front();
-    typename RuleType::TraversalInfoType ti = traversalInfos.front();
-
-    queryList.pop();
-    referenceList.pop();
-    traversalInfos.pop();
-
-    rule.TraversalInfo() = ti;
-
-    // If both are leaves, we must evaluate the base case.
-    if (queryNode.IsLeaf() && referenceNode.IsLeaf())
-    {
-      // Loop through each of the points in each node.
-      for (size_t query = queryNode.Begin(); query < queryNode.End(); ++query)
-      {
-        // See if we need to investigate this point (this function should be
-        // implemented for the single-tree recursion too).  Restore the traversal
-        // information first.
-//        const double childScore = rule.Score(query, referenceNode);
-
-//        if (childScore == DBL_MAX)
-//          continue; // We can't improve this particular point.
-
-        for (size_t ref = referenceNode.Begin(); ref < referenceNode.End(); ++ref)
-          rule.BaseCase(query, ref);
-
-        numBaseCases += referenceNode.Count();
-      }
-    }
-    else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
-    {
-      // We have to recurse down the query node.  In this case the recursion order
-      // does not matter.
-      const double leftScore = rule.Score(*queryNode.Left(), referenceNode);
-      ++numScores;
-
-      if (leftScore != DBL_MAX)
-      {
-        queryList.push(queryNode.Left());
-        referenceList.push(&referenceNode);
-        traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push1 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-      }
-      else
-      {
-        ++numPrunes;
-      }
-
-      // Before recursing, we have to set the traversal information correctly.
-      rule.TraversalInfo() = ti;
-      const double rightScore = rule.Score(*queryNode.Right(), referenceNode);
-      ++numScores;
-
-      if (rightScore != DBL_MAX)
-      {
-        queryList.push(queryNode.Right());
-        referenceList.push(&referenceNode);
-        traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push2 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-      }
-      else
-        ++numPrunes;
-    }
-    else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
+    // The scores stored in the frames were calculated when the frames were
+    // created, one level ago; any base cases and scores computed since then
+    // may have tightened the bounds enough to prune some of them.  Re-evaluate
+    // the whole generation in one pass, compacting the survivors in place.
+    // The root combination is not rescored -- it was never scored.
+    if (depth > 0)
     {
-      // We have to recurse down the reference node.  In this case the recursion
-      // order does matter.  Before recursing, though, we have to set the
-      // traversal information correctly.
-      double leftScore = rule.Score(queryNode, *referenceNode.Left());
-      typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
-      rule.TraversalInfo() = ti;
-      double rightScore = rule.Score(queryNode, *referenceNode.Right());
-      numScores += 2;
-
-      if (leftScore < rightScore)
+      size_t kept = 0;
+      for (size_t i = 0; i < frontier.size(); ++i)
       {
-        // Recurse to the left.  Restore the left traversal info.  Store the right
-        // traversal info.
-        queryList.push(&queryNode);
-        referenceList.push(referenceNode.Left());
-        traversalInfos.push(leftInfo);
-//        Log::Debug << "Push3 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-
-        // Is it still valid to recurse to the right?
-        rightScore = rule.Rescore(queryNode, *referenceNode.Right(), rightScore);
+        const double rescore = rule.Rescore(*frontier[i].queryNode,
+            *frontier[i].referenceNode, frontier[i].score);
 
-        if (rightScore != DBL_MAX)
+        if (rescore == DBL_MAX)
         {
-          // Restore the right traversal info.
-          queryList.push(&queryNode);
-          referenceList.push(referenceNode.Right());
-          traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push4 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
+          ++numPrunes;
+          stats.Prune();
         }
         else
-          ++numPrunes;
-      }
-      else if (rightScore < leftScore)
-    {
-      // Recurse to the right.
-      queryList.push(&queryNode);
-      referenceList.push(referenceNode.Right());
-      traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push5 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-
-      // Is it still valid to recurse to the left?
-      leftScore = rule.Rescore(queryNode, *referenceNode.Left(), leftScore);
-
-      if (leftScore != DBL_MAX)
-      {
-        // Restore the left traversal info.
-        queryList.push(&queryNode);
-        referenceList.push(referenceNode.Left());
-        traversalInfos.push(leftInfo);
-//        Log::Debug << "Push6 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-      }
-      else
-        ++numPrunes;
-    }
-    else // leftScore is equal to rightScore.
-    {
-      if (leftScore == DBL_MAX)
-      {
-        numPrunes += 2;
-      }
-      else
-      {
-        // Choose the left first.  Restore the left traversal info.  Store the
-        // right traversal info.
-        queryList.push(&queryNode);
-        referenceList.push(referenceNode.Left());
-        traversalInfos.push(leftInfo);
-//        Log::Debug << "Push7 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-
-        rightScore = rule.Rescore(queryNode, *referenceNode.Right(),
-            rightScore);
-
-        if (rightScore != DBL_MAX)
         {
-          // Restore the right traversal info.
-          queryList.push(&queryNode);
-          referenceList.push(referenceNode.Right());
-          traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push8 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
+          frontier[kept] = frontier[i];
+          frontier[kept].score = rescore;
+          ++kept;
         }
-        else
-          ++numPrunes;
       }
+      frontier.resize(kept);
+
+      // Process the best combinations first, so that the bounds are as tight
+      // as possible when the worse combinations are expanded (and more of
+      // their children can be pruned).
+      std::sort(frontier.begin(), frontier.end(), FrameIsBetter);
     }
-  }
-  else
-  {
-    // We have to recurse down both query and reference nodes.  Because the
-    // query descent order does not matter, we will go to the left query child
-    // first.  Before recursing, we have to set the traversal information
-    // correctly.
-    double leftScore = rule.Score(*queryNode.Left(), *referenceNode.Left());
-    typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
-    rule.TraversalInfo() = ti;
-    double rightScore = rule.Score(*queryNode.Left(), *referenceNode.Right());
-    typename RuleType::TraversalInfoType rightInfo;
-    numScores += 2;
 
-    if (leftScore < rightScore)
+    for (size_t i = 0; i < frontier.size(); ++i)
     {
-      // Recurse to the left.  Restore the left traversal info.  Store the right
-      // traversal info.
-      queryList.push(queryNode.Left());
-      referenceList.push(referenceNode.Left());
-      traversalInfos.push(leftInfo);
-//        Log::Debug << "Push9 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-
-      // Is it still valid to recurse to the right?
-      rightScore = rule.Rescore(*queryNode.Left(), *referenceNode.Right(),
-          rightScore);
+      TreeType& queryNode = *frontier[i].queryNode;
+      TreeType& referenceNode = *frontier[i].referenceNode;
+      const typename RuleType::TraversalInfoType ti = frontier[i].traversalInfo;
 
-      if (rightScore != DBL_MAX)
-      {
-        // Restore the right traversal info.
-        queryList.push(queryNode.Left());
-        referenceList.push(referenceNode.Right());
-        traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push10 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-      }
-      else
-        ++numPrunes;
-    }
-    else if (rightScore < leftScore)
-    {
-      // Recurse to the right.
-      queryList.push(queryNode.Left());
-      referenceList.push(referenceNode.Right());
-      traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push11 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
+      stats.Visit(depth);
 
-      // Is it still valid to recurse to the left?
-      leftScore = rule.Rescore(*queryNode.Left(), *referenceNode.Left(),
-          leftScore);
+      rule.TraversalInfo() = ti;
 
-      if (leftScore != DBL_MAX)
+      // If both are leaves, we must evaluate the base case.
+      if (queryNode.IsLeaf() && referenceNode.IsLeaf())
       {
-        // Restore the left traversal info.
-        queryList.push(queryNode.Left());
-        referenceList.push(referenceNode.Left());
-        traversalInfos.push(leftInfo);
-//        Log::Debug << "Push12 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-      }
-      else
-        ++numPrunes;
-    }
-    else
-    {
-      if (leftScore == DBL_MAX)
-      {
-        numPrunes += 2;
-      }
-      else
-      {
-        // Choose the left first.  Restore the left traversal info and store the
-        // right traversal info.
-        queryList.push(queryNode.Left());
-        referenceList.push(referenceNode.Left());
-        traversalInfos.push(leftInfo);
-//        Log::Debug << "Push13 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-
-        // Is it still valid to recurse to the right?
-        rightScore = rule.Rescore(*queryNode.Left(), *referenceNode.Right(),
-            rightScore);
-
-        if (rightScore != DBL_MAX)
+        // Loop through each of the points in each node.
+        for (size_t query = queryNode.Begin(); query < queryNode.End();
+            ++query)
         {
-          // Restore the right traversal information.
-          queryList.push(queryNode.Left());
-          referenceList.push(referenceNode.Right());
-          traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push14 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-        }
-        else
-          ++numPrunes;
-      }
-    }
+          rule.BaseCases(query, referenceNode.Begin(), referenceNode.End());
 
-    // Restore the main traversal information.
-    rule.TraversalInfo() = ti;
-
-    // Now recurse down the right query node.
-    leftScore = rule.Score(*queryNode.Right(), *referenceNode.Left());
-    leftInfo = rule.TraversalInfo();
-    rule.TraversalInfo() = ti;
-    rightScore = rule.Score(*queryNode.Right(), *referenceNode.Right());
-    numScores += 2;
+          numBaseCases += referenceNode.Count();
+          stats.BaseCase(referenceNode.Count());
+        }
 
-    if (leftScore < rightScore)
-    {
-      // Recurse to the left.  Restore the left traversal info.  Store the right
-      // traversal info.
-      queryList.push(queryNode.Right());
-      referenceList.push(referenceNode.Left());
-      traversalInfos.push(leftInfo);
-//        Log::Debug << "Push15 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
+        continue;
+      }
 
-      // Is it still valid to recurse to the right?
-      rightScore = rule.Rescore(*queryNode.Right(), *referenceNode.Right(),
-          rightScore);
+      // At least one node has children.  A leaf stands in for itself, so all
+      // four shapes of recursion collapse into one enumeration of child
+      // combinations.  The recursion priority that the old depth-first-style
+      // ordering provided is now supplied by the sorted processing of the next
+      // generation instead.
+      TreeType* queryChildren[2];
+      TreeType* referenceChildren[2];
+      size_t numQueryChildren;
+      size_t numReferenceChildren;
 
-      if (rightScore != DBL_MAX)
+      if (queryNode.IsLeaf())
       {
-        // Restore the right traversal info.
-        queryList.push(queryNode.Right());
-        referenceList.push(referenceNode.Right());
-        traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push16 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
+        queryChildren[0] = &queryNode;
+        numQueryChildren = 1;
       }
       else
-        ++numPrunes;
-    }
-    else if (rightScore < leftScore)
-    {
-      // Recurse to the right.
-      queryList.push(queryNode.Right());
-      referenceList.push(referenceNode.Right());
-      traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push17 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-
-      // Is it still valid to recurse to the left?
-      leftScore = rule.Rescore(*queryNode.Right(), *referenceNode.Left(),
-          leftScore);
-
-      if (leftScore != DBL_MAX)
       {
-        // Restore the left traversal info.
-        queryList.push(queryNode.Right());
-        referenceList.push(referenceNode.Left());
-        traversalInfos.push(leftInfo);
-//        Log::Debug << "Push18 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
+        queryChildren[0] = queryNode.Left();
+        queryChildren[1] = queryNode.Right();
+        numQueryChildren = 2;
       }
-      else
-        ++numPrunes;
-    }
-    else
-    {
-      if (leftScore == DBL_MAX)
+
+      if (referenceNode.IsLeaf())
       {
-        numPrunes += 2;
+        referenceChildren[0] = &referenceNode;
+        numReferenceChildren = 1;
       }
       else
       {
-        // Choose the left first.  Restore the left traversal info.  Store the
-        // right traversal info.
-        queryList.push(queryNode.Right());
-        referenceList.push(referenceNode.Left());
-        traversalInfos.push(leftInfo);
-//        Log::Debug << "Push19 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
-
-        // Is it still valid to recurse to the right?
-        rightScore = rule.Rescore(*queryNode.Right(), *referenceNode.Right(),
-            rightScore);
+        referenceChildren[0] = referenceNode.Left();
+        referenceChildren[1] = referenceNode.Right();
+        numReferenceChildren = 2;
+      }
 
-        if (rightScore != DBL_MAX)
+      for (size_t q = 0; q < numQueryChildren; ++q)
+      {
+        for (size_t r = 0; r < numReferenceChildren; ++r)
         {
-          // Restore the right traversal info.
-          queryList.push(queryNode.Right());
-          referenceList.push(referenceNode.Right());
-          traversalInfos.push(rule.TraversalInfo());
-//        Log::Debug << "Push20 " << queryList.back()->Begin() << ", " <<
-//queryList.back()->Count() << "; " << referenceList.back()->Begin() << ", "
-//    << referenceList.back()->Count() << "\n";
+          // Each score must start from the traversal information of the
+          // parent combination.
+          rule.TraversalInfo() = ti;
+          const double score = rule.Score(*queryChildren[q],
+              *referenceChildren[r]);
+          ++numScores;
+          stats.Score();
+
+          if (score == DBL_MAX)
+          {
+            ++numPrunes;
+            stats.Prune();
+            continue;
+          }
+
+          QueueFrame frame;
+          frame.queryNode = queryChildren[q];
+          frame.referenceNode = referenceChildren[r];
+          frame.score = score;
+          frame.traversalInfo = rule.TraversalInfo();
+          nextFrontier.push_back(frame);
         }
-        else
-          ++numPrunes;
       }
     }
-    }
+
+    // The next generation becomes the current one; the old buffer is reused
+    // (with its capacity intact) to build the generation after that.
+    frontier.swap(nextFrontier);
+    nextFrontier.clear();
+    ++depth;
   }
 }
 
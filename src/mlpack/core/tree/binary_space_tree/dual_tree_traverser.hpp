@@ -11,6 +11,7 @@
 #define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "binary_space_tree.hpp"
 
@@ -61,6 +62,12 @@ class BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
+
  private:
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
@@ -77,6 +84,12 @@ class BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
+
+  //! The current depth of the recursion, for the statistics.
+  size_t depth;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
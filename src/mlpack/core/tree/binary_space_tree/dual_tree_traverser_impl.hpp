@@ -26,7 +26,8 @@ DualTreeTraverser<RuleType>::DualTreeTraverser(RuleType& rule) :
     numPrunes(0),
     numVisited(0),
     numScores(0),
-    numBaseCases(0)
+    numBaseCases(0),
+    depth(0)
 { /* Nothing to do. */ }
 
 template<typename BoundType,
@@ -42,6 +43,8 @@ DualTreeTraverser<RuleType>::Traverse(
 {
   // Increment the visit counter.
   ++numVisited;
+  stats.Visit(depth);
+  ++depth;
 
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
@@ -61,44 +64,64 @@ DualTreeTraverser<RuleType>::Traverse(
       if (childScore == DBL_MAX)
         continue; // We can't improve this particular point.
 
-      for (size_t ref = referenceNode.Begin(); ref < referenceNode.End(); ++ref)
-        rule.BaseCase(query, ref);
+      // The batched form lets the rules evaluate the whole block of leaf
+      // points at once.
+      rule.BaseCases(query, referenceNode.Begin(), referenceNode.End());
 
       numBaseCases += referenceNode.Count();
+      stats.BaseCase(referenceNode.Count());
     }
   }
   else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
   {
     // We have to recurse down the query node.  In this case the recursion order
-    // does not matter.
+    // does not matter.  Hint both query children toward the cache first; with
+    // the flattened node layout only the left child is adjacent, so the fetch
+    // of the right child overlaps with the scoring of the left.
+    mlpack_prefetch(queryNode.Left());
+    mlpack_prefetch(queryNode.Right());
+
     const double leftScore = rule.Score(*queryNode.Left(), referenceNode);
     ++numScores;
+    stats.Score();
 
     if (leftScore != DBL_MAX)
       Traverse(*queryNode.Left(), referenceNode);
     else
+    {
       ++numPrunes;
+      stats.Prune();
+    }
 
     // Before recursing, we have to set the traversal information correctly.
     rule.TraversalInfo() = traversalInfo;
     const double rightScore = rule.Score(*queryNode.Right(), referenceNode);
     ++numScores;
+    stats.Score();
 
     if (rightScore != DBL_MAX)
       Traverse(*queryNode.Right(), referenceNode);
     else
+    {
       ++numPrunes;
+      stats.Prune();
+    }
   }
   else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
   {
     // We have to recurse down the reference node.  In this case the recursion
-    // order does matter.  Before recursing, though, we have to set the
-    // traversal information correctly.
+    // order does matter.  Hint both reference children toward the cache before
+    // they are scored.  Before recursing, though, we have to set the traversal
+    // information correctly.
+    mlpack_prefetch(referenceNode.Left());
+    mlpack_prefetch(referenceNode.Right());
+
     double leftScore = rule.Score(queryNode, *referenceNode.Left());
     typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
     rule.TraversalInfo() = traversalInfo;
     double rightScore = rule.Score(queryNode, *referenceNode.Right());
     numScores += 2;
+    stats.Score(2);
 
     if (leftScore < rightScore)
     {
@@ -118,7 +141,10 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(queryNode, *referenceNode.Right());
       }
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -135,13 +161,17 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(queryNode, *referenceNode.Left());
       }
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else // leftScore is equal to rightScore.
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2;
+        stats.Prune(2);
       }
       else
       {
@@ -161,7 +191,10 @@ DualTreeTraverser<RuleType>::Traverse(
           Traverse(queryNode, *referenceNode.Right());
         }
         else
+        {
           ++numPrunes;
+          stats.Prune();
+        }
       }
     }
   }
@@ -169,14 +202,21 @@ DualTreeTraverser<RuleType>::Traverse(
   {
     // We have to recurse down both query and reference nodes.  Because the
     // query descent order does not matter, we will go to the left query child
-    // first.  Before recursing, we have to set the traversal information
+    // first.  Hint all four children toward the cache before the scoring
+    // starts.  Before recursing, we have to set the traversal information
     // correctly.
+    mlpack_prefetch(queryNode.Left());
+    mlpack_prefetch(queryNode.Right());
+    mlpack_prefetch(referenceNode.Left());
+    mlpack_prefetch(referenceNode.Right());
+
     double leftScore = rule.Score(*queryNode.Left(), *referenceNode.Left());
     typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
     rule.TraversalInfo() = traversalInfo;
     double rightScore = rule.Score(*queryNode.Left(), *referenceNode.Right());
     typename RuleType::TraversalInfoType rightInfo;
     numScores += 2;
+    stats.Score(2);
 
     if (leftScore < rightScore)
     {
@@ -197,7 +237,10 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Left(), *referenceNode.Right());
       }
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -215,13 +258,17 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Left(), *referenceNode.Left());
       }
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2;
+        stats.Prune(2);
       }
       else
       {
@@ -242,7 +289,10 @@ DualTreeTraverser<RuleType>::Traverse(
           Traverse(*queryNode.Left(), *referenceNode.Right());
         }
         else
+        {
           ++numPrunes;
+          stats.Prune();
+        }
       }
     }
 
@@ -255,6 +305,7 @@ DualTreeTraverser<RuleType>::Traverse(
     rule.TraversalInfo() = traversalInfo;
     rightScore = rule.Score(*queryNode.Right(), *referenceNode.Right());
     numScores += 2;
+    stats.Score(2);
 
     if (leftScore < rightScore)
     {
@@ -275,7 +326,10 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Right(), *referenceNode.Right());
       }
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -293,13 +347,17 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Right(), *referenceNode.Left());
       }
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2;
+        stats.Prune(2);
       }
       else
       {
@@ -320,10 +378,15 @@ DualTreeTraverser<RuleType>::Traverse(
           Traverse(*queryNode.Right(), *referenceNode.Right());
         }
         else
+        {
           ++numPrunes;
+          stats.Prune();
+        }
       }
     }
   }
+
+  --depth;
 }
 
 }; // namespace tree
@@ -0,0 +1,362 @@
+/**
+ * @file external_binary_space_tree.cpp
+ * @author Ryan Curtin
+ *
+ * Implementation of ExternalBinarySpaceTree.  The on-disk representation is
+ * a sequence of fixed-size records, one per point: the dims coordinates of
+ * the point followed by its original dataset index (stored as a double,
+ * which is exact for any dataset that fits on disk).
+ */
+#include "external_binary_space_tree.hpp"
+
+#include <mlpack/core/data/streaming_loader.hpp>
+
+#include <cstdio>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+ExternalBinarySpaceTree::ExternalBinarySpaceTree(
+    const std::string& filename,
+    const std::string& workingPrefix,
+    const size_t blockSize,
+    const size_t maxResidentBlocks) :
+    workingPrefix(workingPrefix),
+    blockSize(blockSize),
+    maxResidentBlocks(maxResidentBlocks),
+    numPoints(0),
+    dims(0),
+    numBlocks(0),
+    tempFiles(0),
+    useTick(0),
+    blockFaults(0)
+{
+  // Stream the input into the root record file, appending the original index
+  // of each point to its record.
+  data::StreamingLoader<> loader(filename, 1024);
+  dims = loader.Dimensionality();
+
+  std::ostringstream rootName;
+  rootName << workingPrefix << ".partition" << tempFiles++;
+  const std::string rootFile = rootName.str();
+
+  std::ofstream out(rootFile.c_str(), std::ios::binary);
+  if (!out.is_open())
+    Log::Fatal << "ExternalBinarySpaceTree: cannot write to '" << rootFile
+        << "'!" << std::endl;
+
+  arma::mat batch;
+  while (loader.Next(batch))
+  {
+    arma::mat records(dims + 1, batch.n_cols);
+    records.rows(0, dims - 1) = batch;
+    for (size_t i = 0; i < batch.n_cols; ++i)
+      records(dims, i) = (double) (numPoints + i);
+
+    out.write((const char*) records.memptr(),
+        records.n_elem * sizeof(double));
+    numPoints += batch.n_cols;
+  }
+  out.close();
+
+  if (numPoints == 0)
+    Log::Fatal << "ExternalBinarySpaceTree: the file '" << filename
+        << "' holds no points!" << std::endl;
+
+  BuildNode(rootFile, numPoints);
+
+  Log::Info << "ExternalBinarySpaceTree: built " << nodes.size()
+      << " nodes over " << numBlocks << " on-disk blocks ("
+      << numPoints << " points)." << std::endl;
+}
+
+ExternalBinarySpaceTree::~ExternalBinarySpaceTree()
+{
+  for (size_t i = 0; i < numBlocks; ++i)
+    std::remove(BlockFileName(i).c_str());
+}
+
+size_t ExternalBinarySpaceTree::BuildNode(const std::string& recordFile,
+                                          const size_t count)
+{
+  // References into the node vector do not survive the recursive calls (the
+  // vector may grow), so the node is always addressed by its index.
+  const size_t nodeIndex = nodes.size();
+  nodes.push_back(Node());
+  nodes[nodeIndex].left = size_t(-1);
+  nodes[nodeIndex].right = size_t(-1);
+  nodes[nodeIndex].block = size_t(-1);
+  nodes[nodeIndex].count = count;
+
+  // One streaming pass for the bound of this node's points.
+  bound::HRectBound<2> bound(dims);
+  ComputeBound(recordFile, count, bound);
+  nodes[nodeIndex].bound = bound;
+
+  // Find the dimension with maximum width, as MeanSplit does.
+  size_t splitDimension = dims;
+  double maxWidth = -1;
+  for (size_t d = 0; d < dims; d++)
+  {
+    const double width = bound[d].Width();
+    if (width > maxWidth)
+    {
+      maxWidth = width;
+      splitDimension = d;
+    }
+  }
+
+  // Small nodes -- and unsplittable ones, where every point is identical --
+  // keep their record file as an on-disk leaf block.
+  if ((count <= blockSize) || (maxWidth == 0))
+  {
+    const size_t blockId = numBlocks++;
+    if (std::rename(recordFile.c_str(), BlockFileName(blockId).c_str()) != 0)
+      Log::Fatal << "ExternalBinarySpaceTree: cannot create block file '"
+          << BlockFileName(blockId) << "'!" << std::endl;
+    nodes[nodeIndex].block = blockId;
+    return nodeIndex;
+  }
+
+  // Split in the middle of the widest dimension, streaming the points into
+  // one record file per side; the parent file is removed immediately, so the
+  // transient disk usage stays bounded.
+  const double splitVal = bound[splitDimension].Mid();
+
+  std::ostringstream leftName, rightName;
+  leftName << workingPrefix << ".partition" << tempFiles++;
+  rightName << workingPrefix << ".partition" << tempFiles++;
+  const std::string leftFile = leftName.str();
+  const std::string rightFile = rightName.str();
+
+  const size_t leftCount = Partition(recordFile, count, splitDimension,
+      splitVal, leftFile, rightFile);
+  std::remove(recordFile.c_str());
+
+  // The midpoint lies strictly inside the widest dimension's range, so both
+  // sides are expected to be nonempty; guard against surprises anyway.
+  if ((leftCount == 0) || (leftCount == count))
+  {
+    Log::Warn << "ExternalBinarySpaceTree: degenerate split; storing "
+        << count << " points as one block." << std::endl;
+    const std::string& fullFile = (leftCount == 0) ? rightFile : leftFile;
+    const std::string& emptyFile = (leftCount == 0) ? leftFile : rightFile;
+    std::remove(emptyFile.c_str());
+
+    const size_t blockId = numBlocks++;
+    if (std::rename(fullFile.c_str(), BlockFileName(blockId).c_str()) != 0)
+      Log::Fatal << "ExternalBinarySpaceTree: cannot create block file '"
+          << BlockFileName(blockId) << "'!" << std::endl;
+    nodes[nodeIndex].block = blockId;
+    return nodeIndex;
+  }
+
+  nodes[nodeIndex].left = BuildNode(leftFile, leftCount);
+  nodes[nodeIndex].right = BuildNode(rightFile, count - leftCount);
+
+  return nodeIndex;
+}
+
+void ExternalBinarySpaceTree::ComputeBound(const std::string& recordFile,
+                                           const size_t count,
+                                           bound::HRectBound<2>& bound) const
+{
+  std::ifstream in(recordFile.c_str(), std::ios::binary);
+  if (!in.is_open())
+    Log::Fatal << "ExternalBinarySpaceTree: cannot read '" << recordFile
+        << "'!" << std::endl;
+
+  const size_t batchCols = 1024;
+  arma::mat records(dims + 1, batchCols);
+
+  size_t done = 0;
+  while (done < count)
+  {
+    const size_t cols = std::min(batchCols, count - done);
+    in.read((char*) records.memptr(), cols * (dims + 1) * sizeof(double));
+
+    bound |= records.submat(0, 0, dims - 1, cols - 1);
+    done += cols;
+  }
+}
+
+size_t ExternalBinarySpaceTree::Partition(const std::string& recordFile,
+                                          const size_t count,
+                                          const size_t splitDimension,
+                                          const double splitVal,
+                                          const std::string& leftFile,
+                                          const std::string& rightFile) const
+{
+  std::ifstream in(recordFile.c_str(), std::ios::binary);
+  std::ofstream left(leftFile.c_str(), std::ios::binary);
+  std::ofstream right(rightFile.c_str(), std::ios::binary);
+  if (!in.is_open() || !left.is_open() || !right.is_open())
+    Log::Fatal << "ExternalBinarySpaceTree: cannot partition '" << recordFile
+        << "'!" << std::endl;
+
+  const size_t batchCols = 1024;
+  const size_t recordBytes = (dims + 1) * sizeof(double);
+  arma::mat records(dims + 1, batchCols);
+
+  size_t leftCount = 0;
+  size_t done = 0;
+  while (done < count)
+  {
+    const size_t cols = std::min(batchCols, count - done);
+    in.read((char*) records.memptr(), cols * recordBytes);
+
+    for (size_t i = 0; i < cols; ++i)
+    {
+      const char* record = (const char*) (records.memptr() + i * (dims + 1));
+      if (records(splitDimension, i) < splitVal)
+      {
+        left.write(record, recordBytes);
+        ++leftCount;
+      }
+      else
+      {
+        right.write(record, recordBytes);
+      }
+    }
+
+    done += cols;
+  }
+
+  return leftCount;
+}
+
+const ExternalBinarySpaceTree::ResidentBlock&
+ExternalBinarySpaceTree::GetBlock(const size_t blockId)
+{
+  std::map<size_t, ResidentBlock>::iterator it = residentBlocks.find(blockId);
+  if (it != residentBlocks.end())
+  {
+    it->second.lastUse = ++useTick;
+    return it->second;
+  }
+
+  // Evict the least recently used block if the cache is full.
+  if (residentBlocks.size() >= maxResidentBlocks)
+  {
+    std::map<size_t, ResidentBlock>::iterator oldest = residentBlocks.begin();
+    for (it = residentBlocks.begin(); it != residentBlocks.end(); ++it)
+      if (it->second.lastUse < oldest->second.lastUse)
+        oldest = it;
+    residentBlocks.erase(oldest);
+  }
+
+  // Fault the block in from disk; its size tells us how many points it has.
+  ++blockFaults;
+  const std::string blockFile = BlockFileName(blockId);
+  std::ifstream in(blockFile.c_str(), std::ios::binary);
+  if (!in.is_open())
+    Log::Fatal << "ExternalBinarySpaceTree: cannot read block file '"
+        << blockFile << "'!" << std::endl;
+
+  const size_t recordBytes = (dims + 1) * sizeof(double);
+  in.seekg(0, std::ios::end);
+  const size_t count = ((size_t) in.tellg()) / recordBytes;
+  in.seekg(0, std::ios::beg);
+
+  arma::mat records(dims + 1, count);
+  in.read((char*) records.memptr(), count * recordBytes);
+
+  ResidentBlock& block = residentBlocks[blockId];
+  block.points = records.rows(0, dims - 1);
+  block.indices.set_size(count);
+  for (size_t i = 0; i < count; ++i)
+    block.indices[i] = (arma::uword) records(dims, i);
+  block.lastUse = ++useTick;
+
+  return block;
+}
+
+void ExternalBinarySpaceTree::Search(const arma::mat& querySet,
+                                     const size_t k,
+                                     arma::Mat<size_t>& neighbors,
+                                     arma::mat& distances)
+{
+  if (querySet.n_rows != dims)
+    Log::Fatal << "ExternalBinarySpaceTree::Search(): query dimensionality ("
+        << querySet.n_rows << ") does not match the tree (" << dims << ")!"
+        << std::endl;
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(size_t() - 1);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(std::numeric_limits<double>::max());
+
+  arma::Col<size_t> queryNeighbors(k);
+  arma::vec queryDistances(k);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    queryNeighbors.fill(size_t() - 1);
+    queryDistances.fill(std::numeric_limits<double>::max());
+
+    SearchNode(0, querySet.unsafe_col(i), k, queryNeighbors, queryDistances);
+
+    neighbors.col(i) = queryNeighbors;
+    distances.col(i) = queryDistances;
+  }
+}
+
+void ExternalBinarySpaceTree::SearchNode(const size_t nodeIndex,
+                                         const arma::vec& query,
+                                         const size_t k,
+                                         arma::Col<size_t>& neighbors,
+                                         arma::vec& distances)
+{
+  const Node& node = nodes[nodeIndex];
+
+  // Prune if the bound cannot hold anything better than the worst kept
+  // candidate.
+  if (node.bound.MinDistance(query) > distances[k - 1])
+    return;
+
+  if (node.block != size_t(-1))
+  {
+    // A leaf: fault the block in (if necessary) and scan its points.  The
+    // candidate lists stay sorted, best first.
+    const ResidentBlock& block = GetBlock(node.block);
+    for (size_t j = 0; j < block.points.n_cols; ++j)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(query,
+          block.points.unsafe_col(j));
+      if (distance < distances[k - 1])
+      {
+        size_t pos = k - 1;
+        while ((pos > 0) && (distance < distances[pos - 1]))
+        {
+          distances[pos] = distances[pos - 1];
+          neighbors[pos] = neighbors[pos - 1];
+          --pos;
+        }
+        distances[pos] = distance;
+        neighbors[pos] = block.indices[j];
+      }
+    }
+    return;
+  }
+
+  // Recurse into the nearer child first, so the candidate list tightens
+  // before the farther child is considered (and possibly pruned).
+  const double leftDistance = nodes[node.left].bound.MinDistance(query);
+  const double rightDistance = nodes[node.right].bound.MinDistance(query);
+  if (leftDistance <= rightDistance)
+  {
+    SearchNode(node.left, query, k, neighbors, distances);
+    SearchNode(node.right, query, k, neighbors, distances);
+  }
+  else
+  {
+    SearchNode(node.right, query, k, neighbors, distances);
+    SearchNode(node.left, query, k, neighbors, distances);
+  }
+}
+
+std::string ExternalBinarySpaceTree::BlockFileName(const size_t blockId) const
+{
+  std::ostringstream name;
+  name << workingPrefix << ".block" << blockId;
+  return name.str();
+}
@@ -0,0 +1,198 @@
+/**
+ * @file external_binary_space_tree.hpp
+ * @author Ryan Curtin
+ *
+ * Definition of ExternalBinarySpaceTree, an out-of-core kd-tree whose
+ * construction and leaf storage are bounded by disk instead of RAM.
+ */
+#ifndef __MLPACK_CORE_TREE_BINARY_SPACE_TREE_EXTERNAL_BINARY_SPACE_TREE_HPP
+#define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_EXTERNAL_BINARY_SPACE_TREE_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/hrectbound.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A kd-tree (midpoint splits, as MeanSplit) over a dataset too large to hold
+ * in memory.  Construction streams the input file in batches (see
+ * data::StreamingLoader) and never materializes the full dataset:
+ *
+ *  - each partition pass reads a node's points from a record file on disk
+ *    and writes them, reordered, into one record file per child;
+ *  - nodes small enough to be leaves keep their record file as an on-disk
+ *    point block;
+ *  - only the top levels of the tree -- the internal nodes and one small
+ *    record per leaf block -- stay in memory.
+ *
+ * During search, leaf blocks are faulted in from disk on demand as the
+ * pruning bound requires them, and a bounded number of blocks is kept
+ * resident (least recently used blocks are evicted first).  The tree
+ * therefore answers queries with memory proportional to the number of
+ * resident blocks, not to the dataset.
+ *
+ * Temporary partition files are removed as construction proceeds, so the
+ * transient disk usage is about twice the dataset; the leaf block files live
+ * for the lifetime of the object and are removed by the destructor.
+ */
+class ExternalBinarySpaceTree
+{
+ public:
+  /**
+   * Build the tree over the points in the given file (CSV or
+   * whitespace-separated ASCII; one point per row, as files loaded with
+   * data::Load).  Construction cost is one streaming pass over the data per
+   * tree level.
+   *
+   * @param filename File holding the dataset.
+   * @param workingPrefix Prefix (directory and name stem) for the block
+   *     files; the directory must exist and be writable.
+   * @param blockSize Maximum number of points in an on-disk leaf block.
+   * @param maxResidentBlocks Maximum number of leaf blocks held in memory at
+   *     once during searches.
+   */
+  ExternalBinarySpaceTree(const std::string& filename,
+                          const std::string& workingPrefix,
+                          const size_t blockSize = 4096,
+                          const size_t maxResidentBlocks = 64);
+
+  //! Remove the on-disk leaf block files.
+  ~ExternalBinarySpaceTree();
+
+  /**
+   * Compute the k nearest neighbors of every query point, faulting leaf
+   * blocks in from disk as the traversal reaches them.  The reported indices
+   * refer to the order of the points in the input file.
+   *
+   * @param querySet Matrix of query points (one point per column).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store neighbor indices into (k rows).
+   * @param distances Matrix to store neighbor distances into (k rows).
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Return the number of points in the tree.
+  size_t NumPoints() const { return numPoints; }
+  //! Return the dimensionality of the points in the tree.
+  size_t Dimensionality() const { return dims; }
+  //! Return the number of on-disk leaf blocks.
+  size_t NumBlocks() const { return numBlocks; }
+  //! Return the number of leaf blocks faulted in from disk so far.
+  size_t BlockFaults() const { return blockFaults; }
+
+ private:
+  /**
+   * One node of the in-memory top levels.  Leaves name an on-disk block;
+   * internal nodes name their children.
+   */
+  struct Node
+  {
+    //! Bounding hyperrectangle of the points below this node.
+    bound::HRectBound<2> bound;
+    //! Index of the left child, or size_t(-1) for a leaf.
+    size_t left;
+    //! Index of the right child, or size_t(-1) for a leaf.
+    size_t right;
+    //! Index of the on-disk block, or size_t(-1) for an internal node.
+    size_t block;
+    //! Number of points below this node.
+    size_t count;
+  };
+
+  //! One leaf block resident in memory.
+  struct ResidentBlock
+  {
+    //! The points of the block (one per column).
+    arma::mat points;
+    //! The original dataset index of each point.
+    arma::Col<arma::uword> indices;
+    //! Tick of the last access, for least-recently-used eviction.
+    size_t lastUse;
+  };
+
+  /**
+   * Build the subtree over the points in the given record file, consuming
+   * (and removing or renaming) the file.  Returns the index of the built
+   * node in the nodes vector.
+   *
+   * @param recordFile Record file holding the node's points.
+   * @param count Number of points in the file.
+   */
+  size_t BuildNode(const std::string& recordFile, const size_t count);
+
+  /**
+   * Stream the given record file and compute the bounding hyperrectangle of
+   * its points.
+   */
+  void ComputeBound(const std::string& recordFile,
+                    const size_t count,
+                    bound::HRectBound<2>& bound) const;
+
+  /**
+   * Stream the given record file and write each point to the left or right
+   * output file depending on its value in the split dimension.  Returns the
+   * number of points written to the left file.
+   */
+  size_t Partition(const std::string& recordFile,
+                   const size_t count,
+                   const size_t splitDimension,
+                   const double splitVal,
+                   const std::string& leftFile,
+                   const std::string& rightFile) const;
+
+  /**
+   * Return the block with the given index, reading it from disk if it is not
+   * resident (and evicting the least recently used block if the cache is
+   * full).
+   */
+  const ResidentBlock& GetBlock(const size_t blockId);
+
+  /**
+   * Recursive depth-first search for one query point, visiting the nearer
+   * child first and pruning nodes whose bound cannot contain a better
+   * neighbor.  The candidate lists are kept sorted, best first.
+   */
+  void SearchNode(const size_t nodeIndex,
+                  const arma::vec& query,
+                  const size_t k,
+                  arma::Col<size_t>& neighbors,
+                  arma::vec& distances);
+
+  //! Return the name of the record file of the given block.
+  std::string BlockFileName(const size_t blockId) const;
+
+  //! Prefix for all files written by this tree.
+  std::string workingPrefix;
+  //! Maximum number of points in a leaf block.
+  size_t blockSize;
+  //! Maximum number of blocks resident in memory during searches.
+  size_t maxResidentBlocks;
+
+  //! Number of points in the tree.
+  size_t numPoints;
+  //! Dimensionality of the points.
+  size_t dims;
+  //! Number of on-disk leaf blocks.
+  size_t numBlocks;
+  //! Number of temporary partition files created so far (for unique names).
+  size_t tempFiles;
+
+  //! The in-memory top levels of the tree; element 0 is the root.
+  std::vector<Node> nodes;
+
+  //! The resident leaf blocks, keyed by block index.
+  std::map<size_t, ResidentBlock> residentBlocks;
+  //! Access tick counter for least-recently-used eviction.
+  size_t useTick;
+  //! Number of leaf blocks faulted in from disk.
+  size_t blockFaults;
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file greedy_single_tree_traverser.hpp
+ * @author Ryan Curtin
+ *
+ * A nested class of BinarySpaceTree which performs a defeatist (no-backtrack)
+ * traversal: at each node the query descends into the child that scores best,
+ * and the other child is visited only if it scores within a configurable
+ * overlap of the best child.  The result is approximate, but the traversal
+ * touches only a handful of leaves.
+ */
+#ifndef __MLPACK_CORE_TREE_BINARY_SPACE_TREE_GREEDY_SINGLE_TREE_TRAVERSER_HPP
+#define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_GREEDY_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
+#include "binary_space_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This traverser emulates defeatist search on a spill tree without
+ * materializing overlapping nodes.  A spill tree duplicates the points within
+ * a buffer of width tau around each splitting hyperplane into both children,
+ * so that a defeatist descent still finds the true neighbors of queries near
+ * a split boundary.  Since BinarySpaceTree stores disjoint, contiguous point
+ * ranges, the same effect is obtained at traversal time: whenever the query
+ * lies within the overlap of the split boundary -- that is, whenever the
+ * worse child scores within `overlap` of the better one -- both children are
+ * descended.
+ *
+ * With an overlap of zero this is pure defeatist search (one root-to-leaf
+ * path per query); larger overlaps trade speed for recall, and an effectively
+ * infinite overlap visits every node that scoring cannot prune outright.
+ * Unlike SingleTreeTraverser, no rescoring is performed after the first child
+ * has been visited; there is no backtracking of any kind.
+ */
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+template<typename RuleType>
+class BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
+    GreedySingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the greedy single tree traverser with the given rule set and
+   * overlap buffer width.
+   *
+   * @param rule Rule set to use during the traversal.
+   * @param overlap Width of the overlap buffer: the worse-scoring child of a
+   *     node is visited only if its score is within this value of the better
+   *     child's score (default 0, pure defeatist search).
+   */
+  GreedySingleTreeTraverser(RuleType& rule, const double overlap = 0.0);
+
+  /**
+   * Traverse the tree with the given point, descending only into children
+   * that score within the overlap of the best child.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, BinarySpaceTree& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the width of the overlap buffer.
+  double Overlap() const { return overlap; }
+  //! Modify the width of the overlap buffer.
+  double& Overlap() { return overlap; }
+
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
+
+ private:
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! Width of the overlap buffer.
+  double overlap;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
+
+  //! The current depth of the recursion, for the statistics.
+  size_t depth;
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+// Include implementation.
+#include "greedy_single_tree_traverser_impl.hpp"
+
+#endif
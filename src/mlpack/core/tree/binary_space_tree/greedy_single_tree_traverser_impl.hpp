@@ -0,0 +1,103 @@
+/**
+ * @file greedy_single_tree_traverser_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the defeatist (no-backtrack) single tree traverser for
+ * the BinarySpaceTree.
+ */
+#ifndef __MLPACK_CORE_TREE_BINARY_SPACE_TREE_GREEDY_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_GREEDY_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "greedy_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+template<typename RuleType>
+BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
+GreedySingleTreeTraverser<RuleType>::GreedySingleTreeTraverser(
+    RuleType& rule,
+    const double overlap) :
+    rule(rule),
+    overlap(overlap),
+    numPrunes(0),
+    depth(0)
+{ /* Nothing to do. */ }
+
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+template<typename RuleType>
+void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
+GreedySingleTreeTraverser<RuleType>::Traverse(
+    const size_t queryIndex,
+    BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>&
+        referenceNode)
+{
+  stats.Visit(depth);
+  ++depth;
+
+  if (referenceNode.IsLeaf())
+  {
+    rule.BaseCases(queryIndex, referenceNode.Begin(), referenceNode.End());
+    stats.BaseCase(referenceNode.Count());
+  }
+  else
+  {
+    double leftScore = rule.Score(queryIndex, *referenceNode.Left());
+    double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+    stats.Score(2);
+
+    BinarySpaceTree* best = referenceNode.Left();
+    double bestScore = leftScore;
+    double otherScore = rightScore;
+    if (rightScore < leftScore)
+    {
+      best = referenceNode.Right();
+      bestScore = rightScore;
+      otherScore = leftScore;
+    }
+
+    if (bestScore == DBL_MAX)
+    {
+      // Neither child can contain anything useful.
+      numPrunes += 2;
+      stats.Prune(2);
+    }
+    else
+    {
+      // Commit to the best-scoring child; there is no rescoring and no
+      // backtracking afterwards.
+      BinarySpaceTree* other = (best == referenceNode.Left()) ?
+          referenceNode.Right() : referenceNode.Left();
+      Traverse(queryIndex, *best);
+
+      // The query lies within the overlap buffer of the split boundary if the
+      // other child scores within `overlap` of the best one; a spill tree
+      // would have duplicated the nearby points into both children, so visit
+      // the other child too.
+      if ((otherScore != DBL_MAX) && (otherScore <= bestScore + overlap))
+      {
+        Traverse(queryIndex, *other);
+      }
+      else
+      {
+        ++numPrunes;
+        stats.Prune();
+      }
+    }
+  }
+
+  --depth;
+}
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif
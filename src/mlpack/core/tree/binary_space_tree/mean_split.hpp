@@ -109,6 +109,53 @@ class MeanSplit
                              std::vector<size_t>& oldFromNew);
 };
 
+/**
+ * A specialization of MeanSplit for sparse datasets.  The split dimension and
+ * value are found the same way, but the partitioning pass gathers the values
+ * of the split dimension into a dense working vector first, so each point
+ * pays for one search into its column's nonzeros rather than one per
+ * comparison of the partitioning loop.
+ */
+template<typename BoundType>
+class MeanSplit<BoundType, arma::sp_mat>
+{
+ public:
+  //! Split the node; see the generic SplitNode().
+  static bool SplitNode(const BoundType& bound,
+                        arma::sp_mat& data,
+                        const size_t begin,
+                        const size_t count,
+                        size_t& splitDimension,
+                        size_t& splitCol);
+
+  //! Split the node, also returning a list of changed indices; see the
+  //! generic SplitNode().
+  static bool SplitNode(const BoundType& bound,
+                        arma::sp_mat& data,
+                        const size_t begin,
+                        const size_t count,
+                        size_t& splitDimension,
+                        size_t& splitCol,
+                        std::vector<size_t>& oldFromNew);
+
+ private:
+  //! Reorder the dataset into two parts; see the generic PerformSplit().
+  static size_t PerformSplit(arma::sp_mat& data,
+                             const size_t begin,
+                             const size_t count,
+                             const size_t splitDimension,
+                             const double splitVal);
+
+  //! Reorder the dataset into two parts, also returning a list of changed
+  //! indices; see the generic PerformSplit().
+  static size_t PerformSplit(arma::sp_mat& data,
+                             const size_t begin,
+                             const size_t count,
+                             const size_t splitDimension,
+                             const double splitVal,
+                             std::vector<size_t>& oldFromNew);
+};
+
 }; // namespace tree
 }; // namespace mlpack
 
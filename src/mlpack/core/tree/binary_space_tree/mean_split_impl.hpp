@@ -189,6 +189,167 @@ size_t MeanSplit<BoundType, MatType>::
   return left;
 }
 
+template<typename BoundType>
+bool MeanSplit<BoundType, arma::sp_mat>::SplitNode(const BoundType& bound,
+                                                   arma::sp_mat& data,
+                                                   const size_t begin,
+                                                   const size_t count,
+                                                   size_t& splitDimension,
+                                                   size_t& splitCol)
+{
+  // The split dimension and value are found exactly as in the generic
+  // SplitNode(); only the partitioning differs.
+  splitDimension = data.n_rows; // Indicate invalid.
+  double maxWidth = -1;
+
+  for (size_t d = 0; d < data.n_rows; d++)
+  {
+    double width = bound[d].Width();
+
+    if (width > maxWidth)
+    {
+      maxWidth = width;
+      splitDimension = d;
+    }
+  }
+
+  if (maxWidth == 0) // All these points are the same.  We can't split.
+    return false;
+
+  double splitVal = bound[splitDimension].Mid();
+
+  splitCol = PerformSplit(data, begin, count, splitDimension, splitVal);
+
+  return true;
+}
+
+template<typename BoundType>
+bool MeanSplit<BoundType, arma::sp_mat>::SplitNode(
+    const BoundType& bound,
+    arma::sp_mat& data,
+    const size_t begin,
+    const size_t count,
+    size_t& splitDimension,
+    size_t& splitCol,
+    std::vector<size_t>& oldFromNew)
+{
+  // The split dimension and value are found exactly as in the generic
+  // SplitNode(); only the partitioning differs.
+  splitDimension = data.n_rows; // Indicate invalid.
+  double maxWidth = -1;
+
+  for (size_t d = 0; d < data.n_rows; d++)
+  {
+    double width = bound[d].Width();
+
+    if (width > maxWidth)
+    {
+      maxWidth = width;
+      splitDimension = d;
+    }
+  }
+
+  if (maxWidth == 0) // All these points are the same.  We can't split.
+    return false;
+
+  double splitVal = bound[splitDimension].Mid();
+
+  splitCol = PerformSplit(data, begin, count, splitDimension, splitVal,
+      oldFromNew);
+
+  return true;
+}
+
+template<typename BoundType>
+size_t MeanSplit<BoundType, arma::sp_mat>::
+    PerformSplit(arma::sp_mat& data,
+                 const size_t begin,
+                 const size_t count,
+                 const size_t splitDimension,
+                 const double splitVal)
+{
+  // Gather the values of the split dimension into a dense working vector, so
+  // each point pays for a single search into its column's nonzeros instead
+  // of one per comparison of the partitioning loop below.  The vector is
+  // swapped alongside the columns to stay consistent.
+  arma::vec values(count);
+  for (size_t i = 0; i < count; ++i)
+    values[i] = data(splitDimension, begin + i);
+
+  // The partitioning works as in the generic PerformSplit().
+  size_t left = begin;
+  size_t right = begin + count - 1;
+
+  while ((values[left - begin] < splitVal) && (left <= right))
+    left++;
+  while ((values[right - begin] >= splitVal) && (left <= right))
+    right--;
+
+  while (left <= right)
+  {
+    // Swap columns (and the cached split dimension values).
+    data.swap_cols(left, right);
+    const double v = values[left - begin];
+    values[left - begin] = values[right - begin];
+    values[right - begin] = v;
+
+    while ((values[left - begin] < splitVal) && (left <= right))
+      left++;
+    while ((values[right - begin] >= splitVal) && (left <= right))
+      right--;
+  }
+
+  Log::Assert(left == right + 1);
+
+  return left;
+}
+
+template<typename BoundType>
+size_t MeanSplit<BoundType, arma::sp_mat>::
+    PerformSplit(arma::sp_mat& data,
+                 const size_t begin,
+                 const size_t count,
+                 const size_t splitDimension,
+                 const double splitVal,
+                 std::vector<size_t>& oldFromNew)
+{
+  // As above: cache the split dimension's values densely, then partition.
+  arma::vec values(count);
+  for (size_t i = 0; i < count; ++i)
+    values[i] = data(splitDimension, begin + i);
+
+  size_t left = begin;
+  size_t right = begin + count - 1;
+
+  while ((values[left - begin] < splitVal) && (left <= right))
+    left++;
+  while ((values[right - begin] >= splitVal) && (left <= right))
+    right--;
+
+  while (left <= right)
+  {
+    // Swap columns (and the cached split dimension values).
+    data.swap_cols(left, right);
+    const double v = values[left - begin];
+    values[left - begin] = values[right - begin];
+    values[right - begin] = v;
+
+    // Update the indices for what we changed.
+    size_t t = oldFromNew[left];
+    oldFromNew[left] = oldFromNew[right];
+    oldFromNew[right] = t;
+
+    while ((values[left - begin] < splitVal) && (left <= right))
+      left++;
+    while ((values[right - begin] >= splitVal) && (left <= right))
+      right--;
+  }
+
+  Log::Assert(left == right + 1);
+
+  return left;
+}
+
 }; // namespace tree
 }; // namespace mlpack
 
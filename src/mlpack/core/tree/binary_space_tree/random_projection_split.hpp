@@ -0,0 +1,158 @@
+/**
+ * @file random_projection_split.hpp
+ * @author Ryan Curtin
+ *
+ * Definition of RandomProjectionSplit, a class that splits a binary space
+ * partitioning tree node along a random direction, in the style of random
+ * projection trees.
+ */
+#ifndef __MLPACK_CORE_TREE_BINARY_SPACE_TREE_RANDOM_PROJECTION_SPLIT_HPP
+#define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_RANDOM_PROJECTION_SPLIT_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * A binary space partitioning tree node is split into its left and right
+ * child along a random direction: a random Gaussian direction is drawn, every
+ * point in the node is projected onto it with a single matrix-vector product,
+ * and the points are divided at the median projection value.  Axis-aligned
+ * splits (as performed by MeanSplit) adapt to the ambient dimension of the
+ * data, while random directions adapt to its intrinsic dimension; for data
+ * lying near a low-dimensional manifold embedded in a high-dimensional space,
+ * this produces nodes whose diameters shrink much faster, and therefore
+ * better pruning per node visited.  See
+ *
+ * @code
+ * @inproceedings{dasgupta2008random,
+ *   author = {Dasgupta, Sanjoy and Freund, Yoav},
+ *   title = {Random projection trees and low dimensional manifolds},
+ *   booktitle = {Proceedings of the 40th Annual ACM Symposium on Theory of
+ *       Computing (STOC '08)},
+ *   pages = {537--546},
+ *   year = {2008}
+ * }
+ * @endcode
+ *
+ * Because the split is not axis-aligned, the split dimension reported to the
+ * tree is set to the invalid marker (the dimensionality of the data); the
+ * tree only uses it for bookkeeping, so searches are unaffected.
+ */
+template<typename BoundType, typename MatType = arma::mat>
+class RandomProjectionSplit
+{
+ public:
+  /**
+   * Split the node along a random direction at the median projection value.
+   *
+   * @param bound The bound used for this node.
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param splitDimension This will be set to the invalid marker (the
+   *    dimensionality of the data), since the split is not axis-aligned.
+   * @param splitCol The index at which the dataset is divided into two parts
+   *    after the rearrangement.
+   */
+  static bool SplitNode(const BoundType& bound,
+                        MatType& data,
+                        const size_t begin,
+                        const size_t count,
+                        size_t& splitDimension,
+                        size_t& splitCol);
+
+  /**
+   * Split the node along a random direction at the median projection value,
+   * and return a list of changed indices.
+   *
+   * @param bound The bound used for this node.
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param splitDimension This will be set to the invalid marker (the
+   *    dimensionality of the data), since the split is not axis-aligned.
+   * @param splitCol The index at which the dataset is divided into two parts
+   *    after the rearrangement.
+   * @param oldFromNew Vector which will be filled with the old positions for
+   *    each new point.
+   */
+  static bool SplitNode(const BoundType& bound,
+                        MatType& data,
+                        const size_t begin,
+                        const size_t count,
+                        size_t& splitDimension,
+                        size_t& splitCol,
+                        std::vector<size_t>& oldFromNew);
+
+ private:
+  /**
+   * Project every point of the node onto a freshly drawn random direction
+   * (one matrix-vector product over the point subset) and compute the value
+   * to split at.  Returns false if all projections are equal, in which case
+   * the node cannot be split along this direction.
+   *
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param projections Will be filled with the projection of each point of
+   *    the node (entry i corresponds to column begin + i).
+   * @param splitVal Will be set to the median projection value.
+   */
+  static bool ComputeProjections(const MatType& data,
+                                 const size_t begin,
+                                 const size_t count,
+                                 arma::vec& projections,
+                                 double& splitVal);
+
+  /**
+   * Reorder the dataset into two parts such that the points with projection
+   * value less than splitVal come first.  The projections vector is permuted
+   * alongside the data so the two stay in step.
+   *
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param projections Projection of each point of the node.
+   * @param splitVal The split is based on this value.
+   */
+  static size_t PerformSplit(MatType& data,
+                             const size_t begin,
+                             const size_t count,
+                             arma::vec& projections,
+                             const double splitVal);
+
+  /**
+   * Reorder the dataset into two parts such that the points with projection
+   * value less than splitVal come first.  Also updates the list of old
+   * positions for each new point.
+   *
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param projections Projection of each point of the node.
+   * @param splitVal The split is based on this value.
+   * @param oldFromNew Vector which will be filled with the old positions for
+   *    each new point.
+   */
+  static size_t PerformSplit(MatType& data,
+                             const size_t begin,
+                             const size_t count,
+                             arma::vec& projections,
+                             const double splitVal,
+                             std::vector<size_t>& oldFromNew);
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+// Include implementation.
+#include "random_projection_split_impl.hpp"
+
+#endif
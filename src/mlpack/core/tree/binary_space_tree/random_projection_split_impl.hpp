@@ -0,0 +1,197 @@
+/**
+ * @file random_projection_split_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of RandomProjectionSplit, which splits a binary space
+ * partition tree node along a random direction.
+ */
+#ifndef __MLPACK_CORE_TREE_BINARY_SPACE_TREE_RANDOM_PROJECTION_SPLIT_IMPL_HPP
+#define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_RANDOM_PROJECTION_SPLIT_IMPL_HPP
+
+#include "random_projection_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename BoundType, typename MatType>
+bool RandomProjectionSplit<BoundType, MatType>::SplitNode(
+    const BoundType& /* bound */,
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    size_t& splitDimension,
+    size_t& splitCol)
+{
+  splitDimension = data.n_rows; // The split is not axis-aligned.
+
+  arma::vec projections;
+  double splitVal;
+  if (!ComputeProjections(data, begin, count, projections, splitVal))
+    return false; // All the projections are the same.  We can't split.
+
+  // Perform the actual splitting.  This will order the dataset such that
+  // points whose projection is less than splitVal are on the left of
+  // splitCol, and the others are on the right.
+  splitCol = PerformSplit(data, begin, count, projections, splitVal);
+
+  return true;
+}
+
+template<typename BoundType, typename MatType>
+bool RandomProjectionSplit<BoundType, MatType>::SplitNode(
+    const BoundType& /* bound */,
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    size_t& splitDimension,
+    size_t& splitCol,
+    std::vector<size_t>& oldFromNew)
+{
+  splitDimension = data.n_rows; // The split is not axis-aligned.
+
+  arma::vec projections;
+  double splitVal;
+  if (!ComputeProjections(data, begin, count, projections, splitVal))
+    return false; // All the projections are the same.  We can't split.
+
+  // Perform the actual splitting.  This will order the dataset such that
+  // points whose projection is less than splitVal are on the left of
+  // splitCol, and the others are on the right.
+  splitCol = PerformSplit(data, begin, count, projections, splitVal,
+      oldFromNew);
+
+  return true;
+}
+
+template<typename BoundType, typename MatType>
+bool RandomProjectionSplit<BoundType, MatType>::ComputeProjections(
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::vec& projections,
+    double& splitVal)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Draw a random Gaussian direction, which is uniformly distributed on the
+  // unit sphere after normalization.
+  arma::Col<ElemType> direction =
+      arma::randn<arma::Col<ElemType> >(data.n_rows);
+  direction /= arma::norm(direction, 2);
+
+  // Project the whole point subset onto the direction with one matrix-vector
+  // product.
+  projections = arma::conv_to<arma::vec>::from(
+      arma::trans(data.cols(begin, begin + count - 1)) * direction);
+
+  const double minProj = projections.min();
+  const double maxProj = projections.max();
+
+  if (maxProj == minProj) // All these points project identically.
+    return false;
+
+  // Split at the median projection, which balances the children.  If more
+  // than half of the projections sit at the minimum, the median equals it and
+  // would leave the left child empty; fall back to the midrange, which always
+  // separates the extremes.
+  splitVal = arma::median(projections);
+  if (splitVal == minProj)
+    splitVal = 0.5 * (minProj + maxProj);
+
+  return true;
+}
+
+template<typename BoundType, typename MatType>
+size_t RandomProjectionSplit<BoundType, MatType>::PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::vec& projections,
+    const double splitVal)
+{
+  // This method modifies the input dataset.  We loop both from the left and
+  // right sides of the points contained in this node.  The points whose
+  // projection is less than splitVal should be on the left side of the
+  // matrix, and the others on the right side.  The projections vector is
+  // permuted alongside the columns so the two stay in step.
+  size_t left = begin;
+  size_t right = begin + count - 1;
+
+  // First half-iteration of the loop is out here because the termination
+  // condition is in the middle.
+  while ((left <= right) && (projections[left - begin] < splitVal))
+    left++;
+  while ((left <= right) && (projections[right - begin] >= splitVal))
+    right--;
+
+  while (left <= right)
+  {
+    // Swap columns (and their projections).
+    data.swap_cols(left, right);
+    projections.swap_rows(left - begin, right - begin);
+
+    // See how many points on the left are correct.  When they are correct,
+    // increase the left counter accordingly.  When we encounter one that
+    // isn't correct, stop.  We will switch it later.
+    while ((left <= right) && (projections[left - begin] < splitVal))
+      left++;
+
+    // Now see how many points on the right are correct.  When they are
+    // correct, decrease the right counter accordingly.  When we encounter one
+    // that isn't correct, stop.  We will switch it with the wrong point we
+    // found in the previous loop.
+    while ((left <= right) && (projections[right - begin] >= splitVal))
+      right--;
+  }
+
+  Log::Assert(left == right + 1);
+
+  return left;
+}
+
+template<typename BoundType, typename MatType>
+size_t RandomProjectionSplit<BoundType, MatType>::PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::vec& projections,
+    const double splitVal,
+    std::vector<size_t>& oldFromNew)
+{
+  // Identical to the version above, but the old position of each point is
+  // tracked as well.
+  size_t left = begin;
+  size_t right = begin + count - 1;
+
+  while ((left <= right) && (projections[left - begin] < splitVal))
+    left++;
+  while ((left <= right) && (projections[right - begin] >= splitVal))
+    right--;
+
+  while (left <= right)
+  {
+    // Swap columns (and their projections).
+    data.swap_cols(left, right);
+    projections.swap_rows(left - begin, right - begin);
+
+    // Update the indices for what we changed.
+    size_t t = oldFromNew[left];
+    oldFromNew[left] = oldFromNew[right];
+    oldFromNew[right] = t;
+
+    while ((left <= right) && (projections[left - begin] < splitVal))
+      left++;
+
+    while ((left <= right) && (projections[right - begin] >= splitVal))
+      right--;
+  }
+
+  Log::Assert(left == right + 1);
+
+  return left;
+}
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif
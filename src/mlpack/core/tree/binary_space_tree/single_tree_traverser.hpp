@@ -10,6 +10,7 @@
 #define __MLPACK_CORE_TREE_BINARY_SPACE_TREE_SINGLE_TREE_TRAVERSER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "binary_space_tree.hpp"
 
@@ -39,17 +40,52 @@ class BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
    */
   void Traverse(const size_t queryIndex, BinarySpaceTree& referenceNode);
 
+  /**
+   * Traverse the tree with a block of query points at once.  The upper levels
+   * of the tree are descended only once for the whole block: at each node,
+   * every still-active query is scored, queries that prune drop out of the
+   * block, and the recursion continues with the surviving subset.  Near the
+   * leaves the block thins out to the same per-query work the single-point
+   * overload does, but each upper node (and its bound) is touched once per
+   * block instead of once per query.
+   *
+   * The results are the same as calling Traverse(queryIndex, referenceNode)
+   * for each query in turn; only the recursion order differs.  The child to
+   * descend first is chosen once for the whole block (by the best score of
+   * any query in it) rather than per query, so a query whose preferred child
+   * differs from the block's may make slightly fewer prunes than it would
+   * alone.
+   *
+   * @param queryIndices Indices of the points in the query set making up the
+   *     block.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const std::vector<size_t>& queryIndices,
+                BinarySpaceTree& referenceNode);
+
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
+
  private:
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
+
+  //! The current depth of the recursion, for the statistics.
+  size_t depth;
 };
 
 }; // namespace tree
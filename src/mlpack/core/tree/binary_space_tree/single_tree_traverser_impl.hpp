@@ -25,7 +25,8 @@ template<typename RuleType>
 BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
 SingleTreeTraverser<RuleType>::SingleTreeTraverser(RuleType& rule) :
     rule(rule),
-    numPrunes(0)
+    numPrunes(0),
+    depth(0)
 { /* Nothing to do. */ }
 
 template<typename BoundType,
@@ -39,17 +40,29 @@ SingleTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>&
         referenceNode)
 {
-  // If we are a leaf, run the base case as necessary.
+  stats.Visit(depth);
+  ++depth;
+
+  // If we are a leaf, run the base cases as necessary.  The batched form lets
+  // the rules evaluate the whole block of leaf points at once.
   if (referenceNode.IsLeaf())
   {
-    for (size_t i = referenceNode.Begin(); i < referenceNode.End(); ++i)
-      rule.BaseCase(queryIndex, i);
+    rule.BaseCases(queryIndex, referenceNode.Begin(), referenceNode.End());
+    stats.BaseCase(referenceNode.Count());
   }
   else
   {
+    // Hint both children toward the cache before they are scored.  With the
+    // flattened node layout the left child is adjacent to this node, but the
+    // right child heads its own subtree further away, so its fetch overlaps
+    // with the scoring of the left child.
+    mlpack_prefetch(referenceNode.Left());
+    mlpack_prefetch(referenceNode.Right());
+
     // If either score is DBL_MAX, we do not recurse into that node.
     double leftScore = rule.Score(queryIndex, *referenceNode.Left());
     double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+    stats.Score(2);
 
     if (leftScore < rightScore)
     {
@@ -62,7 +75,10 @@ SingleTreeTraverser<RuleType>::Traverse(
       if (rightScore != DBL_MAX)
         Traverse(queryIndex, *referenceNode.Right()); // Recurse to the right.
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -75,13 +91,17 @@ SingleTreeTraverser<RuleType>::Traverse(
       if (leftScore != DBL_MAX)
         Traverse(queryIndex, *referenceNode.Left()); // Recurse to the left.
       else
+      {
         ++numPrunes;
+        stats.Prune();
+      }
     }
     else // leftScore is equal to rightScore.
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2; // Pruned both left and right.
+        stats.Prune(2);
       }
       else
       {
@@ -95,10 +115,123 @@ SingleTreeTraverser<RuleType>::Traverse(
         if (rightScore != DBL_MAX)
           Traverse(queryIndex, *referenceNode.Right());
         else
+        {
           ++numPrunes;
+          stats.Prune();
+        }
+      }
+    }
+  }
+
+  --depth;
+}
+
+template<typename BoundType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType>
+template<typename RuleType>
+void BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>::
+SingleTreeTraverser<RuleType>::Traverse(
+    const std::vector<size_t>& queryIndices,
+    BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>&
+        referenceNode)
+{
+  // The whole block may have pruned away.
+  if (queryIndices.empty())
+    return;
+
+  stats.Visit(depth);
+  ++depth;
+
+  if (referenceNode.IsLeaf())
+  {
+    // Run the base cases of every query in the block against this leaf; the
+    // leaf's points are hot in cache after the first query.
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+      rule.BaseCases(queryIndices[i], referenceNode.Begin(),
+          referenceNode.End());
+    stats.BaseCase(queryIndices.size() * referenceNode.Count());
+  }
+  else
+  {
+    // Hint both children toward the cache before the scoring loop; the fetch
+    // of the (distant) right child overlaps with the first scores against the
+    // (adjacent) left child.
+    mlpack_prefetch(referenceNode.Left());
+    mlpack_prefetch(referenceNode.Right());
+
+    // Score both children for every query in the block, and find the best
+    // score any query obtains for each child.
+    std::vector<double> leftScores(queryIndices.size());
+    std::vector<double> rightScores(queryIndices.size());
+    double bestLeft = DBL_MAX;
+    double bestRight = DBL_MAX;
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+    {
+      leftScores[i] = rule.Score(queryIndices[i], *referenceNode.Left());
+      rightScores[i] = rule.Score(queryIndices[i], *referenceNode.Right());
+      if (leftScores[i] < bestLeft)
+        bestLeft = leftScores[i];
+      if (rightScores[i] < bestRight)
+        bestRight = rightScores[i];
+    }
+    stats.Score(2 * queryIndices.size());
+
+    // Descend into the child that looks best for the block first.  Each query
+    // rescores the other child (against any bounds tightened by the first
+    // descent) before it is carried into it.
+    BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>* first =
+        referenceNode.Left();
+    BinarySpaceTree<BoundType, StatisticType, MatType, SplitType>* second =
+        referenceNode.Right();
+    std::vector<double>* firstScores = &leftScores;
+    std::vector<double>* secondScores = &rightScores;
+    if (bestRight < bestLeft)
+    {
+      std::swap(first, second);
+      std::swap(firstScores, secondScores);
+    }
+
+    // Collect the queries that are not pruned for the first child.
+    std::vector<size_t> subset;
+    subset.reserve(queryIndices.size());
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+    {
+      if ((*firstScores)[i] != DBL_MAX)
+      {
+        subset.push_back(queryIndices[i]);
+      }
+      else
+      {
+        ++numPrunes;
+        stats.Prune();
       }
     }
+
+    Traverse(subset, *first);
+
+    // Now rescore the second child for each query, and collect the survivors.
+    subset.clear();
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+    {
+      if (((*secondScores)[i] != DBL_MAX) &&
+          (rule.Rescore(queryIndices[i], *second, (*secondScores)[i]) !=
+              DBL_MAX))
+      {
+        subset.push_back(queryIndices[i]);
+      }
+      else
+      {
+        ++numPrunes;
+        stats.Prune();
+      }
+    }
+
+    Traverse(subset, *second);
   }
+
+  --depth;
 }
 
 }; // namespace tree
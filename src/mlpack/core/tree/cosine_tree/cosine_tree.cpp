@@ -104,27 +104,37 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
+    // Gather the current basis into the preallocated workspace once, so that
+    // all of the projections in this iteration are matrix-vector products.
+    size_t numBasisVectors;
+    GatherBasis(treeQueue, numBasisVectors);
+
     // Calculate basis vectors of left and right children.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
+    ModifiedGramSchmidt(numBasisVectors, currentLeft->Centroid(),
+        lBasisVector);
+    ModifiedGramSchmidt(numBasisVectors, currentRight->Centroid(),
+        rBasisVector, &lBasisVector);
 
     // Add basis vectors to their respective nodes.
     currentLeft->BasisVector(lBasisVector);
     currentRight->BasisVector(rBasisVector);
 
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, numBasisVectors, &lBasisVector,
+        &rBasisVector);
+    MonteCarloError(currentRight, numBasisVectors, &lBasisVector,
+        &rBasisVector);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
-    // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    // Calculate Monte Carlo error estimate for the root node; the queue has
+    // changed, so the basis is gathered again.
+    GatherBasis(treeQueue, numBasisVectors);
+    monteCarloError = MonteCarloError(&root, numBasisVectors);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -139,26 +149,59 @@ CosineTree::~CosineTree()
     delete right;
 }
 
+void CosineTree::GatherBasis(CosineNodeQueue& treeQueue,
+                             size_t& numBasisVectors)
+{
+  numBasisVectors = treeQueue.size();
+
+  // Grow the workspace geometrically if needed, so repeated gathers do not
+  // reallocate.
+  if(basisWorkspace.n_cols < numBasisVectors)
+    basisWorkspace.set_size(dataset.n_rows,
+        std::max((size_t) (2 * basisWorkspace.n_cols), numBasisVectors));
+
+  // Variables for iterating through the priority queue.
+  CosineTree *currentNode;
+  CosineNodeQueue::const_iterator i = treeQueue.begin();
+
+  // Transfer basis vectors from the queue to the workspace.
+  size_t j = 0;
+  for(; i != treeQueue.end(); i++, j++)
+  {
+    currentNode = *i;
+    basisWorkspace.col(j) = currentNode->BasisVector();
+  }
+}
+
 void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& centroid,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
+{
+  // Gather the basis from the queue and use the workspace version.
+  size_t numBasisVectors;
+  GatherBasis(treeQueue, numBasisVectors);
+  ModifiedGramSchmidt(numBasisVectors, centroid, newBasisVector,
+      addBasisVector);
+}
+
+void CosineTree::ModifiedGramSchmidt(const size_t numBasisVectors,
+                                     arma::vec& centroid,
+                                     arma::vec& newBasisVector,
+                                     arma::vec* addBasisVector)
 {
   // Set new basis vector to centroid.
   newBasisVector = centroid;
 
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for(; i != treeQueue.end(); i++)
+  // Remove the projections onto the current basis from the centroid.  The
+  // gathered basis is orthonormal, so all of the projections can be computed
+  // against the centroid and removed at once as two matrix-vector products.
+  if(numBasisVectors > 0)
   {
-    currentNode = *i;
-
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
+    arma::vec projections = arma::trans(
+        basisWorkspace.cols(0, numBasisVectors - 1)) * centroid;
+    newBasisVector -= basisWorkspace.cols(0, numBasisVectors - 1) *
+        projections;
   }
 
   // If additional basis vector is passed, take it into account.
@@ -177,6 +220,18 @@ double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  // Gather the basis from the queue and use the workspace version.
+  size_t numBasisVectors;
+  GatherBasis(treeQueue, numBasisVectors);
+  return MonteCarloError(node, numBasisVectors, addBasisVector1,
+      addBasisVector2);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node,
+                                   const size_t numBasisVectors,
+                                   arma::vec* addBasisVector1,
+                                   arma::vec* addBasisVector2)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -186,53 +241,38 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
+  // Get a reference to the original dataset.
+  const arma::mat& dataset = node->GetDataset();
 
   // Initialize weighted projection magnitudes as zeros.
   arma::vec weightedMagnitudes;
   weightedMagnitudes.zeros(numSamples);
 
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if(addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
-  else
-    projectionSize = treeQueue.size();
-
   // For each sample, calculate the weighted projection onto the current basis.
   for(size_t i = 0; i < numSamples; i++)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for(; j != treeQueue.end(); j++, k++)
+    // Compute the projection of the sampled vector onto the existing subspace
+    // as a single matrix-vector product against the gathered basis.
+    double frobProjectionSquared = 0.0;
+    if(numBasisVectors > 0)
     {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
+      arma::vec projection = arma::trans(
+          basisWorkspace.cols(0, numBasisVectors - 1)) *
+          dataset.col(sampledIndices[i]);
+      frobProjectionSquared += arma::dot(projection, projection);
     }
+
     // If two additional vectors are passed, take their projections.
     if(addBasisVector1 && addBasisVector2)
     {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
+      const double projection1 = arma::dot(dataset.col(sampledIndices[i]),
+                                           *addBasisVector1);
+      const double projection2 = arma::dot(dataset.col(sampledIndices[i]),
+                                           *addBasisVector2);
+      frobProjectionSquared += projection1 * projection1 +
+          projection2 * projection2;
     }
 
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
     // Calculate the weighted projection magnitude.
     weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
   }
@@ -307,9 +347,22 @@ void CosineTree::CosineNodeSplit()
     }
   }
 
-  // Split the node into left and right children.
+  // Split the node into left and right children.  The children do their own
+  // centroid, norm and sampling work, which is independent, so they can be
+  // constructed in parallel.
+#ifdef _OPENMP
+  #pragma omp parallel sections
+  {
+    #pragma omp section
+    left = new CosineTree(*this, leftIndices);
+
+    #pragma omp section
+    right = new CosineTree(*this, rightIndices);
+  }
+#else
   left = new CosineTree(*this, leftIndices);
   right = new CosineTree(*this, rightIndices);
+#endif
 }
 
 void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
@@ -332,8 +385,9 @@ void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
 
   for(size_t i = 0; i < numSamples; i++)
   {
-    // Generate a random value for sampling.
-    double randValue = arma::randu();
+    // Generate a random value for sampling.  math::Random() is safe to call
+    // from inside parallel regions (unlike the global Armadillo generator).
+    double randValue = math::Random();
     size_t start = 0, end = numColumns, searchIndex;
 
     // Sample from the distribution and store corresponding probability.
@@ -361,8 +415,9 @@ size_t CosineTree::ColumnSampleLS()
     cDistribution(i+1) = cDistribution(i) + l2NormsSquared(i) / frobNormSquared;
   }
 
-  // Generate a random value for sampling.
-  double randValue = arma::randu();
+  // Generate a random value for sampling.  math::Random() is safe to call
+  // from inside parallel regions (unlike the global Armadillo generator).
+  double randValue = math::Random();
   size_t start = 0, end = numColumns;
 
   // Sample from the distribution.
@@ -402,7 +457,17 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for(size_t i = 0; i < numColumns; i++)
+  // The squared norms of the columns are already cached, so each cosine only
+  // needs one dot product against the split column, instead of the two norm
+  // recomputations norm_dot() would do per pair.  The columns are independent
+  // of each other, so the dot products can be computed in parallel.
+  const size_t splitIndex = indices[splitPointIndex];
+  const double splitNormSquared = l2NormsSquared(splitPointIndex);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for(long i = 0; i < (long) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
@@ -412,8 +477,9 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
     }
     else
     {
-      cosines(i) = arma::norm_dot(dataset.col(indices[splitPointIndex]),
-                                  dataset.col(indices[i]));
+      cosines(i) = arma::dot(dataset.col(splitIndex),
+                             dataset.col(indices[i])) /
+          std::sqrt(splitNormSquared * l2NormsSquared(i));
     }
   }
 }
@@ -200,8 +200,45 @@ class CosineTree
   size_t SplitPointIndex() const { return indices[splitPointIndex]; }
 
  private:
+  /**
+   * Gather the basis vectors of the nodes in the priority queue into the
+   * first columns of the preallocated basis workspace, growing the workspace
+   * geometrically if required.  Gathering the basis once lets the projection
+   * loops in ModifiedGramSchmidt() and MonteCarloError() run as matrix-vector
+   * products against the workspace instead of one dot product (and one fresh
+   * temporary) per basis vector.
+   *
+   * @param treeQueue Priority queue of cosine nodes.
+   * @param numBasisVectors Set to the number of gathered basis vectors.
+   */
+  void GatherBasis(CosineNodeQueue& treeQueue, size_t& numBasisVectors);
+
+  /**
+   * Workspace version of ModifiedGramSchmidt(); the basis is read from the
+   * first 'numBasisVectors' columns of the basis workspace (see
+   * GatherBasis()), and the projections are computed as two matrix-vector
+   * products.  Because the gathered basis is orthonormal, removing all of the
+   * projections at once is equivalent to removing them one at a time.
+   */
+  void ModifiedGramSchmidt(const size_t numBasisVectors,
+                           arma::vec& centroid,
+                           arma::vec& newBasisVector,
+                           arma::vec* addBasisVector = NULL);
+
+  /**
+   * Workspace version of MonteCarloError(); the basis is read from the first
+   * 'numBasisVectors' columns of the basis workspace (see GatherBasis()), so
+   * each sampled column is projected with a single matrix-vector product.
+   */
+  double MonteCarloError(CosineTree* node,
+                         const size_t numBasisVectors,
+                         arma::vec* addBasisVector1 = NULL,
+                         arma::vec* addBasisVector2 = NULL);
+
   //! Matrix for which cosine tree is constructed.
   const arma::mat& dataset;
+  //! Preallocated workspace holding the gathered basis vectors.
+  arma::mat basisWorkspace;
   //! Error tolerance fraction for calculated subspace.
   double epsilon;
   //! Cumulative probability for Monte Carlo error lower bound.
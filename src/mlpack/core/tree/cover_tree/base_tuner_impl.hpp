@@ -0,0 +1,92 @@
+/**
+ * @file base_tuner_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the sampling-based cover tree base tuner.
+ */
+#ifndef __MLPACK_CORE_TREE_COVER_TREE_BASE_TUNER_IMPL_HPP
+#define __MLPACK_CORE_TREE_COVER_TREE_BASE_TUNER_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "base_tuner.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType>
+BaseTuner<MetricType>::BaseTuner(const arma::mat& dataset,
+                                 MetricType& metric,
+                                 const size_t maxSamples) :
+    expansionConstant(1.0),
+    base(2.0),
+    samples(std::min(maxSamples, (size_t) dataset.n_cols))
+{
+  // A dataset with fewer than two points has no meaningful expansion constant;
+  // leave the defaults in place.
+  if (dataset.n_cols < 2)
+    return;
+
+  std::vector<double> distances(dataset.n_cols);
+  for (size_t sample = 0; sample < samples; ++sample)
+  {
+    // Sample a center and compute the distance to every point.  Sampling with
+    // replacement is fine; the estimate is a maximum over samples, so a
+    // repeated center changes nothing.
+    const size_t center = (size_t) math::RandInt(dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      distances[i] = metric.Evaluate(dataset.unsafe_col(center),
+          dataset.unsafe_col(i));
+    std::sort(distances.begin(), distances.end());
+
+    // Measure |B(center, 2r)| / |B(center, r)| at a few radii, taken as
+    // quantiles of the sorted distances so each ball holds enough points for
+    // the ratio to be meaningful.
+    for (size_t denom = 8; denom >= 2; denom /= 2)
+    {
+      const double radius = distances[dataset.n_cols / denom];
+      if (radius == 0.0)
+        continue; // Duplicate points; the ratio is not informative.
+
+      const size_t inner = std::upper_bound(distances.begin(),
+          distances.end(), radius) - distances.begin();
+      const size_t outer = std::upper_bound(distances.begin(),
+          distances.end(), 2 * radius) - distances.begin();
+
+      const double ratio = (double) outer / (double) inner;
+      if (ratio > expansionConstant)
+        expansionConstant = ratio;
+    }
+  }
+
+  // Choose the base from the estimate.  Low expansion constants (expansion
+  // constant 2 corresponds to data on a line) keep the default base of 2.0;
+  // as the expansion constant grows the base shrinks towards 1.3, which
+  // benchmarks well for high intrinsic dimensionality.
+  base = std::min(2.0, std::max(1.3, 1.0 + 2.0 / expansionConstant));
+
+  Log::Info << "BaseTuner: estimated expansion constant " << expansionConstant
+      << " from " << samples << " samples; selected base " << base << "."
+      << std::endl;
+}
+
+template<typename MetricType>
+double BaseTuner<MetricType>::ChooseBase(const arma::mat& dataset)
+{
+  MetricType metric;
+  return ChooseBase(dataset, metric);
+}
+
+template<typename MetricType>
+double BaseTuner<MetricType>::ChooseBase(const arma::mat& dataset,
+                                         MetricType& metric)
+{
+  BaseTuner<MetricType> tuner(dataset, metric);
+  return tuner.Base();
+}
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif
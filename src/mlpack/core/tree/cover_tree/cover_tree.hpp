@@ -10,6 +10,9 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include "first_point_is_root.hpp"
+#include "middle_point_is_root.hpp"
+#include "base_tuner.hpp"
+#include "../node_arena.hpp"
 #include "../statistic.hpp"
 
 namespace mlpack {
@@ -75,7 +78,8 @@ namespace tree {
  * can be used with MetricType (this class defaults to the L2-squared metric).
  * The root node's point can be chosen with the RootPointPolicy; by default, the
  * FirstPointIsRoot policy is used, meaning the first point in the dataset is
- * used.  The StatisticType policy allows you to define statistics which can be
+ * used; MiddlePointIsRoot chooses an approximately central point instead.
+ * The StatisticType policy allows you to define statistics which can be
  * gathered during the creation of the tree.
  *
  * @tparam MetricType Metric type to use during tree construction.
@@ -95,6 +99,9 @@ class CoverTree
    * The dataset will not be modified during the building procedure (unlike
    * BinarySpaceTree).
    *
+   * If the given base is 1.0 or less, a base is chosen automatically by
+   * estimating the expansion constant of the dataset (see BaseTuner).
+   *
    * The last argument will be removed in mlpack 1.1.0 (see #274 and #273).
    *
    * @param dataset Reference to the dataset to build a tree on.
@@ -109,6 +116,9 @@ class CoverTree
    * metric.  Optionally, set the base.  The dataset will not be modified during
    * the building procedure (unlike BinarySpaceTree).
    *
+   * If the given base is 1.0 or less, a base is chosen automatically by
+   * estimating the expansion constant of the dataset (see BaseTuner).
+   *
    * @param dataset Reference to the dataset to build a tree on.
    * @param metric Instantiated metric to use during tree building.
    * @param base Base to use during tree building (default 2.0).
@@ -367,6 +377,11 @@ class CoverTree
   //! The metric used for this tree.
   MetricType* metric;
 
+  //! The arena that this tree's nodes are allocated from; only the root node
+  //! deletes the arena.  NULL if the children of this node are allocated
+  //! individually (as is done for copied or manually-assembled trees).
+  NodeArena<CoverTree>* arena;
+
   /**
    * Create the children for this node.
    */
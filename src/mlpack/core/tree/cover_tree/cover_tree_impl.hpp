@@ -13,6 +13,12 @@
 #include <mlpack/core/util/string_util.hpp>
 #include <string>
 
+#ifdef _OPENMP
+  //! Minimum point set size before distance computations during tree building
+  //! are split across threads; smaller sets are not worth the fork overhead.
+  #define COVER_TREE_PARALLEL_DISTANCE_CUTOFF 1000
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -25,13 +31,14 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
     dataset(dataset),
     point(RootPointPolicy::ChooseRoot(dataset)),
     scale(INT_MAX),
-    base(base),
+    base(base > 1.0 ? base : BaseTuner<MetricType>::ChooseBase(dataset)),
     numDescendants(0),
     parent(NULL),
     parentDistance(0),
     furthestDescendantDistance(0),
     localMetric(metric == NULL),
     metric(metric),
+    arena(new NodeArena<CoverTree>()),
     distanceComps(0)
 {
   // If we need to create a metric, do that.  We'll just do it on the heap.
@@ -84,7 +91,10 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
     scale = old->Scale();
 
     // Now delete it.
-    delete old;
+    if (arena != NULL)
+      arena->Destroy(old);
+    else
+      delete old;
   }
 
   // Use the furthest descendant distance to determine the scale of the root
@@ -106,13 +116,15 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
     dataset(dataset),
     point(RootPointPolicy::ChooseRoot(dataset)),
     scale(INT_MAX),
-    base(base),
+    base(base > 1.0 ?
+        base : BaseTuner<MetricType>::ChooseBase(dataset, metric)),
     numDescendants(0),
     parent(NULL),
     parentDistance(0),
     furthestDescendantDistance(0),
     localMetric(false),
     metric(&metric),
+    arena(new NodeArena<CoverTree>()),
     distanceComps(0)
 {
   // If there is only one point in the dataset, uh, we're done.
@@ -161,7 +173,10 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
     scale = old->Scale();
 
     // Now delete it.
-    delete old;
+    if (arena != NULL)
+      arena->Destroy(old);
+    else
+      delete old;
   }
 
   // Use the furthest descendant distance to determine the scale of the root
@@ -199,6 +214,7 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
     furthestDescendantDistance(0),
     localMetric(false),
     metric(&metric),
+    arena((parent == NULL) ? new NodeArena<CoverTree>() : parent->arena),
     distanceComps(0)
 {
   // If the size of the near set is 0, this is a leaf.
@@ -238,6 +254,7 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
     furthestDescendantDistance(furthestDescendantDistance),
     localMetric(metric == NULL),
     metric(metric),
+    arena(NULL), // Children are added manually and allocated individually.
     distanceComps(0)
 {
   // If necessary, create a local metric.
@@ -262,6 +279,7 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     localMetric(false),
     metric(other.metric),
+    arena(NULL), // Copied children are allocated individually.
     distanceComps(0)
 {
   // Copy each child by hand.
@@ -275,9 +293,18 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CoverTree(
 template<typename MetricType, typename RootPointPolicy, typename StatisticType>
 CoverTree<MetricType, RootPointPolicy, StatisticType>::~CoverTree()
 {
-  // Delete each child.
+  // Delete each child.  Children that live in the arena only have their
+  // destructors run here; the root frees all of the arena's memory at once.
   for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
+  {
+    if (arena != NULL)
+      arena->Destroy(children[i]);
+    else
+      delete children[i];
+  }
+
+  if (parent == NULL && arena != NULL)
+    delete arena;
 
   // Delete the local metric, if necessary.
   if (localMetric)
@@ -470,7 +497,8 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CreateChildren(
     // Make the self child at the lowest possible level.
     // This should not modify farSetSize or usedSetSize.
     size_t tempSize = 0;
-    children.push_back(new CoverTree(dataset, base, point, INT_MIN, this, 0,
+    children.push_back(new (arena->Allocate()) CoverTree(dataset, base,
+        point, INT_MIN, this, 0,
         indices, distances, 0, tempSize, usedSetSize, *metric));
     distanceComps += children.back()->DistanceComps();
 
@@ -478,7 +506,8 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CreateChildren(
     for (size_t i = 0; i < nearSetSize; ++i)
     {
       // farSetSize and usedSetSize will not be modified.
-      children.push_back(new CoverTree(dataset, base, indices[i],
+      children.push_back(new (arena->Allocate()) CoverTree(dataset, base,
+          indices[i],
           INT_MIN, this, distances[i], indices, distances, 0, tempSize,
           usedSetSize, *metric));
       distanceComps += children.back()->DistanceComps();
@@ -510,7 +539,8 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CreateChildren(
   // Build the self child (recursively).
   size_t childFarSetSize = nearSetSize - childNearSetSize;
   size_t childUsedSetSize = 0;
-  children.push_back(new CoverTree(dataset, base, point, nextScale, this, 0,
+  children.push_back(new (arena->Allocate()) CoverTree(dataset, base,
+      point, nextScale, this, 0,
       indices, distances, childNearSetSize, childFarSetSize, childUsedSetSize,
       *metric));
   // Don't double-count the self-child (so, subtract one).
@@ -543,6 +573,13 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CreateChildren(
   // computation later, we'll create an array holding the points in the near
   // set, and then after each run we'll check which of those (if any) were used
   // and we will remove them.  ...if that's faster.  I think it is.
+
+  // Preallocate the child index and distance buffers at their largest
+  // possible size; the sets only shrink as points are used, so a single
+  // allocation serves every child instead of one allocation per child.
+  arma::Col<size_t> childIndices(nearSetSize + farSetSize);
+  arma::vec childDistances(nearSetSize + farSetSize);
+
   while (nearSetSize > 0)
   {
     size_t newPointIndex = nearSetSize - 1;
@@ -568,7 +605,8 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CreateChildren(
     if ((nearSetSize == 1) && (farSetSize == 0))
     {
       size_t childNearSetSize = 0;
-      children.push_back(new CoverTree(dataset, base, indices[0], nextScale,
+      children.push_back(new (arena->Allocate()) CoverTree(dataset, base,
+        indices[0], nextScale,
           this, distances[0], indices, distances, childNearSetSize, farSetSize,
           usedSetSize, *metric));
       distanceComps += children.back()->DistanceComps();
@@ -583,12 +621,10 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CreateChildren(
       break;
     }
 
-    // Create the near and far set indices and distance vectors.  We don't fill
-    // in the self-point, yet.
-    arma::Col<size_t> childIndices(nearSetSize + farSetSize);
+    // Fill the near and far set indices and distance vectors, reusing the
+    // preallocated buffers.  We don't fill in the self-point, yet.
     childIndices.rows(0, (nearSetSize + farSetSize - 2)) = indices.rows(1,
         nearSetSize + farSetSize - 1);
-    arma::vec childDistances(nearSetSize + farSetSize);
 
     // Build distances for the child.
     ComputeDistances(indices[0], childIndices, childDistances, nearSetSize
@@ -610,7 +646,8 @@ CoverTree<MetricType, RootPointPolicy, StatisticType>::CreateChildren(
 
     // Build this child (recursively).
     childUsedSetSize = 1; // Mark self point as used.
-    children.push_back(new CoverTree(dataset, base, indices[0], nextScale,
+    children.push_back(new (arena->Allocate()) CoverTree(dataset, base,
+        indices[0], nextScale,
         this, distances[0], childIndices, childDistances, childNearSetSize,
         childFarSetSize, childUsedSetSize, *metric));
     numDescendants += children.back()->NumDescendants();
@@ -697,8 +734,22 @@ void CoverTree<MetricType, RootPointPolicy, StatisticType>::ComputeDistances(
     const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  Each distance is independent, so for large point sets (near
+  // the root, this is nearly the whole dataset) the loop is split across
+  // threads.
   distanceComps += pointSetSize;
+#ifdef _OPENMP
+  if (pointSetSize >= COVER_TREE_PARALLEL_DISTANCE_CUTOFF)
+  {
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long) pointSetSize; ++i)
+    {
+      distances[i] = metric->Evaluate(dataset.unsafe_col(pointIndex),
+          dataset.unsafe_col(indices[i]));
+    }
+    return;
+  }
+#endif
   for (size_t i = 0; i < pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset.unsafe_col(pointIndex),
@@ -971,7 +1022,10 @@ inline void CoverTree<MetricType, RootPointPolicy, StatisticType>::
     old->Children().erase(old->Children().begin() + old->Children().size() - 1);
 
     // Now delete it.
-    delete old;
+    if (arena != NULL)
+      arena->Destroy(old);
+    else
+      delete old;
   }
 }
 
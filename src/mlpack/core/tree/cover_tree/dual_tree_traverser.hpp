@@ -8,6 +8,8 @@
 #define __MLPACK_CORE_TREE_COVER_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+#include <deque>
 #include <queue>
 
 namespace mlpack {
@@ -36,11 +38,26 @@ class CoverTree<MetricType, RootPointPolicy, StatisticType>::DualTreeTraverser
   //! Modify the number of pruned nodes.
   size_t& NumPrunes() { return numPrunes; }
 
-  ///// These are all fake because this is a patch for kd-trees only and I still
-  ///// want it to compile!
-  size_t NumVisited() const { return 0; }
-  size_t NumScores() const { return 0; }
-  size_t NumBaseCases() const { return 0; }
+  //! Get the number of visited query nodes.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited query nodes.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
 
  private:
   //! The instantiated rule set for pruning branches.
@@ -49,6 +66,21 @@ class CoverTree<MetricType, RootPointPolicy, StatisticType>::DualTreeTraverser
   //! The number of pruned nodes.
   size_t numPrunes;
 
+  //! The number of visited query nodes.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
+
+  //! The current depth of the query recursion, for the statistics.
+  size_t depth;
+
   //! Struct used for traversal.
   struct DualCoverTreeMapEntry
   {
@@ -61,7 +93,7 @@ class CoverTree<MetricType, RootPointPolicy, StatisticType>::DualTreeTraverser
     //! The traversal info associated with the call to Score() for this entry.
     typename RuleType::TraversalInfoType traversalInfo;
 
-    //! Comparison operator, for sorting within the map.
+    //! Comparison operator, for sorting within a scale.
     bool operator<(const DualCoverTreeMapEntry& other) const
     {
       if (score == other.score)
@@ -71,23 +103,110 @@ class CoverTree<MetricType, RootPointPolicy, StatisticType>::DualTreeTraverser
     }
   };
 
+  /**
+   * The scale-indexed frontier of reference entries.  The entries at scale s
+   * live in flat vector slot (maxScale - s), and the leaf entries (scale
+   * INT_MIN) live in a dedicated slot.  This replaces a std::map keyed on
+   * scale: the map's per-node allocations and pointer chasing showed up in
+   * FastMKS profiles next to the kernel evaluations themselves, while the
+   * slot lookup here is just an index computation.
+   *
+   * The slots are held in a deque so that creating a slot for a new, smaller
+   * scale never moves the existing slots; references to a slot's entries
+   * therefore stay valid while entries are inserted at other scales, just as
+   * they did with the map.
+   */
+  class ReferenceFrontier
+  {
+   public:
+    //! Create an empty frontier for scales no greater than maxScale.
+    explicit ReferenceFrontier(const int maxScale) : maxScale(maxScale) { }
+
+    //! Return true if no entries remain in the frontier.
+    bool Empty() const
+    {
+      if (!leafEntries.empty())
+        return false;
+      for (size_t i = 0; i < slots.size(); ++i)
+        if (!slots[i].empty())
+          return false;
+      return true;
+    }
+
+    //! Return the highest scale that has entries, or INT_MIN if only leaf
+    //! entries (or none at all) remain.
+    int MaxScale() const
+    {
+      for (size_t i = 0; i < slots.size(); ++i)
+        if (!slots[i].empty())
+          return maxScale - (int) i;
+      return INT_MIN;
+    }
+
+    //! Access the entries at the given scale, creating an empty slot for the
+    //! scale if none exists yet.
+    std::vector<DualCoverTreeMapEntry>& Scale(const int scale)
+    {
+      if (scale == INT_MIN)
+        return leafEntries;
+
+      const size_t slot = (size_t) (maxScale - scale);
+      while (slot >= slots.size())
+        slots.push_back(std::vector<DualCoverTreeMapEntry>());
+      return slots[slot];
+    }
+
+    //! Access the leaf (scale INT_MIN) entries.
+    std::vector<DualCoverTreeMapEntry>& Leaves() { return leafEntries; }
+
+    //! Add an entry at the scale of its reference node.
+    void Insert(const DualCoverTreeMapEntry& entry)
+    {
+      Scale(entry.referenceNode->Scale()).push_back(entry);
+    }
+
+    //! Return the highest scale this frontier was created for.
+    int BoundingScale() const { return maxScale; }
+
+    //! Return the number of finite-scale slots that have been created.
+    size_t NumScaleSlots() const { return slots.size(); }
+
+   private:
+    //! slots[i] holds the entries at scale (maxScale - i).
+    std::deque<std::vector<DualCoverTreeMapEntry> > slots;
+    //! The entries at scale INT_MIN.
+    std::vector<DualCoverTreeMapEntry> leafEntries;
+    //! The scale of slot 0.
+    int maxScale;
+  };
+
   /**
    * Helper function for traversal of the two trees.
    */
-  void Traverse(CoverTree& queryNode,
-                std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                    referenceMap);
+  void Traverse(CoverTree& queryNode, ReferenceFrontier& referenceFrontier);
 
-  //! Prepare map for recursion.
+  //! Prepare a pruned copy of the frontier for recursion into a query child.
   void PruneMap(CoverTree& queryNode,
-                std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                    referenceMap,
-                std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                    childMap);
+                ReferenceFrontier& referenceFrontier,
+                ReferenceFrontier& childFrontier);
+
+  //! Prune the frontier in place for recursion into the self-child, which is
+  //! its last user and so does not need a copy.
+  void PruneMapInPlace(CoverTree& queryNode,
+                       ReferenceFrontier& referenceFrontier);
+
+  //! Score the entries of one scale against a query child, compacting the
+  //! survivors (with updated scores and traversal info) into newScaleVector.
+  void PruneScale(CoverTree& queryNode,
+                  std::vector<DualCoverTreeMapEntry>& scaleVector,
+                  std::vector<DualCoverTreeMapEntry>& newScaleVector);
+
+  //! Like PruneScale(), but compact the survivors in place.
+  void PruneScaleInPlace(CoverTree& queryNode,
+                         std::vector<DualCoverTreeMapEntry>& scaleVector);
 
   void ReferenceRecursion(CoverTree& queryNode,
-                          std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                              referenceMap);
+                          ReferenceFrontier& referenceFrontier);
 };
 
 }; // namespace tree
@@ -18,7 +18,11 @@ template<typename RuleType>
 CoverTree<MetricType, RootPointPolicy, StatisticType>::
 DualTreeTraverser<RuleType>::DualTreeTraverser(RuleType& rule) :
     rule(rule),
-    numPrunes(0)
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0),
+    depth(0)
 { /* Nothing to do. */ }
 
 template<typename MetricType, typename RootPointPolicy, typename StatisticType>
@@ -28,8 +32,10 @@ DualTreeTraverser<RuleType>::Traverse(
     CoverTree<MetricType, RootPointPolicy, StatisticType>& queryNode,
     CoverTree<MetricType, RootPointPolicy, StatisticType>& referenceNode)
 {
-  // Start by creating a map and adding the reference root node to it.
-  std::map<int, std::vector<DualCoverTreeMapEntry> > refMap;
+  // Start by creating a frontier and adding the reference root node to it.
+  // The root has the highest scale in the reference tree, so it bounds every
+  // scale the frontier will ever hold.
+  ReferenceFrontier refFrontier(referenceNode.Scale());
 
   DualCoverTreeMapEntry rootRefEntry;
 
@@ -37,13 +43,17 @@ DualTreeTraverser<RuleType>::Traverse(
 
   // Perform the evaluation between the roots of either tree.
   rootRefEntry.score = rule.Score(queryNode, referenceNode);
+  ++numScores;
+  stats.Score();
   rootRefEntry.baseCase = rule.BaseCase(queryNode.Point(),
       referenceNode.Point());
+  ++numBaseCases;
+  stats.BaseCase();
   rootRefEntry.traversalInfo = rule.TraversalInfo();
 
-  refMap[referenceNode.Scale()].push_back(rootRefEntry);
+  refFrontier.Insert(rootRefEntry);
 
-  Traverse(queryNode, refMap);
+  Traverse(queryNode, refFrontier);
 }
 
 template<typename MetricType, typename RootPointPolicy, typename StatisticType>
@@ -51,38 +61,45 @@ template<typename RuleType>
 void CoverTree<MetricType, RootPointPolicy, StatisticType>::
 DualTreeTraverser<RuleType>::Traverse(
     CoverTree<MetricType, RootPointPolicy, StatisticType>& queryNode,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& referenceMap)
+    ReferenceFrontier& referenceFrontier)
 {
-  if (referenceMap.size() == 0)
+  ++numVisited;
+  stats.Visit(depth);
+
+  if (referenceFrontier.Empty())
     return; // Nothing to do!
 
   // First recurse down the reference nodes as necessary.
-  ReferenceRecursion(queryNode, referenceMap);
+  ReferenceRecursion(queryNode, referenceFrontier);
 
-  // Did the map get emptied?
-  if (referenceMap.size() == 0)
+  // Did the frontier get emptied?
+  if (referenceFrontier.Empty())
     return; // Nothing to do!
 
   // Now, reduce the scale of the query node by recursing.  But we can't recurse
   // if the query node is a leaf node.
   if ((queryNode.Scale() != INT_MIN) &&
-      (queryNode.Scale() >= (*referenceMap.rbegin()).first))
+      (queryNode.Scale() >= referenceFrontier.MaxScale()))
   {
     // Recurse into the non-self-children first.  The recursion order cannot
     // affect the runtime of the algorithm, because each query child recursion's
     // results are separate and independent.  I don't think this is true in
     // every case, and we may have to modify this section to consider scores in
     // the future.
+    ++depth;
     for (size_t i = 1; i < queryNode.NumChildren(); ++i)
     {
-      // We need a copy of the map for this child.
-      std::map<int, std::vector<DualCoverTreeMapEntry> > childMap;
-      PruneMap(queryNode.Child(i), referenceMap, childMap);
-      Traverse(queryNode.Child(i), childMap);
+      // We need a pruned copy of the frontier for this child.
+      ReferenceFrontier childFrontier(referenceFrontier.BoundingScale());
+      PruneMap(queryNode.Child(i), referenceFrontier, childFrontier);
+      Traverse(queryNode.Child(i), childFrontier);
     }
-    std::map<int, std::vector<DualCoverTreeMapEntry> > selfChildMap;
-    PruneMap(queryNode.Child(0), referenceMap, selfChildMap);
-    Traverse(queryNode.Child(0), selfChildMap);
+
+    // The self-child is the last user of this frontier, so it does not need a
+    // copy; compact the surviving entries in place instead.
+    PruneMapInPlace(queryNode.Child(0), referenceFrontier);
+    Traverse(queryNode.Child(0), referenceFrontier);
+    --depth;
   }
 
   if (queryNode.Scale() != INT_MIN)
@@ -90,10 +107,10 @@ DualTreeTraverser<RuleType>::Traverse(
 
   // If we have made it this far, all we have is a bunch of base case
   // evaluations to do.
-  Log::Assert((*referenceMap.begin()).first == INT_MIN);
+  Log::Assert(referenceFrontier.MaxScale() == INT_MIN);
   Log::Assert(queryNode.Scale() == INT_MIN);
   std::vector<DualCoverTreeMapEntry>& pointVector =
-      (*referenceMap.begin()).second;
+      referenceFrontier.Leaves();
 
   for (size_t i = 0; i < pointVector.size(); ++i)
   {
@@ -109,6 +126,7 @@ DualTreeTraverser<RuleType>::Traverse(
         (queryNode.Point() == queryNode.Parent()->Point()))
     {
       ++numPrunes;
+      stats.Prune();
       continue;
     }
 
@@ -116,15 +134,20 @@ DualTreeTraverser<RuleType>::Traverse(
     // info.
     rule.TraversalInfo() = frame.traversalInfo;
     double score = rule.Score(queryNode, *refNode);
+    ++numScores;
+    stats.Score();
 
     if (score == DBL_MAX)
     {
       ++numPrunes;
+      stats.Prune();
       continue;
     }
 
     // If not, compute the base case.
     rule.BaseCase(queryNode.Point(), pointVector[i].referenceNode->Point());
+    ++numBaseCases;
+    stats.BaseCase();
   }
 }
 
@@ -133,117 +156,151 @@ template<typename RuleType>
 void CoverTree<MetricType, RootPointPolicy, StatisticType>::
 DualTreeTraverser<RuleType>::PruneMap(
     CoverTree& queryNode,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& referenceMap,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& childMap)
+    ReferenceFrontier& referenceFrontier,
+    ReferenceFrontier& childFrontier)
 {
-  if (referenceMap.empty())
+  if (referenceFrontier.Empty())
     return; // Nothing to do.
 
-  // Copy the zero set first.
-  if ((*referenceMap.begin()).first == INT_MIN)
+  // Copy the zero set first, then every occupied scale from the highest on
+  // down.  Slot i of the frontier holds the entries at scale
+  // (BoundingScale() - i), so ascending slots are descending scales.
+  PruneScale(queryNode, referenceFrontier.Leaves(), childFrontier.Leaves());
+
+  for (size_t i = 0; i < referenceFrontier.NumScaleSlots(); ++i)
   {
-    // Get a reference to the vector representing the entries at this scale.
-    std::vector<DualCoverTreeMapEntry>& scaleVector =
-        (*referenceMap.begin()).second;
+    const int thisScale = referenceFrontier.BoundingScale() - (int) i;
+    PruneScale(queryNode, referenceFrontier.Scale(thisScale),
+        childFrontier.Scale(thisScale));
+  }
+}
 
-    // Before traversing all the points in this scale, sort by score.
-    std::sort(scaleVector.begin(), scaleVector.end());
+template<typename MetricType, typename RootPointPolicy, typename StatisticType>
+template<typename RuleType>
+void CoverTree<MetricType, RootPointPolicy, StatisticType>::
+DualTreeTraverser<RuleType>::PruneMapInPlace(
+    CoverTree& queryNode,
+    ReferenceFrontier& referenceFrontier)
+{
+  if (referenceFrontier.Empty())
+    return; // Nothing to do.
 
-    const int thisScale = (*referenceMap.begin()).first;
-    childMap[thisScale].reserve(scaleVector.size());
-    std::vector<DualCoverTreeMapEntry>& newScaleVector = childMap[thisScale];
+  // Same as PruneMap(), but the surviving entries of each scale are compacted
+  // into the front of their own slot instead of copied to a new frontier.
+  PruneScaleInPlace(queryNode, referenceFrontier.Leaves());
 
-    // Loop over each entry in the vector.
-    for (size_t j = 0; j < scaleVector.size(); ++j)
-    {
-      const DualCoverTreeMapEntry& frame = scaleVector[j];
+  for (size_t i = 0; i < referenceFrontier.NumScaleSlots(); ++i)
+  {
+    const int thisScale = referenceFrontier.BoundingScale() - (int) i;
+    PruneScaleInPlace(queryNode, referenceFrontier.Scale(thisScale));
+  }
+}
 
-      // First evaluate if we can prune without performing the base case.
-      CoverTree<MetricType, RootPointPolicy, StatisticType>* refNode =
-          frame.referenceNode;
+template<typename MetricType, typename RootPointPolicy, typename StatisticType>
+template<typename RuleType>
+void CoverTree<MetricType, RootPointPolicy, StatisticType>::
+DualTreeTraverser<RuleType>::PruneScale(
+    CoverTree& queryNode,
+    std::vector<DualCoverTreeMapEntry>& scaleVector,
+    std::vector<DualCoverTreeMapEntry>& newScaleVector)
+{
+  if (scaleVector.empty())
+    return; // Nothing to do.
 
-      // Perform the actual scoring, after restoring the traversal info.
-      rule.TraversalInfo() = frame.traversalInfo;
-      double score = rule.Score(queryNode, *refNode);
+  // Before traversing all the points in this scale, sort by score.
+  std::sort(scaleVector.begin(), scaleVector.end());
 
-      if (score == DBL_MAX)
-      {
-        // Pruned.  Move on.
-        ++numPrunes;
-        continue;
-      }
+  newScaleVector.reserve(scaleVector.size());
 
-      // If it isn't pruned, we must evaluate the base case.
-      const double baseCase = rule.BaseCase(queryNode.Point(),
-          refNode->Point());
+  // Loop over each entry in the vector.
+  for (size_t j = 0; j < scaleVector.size(); ++j)
+  {
+    const DualCoverTreeMapEntry& frame = scaleVector[j];
+
+    // First evaluate if we can prune without performing the base case.
+    CoverTree<MetricType, RootPointPolicy, StatisticType>* refNode =
+        frame.referenceNode;
+
+    // Perform the actual scoring, after restoring the traversal info.
+    rule.TraversalInfo() = frame.traversalInfo;
+    double score = rule.Score(queryNode, *refNode);
+    ++numScores;
+    stats.Score();
 
-      // Add to child map.
-      newScaleVector.push_back(frame);
-      newScaleVector.back().score = score;
-      newScaleVector.back().baseCase = baseCase;
-      newScaleVector.back().traversalInfo = rule.TraversalInfo();
+    if (score == DBL_MAX)
+    {
+      // Pruned.  Move on.
+      ++numPrunes;
+      stats.Prune();
+      continue;
     }
 
-    // If we didn't add anything, then strike this vector from the map.
-    if (newScaleVector.size() == 0)
-      childMap.erase((*referenceMap.begin()).first);
+    // If it isn't pruned, we must evaluate the base case.
+    const double baseCase = rule.BaseCase(queryNode.Point(),
+        refNode->Point());
+    ++numBaseCases;
+    stats.BaseCase();
+
+    // Add to the child frontier's scale.
+    newScaleVector.push_back(frame);
+    newScaleVector.back().score = score;
+    newScaleVector.back().baseCase = baseCase;
+    newScaleVector.back().traversalInfo = rule.TraversalInfo();
   }
+}
 
-  typename std::map<int, std::vector<DualCoverTreeMapEntry> >::reverse_iterator
-      it = referenceMap.rbegin();
+template<typename MetricType, typename RootPointPolicy, typename StatisticType>
+template<typename RuleType>
+void CoverTree<MetricType, RootPointPolicy, StatisticType>::
+DualTreeTraverser<RuleType>::PruneScaleInPlace(
+    CoverTree& queryNode,
+    std::vector<DualCoverTreeMapEntry>& scaleVector)
+{
+  if (scaleVector.empty())
+    return; // Nothing to do.
 
-  while ((it != referenceMap.rend()))
-  {
-    const int thisScale = (*it).first;
-    if (thisScale == INT_MIN) // We already did it.
-      break;
+  // Before traversing all the points in this scale, sort by score.
+  std::sort(scaleVector.begin(), scaleVector.end());
 
-    // Get a reference to the vector representing the entries at this scale.
-    std::vector<DualCoverTreeMapEntry>& scaleVector = (*it).second;
+  // Compact the surviving entries into the front of the vector.
+  size_t kept = 0;
 
-    // Before traversing all the points in this scale, sort by score.
-    std::sort(scaleVector.begin(), scaleVector.end());
+  // Loop over each entry in the vector.
+  for (size_t j = 0; j < scaleVector.size(); ++j)
+  {
+    // First evaluate if we can prune without performing the base case.
+    CoverTree<MetricType, RootPointPolicy, StatisticType>* refNode =
+        scaleVector[j].referenceNode;
 
-    childMap[thisScale].reserve(scaleVector.size());
-    std::vector<DualCoverTreeMapEntry>& newScaleVector = childMap[thisScale];
+    // Perform the actual scoring, after restoring the traversal info.
+    rule.TraversalInfo() = scaleVector[j].traversalInfo;
+    double score = rule.Score(queryNode, *refNode);
+    ++numScores;
+    stats.Score();
 
-    // Loop over each entry in the vector.
-    for (size_t j = 0; j < scaleVector.size(); ++j)
+    if (score == DBL_MAX)
     {
-      const DualCoverTreeMapEntry& frame = scaleVector[j];
-
-      // First evaluate if we can prune without performing the base case.
-      CoverTree<MetricType, RootPointPolicy, StatisticType>* refNode =
-          frame.referenceNode;
-
-      // Perform the actual scoring, after restoring the traversal info.
-      rule.TraversalInfo() = frame.traversalInfo;
-      double score = rule.Score(queryNode, *refNode);
-
-      if (score == DBL_MAX)
-      {
-        // Pruned.  Move on.
-        ++numPrunes;
-        continue;
-      }
-
-      // If it isn't pruned, we must evaluate the base case.
-      const double baseCase = rule.BaseCase(queryNode.Point(),
-          refNode->Point());
-
-      // Add to child map.
-      newScaleVector.push_back(frame);
-      newScaleVector.back().score = score;
-      newScaleVector.back().baseCase = baseCase;
-      newScaleVector.back().traversalInfo = rule.TraversalInfo();
+      // Pruned.  Move on.
+      ++numPrunes;
+      stats.Prune();
+      continue;
     }
 
-    // If we didn't add anything, then strike this vector from the map.
-    if (newScaleVector.size() == 0)
-      childMap.erase((*it).first);
-
-    ++it; // Advance to next scale.
+    // If it isn't pruned, we must evaluate the base case.
+    const double baseCase = rule.BaseCase(queryNode.Point(),
+        refNode->Point());
+    ++numBaseCases;
+    stats.BaseCase();
+
+    // Keep the entry, with its updated evaluation.
+    scaleVector[kept] = scaleVector[j];
+    scaleVector[kept].score = score;
+    scaleVector[kept].baseCase = baseCase;
+    scaleVector[kept].traversalInfo = rule.TraversalInfo();
+    ++kept;
   }
+
+  scaleVector.resize(kept);
 }
 
 template<typename MetricType, typename RootPointPolicy, typename StatisticType>
@@ -251,27 +308,28 @@ template<typename RuleType>
 void CoverTree<MetricType, RootPointPolicy, StatisticType>::
 DualTreeTraverser<RuleType>::ReferenceRecursion(
     CoverTree& queryNode,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& referenceMap)
+    ReferenceFrontier& referenceFrontier)
 {
-  // First, reduce the maximum scale in the reference map down to the scale of
-  // the query node.
-  while (!referenceMap.empty())
+  // First, reduce the maximum scale in the reference frontier down to the
+  // scale of the query node.
+  while (!referenceFrontier.Empty())
   {
+    const int maxScale = referenceFrontier.MaxScale();
+
     // Hacky bullshit to imitate jl cover tree.
-    if (queryNode.Parent() == NULL && (*referenceMap.rbegin()).first <
-        queryNode.Scale())
+    if (queryNode.Parent() == NULL && maxScale < queryNode.Scale())
       break;
-    if (queryNode.Parent() != NULL && (*referenceMap.rbegin()).first <=
-        queryNode.Scale())
+    if (queryNode.Parent() != NULL && maxScale <= queryNode.Scale())
       break;
-    // If the query node's scale is INT_MIN and the reference map's maximum
-    // scale is INT_MIN, don't try to recurse...
-    if ((queryNode.Scale() == INT_MIN) &&
-       ((*referenceMap.rbegin()).first == INT_MIN))
+    // If the query node's scale is INT_MIN and the reference frontier's
+    // maximum scale is INT_MIN, don't try to recurse...
+    if ((queryNode.Scale() == INT_MIN) && (maxScale == INT_MIN))
       break;
 
-    // Get a reference to the current largest scale.
-    std::vector<DualCoverTreeMapEntry>& scaleVector = (*referenceMap.rbegin()).second;
+    // Get a reference to the current largest scale.  Children are inserted at
+    // strictly smaller scales, which never moves this slot.
+    std::vector<DualCoverTreeMapEntry>& scaleVector =
+        referenceFrontier.Scale(maxScale);
 
     // Before traversing all the points in this scale, sort by score.
     std::sort(scaleVector.begin(), scaleVector.end());
@@ -293,6 +351,7 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
       if (score == DBL_MAX)
       {
         ++numPrunes;
+        stats.Prune();
         continue;
       }
 
@@ -303,15 +362,21 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
       {
         rule.TraversalInfo() = frame.traversalInfo;
         double childScore = rule.Score(queryNode, refNode->Child(j));
+        ++numScores;
+        stats.Score();
+
         if (childScore == DBL_MAX)
         {
           ++numPrunes;
+          stats.Prune();
           continue;
         }
 
         // It wasn't pruned; evaluate the base case.
         const double baseCase = rule.BaseCase(queryNode.Point(),
             refNode->Child(j).Point());
+        ++numBaseCases;
+        stats.BaseCase();
 
         DualCoverTreeMapEntry newFrame;
         newFrame.referenceNode = &refNode->Child(j);
@@ -319,12 +384,13 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
         newFrame.baseCase = baseCase;
         newFrame.traversalInfo = rule.TraversalInfo();
 
-        referenceMap[newFrame.referenceNode->Scale()].push_back(newFrame);
+        referenceFrontier.Insert(newFrame);
       }
     }
 
-    // Now clear the memory for this scale; it isn't needed anymore.
-    referenceMap.erase((*referenceMap.rbegin()).first);
+    // Now clear this scale; it isn't needed anymore.  The slot's memory is
+    // kept for reuse.
+    scaleVector.clear();
   }
 }
 
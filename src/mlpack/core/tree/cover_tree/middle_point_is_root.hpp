@@ -0,0 +1,79 @@
+/**
+ * @file middle_point_is_root.hpp
+ * @author Ryan Curtin
+ *
+ * A policy for the cover tree that chooses an approximately central point of
+ * the dataset as the root, instead of blindly taking the first point.
+ */
+#ifndef __MLPACK_CORE_TREE_MIDDLE_POINT_IS_ROOT_HPP
+#define __MLPACK_CORE_TREE_MIDDLE_POINT_IS_ROOT_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This class is meant to be used as a choice for the policy class
+ * RootPointPolicy of the CoverTree class.  It chooses the point with the
+ * least maximum distance to other points -- the point closest to the "middle"
+ * of the dataset -- which gives the root a smaller furthest descendant
+ * distance and therefore a smaller top scale than an arbitrary point would.
+ *
+ * Finding the exact such point costs O(n^2) distance computations, so both
+ * the candidate roots and the points they are measured against are sampled
+ * (up to 100 of each); the chosen root is approximately central, which is all
+ * the tree needs.  The Euclidean metric is used for the measurement
+ * regardless of the metric the tree is built with, since the policy interface
+ * does not carry a metric; a centrally-located point under one metric is
+ * generally also central under another.
+ */
+class MiddlePointIsRoot
+{
+ public:
+  /**
+   * Return the approximately central point to be used as the root point of
+   * the cover tree.
+   */
+  static size_t ChooseRoot(const arma::mat& dataset)
+  {
+    // The squared Euclidean distance has the same ordering as the Euclidean
+    // distance, so the square root can be skipped.
+    metric::LMetric<2, false> metric;
+
+    const size_t candidates = std::min((size_t) 100,
+        (size_t) dataset.n_cols);
+    const size_t targets = std::min((size_t) 100, (size_t) dataset.n_cols);
+
+    size_t bestIndex = 0;
+    double bestMaxDistance = DBL_MAX;
+    for (size_t i = 0; i < candidates; ++i)
+    {
+      const size_t candidate = (size_t) math::RandInt(dataset.n_cols);
+
+      double maxDistance = 0.0;
+      for (size_t j = 0; j < targets; ++j)
+      {
+        const size_t target = (size_t) math::RandInt(dataset.n_cols);
+        const double distance = metric.Evaluate(dataset.unsafe_col(candidate),
+            dataset.unsafe_col(target));
+        if (distance > maxDistance)
+          maxDistance = distance;
+      }
+
+      if (maxDistance < bestMaxDistance)
+      {
+        bestMaxDistance = maxDistance;
+        bestIndex = candidate;
+      }
+    }
+
+    return bestIndex;
+  }
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif // __MLPACK_CORE_TREE_MIDDLE_POINT_IS_ROOT_HPP
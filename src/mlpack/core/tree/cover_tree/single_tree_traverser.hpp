@@ -10,6 +10,7 @@
 #define __MLPACK_CORE_TREE_COVER_TREE_SINGLE_TREE_TRAVERSER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "cover_tree.hpp"
 
@@ -40,12 +41,21 @@ class CoverTree<MetricType, RootPointPolicy, StatisticType>::SingleTreeTraverser
   //! Set the number of prunes (good for a reset to 0).
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
+
  private:
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
 };
 
 }; // namespace tree
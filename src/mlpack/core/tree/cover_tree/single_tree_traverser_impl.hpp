@@ -64,12 +64,17 @@ SingleTreeTraverser<RuleType>::Traverse(
   // largest scale.
   std::map<int, std::vector<MapEntryType> > mapQueue;
 
+  // The root is at level 0 of the traversal.
+  stats.Visit(0);
+
   // Create the score for the children.
   double rootChildScore = rule.Score(queryIndex, referenceNode);
+  stats.Score();
 
   if (rootChildScore == DBL_MAX)
   {
     numPrunes += referenceNode.NumChildren();
+    stats.Prune(referenceNode.NumChildren());
   }
   else
   {
@@ -78,12 +83,14 @@ SingleTreeTraverser<RuleType>::Traverse(
     // using TreeTraits::FirstPointIsCentroid; this is an optimization that
     // (theoretically) the compiler should get right.
     double rootBaseCase = rule.BaseCase(queryIndex, referenceNode.Point());
+    stats.BaseCase();
 
     // Don't add the self-leaf.
     size_t i = 0;
     if (referenceNode.Child(0).NumChildren() == 0)
     {
       ++numPrunes;
+      stats.Prune();
       i = 1;
     }
 
@@ -106,6 +113,9 @@ SingleTreeTraverser<RuleType>::Traverse(
   typename std::map<int, std::vector<MapEntryType> >::reverse_iterator rit =
       mapQueue.rbegin();
 
+  // Each processed scale is one level deeper in the traversal.
+  size_t level = 1;
+
   // We will treat the leaves differently (below).
   while ((*rit).first != INT_MIN)
   {
@@ -121,6 +131,8 @@ SingleTreeTraverser<RuleType>::Traverse(
       // Get a reference to the current element.
       const MapEntryType& frame = scaleVector.at(i);
 
+      stats.Visit(level);
+
       CoverTree<MetricType, RootPointPolicy, StatisticType>* node = frame.node;
       const double score = frame.score;
       const size_t parent = frame.parent;
@@ -131,17 +143,20 @@ SingleTreeTraverser<RuleType>::Traverse(
       if (rule.Rescore(queryIndex, *node, score) == DBL_MAX)
       {
         ++numPrunes;
+        stats.Prune();
         continue;
       }
 
       // Create the score for the children.
       const double childScore = rule.Score(queryIndex, *node);
+      stats.Score();
 
       // Now if this childScore is DBL_MAX we can prune all children.  In this
       // recursion setup pruning is all or nothing for children.
       if (childScore == DBL_MAX)
       {
         numPrunes += node->NumChildren();
+        stats.Prune(node->NumChildren());
         continue;
       }
 
@@ -150,13 +165,17 @@ SingleTreeTraverser<RuleType>::Traverse(
       // trees using TreeTraits::FirstPointIsCentroid; this is an optimization
       // that (theoretically) the compiler should get right.
       if (point != parent)
+      {
         baseCase = rule.BaseCase(queryIndex, point);
+        stats.BaseCase();
+      }
 
       // Don't add the self-leaf.
       size_t j = 0;
       if (node->Child(0).NumChildren() == 0)
       {
         ++numPrunes;
+        stats.Prune();
         j = 1;
       }
 
@@ -174,6 +193,7 @@ SingleTreeTraverser<RuleType>::Traverse(
 
     // Now clear the memory for this scale; it isn't needed anymore.
     mapQueue.erase((*rit).first);
+    ++level;
   }
 
   // Now deal with the leaves.
@@ -181,6 +201,8 @@ SingleTreeTraverser<RuleType>::Traverse(
   {
     const MapEntryType& frame = mapQueue[INT_MIN].at(i);
 
+    stats.Visit(level);
+
     CoverTree<MetricType, RootPointPolicy, StatisticType>* node = frame.node;
     const double score = frame.score;
     const size_t point = node->Point();
@@ -191,6 +213,7 @@ SingleTreeTraverser<RuleType>::Traverse(
     if (rescore == DBL_MAX)
     {
       ++numPrunes;
+      stats.Prune();
       continue;
     }
 
@@ -198,10 +221,12 @@ SingleTreeTraverser<RuleType>::Traverse(
     // combination, even if pruning it will make no difference.  It's the
     // definition.
     const double actualScore = rule.Score(queryIndex, *node);
+    stats.Score();
 
     if (actualScore == DBL_MAX)
     {
       ++numPrunes;
+      stats.Prune();
       continue;
     }
     else
@@ -211,6 +236,7 @@ SingleTreeTraverser<RuleType>::Traverse(
       // trees using TreeTraits::FirstPointIsCentroid; this is an optimization
       // that (theoretically) the compiler should get right.
       rule.BaseCase(queryIndex, point);
+      stats.BaseCase();
     }
   }
 }
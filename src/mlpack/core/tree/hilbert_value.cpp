@@ -0,0 +1,121 @@
+/**
+ * @file hilbert_value.cpp
+ * @author Andrew Wells
+ *
+ * Implementation of the cached fixed-precision Hilbert curve calculator.
+ */
+#include "hilbert_value.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace tree {
+
+HilbertValue::HilbertValue() : bitsPerDim(0), keyDims(0)
+{
+  // Nothing to do; InitFrame() sets the frame.
+}
+
+void HilbertValue::InitFrame(const arma::mat& dataset)
+{
+  mins = arma::min(dataset, 1);
+  widths = arma::max(dataset, 1) - mins;
+
+  // A constant dimension cannot distinguish any points; give it unit width so
+  // the normalization below stays well-defined (every point quantizes to 0).
+  for (size_t d = 0; d < widths.n_elem; ++d)
+    if (widths[d] == 0.0)
+      widths[d] = 1.0;
+
+  // Only as many dimensions as fit one bit each into a 64-bit key can
+  // contribute to the value; the bits are split evenly between the
+  // contributing dimensions (capped as in the Morton ordering utility).
+  keyDims = std::min((size_t) dataset.n_rows, (size_t) 64);
+  bitsPerDim = 64 / keyDims;
+  if (bitsPerDim > 32)
+    bitsPerDim = 32;
+}
+
+uint64_t HilbertValue::Value(const arma::vec& point) const
+{
+  const uint64_t maxCode = (((uint64_t) 1) << bitsPerDim) - 1;
+
+  // Quantize the contributing coordinates; points outside the frame are
+  // clamped onto its boundary.
+  std::vector<uint64_t> x(keyDims);
+  for (size_t d = 0; d < keyDims; ++d)
+  {
+    double t = (point[d] - mins[d]) / widths[d];
+    if (t < 0.0)
+      t = 0.0;
+    else if (t > 1.0)
+      t = 1.0;
+    x[d] = std::min((uint64_t) (t * (double) maxCode), maxCode);
+  }
+
+  // Transform the coordinates in place into the transpose form of the Hilbert
+  // index (Skilling, "Programming the Hilbert curve", 2004).
+  const uint64_t m = ((uint64_t) 1) << (bitsPerDim - 1);
+
+  // Inverse undo.
+  for (uint64_t q = m; q > 1; q >>= 1)
+  {
+    const uint64_t p = q - 1;
+    for (size_t d = 0; d < keyDims; ++d)
+    {
+      if (x[d] & q)
+      {
+        x[0] ^= p; // Invert.
+      }
+      else
+      {
+        const uint64_t t = (x[0] ^ x[d]) & p; // Exchange.
+        x[0] ^= t;
+        x[d] ^= t;
+      }
+    }
+  }
+
+  // Gray encode.
+  for (size_t d = 1; d < keyDims; ++d)
+    x[d] ^= x[d - 1];
+  uint64_t t = 0;
+  for (uint64_t q = m; q > 1; q >>= 1)
+    if (x[keyDims - 1] & q)
+      t ^= q - 1;
+  for (size_t d = 0; d < keyDims; ++d)
+    x[d] ^= t;
+
+  // The transpose form distributes the bits of the index across the
+  // coordinates; interleaving them most significant bit first recovers the
+  // index itself.
+  uint64_t key = 0;
+  for (size_t b = bitsPerDim; b > 0; --b)
+    for (size_t d = 0; d < keyDims; ++d)
+      key = (key << 1) | ((x[d] >> (b - 1)) & 1);
+
+  return key;
+}
+
+uint64_t HilbertValue::CachedValue(const arma::mat& dataset,
+                                   const size_t index)
+{
+  // Column indices of existing points never change (deleted points stay in
+  // the dataset), so a cached value can never go stale.
+  if (index >= computed.size())
+  {
+    computed.resize(dataset.n_cols, false);
+    values.resize(dataset.n_cols, 0);
+  }
+
+  if (!computed[index])
+  {
+    values[index] = Value(dataset.unsafe_col(index));
+    computed[index] = true;
+  }
+
+  return values[index];
+}
+
+} // namespace tree
+} // namespace mlpack
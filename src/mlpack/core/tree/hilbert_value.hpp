@@ -0,0 +1,98 @@
+/**
+ * @file hilbert_value.hpp
+ * @author Andrew Wells
+ *
+ * A fixed-precision integer Hilbert curve, with a per-point value cache, for
+ * ordering points and bounds in Hilbert R-tree splits.
+ */
+#ifndef __MLPACK_CORE_TREE_HILBERT_VALUE_HPP
+#define __MLPACK_CORE_TREE_HILBERT_VALUE_HPP
+
+#include <mlpack/core.hpp>
+
+// uint64_t isn't defined on every windows.
+#if defined(_MSC_VER) && (_MSC_VER < 1600)
+  typedef unsigned __int64 uint64_t;
+#else
+  #include <stdint.h> // uint64_t.
+#endif
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Compute fixed-precision integer Hilbert curve values of points, caching the
+ * value of each dataset point so it is computed at most once no matter how
+ * many splits the point participates in.
+ *
+ * The quantization frame (the box mapped onto the curve) is fixed when
+ * InitFrame() is called, so values computed at different times remain
+ * comparable; points outside the frame are clamped onto its boundary, which
+ * only weakens the ordering heuristic near the edges.  Each dimension is
+ * quantized to the same number of bits, chosen so the interleaved key fits in
+ * 64 bits; for very high-dimensional data only the first 64 dimensions
+ * contribute to the key (as with the Morton ordering utility, the value is a
+ * locality heuristic, so this does not affect correctness).
+ *
+ * The quantized coordinates are converted to a position along the Hilbert
+ * curve with the transpose-form bit manipulation algorithm of Skilling
+ * ("Programming the Hilbert curve", 2004), which runs in
+ * O(dimensions * bits) integer operations per point.
+ */
+class HilbertValue
+{
+ public:
+  /**
+   * Create an empty calculator; InitFrame() must be called before values can
+   * be computed.
+   */
+  HilbertValue();
+
+  /**
+   * Fix the quantization frame to the bounding box of the given dataset.
+   * Values computed before and after a frame change are not comparable, so
+   * this should be called exactly once.
+   *
+   * @param dataset Dataset whose bounding box defines the frame.
+   */
+  void InitFrame(const arma::mat& dataset);
+
+  //! Return true if the quantization frame has been initialized.
+  bool Initialized() const { return bitsPerDim > 0; }
+
+  /**
+   * Compute the Hilbert value of the given point (clamped into the frame).
+   *
+   * @param point Point to compute the Hilbert value of.
+   */
+  uint64_t Value(const arma::vec& point) const;
+
+  /**
+   * Return the Hilbert value of the given dataset point, computing and
+   * caching it on first use.
+   *
+   * @param dataset Dataset the point lives in.
+   * @param index Column index of the point.
+   */
+  uint64_t CachedValue(const arma::mat& dataset, const size_t index);
+
+ private:
+  //! Lower corner of the quantization frame.
+  arma::vec mins;
+  //! Widths of the quantization frame (zero widths are replaced by one).
+  arma::vec widths;
+  //! Bits of precision per dimension (0 until InitFrame() is called).
+  size_t bitsPerDim;
+  //! Number of dimensions contributing to the key.
+  size_t keyDims;
+
+  //! Cached values, indexed by dataset column.
+  std::vector<uint64_t> values;
+  //! Whether the value of each dataset column has been computed.
+  std::vector<bool> computed;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -21,16 +21,27 @@ namespace bound {
  * with the LMetric class.  Be sure to use the same template parameters for
  * LMetric as you do for HRectBound -- otherwise odd results may occur.
  *
+ * The element type of the bound is also a template parameter; use float for
+ * single-precision bounds (i.e. when the tree is built on an arma::fmat),
+ * which halves the memory used by the bounds and allows wider SIMD operations.
+ * Float bounds may also be used with double-precision data to halve the bound
+ * memory footprint of the tree: when a bound is expanded to include data of a
+ * wider type, any inexact narrowing is rounded outward, so the stored bound
+ * always encloses the data and pruning remains conservative.
+ *
  * @tparam Power The metric to use; use 2 for Euclidean (L2).
  * @tparam TakeRoot Whether or not the root should be taken (see LMetric
  *     documentation).
+ * @tparam ElemType Type of the bound values (e.g. double or float).
  */
-template<int Power = 2, bool TakeRoot = true>
+template<int Power = 2, bool TakeRoot = true, typename ElemType = double>
 class HRectBound
 {
  public:
   //! This is the metric type that this bound is using.
   typedef metric::LMetric<Power, TakeRoot> MetricType;
+  //! The type of a single range of the bound.
+  typedef math::RangeType<ElemType> RangeType;
 
   /**
    * Empty constructor; creates a bound of dimensionality 0.
@@ -62,28 +73,30 @@ class HRectBound
 
   //! Get the range for a particular dimension.  No bounds checking.  Be
   //! careful: this may make MinWidth() invalid.
-  math::Range& operator[](const size_t i) { return bounds[i]; }
+  math::RangeType<ElemType>& operator[](const size_t i) { return bounds[i]; }
   //! Modify the range for a particular dimension.  No bounds checking.
-  const math::Range& operator[](const size_t i) const { return bounds[i]; }
+  const math::RangeType<ElemType>& operator[](const size_t i) const
+  { return bounds[i]; }
 
   //! Get the minimum width of the bound.
-  double MinWidth() const { return minWidth; }
+  ElemType MinWidth() const { return minWidth; }
   //! Modify the minimum width of the bound.
-  double& MinWidth() { return minWidth; }
+  ElemType& MinWidth() { return minWidth; }
 
   /**
    * Calculates the centroid of the range, placing it into the given vector.
    *
    * @param centroid Vector which the centroid will be written to.
    */
-  void Centroid(arma::vec& centroid) const;
+  template<typename VecType>
+  void Centroid(VecType& centroid) const;
 
   /**
    * Calculate the volume of the hyperrectangle.
    *
    * @return Volume of the hyperrectangle.
    */
-  double Volume() const;
+  ElemType Volume() const;
 
   /**
    * Calculates minimum bound-to-point distance.
@@ -91,15 +104,16 @@ class HRectBound
    * @param point Point to which the minimum distance is requested.
    */
   template<typename VecType>
-  double MinDistance(const VecType& point,
-                     typename boost::enable_if<IsVector<VecType> >* = 0) const;
+  ElemType MinDistance(const VecType& point,
+                       typename boost::enable_if<IsVector<VecType> >* = 0)
+      const;
 
   /**
    * Calculates minimum bound-to-bound distance.
    *
    * @param other Bound to which the minimum distance is requested.
    */
-  double MinDistance(const HRectBound& other) const;
+  ElemType MinDistance(const HRectBound& other) const;
 
   /**
    * Calculates maximum bound-to-point squared distance.
@@ -107,15 +121,16 @@ class HRectBound
    * @param point Point to which the maximum distance is requested.
    */
   template<typename VecType>
-  double MaxDistance(const VecType& point,
-                     typename boost::enable_if<IsVector<VecType> >* = 0) const;
+  ElemType MaxDistance(const VecType& point,
+                       typename boost::enable_if<IsVector<VecType> >* = 0)
+      const;
 
   /**
    * Computes maximum distance.
    *
    * @param other Bound to which the maximum distance is requested.
    */
-  double MaxDistance(const HRectBound& other) const;
+  ElemType MaxDistance(const HRectBound& other) const;
 
   /**
    * Calculates minimum and maximum bound-to-bound distance.
@@ -123,7 +138,7 @@ class HRectBound
    * @param other Bound to which the minimum and maximum distances are
    *     requested.
    */
-  math::Range RangeDistance(const HRectBound& other) const;
+  math::RangeType<ElemType> RangeDistance(const HRectBound& other) const;
 
   /**
    * Calculates minimum and maximum bound-to-point distance.
@@ -132,9 +147,9 @@ class HRectBound
    *     requested.
    */
   template<typename VecType>
-  math::Range RangeDistance(const VecType& point,
-                            typename boost::enable_if<IsVector<VecType> >* = 0)
-      const;
+  math::RangeType<ElemType> RangeDistance(
+      const VecType& point,
+      typename boost::enable_if<IsVector<VecType> >* = 0) const;
 
   /**
    * Expands this region to include new points.
@@ -146,6 +161,27 @@ class HRectBound
   template<typename MatType>
   HRectBound& operator|=(const MatType& data);
 
+  /**
+   * Expands this region to include new sparse points, visiting only the
+   * nonzero elements.  Any dimension in which some point holds an implicit
+   * zero has zero merged into its range as well.
+   *
+   * @param data Sparse data points to expand this region to include.
+   */
+  template<typename InputType>
+  HRectBound& operator|=(const arma::SpMat<InputType>& data);
+
+  /**
+   * Expands this region to include a contiguous set of columns of a sparse
+   * matrix, as handed over during tree construction.  Only the nonzero
+   * elements of those columns are visited.
+   *
+   * @param data Subview of sparse data points to expand this region to
+   *   include; it must span every row of the matrix it views.
+   */
+  template<typename InputType>
+  HRectBound& operator|=(const arma::SpSubview<InputType>& data);
+
   /**
    * Expands this region to encompass another bound.
    */
@@ -160,7 +196,7 @@ class HRectBound
   /**
    * Returns the diameter of the hyperrectangle (that is, the longest diagonal).
    */
-  double Diameter() const;
+  ElemType Diameter() const;
 
   /**
    * Returns a string representation of this object.
@@ -178,9 +214,9 @@ class HRectBound
   //! The dimensionality of the bound.
   size_t dim;
   //! The bounds for each dimension.
-  math::Range* bounds;
+  math::RangeType<ElemType>* bounds;
   //! Cached minimum width of bound.
-  double minWidth;
+  ElemType minWidth;
 };
 
 }; // namespace bound
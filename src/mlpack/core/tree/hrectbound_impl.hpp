@@ -9,6 +9,7 @@
 #ifndef __MLPACK_CORE_TREE_HRECTBOUND_IMPL_HPP
 #define __MLPACK_CORE_TREE_HRECTBOUND_IMPL_HPP
 
+#include <cmath>
 #include <math.h>
 
 // In case it has not been included yet.
@@ -17,11 +18,103 @@
 namespace mlpack {
 namespace bound {
 
+/**
+ * Raise a nonnegative value to the integral power Power.  For the common
+ * metrics (L1, L2, L3) this expands to straight multiplications, which keeps
+ * the per-dimension loops of the distance functions below free of libm calls
+ * and allows the compiler to vectorize them (with SSE/AVX where available).
+ * The value type is a template parameter so that both double and float
+ * bounds use their native precision.
+ */
+template<int Power>
+struct BoundPower
+{
+  template<typename T>
+  static T Pow(const T x) { return std::pow(x, (T) Power); }
+
+  template<typename T>
+  static T Root(const T x) { return std::pow(x, (T) 1 / (T) Power); }
+};
+
+template<>
+struct BoundPower<1>
+{
+  template<typename T>
+  static T Pow(const T x) { return x; }
+
+  template<typename T>
+  static T Root(const T x) { return x; }
+};
+
+template<>
+struct BoundPower<2>
+{
+  template<typename T>
+  static T Pow(const T x) { return x * x; }
+
+  template<typename T>
+  static T Root(const T x) { return std::sqrt(x); }
+};
+
+template<>
+struct BoundPower<3>
+{
+  template<typename T>
+  static T Pow(const T x) { return x * x * x; }
+
+  template<typename T>
+  static T Root(const T x) { return std::pow(x, (T) 1 / (T) 3); }
+};
+
+//! Raise a nonnegative value to the integral power Power.
+template<int Power, typename T>
+inline T BoundPow(const T x) { return BoundPower<Power>::Pow(x); }
+
+//! Take the Power'th root of a nonnegative value; the inverse of BoundPow().
+template<int Power, typename T>
+inline T BoundRoot(const T x) { return BoundPower<Power>::Root(x); }
+
+/**
+ * Outward-rounding conversion of a value to the bound's element type.  When
+ * the bound is stored at lower precision than the data (e.g. float bounds
+ * over an arma::mat), a plain round-to-nearest conversion may round a minimum
+ * up or a maximum down, producing a bound that no longer encloses the data --
+ * and pruning with such a bound would not be conservative.  These helpers
+ * round toward -inf and +inf respectively whenever the conversion is inexact,
+ * so stored lower bounds never increase and stored upper bounds never
+ * decrease.  When no narrowing occurs, they are plain copies.
+ */
+template<typename ElemType, typename InputType>
+struct BoundConversion
+{
+  static ElemType RoundDown(const InputType value) { return value; }
+  static ElemType RoundUp(const InputType value) { return value; }
+};
+
+//! Narrowing double-to-float conversion; round outward when inexact.
+template<>
+struct BoundConversion<float, double>
+{
+  static float RoundDown(const double value)
+  {
+    const float result = (float) value;
+    return ((double) result > value) ?
+        nextafterf(result, -std::numeric_limits<float>::max()) : result;
+  }
+
+  static float RoundUp(const double value)
+  {
+    const float result = (float) value;
+    return ((double) result < value) ?
+        nextafterf(result, std::numeric_limits<float>::max()) : result;
+  }
+};
+
 /**
  * Empty constructor.
  */
-template<int Power, bool TakeRoot>
-inline HRectBound<Power, TakeRoot>::HRectBound() :
+template<int Power, bool TakeRoot, typename ElemType>
+inline HRectBound<Power, TakeRoot, ElemType>::HRectBound() :
     dim(0),
     bounds(NULL),
     minWidth(0)
@@ -31,20 +124,22 @@ inline HRectBound<Power, TakeRoot>::HRectBound() :
  * Initializes to specified dimensionality with each dimension the empty
  * set.
  */
-template<int Power, bool TakeRoot>
-inline HRectBound<Power, TakeRoot>::HRectBound(const size_t dimension) :
+template<int Power, bool TakeRoot, typename ElemType>
+inline HRectBound<Power, TakeRoot, ElemType>::HRectBound(
+    const size_t dimension) :
     dim(dimension),
-    bounds(new math::Range[dim]),
+    bounds(new math::RangeType<ElemType>[dim]),
     minWidth(0)
 { /* Nothing to do. */ }
 
 /***
  * Copy constructor necessary to prevent memory leaks.
  */
-template<int Power, bool TakeRoot>
-inline HRectBound<Power, TakeRoot>::HRectBound(const HRectBound& other) :
+template<int Power, bool TakeRoot, typename ElemType>
+inline HRectBound<Power, TakeRoot, ElemType>::HRectBound(
+    const HRectBound& other) :
     dim(other.Dim()),
-    bounds(new math::Range[dim]),
+    bounds(new math::RangeType<ElemType>[dim]),
     minWidth(other.MinWidth())
 {
   // Copy other bounds over.
@@ -55,9 +150,9 @@ inline HRectBound<Power, TakeRoot>::HRectBound(const HRectBound& other) :
 /***
  * Same as the copy constructor.
  */
-template<int Power, bool TakeRoot>
-inline HRectBound<Power, TakeRoot>& HRectBound<Power, TakeRoot>::operator=(
-    const HRectBound& other)
+template<int Power, bool TakeRoot, typename ElemType>
+inline HRectBound<Power, TakeRoot, ElemType>&
+HRectBound<Power, TakeRoot, ElemType>::operator=(const HRectBound& other)
 {
   if (dim != other.Dim())
   {
@@ -66,7 +161,7 @@ inline HRectBound<Power, TakeRoot>& HRectBound<Power, TakeRoot>::operator=(
       delete[] bounds;
 
     dim = other.Dim();
-    bounds = new math::Range[dim];
+    bounds = new math::RangeType<ElemType>[dim];
   }
 
   // Now copy each of the bound values.
@@ -81,8 +176,8 @@ inline HRectBound<Power, TakeRoot>& HRectBound<Power, TakeRoot>::operator=(
 /**
  * Destructor: clean up memory.
  */
-template<int Power, bool TakeRoot>
-inline HRectBound<Power, TakeRoot>::~HRectBound()
+template<int Power, bool TakeRoot, typename ElemType>
+inline HRectBound<Power, TakeRoot, ElemType>::~HRectBound()
 {
   if (bounds)
     delete[] bounds;
@@ -91,11 +186,11 @@ inline HRectBound<Power, TakeRoot>::~HRectBound()
 /**
  * Resets all dimensions to the empty set.
  */
-template<int Power, bool TakeRoot>
-inline void HRectBound<Power, TakeRoot>::Clear()
+template<int Power, bool TakeRoot, typename ElemType>
+inline void HRectBound<Power, TakeRoot, ElemType>::Clear()
 {
   for (size_t i = 0; i < dim; i++)
-    bounds[i] = math::Range();
+    bounds[i] = math::RangeType<ElemType>();
   minWidth = 0;
 }
 
@@ -104,8 +199,10 @@ inline void HRectBound<Power, TakeRoot>::Clear()
  *
  * @param centroid Vector which the centroid will be written to.
  */
-template<int Power, bool TakeRoot>
-inline void HRectBound<Power, TakeRoot>::Centroid(arma::vec& centroid) const
+template<int Power, bool TakeRoot, typename ElemType>
+template<typename VecType>
+inline void HRectBound<Power, TakeRoot, ElemType>::Centroid(
+    VecType& centroid) const
 {
   // Set size correctly if necessary.
   if (!(centroid.n_elem == dim))
@@ -120,10 +217,10 @@ inline void HRectBound<Power, TakeRoot>::Centroid(arma::vec& centroid) const
  *
  * @return Volume of the hyperrectangle.
  */
-template<int Power, bool TakeRoot>
-inline double HRectBound<Power, TakeRoot>::Volume() const
+template<int Power, bool TakeRoot, typename ElemType>
+inline ElemType HRectBound<Power, TakeRoot, ElemType>::Volume() const
 {
-  double volume = 1.0;
+  ElemType volume = 1.0;
   for (size_t i = 0; i < dim; ++i)
     volume *= (bounds[i].Hi() - bounds[i].Lo());
 
@@ -133,17 +230,17 @@ inline double HRectBound<Power, TakeRoot>::Volume() const
 /**
  * Calculates minimum bound-to-point squared distance.
  */
-template<int Power, bool TakeRoot>
+template<int Power, bool TakeRoot, typename ElemType>
 template<typename VecType>
-inline double HRectBound<Power, TakeRoot>::MinDistance(
+inline ElemType HRectBound<Power, TakeRoot, ElemType>::MinDistance(
     const VecType& point,
     typename boost::enable_if<IsVector<VecType> >* /* junk */) const
 {
   Log::Assert(point.n_elem == dim);
 
-  double sum = 0;
+  ElemType sum = 0;
 
-  double lower, higher;
+  ElemType lower, higher;
   for (size_t d = 0; d < dim; d++)
   {
     lower = bounds[d].Lo() - point[d];
@@ -152,7 +249,8 @@ inline double HRectBound<Power, TakeRoot>::MinDistance(
     // Since only one of 'lower' or 'higher' is negative, if we add each's
     // absolute value to itself and then sum those two, our result is the
     // nonnegative half of the equation times two; then we raise to power Power.
-    sum += pow((lower + fabs(lower)) + (higher + fabs(higher)), (double) Power);
+    sum += BoundPow<Power>((lower + std::fabs(lower)) +
+        (higher + std::fabs(higher)));
   }
 
   // Now take the Power'th root (but make sure our result is squared if it needs
@@ -160,24 +258,25 @@ inline double HRectBound<Power, TakeRoot>::MinDistance(
   // that was introduced earlier.  The compiler should optimize out the if
   // statement entirely.
   if (TakeRoot)
-    return pow(sum, 1.0 / (double) Power) / 2.0;
+    return BoundRoot<Power>(sum) / 2;
   else
-    return sum / pow(2.0, Power);
+    return sum / BoundPow<Power>((ElemType) 2);
 }
 
 /**
  * Calculates minimum bound-to-bound squared distance.
  */
-template<int Power, bool TakeRoot>
-double HRectBound<Power, TakeRoot>::MinDistance(const HRectBound& other) const
+template<int Power, bool TakeRoot, typename ElemType>
+ElemType HRectBound<Power, TakeRoot, ElemType>::MinDistance(
+    const HRectBound& other) const
 {
   Log::Assert(dim == other.dim);
 
-  double sum = 0;
-  const math::Range* mbound = bounds;
-  const math::Range* obound = other.bounds;
+  ElemType sum = 0;
+  const math::RangeType<ElemType>* mbound = bounds;
+  const math::RangeType<ElemType>* obound = other.bounds;
 
-  double lower, higher;
+  ElemType lower, higher;
   for (size_t d = 0; d < dim; d++)
   {
     lower = obound->Lo() - mbound->Hi();
@@ -185,7 +284,8 @@ double HRectBound<Power, TakeRoot>::MinDistance(const HRectBound& other) const
     // We invoke the following:
     //   x + fabs(x) = max(x * 2, 0)
     //   (x * 2)^2 / 4 = x^2
-    sum += pow((lower + fabs(lower)) + (higher + fabs(higher)), (double) Power);
+    sum += BoundPow<Power>((lower + std::fabs(lower)) +
+        (higher + std::fabs(higher)));
 
     // Move bound pointers.
     mbound++;
@@ -194,34 +294,34 @@ double HRectBound<Power, TakeRoot>::MinDistance(const HRectBound& other) const
 
   // The compiler should optimize out this if statement entirely.
   if (TakeRoot)
-    return pow(sum, 1.0 / (double) Power) / 2.0;
+    return BoundRoot<Power>(sum) / 2;
   else
-    return sum / pow(2.0, Power);
+    return sum / BoundPow<Power>((ElemType) 2);
 }
 
 /**
  * Calculates maximum bound-to-point squared distance.
  */
-template<int Power, bool TakeRoot>
+template<int Power, bool TakeRoot, typename ElemType>
 template<typename VecType>
-inline double HRectBound<Power, TakeRoot>::MaxDistance(
+inline ElemType HRectBound<Power, TakeRoot, ElemType>::MaxDistance(
     const VecType& point,
     typename boost::enable_if<IsVector<VecType> >* /* junk */) const
 {
-  double sum = 0;
+  ElemType sum = 0;
 
   Log::Assert(point.n_elem == dim);
 
   for (size_t d = 0; d < dim; d++)
   {
-    double v = std::max(fabs(point[d] - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - point[d]));
-    sum += pow(v, (double) Power);
+    ElemType v = std::max(std::fabs(point[d] - bounds[d].Lo()),
+        std::fabs(bounds[d].Hi() - point[d]));
+    sum += BoundPow<Power>(v);
   }
 
   // The compiler should optimize out this if statement entirely.
   if (TakeRoot)
-    return pow(sum, 1.0 / (double) Power);
+    return BoundRoot<Power>(sum);
   else
     return sum;
 }
@@ -229,25 +329,25 @@ inline double HRectBound<Power, TakeRoot>::MaxDistance(
 /**
  * Computes maximum distance.
  */
-template<int Power, bool TakeRoot>
-inline double HRectBound<Power, TakeRoot>::MaxDistance(const HRectBound& other)
-    const
+template<int Power, bool TakeRoot, typename ElemType>
+inline ElemType HRectBound<Power, TakeRoot, ElemType>::MaxDistance(
+    const HRectBound& other) const
 {
-  double sum = 0;
+  ElemType sum = 0;
 
   Log::Assert(dim == other.dim);
 
-  double v;
+  ElemType v;
   for (size_t d = 0; d < dim; d++)
   {
-    v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - other.bounds[d].Lo()));
-    sum += pow(v, (double) Power); // v is non-negative.
+    v = std::max(std::fabs(other.bounds[d].Hi() - bounds[d].Lo()),
+        std::fabs(bounds[d].Hi() - other.bounds[d].Lo()));
+    sum += BoundPow<Power>(v); // v is non-negative.
   }
 
   // The compiler should optimize out this if statement entirely.
   if (TakeRoot)
-    return pow(sum, 1.0 / (double) Power);
+    return BoundRoot<Power>(sum);
   else
     return sum;
 }
@@ -255,16 +355,17 @@ inline double HRectBound<Power, TakeRoot>::MaxDistance(const HRectBound& other)
 /**
  * Calculates minimum and maximum bound-to-bound squared distance.
  */
-template<int Power, bool TakeRoot>
-inline math::Range HRectBound<Power, TakeRoot>::RangeDistance(
+template<int Power, bool TakeRoot, typename ElemType>
+inline math::RangeType<ElemType>
+HRectBound<Power, TakeRoot, ElemType>::RangeDistance(
     const HRectBound& other) const
 {
-  double loSum = 0;
-  double hiSum = 0;
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
 
   Log::Assert(dim == other.dim);
 
-  double v1, v2, vLo, vHi;
+  ElemType v1, v2, vLo, vHi;
   for (size_t d = 0; d < dim; d++)
   {
     v1 = other.bounds[d].Lo() - bounds[d].Hi();
@@ -281,32 +382,33 @@ inline math::Range HRectBound<Power, TakeRoot>::RangeDistance(
       vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
     }
 
-    loSum += pow(vLo, (double) Power);
-    hiSum += pow(vHi, (double) Power);
+    loSum += BoundPow<Power>(vLo);
+    hiSum += BoundPow<Power>(vHi);
   }
 
   if (TakeRoot)
-    return math::Range(pow(loSum, 1.0 / (double) Power),
-                       pow(hiSum, 1.0 / (double) Power));
+    return math::RangeType<ElemType>(BoundRoot<Power>(loSum),
+                                     BoundRoot<Power>(hiSum));
   else
-    return math::Range(loSum, hiSum);
+    return math::RangeType<ElemType>(loSum, hiSum);
 }
 
 /**
  * Calculates minimum and maximum bound-to-point squared distance.
  */
-template<int Power, bool TakeRoot>
+template<int Power, bool TakeRoot, typename ElemType>
 template<typename VecType>
-inline math::Range HRectBound<Power, TakeRoot>::RangeDistance(
+inline math::RangeType<ElemType>
+HRectBound<Power, TakeRoot, ElemType>::RangeDistance(
     const VecType& point,
     typename boost::enable_if<IsVector<VecType> >* /* junk */) const
 {
-  double loSum = 0;
-  double hiSum = 0;
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
 
   Log::Assert(point.n_elem == dim);
 
-  double v1, v2, vLo, vHi;
+  ElemType v1, v2, vLo, vHi;
   for (size_t d = 0; d < dim; d++)
   {
     v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
@@ -331,35 +433,168 @@ inline math::Range HRectBound<Power, TakeRoot>::RangeDistance(
       }
     }
 
-    loSum += pow(vLo, (double) Power);
-    hiSum += pow(vHi, (double) Power);
+    loSum += BoundPow<Power>(vLo);
+    hiSum += BoundPow<Power>(vHi);
   }
 
   if (TakeRoot)
-    return math::Range(pow(loSum, 1.0 / (double) Power),
-                       pow(hiSum, 1.0 / (double) Power));
+    return math::RangeType<ElemType>(BoundRoot<Power>(loSum),
+                                     BoundRoot<Power>(hiSum));
   else
-    return math::Range(loSum, hiSum);
+    return math::RangeType<ElemType>(loSum, hiSum);
 }
 
 /**
  * Expands this region to include a new point.
  */
-template<int Power, bool TakeRoot>
+template<int Power, bool TakeRoot, typename ElemType>
 template<typename MatType>
-inline HRectBound<Power, TakeRoot>& HRectBound<Power, TakeRoot>::operator|=(
-    const MatType& data)
+inline HRectBound<Power, TakeRoot, ElemType>&
+HRectBound<Power, TakeRoot, ElemType>::operator|=(const MatType& data)
+{
+  Log::Assert(data.n_rows == dim);
+
+  // Compute the extrema in the data's own precision; any narrowing to the
+  // bound's element type is done outward (below), so the stored bound always
+  // encloses the data.
+  typedef typename MatType::elem_type InputType;
+  typedef BoundConversion<ElemType, InputType> Convert;
+
+  arma::Col<InputType> mins(min(data, 1));
+  arma::Col<InputType> maxs(max(data, 1));
+
+  minWidth = std::numeric_limits<ElemType>::max();
+  for (size_t i = 0; i < dim; i++)
+  {
+    bounds[i] |= math::RangeType<ElemType>(Convert::RoundDown(mins[i]),
+                                           Convert::RoundUp(maxs[i]));
+    const ElemType width = bounds[i].Width();
+    if (width < minWidth)
+      minWidth = width;
+  }
+
+  return *this;
+}
+
+/**
+ * Expands this region to include a new set of sparse points.
+ */
+template<int Power, bool TakeRoot, typename ElemType>
+template<typename InputType>
+inline HRectBound<Power, TakeRoot, ElemType>&
+HRectBound<Power, TakeRoot, ElemType>::operator|=(
+    const arma::SpMat<InputType>& data)
+{
+  Log::Assert(data.n_rows == dim);
+
+  typedef BoundConversion<ElemType, InputType> Convert;
+
+  // Find the extrema of the nonzero values of each dimension in one pass,
+  // counting the nonzeros so that dimensions holding implicit zeros can be
+  // detected afterwards.
+  arma::Col<InputType> mins(dim);
+  mins.fill(std::numeric_limits<InputType>::max());
+  arma::Col<InputType> maxs(dim);
+  maxs.fill(-std::numeric_limits<InputType>::max());
+  arma::Col<arma::uword> counts(dim);
+  counts.zeros();
+
+  for (typename arma::SpMat<InputType>::const_iterator it = data.begin();
+       it != data.end(); ++it)
+  {
+    const size_t d = it.row();
+    if (*it < mins[d])
+      mins[d] = *it;
+    if (*it > maxs[d])
+      maxs[d] = *it;
+    counts[d]++;
+  }
+
+  // Any dimension with fewer nonzeros than points also holds an implicit
+  // zero, which must be part of its range.
+  for (size_t i = 0; i < dim; i++)
+  {
+    if (counts[i] < data.n_cols)
+    {
+      if (mins[i] > 0)
+        mins[i] = 0;
+      if (maxs[i] < 0)
+        maxs[i] = 0;
+    }
+  }
+
+  minWidth = std::numeric_limits<ElemType>::max();
+  for (size_t i = 0; i < dim; i++)
+  {
+    bounds[i] |= math::RangeType<ElemType>(Convert::RoundDown(mins[i]),
+                                           Convert::RoundUp(maxs[i]));
+    const ElemType width = bounds[i].Width();
+    if (width < minWidth)
+      minWidth = width;
+  }
+
+  return *this;
+}
+
+/**
+ * Expands this region to include a contiguous set of columns of a sparse
+ * matrix.
+ */
+template<int Power, bool TakeRoot, typename ElemType>
+template<typename InputType>
+inline HRectBound<Power, TakeRoot, ElemType>&
+HRectBound<Power, TakeRoot, ElemType>::operator|=(
+    const arma::SpSubview<InputType>& data)
 {
   Log::Assert(data.n_rows == dim);
+  // The subview must span every row of the matrix it views, so that its
+  // nonzeros are reachable through the column iterators of that matrix.
+  // Tree construction hands over whole-row column slices, which satisfy this.
+  Log::Assert(data.n_rows == data.m.n_rows);
+
+  typedef BoundConversion<ElemType, InputType> Convert;
+
+  // As in the SpMat overload: one pass over the nonzeros for the extrema,
+  // counting them so implicit zeros can be detected.
+  arma::Col<InputType> mins(dim);
+  mins.fill(std::numeric_limits<InputType>::max());
+  arma::Col<InputType> maxs(dim);
+  maxs.fill(-std::numeric_limits<InputType>::max());
+  arma::Col<arma::uword> counts(dim);
+  counts.zeros();
+
+  for (size_t col = 0; col < data.n_cols; ++col)
+  {
+    const size_t dataCol = data.aux_col1 + col;
+    for (typename arma::SpMat<InputType>::const_col_iterator it =
+        data.m.begin_col(dataCol); it != data.m.end_col(dataCol); ++it)
+    {
+      const size_t d = it.row();
+      if (*it < mins[d])
+        mins[d] = *it;
+      if (*it > maxs[d])
+        maxs[d] = *it;
+      counts[d]++;
+    }
+  }
 
-  arma::vec mins(min(data, 1));
-  arma::vec maxs(max(data, 1));
+  for (size_t i = 0; i < dim; i++)
+  {
+    if (counts[i] < data.n_cols)
+    {
+      if (mins[i] > 0)
+        mins[i] = 0;
+      if (maxs[i] < 0)
+        maxs[i] = 0;
+    }
+  }
 
-  minWidth = DBL_MAX;
+  minWidth = std::numeric_limits<ElemType>::max();
   for (size_t i = 0; i < dim; i++)
   {
-    bounds[i] |= math::Range(mins[i], maxs[i]);
-    const double width = bounds[i].Width();
+    bounds[i] |= math::RangeType<ElemType>(Convert::RoundDown(mins[i]),
+                                           Convert::RoundUp(maxs[i]));
+    const ElemType width = bounds[i].Width();
     if (width < minWidth)
       minWidth = width;
   }
@@ -370,17 +605,17 @@ inline HRectBound<Power, TakeRoot>& HRectBound<Power, TakeRoot>::operator|=(
 /**
  * Expands this region to encompass another bound.
  */
-template<int Power, bool TakeRoot>
-inline HRectBound<Power, TakeRoot>& HRectBound<Power, TakeRoot>::operator|=(
-    const HRectBound& other)
+template<int Power, bool TakeRoot, typename ElemType>
+inline HRectBound<Power, TakeRoot, ElemType>&
+HRectBound<Power, TakeRoot, ElemType>::operator|=(const HRectBound& other)
 {
   assert(other.dim == dim);
 
-  minWidth = DBL_MAX;
+  minWidth = std::numeric_limits<ElemType>::max();
   for (size_t i = 0; i < dim; i++)
   {
     bounds[i] |= other.bounds[i];
-    const double width = bounds[i].Width();
+    const ElemType width = bounds[i].Width();
     if (width < minWidth)
       minWidth = width;
   }
@@ -391,9 +626,10 @@ inline HRectBound<Power, TakeRoot>& HRectBound<Power, TakeRoot>::operator|=(
 /**
  * Determines if a point is within this bound.
  */
-template<int Power, bool TakeRoot>
+template<int Power, bool TakeRoot, typename ElemType>
 template<typename VecType>
-inline bool HRectBound<Power, TakeRoot>::Contains(const VecType& point) const
+inline bool HRectBound<Power, TakeRoot, ElemType>::Contains(
+    const VecType& point) const
 {
   for (size_t i = 0; i < point.n_elem; i++)
   {
@@ -407,15 +643,15 @@ inline bool HRectBound<Power, TakeRoot>::Contains(const VecType& point) const
 /**
  * Returns the diameter of the hyperrectangle (that is, the longest diagonal).
  */
-template<int Power, bool TakeRoot>
-inline double HRectBound<Power, TakeRoot>::Diameter() const
+template<int Power, bool TakeRoot, typename ElemType>
+inline ElemType HRectBound<Power, TakeRoot, ElemType>::Diameter() const
 {
-  double d = 0;
+  ElemType d = 0;
   for (size_t i = 0; i < dim; ++i)
-    d += std::pow(bounds[i].Hi() - bounds[i].Lo(), (double) Power);
+    d += BoundPow<Power>(bounds[i].Hi() - bounds[i].Lo());
 
   if (TakeRoot)
-    return std::pow(d, 1.0 / (double) Power);
+    return BoundRoot<Power>(d);
   else
     return d;
 }
@@ -423,8 +659,8 @@ inline double HRectBound<Power, TakeRoot>::Diameter() const
 /**
  * Returns a string representation of this object.
  */
-template<int Power, bool TakeRoot>
-std::string HRectBound<Power, TakeRoot>::ToString() const
+template<int Power, bool TakeRoot, typename ElemType>
+std::string HRectBound<Power, TakeRoot, ElemType>::ToString() const
 {
   std::ostringstream convert;
   convert << "HRectBound [" << this << "]" << std::endl;
@@ -0,0 +1,109 @@
+/**
+ * @file morton_order.cpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the Morton-curve dataset reordering utility.
+ */
+#include "morton_order.hpp"
+
+#include <algorithm>
+
+// uint64_t isn't defined on every windows.
+#if defined(_MSC_VER) && (_MSC_VER < 1600)
+  typedef unsigned __int64 uint64_t;
+#else
+  #include <stdint.h> // uint64_t.
+#endif
+
+namespace mlpack {
+namespace tree {
+
+void MortonOrder(const arma::mat& dataset, std::vector<size_t>& oldFromNew)
+{
+  const size_t points = dataset.n_cols;
+
+  // Only as many dimensions as fit one bit each into a 64-bit key can
+  // contribute to the ordering.  The bits are split evenly between the
+  // contributing dimensions (capped so the shifts below stay well-defined
+  // for very low-dimensional data).
+  const size_t keyDims = std::min((size_t) dataset.n_rows, (size_t) 64);
+  size_t bitsPerDim = 64 / keyDims;
+  if (bitsPerDim > 32)
+    bitsPerDim = 32;
+  const uint64_t maxCode = (((uint64_t) 1) << bitsPerDim) - 1;
+
+  // Normalize each contributing dimension over its own range so every
+  // dimension gets the full code range.
+  arma::vec offsets = arma::min(dataset, 1);
+  arma::vec ranges = arma::max(dataset, 1) - offsets;
+
+  // Compute the interleaved key of every point.
+  std::vector<std::pair<uint64_t, size_t> > keys(points);
+
+  #ifdef _OPENMP
+  #pragma omp parallel
+  #endif
+  {
+    // Per-thread workspace for the per-dimension codes of one point.
+    std::vector<uint64_t> codes(keyDims);
+
+    #ifdef _OPENMP
+    #pragma omp for schedule(static)
+    #endif
+    // The loop index is signed for OpenMP.
+    for (long i = 0; i < (long) points; ++i)
+    {
+      for (size_t d = 0; d < keyDims; ++d)
+      {
+        if (ranges[d] > 0.0)
+        {
+          const double t = (dataset(d, i) - offsets[d]) / ranges[d];
+          codes[d] = std::min((uint64_t) (t * (double) maxCode), maxCode);
+        }
+        else
+        {
+          // A constant dimension cannot distinguish any points.
+          codes[d] = 0;
+        }
+      }
+
+      // Interleave the code bits, most significant first, cycling through
+      // the dimensions.
+      uint64_t key = 0;
+      for (size_t b = bitsPerDim; b > 0; --b)
+        for (size_t d = 0; d < keyDims; ++d)
+          key = (key << 1) | ((codes[d] >> (b - 1)) & 1);
+
+      keys[i] = std::make_pair(key, (size_t) i);
+    }
+  }
+
+  // Sorting by key walks the curve; ties (points quantized to the same cell)
+  // keep no particular order, which is fine for a locality heuristic.
+  std::sort(keys.begin(), keys.end());
+
+  oldFromNew.resize(points);
+  for (size_t i = 0; i < points; ++i)
+    oldFromNew[i] = keys[i].second;
+}
+
+void MortonOrder(const arma::mat& dataset,
+                 arma::mat& orderedDataset,
+                 std::vector<size_t>& oldFromNew)
+{
+  MortonOrder(dataset, oldFromNew);
+
+  // Apply the permutation; this is a pure gather, so the columns can be
+  // copied independently.
+  orderedDataset.set_size(dataset.n_rows, dataset.n_cols);
+
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+  #endif
+  // The loop index is signed for OpenMP.
+  for (long i = 0; i < (long) dataset.n_cols; ++i)
+    orderedDataset.col(i) = dataset.col(oldFromNew[i]);
+}
+
+} // namespace tree
+} // namespace mlpack
@@ -0,0 +1,57 @@
+/**
+ * @file morton_order.hpp
+ * @author Ryan Curtin
+ *
+ * Utility to reorder a dataset along a Morton (Z-order) space-filling curve
+ * before building a tree on it.
+ */
+#ifndef __MLPACK_CORE_TREE_MORTON_ORDER_HPP
+#define __MLPACK_CORE_TREE_MORTON_ORDER_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Compute a Morton-curve ordering of the given dataset.  Each point is
+ * quantized to a fixed number of bits per dimension (as many as fit in a
+ * 64-bit key) and the bits are interleaved across dimensions; sorting by the
+ * resulting keys places points that are close in space close in the
+ * ordering.  Reordering a dataset this way before building a
+ * BinarySpaceTree means the points of a leaf -- and of nearby sibling
+ * leaves -- occupy (nearly) contiguous memory, which improves cache behavior
+ * during traversals.
+ *
+ * The permutation is emitted in the same convention as the oldFromNew
+ * mappings produced by the tree constructors: oldFromNew[i] is the index, in
+ * the original dataset, of the point at column i of the reordered dataset.
+ * It can therefore be passed directly to Unmap()-style result translation.
+ *
+ * For datasets with more than 64 dimensions only the first 64 dimensions
+ * contribute one bit each to the key; the remaining dimensions are ignored
+ * for ordering purposes (the reordering is a locality heuristic, so this
+ * only weakens the heuristic, not correctness).
+ *
+ * @param dataset Dataset to compute the ordering of (one point per column).
+ * @param oldFromNew Vector to store the permutation in.
+ */
+void MortonOrder(const arma::mat& dataset, std::vector<size_t>& oldFromNew);
+
+/**
+ * Compute a Morton-curve ordering of the given dataset and apply it, storing
+ * the reordered dataset in orderedDataset.  See the other overload for
+ * details of the ordering and the permutation convention.
+ *
+ * @param dataset Dataset to reorder (one point per column).
+ * @param orderedDataset Matrix to store the reordered dataset in.
+ * @param oldFromNew Vector to store the permutation in.
+ */
+void MortonOrder(const arma::mat& dataset,
+                 arma::mat& orderedDataset,
+                 std::vector<size_t>& oldFromNew);
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file node_arena.hpp
+ *
+ * Definition of NodeArena, a simple slab allocator for tree nodes.  All nodes
+ * of a tree are placed in large contiguous slabs, which improves locality
+ * during traversal and reduces per-node allocation overhead during tree
+ * construction.
+ */
+#ifndef __MLPACK_CORE_TREE_NODE_ARENA_HPP
+#define __MLPACK_CORE_TREE_NODE_ARENA_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A slab allocator for tree nodes.  Memory is handed out in order from large
+ * contiguous slabs, so nodes which are allocated close together in time (which
+ * for recursive tree-building means nodes which are close together in the
+ * tree) are also close together in memory.  Individual nodes cannot be
+ * reclaimed; Destroy() runs the destructor of a node but its memory is only
+ * released when the arena itself is destructed, which frees all slabs at once.
+ *
+ * The arena is owned by the root of the tree that allocates from it, and the
+ * root is responsible for destructing all arena-allocated nodes (via Destroy())
+ * before deleting the arena.
+ *
+ * Allocate() is thread-safe when OpenMP is enabled, so parallel tree
+ * construction may allocate children from concurrent tasks.
+ *
+ * @tparam NodeType The type of tree node to be allocated.
+ */
+template<typename NodeType>
+class NodeArena
+{
+ public:
+  /**
+   * Create an empty arena.  No memory is allocated until the first call to
+   * Allocate().
+   *
+   * @param slabSize Number of nodes each slab can hold.
+   */
+  NodeArena(const size_t slabSize = 1024) :
+      slabSize(slabSize),
+      used(slabSize) // Force allocation of a slab on the first Allocate().
+  {
+#ifdef _OPENMP
+    omp_init_lock(&lock);
+#endif
+  }
+
+  /**
+   * Free all slabs.  This does not run the destructors of any nodes allocated
+   * from this arena; they must be destructed with Destroy() first.
+   */
+  ~NodeArena()
+  {
+    for (size_t i = 0; i < slabs.size(); ++i)
+      delete[] slabs[i];
+#ifdef _OPENMP
+    omp_destroy_lock(&lock);
+#endif
+  }
+
+  /**
+   * Return uninitialized storage for one node.  The caller is expected to
+   * construct a node into the returned memory with placement new.
+   */
+  void* Allocate()
+  {
+#ifdef _OPENMP
+    omp_set_lock(&lock);
+#endif
+    if (used == slabSize)
+    {
+      // The current slab is full (or no slab exists yet); make a new one.
+      slabs.push_back(new char[slabSize * sizeof(NodeType)]);
+      used = 0;
+    }
+
+    void* memory = slabs.back() + (used++) * sizeof(NodeType);
+#ifdef _OPENMP
+    omp_unset_lock(&lock);
+#endif
+    return memory;
+  }
+
+  /**
+   * Run the destructor of a node allocated from this arena.  The node's memory
+   * is not reclaimed until the arena itself is destructed.
+   *
+   * @param node Node to destruct; if NULL, nothing happens.
+   */
+  void Destroy(NodeType* node)
+  {
+    if (node != NULL)
+      node->~NodeType();
+  }
+
+ private:
+  //! The slabs that have been allocated so far.
+  std::vector<char*> slabs;
+  //! The number of nodes each slab can hold.
+  size_t slabSize;
+  //! The number of nodes handed out from the most recent slab.
+  size_t used;
+#ifdef _OPENMP
+  //! Guards Allocate() against concurrent tree-building tasks.
+  omp_lock_t lock;
+#endif
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif // __MLPACK_CORE_TREE_NODE_ARENA_HPP
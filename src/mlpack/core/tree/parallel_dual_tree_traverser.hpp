@@ -0,0 +1,82 @@
+/**
+ * @file parallel_dual_tree_traverser.hpp
+ * @author Ryan Curtin
+ *
+ * Defines the ParallelDualTreeTraverser, a task-parallel wrapper around a
+ * tree's own dual-tree traverser.  The query tree is split into a frontier of
+ * disjoint subtrees, and each subtree is traversed against the whole
+ * reference tree as an independent task, so dual-tree work scales across
+ * cores when OpenMP is available.
+ */
+#ifndef __MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define __MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ParallelDualTreeTraverser runs a dual-tree traversal as a set of
+ * parallel tasks, one per query subtree, using the tree's own
+ * DualTreeTraverser for each task.  The OpenMP task scheduler balances the
+ * tasks across threads; without OpenMP, the traversal simply runs serially.
+ *
+ * Each task operates on a thread-local copy of the rules, so rule-internal
+ * state (traversal information, statistics) is not shared between threads.
+ * For this to be correct, the RuleType must satisfy two conditions beyond the
+ * usual dual-tree rules policy:
+ *
+ *  - results must be written only to locations owned by the query points (or
+ *    query nodes) being traversed, so that disjoint query subtrees write to
+ *    disjoint locations; and
+ *
+ *  - the rules must implement 'void Merge(const RuleType& other)', which
+ *    folds the statistics of a thread-local copy back into this object.  It
+ *    is called once per task, under a lock.
+ *
+ * Note that less pruning may occur than in a strictly serial traversal,
+ * because the frontier subtrees are traversed without first scoring their
+ * ancestors against the reference tree; results are unaffected.
+ *
+ * @tparam TreeType The tree type to traverse; its DualTreeTraverser is used
+ *     for the per-task traversals.
+ * @tparam RuleType The rule set to use (see above for extra requirements).
+ */
+template<typename TreeType, typename RuleType>
+class ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.
+   */
+  ParallelDualTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Get the number of prunes (summed over all tasks).
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+ private:
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The number of prunes, summed over all tasks.
+  size_t numPrunes;
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file parallel_dual_tree_traverser_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the ParallelDualTreeTraverser.
+ */
+#ifndef __MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define __MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+#include <queue>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+
+  //! Number of query subtree tasks to create per thread.  More tasks per
+  //! thread gives the scheduler more freedom to balance uneven subtrees.
+  #define PARALLEL_DUAL_TREE_TASKS_PER_THREAD 4
+#endif
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+ParallelDualTreeTraverser<TreeType, RuleType>::ParallelDualTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void ParallelDualTreeTraverser<TreeType, RuleType>::Traverse(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+#ifdef _OPENMP
+  // Expand a frontier of disjoint query subtrees breadth-first, until there
+  // are enough subtrees to keep every thread busy (or the query tree has no
+  // more structure to expand).
+  const size_t target = (size_t) omp_get_max_threads() *
+      PARALLEL_DUAL_TREE_TASKS_PER_THREAD;
+
+  std::vector<TreeType*> frontier;
+  std::queue<TreeType*> expansion;
+  expansion.push(&queryNode);
+  while (!expansion.empty())
+  {
+    if (expansion.size() + frontier.size() >= target)
+      break;
+
+    TreeType* node = expansion.front();
+    expansion.pop();
+
+    if (node->NumChildren() == 0)
+      frontier.push_back(node);
+    else
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+        expansion.push(&node->Child(i));
+  }
+  while (!expansion.empty())
+  {
+    frontier.push_back(expansion.front());
+    expansion.pop();
+  }
+
+  // If the query tree did not yield more than one subtree, there is nothing
+  // to parallelize.
+  if (frontier.size() <= 1)
+  {
+    typename TreeType::template DualTreeTraverser<RuleType> traverser(rule);
+    traverser.Traverse(queryNode, referenceNode);
+    numPrunes += traverser.NumPrunes();
+    return;
+  }
+
+  #pragma omp parallel
+  {
+    #pragma omp single
+    {
+      for (size_t i = 0; i < frontier.size(); ++i)
+      {
+        #pragma omp task default(shared) firstprivate(i)
+        {
+          // Each task traverses its query subtree against the whole reference
+          // tree with a thread-local copy of the rules, so rule-internal
+          // state is not shared; results are written to disjoint query
+          // points.
+          RuleType localRule(rule);
+          typename TreeType::template DualTreeTraverser<RuleType>
+              traverser(localRule);
+          traverser.Traverse(*frontier[i], referenceNode);
+
+          #pragma omp critical (parallelDualTreeTraverserMerge)
+          {
+            rule.Merge(localRule);
+            numPrunes += traverser.NumPrunes();
+          }
+        }
+      }
+    }
+  }
+#else
+  // Without OpenMP, simply run the underlying serial traversal.
+  typename TreeType::template DualTreeTraverser<RuleType> traverser(rule);
+  traverser.Traverse(queryNode, referenceNode);
+  numPrunes += traverser.NumPrunes();
+#endif
+}
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif
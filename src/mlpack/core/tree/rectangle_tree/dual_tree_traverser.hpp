@@ -10,6 +10,7 @@
 #define __MLPACK_CORE_TREE_RECTANGLE_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "rectangle_tree.hpp"
 
@@ -60,6 +61,12 @@ class RectangleTree<SplitType, DescentType, StatisticType, MatType>::
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
+
  private:
    
   //We use this struct and this function to make the sorting and scoring easy and efficient:
@@ -91,6 +98,12 @@ class RectangleTree<SplitType, DescentType, StatisticType, MatType>::
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
+
+  //! The current depth of the recursion, for the statistics.
+  size_t depth;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
@@ -28,7 +28,8 @@ DualTreeTraverser<RuleType>::DualTreeTraverser(RuleType& rule) :
     numPrunes(0),
     numVisited(0),
     numScores(0),
-    numBaseCases(0)
+    numBaseCases(0),
+    depth(0)
 { /* Nothing to do */ }
 
 template<typename SplitType,
@@ -43,6 +44,8 @@ DualTreeTraverser<RuleType>::Traverse(
 {
   // Increment the visit counter.
   ++numVisited;
+  stats.Visit(depth);
+  ++depth;
 
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
@@ -71,6 +74,7 @@ DualTreeTraverser<RuleType>::Traverse(
         rule.BaseCase(queryNode.Points()[query], referenceNode.Points()[ref]);
 
       numBaseCases += referenceNode.Count();
+      stats.BaseCase(referenceNode.Count());
     }
   }
   else if(!queryNode.IsLeaf() && referenceNode.IsLeaf())
@@ -81,10 +85,14 @@ DualTreeTraverser<RuleType>::Traverse(
       // Before recursing, we have to set the traversal information correctly.
       rule.TraversalInfo() = traversalInfo;
       ++numScores;
+      stats.Score();
       if(rule.Score(queryNode.Child(i), referenceNode) < DBL_MAX)
         Traverse(queryNode.Child(i), referenceNode);
       else
+      {
         numPrunes++;
+        stats.Prune();
+      }
     }
   }
   else if(queryNode.IsLeaf() && !referenceNode.IsLeaf())
@@ -102,6 +110,7 @@ DualTreeTraverser<RuleType>::Traverse(
     }
     std::sort(nodesAndScores.begin(), nodesAndScores.end(), nodeComparator);
     numScores += nodesAndScores.size();
+    stats.Score(nodesAndScores.size());
 
     for (size_t i = 0; i < nodesAndScores.size(); i++)
     {
@@ -110,6 +119,7 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(queryNode, *(nodesAndScores[i].node));
       } else {
         numPrunes += nodesAndScores.size() - i;
+        stats.Prune(nodesAndScores.size() - i);
         break;
       }
     }
@@ -133,6 +143,7 @@ DualTreeTraverser<RuleType>::Traverse(
       }
       std::sort(nodesAndScores.begin(), nodesAndScores.end(), nodeComparator);
       numScores += nodesAndScores.size();
+      stats.Score(nodesAndScores.size());
 
       for (size_t i = 0; i < nodesAndScores.size(); i++)
       {
@@ -141,11 +152,14 @@ DualTreeTraverser<RuleType>::Traverse(
           Traverse(queryNode.Child(j), *(nodesAndScores[i].node));
         } else {
           numPrunes += nodesAndScores.size() - i;
+          stats.Prune(nodesAndScores.size() - i);
           break;
         }
       }
     }
   }
+
+  --depth;
 }
 
 }; // namespace tree
@@ -1 +1,83 @@
- 
+/**
+ * @file hilbert_r_tree_split.hpp
+ * @author Andrew Wells
+ *
+ * Defintion of the HilbertRTreeSplit class, a class that splits the nodes of
+ * an R tree along the Hilbert curve, starting at a leaf node and moving
+ * upwards if necessary.
+ */
+#ifndef __MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_R_TREE_SPLIT_HPP
+#define __MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_R_TREE_SPLIT_HPP
+
+#include <mlpack/core.hpp>
+
+// uint64_t isn't defined on every windows.
+#if defined(_MSC_VER) && (_MSC_VER < 1600)
+  typedef unsigned __int64 uint64_t;
+#else
+  #include <stdint.h> // uint64_t.
+#endif
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The Hilbert R-tree split orders the contents of an overflowing node by
+ * their position along a Hilbert space-filling curve and cuts the ordering in
+ * half, instead of searching for a minimum-volume partition as the Guttman
+ * split does.  This makes splits cheap -- one sort of at most
+ * maxLeafSize + 1 (or maxNumChildren + 1) cached keys -- while the locality
+ * of the curve keeps the resulting bounds reasonably tight.
+ *
+ * The Hilbert value of each point is computed at most once, the first time
+ * the point participates in a split, and cached in the HilbertValue
+ * calculator stored on the root of the tree (see HilbertValue); later splits
+ * only merge cached keys.  The quantization frame of the calculator is fixed
+ * from the dataset the first time a split occurs.
+ */
+template<typename DescentType,
+         typename StatisticType,
+         typename MatType>
+class HilbertRTreeSplit
+{
+ public:
+  // Convenience typedef to keep lines from being 1000 characters long.
+  typedef RectangleTree<HilbertRTreeSplit, DescentType, StatisticType, MatType>
+      TreeType;
+
+  /**
+   * Split a leaf node, ordering its points by cached Hilbert value.  If
+   * necessary, this split will propagate upwards through the tree.
+   */
+  static void SplitLeafNode(TreeType* tree,
+                            std::vector<bool>& relevels);
+
+  /**
+   * Split a non-leaf node, ordering its children by the Hilbert value of
+   * their bound centroids.  If this is a root node, the tree increases in
+   * depth.
+   */
+  static bool SplitNonLeafNode(TreeType* tree,
+                               std::vector<bool>& relevels);
+
+ private:
+  /**
+   * Get the Hilbert value calculator of the root of the tree containing the
+   * given node, initializing its quantization frame from the dataset if this
+   * is the first split.
+   */
+  static HilbertValue& RootValues(TreeType* tree);
+
+  /**
+   * Insert a node into another node.
+   */
+  static void InsertNodeIntoTree(TreeType* destTree, TreeType* srcNode);
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+// Include implementation
+#include "hilbert_r_tree_split_impl.hpp"
+
+#endif
@@ -1 +1,225 @@
- 
+/**
+ * @file hilbert_r_tree_split_impl.hpp
+ * @author Andrew Wells
+ *
+ * Implementation of class (HilbertRTreeSplit) to split a RectangleTree.
+ */
+#ifndef __MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_R_TREE_SPLIT_IMPL_HPP
+#define __MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_R_TREE_SPLIT_IMPL_HPP
+
+#include "hilbert_r_tree_split.hpp"
+#include "rectangle_tree.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * We order the points of the overflowing leaf by their cached Hilbert values
+ * and cut the ordering in half, then delete the old node and insert the new
+ * nodes into the tree, splitting the parent if necessary.  The Hilbert value
+ * of each point is computed at most once, the first time the point
+ * participates in a split; afterwards the cached value is reused.
+ */
+template<typename DescentType,
+         typename StatisticType,
+         typename MatType>
+void HilbertRTreeSplit<DescentType, StatisticType, MatType>::SplitLeafNode(
+    TreeType* tree,
+    std::vector<bool>& relevels)
+{
+  // If we are splitting the root node, we need will do things differently so
+  // that the constructor and other methods don't confuse the end user by
+  // giving an address of another node.
+  if (tree->Parent() == NULL)
+  {
+    // We actually want to copy this way.  Pointers and everything.
+    TreeType* copy = new TreeType(*tree, false);
+    copy->Parent() = tree;
+    tree->Count() = 0;
+    tree->NullifyData();
+    // Because this was a leaf node, numChildren must be 0.
+    tree->Children()[(tree->NumChildren())++] = copy;
+    SplitLeafNode(copy, relevels);
+    return;
+  }
+
+  assert(tree->Parent()->NumChildren() <= tree->Parent()->MaxNumChildren());
+
+  HilbertValue& hilbert = RootValues(tree);
+
+  // Order the points by Hilbert value; only points that have never been split
+  // before actually have their value computed here.
+  const size_t count = tree->Count();
+  std::vector<std::pair<uint64_t, size_t> > keys(count);
+  for (size_t i = 0; i < count; i++)
+    keys[i] = std::make_pair(
+        hilbert.CachedValue(tree->Dataset(), tree->Points()[i]), i);
+  std::sort(keys.begin(), keys.end());
+
+  TreeType* treeOne = new TreeType(tree->Parent());
+  TreeType* treeTwo = new TreeType(tree->Parent());
+
+  // Cut the Hilbert ordering in half; each half is a contiguous run of the
+  // curve, so both bounds stay compact without any volume search.
+  const size_t half = count / 2;
+  for (size_t i = 0; i < half; i++)
+    treeOne->InsertPoint(tree->Points()[keys[i].second]);
+  for (size_t i = half; i < count; i++)
+    treeTwo->InsertPoint(tree->Points()[keys[i].second]);
+
+  // Remove this node and insert treeOne and treeTwo.
+  TreeType* par = tree->Parent();
+  size_t index = 0;
+  while (par->Children()[index] != tree) { ++index; }
+
+  par->Children()[index] = treeOne;
+  par->Children()[par->NumChildren()++] = treeTwo;
+
+  // We only add one at a time, so we should only need to test for equality
+  // just in case, we use an assert.
+  assert(par->NumChildren() <= par->MaxNumChildren() + 1);
+  if (par->NumChildren() == par->MaxNumChildren() + 1)
+    SplitNonLeafNode(par, relevels);
+
+  assert(treeOne->Parent()->NumChildren() <= treeOne->MaxNumChildren());
+  assert(treeOne->Parent()->NumChildren() >= treeOne->MinNumChildren());
+  assert(treeTwo->Parent()->NumChildren() <= treeTwo->MaxNumChildren());
+  assert(treeTwo->Parent()->NumChildren() >= treeTwo->MinNumChildren());
+
+  // We need to delete this carefully since references to points are used.
+  tree->SoftDelete();
+}
+
+/**
+ * We order the children of the overflowing node by the Hilbert value of their
+ * bound centroids and cut the ordering in half.  Then we delete the now
+ * unused information and recurse up the tree if necessary.  We don't need to
+ * worry about the bounds higher up the tree because they were already updated
+ * if necessary.
+ */
+template<typename DescentType,
+         typename StatisticType,
+         typename MatType>
+bool HilbertRTreeSplit<DescentType, StatisticType, MatType>::SplitNonLeafNode(
+    TreeType* tree,
+    std::vector<bool>& relevels)
+{
+  // If we are splitting the root node, we need will do things differently so
+  // that the constructor and other methods don't confuse the end user by
+  // giving an address of another node.
+  if (tree->Parent() == NULL)
+  {
+    // We actually want to copy this way.  Pointers and everything.
+    TreeType* copy = new TreeType(*tree, false);
+    copy->Parent() = tree;
+    tree->NumChildren() = 0;
+    tree->NullifyData();
+    tree->Children()[(tree->NumChildren())++] = copy;
+    SplitNonLeafNode(copy, relevels);
+    return true;
+  }
+
+  HilbertValue& hilbert = RootValues(tree);
+
+  // Order the children by the Hilbert value of their bound centroids.  The
+  // centroids move as the bounds grow, so these values are not cached; there
+  // are only at most maxNumChildren + 1 of them per split, so this is cheap.
+  const size_t numChildren = tree->NumChildren();
+  std::vector<std::pair<uint64_t, size_t> > keys(numChildren);
+  arma::vec centroid;
+  for (size_t i = 0; i < numChildren; i++)
+  {
+    tree->Children()[i]->Bound().Centroid(centroid);
+    keys[i] = std::make_pair(hilbert.Value(centroid), i);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  TreeType* treeOne = new TreeType(tree->Parent());
+  TreeType* treeTwo = new TreeType(tree->Parent());
+
+  // Cut the Hilbert ordering in half.
+  const size_t half = numChildren / 2;
+  for (size_t i = 0; i < half; i++)
+    InsertNodeIntoTree(treeOne, tree->Children()[keys[i].second]);
+  for (size_t i = half; i < numChildren; i++)
+    InsertNodeIntoTree(treeTwo, tree->Children()[keys[i].second]);
+
+  // Remove this node and insert treeOne and treeTwo.
+  TreeType* par = tree->Parent();
+  size_t index = 0;
+  while (par->Children()[index] != tree) { ++index; }
+
+  assert(index != par->NumChildren());
+  par->Children()[index] = treeOne;
+  par->Children()[par->NumChildren()++] = treeTwo;
+
+  // We only add one at a time, so should only need to test for equality just
+  // in case, we use an assert.
+  assert(par->NumChildren() <= par->MaxNumChildren() + 1);
+
+  if (par->NumChildren() == par->MaxNumChildren() + 1)
+    SplitNonLeafNode(par, relevels);
+
+  // We have to update the children of each of these new nodes so that they
+  // record the correct parent.
+  for (size_t i = 0; i < treeOne->NumChildren(); i++)
+    treeOne->Children()[i]->Parent() = treeOne;
+
+  for (size_t i = 0; i < treeTwo->NumChildren(); i++)
+    treeTwo->Children()[i]->Parent() = treeTwo;
+
+  assert(treeOne->NumChildren() <= treeOne->MaxNumChildren());
+  assert(treeTwo->NumChildren() <= treeTwo->MaxNumChildren());
+  assert(treeOne->Parent()->NumChildren() <= treeOne->MaxNumChildren());
+
+  // Because we now have pointers to the information stored under this tree,
+  // we need to delete this node carefully.
+  tree->SoftDelete(); // Currently does nothing but leak memory.
+
+  return false;
+}
+
+/**
+ * Walk up to the root of the tree containing the given node and return its
+ * Hilbert value calculator, fixing the quantization frame from the dataset if
+ * this is the first split.  The root always remains the same object across
+ * splits (root splits copy the root's contents into a new child), so the
+ * cache survives for the life of the tree; and because deleted points stay in
+ * the dataset, cached values can never go stale.
+ */
+template<typename DescentType,
+         typename StatisticType,
+         typename MatType>
+HilbertValue& HilbertRTreeSplit<DescentType, StatisticType, MatType>::
+RootValues(TreeType* tree)
+{
+  TreeType* root = tree;
+  while (root->Parent() != NULL)
+    root = root->Parent();
+
+  if (!root->HilbertValues().Initialized())
+    root->HilbertValues().InitFrame(root->Dataset());
+
+  return root->HilbertValues();
+}
+
+/**
+ * Insert a node into another node.  Expanding the bounds and updating the
+ * numberOfChildren.
+ */
+template<typename DescentType,
+         typename StatisticType,
+         typename MatType>
+void HilbertRTreeSplit<DescentType, StatisticType, MatType>::
+InsertNodeIntoTree(TreeType* destTree, TreeType* srcNode)
+{
+  destTree->Bound() |= srcNode->Bound();
+  destTree->Children()[destTree->NumChildren()++] = srcNode;
+}
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif
@@ -10,6 +10,7 @@
 
 #include <mlpack/core.hpp>
 
+#include "../hilbert_value.hpp"
 #include "../hrectbound.hpp"
 #include "../statistic.hpp"
 
@@ -97,6 +98,14 @@ class RectangleTree
   std::vector<size_t> points;
   //! The local dataset
   MatType* localDataset;
+  //! Points buffered for insertion (used on the root; see BufferInsert()).
+  std::vector<size_t> insertBuffer;
+  //! Number of points to buffer before flushing (0 disables buffering).
+  size_t insertBufferCapacity;
+  //! A Hilbert value calculator for Hilbert R-tree splits.  As with the split
+  //! history for X trees, this exists only to support one split type; the
+  //! Hilbert split uses the root's calculator and leaves all others empty.
+  HilbertValue hilbertValue;
 
  public:
   //! So other classes can use TreeType::Mat.
@@ -131,6 +140,40 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Build a rectangle type tree on the given dataset by bulk-loading the
+   * points with the Sort-Tile-Recursive (STR) packing algorithm, instead of
+   * inserting them one at a time.  The points are sorted along one dimension
+   * (cycling through the dimensions as the recursion deepens) and partitioned
+   * into contiguous tiles, one per child, so the tree is built in a single
+   * O(n log n) pass with full nodes and no splitting or reinsertion.  The
+   * resulting tree is generally tighter than an insertion-built tree, but
+   * because the nodes are packed, subsequent InsertPoint() calls will cause
+   * more splits than they would on an insertion-built tree; bulk-loading is
+   * meant for static datasets.  Unlike the insertion-based constructor, the
+   * ordering of the points in the dataset is not modified.
+   *
+   * The tree is returned as a pointer (the caller is responsible for deleting
+   * it); a constructor overload taking a bulk-load flag would be ambiguous
+   * with the insertion-based constructor for integer literal arguments.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node
+   *      may have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node
+   *      may have.
+   * @param firstDataIndex The index of the first data point.
+   * @return Pointer to the newly-built tree; the caller must delete it.
+   */
+  static RectangleTree* BulkLoad(MatType& data,
+                                 const size_t maxLeafSize = 20,
+                                 const size_t minLeafSize = 8,
+                                 const size_t maxNumChildren = 5,
+                                 const size_t minNumChildren = 2,
+                                 const size_t firstDataIndex = 0);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -191,6 +234,37 @@ class RectangleTree
    */
   void InsertPoint(const size_t point, std::vector<bool>& relevels);
 
+  /**
+   * Insert a batch of points in one pass.  The batch is reordered along a
+   * Morton curve before insertion, so consecutive insertions descend to
+   * nearby leaves, and one relevel vector is shared by the whole batch, so
+   * forced reinsertion (for split types that use it, like the R* tree) runs
+   * at most once per level per batch instead of at most once per level per
+   * point.  This amortizes split and reinsertion work across the batch,
+   * which makes it much faster than calling InsertPoint() per point on
+   * sustained insert streams.  Call this on the root of the tree.
+   *
+   * @param pointIndices Indices (in the dataset) of the points to insert.
+   */
+  void InsertPoints(const std::vector<size_t>& pointIndices);
+
+  /**
+   * Buffer a point for insertion.  If the insert buffer capacity (settable
+   * with InsertBufferCapacity()) is zero, the point is inserted immediately;
+   * otherwise it is appended to the insert buffer, which is flushed with
+   * InsertPoints() when it reaches capacity.  Buffered points are not
+   * visible to queries until they are flushed, so call FlushInserts()
+   * before searching the tree.  Call this on the root of the tree.
+   *
+   * @param point Index (in the dataset) of the point to insert.
+   */
+  void BufferInsert(const size_t point);
+
+  /**
+   * Insert any points currently held in the insert buffer.
+   */
+  void FlushInserts();
+
   /**
    * Inserts a node into the tree, tracking which levels have been inserted
    * into.  The node will be inserted so that the tree remains valid.
@@ -274,6 +348,11 @@ class RectangleTree
   //! Modify the split history object of this node.
   SplitHistoryStruct& SplitHistory() { return splitHistory; }
 
+  //! Return the Hilbert value calculator of this node (for Hilbert R-trees).
+  const HilbertValue& HilbertValues() const { return hilbertValue; }
+  //! Modify the Hilbert value calculator of this node (for Hilbert R-trees).
+  HilbertValue& HilbertValues() { return hilbertValue; }
+
   //! Return whether or not this node is a leaf (true if it has no children).
   bool IsLeaf() const;
 
@@ -297,6 +376,13 @@ class RectangleTree
   //! Modify the minimum number of children (in a non-leaf node).
   size_t& MinNumChildren() { return minNumChildren; }
 
+  //! Return the insert buffer capacity (0 if buffered insertion is disabled).
+  size_t InsertBufferCapacity() const { return insertBufferCapacity; }
+  //! Modify the insert buffer capacity (0 disables buffered insertion).
+  size_t& InsertBufferCapacity() { return insertBufferCapacity; }
+  //! Return the number of points currently buffered for insertion.
+  size_t InsertBufferSize() const { return insertBuffer.size(); }
+
   //! Gets the parent of this node.
   RectangleTree* Parent() const { return parent; }
   //! Modify the parent of this node.
@@ -509,6 +595,45 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Comparator to order point indices by a single dimension of the dataset.
+   * Used by the STR bulk-loading code (see BulkLoad() and PackRange()).
+   */
+  struct PointDimComparator
+  {
+    //! The dataset the indices refer to.
+    const MatType& data;
+    //! The dimension to compare on.
+    const size_t dim;
+
+    PointDimComparator(const MatType& data, const size_t dim) :
+        data(data), dim(dim) { }
+
+    bool operator()(const size_t a, const size_t b) const
+    {
+      return data(dim, a) < data(dim, b);
+    }
+  };
+
+  /**
+   * Fill this (empty) node with the points indices[packBegin] through
+   * indices[packEnd - 1], recursively packing children with the STR
+   * algorithm.  If the range fits in a leaf, the points are copied in
+   * directly; otherwise, the range is sorted along one dimension and split
+   * into contiguous tiles, and a child is packed from each tile.  This is the
+   * recursive step of BulkLoad(), and should not be called on a node that
+   * already holds points or children.
+   *
+   * @param indices Vector of point indices; the given range will be sorted.
+   * @param packBegin First position in indices to pack into this node.
+   * @param packEnd One past the last position in indices to pack.
+   * @param depth Depth of this node in the tree; selects the sort dimension.
+   */
+  void PackRange(std::vector<size_t>& indices,
+                 const size_t packBegin,
+                 const size_t packEnd,
+                 const size_t depth);
+
  public:
   /**
    * Condense the bounding rectangles for this node based on the removal of the
@@ -14,6 +14,8 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/string_util.hpp>
 
+#include "../morton_order.hpp"
+
 namespace mlpack {
 namespace tree {
 
@@ -42,7 +44,8 @@ RectangleTree<SplitType, DescentType, StatisticType, MatType>::RectangleTree(
     parentDistance(0),
     dataset(data),
     points(maxLeafSize + 1), // Add one to make splitting the node simpler.
-    localDataset(new MatType(data.n_rows, static_cast<int> (maxLeafSize) + 1))
+    localDataset(new MatType(data.n_rows, static_cast<int> (maxLeafSize) + 1)),
+    insertBufferCapacity(0)
 {
   stat = StatisticType(*this);
 
@@ -53,6 +56,86 @@ RectangleTree<SplitType, DescentType, StatisticType, MatType>::RectangleTree(
     root->InsertPoint(i);
 }
 
+template<typename SplitType,
+         typename DescentType,
+         typename StatisticType,
+         typename MatType>
+RectangleTree<SplitType, DescentType, StatisticType, MatType>*
+RectangleTree<SplitType, DescentType, StatisticType, MatType>::BulkLoad(
+    MatType& data,
+    const size_t maxLeafSize,
+    const size_t minLeafSize,
+    const size_t maxNumChildren,
+    const size_t minNumChildren,
+    const size_t firstDataIndex)
+{
+  // Create an empty root with the right parameters by starting the insertion
+  // constructor past the end of the dataset (so it inserts nothing), then
+  // pack the points in with STR.
+  RectangleTree* root = new RectangleTree(data, maxLeafSize, minLeafSize,
+      maxNumChildren, minNumChildren, data.n_cols);
+
+  std::vector<size_t> indices(data.n_cols - firstDataIndex);
+  for (size_t i = 0; i < indices.size(); i++)
+    indices[i] = firstDataIndex + i;
+
+  root->PackRange(indices, 0, indices.size(), 0);
+
+  return root;
+}
+
+template<typename SplitType,
+         typename DescentType,
+         typename StatisticType,
+         typename MatType>
+void RectangleTree<SplitType, DescentType, StatisticType, MatType>::PackRange(
+    std::vector<size_t>& indices,
+    const size_t packBegin,
+    const size_t packEnd,
+    const size_t depth)
+{
+  const size_t rangeSize = packEnd - packBegin;
+
+  // If the range fits in a leaf, copy the points in directly.
+  if (rangeSize <= maxLeafSize)
+  {
+    for (size_t i = packBegin; i < packEnd; i++)
+    {
+      localDataset->col(count) = dataset.col(indices[i]);
+      points[count++] = indices[i];
+      bound |= dataset.col(indices[i]);
+    }
+
+    return;
+  }
+
+  // Sort the range along one dimension, cycling through the dimensions as the
+  // recursion deepens (this is the sort-tile step of STR).
+  std::sort(indices.begin() + packBegin, indices.begin() + packEnd,
+      PointDimComparator(dataset, depth % bound.Dim()));
+
+  // Use no more children than are needed to keep the leaves full, up to the
+  // fanout of the tree.
+  size_t fanout = (rangeSize + maxLeafSize - 1) / maxLeafSize;
+  if (fanout > maxNumChildren)
+    fanout = maxNumChildren;
+
+  // Split the sorted range into nearly equal contiguous tiles and pack a
+  // child from each tile.  Note that internal nodes hold no points, so count
+  // stays 0 here (matching the insertion-based construction).
+  for (size_t i = 0; i < fanout; i++)
+  {
+    const size_t tileBegin = packBegin + (i * rangeSize) / fanout;
+    const size_t tileEnd = packBegin + ((i + 1) * rangeSize) / fanout;
+
+    RectangleTree* child = new RectangleTree(this);
+    child->PackRange(indices, tileBegin, tileEnd, depth + 1);
+
+    children[numChildren++] = child;
+    bound |= child->Bound();
+  }
+}
+
 template<typename SplitType,
          typename DescentType,
          typename StatisticType,
@@ -74,7 +157,8 @@ RectangleTree<SplitType, DescentType, StatisticType, MatType>::RectangleTree(
     dataset(parentNode->Dataset()),
     points(maxLeafSize + 1), // Add one to make splitting the node simpler.
     localDataset(new MatType(static_cast<int> (parentNode->Bound().Dim()),
-                             static_cast<int> (maxLeafSize) + 1))
+                             static_cast<int> (maxLeafSize) + 1)),
+    insertBufferCapacity(0)
 {
   stat = StatisticType(*this);
 }
@@ -104,7 +188,8 @@ RectangleTree<SplitType, DescentType, StatisticType, MatType>::RectangleTree(
     parentDistance(other.ParentDistance()),
     dataset(other.dataset),
     points(other.Points()),
-    localDataset(NULL)
+    localDataset(NULL),
+    insertBufferCapacity(other.insertBufferCapacity)
 {
   if (deepCopy)
   {
@@ -244,6 +329,87 @@ void RectangleTree<SplitType, DescentType, StatisticType, MatType>::InsertPoint(
   children[descentNode]->InsertPoint(point, relevels);
 }
 
+/**
+ * Insert a batch of points in one pass, with split and reinsertion work
+ * amortized across the batch.
+ */
+template<typename SplitType,
+         typename DescentType,
+         typename StatisticType,
+         typename MatType>
+void RectangleTree<SplitType, DescentType, StatisticType, MatType>::
+    InsertPoints(const std::vector<size_t>& pointIndices)
+{
+  if (pointIndices.empty())
+    return;
+
+  // Reorder the batch along a Morton curve, so consecutive insertions descend
+  // to nearby (often the same) leaves; this keeps the descent path warm in
+  // cache and groups the splits a batch causes together.
+  arma::mat batch(dataset.n_rows, pointIndices.size());
+  for (size_t i = 0; i < pointIndices.size(); i++)
+    batch.col(i) = dataset.col(pointIndices[i]);
+
+  std::vector<size_t> order;
+  MortonOrder(batch, order);
+
+  // One relevel vector is shared by the whole batch, so forced reinsertion
+  // (for split types that use it) runs at most once per level per batch
+  // instead of at most once per level per point.
+  std::vector<bool> relevels(TreeDepth(), true);
+
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    // The tree may have grown since the last insertion; levels created during
+    // the batch are still eligible for reinsertion.
+    if (TreeDepth() > relevels.size())
+      relevels.resize(TreeDepth(), true);
+
+    InsertPoint(pointIndices[order[i]], relevels);
+  }
+}
+
+/**
+ * Buffer a point for insertion, flushing the buffer as a batch when it
+ * reaches capacity.
+ */
+template<typename SplitType,
+         typename DescentType,
+         typename StatisticType,
+         typename MatType>
+void RectangleTree<SplitType, DescentType, StatisticType, MatType>::
+    BufferInsert(const size_t point)
+{
+  if (insertBufferCapacity == 0)
+  {
+    // Buffering is disabled; insert immediately.
+    InsertPoint(point);
+    return;
+  }
+
+  insertBuffer.push_back(point);
+  if (insertBuffer.size() >= insertBufferCapacity)
+    FlushInserts();
+}
+
+/**
+ * Insert any points currently held in the insert buffer.
+ */
+template<typename SplitType,
+         typename DescentType,
+         typename StatisticType,
+         typename MatType>
+void RectangleTree<SplitType, DescentType, StatisticType, MatType>::
+    FlushInserts()
+{
+  if (insertBuffer.empty())
+    return;
+
+  std::vector<size_t> batch;
+  batch.swap(insertBuffer);
+  InsertPoints(batch);
+}
+
 /**
  * Inserts a node into the tree, tracking which levels have been inserted into.
  *
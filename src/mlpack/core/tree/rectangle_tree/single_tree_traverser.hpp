@@ -10,6 +10,7 @@
 #define __MLPACK_CORE_TREE_RECTANGLE_TREE_SINGLE_TREE_TRAVERSER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "rectangle_tree.hpp"
 
@@ -44,8 +45,14 @@ class RectangleTree<SplitType, DescentType, StatisticType, MatType>::
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the traversal statistics (a no-op object unless
+  //! MLPACK_TRAVERSAL_STATISTICS is defined).
+  const TraversalStatistics& Statistics() const { return stats; }
+  //! Modify the traversal statistics.
+  TraversalStatistics& Statistics() { return stats; }
+
  private:
-  
+
   // We use this class and this function to make the sorting and scoring easy
   // and efficient:
   class NodeAndScore {
@@ -64,6 +71,12 @@ class RectangleTree<SplitType, DescentType, StatisticType, MatType>::
 
   //! The number of nodes which have been prenud during traversal.
   size_t numPrunes;
+
+  //! Statistics about the traversal.
+  TraversalStatistics stats;
+
+  //! The current depth of the recursion, for the statistics.
+  size_t depth;
 };
 
 }; // namespace tree
@@ -25,7 +25,8 @@ template<typename RuleType>
 RectangleTree<SplitType, DescentType, StatisticType, MatType>::
 SingleTreeTraverser<RuleType>::SingleTreeTraverser(RuleType& rule) :
     rule(rule),
-    numPrunes(0)
+    numPrunes(0),
+    depth(0)
 { /* Nothing to do */ }
 
 template<typename SplitType,
@@ -39,6 +40,7 @@ SingleTreeTraverser<RuleType>::Traverse(
     const RectangleTree<SplitType, DescentType, StatisticType, MatType>&
         referenceNode)
 {
+  stats.Visit(depth);
 
   // If we reach a leaf node, we need to run the base case.
   if (referenceNode.IsLeaf())
@@ -46,6 +48,7 @@ SingleTreeTraverser<RuleType>::Traverse(
     for (size_t i = 0; i < referenceNode.Count(); i++)
       rule.BaseCase(queryIndex, referenceNode.Points()[i]);
 
+    stats.BaseCase(referenceNode.Count());
     return;
   }
 
@@ -59,6 +62,7 @@ SingleTreeTraverser<RuleType>::Traverse(
   }
 
   std::sort(nodesAndScores.begin(), nodesAndScores.end(), NodeComparator);
+  stats.Score(referenceNode.NumChildren());
 
   // Now iterate through them starting with the best and stopping when we reach
   // one that isn't good enough.
@@ -67,11 +71,14 @@ SingleTreeTraverser<RuleType>::Traverse(
     if (rule.Rescore(queryIndex, *nodesAndScores[i].node,
         nodesAndScores[i].score) != DBL_MAX)
     {
+      ++depth;
       Traverse(queryIndex, *nodesAndScores[i].node);
+      --depth;
     }
     else
     {
       numPrunes += referenceNode.NumChildren() - i;
+      stats.Prune(referenceNode.NumChildren() - i);
       return;
     }
   }
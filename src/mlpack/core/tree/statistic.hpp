@@ -44,6 +44,32 @@ class EmptyStatistic
     }
 };
 
+/**
+ * The StatisticTraits class provides compile-time information about a
+ * statistic type, in the same way that TreeTraits does for trees.  The
+ * default values here are the safe ones; specialize this class for your own
+ * statistic type to change them.
+ */
+template<typename StatisticType>
+class StatisticTraits
+{
+ public:
+  /**
+   * If true, the statistic is not constructed for every node during tree
+   * building; instead, each node builds its statistic on the first call to
+   * Stat().  This saves build time and touches less memory for workloads
+   * that only ever visit a small fraction of the tree, at the cost of a flag
+   * check on every Stat() access.  Only enable this for statistics whose
+   * node constructor depends on nothing but the finished node (and, through
+   * Stat(), its children) -- which is also what the eager construction order
+   * guarantees.
+   *
+   * Currently only BinarySpaceTree honors this trait; other tree types build
+   * their statistics eagerly regardless.
+   */
+  static const bool BuildLazily = false;
+};
+
 }; // namespace tree
 }; // namespace mlpack
 
@@ -0,0 +1,169 @@
+/**
+ * @file traversal_statistics.hpp
+ * @author Ryan Curtin
+ *
+ * Definition of the TraversalStatistics class, a uniform instrumentation
+ * surface for tree traversers.  Every traverser holds one of these objects and
+ * reports base case evaluations, scores, prunes, and node visits to it; the
+ * object additionally tracks the maximum depth reached and the number of
+ * visits at each level of the traversal.
+ *
+ * Because this bookkeeping is not free and is only interesting when tuning a
+ * tree type for a particular dataset, it is compiled out by default.  Define
+ * MLPACK_TRAVERSAL_STATISTICS at configuration time to enable it; when it is
+ * not defined, every member function is an empty inline function and the
+ * instrumentation calls in the traversers cost nothing.  The per-traverser
+ * counters (NumPrunes() and friends) are unaffected by this macro.
+ */
+#ifndef __MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define __MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A collection of statistics about a tree traversal, collected by the
+ * traverser itself as it runs.  The statistics accumulate across calls to
+ * Traverse(), in the same way the traversers' own counters do; call Reset()
+ * to start a fresh measurement.
+ *
+ * The Report() method prints the collected statistics through Log::Info in
+ * the same style Timers uses for timer reporting, so a typical use is
+ *
+ * @code
+ * traverser.Statistics().Report("reference tree traversal");
+ * @endcode
+ *
+ * after the traversal completes.  If MLPACK_TRAVERSAL_STATISTICS is not
+ * defined, Report() prints nothing and the whole class is a no-op.
+ */
+class TraversalStatistics
+{
+ public:
+#ifdef MLPACK_TRAVERSAL_STATISTICS
+  /**
+   * Create the statistics object with all counts set to zero.
+   */
+  TraversalStatistics() :
+      numVisited(0),
+      numScores(0),
+      numPrunes(0),
+      numBaseCases(0),
+      maxDepth(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Record a visit to a node (or node combination) at the given level of the
+   * traversal.  The root is at level 0.
+   *
+   * @param level Level of the visited node.
+   */
+  void Visit(const size_t level)
+  {
+    ++numVisited;
+
+    if (level >= levelVisits.size())
+      levelVisits.resize(level + 1, 0);
+    ++levelVisits[level];
+
+    if (level > maxDepth)
+      maxDepth = level;
+  }
+
+  //! Record that Score() was called the given number of times.
+  void Score(const size_t count = 1) { numScores += count; }
+
+  //! Record that the given number of nodes (or node combinations) was pruned.
+  void Prune(const size_t count = 1) { numPrunes += count; }
+
+  //! Record that the given number of base cases was evaluated.
+  void BaseCase(const size_t count = 1) { numBaseCases += count; }
+
+  //! Reset all counts to zero.
+  void Reset()
+  {
+    numVisited = 0;
+    numScores = 0;
+    numPrunes = 0;
+    numBaseCases = 0;
+    maxDepth = 0;
+    levelVisits.clear();
+  }
+
+  //! Get the number of nodes (or node combinations) visited.
+  size_t NumVisited() const { return numVisited; }
+  //! Get the number of times Score() was called.
+  size_t NumScores() const { return numScores; }
+  //! Get the number of nodes (or node combinations) pruned.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Get the number of base cases evaluated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Get the maximum level reached during the traversal (the root is 0).
+  size_t MaxDepth() const { return maxDepth; }
+  //! Get the number of visits at each level of the traversal.
+  const std::vector<size_t>& LevelVisits() const { return levelVisits; }
+
+  /**
+   * Print the collected statistics through Log::Info, in the same style that
+   * Timers uses for timer reporting.
+   *
+   * @param name Name of the traversal, for the report header.
+   */
+  void Report(const std::string& name) const
+  {
+    Log::Info << "Traversal statistics (" << name << "):" << std::endl;
+    Log::Info << "  node visits: " << numVisited << std::endl;
+    Log::Info << "  scores: " << numScores << std::endl;
+    Log::Info << "  prunes: " << numPrunes << std::endl;
+    Log::Info << "  base cases: " << numBaseCases << std::endl;
+    Log::Info << "  maximum depth: " << maxDepth << std::endl;
+    for (size_t i = 0; i < levelVisits.size(); ++i)
+      Log::Info << "  visits at level " << i << ": " << levelVisits[i]
+          << std::endl;
+  }
+
+ private:
+  //! The number of nodes (or node combinations) visited.
+  size_t numVisited;
+  //! The number of times Score() was called.
+  size_t numScores;
+  //! The number of nodes (or node combinations) pruned.
+  size_t numPrunes;
+  //! The number of base cases evaluated.
+  size_t numBaseCases;
+  //! The maximum level reached during the traversal.
+  size_t maxDepth;
+  //! The number of visits at each level of the traversal.
+  std::vector<size_t> levelVisits;
+#else
+  // Statistics collection is disabled; every member is an empty inline
+  // function, so the instrumentation calls in the traversers cost nothing.
+  TraversalStatistics() { }
+
+  void Visit(const size_t /* level */) { }
+  void Score(const size_t /* count */ = 1) { }
+  void Prune(const size_t /* count */ = 1) { }
+  void BaseCase(const size_t /* count */ = 1) { }
+  void Reset() { }
+
+  size_t NumVisited() const { return 0; }
+  size_t NumScores() const { return 0; }
+  size_t NumPrunes() const { return 0; }
+  size_t NumBaseCases() const { return 0; }
+  size_t MaxDepth() const { return 0; }
+  const std::vector<size_t>& LevelVisits() const
+  {
+    static std::vector<size_t> empty;
+    return empty;
+  }
+
+  void Report(const std::string& /* name */) const { }
+#endif
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
+#endif
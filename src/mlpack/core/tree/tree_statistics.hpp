@@ -0,0 +1,86 @@
+/**
+ * @file tree_statistics.hpp
+ *
+ * Post-build shape statistics for any mlpack tree type, for tuning build
+ * parameters (split policies, leaf sizes, rectangle-tree fill factors).
+ */
+#ifndef __MLPACK_CORE_TREE_TREE_STATISTICS_HPP
+#define __MLPACK_CORE_TREE_TREE_STATISTICS_HPP
+
+#include <mlpack/core.hpp>
+
+#include "hrectbound.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The shape of a built tree, assembled by BuildStatistics() in one pass:
+ * per-level node and leaf counts, the leaf occupancy distribution, and (for
+ * trees with axis-aligned bounds, such as the kd-tree and the R tree) the
+ * total leaf bound volume and the total overlap volume of sibling bounds.
+ * The volumes are what the split policies of the rectangle trees try to
+ * minimize, so they are the quantities to correlate with traversal counters
+ * when tuning build parameters.
+ *
+ * Print the statistics with ToString():
+ *
+ * @code
+ * Log::Info << BuildStatistics(tree).ToString();
+ * @endcode
+ */
+struct TreeBuildStatistics
+{
+  //! Total number of nodes in the tree.
+  size_t nodes;
+  //! Total number of leaf nodes in the tree.
+  size_t leaves;
+  //! Number of points held by the tree.
+  size_t points;
+  //! Depth of the deepest node (the root has depth 0).
+  size_t maxDepth;
+  //! Number of nodes at each depth.
+  std::vector<size_t> nodesPerLevel;
+  //! Number of leaves at each depth.
+  std::vector<size_t> leavesPerLevel;
+  //! Number of leaves holding each number of points (element i counts the
+  //! leaves with exactly i points).
+  std::vector<size_t> leafSizeCounts;
+  //! Smallest number of points held by any leaf.
+  size_t minLeafSize;
+  //! Largest number of points held by any leaf.
+  size_t maxLeafSize;
+  //! Average number of points held by a leaf.
+  double meanLeafSize;
+  //! Whether the bound type has a volume (see leafVolume and overlapVolume).
+  bool haveVolumes;
+  //! Total volume of the leaf bounds (only set when haveVolumes is true).
+  double leafVolume;
+  //! Total volume of the pairwise overlap of sibling bounds (only set when
+  //! haveVolumes is true).
+  double overlapVolume;
+
+  // Returns a string representation of the statistics.
+  std::string ToString() const;
+};
+
+/**
+ * Walk a built tree and assemble its shape statistics.  One node is visited
+ * once, so the cost is linear in the size of the tree (plus one overlap
+ * computation per pair of siblings, for trees with axis-aligned bounds).
+ * Works with any tree exposing NumChildren(), Child(), NumPoints(),
+ * NumDescendants(), and Bound(); the cover tree, which has no bounds,
+ * reports no volumes.
+ *
+ * @param root Root of the tree to measure.
+ */
+template<typename TreeType>
+TreeBuildStatistics BuildStatistics(const TreeType& root);
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "tree_statistics_impl.hpp"
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file tree_statistics_impl.hpp
+ *
+ * Implementation of the post-build tree shape statistics.
+ */
+#ifndef __MLPACK_CORE_TREE_TREE_STATISTICS_IMPL_HPP
+#define __MLPACK_CORE_TREE_TREE_STATISTICS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "tree_statistics.hpp"
+
+namespace mlpack {
+namespace tree {
+
+// Forward declaration (see cover_tree/cover_tree.hpp); the cover tree needs
+// its own overloads below, and this avoids making every user of this file
+// include it.
+template<typename MetricType, typename RootPointPolicy, typename StatisticType>
+class CoverTree;
+
+//! Bounds without an axis-aligned representation report no volume.
+template<typename BoundType>
+inline bool BoundVolume(const BoundType& /* bound */, double& /* volume */)
+{
+  return false;
+}
+
+//! The volume of an axis-aligned bound.
+template<int Power, bool TakeRoot, typename ElemType>
+inline bool BoundVolume(
+    const bound::HRectBound<Power, TakeRoot, ElemType>& bound,
+    double& volume)
+{
+  volume = (double) bound.Volume();
+  return true;
+}
+
+//! Bounds without an axis-aligned representation report no overlap.
+template<typename BoundType>
+inline bool BoundOverlap(const BoundType& /* a */,
+                         const BoundType& /* b */,
+                         double& /* overlap */)
+{
+  return false;
+}
+
+//! The volume of the intersection of two axis-aligned bounds.
+template<int Power, bool TakeRoot, typename ElemType>
+inline bool BoundOverlap(
+    const bound::HRectBound<Power, TakeRoot, ElemType>& a,
+    const bound::HRectBound<Power, TakeRoot, ElemType>& b,
+    double& overlap)
+{
+  overlap = 1.0;
+  for (size_t d = 0; d < a.Dim(); ++d)
+  {
+    const double width = std::min((double) a[d].Hi(), (double) b[d].Hi()) -
+        std::max((double) a[d].Lo(), (double) b[d].Lo());
+    if (width <= 0.0)
+    {
+      overlap = 0.0;
+      return true;
+    }
+    overlap *= width;
+  }
+  return true;
+}
+
+//! Accumulate the bound volume of a leaf.
+template<typename TreeType>
+inline void AccumulateLeafVolume(const TreeType& node,
+                                 TreeBuildStatistics& stats)
+{
+  double volume;
+  if (BoundVolume(node.Bound(), volume))
+  {
+    stats.haveVolumes = true;
+    stats.leafVolume += volume;
+  }
+}
+
+//! Accumulate the pairwise overlap volume of the children of a node.  The
+//! overlap of the child bounds is what rectangle-tree split policies try to
+//! minimize.
+template<typename TreeType>
+inline void AccumulateOverlapVolume(const TreeType& node,
+                                    TreeBuildStatistics& stats)
+{
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    for (size_t j = i + 1; j < node.NumChildren(); ++j)
+    {
+      double overlap;
+      if (BoundOverlap(node.Child(i).Bound(), node.Child(j).Bound(),
+          overlap))
+      {
+        stats.haveVolumes = true;
+        stats.overlapVolume += overlap;
+      }
+    }
+  }
+}
+
+//! The cover tree has no Bound() at all, so it reports no volumes.
+template<typename MetricType, typename RootPointPolicy,
+         typename StatisticType>
+inline void AccumulateLeafVolume(
+    const CoverTree<MetricType, RootPointPolicy, StatisticType>& /* node */,
+    TreeBuildStatistics& /* stats */)
+{ }
+
+template<typename MetricType, typename RootPointPolicy,
+         typename StatisticType>
+inline void AccumulateOverlapVolume(
+    const CoverTree<MetricType, RootPointPolicy, StatisticType>& /* node */,
+    TreeBuildStatistics& /* stats */)
+{ }
+
+//! Accumulate the statistics of one subtree (one recursive pass).
+template<typename TreeType>
+void CollectStatistics(const TreeType& node,
+                       const size_t depth,
+                       TreeBuildStatistics& stats)
+{
+  stats.nodes++;
+  if (depth > stats.maxDepth)
+    stats.maxDepth = depth;
+  if (depth >= stats.nodesPerLevel.size())
+  {
+    stats.nodesPerLevel.resize(depth + 1, 0);
+    stats.leavesPerLevel.resize(depth + 1, 0);
+  }
+  stats.nodesPerLevel[depth]++;
+
+  if (node.NumChildren() == 0)
+  {
+    stats.leaves++;
+    stats.leavesPerLevel[depth]++;
+
+    const size_t leafSize = node.NumPoints();
+    if (leafSize >= stats.leafSizeCounts.size())
+      stats.leafSizeCounts.resize(leafSize + 1, 0);
+    stats.leafSizeCounts[leafSize]++;
+    stats.minLeafSize = std::min(stats.minLeafSize, leafSize);
+    stats.maxLeafSize = std::max(stats.maxLeafSize, leafSize);
+
+    AccumulateLeafVolume(node, stats);
+  }
+  else
+  {
+    AccumulateOverlapVolume(node, stats);
+
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+      CollectStatistics(node.Child(i), depth + 1, stats);
+  }
+}
+
+template<typename TreeType>
+TreeBuildStatistics BuildStatistics(const TreeType& root)
+{
+  TreeBuildStatistics stats;
+  stats.nodes = 0;
+  stats.leaves = 0;
+  stats.points = root.NumDescendants();
+  stats.maxDepth = 0;
+  stats.minLeafSize = size_t() - 1;
+  stats.maxLeafSize = 0;
+  stats.meanLeafSize = 0.0;
+  stats.haveVolumes = false;
+  stats.leafVolume = 0.0;
+  stats.overlapVolume = 0.0;
+
+  CollectStatistics(root, 0, stats);
+
+  if (stats.leaves > 0)
+  {
+    double leafPoints = 0.0;
+    for (size_t i = 0; i < stats.leafSizeCounts.size(); ++i)
+      leafPoints += (double) (i * stats.leafSizeCounts[i]);
+    stats.meanLeafSize = leafPoints / stats.leaves;
+  }
+  else
+  {
+    stats.minLeafSize = 0;
+  }
+
+  return stats;
+}
+
+inline std::string TreeBuildStatistics::ToString() const
+{
+  std::ostringstream convert;
+  convert << "TreeBuildStatistics [" << this << "]" << std::endl;
+  convert << "  Nodes: " << nodes << " (" << leaves << " leaves)"
+      << std::endl;
+  convert << "  Points: " << points << std::endl;
+  convert << "  Maximum depth: " << maxDepth << std::endl;
+  convert << "  Leaf size: minimum " << minLeafSize << ", mean "
+      << meanLeafSize << ", maximum " << maxLeafSize << std::endl;
+  if (haveVolumes)
+  {
+    convert << "  Leaf bound volume: " << leafVolume << std::endl;
+    convert << "  Sibling overlap volume: " << overlapVolume << std::endl;
+  }
+  for (size_t i = 0; i < nodesPerLevel.size(); ++i)
+  {
+    convert << "  Level " << i << ": " << nodesPerLevel[i] << " nodes ("
+        << leavesPerLevel[i] << " leaves)" << std::endl;
+  }
+  return convert.str();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * @file allocation_counters.cpp
+ * @author Matthew Amidon
+ *
+ * Implementation of allocation counters.
+ */
+#include "allocation_counters.hpp"
+#include "cli.hpp"
+#include "log.hpp"
+
+// glibc removed __malloc_hook in 2.32 (it was deprecated long before), so
+// the hook path only exists on older glibc; newer systems fall through to
+// the zero-reporting stubs below.
+#if defined(__GLIBC__) && (__GLIBC__ == 2) && (__GLIBC_MINOR__ < 32)
+  #define MLPACK_HAVE_MALLOC_HOOK
+#endif
+
+#ifdef MLPACK_HAVE_MALLOC_HOOK
+  #include <malloc.h> // __malloc_hook.
+#endif
+
+using namespace mlpack;
+
+// The global allocation statistics, accumulated by the malloc hook while at
+// least one region is active.  Regions take snapshots of these totals when
+// they start and charge themselves the difference when they stop, which is
+// what makes nested regions work.
+static size_t globalCount = 0;
+static size_t globalBytes = 0;
+
+#ifdef MLPACK_HAVE_MALLOC_HOOK
+
+// The number of active regions; the hook is installed while this is nonzero.
+static size_t activeRegions = 0;
+
+// The hook that was installed before ours, to be restored and chained to.
+static void* (*oldMallocHook)(size_t, const void*) = NULL;
+
+static void* CountingMallocHook(size_t size, const void* /* caller */)
+{
+  void* result;
+
+  // The hook must be uninstalled while allocating (so the malloc call below
+  // does not recurse into it), and that uninstall/reinstall dance is global
+  // state: two OpenMP threads allocating at once could drop the hook or
+  // corrupt the chain.  The critical section serializes the dance (and the
+  // counter updates) across OpenMP threads; threads created by other means
+  // are not covered.  An allocation made by another thread while the hook is
+  // out is simply not counted, which the "approximate inside parallel
+  // regions" caveat already covers.
+#ifdef _OPENMP
+  #pragma omp critical (allocationCounterHook)
+#endif
+  {
+    __malloc_hook = oldMallocHook;
+
+    result = malloc(size);
+
+    // Only successful allocations are counted.  realloc() growth and C
+    // library internal allocations that bypass malloc() are not observed; in
+    // practice C++ code allocates through operator new, which is.
+    if (result != NULL)
+    {
+      ++globalCount;
+      globalBytes += size;
+    }
+
+    __malloc_hook = CountingMallocHook;
+  }
+
+  return result;
+}
+
+static void InstallHook()
+{
+#ifdef _OPENMP
+  #pragma omp critical (allocationCounterHook)
+#endif
+  {
+    if (activeRegions++ == 0)
+    {
+      oldMallocHook = __malloc_hook;
+      __malloc_hook = CountingMallocHook;
+    }
+  }
+}
+
+static void RemoveHook()
+{
+#ifdef _OPENMP
+  #pragma omp critical (allocationCounterHook)
+#endif
+  {
+    if (--activeRegions == 0)
+      __malloc_hook = oldMallocHook;
+  }
+}
+
+#else
+
+// Without the hook there is nothing to install; counters always report zero.
+static void InstallHook() { }
+static void RemoveHook() { }
+
+#endif
+
+/**
+ * Start the given allocation counter.
+ */
+void AllocationCounter::Start(const std::string& name)
+{
+  CLI::GetSingleton().alloc.StartCounter(name);
+}
+
+/**
+ * Stop the given allocation counter.
+ */
+void AllocationCounter::Stop(const std::string& name)
+{
+  CLI::GetSingleton().alloc.StopCounter(name);
+}
+
+/**
+ * Get the given allocation counter.
+ */
+AllocationInfo AllocationCounter::Get(const std::string& name)
+{
+  return CLI::GetSingleton().alloc.GetCounter(name);
+}
+
+std::map<std::string, AllocationInfo>& AllocationCounters::GetAllCounters()
+{
+  return counters;
+}
+
+AllocationInfo AllocationCounters::GetCounter(const std::string& counterName)
+{
+  std::string name(counterName);
+  return counters[name];
+}
+
+void AllocationCounters::PrintCounter(const std::string& counterName)
+{
+  AllocationInfo& info = counters[counterName];
+  Log::Info << info.count << " allocations, " << info.bytes << " bytes";
+
+  // Also output a convenient MB/GB total, in the spirit of PrintTimer().
+  const double megabytes = (double) info.bytes / (1024.0 * 1024.0);
+  if (megabytes >= 1024.0)
+    Log::Info << " (" << megabytes / 1024.0 << " GB)";
+  else if (megabytes >= 1.0)
+    Log::Info << " (" << megabytes << " MB)";
+
+  Log::Info << std::endl;
+}
+
+void AllocationCounters::StartCounter(const std::string& counterName)
+{
+  std::string name(counterName);
+
+  // Snapshot the global totals; the difference at stop time is what this
+  // region allocated.  The map insertions happen before the hook goes in, so
+  // our own bookkeeping is not counted.
+  AllocationInfo snapshot;
+  snapshot.count = globalCount;
+  snapshot.bytes = globalBytes;
+  snapshots[name] = snapshot;
+  counters[name]; // Ensure the accumulated entry exists.
+
+  InstallHook();
+}
+
+void AllocationCounters::StopCounter(const std::string& counterName)
+{
+  RemoveHook();
+
+  std::string name(counterName);
+  const AllocationInfo& snapshot = snapshots[name];
+  counters[name].count += globalCount - snapshot.count;
+  counters[name].bytes += globalBytes - snapshot.bytes;
+  snapshots.erase(name);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file allocation_counters.hpp
+ * @author Matthew Amidon
+ *
+ * Allocation counters for MLPACK.  These mirror the Timer interface: a named
+ * region is started and stopped, and while any region is active, every heap
+ * allocation made by the program is counted and its size accumulated.  This
+ * answers the question "where does the memory traffic come from" without an
+ * external profiler.
+ */
+#ifndef __MLPACK_CORE_UTILITIES_ALLOCATION_COUNTERS_HPP
+#define __MLPACK_CORE_UTILITIES_ALLOCATION_COUNTERS_HPP
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace mlpack {
+
+/**
+ * The accumulated allocation statistics of one named region: how many heap
+ * allocations were made while the region was active, and how many bytes were
+ * requested in total.  Frees are not tracked, so this measures allocation
+ * churn rather than peak usage.
+ */
+struct AllocationInfo
+{
+  //! Number of heap allocations.
+  size_t count;
+  //! Total number of bytes requested.
+  size_t bytes;
+
+  //! Initialize to zero.
+  AllocationInfo() : count(0), bytes(0) { }
+};
+
+/**
+ * The allocation counter class provides a way for the heap traffic of MLPACK
+ * methods to be measured, in the same way that the Timer class measures their
+ * runtime.  Counting is implemented with glibc malloc hooks, so it is only
+ * active on glibc older than 2.32 (which removed the hooks); elsewhere the
+ * regions exist but always report zero.  The hooks are installed when the
+ * first region is started and removed when the last region is stopped, so a
+ * program that never starts a region pays nothing.
+ *
+ * Like timers, counters are additive across runs of the same region, and
+ * nested regions each observe the allocations made while they are active.
+ *
+ * Hook installation and the counting itself are serialized across OpenMP
+ * threads, so counting inside parallel regions is safe, but allocations made
+ * while the hook is momentarily uninstalled are missed: counts observed
+ * inside parallel regions are approximate.  Threads created by means other
+ * than OpenMP are not synchronized at all.
+ */
+class AllocationCounter
+{
+ public:
+  /**
+   * Start the given allocation counter.  If a counter is started, then
+   * stopped, then re-started, then re-stopped, its final value covers both
+   * runs -- counters are additive and do not reset.
+   *
+   * @note Undefined behavior will occur if a counter is started twice.
+   *
+   * @param name Name of counter to be started.
+   */
+  static void Start(const std::string& name);
+
+  /**
+   * Stop the given allocation counter.
+   *
+   * @note Undefined behavior will occur if a counter is stopped twice.
+   *
+   * @param name Name of counter to be stopped.
+   */
+  static void Stop(const std::string& name);
+
+  /**
+   * Get the value of the given allocation counter.
+   *
+   * @param name Name of counter to return value of.
+   */
+  static AllocationInfo Get(const std::string& name);
+};
+
+class AllocationCounters
+{
+ public:
+  //! Nothing to do for the constructor.
+  AllocationCounters() { }
+
+  /**
+   * Returns all of the counters used via this interface.
+   */
+  std::map<std::string, AllocationInfo>& GetAllCounters();
+
+  /**
+   * Returns the counter specified.
+   *
+   * @param counterName The name of the counter in question.
+   */
+  AllocationInfo GetCounter(const std::string& counterName);
+
+  /**
+   * Prints the specified counter.  If more than a megabyte was allocated, the
+   * total is also displayed in megabytes (or gigabytes).
+   *
+   * @param counterName The name of the counter in question.
+   */
+  void PrintCounter(const std::string& counterName);
+
+  /**
+   * Starts counting allocations into the given counter, installing the malloc
+   * hooks if no other counter is active.
+   *
+   * @param counterName The name of the counter in question.
+   */
+  void StartCounter(const std::string& counterName);
+
+  /**
+   * Stops counting allocations into the given counter, removing the malloc
+   * hooks if no other counter remains active.
+   *
+   * @param counterName The name of the counter in question.
+   */
+  void StopCounter(const std::string& counterName);
+
+ private:
+  //! The accumulated statistics of every region seen so far.
+  std::map<std::string, AllocationInfo> counters;
+  //! The global statistics snapshot taken when each active region started.
+  std::map<std::string, AllocationInfo> snapshots;
+};
+
+}; // namespace mlpack
+
+#endif // __MLPACK_CORE_UTILITIES_ALLOCATION_COUNTERS_HPP
@@ -73,6 +73,19 @@ CLI::~CLI()
       Log::Info << "  " << i << ": ";
       timer.PrintTimer((*it).first);
     }
+
+    // Only print allocation counters if any regions were actually counted.
+    if (!alloc.GetAllCounters().empty())
+    {
+      Log::Info << "Program allocation counters:" << std::endl;
+      std::map<std::string, AllocationInfo>::iterator ait;
+      for (ait = alloc.GetAllCounters().begin();
+          ait != alloc.GetAllCounters().end(); ++ait)
+      {
+        Log::Info << "  " << (*ait).first << ": ";
+        alloc.PrintCounter((*ait).first);
+      }
+    }
   }
 
   // Notify the user if we are debugging, but only if we actually parsed the
@@ -128,6 +141,46 @@ void CLI::Add(const std::string& path,
   return;
 }
 
+/**
+ * Enqueues an option for lazy registration.  This is the only work done at
+ * static initialization time for an option declared with the PARAM_*()
+ * macros; the boost::program_options registration is deferred until
+ * FlushOptions() is called by the first real use of the option table.
+ *
+ * @param option Option to be registered when the option table is first used.
+ */
+void CLI::EnqueueOption(util::OptionBase* option)
+{
+  PendingOptions().push_back(option);
+}
+
+/**
+ * Returns the list of options enqueued by EnqueueOption() but not yet
+ * registered.
+ */
+std::list<util::OptionBase*>& CLI::PendingOptions()
+{
+  // A function-local static, so that options can be enqueued from any static
+  // initializer regardless of initialization order.
+  static std::list<util::OptionBase*> pendingOptions;
+  return pendingOptions;
+}
+
+/**
+ * Registers all enqueued options.
+ */
+void CLI::FlushOptions()
+{
+  // Swap the pending list out first: registration itself uses GetParam() to
+  // store default values, and the re-entrant call must see an empty list.
+  std::list<util::OptionBase*> pending;
+  pending.swap(PendingOptions());
+
+  std::list<util::OptionBase*>::iterator it;
+  for (it = pending.begin(); it != pending.end(); ++it)
+    (*it)->Register();
+}
+
 /*
  * Adds an alias mapping for a given parameter.
  *
@@ -260,6 +313,9 @@ bool CLI::HasParam(const std::string& key)
 template<>
 bool& CLI::GetParam<bool>(const std::string& key)
 {
+  // Register any lazily enqueued options first.
+  FlushOptions();
+
   std::string used_key = key;
   po::variables_map vmap = GetSingleton().vmap;
   gmap_t& gmap = GetSingleton().globalValues;
@@ -344,6 +400,9 @@ std::string CLI::HyphenateString(const std::string& str, int padding)
  */
 std::string CLI::GetDescription(const std::string& identifier)
 {
+  // Register any lazily enqueued options first.
+  FlushOptions();
+
   gmap_t& gmap = GetSingleton().globalValues;
   std::string name = std::string(identifier);
 
@@ -379,6 +438,9 @@ void CLI::ParseCommandLine(int argc, char** line)
 {
   Timer::Start("total_time");
 
+  // Register any lazily enqueued options first.
+  FlushOptions();
+
   GetSingleton().programName = std::string(line[0]);
   po::variables_map& vmap = GetSingleton().vmap;
   po::options_description& desc = GetSingleton().desc;
@@ -453,6 +515,9 @@ void CLI::RemoveDuplicateFlags(po::basic_parsed_options<char>& bpo)
  */
 void CLI::ParseStream(std::istream& stream)
 {
+  // Register any lazily enqueued options first.
+  FlushOptions();
+
   po::variables_map& vmap = GetSingleton().vmap;
   po::options_description& desc = GetSingleton().desc;
 
@@ -479,6 +544,9 @@ void CLI::ParseStream(std::istream& stream)
 /* Prints out the current hierarchy. */
 void CLI::Print()
 {
+  // Register any lazily enqueued options first.
+  FlushOptions();
+
   gmap_t& gmap = GetSingleton().globalValues;
   gmap_t::iterator iter;
 
@@ -534,6 +602,9 @@ void CLI::Print()
 /* Prints the descriptions of the current hierarchy. */
 void CLI::PrintHelp(const std::string& param)
 {
+  // Register any lazily enqueued options first.
+  FlushOptions();
+
   std::string used_param = param;
   gmap_t& gmap = GetSingleton().globalValues;
   amap_t& amap = GetSingleton().aliasValues;
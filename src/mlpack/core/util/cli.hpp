@@ -18,6 +18,7 @@
 #include <boost/program_options.hpp>
 
 #include "timers.hpp"
+#include "allocation_counters.hpp"
 #include "cli_deleter.hpp" // To make sure we can delete the singleton.
 #include "version.hpp"
 
@@ -366,6 +367,10 @@ namespace util {
 // program being run.
 class ProgramDoc;
 
+// Externally defined in option.hpp, this is the base class of the static
+// objects which register options with CLI.
+class OptionBase;
+
 }; // namespace util
 
 /**
@@ -560,6 +565,19 @@ class CLI
                       const std::string& description,
                       const std::string& alias = "");
 
+  /**
+   * Enqueues an option for lazy registration; this should not be used outside
+   * of the Option class.  The static initializers of the Option objects
+   * declared by the PARAM_*() macros only append a pointer here, and the
+   * boost::program_options registration work is deferred until the first time
+   * the option table is actually needed.  This keeps the load-time cost of
+   * each option linked into an executable down to a single pointer push.
+   *
+   * @param option Option to be registered when the option table is first used.
+   *     The object must have static storage duration.
+   */
+  static void EnqueueOption(util::OptionBase* option);
+
   /**
    * Parses the parameters for 'help' and 'info'.
    * If found, will print out the appropriate information and kill the program.
@@ -699,6 +717,13 @@ class CLI
   //! So that Timer::Start() and Timer::Stop() can access the timer variable.
   friend class Timer;
 
+  //! Holds the allocation counter objects.
+  AllocationCounters alloc;
+
+  //! So that AllocationCounter::Start() and AllocationCounter::Stop() can
+  //! access the alloc variable.
+  friend class AllocationCounter;
+
  public:
   //! Pointer to the ProgramDoc object.
   util::ProgramDoc *doc;
@@ -730,6 +755,20 @@ class CLI
   void FileTimeToTimeVal(timeval* tv);
 #endif
 
+  /**
+   * Returns the list of options enqueued by EnqueueOption() but not yet
+   * registered.  A function-local static is used so that the list can be
+   * appended to from any static initializer, regardless of initialization
+   * order.
+   */
+  static std::list<util::OptionBase*>& PendingOptions();
+
+  /**
+   * Registers all enqueued options.  This is called before any use of the
+   * option table, and does nothing when no options are pending.
+   */
+  static void FlushOptions();
+
   /**
    * Checks that all required parameters have been specified on the command
    * line.  If any have not been specified, an error message is printed and the
@@ -81,6 +81,9 @@ bool& CLI::GetParam<bool>(const std::string& identifier);
 template<typename T>
 T& CLI::GetParam(const std::string& identifier)
 {
+  // Register any lazily enqueued options first.
+  FlushOptions();
+
   // Used to ensure we have a valid value.
   T tmp = T();
 
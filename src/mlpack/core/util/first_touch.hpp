@@ -0,0 +1,78 @@
+/**
+ * @file first_touch.hpp
+ * @author Ryan Curtin
+ *
+ * Parallel first-touch initialization for working buffers used by parallel
+ * algorithms.  On NUMA systems, Linux (and most other operating systems)
+ * places each page of a fresh allocation on the memory node of the thread
+ * that first writes it.  A buffer that is filled serially therefore ends up
+ * entirely on one node, and a parallel loop that later walks it from every
+ * socket is limited to that node's memory bandwidth.  Initializing the
+ * buffer with the same parallel decomposition that the compute loops use
+ * spreads the pages across the nodes, so each thread mostly reads and writes
+ * local memory.
+ *
+ * Thread-to-core pinning itself is left to the OpenMP runtime (for instance
+ * via OMP_PROC_BIND or GOMP_CPU_AFFINITY), since mlpack uses the runtime's
+ * thread pool rather than managing its own threads.
+ */
+#ifndef __MLPACK_CORE_UTIL_FIRST_TOUCH_HPP
+#define __MLPACK_CORE_UTIL_FIRST_TOUCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Fill the given matrix with the given value, touching the columns in
+ * parallel with a static schedule.  Use this instead of fill() to initialize
+ * a freshly allocated working buffer that parallel loops will later walk
+ * column-by-column with a static schedule: the page placement will then
+ * match the loop decomposition.  Without OpenMP this is equivalent to
+ * matrix.fill(value).
+ *
+ * @param matrix Matrix to fill.
+ * @param value Value to fill the matrix with.
+ */
+template<typename eT>
+inline void FirstTouchFill(arma::Mat<eT>& matrix, const eT value)
+{
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long col = 0; col < (long) matrix.n_cols; col++)
+    matrix.col(col).fill(value);
+}
+
+/**
+ * Fill the given vector with the given value, touching blocks of elements in
+ * parallel with a static schedule.  Without OpenMP this is equivalent to
+ * vector.fill(value).
+ *
+ * @param vector Vector to fill.
+ * @param value Value to fill the vector with.
+ */
+template<typename eT>
+inline void FirstTouchFill(arma::Col<eT>& vector, const eT value)
+{
+  // Blocks of 4096 elements, so each thread's share spans whole pages.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (vector.n_elem + blockSize - 1) / blockSize;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long block = 0; block < (long) numBlocks; block++)
+  {
+    const size_t begin = block * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) vector.n_elem);
+    for (size_t i = begin; i < end; ++i)
+      vector[i] = value;
+  }
+}
+
+}; // namespace util
+}; // namespace mlpack
+
+#endif
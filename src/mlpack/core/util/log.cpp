@@ -30,18 +30,31 @@
 using namespace mlpack;
 using namespace mlpack::util;
 
-// Only output debugging output if in debug mode.
-#ifdef DEBUG
+// Only define streams whose level is enabled at compile time as real
+// PrefixedOutStream objects; the rest are no-op NullOutStream objects.
+#if MLPACK_LOG_LEVEL >= MLPACK_LOG_LEVEL_DEBUG
 PrefixedOutStream Log::Debug = PrefixedOutStream(std::cout,
     BASH_CYAN "[DEBUG] " BASH_CLEAR);
 #else
 NullOutStream Log::Debug = NullOutStream();
 #endif
 
+#if MLPACK_LOG_LEVEL >= MLPACK_LOG_LEVEL_INFO
 PrefixedOutStream Log::Info = PrefixedOutStream(std::cout,
     BASH_GREEN "[INFO ] " BASH_CLEAR, true /* unless --verbose */, false);
+#else
+NullOutStream Log::Info = NullOutStream();
+#endif
+
+#if MLPACK_LOG_LEVEL >= MLPACK_LOG_LEVEL_WARN
 PrefixedOutStream Log::Warn = PrefixedOutStream(std::cout,
     BASH_YELLOW "[WARN ] " BASH_CLEAR, false, false);
+#else
+NullOutStream Log::Warn = NullOutStream();
+#endif
+
+// Log::Fatal can never be compiled out; control flow depends on it
+// terminating the program.
 PrefixedOutStream Log::Fatal = PrefixedOutStream(std::cerr,
     BASH_RED "[FATAL] " BASH_CLEAR, false, true /* fatal */);
 
@@ -12,6 +12,27 @@
 #include "prefixedoutstream.hpp"
 #include "nulloutstream.hpp"
 
+//! Available compile-time log levels, from least to most output.
+#define MLPACK_LOG_LEVEL_FATAL 1
+#define MLPACK_LOG_LEVEL_WARN  2
+#define MLPACK_LOG_LEVEL_INFO  3
+#define MLPACK_LOG_LEVEL_DEBUG 4
+
+// The compile-time log level.  Streams above this level are declared as
+// NullOutStream objects, whose inline no-op operators optimize away entirely,
+// so disabled levels cost literally nothing at runtime.  By default, debug
+// builds enable all levels and release builds enable everything but
+// Log::Debug; define MLPACK_LOG_LEVEL (e.g. -DMLPACK_LOG_LEVEL=2) to compile
+// out more.  Log::Fatal can never be compiled out, since program control flow
+// depends on it terminating the program.
+#ifndef MLPACK_LOG_LEVEL
+  #ifdef DEBUG
+    #define MLPACK_LOG_LEVEL MLPACK_LOG_LEVEL_DEBUG
+  #else
+    #define MLPACK_LOG_LEVEL MLPACK_LOG_LEVEL_INFO
+  #endif
+#endif
+
 namespace mlpack {
 
 /**
@@ -43,7 +64,10 @@ namespace mlpack {
  *
  * Any messages sent to Log::Debug will not be shown when compiling in non-debug
  * mode.  Messages to Log::Info will only be shown when the --verbose flag is
- * given to the program (or rather, the CLI class).
+ * given to the program (or rather, the CLI class).  The MLPACK_LOG_LEVEL
+ * macro controls which levels exist at all: streams above the compile-time
+ * level are replaced with no-op NullOutStream objects and cost nothing at
+ * runtime.
  *
  * @see PrefixedOutStream, NullOutStream, CLI
  */
@@ -59,9 +83,9 @@ class Log
                      const std::string& message = "Assert Failed.");
 
 
-  // We only use PrefixedOutStream if the program is compiled with debug
-  // symbols.
-#ifdef DEBUG
+  // Each stream is only a PrefixedOutStream if its level is enabled at
+  // compile time; otherwise it is a no-op NullOutStream.
+#if MLPACK_LOG_LEVEL >= MLPACK_LOG_LEVEL_DEBUG
   //! Prints debug output with the appropriate tag: [DEBUG].
   static util::PrefixedOutStream Debug;
 #else
@@ -69,12 +93,22 @@ class Log
   static util::NullOutStream Debug;
 #endif
 
+#if MLPACK_LOG_LEVEL >= MLPACK_LOG_LEVEL_INFO
   //! Prints informational messages if --verbose is specified, prefixed with
   //! [INFO ].
   static util::PrefixedOutStream Info;
+#else
+  //! Dumps informational messages into the bit nether regions.
+  static util::NullOutStream Info;
+#endif
 
+#if MLPACK_LOG_LEVEL >= MLPACK_LOG_LEVEL_WARN
   //! Prints warning messages prefixed with [WARN ].
   static util::PrefixedOutStream Warn;
+#else
+  //! Dumps warning messages into the bit nether regions.
+  static util::NullOutStream Warn;
+#endif
 
   //! Prints fatal messages prefixed with [FATAL], then terminates the program.
   static util::PrefixedOutStream Fatal;
@@ -16,8 +16,9 @@ namespace mlpack {
 namespace util {
 
 /**
- * Used for Log::Debug when not compiled with debugging symbols.  This class
- * does nothing and should be optimized out entirely by the compiler.
+ * Used for any Log stream whose level is disabled at compile time (see
+ * MLPACK_LOG_LEVEL in log.hpp).  This class does nothing and should be
+ * optimized out entirely by the compiler.
  */
 class NullOutStream
 {
@@ -25,12 +26,16 @@ class NullOutStream
   /**
    * Does nothing.
    */
-  NullOutStream() { }
+  NullOutStream() : ignoreInput(false) { }
 
   /**
    * Does nothing.
    */
-  NullOutStream(const NullOutStream& /* other */) { }
+  NullOutStream(const NullOutStream& /* other */) : ignoreInput(false) { }
+
+  //! Exists so that NullOutStream is a drop-in replacement for
+  //! PrefixedOutStream; writes to it have no effect.
+  bool ignoreInput;
 
   //! Does nothing.
   NullOutStream& operator<<(bool) { return *this; }
@@ -16,20 +16,40 @@ namespace mlpack {
 namespace util {
 
 /**
- * A static object whose constructor registers a parameter with the CLI class.
- * This should not be used outside of CLI itself, and you should use the
- * PARAM_FLAG(), PARAM_DOUBLE(), PARAM_INT(), PARAM_STRING(), or other similar
- * macros to declare these objects instead of declaring them directly.
+ * Base class of Option, through which CLI performs the deferred registration
+ * of enqueued options without knowing their template parameter.
+ *
+ * @see mlpack::util::Option, mlpack::CLI
+ */
+class OptionBase
+{
+ public:
+  //! Destruct the OptionBase object.
+  virtual ~OptionBase() { }
+
+  //! Perform the actual registration with CLI; called by CLI::FlushOptions().
+  virtual void Register() const = 0;
+};
+
+/**
+ * A static object whose constructor enqueues a parameter for registration with
+ * the CLI class.  The constructor only stores the parameter information and
+ * appends a pointer to CLI's pending option list; the registration itself
+ * (which involves boost::program_options) is deferred until CLI first needs
+ * the option table, so that linked-in options cost almost nothing at program
+ * load time.  This should not be used outside of CLI itself, and you should
+ * use the PARAM_FLAG(), PARAM_DOUBLE(), PARAM_INT(), PARAM_STRING(), or other
+ * similar macros to declare these objects instead of declaring them directly.
  *
  * @see core/io/cli.hpp, mlpack::CLI
  */
 template<typename N>
-class Option
+class Option : public OptionBase
 {
  public:
   /**
-   * Construct an Option object.  When constructed, it will register
-   * itself with CLI.
+   * Construct an Option object.  When constructed, it will enqueue
+   * itself for registration with CLI.
    *
    * @param ignoreTemplate Whether or not the template type matters for this
    *     option.  Essentially differs options with no value (flags) from those
@@ -50,8 +70,8 @@ class Option
          bool required = false);
 
   /**
-   * Constructs an Option object.  When constructed, it will register a flag
-   * with CLI.
+   * Constructs an Option object.  When constructed, it will enqueue a flag
+   * for registration with CLI.
    *
    * @param identifier The name of the option (no dashes in front); for --help
    *     we would pass "help".
@@ -62,6 +82,28 @@ class Option
   Option(const std::string& identifier,
          const std::string& description,
          const std::string& parent = std::string(""));
+
+  /**
+   * Perform the actual registration with CLI.  This is called by
+   * CLI::FlushOptions() the first time the option table is used.
+   */
+  void Register() const;
+
+ private:
+  //! Whether or not the template type matters for this option.
+  bool ignoreTemplate;
+  //! True if this option is a flag.
+  bool isFlag;
+  //! Default value this parameter will be initialized to.
+  N defaultValue;
+  //! The name of the option.
+  std::string identifier;
+  //! A short string describing the option.
+  std::string description;
+  //! An alias for the option (one letter).
+  std::string alias;
+  //! Whether or not the option is required at runtime.
+  bool required;
 };
 
 /**
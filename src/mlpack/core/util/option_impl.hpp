@@ -14,7 +14,8 @@ namespace mlpack {
 namespace util {
 
 /**
- * Registers a parameter with CLI.
+ * Enqueues a parameter for registration with CLI.  Registration itself is
+ * deferred until CLI first needs the option table.
  */
 template<typename N>
 Option<N>::Option(bool ignoreTemplate,
@@ -22,29 +23,59 @@ Option<N>::Option(bool ignoreTemplate,
                   const std::string& identifier,
                   const std::string& description,
                   const std::string& alias,
-                  bool required)
+                  bool required) :
+    ignoreTemplate(ignoreTemplate),
+    isFlag(false),
+    defaultValue(defaultValue),
+    identifier(identifier),
+    description(description),
+    alias(alias),
+    required(required)
 {
-  if (ignoreTemplate)
-  {
-    CLI::Add(identifier, description, alias, required);
-  }
-  else
-  {
-    CLI::Add<N>(identifier, description, alias, required);
-    CLI::GetParam<N>(identifier) = defaultValue;
-  }
+  CLI::EnqueueOption(this);
 }
 
 
 /**
- * Registers a flag parameter with CLI.
+ * Enqueues a flag parameter for registration with CLI.  Registration itself is
+ * deferred until CLI first needs the option table.
  */
 template<typename N>
 Option<N>::Option(const std::string& identifier,
                   const std::string& description,
-                  const std::string& alias)
+                  const std::string& alias) :
+    ignoreTemplate(false),
+    isFlag(true),
+    defaultValue(),
+    identifier(identifier),
+    description(description),
+    alias(alias),
+    required(false)
 {
-  CLI::AddFlag(identifier, description, alias);
+  CLI::EnqueueOption(this);
+}
+
+
+/**
+ * Registers the parameter with CLI; called by CLI::FlushOptions() the first
+ * time the option table is used.
+ */
+template<typename N>
+void Option<N>::Register() const
+{
+  if (isFlag)
+  {
+    CLI::AddFlag(identifier, description, alias);
+  }
+  else if (ignoreTemplate)
+  {
+    CLI::Add(identifier, description, alias, required);
+  }
+  else
+  {
+    CLI::Add<N>(identifier, description, alias, required);
+    CLI::GetParam<N>(identifier) = defaultValue;
+  }
 }
 
 }; // namespace util
@@ -10,11 +10,61 @@
 #include <streambuf>
 #include <string.h>
 #include <stdlib.h>
+#include <map>
 
 #include "prefixedoutstream.hpp"
 
 using namespace mlpack::util;
 
+#ifdef _OPENMP
+
+// One partial-line buffer per (stream, thread) pair.  The pointer is
+// threadprivate, so the map is only ever touched by its own thread and no
+// locking is needed to access it.
+static std::map<const PrefixedOutStream*, std::string>* threadLineBuffers =
+    NULL;
+#pragma omp threadprivate(threadLineBuffers)
+
+std::string* PrefixedOutStream::ThreadLineBuffer()
+{
+  if (threadLineBuffers == NULL)
+    threadLineBuffers = new std::map<const PrefixedOutStream*, std::string>();
+  return &(*threadLineBuffers)[this];
+}
+
+/**
+ * Accumulate the given text into the calling thread's line buffer; each
+ * completed line is written to the destination in one operation, so lines
+ * produced by different threads cannot interleave and the destination is only
+ * locked once per line rather than once per insertion.
+ */
+void PrefixedOutStream::BufferLine(const std::string& data, bool& newlined)
+{
+  std::string& buffer = *ThreadLineBuffer();
+
+  size_t nl;
+  size_t pos = 0;
+  while ((nl = data.find('\n', pos)) != std::string::npos)
+  {
+    buffer += data.substr(pos, nl - pos);
+
+    if (!ignoreInput)
+    {
+      #pragma omp critical (PrefixedOutStreamFlush)
+      destination << prefix << buffer << std::endl;
+      newlined = true;
+    }
+
+    buffer.clear();
+    pos = nl + 1;
+  }
+
+  if (pos != data.length()) // Keep the rest for later.
+    buffer += data.substr(pos);
+}
+
+#endif
+
 /**
  * These are all necessary because gcc's template mechanism does not seem smart
  * enough to figure out what I want to pass into operator<< without these.  That
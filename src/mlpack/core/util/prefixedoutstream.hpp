@@ -13,6 +13,10 @@
 #include <string>
 #include <streambuf>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 #include <boost/lexical_cast.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/type_traits.hpp>
@@ -47,6 +51,15 @@ namespace util {
  *
  * These objects are used for the mlpack::Log levels (DEBUG, INFO, WARN, and
  * FATAL).
+ *
+ * Inside an OpenMP parallel region, output is accumulated into a per-thread
+ * line buffer and each completed line is written to the destination in a
+ * single operation, so that lines produced by different threads are neither
+ * garbled together nor serialized on every insertion.  A partial line written
+ * by a thread is only displayed once that thread completes it with a newline,
+ * and zero-length insertions (formatting manipulators) are dropped, so
+ * parallel output should always be newline-terminated.  Output outside of
+ * parallel regions is unaffected.
  */
 class PrefixedOutStream
 {
@@ -162,6 +175,21 @@ class PrefixedOutStream
    */
   inline void PrefixIfNeeded();
 
+#ifdef _OPENMP
+  /**
+   * Accumulate the given text into the calling thread's line buffer, writing
+   * each completed line to the destination in a single operation.  This is
+   * used for all output from inside a parallel region.
+   *
+   * @param data Text to accumulate.
+   * @param newlined Set to true if at least one line was written.
+   */
+  void BufferLine(const std::string& data, bool& newlined);
+
+  //! Return the calling thread's partial-line buffer for this stream.
+  std::string* ThreadLineBuffer();
+#endif
+
   //! Contains the prefix we must prepend to each line.
   std::string prefix;
 
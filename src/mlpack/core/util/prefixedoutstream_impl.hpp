@@ -62,6 +62,26 @@ void PrefixedOutStream::CallBaseLogic(const T& s,
 template<typename T>
 void PrefixedOutStream::BaseLogic(const T& val)
 {
+#ifdef _OPENMP
+  // Inside a parallel region, all threads (including the master) go through
+  // the per-thread line buffers, so that complete lines are written to the
+  // destination atomically and the threads do not contend on every insertion.
+  if (omp_in_parallel())
+  {
+    std::ostringstream parallelConvert;
+    parallelConvert << val;
+
+    bool parallelNewlined = false;
+    if (!parallelConvert.fail())
+      BufferLine(parallelConvert.str(), parallelNewlined);
+
+    if (fatal && parallelNewlined)
+      exit(1);
+
+    return;
+  }
+#endif
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
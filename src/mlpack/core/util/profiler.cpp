@@ -0,0 +1,139 @@
+/**
+ * @file profiler.cpp
+ * @author Matthew Amidon
+ *
+ * Implementation of the hierarchical profiler.
+ */
+#include "profiler.hpp"
+#include "log.hpp"
+
+#include <cstring>
+
+#if defined(__MACH__) && defined(__APPLE__)
+  #include <mach/mach_time.h> // mach_timebase_info, mach_absolute_time().
+#elif !defined(_WIN32)
+  #include <time.h> // clock_gettime().
+#endif
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+// The root node has no name, no parent, and is never timed.
+ProfileNode Profiler::root = { NULL, NULL, std::vector<ProfileNode*>(),
+    0, 0, 0, 0 };
+ProfileNode* Profiler::current = &Profiler::root;
+
+uint64_t Profiler::Timestamp()
+{
+#if defined(__MACH__) && defined(__APPLE__)
+  static mach_timebase_info_data_t info;
+  if (info.denom == 0)
+    (void) mach_timebase_info(&info);
+
+  return mach_absolute_time() * info.numer / info.denom;
+#elif defined(_WIN32)
+  static double nsPerTick = 0.0;
+  if (nsPerTick == 0.0)
+  {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    nsPerTick = 1e9 / (double) frequency.QuadPart;
+  }
+
+  LARGE_INTEGER count;
+  QueryPerformanceCounter(&count);
+  return (uint64_t) ((double) count.QuadPart * nsPerTick);
+#else
+  // Get the cheapest monotonic clock available.
+#if defined(CLOCK_MONOTONIC_RAW)
+  static const clockid_t id = CLOCK_MONOTONIC_RAW;
+#elif defined(CLOCK_MONOTONIC)
+  static const clockid_t id = CLOCK_MONOTONIC;
+#else
+  static const clockid_t id = CLOCK_REALTIME;
+#endif
+
+  struct timespec ts;
+  clock_gettime(id, &ts);
+  return ((uint64_t) ts.tv_sec) * 1000000000 + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+void Profiler::Enter(const char* name)
+{
+  // Look for an existing node for this region under the current region.  The
+  // name is a string literal, so comparing pointers almost always suffices;
+  // strcmp() covers literals duplicated across translation units.
+  for (size_t i = 0; i < current->children.size(); ++i)
+  {
+    ProfileNode* child = current->children[i];
+    if ((child->name == name) || (strcmp(child->name, name) == 0))
+    {
+      current = child;
+      return;
+    }
+  }
+
+  ProfileNode* node = new ProfileNode();
+  node->name = name;
+  node->parent = current;
+  node->totalTime = 0;
+  node->minTime = 0;
+  node->maxTime = 0;
+  node->calls = 0;
+
+  current->children.push_back(node);
+  current = node;
+}
+
+void Profiler::Leave(const uint64_t elapsed)
+{
+  if (current == &root)
+    return; // Unbalanced Leave(); ignore it.
+
+  current->totalTime += elapsed;
+  if ((current->calls == 0) || (elapsed < current->minTime))
+    current->minTime = elapsed;
+  if (elapsed > current->maxTime)
+    current->maxTime = elapsed;
+  ++current->calls;
+
+  current = current->parent;
+}
+
+void Profiler::PrintNode(const ProfileNode& node, const size_t depth)
+{
+  for (size_t i = 0; i < depth; ++i)
+    Log::Info << "  ";
+
+  const double total = (double) node.totalTime / 1e9;
+  const double mean = (double) node.totalTime / (double) node.calls / 1e9;
+
+  Log::Info << node.name << ": " << total << "s over " << node.calls
+      << " calls (mean " << mean << "s, min "
+      << ((double) node.minTime / 1e9) << "s, max "
+      << ((double) node.maxTime / 1e9) << "s";
+
+  // Attribute this region's time to its parent, if the parent was timed.
+  if ((node.parent != NULL) && (node.parent->totalTime > 0))
+    Log::Info << "; " << (100.0 * (double) node.totalTime /
+        (double) node.parent->totalTime) << "% of " << node.parent->name;
+
+  Log::Info << ")" << std::endl;
+
+  for (size_t i = 0; i < node.children.size(); ++i)
+    PrintNode(*node.children[i], depth + 1);
+}
+
+void Profiler::Print()
+{
+  if (root.children.empty())
+  {
+    Log::Info << "No profile regions were recorded." << std::endl;
+    return;
+  }
+
+  Log::Info << "Profile (times in seconds):" << std::endl;
+  for (size_t i = 0; i < root.children.size(); ++i)
+    PrintNode(*root.children[i], 1);
+}
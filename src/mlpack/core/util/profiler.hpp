@@ -0,0 +1,150 @@
+/**
+ * @file profiler.hpp
+ * @author Matthew Amidon
+ *
+ * A hierarchical, low-overhead profiler.  Unlike the Timer class, which keeps
+ * a flat map of named timers and pays a map lookup per Start()/Stop(), the
+ * profiler maintains a tree of timed regions with per-call statistics (call
+ * count, total, min, max) and parent/child attribution.  It is cheap enough
+ * to wrap hot functions like BaseCase() or Score() and answer the question
+ * "where did the traversal time go".
+ */
+#ifndef __MLPACK_CORE_UTIL_PROFILER_HPP
+#define __MLPACK_CORE_UTIL_PROFILER_HPP
+
+#include <cstddef>
+#include <vector>
+
+#if defined(_WIN32)
+  #include <windows.h> // QueryPerformanceCounter().
+
+  // uint64_t isn't defined on every windows.
+  #if !defined(HAVE_UINT64_T)
+    #if SIZEOF_UNSIGNED_LONG == 8
+      typedef unsigned long uint64_t;
+    #else
+      typedef unsigned long long  uint64_t;
+    #endif  // SIZEOF_UNSIGNED_LONG
+  #endif  // HAVE_UINT64_T
+#else
+  #include <stdint.h> // uint64_t.
+#endif
+
+namespace mlpack {
+namespace util {
+
+/**
+ * A single node in the profile tree: one timed region, as observed under a
+ * particular parent region.  The same region name may appear under several
+ * parents; each occurrence has its own node, which is what gives parent/child
+ * attribution.
+ */
+struct ProfileNode
+{
+  //! Name of the region (must be a string literal; only the pointer and, on
+  //! mismatch, the characters are compared).
+  const char* name;
+  //! Parent node (NULL for the root).
+  ProfileNode* parent;
+  //! Child regions entered while this region was active.
+  std::vector<ProfileNode*> children;
+
+  //! Total time spent in this region, in nanoseconds.
+  uint64_t totalTime;
+  //! Shortest single call, in nanoseconds.
+  uint64_t minTime;
+  //! Longest single call, in nanoseconds.
+  uint64_t maxTime;
+  //! Number of calls.
+  size_t calls;
+};
+
+/**
+ * The static profiler state: the tree of profiled regions and the region
+ * currently being timed.  Regions are entered and left via the ProfileRegion
+ * scope guard (or the MLPACK_PROFILE macro), not by calling Enter()/Leave()
+ * directly.
+ *
+ * The profiler is not thread-safe; profile serial runs, or only the master
+ * thread.
+ */
+class Profiler
+{
+ public:
+  /**
+   * Get a monotonic timestamp in nanoseconds.  This uses the fastest
+   * monotonic clock available on the platform.
+   */
+  static uint64_t Timestamp();
+
+  /**
+   * Enter the region with the given name, creating a node for it under the
+   * current region if necessary.  The name must be a string literal (its
+   * address is used as the fast-path identity of the region).
+   */
+  static void Enter(const char* name);
+
+  /**
+   * Leave the current region, attributing the given elapsed time (in
+   * nanoseconds) to it.
+   */
+  static void Leave(const uint64_t elapsed);
+
+  /**
+   * Print the profile tree to Log::Info, with total time, call count, mean,
+   * min, max, and each region's share of its parent's time.
+   */
+  static void Print();
+
+  //! Get the root of the profile tree (for inspection; never timed itself).
+  static const ProfileNode& Root() { return root; }
+
+ private:
+  //! The root of the profile tree (never timed itself).
+  static ProfileNode root;
+  //! The region currently being timed.
+  static ProfileNode* current;
+
+  //! Print one node and its children, indented to the given depth.
+  static void PrintNode(const ProfileNode& node, const size_t depth);
+};
+
+/**
+ * Scope guard that times a region of code.  Prefer the MLPACK_PROFILE macro:
+ *
+ * @code
+ * void Rules::BaseCase(...)
+ * {
+ *   MLPACK_PROFILE("base_case");
+ *   ...
+ * }
+ * @endcode
+ */
+class ProfileRegion
+{
+ public:
+  //! Enter the given region (name must be a string literal).
+  ProfileRegion(const char* name) : start(Profiler::Timestamp())
+  {
+    Profiler::Enter(name);
+  }
+
+  //! Leave the region, recording the elapsed time.
+  ~ProfileRegion()
+  {
+    Profiler::Leave(Profiler::Timestamp() - start);
+  }
+
+ private:
+  //! Timestamp at which the region was entered.
+  uint64_t start;
+};
+
+}; // namespace util
+}; // namespace mlpack
+
+//! Time the enclosing scope as a profile region with the given name.
+#define MLPACK_PROFILE(name) \
+    mlpack::util::ProfileRegion profileRegion_(name)
+
+#endif // __MLPACK_CORE_UTIL_PROFILER_HPP
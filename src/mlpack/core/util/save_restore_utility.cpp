@@ -7,12 +7,65 @@
  *   restoring models.  The current output file type is XML.
  */
 #include <mlpack/core.hpp>
+#include <fstream>
 
 using namespace mlpack;
 using namespace mlpack::util;
 
+//! Magic string identifying a binary model file.
+static const char modelMagic[4] = { 'M', 'L', 'M', 'B' };
+//! Version of the binary model format that we write.
+static const arma::u32 modelVersion = 1;
+
+//! Write a length-prefixed string to a binary model file.
+static void WriteBinaryString(std::ostream& stream, const std::string& str)
+{
+  const arma::u32 length = (arma::u32) str.length();
+  stream.write((const char*) &length, sizeof(length));
+  stream.write(str.data(), length);
+}
+
+//! Read a length-prefixed string from a binary model file.
+static std::string ReadBinaryString(std::istream& stream)
+{
+  arma::u32 length = 0;
+  stream.read((char*) &length, sizeof(length));
+  std::string str((size_t) length, '\0');
+  if (length > 0)
+    stream.read(&str[0], length);
+  return str;
+}
+
 bool SaveRestoreUtility::ReadFile(const std::string& filename)
 {
+  // Binary model files are identified by their magic string; anything else is
+  // parsed as XML.
+  std::ifstream stream(filename.c_str(),
+      std::ifstream::in | std::ifstream::binary);
+  if (stream.is_open())
+  {
+    char magic[4] = { 0, 0, 0, 0 };
+    stream.read(magic, 4);
+    if (stream.good() &&
+        (magic[0] == modelMagic[0]) && (magic[1] == modelMagic[1]) &&
+        (magic[2] == modelMagic[2]) && (magic[3] == modelMagic[3]))
+    {
+      arma::u32 version = 0;
+      stream.read((char*) &version, sizeof(version));
+      if (version != modelVersion)
+        Log::Fatal << "Unknown binary model format version " << version
+            << " in '" << filename << "'!" << std::endl;
+
+      ReadBinary(stream);
+      if (!stream)
+        Log::Fatal << "Binary model file '" << filename << "' is truncated!"
+            << std::endl;
+
+      return true;
+    }
+    stream.close();
+  }
+
   xmlDocPtr xmlDocTree = NULL;
   if (NULL == (xmlDocTree = xmlReadFile(filename.c_str(), NULL, 0)))
   {
@@ -25,9 +78,47 @@ bool SaveRestoreUtility::ReadFile(const std::string& filename)
   return true;
 }
 
+void SaveRestoreUtility::ReadBinary(std::istream& stream)
+{
+  parameters.clear();
+  matParameters.clear();
+  children.clear();
+
+  arma::u32 count = 0;
+  stream.read((char*) &count, sizeof(count));
+  for (arma::u32 i = 0; i < count; ++i)
+  {
+    const std::string name = ReadBinaryString(stream);
+    parameters[name] = ReadBinaryString(stream);
+  }
+
+  stream.read((char*) &count, sizeof(count));
+  for (arma::u32 i = 0; i < count; ++i)
+  {
+    const std::string name = ReadBinaryString(stream);
+    arma::u64 rows = 0;
+    arma::u64 cols = 0;
+    stream.read((char*) &rows, sizeof(rows));
+    stream.read((char*) &cols, sizeof(cols));
+
+    arma::mat& matrix = matParameters[name];
+    matrix.set_size((size_t) rows, (size_t) cols);
+    stream.read((char*) matrix.memptr(),
+        (std::streamsize) (matrix.n_elem * sizeof(double)));
+  }
+
+  stream.read((char*) &count, sizeof(count));
+  for (arma::u32 i = 0; i < count; ++i)
+  {
+    const std::string name = ReadBinaryString(stream);
+    children[name].ReadBinary(stream);
+  }
+}
+
 void SaveRestoreUtility::ReadFile(xmlNode* n)
 {
   parameters.clear();
+  matParameters.clear();
   xmlNodePtr current = NULL;
   for (current = n; current; current = current->next)
   {
@@ -49,6 +140,21 @@ void SaveRestoreUtility::ReadFile(xmlNode* n)
 
 bool SaveRestoreUtility::WriteFile(const std::string& filename)
 {
+  // Write a binary model file if the extension asks for one.
+  const size_t ext = filename.rfind('.');
+  if ((ext != std::string::npos) && (filename.substr(ext + 1) == "bin"))
+  {
+    std::ofstream stream(filename.c_str(),
+        std::ofstream::out | std::ofstream::binary);
+    if (!stream.is_open())
+      return false;
+
+    stream.write(modelMagic, 4);
+    stream.write((const char*) &modelVersion, sizeof(modelVersion));
+    WriteBinary(stream);
+    return stream.good();
+  }
+
   bool success = false;
   xmlDocPtr xmlDocTree = xmlNewDoc(BAD_CAST "1.0");
   xmlNodePtr root = xmlNewNode(NULL, BAD_CAST "root");
@@ -70,6 +176,24 @@ void SaveRestoreUtility::WriteFile(xmlNode* n)
     xmlNewChild(n, NULL, BAD_CAST(*it).first.c_str(),
         BAD_CAST(*it).second.c_str());
   }
+  // Matrix parameters are stored natively; convert them to text for XML
+  // output.
+  for (std::map<std::string, arma::mat>::const_iterator it =
+      matParameters.begin(); it != matParameters.end(); ++it)
+  {
+    const arma::mat& mat = it->second;
+    std::ostringstream output;
+    for (size_t r = 0; r < mat.n_rows; ++r)
+    {
+      for (size_t c = 0; c < mat.n_cols - 1; ++c)
+      {
+        output << std::setprecision(15) << mat(r, c) << ",";
+      }
+      output << std::setprecision(15) << mat(r, mat.n_cols - 1) << std::endl;
+    }
+    xmlNewChild(n, NULL, BAD_CAST(*it).first.c_str(),
+        BAD_CAST output.str().c_str());
+  }
   xmlNodePtr child;
   for (std::map<std::string, SaveRestoreUtility>::iterator it =
        children.begin(); it != children.end(); ++it)
@@ -79,9 +203,56 @@ void SaveRestoreUtility::WriteFile(xmlNode* n)
   }
 }
 
+void SaveRestoreUtility::WriteBinary(std::ostream& stream) const
+{
+  arma::u32 count = (arma::u32) parameters.size();
+  stream.write((const char*) &count, sizeof(count));
+  for (std::map<std::string, std::string>::const_iterator it =
+      parameters.begin(); it != parameters.end(); ++it)
+  {
+    WriteBinaryString(stream, it->first);
+    WriteBinaryString(stream, it->second);
+  }
+
+  count = (arma::u32) matParameters.size();
+  stream.write((const char*) &count, sizeof(count));
+  for (std::map<std::string, arma::mat>::const_iterator it =
+      matParameters.begin(); it != matParameters.end(); ++it)
+  {
+    WriteBinaryString(stream, it->first);
+    const arma::u64 rows = it->second.n_rows;
+    const arma::u64 cols = it->second.n_cols;
+    stream.write((const char*) &rows, sizeof(rows));
+    stream.write((const char*) &cols, sizeof(cols));
+    // Dump the matrix payload raw; no text conversion and no precision loss.
+    stream.write((const char*) it->second.memptr(),
+        (std::streamsize) (it->second.n_elem * sizeof(double)));
+  }
+
+  count = (arma::u32) children.size();
+  stream.write((const char*) &count, sizeof(count));
+  for (std::map<std::string, SaveRestoreUtility>::const_iterator it =
+      children.begin(); it != children.end(); ++it)
+  {
+    WriteBinaryString(stream, it->first);
+    it->second.WriteBinary(stream);
+  }
+}
+
 arma::mat& SaveRestoreUtility::LoadParameter(arma::mat& matrix,
                                              const std::string& name) const
 {
+  // Natively stored matrices (from SaveParameter() or a binary model file)
+  // can be copied directly.
+  std::map<std::string, arma::mat>::const_iterator mit =
+      matParameters.find(name);
+  if (mit != matParameters.end())
+  {
+    matrix = mit->second;
+    return matrix;
+  }
+
+  // Otherwise, the matrix came from an XML file and must be parsed from text.
   std::map<std::string, std::string>::const_iterator it = parameters.find(name);
   if (it != parameters.end())
   {
@@ -182,18 +353,9 @@ void SaveRestoreUtility::SaveParameter(const char c, const std::string& name)
 void SaveRestoreUtility::SaveParameter(const arma::mat& mat,
                                        const std::string& name)
 {
-  std::ostringstream output;
-  size_t columns = mat.n_cols;
-  size_t rows = mat.n_rows;
-  for (size_t r = 0; r < rows; ++r)
-  {
-    for (size_t c = 0; c < columns - 1; ++c)
-    {
-      output << std::setprecision(15) << mat(r, c) << ",";
-    }
-    output << std::setprecision(15) << mat(r, columns - 1) << std::endl;
-  }
-  parameters[name] = output.str();
+  // Store the matrix natively; the XML writer converts it to text on demand,
+  // and the binary writer dumps the payload raw.
+  matParameters[name] = mat;
 }
 
 // Special template specializations for vectors.
@@ -32,6 +32,13 @@ class SaveRestoreUtility
    */
   std::map<std::string, std::string> parameters;
 
+  /**
+   * matParameters contains matrix-valued parameters, stored natively so that
+   * saving does not pay for a text conversion and binary output can dump the
+   * payload raw.
+   */
+  std::map<std::string, arma::mat> matParameters;
+
   /**
    * children contains a list of names in string format and child
    * models in the model hierarchy in SaveRestoreUtility format
@@ -49,12 +56,16 @@ class SaveRestoreUtility
   ~SaveRestoreUtility() { parameters.clear(); }
 
   /**
-   * ReadFile reads an XML tree from a file.
+   * ReadFile reads a model from a file.  Binary model files are detected by
+   * their magic string; any other file is parsed as an XML tree.
    */
   bool ReadFile(const std::string& filename);
 
   /**
-   * WriteFile writes the XML tree to a file.
+   * WriteFile writes the model to a file.  If the filename has the extension
+   * .bin, a binary model file is written (with raw matrix payloads, which is
+   * far faster and smaller for large models); otherwise an XML tree is
+   * written.
    */
   bool WriteFile(const std::string& filename);
 
@@ -135,6 +146,18 @@ class SaveRestoreUtility
    */
   void ReadFile(xmlNode* n);
 
+  /**
+   * WriteBinary writes this model (and its children, recursively) to the
+   * given stream in the binary model format.
+   */
+  void WriteBinary(std::ostream& stream) const;
+
+  /**
+   * ReadBinary reads this model (and its children, recursively) from the
+   * given stream in the binary model format.
+   */
+  void ReadBinary(std::istream& stream);
+
 };
 
 //! Specialization for arma::vec.
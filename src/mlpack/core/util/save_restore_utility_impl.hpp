@@ -78,6 +78,9 @@ void SaveRestoreUtility::SaveParameter(const std::vector<T>& t,
                                        const std::string& name)
 {
   std::ostringstream output;
+  // Manually increase precision, as is done for single parameters above, so
+  // that floating-point elements survive a round trip.
+  output << std::setprecision(15);
   for (size_t index = 0; index < t.size(); ++index)
   {
     output << t[index] << ",";
@@ -60,9 +60,15 @@ class AdaBoost
   double tolerance;
 
   /**
-   * Classification Function. 
+   * Classification Function.
+   *
+   * If predictedLabels is already of the correct length, it is reused without
+   * reallocation, and the internal vote matrix and weak learner prediction
+   * buffer are likewise reused, so classifying many same-sized batches
+   * performs no allocation after the first call.
+   *
    * @param test Testing data.
-   * @param predictedLabels Vector to store the predicted labels of the 
+   * @param predictedLabels Vector to store the predicted labels of the
    *                         test set.
    */
   void Classify(const MatType& test, arma::Row<size_t>& predictedLabels);
@@ -87,7 +93,13 @@ private:
 
   // To check for the bound for the hammingLoss.
   double ztProduct;
-  
+
+  //! Reusable buffer for the predictions of each weak learner during
+  //! Classify(), so that repeated calls do not reallocate it.
+  arma::Row<size_t> tempPredictedLabels;
+  //! Reusable matrix of accumulated weighted votes for each class.
+  arma::mat cMatrix;
+
 }; // class AdaBoost
 
 } // namespace adaboost
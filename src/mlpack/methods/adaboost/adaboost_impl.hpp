@@ -59,9 +59,6 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
   // To be used for prediction by the Weak Learner for prediction.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input Data for incorporating weights.
-  MatType tempData(data);
-
   // This matrix is a helper matrix used to calculate the final hypothesis.
   arma::mat sumFinalH(predictedLabels.n_cols, numClasses);
   sumFinalH.fill(0.0);
@@ -92,9 +89,11 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
     // Build the weight vectors
     BuildWeightMatrix(D, weights);
 
-    // call the other weak learner and train the labels.
-    WeakLearner w(other, tempData, weights, labels);
-    w.Classify(tempData, predictedLabels);
+    // Call the other weak learner and train the labels.  The weights are
+    // passed to the weak learner directly; the dataset itself is never
+    // modified, so no copy of it is needed.
+    WeakLearner w(other, data, weights, labels);
+    w.Classify(data, predictedLabels);
 
     // Now from predictedLabels, build ht, the weak hypothesis
     // buildClassificationMatrix(ht, predictedLabels);
@@ -205,10 +204,11 @@ void AdaBoost<MatType, WeakLearner>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(predictedLabels.n_cols);
-  arma::mat cMatrix(numClasses, test.n_cols);
-
-  cMatrix.zeros();
+  // These members only reallocate if the batch size has changed since the
+  // last call.
+  tempPredictedLabels.set_size(test.n_cols);
+  cMatrix.zeros(numClasses, test.n_cols);
+  predictedLabels.set_size(1, test.n_cols);
   predictedLabels.zeros();
 
   for (size_t i = 0;i < wl.size(); i++)
@@ -218,13 +218,12 @@ void AdaBoost<MatType, WeakLearner>::Classify(
     for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
       cMatrix(tempPredictedLabels(j), j) += (alpha[i] * tempPredictedLabels(j));
   }
-  
-  arma::colvec cMRow;
+
   arma::uword max_index;
 
   for (size_t i = 0; i < predictedLabels.n_cols; i++)
   {
-    cMRow = cMatrix.col(i);
+    arma::vec cMRow = cMatrix.unsafe_col(i);
     cMRow.max(max_index);
     predictedLabels(i) = max_index;
   }
@@ -0,0 +1,152 @@
+/**
+ * @file nndsvd_init.hpp
+ * @author Sumedh Ghaisas
+ *
+ * Intialization rule for Alternating Matrix Factorization.
+ */
+#ifndef __MLPACK_METHODS_LMF_NNDSVD_INIT_HPP
+#define __MLPACK_METHODS_LMF_NNDSVD_INIT_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class initializes the W and H matrices of the AMF algorithm with the
+ * NNDSVD scheme of Boutsidis and Gallopoulos ("SVD based initialization: a
+ * head start for nonnegative matrix factorization", 2008).  Each of the
+ * leading r singular triplets of V is split into its nonnegative parts, and
+ * the larger part is scaled into a column of W and a row of H.  Compared to a
+ * random start, this places the factorization near the best rank-r subspace
+ * from the beginning, which typically saves a large number of update
+ * iterations at the cost of one truncated decomposition.
+ *
+ * The leading singular triplets are computed with the truncated randomized
+ * SVD of Halko, Martinsson and Tropp ("Finding structure with randomness",
+ * 2011): a few multiplication passes over V and an exact SVD of a small
+ * projected matrix.  The multiplications are templated on the matrix type, so
+ * sparse inputs are never densified.
+ *
+ * Multiplicative update rules cannot change entries that start at exactly
+ * zero, so the zeros the splitting produces are replaced with a small
+ * positive value derived from the mean of V.
+ */
+class NNDSVDInitialization
+{
+ public:
+  /**
+   * Create the NNDSVDInitialization object with the given parameters of the
+   * underlying randomized SVD (or the defaults).
+   *
+   * @param oversampling Number of random projections beyond the target rank.
+   * @param powerIterations Number of power iterations for spectrum sharpening.
+   */
+  NNDSVDInitialization(const size_t oversampling = 5,
+                       const size_t powerIterations = 2) :
+      oversampling(oversampling),
+      powerIterations(powerIterations)
+  { }
+
+  template<typename MatType>
+  inline void Initialize(const MatType& V,
+                         const size_t r,
+                         arma::mat& W,
+                         arma::mat& H) const
+  {
+    const size_t n = V.n_rows;
+    const size_t m = V.n_cols;
+
+    // Stage A of the randomized SVD: an orthonormal basis Q whose range
+    // approximates the range of V, found by applying V to random vectors.
+    const size_t subspaceSize = std::min(r + oversampling, std::min(n, m));
+    arma::mat Q, R;
+    arma::qr_econ(Q, R, V * arma::randn<arma::mat>(m, subspaceSize));
+
+    // Power iterations sharpen the spectrum of the sampled subspace.
+    for (size_t i = 0; i < powerIterations; ++i)
+    {
+      arma::qr_econ(Q, R, arma::trans(V) * Q);
+      arma::qr_econ(Q, R, V * Q);
+    }
+
+    // Stage B: exact SVD of the small projected matrix trans(Q) * V.  The
+    // projection is written as trans(trans(V) * Q) so that a sparse V is
+    // multiplied from the left.
+    arma::mat B = arma::trans(arma::trans(V) * Q);
+    arma::mat leftSmall, right;
+    arma::vec sigma;
+    arma::svd_econ(leftSmall, sigma, right, B);
+
+    // Lift the left singular vectors back to the original space.
+    arma::mat left = Q * leftSmall;
+
+    W.zeros(n, r);
+    H.zeros(r, m);
+
+    // The leading singular vectors of a nonnegative matrix can be taken
+    // nonnegative, so the first triplet is used directly.
+    W.col(0) = std::sqrt(sigma[0]) * arma::abs(left.col(0));
+    H.row(0) = std::sqrt(sigma[0]) * arma::trans(arma::abs(right.col(0)));
+
+    // The randomized decomposition cannot produce more triplets than the
+    // subspace holds; any remaining columns are left to the zero fill below.
+    const size_t rank = std::min(r, (size_t) sigma.n_elem);
+    for (size_t j = 1; j < rank; ++j)
+    {
+      const arma::vec u = left.col(j);
+      const arma::vec v = right.col(j);
+
+      // Split the singular vectors into their nonnegative parts.
+      const arma::vec up = (arma::abs(u) + u) / 2;
+      const arma::vec un = (arma::abs(u) - u) / 2;
+      const arma::vec vp = (arma::abs(v) + v) / 2;
+      const arma::vec vn = (arma::abs(v) - v) / 2;
+
+      const double upNorm = arma::norm(up, 2);
+      const double unNorm = arma::norm(un, 2);
+      const double vpNorm = arma::norm(vp, 2);
+      const double vnNorm = arma::norm(vn, 2);
+
+      // Keep whichever pair of parts carries more of the triplet's energy,
+      // rescaled so their outer product keeps the singular value's weight.
+      const double positiveTerm = upNorm * vpNorm;
+      const double negativeTerm = unNorm * vnNorm;
+
+      if (positiveTerm >= negativeTerm && positiveTerm > 0)
+      {
+        const double scale = std::sqrt(sigma[j] * positiveTerm);
+        W.col(j) = (scale / upNorm) * up;
+        H.row(j) = (scale / vpNorm) * arma::trans(vp);
+      }
+      else if (negativeTerm > 0)
+      {
+        const double scale = std::sqrt(sigma[j] * negativeTerm);
+        W.col(j) = (scale / unNorm) * un;
+        H.row(j) = (scale / vnNorm) * arma::trans(vn);
+      }
+    }
+
+    // Multiplicative update rules never move entries that start at exactly
+    // zero, so replace the zeros with a small positive value based on the
+    // mean of the input.
+    const double zeroFill = arma::accu(V) / (100.0 * n * m);
+    for (size_t i = 0; i < W.n_elem; ++i)
+      if (W[i] <= 0)
+        W[i] = zeroFill;
+    for (size_t i = 0; i < H.n_elem; ++i)
+      if (H[i] <= 0)
+        H[i] = zeroFill;
+  }
+
+ private:
+  //! Number of extra random projections in the randomized SVD.
+  size_t oversampling;
+  //! Number of power iterations in the randomized SVD.
+  size_t powerIterations;
+}; // Class NNDSVDInitialization
+
+}; // namespace amf
+}; // namespace mlpack
+
+#endif
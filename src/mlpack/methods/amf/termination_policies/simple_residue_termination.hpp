@@ -62,8 +62,11 @@ class SimpleResidueTermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    // Calculate the norm and compute the residue
-    const double norm = arma::norm(W * H, "fro");
+    // Calculate the norm and compute the residue.  The Frobenius norm
+    // satisfies || W H ||_F^2 = accu((W^T W) % (H H^T)), which works on the
+    // rank-sized Gram matrices instead of reconstructing the dense W H; this
+    // drops the cost of the check from O(n m k) to O((n + m) k^2).
+    const double norm = sqrt(arma::accu((W.t() * W) % (H * H.t())));
     residue = fabs(normOld - norm) / normOld;
 
     // Store the norm.
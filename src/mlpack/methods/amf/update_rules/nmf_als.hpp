@@ -52,7 +52,21 @@ class NMFALSUpdate
   {
     // The call to inv() sometimes fails; so we are using the psuedoinverse.
     // W = (inv(H * H.t()) * H * V.t()).t();
-    W = V * H.t() * pinv(H * H.t());
+    //
+    // Every row of W is an independent least squares solve against the same
+    // rank-sized projection, so the rows are computed in blocks divided among
+    // the threads (each block is one small matrix product).  The loop index
+    // is signed for OpenMP.
+    const arma::mat projection = H.t() * pinv(H * H.t());
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < (long) W.n_rows; i += rowBlockSize)
+    {
+      const size_t endRow = std::min((size_t) i + rowBlockSize,
+          (size_t) W.n_rows) - 1;
+      W.rows(i, endRow) = V.rows(i, endRow) * projection;
+    }
 
     // Set all negative numbers to machine epsilon
     for (size_t i = 0; i < W.n_elem; i++)
@@ -81,7 +95,19 @@ class NMFALSUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = pinv(W.t() * W) * W.t() * V;
+    // As in WUpdate(), the columns of H are independent solves against the
+    // same projection, so they are computed in blocks divided among the
+    // threads.
+    const arma::mat projection = pinv(W.t() * W) * W.t();
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < (long) H.n_cols; i += rowBlockSize)
+    {
+      const size_t endCol = std::min((size_t) i + rowBlockSize,
+          (size_t) H.n_cols) - 1;
+      H.cols(i, endCol) = projection * V.cols(i, endCol);
+    }
 
     // Set all negative numbers to 0.
     for (size_t i = 0; i < H.n_elem; i++)
@@ -92,8 +118,101 @@ class NMFALSUpdate
       }
     }
   }
+
+ private:
+  //! Number of rows (or columns) solved per scheduling unit.
+  static const size_t rowBlockSize = 64;
 }; // class NMFALSUpdate
 
+/**
+ * WUpdate function specialization for sparse matrix.  The product
+ * \f$ VH^T \f$ is accumulated over the nonzero entries of V only, so the
+ * per-iteration cost is proportional to the number of nonzeros.
+ */
+template<>
+inline void NMFALSUpdate::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                arma::mat& W,
+                                                const arma::mat& H)
+{
+  arma::mat vHt(V.n_rows, H.n_rows);
+  vHt.zeros();
+
+  // Nonzeros in different columns may fall on the same row of the
+  // accumulator, so each thread accumulates into its own workspace and the
+  // workspaces are combined at the end.  The loop index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    arma::mat threadVHt(V.n_rows, H.n_rows);
+    threadVHt.zeros();
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 64)
+#endif
+    for (long col = 0; col < (long) V.n_cols; ++col)
+    {
+      for (arma::sp_mat::const_iterator it = V.begin_col(col);
+           it != V.end_col(col); ++it)
+        threadVHt.row(it.row()) += (*it) * arma::trans(H.col(col));
+    }
+
+#ifdef _OPENMP
+    #pragma omp critical (nmfAlsAccumulate)
+#endif
+    vHt += threadVHt;
+  }
+
+  // The call to inv() sometimes fails; so we are using the psuedoinverse.
+  W = vHt * pinv(H * H.t());
+
+  // Set all negative numbers to machine epsilon
+  for (size_t i = 0; i < W.n_elem; i++)
+  {
+    if (W(i) < 0.0)
+    {
+      W(i) = 0.0;
+    }
+  }
+}
+
+/**
+ * HUpdate function specialization for sparse matrix.  As with WUpdate(), the
+ * product \f$ W^TV \f$ is accumulated over the nonzero entries of V only.
+ */
+template<>
+inline void NMFALSUpdate::HUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                const arma::mat& W,
+                                                arma::mat& H)
+{
+  arma::mat wtV(W.n_cols, V.n_cols);
+  wtV.zeros();
+
+  // The nonzeros of a column of V touch only the matching column of the
+  // accumulator, so the columns are simply divided among the threads.  The
+  // loop index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (long col = 0; col < (long) V.n_cols; ++col)
+  {
+    for (arma::sp_mat::const_iterator it = V.begin_col(col);
+         it != V.end_col(col); ++it)
+      wtV.col(col) += (*it) * arma::trans(W.row(it.row()));
+  }
+
+  H = pinv(W.t() * W) * wtV;
+
+  // Set all negative numbers to 0.
+  for (size_t i = 0; i < H.n_elem; i++)
+  {
+    if (H(i) < 0.0)
+    {
+      H(i) = 0.0;
+    }
+  }
+}
+
 }; // namespace amf
 }; // namespace mlpack
 
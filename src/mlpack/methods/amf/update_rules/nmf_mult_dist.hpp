@@ -74,6 +74,46 @@ class NMFMultiplicativeDistanceUpdate
   }
 };
 
+/**
+ * WUpdate function specialization for sparse matrix.  The numerator
+ * \f$ VH^T \f$ is accumulated over the nonzero entries of V only, and the
+ * denominator is grouped as \f$ W(HH^T) \f$ so that no term depends on the
+ * (mostly zero) size of V; this makes the per-iteration cost proportional to
+ * the number of nonzeros.
+ */
+template<>
+inline void NMFMultiplicativeDistanceUpdate::WUpdate<arma::sp_mat>(
+    const arma::sp_mat& V,
+    arma::mat& W,
+    const arma::mat& H)
+{
+  arma::mat vHt(V.n_rows, H.n_rows);
+  vHt.zeros();
+  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
+    vHt.row(it.row()) += (*it) * arma::trans(H.col(it.col()));
+
+  W = (W % vHt) / (W * (H * H.t()));
+}
+
+/**
+ * HUpdate function specialization for sparse matrix.  As with WUpdate(), the
+ * numerator \f$ W^TV \f$ is accumulated over the nonzero entries of V only
+ * and the denominator is grouped as \f$ (W^TW)H \f$.
+ */
+template<>
+inline void NMFMultiplicativeDistanceUpdate::HUpdate<arma::sp_mat>(
+    const arma::sp_mat& V,
+    const arma::mat& W,
+    arma::mat& H)
+{
+  arma::mat wtV(W.n_cols, V.n_cols);
+  wtV.zeros();
+  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
+    wtV.col(it.col()) += (*it) * arma::trans(W.row(it.row()));
+
+  H = (H % wtV) / ((W.t() * W) * H);
+}
+
 }; // namespace amf
 }; // namespace mlpack
 
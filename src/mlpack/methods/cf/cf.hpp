@@ -147,7 +147,13 @@ class CF
   const arma::sp_mat& CleanedData() const { return cleanedData; }
 
   /**
-   * Generates the given number of recommendations for all users.
+   * Generates the given number of recommendations for all users.  This is the
+   * batch path: the neighbor search structure is built only once (and
+   * searched monochromatically, with no copied query set), and the
+   * recommendations are generated in independent blocks of users with the
+   * rating reconstruction done as one matrix multiplication per block, so it
+   * is much faster and leaner than querying every user through the other
+   * overload.
    *
    * @param numRecs Number of Recommendations
    * @param recommendations Matrix to save recommendations into.
@@ -166,6 +172,35 @@ class CF
                           arma::Mat<size_t>& recommendations,
                           arma::Col<size_t>& users);
 
+  /**
+   * Fold a single new (or changed) rating into the trained model without
+   * refactorizing the rating matrix.  The rating is inserted into the rating
+   * matrix, and the affected row of W and column of H are re-solved by least
+   * squares against the fixed opposite factor (the fold-in of Sarwar et al.).
+   * Unknown user or item indices grow the model.  Neighborhoods are computed
+   * from the current factors at recommendation time, so later calls to
+   * GetRecommendations() reflect the new rating immediately.
+   *
+   * Folded-in estimates drift away from a full joint factorization as
+   * updates accumulate, so a periodic full rebuild is still advisable.
+   *
+   * @param user Index of the user giving the rating.
+   * @param item Index of the rated item.
+   * @param value Value of the rating.
+   */
+  void AddRating(const size_t user, const size_t item, const double value);
+
+  /**
+   * Fold a new user with the given ratings into the trained model without
+   * refactorizing the rating matrix; see AddRating() for the scheme.  The
+   * ratings matrix must have two rows: the first holds item indices and the
+   * second holds the corresponding rating values (one column per rating).
+   *
+   * @param ratings Ratings of the new user (2 x n matrix).
+   * @return Index assigned to the new user.
+   */
+  size_t AddUser(const arma::mat& ratings);
+
   /**
    * Returns a string representation of this object.
    */
@@ -189,6 +224,25 @@ class CF
   //! Converts the User, Item, Value Matrix to User-Item Table
   void CleanData(const arma::mat& data);
 
+  /**
+   * Re-solve the factor column of the given user by least squares against
+   * the fixed item factor W, using only the items the user has rated.
+   */
+  void UpdateUserFactor(const size_t user);
+
+  /**
+   * Re-solve the factor row of the given item by least squares against the
+   * fixed user factor H, using only the users who rated the item.
+   */
+  void UpdateItemFactor(const size_t item);
+
+  /**
+   * Grow the rating matrix and the factors to the given shape, keeping all
+   * existing entries.  This copies the coordinate list of the rating matrix;
+   * it does not refactorize.
+   */
+  void GrowRatingMatrix(const size_t items, const size_t users);
+
   /**
    * Helper function to insert a point into the recommendation matrices.
    *
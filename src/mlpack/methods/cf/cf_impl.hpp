@@ -100,15 +100,110 @@ template<typename FactorizerType>
 void CF<FactorizerType>::GetRecommendations(const size_t numRecs,
                                             arma::Mat<size_t>& recommendations)
 {
-  // Generate list of users.  Maybe it would be more efficient to pass an empty
-  // users list, and then have the other overload of GetRecommendations() assume
-  // that if users is empty, then recommendations should be generated for all
-  // users?
-  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
-      cleanedData.n_cols - 1, cleanedData.n_cols);
-
-  // Call the main overload for recommendations.
-  GetRecommendations(numRecs, recommendations, users);
+  // This overload is the batch path.  Instead of copying every user's feature
+  // vector into a separate query set, the neighbor search structure is built
+  // once over the reconstructed rating matrix and searched monochromatically,
+  // and the recommendations are then generated in blocks of users, so that
+  // the scratch matrices stay small no matter how many users there are.
+
+  // Generate the rating table by multiplying the approximate values; this is
+  // a single large BLAS call.
+  rating = w * h;
+
+  // A monochromatic search does not return a query point as its own neighbor,
+  // but the query-set overload does (each queried user's feature vector is an
+  // exact copy of a reference point).  So, to produce identical
+  // neighborhoods, search for one neighbor fewer and add the user itself to
+  // its own neighborhood average below.
+  arma::Mat<size_t> neighborhood;
+  if (numUsersForSimilarity > 1)
+  {
+    neighbor::AllkNN a(rating);
+    arma::mat resultingDistances; // Temporary storage.
+    a.Search(numUsersForSimilarity - 1, neighborhood, resultingDistances);
+  }
+  else
+  {
+    // The neighborhood of each user is only the user itself.
+    neighborhood.set_size(0, rating.n_cols);
+  }
+
+  recommendations.set_size(numRecs, rating.n_cols);
+
+  // Process the users in fixed-size blocks.  The average rating of a user's
+  // neighborhood is w * (average of the neighbors' columns of h), so the
+  // averaging can be done in the low-rank space and then reconstructed with
+  // one gemm per block instead of a gather over full rating columns.  The
+  // blocks are independent, so they can be handled in parallel.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (rating.n_cols + blockSize - 1) / blockSize;
+
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+  #endif
+  for (long block = 0; block < (long) numBlocks; ++block)
+  {
+    const size_t firstUser = (size_t) block * blockSize;
+    const size_t lastUser = std::min(firstUser + blockSize - 1,
+        (size_t) rating.n_cols - 1);
+    const size_t usersInBlock = lastUser - firstUser + 1;
+
+    // Average the neighborhood of each user in the low-rank space.
+    arma::mat blockH(h.n_rows, usersInBlock);
+    for (size_t i = 0; i < usersInBlock; ++i)
+    {
+      blockH.col(i) = h.col(firstUser + i); // The user itself.
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        blockH.col(i) += h.col(neighborhood(j, firstUser + i));
+      blockH.col(i) /= (neighborhood.n_rows + 1);
+    }
+
+    // Reconstruct the average ratings for the whole block at once.
+    arma::mat averages = w * blockH;
+
+    // Find the maximum numRecs elements in the averages matrix for each user.
+    arma::Mat<size_t> blockRecs(numRecs, usersInBlock);
+    blockRecs.fill(cleanedData.n_rows); // Invalid item number.
+    arma::mat values(numRecs, usersInBlock);
+    values.fill(-DBL_MAX); // The smallest possible value.
+    for (size_t i = 0; i < usersInBlock; ++i)
+    {
+      // Look through the averages column corresponding to the current user.
+      for (size_t j = 0; j < averages.n_rows; ++j)
+      {
+        // Ensure that the user hasn't already rated the item.
+        if (cleanedData(j, firstUser + i) != 0.0)
+          continue; // The user already rated the item.
+
+        // Is the estimated value better than the worst candidate?
+        const double value = averages(j, i);
+        if (value > values(values.n_rows - 1, i))
+        {
+          // It should be inserted.  Which position?
+          size_t insertPosition = values.n_rows - 1;
+          while (insertPosition > 0)
+          {
+            if (value <= values(insertPosition - 1, i))
+              break; // The current value is the right one.
+            insertPosition--;
+          }
+
+          // Now insert it into the list.
+          InsertNeighbor(i, insertPosition, j, value, blockRecs, values);
+        }
+      }
+    }
+
+    recommendations.cols(firstUser, lastUser) = blockRecs;
+  }
+
+  // Issue any warnings outside of the parallel region.
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    if (recommendations(numRecs - 1, i) == cleanedData.n_rows)
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << i << " (not enough un-rated items)!" << std::endl;
+  }
 }
 
 template<typename FactorizerType>
@@ -194,6 +289,162 @@ void CF<FactorizerType>::GetRecommendations(const size_t numRecs,
   }
 }
 
+template<typename FactorizerType>
+void CF<FactorizerType>::AddRating(const size_t user,
+                                   const size_t item,
+                                   const double value)
+{
+  // Grow the rating matrix and the factors if the user or item is new.
+  if ((item >= cleanedData.n_rows) || (user >= cleanedData.n_cols))
+  {
+    GrowRatingMatrix(std::max(item + 1, (size_t) cleanedData.n_rows),
+                     std::max(user + 1, (size_t) cleanedData.n_cols));
+  }
+
+  cleanedData(item, user) = value;
+
+  // Fold the rating in: re-solve the affected row of w and column of h
+  // against the fixed opposite factor.
+  UpdateItemFactor(item);
+  UpdateUserFactor(user);
+}
+
+template<typename FactorizerType>
+size_t CF<FactorizerType>::AddUser(const arma::mat& ratings)
+{
+  if (ratings.n_rows != 2)
+    Log::Fatal << "CF::AddUser(): ratings matrix must have two rows (item "
+        << "indices and rating values); " << ratings.n_rows << " given."
+        << std::endl;
+
+  // The new user takes the next free column.
+  const size_t user = cleanedData.n_cols;
+
+  size_t items = cleanedData.n_rows;
+  for (size_t i = 0; i < ratings.n_cols; ++i)
+    items = std::max(items, (size_t) ratings(0, i) + 1);
+  GrowRatingMatrix(items, user + 1);
+
+  for (size_t i = 0; i < ratings.n_cols; ++i)
+    cleanedData((size_t) ratings(0, i), user) = ratings(1, i);
+
+  // Fold the user in, then refresh the factors of the items they rated.
+  UpdateUserFactor(user);
+  for (size_t i = 0; i < ratings.n_cols; ++i)
+    UpdateItemFactor((size_t) ratings(0, i));
+
+  return user;
+}
+
+template<typename FactorizerType>
+void CF<FactorizerType>::UpdateUserFactor(const size_t user)
+{
+  // Gather the items this user has rated.
+  std::vector<arma::uword> items;
+  std::vector<double> values;
+  for (arma::sp_mat::const_iterator it = cleanedData.begin_col(user);
+       it != cleanedData.end_col(user); ++it)
+  {
+    items.push_back(it.row());
+    values.push_back(*it);
+  }
+
+  if (items.empty())
+  {
+    h.col(user).zeros();
+    return;
+  }
+
+  // Least squares against the fixed item factor, restricted to the rated
+  // rows.  pinv() is used instead of solve() for the same reason as in the
+  // ALS update rules: the subproblem may be rank-deficient.
+  arma::mat wSub(items.size(), w.n_cols);
+  arma::vec rSub(items.size());
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    wSub.row(i) = w.row(items[i]);
+    rSub[i] = values[i];
+  }
+
+  arma::vec solution = arma::pinv(wSub) * rSub;
+
+  // Match the nonnegative factorization: clamp negative coordinates.
+  for (size_t i = 0; i < solution.n_elem; ++i)
+    if (solution[i] < 0.0)
+      solution[i] = 0.0;
+
+  h.col(user) = solution;
+}
+
+template<typename FactorizerType>
+void CF<FactorizerType>::UpdateItemFactor(const size_t item)
+{
+  // Gather the users who rated this item.  The rating matrix is stored by
+  // column (by user), so a row gather costs one pass over the users.
+  const arma::rowvec itemRatings(cleanedData.row(item));
+
+  std::vector<arma::uword> users;
+  std::vector<double> values;
+  for (size_t i = 0; i < itemRatings.n_elem; ++i)
+  {
+    if (itemRatings[i] != 0.0)
+    {
+      users.push_back(i);
+      values.push_back(itemRatings[i]);
+    }
+  }
+
+  if (users.empty())
+  {
+    w.row(item).zeros();
+    return;
+  }
+
+  // Least squares against the fixed user factor, restricted to the rating
+  // users.
+  arma::mat hSub(users.size(), h.n_rows);
+  arma::vec rSub(users.size());
+  for (size_t i = 0; i < users.size(); ++i)
+  {
+    hSub.row(i) = arma::trans(h.col(users[i]));
+    rSub[i] = values[i];
+  }
+
+  arma::vec solution = arma::pinv(hSub) * rSub;
+
+  // Match the nonnegative factorization: clamp negative coordinates.
+  for (size_t i = 0; i < solution.n_elem; ++i)
+    if (solution[i] < 0.0)
+      solution[i] = 0.0;
+
+  w.row(item) = arma::trans(solution);
+}
+
+template<typename FactorizerType>
+void CF<FactorizerType>::GrowRatingMatrix(const size_t items,
+                                          const size_t users)
+{
+  // Rebuild the sparse matrix with the larger shape, keeping the nonzeros.
+  // This copies the coordinate list; it does not refactorize.
+  arma::umat locations(2, cleanedData.n_nonzero);
+  arma::vec values(cleanedData.n_nonzero);
+  size_t index = 0;
+  for (arma::sp_mat::const_iterator it = cleanedData.begin();
+       it != cleanedData.end(); ++it)
+  {
+    locations(0, index) = it.row();
+    locations(1, index) = it.col();
+    values[index] = *it;
+    ++index;
+  }
+  cleanedData = arma::sp_mat(locations, values, items, users);
+
+  // Grow the factors to match; new rows and columns start at zero and are
+  // filled by the fold-in solves once their ratings are inserted.
+  w.resize(items, w.n_cols);
+  h.resize(h.n_rows, users);
+}
+
 template<typename FactorizerType>
 void CF<FactorizerType>::CleanData(const arma::mat& data)
 {
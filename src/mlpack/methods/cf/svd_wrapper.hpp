@@ -19,7 +19,71 @@ namespace cf
  * this class as a template parameter to class SVDWrapper will force SVDWrapper
  * to use Armadillo's SVD implementation.
  */
-class DummyClass {}; 
+class DummyClass {};
+
+/**
+ * This class implements the randomized truncated SVD of Halko, Martinsson and
+ * Tropp ("Finding structure with randomness", 2011). Passing it as the
+ * template parameter of SVDWrapper gives a factorizer which only computes the
+ * leading part of the spectrum with a few matrix multiplication passes over
+ * the input, instead of the cubic cost of a full SVD; for large matrices and
+ * small ranks this is far faster, at the cost of a small approximation error.
+ *
+ * The rank of the truncation is given at construction time; at least 'rank'
+ * singular vectors are always produced (a few more, because of the
+ * oversampling), so the result can be trimmed by SVDWrapper just like an
+ * exact factorization. If the rank is left at 0, or the requested subspace is
+ * not actually smaller than the input, the exact Armadillo SVD is used
+ * instead.
+ */
+class RandomizedSVD
+{
+ public:
+  /**
+   * Create the RandomizedSVD object with the given parameters.
+   *
+   * @param rank Rank of the truncated decomposition (0 means exact SVD).
+   * @param oversampling Number of extra random projections used to capture
+   *     the leading subspace more reliably.
+   * @param powerIterations Number of power iterations used to sharpen the
+   *     spectrum of the sampled subspace; useful when the singular values
+   *     decay slowly.
+   */
+  RandomizedSVD(const size_t rank = 0,
+                const size_t oversampling = 10,
+                const size_t powerIterations = 2) :
+      rank(rank),
+      oversampling(oversampling),
+      powerIterations(powerIterations)
+  { }
+
+  /**
+   * Compute the (approximately) truncated SVD factorization
+   * V = W * diagmat(sigma) * trans(H).
+   *
+   * @param W first unitary matrix
+   * @param sigma singular values
+   * @param H second unitary matrix
+   * @param V input matrix
+   */
+  void Apply(arma::mat& W,
+             arma::vec& sigma,
+             arma::mat& H,
+             const arma::mat& V) const;
+
+  //! Get the rank of the truncation.
+  size_t Rank() const { return rank; }
+  //! Modify the rank of the truncation.
+  size_t& Rank() { return rank; }
+
+ private:
+  //! Rank of the truncated decomposition.
+  size_t rank;
+  //! Number of extra random projections.
+  size_t oversampling;
+  //! Number of power iterations.
+  size_t powerIterations;
+}; // class RandomizedSVD
 
 /**
  * This class acts as the wrapper for all SVD factorizers which are incompatible 
@@ -76,6 +140,7 @@ class SVDWrapper
 
 //! add simple typedefs
 typedef SVDWrapper<DummyClass> ArmaSVDFactorizer;
+typedef SVDWrapper<RandomizedSVD> RandomizedSVDFactorizer;
 
 //! include the implementation
 #include "svd_wrapper_impl.hpp"
@@ -4,6 +4,46 @@
  *
  * Implementation of the SVD wrapper class.
  */
+inline void mlpack::cf::RandomizedSVD::Apply(arma::mat& W,
+                                             arma::vec& sigma,
+                                             arma::mat& H,
+                                             const arma::mat& V) const
+{
+  // If no rank was given, or the requested subspace is not actually smaller
+  // than the input, fall back to the exact factorization.
+  const size_t smallerDimension = std::min(V.n_rows, V.n_cols);
+  if(rank == 0 || rank + oversampling >= smallerDimension)
+  {
+    arma::svd(W, sigma, H, V);
+    return;
+  }
+
+  const size_t subspaceSize = rank + oversampling;
+
+  // Stage A: find an orthonormal basis Q whose range approximates the range
+  // of V, by applying V to a set of random vectors (one gemm).
+  arma::mat Q, R;
+  arma::qr_econ(Q, R, V * arma::randn<arma::mat>(V.n_cols, subspaceSize));
+
+  // Power iterations sharpen the spectrum of the sampled subspace; the
+  // re-orthonormalization after each application keeps the basis from
+  // collapsing onto the leading singular vector.
+  for(size_t i = 0; i < powerIterations; i++)
+  {
+    arma::qr_econ(Q, R, arma::trans(V) * Q);
+    arma::qr_econ(Q, R, V * Q);
+  }
+
+  // Stage B: exact SVD of the small projected matrix B = trans(Q) * V, whose
+  // row count is only the subspace size.
+  arma::mat B = arma::trans(Q) * V;
+  arma::mat Wsmall;
+  arma::svd_econ(Wsmall, sigma, H, B);
+
+  // Lift the left singular vectors back to the original space.
+  W = Q * Wsmall;
+}
+
 template<class Factorizer>
 double mlpack::cf::SVDWrapper<Factorizer>::Apply(const arma::mat& V,
                          arma::mat& W,
@@ -14,10 +54,11 @@ double mlpack::cf::SVDWrapper<Factorizer>::Apply(const arma::mat& V,
   arma::vec E;
   factorizer.Apply(W, E, H, V);
 
-  // construct sigma matrix 
+  // construct sigma matrix (a truncated factorizer may return fewer singular
+  // values than the smaller dimension of V)
   sigma.zeros(V.n_rows, V.n_cols);
 
-  for(size_t i = 0;i < sigma.n_rows && i < sigma.n_cols;i++)
+  for(size_t i = 0;i < sigma.n_rows && i < sigma.n_cols && i < E.n_elem;i++)
     sigma(i, i) = E(i, 0);
 
   arma::mat V_rec = W * sigma * arma::trans(H);
@@ -66,9 +107,10 @@ double mlpack::cf::SVDWrapper<Factorizer>::Apply(const arma::mat& V,
   arma::vec sigma;
   factorizer.Apply(W, sigma, H, V);
 
-  // remove the part of W and H depending upon the value of rank
+  // remove the part of W and H depending upon the value of rank (H may be
+  // rectangular if the factorizer returned a truncated factorization)
   W = W.submat(0, 0, W.n_rows - 1, r - 1);
-  H = H.submat(0, 0, H.n_cols - 1, r - 1);
+  H = H.submat(0, 0, H.n_rows - 1, r - 1);
 
   // take only required eigenvalues
   sigma = sigma.subvec(0, r - 1);
@@ -23,6 +23,14 @@ namespace decision_stump {
  * last bin has range up to \infty (split[i + 1] does not exist in that case).
  * Points that are below the first bin will take the label of the first bin.
  *
+ * By default, candidate splits are found by sorting each attribute, which
+ * costs O(n log n) per attribute.  If a nonzero number of histogram bins is
+ * given to the constructor, each attribute is instead assigned to equal-width
+ * bins and splits are found from the bin histograms, which costs O(n) per
+ * attribute.  The bin assignments depend only on the data, so they are
+ * computed once and reused when the stump is retrained with new weights
+ * during boosting.
+ *
  * @tparam MatType Type of matrix that is being used (sparse or dense).
  */
 template <typename MatType = arma::mat>
@@ -37,11 +45,14 @@ class DecisionStump
    * @param labels Labels of training data.
    * @param classes Number of distinct classes in labels.
    * @param inpBucketSize Minimum size of bucket when splitting.
+   * @param numBins Number of histogram bins to use for split finding; if 0,
+   *      the sort-based split finding is used instead.
    */
   DecisionStump(const MatType& data,
                 const arma::Row<size_t>& labels,
                 const size_t classes,
-                size_t inpBucketSize);
+                size_t inpBucketSize,
+                const size_t numBins = 0);
 
   /**
    * Classification function. After training, classify test, and put the
@@ -85,6 +96,9 @@ class DecisionStump
   //! Modify the labels for each split bin (be careful!).
   arma::Col<size_t>& BinLabels() { return binLabels; }
 
+  //! Get the number of histogram bins (0 if sort-based splitting is used).
+  size_t NumBins() const { return numBins; }
+
  private:
   //! Stores the number of classes.
   size_t numClass;
@@ -95,6 +109,21 @@ class DecisionStump
   //! Size of bucket while determining splitting criterion.
   size_t bucketSize;
 
+  //! Number of histogram bins (0 means sort-based split finding).
+  size_t numBins;
+
+  //! Minimum value of each attribute (only used for histogram splitting).
+  arma::vec binMins;
+
+  //! Bin width of each attribute (only used for histogram splitting); an
+  //! attribute with zero width is constant and cannot be split on.
+  arma::vec binWidths;
+
+  //! Bin index of each value of each attribute (only used for histogram
+  //! splitting).  These depend only on the data, so they are reused when the
+  //! stump is retrained with new weights during boosting.
+  arma::Mat<size_t> binIndices;
+
   //! Stores the splitting values after training.
   arma::vec split;
 
@@ -168,6 +197,27 @@ class DecisionStump
   void Train(const MatType& data, const arma::Row<size_t>& labels,
              const arma::rowvec& weightD);
 
+  /**
+   * Assign each value of each attribute to one of numBins equal-width bins,
+   * filling binMins, binWidths, and binIndices.
+   *
+   * @param data Dataset to compute the bin assignments of.
+   */
+  void BuildBins(const MatType& data);
+
+  /**
+   * Histogram-based training: choose the attribute whose binned split has the
+   * best entropy, then build the split values and bin labels from the
+   * histogram of that attribute.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for dataset.
+   * @param isWeight Whether we need to run a weighted Decision Stump.
+   */
+  template <bool isWeight>
+  void TrainHist(const MatType& data, const arma::Row<size_t>& labels,
+                 const arma::rowvec& weightD);
+
 };
 
 }; // namespace decision_stump
@@ -26,10 +26,12 @@ template<typename MatType>
 DecisionStump<MatType>::DecisionStump(const MatType& data,
                                       const arma::Row<size_t>& labels,
                                       const size_t classes,
-                                      size_t inpBucketSize)
+                                      size_t inpBucketSize,
+                                      const size_t numBins)
 {
   numClass = classes;
   bucketSize = inpBucketSize;
+  this->numBins = numBins;
 
   arma::rowvec weightD;
 
@@ -48,33 +50,51 @@ template <bool isWeight>
 void DecisionStump<MatType>::Train(const MatType& data, const arma::Row<size_t>& labels,
                                     const arma::rowvec& weightD)
 {
+  // If a bin count was given, use histogram-based split finding instead of
+  // sorting every attribute.
+  if (numBins > 0)
+  {
+    TrainHist<isWeight>(data, labels, weightD);
+    return;
+  }
+
   // If classLabels are not all identical, proceed with training.
   int bestAtt = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<size_t, isWeight>(
       labels.subvec(0, labels.n_elem - 1), 0, weightD);
 
-  double gain, bestGain = 0.0;
-  for (size_t i = 0; i < data.n_rows; i++)
+  // The candidate attributes are independent of each other, so they can be
+  // evaluated in parallel.
+  double bestGain = 0.0;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long i = 0; i < (long) data.n_rows; i++)
   {
     // Go through each attribute of the data.
     if (IsDistinct<double>(data.row(i)))
     {
       // For each attribute with non-identical values, treat it as a potential
       // splitting attribute and calculate entropy if split on it.
-      entropy = SetupSplitAttribute<isWeight>(data.row(i), labels, weightD);
+      const double entropy = SetupSplitAttribute<isWeight>(data.row(i), labels,
+          weightD);
 
-      gain = rootEntropy - entropy;
+      const double gain = rootEntropy - entropy;
       // Find the attribute with the best entropy so that the gain is
       // maximized.
 
       // if (entropy < bestEntropy)
       // Instead of the above rule, we are maximizing gain, which was
       // what is returned from SetupSplitAttribute.
-      if (gain < bestGain)
+#ifdef _OPENMP
+      #pragma omp critical (DecisionStumpBestSplit)
+#endif
       {
-        bestAtt = i;
-        bestGain = gain;
+        if (gain < bestGain)
+        {
+          bestAtt = i;
+          bestGain = gain;
+        }
       }
     }
   }
@@ -84,6 +104,184 @@ void DecisionStump<MatType>::Train(const MatType& data, const arma::Row<size_t>&
   TrainOnAtt<double>(data.row(splitAttribute), labels);
 }
 
+/**
+ * Assign each value of each attribute to one of numBins equal-width bins.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::BuildBins(const MatType& data)
+{
+  binMins.set_size(data.n_rows);
+  binWidths.set_size(data.n_rows);
+  binIndices.set_size(data.n_rows, data.n_cols);
+
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    // Find the range of the attribute.
+    double minVal = data(i, 0);
+    double maxVal = data(i, 0);
+    for (size_t j = 1; j < data.n_cols; j++)
+    {
+      if (data(i, j) < minVal)
+        minVal = data(i, j);
+      if (data(i, j) > maxVal)
+        maxVal = data(i, j);
+    }
+
+    binMins(i) = minVal;
+    binWidths(i) = (maxVal - minVal) / numBins;
+
+    if (binWidths(i) == 0.0)
+    {
+      // The attribute is constant; every value falls into the first bin.
+      for (size_t j = 0; j < data.n_cols; j++)
+        binIndices(i, j) = 0;
+      continue;
+    }
+
+    for (size_t j = 0; j < data.n_cols; j++)
+    {
+      size_t bin = (size_t) ((data(i, j) - minVal) / binWidths(i));
+      // The maximum of the attribute falls into the last bin.
+      if (bin >= numBins)
+        bin = numBins - 1;
+      binIndices(i, j) = bin;
+    }
+  }
+}
+
+/**
+ * Histogram-based training.  Each attribute is evaluated from the per-class
+ * weight histogram of its bins, which is built in a single pass over the
+ * data.
+ */
+template<typename MatType>
+template<bool isWeight>
+void DecisionStump<MatType>::TrainHist(const MatType& data,
+                                       const arma::Row<size_t>& labels,
+                                       const arma::rowvec& weightD)
+{
+  // Compute the bin assignments only if they have not been computed yet (or
+  // were computed for a different dataset); during boosting, they are copied
+  // from the previous round's stump.
+  if ((binIndices.n_rows != data.n_rows) || (binIndices.n_cols != data.n_cols))
+    BuildBins(data);
+
+  const double rootEntropy = CalculateEntropy<size_t, isWeight>(
+      labels.subvec(0, labels.n_elem - 1), 0, weightD);
+
+  int bestAtt = 0;
+  double bestGain = 0.0;
+  // The attributes are scored independently of each other, so they can be
+  // evaluated in parallel; each thread keeps its own histogram workspace.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    // Per-class weight histogram of the bins of one attribute.
+    arma::mat counts(numClass, numBins);
+    arma::rowvec binTotals(numBins);
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic)
+#endif
+    for (long i = 0; i < (long) data.n_rows; i++)
+    {
+      // A constant attribute cannot be split on.
+      if (binWidths(i) == 0.0)
+        continue;
+
+      // Build the histogram of this attribute.
+      counts.zeros();
+      binTotals.zeros();
+      for (size_t j = 0; j < data.n_cols; j++)
+      {
+        const double w = isWeight ? weightD(j) : 1.0;
+        counts(labels(j), binIndices(i, j)) += w;
+        binTotals(binIndices(i, j)) += w;
+      }
+      const double total = arma::accu(binTotals);
+
+      // Weighted sum of the (negative) entropies of the bins, analogous to
+      // SetupSplitAttribute().
+      double entropy = 0.0;
+      for (size_t b = 0; b < numBins; b++)
+      {
+        if (binTotals(b) == 0.0)
+          continue;
+
+        double binEntropy = 0.0;
+        for (size_t c = 0; c < numClass; c++)
+        {
+          const double p1 = counts(c, b) / binTotals(b);
+          binEntropy += (p1 == 0) ? 0 : p1 * std::log(p1);
+        }
+        entropy += (binTotals(b) / total) * (binEntropy / std::log(2.0));
+      }
+
+      const double gain = rootEntropy - entropy;
+#ifdef _OPENMP
+      #pragma omp critical (DecisionStumpBestSplit)
+#endif
+      {
+        if (gain < bestGain)
+        {
+          bestAtt = i;
+          bestGain = gain;
+        }
+      }
+    }
+  }
+  splitAttribute = bestAtt;
+
+  // Rebuild the histogram of the chosen attribute, and assign each bin the
+  // label of its heaviest class.
+  arma::mat counts(numClass, numBins);
+  arma::rowvec binTotals(numBins);
+  counts.zeros();
+  binTotals.zeros();
+  for (size_t j = 0; j < data.n_cols; j++)
+  {
+    const double w = isWeight ? weightD(j) : 1.0;
+    counts(labels(j), binIndices(splitAttribute, j)) += w;
+    binTotals(binIndices(splitAttribute, j)) += w;
+  }
+
+  // Label of the first non-empty bin; empty bins take the label of the
+  // closest non-empty bin before them.
+  size_t lastLabel = 0;
+  for (size_t b = 0; b < numBins; b++)
+  {
+    if (binTotals(b) > 0.0)
+    {
+      lastLabel = 0;
+      for (size_t c = 1; c < numClass; c++)
+        if (counts(c, b) > counts(lastLabel, b))
+          lastLabel = c;
+      break;
+    }
+  }
+
+  split.set_size(numBins);
+  binLabels.set_size(numBins);
+  for (size_t b = 0; b < numBins; b++)
+  {
+    if (binTotals(b) > 0.0)
+    {
+      size_t maxClass = 0;
+      for (size_t c = 1; c < numClass; c++)
+        if (counts(c, b) > counts(maxClass, b))
+          maxClass = c;
+      lastLabel = maxClass;
+    }
+
+    split(b) = binMins(splitAttribute) + b * binWidths(splitAttribute);
+    binLabels(b) = lastLabel;
+  }
+
+  // Merge adjacent bins with identical labels.
+  MergeRanges();
+}
+
 /**
  * Classification function. After training, classify test, and put the predicted
  * classes in predictedLabels.
@@ -138,6 +336,14 @@ DecisionStump<MatType>::DecisionStump(
 {
   numClass = other.numClass;
   bucketSize = other.bucketSize;
+  numBins = other.numBins;
+
+  // The bin assignments depend only on the data; if the other stump was
+  // trained on the same data (as in boosting), copying them avoids
+  // recomputation in every round.
+  binMins = other.binMins;
+  binWidths = other.binWidths;
+  binIndices = other.binIndices;
 
   // weightD = weights;
   // tempD = weightD;
@@ -23,16 +23,23 @@ PROGRAM_INFO("Density Estimation With Density Estimation Trees",
     "in the DET can be calculated."
     "\n\n"
     "The created DET can be saved to a file, along with the density estimates "
-    "for the test set and the variable importances.");
+    "for the test set and the variable importances."
+    "\n\n"
+    "A trained DET can be saved with --output_model_file and loaded later "
+    "with --input_model_file, so scoring jobs do not have to retrain the "
+    "estimator.");
 
 // Input data files.
-PARAM_STRING_REQ("train_file", "The data set on which to build a density "
-    "estimation tree.", "t");
+PARAM_STRING("train_file", "The data set on which to build a density "
+    "estimation tree.  Required unless --input_model_file is given.", "t", "");
 PARAM_STRING("test_file", "A set of test points to estimate the density of.",
     "T", "");
 PARAM_STRING("labels_file", "The labels for the given training data to "
     "generate the class membership of each leaf (as an extra statistic)", "l",
     "");
+PARAM_STRING("input_model_file", "A file containing a trained density "
+    "estimation tree to load, instead of training one (--train_file is then "
+    "not required).", "m", "");
 
 // Output data files.
 PARAM_STRING("unpruned_tree_estimates_file", "The file in which to output the "
@@ -49,6 +56,9 @@ PARAM_STRING("tree_file", "The file in which to print the final optimally "
     "pruned tree.", "r", "");
 PARAM_STRING("vi_file", "The file to output the variable importance values "
     "for each feature.", "i", "");
+PARAM_STRING("output_model_file", "The file to save the trained density "
+    "estimation tree to (use the .bin extension for the compact binary model "
+    "format).", "s", "");
 
 // Parameters for the algorithm.
 PARAM_INT("folds", "The number of folds of cross-validation to perform for the "
@@ -75,48 +85,81 @@ int main(int argc, char *argv[])
 {
   CLI::ParseCommandLine(argc, argv);
 
-  string trainSetFile = CLI::GetParam<string>("train_file");
+  const string trainSetFile = CLI::GetParam<string>("train_file");
+  const string inputModelFile = CLI::GetParam<string>("input_model_file");
+
+  if ((trainSetFile == "") && (inputModelFile == ""))
+    Log::Fatal << "Neither --train_file nor --input_model_file were "
+        << "specified; no density estimation tree to work with!" << endl;
+
   arma::Mat<double> trainingData;
 
-  data::Load(trainSetFile, trainingData, true);
+  if (trainSetFile != "")
+    data::Load(trainSetFile, trainingData, true);
 
-  // Cross-validation here.
-  size_t folds = CLI::GetParam<int>("folds");
-  if (folds == 0)
+  DTree* dtreeOpt;
+
+  if (inputModelFile != "")
   {
-    folds = trainingData.n_cols;
-    Log::Info << "Performing leave-one-out cross validation." << endl;
+    // Load a previously trained tree instead of training one.
+    dtreeOpt = new DTree();
+
+    Timer::Start("det_model_loading");
+    dtreeOpt->Load(inputModelFile);
+    Timer::Stop("det_model_loading");
+
+    Log::Info << "Loaded density estimation tree with "
+        << dtreeOpt->SubtreeLeaves() << " leaves from '" << inputModelFile
+        << "'." << endl;
   }
   else
   {
-    Log::Info << "Performing " << folds << "-fold cross validation." << endl;
-  }
+    // Cross-validation here.
+    size_t folds = CLI::GetParam<int>("folds");
+    if (folds == 0)
+    {
+      folds = trainingData.n_cols;
+      Log::Info << "Performing leave-one-out cross validation." << endl;
+    }
+    else
+    {
+      Log::Info << "Performing " << folds << "-fold cross validation." << endl;
+    }
 
-  const string unprunedTreeEstimateFile =
-      CLI::GetParam<string>("unpruned_tree_estimates_file");
-  const bool regularization = false;
+    const string unprunedTreeEstimateFile =
+        CLI::GetParam<string>("unpruned_tree_estimates_file");
+    const bool regularization = false;
 //  const bool regularization = CLI::HasParam("volume_regularization");
-  const int maxLeafSize = CLI::GetParam<int>("max_leaf_size");
-  const int minLeafSize = CLI::GetParam<int>("min_leaf_size");
-
-  // Obtain the optimal tree.
-  Timer::Start("det_training");
-  DTree *dtreeOpt = Trainer(trainingData, folds, regularization, maxLeafSize,
-      minLeafSize, unprunedTreeEstimateFile);
-  Timer::Stop("det_training");
+    const int maxLeafSize = CLI::GetParam<int>("max_leaf_size");
+    const int minLeafSize = CLI::GetParam<int>("min_leaf_size");
+
+    // Obtain the optimal tree.
+    Timer::Start("det_training");
+    dtreeOpt = Trainer(trainingData, folds, regularization, maxLeafSize,
+        minLeafSize, unprunedTreeEstimateFile);
+    Timer::Stop("det_training");
+  }
 
   // Compute densities for the training points in the optimal tree.
   FILE *fp = NULL;
 
-  if (CLI::GetParam<string>("training_set_estimates_file") != "")
+  if ((CLI::GetParam<string>("training_set_estimates_file") != "") &&
+      (trainingData.n_cols == 0))
+  {
+    Log::Warn << "--training_set_estimates_file ignored because no "
+        << "--train_file was given." << endl;
+  }
+  else if (CLI::GetParam<string>("training_set_estimates_file") != "")
   {
     fp = fopen(CLI::GetParam<string>("training_set_estimates_file").c_str(),
         "w");
 
     // Compute density estimates for each point in the training set.
     Timer::Start("det_estimation_time");
-    for (size_t i = 0; i < trainingData.n_cols; i++)
-      fprintf(fp, "%lg\n", dtreeOpt->ComputeValue(trainingData.unsafe_col(i)));
+    arma::vec trainingEstimates;
+    dtreeOpt->ComputeValue(trainingData, trainingEstimates);
+    for (size_t i = 0; i < trainingEstimates.n_elem; i++)
+      fprintf(fp, "%lg\n", trainingEstimates[i]);
     Timer::Stop("det_estimation_time");
 
     fclose(fp);
@@ -137,8 +180,10 @@ int main(int argc, char *argv[])
       fp = fopen(CLI::GetParam<string>("test_set_estimates_file").c_str(), "w");
 
       Timer::Start("det_test_set_estimation");
-      for (size_t i = 0; i < testData.n_cols; i++)
-        fprintf(fp, "%lg\n", dtreeOpt->ComputeValue(testData.unsafe_col(i)));
+      arma::vec testEstimates;
+      dtreeOpt->ComputeValue(testData, testEstimates);
+      for (size_t i = 0; i < testEstimates.n_elem; i++)
+        fprintf(fp, "%lg\n", testEstimates[i]);
       Timer::Stop("det_test_set_estimation");
 
       fclose(fp);
@@ -167,7 +212,13 @@ int main(int argc, char *argv[])
   }
 
   // Print the leaf memberships for the optimal tree.
-  if (CLI::GetParam<string>("labels_file") != "")
+  if ((CLI::GetParam<string>("labels_file") != "") &&
+      (trainingData.n_cols == 0))
+  {
+    Log::Warn << "--labels_file ignored because no --train_file was given."
+        << endl;
+  }
+  else if (CLI::GetParam<string>("labels_file") != "")
   {
     std::string labelsFile = CLI::GetParam<string>("labels_file");
     arma::Mat<size_t> labels;
@@ -197,5 +248,14 @@ int main(int argc, char *argv[])
     PrintVariableImportance(dtreeOpt, CLI::GetParam<string>("vi_file"));
   }
 
+  // Save the trained tree, if desired.
+  const string outputModelFile = CLI::GetParam<string>("output_model_file");
+  if (outputModelFile != "")
+  {
+    Timer::Start("det_model_saving");
+    dtreeOpt->Save(outputModelFile);
+    Timer::Stop("det_model_saving");
+  }
+
   delete dtreeOpt;
 }
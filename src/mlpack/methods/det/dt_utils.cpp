@@ -129,11 +129,10 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
     std::ofstream outfile(unprunedTreeOutput.c_str());
     if (outfile.good())
     {
-      for (size_t i = 0; i < dataset.n_cols; ++i)
-      {
-        arma::vec testPoint = dataset.unsafe_col(i);
-        outfile << dtree->ComputeValue(testPoint) << std::endl;
-      }
+      arma::vec estimates;
+      dtree->ComputeValue(dataset, estimates);
+      for (size_t i = 0; i < estimates.n_elem; ++i)
+        outfile << estimates[i] << std::endl;
     }
     else
     {
@@ -220,12 +219,9 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
          i < ((prunedSequence.size() < 2) ? 0 : prunedSequence.size() - 2); ++i)
     {
       // Compute test values for this state of the tree.
-      double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; j++)
-      {
-        arma::vec testPoint = test.unsafe_col(j);
-        cvVal += cvDTree->ComputeValue(testPoint);
-      }
+      arma::vec cvEstimates;
+      cvDTree->ComputeValue(test, cvEstimates);
+      const double cvVal = arma::accu(cvEstimates);
 
       // Update the cv regularization constant.
       regularizationConstants[i] += 2.0 * cvVal / (double) dataset.n_cols;
@@ -237,12 +233,9 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
     }
 
     // Compute test values for this state of the tree.
-    double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
-    {
-      arma::vec testPoint = test.unsafe_col(i);
-      cvVal += cvDTree->ComputeValue(testPoint);
-    }
+    arma::vec cvEstimates;
+    cvDTree->ComputeValue(test, cvEstimates);
+    const double cvVal = arma::accu(cvEstimates);
 
     if (prunedSequence.size() > 2)
       regularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal /
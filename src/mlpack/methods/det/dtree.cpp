@@ -142,8 +142,13 @@ bool DTree::FindSplit(const arma::mat& data,
   double minError = logNegError;
   bool splitFound = false;
 
-  // Loop through each dimension.
-  for (size_t dim = 0; dim < maxVals.n_elem; dim++)
+  // Loop through each dimension.  The candidate dimensions are independent of
+  // each other, so they can be evaluated in parallel; each thread keeps its
+  // own sorted copy of the dimension's values.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long dim = 0; dim < (long) maxVals.n_elem; dim++)
   {
     // Have to deal with REAL, INTEGER, NOMINAL data differently, so we have to
     // think of how to do that...
@@ -214,19 +219,24 @@ bool DTree::FindSplit(const arma::mat& data,
     double actualMinDimError = std::log(minDimError)
         - 2 * std::log((double) data.n_cols) - volumeWithoutDim;
 
-    if ((actualMinDimError > minError) && dimSplitFound)
+#ifdef _OPENMP
+    #pragma omp critical (DTreeFindSplit)
+#endif
     {
-      // Calculate actual error (in logspace) by adding terms back to our
-      // estimate.
-      minError = actualMinDimError;
-      splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
-          - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
-          - volumeWithoutDim;
-      splitFound = true;
-    } // end if better split found in this dimension.
+      if ((actualMinDimError > minError) && dimSplitFound)
+      {
+        // Calculate actual error (in logspace) by adding terms back to our
+        // estimate.
+        minError = actualMinDimError;
+        splitDim = dim;
+        splitValue = dimSplitValue;
+        leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
+            - volumeWithoutDim;
+        rightError = std::log(dimRightError) -
+            2 * std::log((double) data.n_cols) - volumeWithoutDim;
+        splitFound = true;
+      } // end if better split found in this dimension.
+    }
   }
 
   return splitFound;
@@ -570,6 +580,66 @@ double DTree::ComputeValue(const arma::vec& query) const
 }
 
 
+void DTree::ComputeValue(const arma::mat& queries, arma::vec& densities) const
+{
+  Log::Assert(queries.n_rows == maxVals.n_elem);
+
+  densities.set_size(queries.n_cols);
+
+  // Collect the queries inside the root's bounding box; the density of any
+  // query outside of it is zero.
+  arma::uvec indices(queries.n_cols);
+  size_t numInside = 0;
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    if (WithinRange(queries.unsafe_col(i)))
+      indices[numInside++] = i;
+    else
+      densities[i] = 0.0;
+  }
+
+  ComputeValue(queries, indices, 0, numInside, densities);
+}
+
+
+void DTree::ComputeValue(const arma::mat& queries,
+                         arma::uvec& indices,
+                         const size_t begin,
+                         const size_t end,
+                         arma::vec& densities) const
+{
+  if (begin == end)
+    return; // No queries reached this node.
+
+  if (subtreeLeaves == 1) // If we are a leaf...
+  {
+    const double density = std::exp(std::log(ratio) - logVolume);
+    for (size_t i = begin; i < end; ++i)
+      densities[indices[i]] = density;
+    return;
+  }
+
+  // Partition the indices so that queries going to the left child lie in
+  // [begin, splitIndex) and queries going to the right child lie in
+  // [splitIndex, end); then each child is descended only once for its whole
+  // group of queries.
+  size_t splitIndex = begin;
+  for (size_t i = begin; i < end; ++i)
+  {
+    if (queries(splitDim, indices[i]) <= splitValue)
+    {
+      const arma::uword tmp = indices[splitIndex];
+      indices[splitIndex] = indices[i];
+      indices[i] = tmp;
+      ++splitIndex;
+    }
+  }
+
+  left->ComputeValue(queries, indices, begin, splitIndex, densities);
+  right->ComputeValue(queries, indices, splitIndex, end, densities);
+}
+
+
 void DTree::WriteTree(FILE *fp, const size_t level) const
 {
   if (subtreeLeaves > 1)
@@ -676,3 +746,261 @@ std::string DTree::ToString() const
   convert << std::endl;
   return convert.str();
 }
+
+
+void DTree::PreorderList(std::vector<const DTree*>& nodes) const
+{
+  nodes.push_back(this);
+  if (subtreeLeaves > 1)
+  {
+    left->PreorderList(nodes);
+    right->PreorderList(nodes);
+  }
+}
+
+
+// Save the tree to a SaveRestoreUtility as flattened preorder arrays.
+void DTree::Save(util::SaveRestoreUtility& sr) const
+{
+  std::vector<const DTree*> nodes;
+  PreorderList(nodes);
+  const size_t numNodes = nodes.size();
+
+  std::vector<size_t> starts(numNodes);
+  std::vector<size_t> ends(numNodes);
+  std::vector<size_t> splitDims(numNodes);
+  std::vector<size_t> leafCounts(numNodes);
+  std::vector<size_t> rightChildren(numNodes);
+  std::vector<double> splitValues(numNodes);
+  std::vector<double> logNegErrors(numNodes);
+  std::vector<double> subtreeErrors(numNodes);
+  std::vector<double> ratios(numNodes);
+  std::vector<double> logVolumes(numNodes);
+  std::vector<double> alphaUppers(numNodes);
+  std::vector<int> bucketTags(numNodes);
+  arma::mat maxValsMat(maxVals.n_elem, numNodes);
+  arma::mat minValsMat(minVals.n_elem, numNodes);
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    const DTree& node = *nodes[i];
+    const bool isLeaf = (node.subtreeLeaves == 1);
+
+    starts[i] = node.start;
+    ends[i] = node.end;
+    // The split of a leaf is meaningless (and uninitialized); store zeros.
+    splitDims[i] = isLeaf ? 0 : node.splitDim;
+    splitValues[i] = isLeaf ? 0.0 : node.splitValue;
+    leafCounts[i] = node.subtreeLeaves;
+    logNegErrors[i] = node.logNegError;
+    subtreeErrors[i] = node.subtreeLeavesLogNegError;
+    ratios[i] = node.ratio;
+    logVolumes[i] = node.logVolume;
+    alphaUppers[i] = node.alphaUpper;
+    bucketTags[i] = node.bucketTag;
+    maxValsMat.col(i) = node.maxVals;
+    minValsMat.col(i) = node.minVals;
+
+    // In a preorder layout the left subtree of node i occupies the
+    // (2 * leftLeaves - 1) slots directly after i, so the right child index
+    // follows from the left child's leaf count; 0 marks a leaf (the root is
+    // at index 0 and can never be a right child).
+    rightChildren[i] = isLeaf ? 0 : (i + 2 * node.left->subtreeLeaves);
+  }
+
+  sr.SaveParameter(numNodes, "nodes");
+  sr.SaveParameter(starts, "starts");
+  sr.SaveParameter(ends, "ends");
+  sr.SaveParameter(splitDims, "split_dims");
+  sr.SaveParameter(splitValues, "split_values");
+  sr.SaveParameter(leafCounts, "subtree_leaves");
+  sr.SaveParameter(logNegErrors, "log_neg_errors");
+  sr.SaveParameter(subtreeErrors, "subtree_leaves_log_neg_errors");
+  sr.SaveParameter(ratios, "ratios");
+  sr.SaveParameter(logVolumes, "log_volumes");
+  sr.SaveParameter(alphaUppers, "alpha_uppers");
+  sr.SaveParameter(bucketTags, "bucket_tags");
+  sr.SaveParameter(rightChildren, "right_children");
+  sr.SaveParameter(maxValsMat, "max_vals");
+  sr.SaveParameter(minValsMat, "min_vals");
+}
+
+
+// Load the tree from the flattened preorder arrays written by Save().
+void DTree::Load(const util::SaveRestoreUtility& sr)
+{
+  size_t numNodes = 0;
+  sr.LoadParameter(numNodes, "nodes");
+
+  std::vector<size_t> starts;
+  std::vector<size_t> ends;
+  std::vector<size_t> splitDims;
+  std::vector<size_t> leafCounts;
+  std::vector<size_t> rightChildren;
+  std::vector<double> splitValues;
+  std::vector<double> logNegErrors;
+  std::vector<double> subtreeErrors;
+  std::vector<double> ratios;
+  std::vector<double> logVolumes;
+  std::vector<double> alphaUppers;
+  std::vector<int> bucketTags;
+  arma::mat maxValsMat;
+  arma::mat minValsMat;
+
+  sr.LoadParameter(starts, "starts");
+  sr.LoadParameter(ends, "ends");
+  sr.LoadParameter(splitDims, "split_dims");
+  sr.LoadParameter(splitValues, "split_values");
+  sr.LoadParameter(leafCounts, "subtree_leaves");
+  sr.LoadParameter(logNegErrors, "log_neg_errors");
+  sr.LoadParameter(subtreeErrors, "subtree_leaves_log_neg_errors");
+  sr.LoadParameter(ratios, "ratios");
+  sr.LoadParameter(logVolumes, "log_volumes");
+  sr.LoadParameter(alphaUppers, "alpha_uppers");
+  sr.LoadParameter(bucketTags, "bucket_tags");
+  sr.LoadParameter(rightChildren, "right_children");
+  sr.LoadParameter(maxValsMat, "max_vals");
+  sr.LoadParameter(minValsMat, "min_vals");
+
+  if ((numNodes == 0) ||
+      (starts.size() != numNodes) ||
+      (ends.size() != numNodes) ||
+      (splitDims.size() != numNodes) ||
+      (splitValues.size() != numNodes) ||
+      (leafCounts.size() != numNodes) ||
+      (logNegErrors.size() != numNodes) ||
+      (subtreeErrors.size() != numNodes) ||
+      (ratios.size() != numNodes) ||
+      (logVolumes.size() != numNodes) ||
+      (alphaUppers.size() != numNodes) ||
+      (bucketTags.size() != numNodes) ||
+      (rightChildren.size() != numNodes) ||
+      (maxValsMat.n_cols != numNodes) ||
+      (minValsMat.n_cols != numNodes))
+  {
+    Log::Fatal << "DTree::Load(): model reports " << numNodes << " nodes but "
+        << "the node arrays have inconsistent lengths!" << std::endl;
+  }
+
+  // Delete any existing children before overwriting this node.
+  if (left != NULL)
+    delete left;
+  if (right != NULL)
+    delete right;
+
+  // Allocate the nodes, then fill them and link the children; in the
+  // preorder layout the left child of node i is node i + 1 and the right
+  // child index is stored explicitly.
+  std::vector<DTree*> nodes(numNodes);
+  nodes[0] = this;
+  for (size_t i = 1; i < numNodes; ++i)
+    nodes[i] = new DTree();
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    DTree& node = *nodes[i];
+
+    node.start = starts[i];
+    node.end = ends[i];
+    node.splitDim = splitDims[i];
+    node.splitValue = splitValues[i];
+    node.subtreeLeaves = leafCounts[i];
+    node.logNegError = logNegErrors[i];
+    node.subtreeLeavesLogNegError = subtreeErrors[i];
+    node.ratio = ratios[i];
+    node.logVolume = logVolumes[i];
+    node.alphaUpper = alphaUppers[i];
+    node.bucketTag = bucketTags[i];
+    node.maxVals = maxValsMat.col(i);
+    node.minVals = minValsMat.col(i);
+    node.root = (i == 0);
+
+    if (rightChildren[i] != 0)
+    {
+      if ((i + 1 >= numNodes) || (rightChildren[i] >= numNodes))
+        Log::Fatal << "DTree::Load(): node " << i << " has a child index out "
+            << "of range!" << std::endl;
+
+      node.left = nodes[i + 1];
+      node.right = nodes[rightChildren[i]];
+    }
+    else
+    {
+      node.left = NULL;
+      node.right = NULL;
+    }
+  }
+}
+
+
+// Load the tree from a file.
+void DTree::Load(const std::string& filename)
+{
+  util::SaveRestoreUtility load;
+
+  if (!load.ReadFile(filename))
+    Log::Fatal << "DTree::Load(): could not read file '" << filename
+        << "'!\n";
+  Load(load);
+}
+
+
+// Save the tree to a file.
+void DTree::Save(const std::string& filename) const
+{
+  util::SaveRestoreUtility save;
+  Save(save);
+
+  if (!save.WriteFile(filename))
+    Log::Warn << "DTree::Save(): error saving to '" << filename << "'.\n";
+}
+
+
+DTreeTagTable::DTreeTagTable(const DTree& tree)
+{
+  // The tree is a full binary tree, so it has (2 * leaves - 1) nodes.
+  const size_t numNodes = 2 * tree.SubtreeLeaves() - 1;
+  splitDims.reserve(numNodes);
+  splitValues.reserve(numNodes);
+  rightChildren.reserve(numNodes);
+  bucketTags.reserve(numNodes);
+
+  Build(tree);
+}
+
+
+void DTreeTagTable::Build(const DTree& node)
+{
+  const size_t index = splitDims.size();
+  const bool isLeaf = (node.SubtreeLeaves() == 1);
+
+  // The split of a leaf is meaningless (and uninitialized); store zeros.
+  splitDims.push_back(isLeaf ? 0 : node.SplitDim());
+  splitValues.push_back(isLeaf ? 0.0 : node.SplitValue());
+  rightChildren.push_back(0);
+  bucketTags.push_back(node.BucketTag());
+
+  if (!isLeaf)
+  {
+    Build(*node.Left());
+    // The left subtree has been appended, so the right child lands at the
+    // next free slot.
+    rightChildren[index] = splitDims.size();
+    Build(*node.Right());
+  }
+}
+
+
+int DTreeTagTable::FindBucket(const arma::vec& query) const
+{
+  // Descend the packed layout; the comparison is the same as in
+  // DTree::FindBucket(), and a right child index of 0 marks a leaf.
+  size_t node = 0;
+  while (rightChildren[node] != 0)
+  {
+    node = (query[splitDims[node]] <= splitValues[node]) ? (node + 1) :
+        rightChildren[node];
+  }
+
+  return bucketTags[node];
+}
@@ -139,6 +139,17 @@ class DTree
    */
   double ComputeValue(const arma::vec& query) const;
 
+  /**
+   * Compute the density estimates of a set of query points all at once.  The
+   * queries are partitioned by each node's split as the tree is descended, so
+   * each node is visited at most once per call instead of once per query
+   * point.
+   *
+   * @param queries Points to estimate the density of (one point per column).
+   * @param densities Vector to store the density estimate of each query in.
+   */
+  void ComputeValue(const arma::mat& queries, arma::vec& densities) const;
+
   /**
    * Print the tree in a depth-first manner (this function is called
    * recursively).
@@ -185,6 +196,42 @@ class DTree
    */
   bool WithinRange(const arma::vec& query) const;
 
+  /**
+   * Save the tree to a SaveRestoreUtility.  The tree is flattened into
+   * preorder arrays: node i's left child is node i + 1, and the index of its
+   * right child is stored explicitly (0 marks a leaf).  With a flat layout the
+   * saved model is a handful of vectors and two matrices instead of a nested
+   * node hierarchy, so large trees serialize quickly and compactly.
+   *
+   * @param sr SaveRestoreUtility object to save to.
+   */
+  void Save(util::SaveRestoreUtility& sr) const;
+
+  /**
+   * Load the tree from a SaveRestoreUtility.  The format should be the same
+   * as is generated by the Save() method.  Any existing children of this node
+   * are deleted.
+   *
+   * @param sr SaveRestoreUtility object to load from.
+   */
+  void Load(const util::SaveRestoreUtility& sr);
+
+  /**
+   * Save the tree to a file.  If the filename has the .bin extension, the
+   * compact binary model format is written; otherwise an XML model file is
+   * written.
+   *
+   * @param filename Name of file to save the tree to.
+   */
+  void Save(const std::string& filename) const;
+
+  /**
+   * Load the tree from a file saved with Save().
+   *
+   * @param filename Name of file to load the tree from.
+   */
+  void Load(const std::string& filename);
+
  private:
   // The indices in the complete set of points
   // (after all forms of swapping in the original data
@@ -267,6 +314,8 @@ class DTree
   bool Root() const { return root; }
   //! Return the upper part of the alpha sum.
   double AlphaUpper() const { return alphaUpper; }
+  //! Return the tag of this leaf, or -1 if this node is not a tagged leaf.
+  int BucketTag() const { return bucketTag; }
 
   //! Return the maximum values.
   const arma::vec& MaxVals() const { return maxVals; }
@@ -305,6 +354,73 @@ class DTree
                    const double splitValue,
                    arma::Col<size_t>& oldFromNew) const;
 
+  /**
+   * Recursively estimate the density of the queries whose indices lie in the
+   * range [begin, end) of indices, partitioning the indices by this node's
+   * split before descending.
+   */
+  void ComputeValue(const arma::mat& queries,
+                    arma::uvec& indices,
+                    const size_t begin,
+                    const size_t end,
+                    arma::vec& densities) const;
+
+  /**
+   * Append this node and its subtree to the given preorder node list.
+   */
+  void PreorderList(std::vector<const DTree*>& nodes) const;
+
+};
+
+/**
+ * A compact, read-only descent table built from a tagged density estimation
+ * tree.  The nodes of the tree are packed contiguously in preorder, so the
+ * left child of node i is node i + 1 and the split values lie next to each
+ * other in memory; a descent therefore touches a few contiguous arrays
+ * instead of chasing pointers between heap-allocated nodes.  This makes
+ * repeated calls to FindBucket() (e.g. tagging a stream of points) much more
+ * cache-friendly than descending the pointer-linked tree.
+ *
+ * The table holds no densities or bounds; it only answers FindBucket()
+ * queries.  The tree it was built from may be deleted afterwards.
+ */
+class DTreeTagTable
+{
+ public:
+  /**
+   * Construct the table from a tree whose leaves have been tagged with
+   * DTree::TagTree().
+   *
+   * @param tree Tagged tree to build the table from.
+   */
+  DTreeTagTable(const DTree& tree);
+
+  /**
+   * Return the tag of the leaf containing the query.  This returns the same
+   * tag as DTree::FindBucket() on the tree the table was built from.
+   *
+   * @param query Query to search for.
+   */
+  int FindBucket(const arma::vec& query) const;
+
+  //! Return the number of nodes in the table.
+  size_t NumNodes() const { return splitDims.size(); }
+
+ private:
+  //! Split dimension of each node, in preorder (0 for leaves).
+  std::vector<size_t> splitDims;
+  //! Split value of each node, in preorder (0 for leaves).
+  std::vector<double> splitValues;
+  //! Index of each node's right child; 0 marks a leaf.  The left child of
+  //! node i is node i + 1.
+  std::vector<size_t> rightChildren;
+  //! The tag of each leaf; -1 for internal nodes.
+  std::vector<int> bucketTags;
+
+  /**
+   * Append the given subtree to the table in preorder.
+   */
+  void Build(const DTree& node);
 };
 
 }; // namespace det
@@ -27,6 +27,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 namespace mlpack {
 namespace emst /** Euclidean Minimum Spanning Trees. */ {
@@ -63,6 +64,14 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * An approximate spanning tree can be computed by passing a nonzero epsilon to
+ * the constructor; then, each edge of the result is at most (1 + epsilon)
+ * times longer than the shortest edge leaving its component, so the total
+ * length of the tree is at most (1 + epsilon) times the length of the exact
+ * minimum spanning tree.  The looser pruning bound can give large speedups
+ * when exact edges are not required (hierarchical clustering, for instance,
+ * often tolerates small relative error).
+ *
  * @tparam MetricType The metric to use.  IMPORTANT: this hasn't really been
  * tested with anything other than the L2 metric, so user beware. Note that the
  * tree type needs to compute bounds using the same metric as the type
@@ -89,6 +98,10 @@ class DualTreeBoruvka
   //! Indicates whether or not O(n^2) naive mode will be used.
   bool naive;
 
+  //! Allowed relative error on each component-neighbor edge (0 means the
+  //! exact MST is computed).
+  double epsilon;
+
   //! Edges.
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
@@ -126,10 +139,14 @@ class DualTreeBoruvka
    *
    * @param data Dataset to build a tree for.
    * @param naive Whether the computation should be done in O(n^2) naive mode.
+   * @param epsilon Allowed relative error on each component-neighbor edge (0
+   *      means the exact minimum spanning tree is computed; larger values
+   *      allow looser pruning and thus faster, approximate results).
    * @param leafSize The leaf size to be used during tree construction.
    */
   DualTreeBoruvka(const typename TreeType::Mat& dataset,
                   const bool naive = false,
+                  const double epsilon = 0.0,
                   const MetricType metric = MetricType());
 
   /**
@@ -148,9 +165,12 @@ class DualTreeBoruvka
    *
    * @param tree Pre-built tree.
    * @param dataset Dataset corresponding to the pre-built tree.
+   * @param epsilon Allowed relative error on each component-neighbor edge (0
+   *      means the exact minimum spanning tree is computed).
    */
   DualTreeBoruvka(TreeType* tree,
                   const typename TreeType::Mat& dataset,
+                  const double epsilon = 0.0,
                   const MetricType metric = MetricType());
 
   /**
@@ -169,6 +189,11 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  //! Get the allowed relative error on each component-neighbor edge.
+  double Epsilon() const { return epsilon; }
+  //! Modify the allowed relative error on each component-neighbor edge.
+  double& Epsilon() { return epsilon; }
+
   /**
    * Returns a string representation of this object.
    */
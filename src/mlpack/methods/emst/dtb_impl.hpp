@@ -44,14 +44,20 @@ template<typename MetricType, typename TreeType>
 DualTreeBoruvka<MetricType, TreeType>::DualTreeBoruvka(
     const typename TreeType::Mat& dataset,
     const bool naive,
+    const double epsilon,
     const MetricType metric) :
     data((tree::TreeTraits<TreeType>::RearrangesDataset && !naive) ? dataCopy : dataset),
     ownTree(!naive),
     naive(naive),
+    epsilon(epsilon),
     connections(dataset.n_cols),
     totalDist(0.0),
     metric(metric)
 {
+  if (epsilon < 0)
+    Log::Fatal << "DualTreeBoruvka::DualTreeBoruvka(): epsilon must be "
+        << "non-negative!" << std::endl;
+
   Timer::Start("emst/tree_building");
 
   if (!naive)
@@ -78,15 +84,21 @@ template<typename MetricType, typename TreeType>
 DualTreeBoruvka<MetricType, TreeType>::DualTreeBoruvka(
     TreeType* tree,
     const typename TreeType::Mat& dataset,
+    const double epsilon,
     const MetricType metric) :
     data(dataset),
     tree(tree),
     ownTree(false),
     naive(false),
+    epsilon(epsilon),
     connections(data.n_cols),
     totalDist(0.0),
     metric(metric)
 {
+  if (epsilon < 0)
+    Log::Fatal << "DualTreeBoruvka::DualTreeBoruvka(): epsilon must be "
+        << "non-negative!" << std::endl;
+
   edges.reserve(data.n_cols - 1); // Fill with EdgePairs.
 
   neighborsInComponent.set_size(data.n_cols);
@@ -115,7 +127,7 @@ void DualTreeBoruvka<MetricType, TreeType>::ComputeMST(arma::mat& results)
 
   typedef DTBRules<MetricType, TreeType> RuleType;
   RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+                 neighborsOutComponent, metric, epsilon);
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
@@ -127,7 +139,13 @@ void DualTreeBoruvka<MetricType, TreeType>::ComputeMST(arma::mat& results)
     }
     else
     {
-      typename TreeType::template DualTreeTraverser<RuleType> traverser(rules);
+      // When OpenMP is available, this runs the candidate-edge search for
+      // disjoint query subtrees as parallel tasks, each with a thread-local
+      // copy of the rules; the per-thread candidates are merged by keeping
+      // the closest candidate edge of each component.  The union of the
+      // candidates into the spanning tree (AddAllEdges()) stays serial,
+      // since it is O(N) work per iteration.
+      tree::ParallelDualTreeTraverser<TreeType, RuleType> traverser(rules);
       traverser.Traverse(*tree, *tree);
     }
 
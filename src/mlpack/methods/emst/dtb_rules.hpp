@@ -23,10 +23,37 @@ class DTBRules
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
-           MetricType& metric);
+           MetricType& metric,
+           const double epsilon = 0.0);
+
+  /**
+   * Create a thread-local copy of another rule set, for use with
+   * tree::ParallelDualTreeTraverser.  The copy gets its own union-find
+   * structure (Find() performs path compression, so it cannot be shared
+   * between threads) and its own candidate edge arrays, which are folded
+   * back into the original rules by Merge().
+   */
+  DTBRules(const DTBRules& other);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case over a contiguous block of reference points (the points
+   * of a leaf node).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point in the block.
+   * @param referenceEnd Index one past the last reference point in the block.
+   */
+  void BaseCases(const size_t queryIndex,
+                 const size_t referenceBegin,
+                 const size_t referenceEnd)
+  {
+    for (size_t i = referenceBegin; i < referenceEnd; ++i)
+      BaseCase(queryIndex, i);
+  }
+
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -120,10 +147,25 @@ class DTBRules
   //! Modify the number of node combinations that have been scored.
   size_t& Scores() { return scores; }
 
+  /**
+   * Merge the results of a thread-local copy of the rules back into this
+   * object.  This is required by tree::ParallelDualTreeTraverser; the closer
+   * of the two candidate edges is kept for every component.
+   */
+  void Merge(const DTBRules& other);
+
  private:
   //! The data points.
   const arma::mat& dataSet;
 
+  //! Thread-local copies of the shared state; these are empty unless this
+  //! object was created by the copy constructor, in which case the reference
+  //! members below point at these instead of the original objects.
+  UnionFind ownConnections;
+  arma::vec ownDistances;
+  arma::Col<size_t> ownInComponent;
+  arma::Col<size_t> ownOutComponent;
+
   //! Stores the tree structure so far
   UnionFind& connections;
 
@@ -141,11 +183,24 @@ class DTBRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! The allowed relative error on each component-neighbor edge.
+  const double epsilon;
+
   /**
    * Update the bound for the given query node.
    */
   inline double CalculateBound(TreeType& queryNode) const;
 
+  /**
+   * Relax a pruning bound by epsilon, for approximate search: the relaxed
+   * bound admits any edge whose length is within a relative factor of
+   * (1 + epsilon) of the shortest edge leaving the component.
+   */
+  double Relax(const double bound) const
+  {
+    return (bound == DBL_MAX) ? DBL_MAX : bound / (1.0 + epsilon);
+  }
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases calculated.
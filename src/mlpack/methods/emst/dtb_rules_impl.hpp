@@ -17,20 +17,64 @@ DTBRules(const arma::mat& dataSet,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
-         MetricType& metric)
+         MetricType& metric,
+         const double epsilon)
 :
   dataSet(dataSet),
+  ownConnections(0),
   connections(connections),
   neighborsDistances(neighborsDistances),
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
   metric(metric),
+  epsilon(epsilon),
   baseCases(0),
   scores(0)
 {
   // Nothing else to do.
 }
 
+template<typename MetricType, typename TreeType>
+DTBRules<MetricType, TreeType>::DTBRules(const DTBRules& other) :
+  dataSet(other.dataSet),
+  ownConnections(other.connections),
+  ownDistances(other.neighborsDistances.n_elem),
+  ownInComponent(other.neighborsInComponent.n_elem),
+  ownOutComponent(other.neighborsOutComponent.n_elem),
+  connections(ownConnections),
+  neighborsDistances(ownDistances),
+  neighborsInComponent(ownInComponent),
+  neighborsOutComponent(ownOutComponent),
+  metric(other.metric),
+  epsilon(other.epsilon),
+  baseCases(0),
+  scores(0)
+{
+  // The copy starts with no candidate edges; the shared candidate arrays may
+  // be concurrently merged into by other threads, so their contents are not
+  // read here.  (The union-find structure is safe to copy: it is only
+  // modified between traversals, when the found edges are added.)
+  ownDistances.fill(DBL_MAX);
+}
+
+template<typename MetricType, typename TreeType>
+void DTBRules<MetricType, TreeType>::Merge(const DTBRules& other)
+{
+  // Keep the closer of the two candidate edges for every component.
+  for (size_t i = 0; i < neighborsDistances.n_elem; ++i)
+  {
+    if (other.neighborsDistances[i] < neighborsDistances[i])
+    {
+      neighborsDistances[i] = other.neighborsDistances[i];
+      neighborsInComponent[i] = other.neighborsInComponent[i];
+      neighborsOutComponent[i] = other.neighborsOutComponent[i];
+    }
+  }
+
+  baseCases += other.baseCases;
+  scores += other.scores;
+}
+
 template<typename MetricType, typename TreeType>
 inline force_inline
 double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
@@ -87,8 +131,9 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
   const double distance = referenceNode.MinDistance(queryPoint);
 
   // If all the points in the reference node are farther than the candidate
-  // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
+  // nearest neighbor for the query's component, we prune.  For approximate
+  // search the bound is relaxed by epsilon.
+  return Relax(neighborsDistances[queryComponentIndex]) < distance
       ? DBL_MAX : distance;
 }
 
@@ -112,8 +157,9 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                                     baseCaseResult);
 
   // If all the points in the reference node are farther than the candidate
-  // nearest neighbor for the query's component, we prune.
-  return (neighborsDistances[queryComponentIndex] < distance) ? DBL_MAX :
+  // nearest neighbor for the query's component, we prune.  For approximate
+  // search the bound is relaxed by epsilon.
+  return (Relax(neighborsDistances[queryComponentIndex]) < distance) ? DBL_MAX :
       distance;
 }
 
@@ -124,7 +170,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > Relax(neighborsDistances[connections.Find(queryIndex)]))
       ? DBL_MAX : oldScore;
 }
 
@@ -141,7 +187,10 @@ double DTBRules<MetricType, TreeType>::Score(TreeType& queryNode,
 
   ++scores;
   const double distance = queryNode.MinDistance(&referenceNode);
-  const double bound = CalculateBound(queryNode);
+
+  // For approximate search the bound is relaxed by epsilon; the bounds cached
+  // in the statistic stay exact.
+  const double bound = Relax(CalculateBound(queryNode));
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for all queries in the node, we prune.
@@ -162,7 +211,10 @@ double DTBRules<MetricType, TreeType>::Score(TreeType& queryNode,
 
   ++scores;
   const double distance = queryNode.MinDistance(referenceNode, baseCaseResult);
-  const double bound = CalculateBound(queryNode);
+
+  // For approximate search the bound is relaxed by epsilon; the bounds cached
+  // in the statistic stay exact.
+  const double bound = Relax(CalculateBound(queryNode));
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for all queries in the node, we prune.
@@ -174,7 +226,7 @@ double DTBRules<MetricType, TreeType>::Rescore(TreeType& queryNode,
                                                TreeType& /* referenceNode */,
                                                const double oldScore) const
 {
-  const double bound = CalculateBound(queryNode);
+  const double bound = Relax(CalculateBound(queryNode));
   return (oldScore > bound) ? DBL_MAX : oldScore;
 }
 
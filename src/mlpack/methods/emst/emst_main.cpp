@@ -37,6 +37,11 @@ PARAM_STRING_REQ("input_file", "Data input file.", "i");
 PARAM_STRING("output_file", "Data output file.  Stored as an edge list.", "o",
     "emst_output.csv");
 PARAM_FLAG("naive", "Compute the MST using O(n^2) naive algorithm.", "n");
+PARAM_DOUBLE("epsilon", "If specified, the spanning tree is approximate: each "
+    "edge may be up to a factor of (1 + epsilon) longer than the shortest "
+    "edge leaving its component.  This allows much looser pruning, at the "
+    "cost of a tree up to (1 + epsilon) times longer than the exact MST.",
+    "e", 0.0);
 PARAM_INT("leaf_size", "Leaf size in the kd-tree.  One-element leaves give the "
     "empirically best performance, but at the cost of greater memory "
     "requirements.", "l", 1);
@@ -55,6 +60,11 @@ int main(int argc, char* argv[])
   arma::mat dataPoints;
   data::Load(dataFilename, dataPoints, true);
 
+  const double epsilon = CLI::GetParam<double>("epsilon");
+  if (epsilon < 0)
+    Log::Fatal << "Invalid epsilon (" << epsilon << ")!  Must be "
+        << "non-negative." << std::endl;
+
   // Do naive computation if necessary.
   if (CLI::GetParam<bool>("naive"))
   {
@@ -91,7 +101,7 @@ int main(int argc, char* argv[])
     metric::LMetric<2, true> metric;
     Timer::Stop("tree_building");
 
-    DualTreeBoruvka<> dtb(&tree, dataPoints, metric);
+    DualTreeBoruvka<> dtb(&tree, dataPoints, epsilon, metric);
 
     // Run the DTB algorithm.
     Log::Info << "Calculating minimum spanning tree." << endl;
@@ -33,11 +33,15 @@ FastMKS<KernelType, TreeType>::FastMKS(const arma::mat& referenceSet,
 {
   Timer::Start("tree_building");
 
+  // Cache the self-kernel values, so that each metric evaluation during tree
+  // building and search costs one kernel evaluation instead of three.
+  metric.BindDataset(referenceSet);
+
   if (!naive)
-    referenceTree = new TreeType(referenceSet);
+    referenceTree = new TreeType(referenceSet, metric);
 
   if (!naive && !single)
-    queryTree = new TreeType(referenceSet);
+    queryTree = new TreeType(referenceSet, metric);
 
   Timer::Stop("tree_building");
 }
@@ -58,12 +62,17 @@ FastMKS<KernelType, TreeType>::FastMKS(const arma::mat& referenceSet,
 {
   Timer::Start("tree_building");
 
+  // Cache the self-kernel values, so that each metric evaluation during tree
+  // building and search costs one kernel evaluation instead of three.
+  metric.BindDataset(referenceSet);
+  metric.BindDataset(querySet);
+
   // If necessary, the trees should be built.
   if (!naive)
-    referenceTree = new TreeType(referenceSet);
+    referenceTree = new TreeType(referenceSet, metric);
 
   if (!naive && !single)
-    queryTree = new TreeType(querySet);
+    queryTree = new TreeType(querySet, metric);
 
   Timer::Stop("tree_building");
 }
@@ -85,6 +94,10 @@ FastMKS<KernelType, TreeType>::FastMKS(const arma::mat& referenceSet,
 {
   Timer::Start("tree_building");
 
+  // Cache the self-kernel values, so that each metric evaluation during tree
+  // building and search costs one kernel evaluation instead of three.
+  metric.BindDataset(referenceSet);
+
   // If necessary, the reference tree should be built.  There is no query tree.
   if (!naive)
     referenceTree = new TreeType(referenceSet, metric);
@@ -113,6 +126,11 @@ FastMKS<KernelType, TreeType>::FastMKS(const arma::mat& referenceSet,
 {
   Timer::Start("tree_building");
 
+  // Cache the self-kernel values, so that each metric evaluation during tree
+  // building and search costs one kernel evaluation instead of three.
+  metric.BindDataset(referenceSet);
+  metric.BindDataset(querySet);
+
   // If necessary, the trees should be built.
   if (!naive)
     referenceTree = new TreeType(referenceSet, metric);
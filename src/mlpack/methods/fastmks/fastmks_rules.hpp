@@ -31,6 +31,23 @@ class FastMKSRules
   //! Compute the base case (kernel value) between two points.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case over a contiguous block of reference points (the points
+   * of a leaf node).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point in the block.
+   * @param referenceEnd Index one past the last reference point in the block.
+   */
+  void BaseCases(const size_t queryIndex,
+                 const size_t referenceBegin,
+                 const size_t referenceEnd)
+  {
+    for (size_t i = referenceBegin; i < referenceEnd; ++i)
+      BaseCase(queryIndex, i);
+  }
+
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -122,6 +139,25 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! Number of slots in the kernel value cache.  The same point pair is often
+  //! revisited through different node combinations, and for expensive kernels
+  //! the evaluations -- not the traversal -- dominate the cost, so a bounded
+  //! cache of recent pair evaluations pays for itself.
+  static const size_t kernelCacheSize = 8192;
+  //! Query indices of the cached pair evaluations (size_t(-1) if empty).
+  arma::Col<size_t> cacheQueryIndices;
+  //! Reference indices of the cached pair evaluations.
+  arma::Col<size_t> cacheReferenceIndices;
+  //! Cached kernel evaluations.
+  arma::vec cacheKernels;
+
+  //! Get the cache slot a query/reference pair hashes to.
+  size_t CacheSlot(const size_t queryIndex, const size_t referenceIndex) const
+  {
+    // Knuth's multiplicative hash, to spread out nearby index pairs.
+    return (queryIndex * 2654435761UL + referenceIndex) % kernelCacheSize;
+  }
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
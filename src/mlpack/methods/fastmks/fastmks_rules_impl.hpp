@@ -41,6 +41,12 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(const arma::mat& referenceSet,
     referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.unsafe_col(i),
                                                referenceSet.unsafe_col(i)));
 
+  // Set up the (empty) kernel value cache.
+  cacheQueryIndices.set_size(kernelCacheSize);
+  cacheQueryIndices.fill((size_t) -1);
+  cacheReferenceIndices.set_size(kernelCacheSize);
+  cacheKernels.set_size(kernelCacheSize);
+
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
   traversalInfo.LastQueryNode() = (TreeType*) this;
@@ -68,10 +74,27 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
     lastReferenceIndex = referenceIndex;
   }
 
+  // This pair may have been evaluated before, through some other node
+  // combination; if so, its result was also already considered for the result
+  // lists, so we can return the cached value immediately.
+  const size_t slot = CacheSlot(queryIndex, referenceIndex);
+  if ((cacheQueryIndices[slot] == queryIndex) &&
+      (cacheReferenceIndices[slot] == referenceIndex))
+  {
+    if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+      lastKernel = cacheKernels[slot];
+    return cacheKernels[slot];
+  }
+
   ++baseCases;
   double kernelEval = kernel.Evaluate(querySet.unsafe_col(queryIndex),
                                       referenceSet.unsafe_col(referenceIndex));
 
+  // Cache the evaluation, evicting whatever older pair hashed to this slot.
+  cacheQueryIndices[slot] = queryIndex;
+  cacheReferenceIndices[slot] = referenceIndex;
+  cacheKernels[slot] = kernelEval;
+
   // Update the last kernel value, if we need to.
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
     lastKernel = kernelEval;
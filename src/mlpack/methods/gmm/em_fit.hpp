@@ -10,9 +10,12 @@
 #define __MLPACK_METHODS_GMM_EM_FIT_HPP
 
 #include <mlpack/core.hpp>
+#include <ctime>
 
 // Default clustering mechanism.
 #include <mlpack/methods/kmeans/kmeans.hpp>
+// Batch source for the streaming (stochastic EM) mode.
+#include <mlpack/core/data/streaming_loader.hpp>
 // Default covariance matrix constraint.
 #include "positive_definite_constraint.hpp"
 
@@ -67,17 +70,33 @@ class EMFit
    * as the initial model, instead of using the InitialClusteringType::Cluster()
    * option.
    *
+   * The DistributionType template parameter may be either
+   * distribution::GaussianDistribution (full covariance matrices) or
+   * distribution::DiagonalGaussianDistribution (per-dimension variances
+   * only); the distribution-specific covariance updates are dispatched
+   * through private overloads.
+   *
+   * If bestSoFar is given, it points at the best final log-likelihood of any
+   * concurrent trial of GMM::Estimate() (read and written under a named
+   * critical section).  A trial whose log-likelihood is behind that value by
+   * more than its current per-iteration gain could recover in the remaining
+   * iterations is abandoned before convergence.
+   *
    * @param observations List of observations to train on.
    * @param means Vector to store trained means in.
    * @param covariances Vector to store trained covariances in.
    * @param weights Vector to store a priori weights in.
    * @param useInitialModel If true, the given model is used for the initial
    *      clustering.
+   * @param bestSoFar If non-NULL, the best final log-likelihood of the
+   *      concurrent trials, for early abandonment.
    */
+  template<typename DistributionType>
   void Estimate(const arma::mat& observations,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<DistributionType>& dists,
                 arma::vec& weights,
-                const bool useInitialModel = false);
+                const bool useInitialModel = false,
+                const double* bestSoFar = NULL);
 
   /**
    * Fit the observations to a Gaussian mixture model (GMM) using the EM
@@ -95,12 +114,51 @@ class EMFit
    * @param weights Vector to store a priori weights in.
    * @param useInitialModel If true, the given model is used for the initial
    *      clustering.
+   * @param bestSoFar If non-NULL, the best final log-likelihood of the
+   *      concurrent trials, for early abandonment.
    */
+  template<typename DistributionType>
   void Estimate(const arma::mat& observations,
                 const arma::vec& probabilities,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<DistributionType>& dists,
                 arma::vec& weights,
-                const bool useInitialModel = false);
+                const bool useInitialModel = false,
+                const double* bestSoFar = NULL);
+
+  /**
+   * Fit a GMM to observations arriving in batches from a stream, using
+   * stepwise (stochastic) EM.  Instead of full passes over a resident
+   * dataset, each batch gets one E-step, and the per-point sufficient
+   * statistics of the batch are interpolated into running statistics:
+   *
+   *   s <- (1 - eta_t) s + eta_t s_batch,  eta_t = (t + 2)^(-kappa),
+   *
+   * where t is the batch number and kappa is the forgetting exponent.  The
+   * model is then recomputed from the running statistics in closed form, so
+   * it updates after every batch and tracks drift in the stream; kappa in
+   * (0.5, 1] trades adaptivity (lower) against noise suppression (higher).
+   *
+   * If useInitialModel is not set, the initial clustering runs on the first
+   * batch, which therefore ought to be reasonably representative.
+   * MaxIterations() bounds the number of batches consumed (0 means the
+   * stream is read until it is exhausted); convergence-based stopping and
+   * trial abandonment do not apply here, and checkpointing is not performed.
+   *
+   * @param loader Stream to read observation batches from.
+   * @param dists Vector to store trained components in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the starting
+   *      point instead of clustering the first batch.
+   * @param forgettingExponent Decay exponent kappa of the step size.
+   * @return Average per-point log-likelihood of the stream, interpolated
+   *      with the same step sequence (so recent batches weigh more).
+   */
+  template<typename DistributionType>
+  double EstimateStreaming(data::StreamingLoader<>& loader,
+                           std::vector<DistributionType>& dists,
+                           arma::vec& weights,
+                           const bool useInitialModel = false,
+                           const double forgettingExponent = 0.7);
 
   //! Get the clusterer.
   const InitialClusteringType& Clusterer() const { return clusterer; }
@@ -122,6 +180,40 @@ class EMFit
   //! Modify the tolerance for the convergence of the EM algorithm.
   double& Tolerance() { return tolerance; }
 
+  //! Get the checkpoint file ("" means checkpointing is disabled).
+  const std::string& CheckpointFile() const { return checkpointFile; }
+  //! Modify the checkpoint file.  If set, Estimate() periodically snapshots
+  //! the current model to this file in the SaveRestoreUtility format, so a
+  //! preempted run can be resumed with LoadCheckpoint() (or GMM::Load(),
+  //! which reads the same format) and useInitialModel = true.
+  std::string& CheckpointFile() { return checkpointFile; }
+
+  //! Get the number of EM iterations between checkpoints (0 disables the
+  //! iteration trigger).
+  size_t CheckpointIterations() const { return checkpointIterations; }
+  //! Modify the number of EM iterations between checkpoints.
+  size_t& CheckpointIterations() { return checkpointIterations; }
+
+  //! Get the number of seconds between checkpoints (0 disables the wall-clock
+  //! trigger).
+  size_t CheckpointSeconds() const { return checkpointSeconds; }
+  //! Modify the number of seconds between checkpoints.
+  size_t& CheckpointSeconds() { return checkpointSeconds; }
+
+  /**
+   * Load a model checkpoint written by a previous Estimate() run from the
+   * checkpoint file.  The loaded model can be passed back to Estimate() with
+   * useInitialModel set to true to resume fitting.  The vectors are resized
+   * to the checkpointed number of components.
+   *
+   * @param dists Vector to store the checkpointed components in.
+   * @param weights Vector to store the checkpointed a priori weights in.
+   * @return True if the checkpoint was read successfully, false otherwise.
+   */
+  template<typename DistributionType>
+  bool LoadCheckpoint(std::vector<DistributionType>& dists,
+                      arma::vec& weights) const;
+
  private:
   /**
    * Run the clusterer, and then turn the cluster assignments into Gaussians.
@@ -133,8 +225,9 @@ class EMFit
    * @param covariances Vector to store covariances in.
    * @param weights Vector to store a priori weights in.
    */
+  template<typename DistributionType>
   void InitialClustering(const arma::mat& observations,
-                         std::vector<distribution::GaussianDistribution>& dists,
+                         std::vector<DistributionType>& dists,
                          arma::vec& weights);
 
   /**
@@ -147,11 +240,105 @@ class EMFit
    * @param covariances Vector of covariance matrices.
    * @param weights Vector of a priori weights.
    */
+  template<typename DistributionType>
   double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
+                       const std::vector<DistributionType>& dists,
                        const arma::vec& weights) const;
 
+  /**
+   * Update the covariance of a single component in the M step, given the
+   * updated mean and the weight of each observation.  The covariance math is
+   * the only part of Estimate() that depends on the distribution type, so it
+   * is dispatched through these overloads.
+   *
+   * @param observations List of observations.
+   * @param pointWeights Weight of each observation for this component.
+   * @param totalWeight Sum of the observation weights.
+   * @param dist Component distribution to update.
+   */
+  void CovarianceUpdate(const arma::mat& observations,
+                        const arma::vec& pointWeights,
+                        const double totalWeight,
+                        distribution::GaussianDistribution& dist);
+  //! Diagonal version: only the per-dimension variances are computed, so the
+  //! update is O(nd) instead of O(nd^2).
+  void CovarianceUpdate(const arma::mat& observations,
+                        const arma::vec& pointWeights,
+                        const double totalWeight,
+                        distribution::DiagonalGaussianDistribution& dist);
+
+  /**
+   * Compute the weighted second-moment statistic of a batch of observations
+   * for the streaming mode: the weighted sum of outer products for a
+   * full-covariance component, or of elementwise squares (a single column)
+   * for a diagonal one.
+   *
+   * @param observations Batch of observations.
+   * @param pointWeights Weight of each observation for this component.
+   * @param moment Matrix to store the statistic in.
+   * @param dist Component the statistic is for (selects the overload only).
+   */
+  void BatchMoment(const arma::mat& observations,
+                   const arma::vec& pointWeights,
+                   arma::mat& moment,
+                   const distribution::GaussianDistribution& dist);
+  void BatchMoment(const arma::mat& observations,
+                   const arma::vec& pointWeights,
+                   arma::mat& moment,
+                   const distribution::DiagonalGaussianDistribution& dist);
+
+  //! Recover the second moment E[x x^T] (or its diagonal) of a component
+  //! from its mean and covariance, to seed the streaming statistics.
+  void MomentFromCovariance(const distribution::GaussianDistribution& dist,
+                            arma::mat& moment);
+  void MomentFromCovariance(
+      const distribution::DiagonalGaussianDistribution& dist,
+      arma::mat& moment);
+
+  //! Set a component's covariance from its normalized second moment and its
+  //! (already updated) mean.
+  void CovarianceFromMoment(const arma::mat& moment,
+                            distribution::GaussianDistribution& dist);
+  void CovarianceFromMoment(const arma::mat& moment,
+                            distribution::DiagonalGaussianDistribution& dist);
+
+  /**
+   * Accumulate the contribution of a single observation into the covariance
+   * of a component during initial clustering (the outer product of the
+   * observation, or just its elementwise square in the diagonal case).
+   *
+   * @param observation Single observation.
+   * @param dist Component distribution to accumulate into.
+   */
+  void AccumulateCovariance(const arma::vec& observation,
+                            distribution::GaussianDistribution& dist);
+  void AccumulateCovariance(const arma::vec& observation,
+                            distribution::DiagonalGaussianDistribution& dist);
+
+  /**
+   * Write the current model to the checkpoint file if either checkpoint
+   * trigger has fired.  The model is written in the same SaveRestoreUtility
+   * layout that GMM::Save() produces, so GMM::Load() can read a checkpoint
+   * directly.  This is called between EM iterations, so the snapshot is
+   * always a consistent model.
+   *
+   * @param dists Current component distributions.
+   * @param weights Current a priori weights.
+   * @param iteration Current EM iteration number.
+   * @param lastCheckpoint Time of the last checkpoint; updated on write.
+   */
+  template<typename DistributionType>
+  void Checkpoint(const std::vector<DistributionType>& dists,
+                  const arma::vec& weights,
+                  const size_t iteration,
+                  std::time_t& lastCheckpoint) const;
+
+  //! Apply the covariance constraint policy to a full-covariance component.
+  void ApplyConstraint(distribution::GaussianDistribution& dist);
+  //! The constraint policies operate on full covariance matrices; for a
+  //! diagonal component we only need to keep every variance positive.
+  void ApplyConstraint(distribution::DiagonalGaussianDistribution& dist);
+
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
   //! Tolerance for convergence of EM.
@@ -160,6 +347,12 @@ class EMFit
   InitialClusteringType clusterer;
   //! Object which applies constraints to the covariance matrix.
   CovarianceConstraintPolicy constraint;
+  //! File the model is periodically checkpointed to ("" disables).
+  std::string checkpointFile;
+  //! EM iterations between checkpoints (0 disables the iteration trigger).
+  size_t checkpointIterations;
+  //! Seconds between checkpoints (0 disables the wall-clock trigger).
+  size_t checkpointSeconds;
 };
 
 }; // namespace gmm
@@ -24,19 +24,32 @@ EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
     maxIterations(maxIterations),
     tolerance(tolerance),
     clusterer(clusterer),
-    constraint(constraint)
+    constraint(constraint),
+    checkpointFile(""),
+    checkpointIterations(0),
+    checkpointSeconds(0)
 { /* Nothing to do. */ }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename DistributionType>
 void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     const arma::mat& observations,
-    std::vector<distribution::GaussianDistribution>& dists,
+    std::vector<DistributionType>& dists,
     arma::vec& weights,
-    const bool useInitialModel)
+    const bool useInitialModel,
+    const double* bestSoFar)
 {
-  // Only perform initial clustering if the user wanted it.
+  // Only perform initial clustering if the user wanted it.  The initial
+  // clustering draws from the global random number generator, which is not
+  // thread-safe, so concurrent trials (see GMM::Estimate()) take turns here;
+  // the EM iterations themselves run concurrently.
   if (!useInitialModel)
+  {
+#ifdef _OPENMP
+    #pragma omp critical (emFitInitialClustering)
+#endif
     InitialClustering(observations, dists, weights);
+  }
 
   double l = LogLikelihood(observations, dists, weights);
 
@@ -46,6 +59,14 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   double lOld = -DBL_MAX;
   arma::mat condProb(observations.n_cols, dists.size());
 
+  // Touch the conditional probability matrix in parallel, so on NUMA systems
+  // its pages are spread across the memory nodes instead of landing wherever
+  // the allocating thread runs.
+  util::FirstTouchFill(condProb, 0.0);
+
+  // Time of the last checkpoint, for the wall-clock trigger.
+  std::time_t lastCheckpoint = std::time(NULL);
+
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
@@ -54,8 +75,13 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
         << "log-likelihood " << l << "." << std::endl;
 
     // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
+    // Gaussian given the observations and the present theta value.  Each
+    // component writes only its own column of condProb, so the components can
+    // be evaluated in parallel (the loop index is signed for OpenMP).
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < (long) dists.size(); i++)
     {
       // Store conditional probabilities into condProb vector for each
       // Gaussian.  First we make an alias of the condProb vector.
@@ -64,8 +90,12 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
       condProbAlias *= weights[i];
     }
 
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
+    // Normalize row-wise; the rows are independent, so they are divided among
+    // the threads in blocks.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < (long) condProb.n_rows; i++)
     {
       // Avoid dividing by zero; if the probability for everything is 0, we
       // don't want to make it NaN.
@@ -78,26 +108,29 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
 
     // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
+    // probabilities.  Each iteration updates only dists[i] (the sufficient
+    // statistics are matrix products over all points), so the components can
+    // be updated in parallel.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < (long) dists.size(); i++)
     {
       // Don't update if there's no probability of the Gaussian having points.
       if (probRowSums[i] != 0)
         dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
 
       // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
+      // conditional probabilities and the updated means.  The covariance math
+      // depends on the distribution type, so it is dispatched through an
+      // overload.  Don't update if there's no probability of the Gaussian
+      // having points.
       if (probRowSums[i] != 0.0)
-        dists[i].Covariance() = (tmp * trans(tmpB)) / probRowSums[i];
+        CovarianceUpdate(observations, condProb.col(i), probRowSums[i],
+            dists[i]);
 
       // Apply covariance constraint.
-      constraint.ApplyConstraint(dists[i].Covariance());
+      ApplyConstraint(dists[i]);
     }
 
     // Calculate the new values for omega using the updated conditional
@@ -108,20 +141,56 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     lOld = l;
     l = LogLikelihood(observations, dists, weights);
 
+    // If another trial has already finished with a better log-likelihood than
+    // this one can plausibly reach, abandon this trial.  The per-iteration
+    // gain of EM shrinks over time, so projecting the current gain over all
+    // remaining iterations overestimates what is left; if even that
+    // projection cannot close the gap, this trial has lost.
+    if (bestSoFar != NULL)
+    {
+      double best;
+#ifdef _OPENMP
+      #pragma omp critical (gmmTrialBest)
+#endif
+      best = *bestSoFar;
+
+      if ((best > l) &&
+          ((best - l) > (l - lOld) * (double) (maxIterations - iteration)))
+      {
+        Log::Info << "EMFit::Estimate(): abandoning trial at iteration "
+            << iteration << "; log-likelihood " << l << " cannot reach best "
+            << "result so far " << best << "." << std::endl;
+        return;
+      }
+    }
+
+    // The model is consistent between iterations, so this is a safe place to
+    // snapshot it.
+    Checkpoint(dists, weights, iteration, lastCheckpoint);
+
     iteration++;
   }
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename DistributionType>
 void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     const arma::mat& observations,
     const arma::vec& probabilities,
-    std::vector<distribution::GaussianDistribution>& dists,
+    std::vector<DistributionType>& dists,
     arma::vec& weights,
-    const bool useInitialModel)
+    const bool useInitialModel,
+    const double* bestSoFar)
 {
+  // See the non-probabilistic overload for why the initial clustering is
+  // serialized between concurrent trials.
   if (!useInitialModel)
+  {
+#ifdef _OPENMP
+    #pragma omp critical (emFitInitialClustering)
+#endif
     InitialClustering(observations, dists, weights);
+  }
 
   double l = LogLikelihood(observations, dists, weights);
 
@@ -131,13 +200,26 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   double lOld = -DBL_MAX;
   arma::mat condProb(observations.n_cols, dists.size());
 
+  // Touch the conditional probability matrix in parallel, so on NUMA systems
+  // its pages are spread across the memory nodes instead of landing wherever
+  // the allocating thread runs.
+  util::FirstTouchFill(condProb, 0.0);
+
+  // Time of the last checkpoint, for the wall-clock trigger.
+  std::time_t lastCheckpoint = std::time(NULL);
+
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
     // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
+    // Gaussian given the observations and the present theta value.  Each
+    // component writes only its own column of condProb, so the components can
+    // be evaluated in parallel (the loop index is signed for OpenMP).
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < (long) dists.size(); i++)
     {
       // Store conditional probabilities into condProb vector for each
       // Gaussian.  First we make an alias of the condProb vector.
@@ -146,8 +228,12 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
       condProbAlias *= weights[i];
     }
 
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
+    // Normalize row-wise; the rows are independent, so they are divided among
+    // the threads in blocks.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < (long) condProb.n_rows; i++)
     {
       // Avoid dividing by zero; if the probability for everything is 0, we
       // don't want to make it NaN.
@@ -161,8 +247,12 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     arma::vec probRowSums(dists.size());
 
     // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
+    // probabilities.  Each iteration updates only dists[i] and its own entry
+    // of probRowSums, so the components can be updated in parallel.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < (long) dists.size(); i++)
     {
       // Calculate the sum of probabilities of points, which is the
       // conditional probability of each point being from Gaussian i
@@ -174,16 +264,14 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
         probRowSums[i];
 
       // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      dists[i].Covariance() = (tmp * trans(tmpB)) / probRowSums[i];
+      // conditional probabilities and the updated means.  The covariance math
+      // depends on the distribution type, so it is dispatched through an
+      // overload.
+      CovarianceUpdate(observations, condProb.col(i) % probabilities,
+          probRowSums[i], dists[i]);
 
       // Apply covariance constraint.
-      constraint.ApplyConstraint(dists[i].Covariance());
+      ApplyConstraint(dists[i]);
     }
 
     // Calculate the new values for omega using the updated conditional
@@ -194,14 +282,237 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     lOld = l;
     l = LogLikelihood(observations, dists, weights);
 
+    // Abandon a trial that has fallen hopelessly behind the best concurrent
+    // trial; see the non-probabilistic overload for the reasoning.
+    if (bestSoFar != NULL)
+    {
+      double best;
+#ifdef _OPENMP
+      #pragma omp critical (gmmTrialBest)
+#endif
+      best = *bestSoFar;
+
+      if ((best > l) &&
+          ((best - l) > (l - lOld) * (double) (maxIterations - iteration)))
+      {
+        Log::Info << "EMFit::Estimate(): abandoning trial at iteration "
+            << iteration << "; log-likelihood " << l << " cannot reach best "
+            << "result so far " << best << "." << std::endl;
+        return;
+      }
+    }
+
+    // The model is consistent between iterations, so this is a safe place to
+    // snapshot it.
+    Checkpoint(dists, weights, iteration, lastCheckpoint);
+
     iteration++;
   }
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename DistributionType>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+EstimateStreaming(data::StreamingLoader<>& loader,
+                  std::vector<DistributionType>& dists,
+                  arma::vec& weights,
+                  const bool useInitialModel,
+                  const double forgettingExponent)
+{
+  arma::mat batch;
+  if (!loader.Next(batch))
+    Log::Fatal << "EMFit::EstimateStreaming(): the stream holds no points!"
+        << std::endl;
+
+  // Without an initial model, the first batch stands in for the dataset in
+  // the initial clustering, so it ought to be reasonably representative.
+  if (!useInitialModel)
+    InitialClustering(batch, dists, weights);
+
+  // The running sufficient statistics of each component: its weight mass, its
+  // weighted point sum, and its weighted second moment, all normalized per
+  // point.  They are seeded from the initial model so the first batches
+  // refine it instead of erasing it.
+  const size_t gaussians = dists.size();
+  arma::vec s0 = weights;
+  arma::mat s1(batch.n_rows, gaussians);
+  std::vector<arma::mat> s2(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    s1.col(i) = weights[i] * dists[i].Mean();
+    MomentFromCovariance(dists[i], s2[i]);
+    s2[i] *= weights[i];
+  }
+
+  double avgLogLikelihood = 0.0;
+  size_t batches = 0;
+  do
+  {
+    // E-step over this batch only.  Each component writes its own column of
+    // condProb, as in Estimate() (the loop index is signed for OpenMP).
+    arma::mat condProb(batch.n_cols, gaussians);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < (long) gaussians; i++)
+    {
+      arma::vec condProbAlias = condProb.unsafe_col(i);
+      dists[i].Probability(batch, condProbAlias);
+      condProbAlias *= weights[i];
+    }
+
+    // The per-point normalizer is also the likelihood of the point under the
+    // current model, so the log-likelihood of the batch comes for free.
+    double batchLogLikelihood = 0.0;
+    for (size_t i = 0; i < condProb.n_rows; i++)
+    {
+      const double probSum = accu(condProb.row(i));
+      if (probSum != 0.0)
+      {
+        condProb.row(i) /= probSum;
+        batchLogLikelihood += log(probSum);
+      }
+    }
+    batchLogLikelihood /= batch.n_cols;
+
+    // Interpolate this batch's per-point statistics into the running
+    // statistics.  The step size decays polynomially, so the statistics
+    // average out batch noise while old batches are gradually forgotten.
+    const double step = std::pow((double) (batches + 2), -forgettingExponent);
+    arma::mat moment;
+    for (size_t i = 0; i < gaussians; ++i)
+    {
+      s0[i] = (1.0 - step) * s0[i] +
+          step * accu(condProb.col(i)) / batch.n_cols;
+      s1.col(i) = (1.0 - step) * s1.col(i) +
+          step * (batch * condProb.col(i)) / batch.n_cols;
+
+      BatchMoment(batch, condProb.col(i), moment, dists[i]);
+      s2[i] = (1.0 - step) * s2[i] + step * moment / batch.n_cols;
+    }
+    avgLogLikelihood = (batches == 0) ? batchLogLikelihood :
+        (1.0 - step) * avgLogLikelihood + step * batchLogLikelihood;
+
+    // M-step: the model is a closed form of the running statistics.
+    for (size_t i = 0; i < gaussians; ++i)
+    {
+      // Leave a component untouched until it accumulates some mass.
+      if (s0[i] == 0.0)
+        continue;
+
+      dists[i].Mean() = s1.col(i) / s0[i];
+      CovarianceFromMoment(s2[i] / s0[i], dists[i]);
+      ApplyConstraint(dists[i]);
+    }
+    weights = s0 / accu(s0);
+
+    ++batches;
+    Log::Debug << "EMFit::EstimateStreaming(): batch " << batches
+        << ", average log-likelihood " << avgLogLikelihood << "."
+        << std::endl;
+  } while (((maxIterations == 0) || (batches < maxIterations)) &&
+      loader.Next(batch));
+
+  Log::Info << "EMFit::EstimateStreaming(): consumed " << batches
+      << " batches; average log-likelihood " << avgLogLikelihood << "."
+      << std::endl;
+
+  return avgLogLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename DistributionType>
+bool EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LoadCheckpoint(
+    std::vector<DistributionType>& dists,
+    arma::vec& weights) const
+{
+  util::SaveRestoreUtility load;
+  if (!load.ReadFile(checkpointFile))
+  {
+    Log::Warn << "EMFit::LoadCheckpoint(): could not read checkpoint file '"
+        << checkpointFile << "'." << std::endl;
+    return false;
+  }
+
+  size_t gaussians;
+  load.LoadParameter(gaussians, "gaussians");
+  load.LoadParameter(weights, "weights");
+
+  if (weights.n_elem != gaussians)
+  {
+    Log::Warn << "EMFit::LoadCheckpoint(): checkpoint file '" << checkpointFile
+        << "' reports " << gaussians << " components but contains "
+        << weights.n_elem << " weights." << std::endl;
+    return false;
+  }
+
+  dists.resize(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    std::stringstream o;
+    o << "gaussian" << i;
+    dists[i].Load(load.Children().at(o.str()));
+  }
+
+  return true;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename DistributionType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Checkpoint(
+    const std::vector<DistributionType>& dists,
+    const arma::vec& weights,
+    const size_t iteration,
+    std::time_t& lastCheckpoint) const
+{
+  if (checkpointFile == "")
+    return; // Checkpointing is disabled.
+
+  // Has either the iteration trigger or the wall-clock trigger fired?
+  const bool iterationDue = (checkpointIterations > 0) &&
+      (iteration % checkpointIterations == 0);
+  const bool timeDue = (checkpointSeconds > 0) &&
+      (std::difftime(std::time(NULL), lastCheckpoint) >=
+          (double) checkpointSeconds);
+  if (!iterationDue && !timeDue)
+    return;
+
+  // Write the model in the same layout as GMM::Save(), so that GMM::Load()
+  // can read a checkpoint directly.
+  util::SaveRestoreUtility save;
+  save.SaveParameter(std::string("GMM"), "type");
+  save.SaveParameter(dists.size(), "gaussians");
+  save.SaveParameter(dists.empty() ? size_t(0) :
+      size_t(dists[0].Mean().n_elem), "dimensionality");
+  save.SaveParameter(weights, "weights");
+  save.SaveParameter(iteration, "iteration");
+
+  util::SaveRestoreUtility child;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    std::stringstream o;
+    o << i;
+    const std::string gaussianName = "gaussian" + o.str();
+
+    dists[i].Save(child);
+    save.AddChild(child, gaussianName);
+  }
+
+  if (!save.WriteFile(checkpointFile))
+    Log::Warn << "EMFit::Estimate(): error checkpointing model to '"
+        << checkpointFile << "'." << std::endl;
+  else
+    Log::Info << "EMFit::Estimate(): model checkpointed to '" << checkpointFile
+        << "' at iteration " << iteration << "." << std::endl;
+
+  lastCheckpoint = std::time(NULL);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename DistributionType>
 void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
 InitialClustering(const arma::mat& observations,
-                  std::vector<distribution::GaussianDistribution>& dists,
+                  std::vector<DistributionType>& dists,
                   arma::vec& weights)
 {
   // Assignments from clustering.
@@ -227,8 +538,7 @@ InitialClustering(const arma::mat& observations,
     dists[cluster].Mean() += observations.col(i);
 
     // Add this to the relevant covariance.
-    dists[cluster].Covariance() += observations.col(i) *
-        trans(observations.col(i));
+    AccumulateCovariance(observations.col(i), dists[cluster]);
 
     // Now add one to the weights (we will normalize).
     weights[cluster]++;
@@ -244,7 +554,7 @@ InitialClustering(const arma::mat& observations,
   {
     const size_t cluster = assignments[i];
     const arma::vec normObs = observations.col(i) - dists[cluster].Mean();
-    dists[cluster].Covariance() += normObs * normObs.t();
+    AccumulateCovariance(normObs, dists[cluster]);
   }
 
   for (size_t i = 0; i < dists.size(); ++i)
@@ -252,7 +562,7 @@ InitialClustering(const arma::mat& observations,
     dists[i].Covariance() /= (weights[i] > 1) ? weights[i] : 1;
 
     // Apply constraints to covariance matrix.
-    constraint.ApplyConstraint(dists[i].Covariance());
+    ApplyConstraint(dists[i]);
   }
 
   // Finally, normalize weights.
@@ -260,18 +570,24 @@ InitialClustering(const arma::mat& observations,
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename DistributionType>
 double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
     const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
+    const std::vector<DistributionType>& dists,
     const arma::vec& weights) const
 {
   double logLikelihood = 0;
 
-  arma::vec phis;
   arma::mat likelihoods(dists.size(), observations.n_cols);
-  
-  for (size_t i = 0; i < dists.size(); ++i)
+
+  // Each component writes only its own row of the likelihood matrix, so the
+  // components can be evaluated in parallel (with a per-thread phi vector).
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long i = 0; i < (long) dists.size(); ++i)
   {
+    arma::vec phis;
     dists[i].Probability(observations, phis);
     likelihoods.row(i) = weights(i) * trans(phis);
   }
@@ -287,6 +603,132 @@ double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
   return logLikelihood;
 }
 
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+CovarianceUpdate(const arma::mat& observations,
+                 const arma::vec& pointWeights,
+                 const double totalWeight,
+                 distribution::GaussianDistribution& dist)
+{
+  // The covariance is the weighted sum of the outer products of the
+  // deviations from the mean, computed as a single matrix product.
+  arma::mat tmp = observations - (dist.Mean() *
+      arma::ones<arma::rowvec>(observations.n_cols));
+  arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
+      trans(pointWeights));
+
+  dist.Covariance() = (tmp * trans(tmpB)) / totalWeight;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+CovarianceUpdate(const arma::mat& observations,
+                 const arma::vec& pointWeights,
+                 const double totalWeight,
+                 distribution::DiagonalGaussianDistribution& dist)
+{
+  // Only the per-dimension variances are needed, so the outer-product
+  // accumulation of the full-covariance case reduces to a weighted sum of
+  // squared deviations in each dimension.
+  arma::mat tmp = observations - (dist.Mean() *
+      arma::ones<arma::rowvec>(observations.n_cols));
+
+  dist.Covariance() = ((tmp % tmp) * pointWeights) / totalWeight;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+BatchMoment(const arma::mat& observations,
+            const arma::vec& pointWeights,
+            arma::mat& moment,
+            const distribution::GaussianDistribution& /* dist */)
+{
+  // Weighted sum of outer products, computed as a single matrix product (the
+  // same trick as CovarianceUpdate(), without the mean subtraction).
+  arma::mat tmp = observations %
+      (arma::ones<arma::vec>(observations.n_rows) * trans(pointWeights));
+  moment = observations * trans(tmp);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+BatchMoment(const arma::mat& observations,
+            const arma::vec& pointWeights,
+            arma::mat& moment,
+            const distribution::DiagonalGaussianDistribution& /* dist */)
+{
+  // Only the per-dimension second moments are needed; moment is one column.
+  moment = (observations % observations) * pointWeights;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+MomentFromCovariance(const distribution::GaussianDistribution& dist,
+                     arma::mat& moment)
+{
+  moment = dist.Covariance() + dist.Mean() * trans(dist.Mean());
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+MomentFromCovariance(const distribution::DiagonalGaussianDistribution& dist,
+                     arma::mat& moment)
+{
+  moment = dist.Covariance() + dist.Mean() % dist.Mean();
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+CovarianceFromMoment(const arma::mat& moment,
+                     distribution::GaussianDistribution& dist)
+{
+  dist.Covariance() = moment - dist.Mean() * trans(dist.Mean());
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+CovarianceFromMoment(const arma::mat& moment,
+                     distribution::DiagonalGaussianDistribution& dist)
+{
+  dist.Covariance() = moment.col(0) - dist.Mean() % dist.Mean();
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+AccumulateCovariance(const arma::vec& observation,
+                     distribution::GaussianDistribution& dist)
+{
+  dist.Covariance() += observation * trans(observation);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+AccumulateCovariance(const arma::vec& observation,
+                     distribution::DiagonalGaussianDistribution& dist)
+{
+  dist.Covariance() += observation % observation;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+ApplyConstraint(distribution::GaussianDistribution& dist)
+{
+  constraint.ApplyConstraint(dist.Covariance());
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+ApplyConstraint(distribution::DiagonalGaussianDistribution& dist)
+{
+  // The constraint policies operate on full covariance matrices; a diagonal
+  // covariance cannot become non-diagonal, so we only need to keep every
+  // variance positive.
+  arma::vec& cov = dist.Covariance();
+  for (size_t i = 0; i < cov.n_elem; ++i)
+    if (cov[i] < 1e-30)
+      cov[i] = 1e-30;
+}
+
 }; // namespace gmm
 }; // namespace mlpack
 
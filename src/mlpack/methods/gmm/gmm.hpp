@@ -24,20 +24,37 @@ namespace gmm /** Gaussian Mixture Models. */ {
  * GMM can be trained using normal data, or data with probabilities of being
  * from this GMM (see GMM::Estimate() for more information).
  *
+ * The component distributions are given by the DistributionType template
+ * parameter, which is distribution::GaussianDistribution (full covariance
+ * matrices) by default; distribution::DiagonalGaussianDistribution may be
+ * used instead for diagonal covariances, which reduces the cost of each
+ * probability evaluation and each EM update from O(d^2) to O(d) per point.
+ *
  * The FittingType template class must provide a way for the GMM to train on
  * data.  It must provide the following two functions:
  *
  * @code
  * void Estimate(const arma::mat& observations,
- *               std::vector<distribution::GaussianDistribution>& dists,
- *               arma::vec& weights);
+ *               std::vector<DistributionType>& dists,
+ *               arma::vec& weights,
+ *               const bool useInitialModel,
+ *               const double* bestSoFar);
  *
  * void Estimate(const arma::mat& observations,
  *               const arma::vec& probabilities,
- *               std::vector<distribution::GaussianDistribution>& dists,
- *               arma::vec& weights);
+ *               std::vector<DistributionType>& dists,
+ *               arma::vec& weights,
+ *               const bool useInitialModel,
+ *               const double* bestSoFar);
  * @endcode
  *
+ * If bestSoFar is non-NULL, it points at the best final log-likelihood of the
+ * other trials run by GMM::Estimate() (accessed under the named critical
+ * section "gmmTrialBest"); the fitting type may use it to abandon a trial
+ * that cannot catch up, or ignore it entirely.  GMM::Estimate() may run
+ * trials on its fitting type concurrently, each on a copy of the fitting
+ * type, so Estimate() must not depend on shared mutable state beyond that.
+ *
  * These functions should produce a trained GMM from the given observations and
  * probabilities.  These may modify the size of the model (by increasing the
  * size of the mean and covariance vectors as well as the weight vectors), but
@@ -69,7 +86,8 @@ namespace gmm /** Gaussian Mixture Models. */ {
  * arma::vec observation = g.Random();
  * @endcode
  */
-template<typename FittingType = EMFit<> >
+template<typename FittingType = EMFit<>,
+         typename DistributionType = distribution::GaussianDistribution>
 class GMM
 {
  private:
@@ -79,7 +97,7 @@ class GMM
   size_t dimensionality;
 
   //! Vector of Gaussians
-  std::vector<distribution::GaussianDistribution> dists;
+  std::vector<DistributionType> dists;
 
   //! Legacy member data, not used.
   std::vector<arma::vec> means;
@@ -134,7 +152,7 @@ class GMM
    * @param dists Distributions of the model.
    * @param weights Weights of the model.
    */
-  GMM(const std::vector<distribution::GaussianDistribution> & dists,
+  GMM(const std::vector<DistributionType> & dists,
       const arma::vec& weights) :
       gaussians(dists.size()),
       dimensionality((!dists.empty()) ? dists[0].Mean().n_elem : 0),
@@ -152,7 +170,7 @@ class GMM
    * @param covariances Covariances of the model.
    * @param weights Weights of the model.
    */
-  GMM(const std::vector<distribution::GaussianDistribution> & dists,
+  GMM(const std::vector<DistributionType> & dists,
       const arma::vec& weights,
       FittingType& fitter) :
       gaussians(dists.size()),
@@ -165,7 +183,7 @@ class GMM
    * Copy constructor for GMMs which use different fitting types.
    */
   template<typename OtherFittingType>
-  GMM(const GMM<OtherFittingType>& other);
+  GMM(const GMM<OtherFittingType, DistributionType>& other);
 
   /**
    * Copy constructor for GMMs using the same fitting type.  This also copies
@@ -177,7 +195,7 @@ class GMM
    * Copy operator for GMMs which use different fitting types.
    */
   template<typename OtherFittingType>
-  GMM& operator=(const GMM<OtherFittingType>& other);
+  GMM& operator=(const GMM<OtherFittingType, DistributionType>& other);
 
   /**
    * Copy operator for GMMs which use the same fitting type.  This also copies
@@ -232,14 +250,14 @@ class GMM
    *
    * @param i index of component.
    */
-  const distribution::GaussianDistribution& Component(size_t i) const {
+  const DistributionType& Component(size_t i) const {
       return dists[i]; }
   /**
    * Return a reference to a component distribution.
    *
    * @param i index of component.
    */
-  distribution::GaussianDistribution& Component(size_t i) { return dists[i]; }
+  DistributionType& Component(size_t i) { return dists[i]; }
 
   //! Functions from earlier releases give errors
   const std::vector<arma::vec>& Means() const
@@ -296,6 +314,45 @@ class GMM
   double Probability(const arma::vec& observation,
                      const size_t component) const;
 
+  /**
+   * Compute the probability of each of the given observations (one per
+   * column) coming from this distribution.  Each component is evaluated over
+   * the whole block with the batched distribution path, so this is far faster
+   * than calling the single-observation Probability() in a loop.
+   *
+   * @param observations Observations to evaluate the probability of.
+   * @param probs Vector to store the probability of each observation in.
+   */
+  void Probability(const arma::mat& observations, arma::vec& probs) const;
+
+  /**
+   * Compute the probability of each of the given observations (one per
+   * column) coming from the given Gaussian component in this distribution,
+   * using the batched distribution path.
+   *
+   * @param observations Observations to evaluate the probability of.
+   * @param component Index of the component of the GMM to be considered.
+   * @param probs Vector to store the probability of each observation in.
+   */
+  void Probability(const arma::mat& observations,
+                   const size_t component,
+                   arma::vec& probs) const;
+
+  /**
+   * Compute the responsibility of each component for each of the given
+   * observations (one per column); that is, the posterior probability that
+   * the observation was generated by that component.  Entry (i, j) of the
+   * output is the responsibility of component i for observation j, and each
+   * column sums to one.  If every component underflows to zero probability
+   * for some observation, its responsibilities are set uniform.
+   *
+   * @param observations Observations to compute responsibilities for.
+   * @param responsibilities Matrix to store the responsibilities in; it will
+   *     be set to size Gaussians() x observations.n_cols.
+   */
+  void Responsibilities(const arma::mat& observations,
+                        arma::mat& responsibilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -304,6 +361,18 @@ class GMM
    */
   arma::vec Random() const;
 
+  /**
+   * Generate the given number of random observations, one per column of the
+   * output matrix.  The observations are generated component by component
+   * with the batched distribution sampler, so the columns are grouped by the
+   * component that generated them; shuffle the columns if an exchangeable
+   * ordering is needed.
+   *
+   * @param numSamples Number of observations to generate.
+   * @param samples Matrix to store the observations in.
+   */
+  void Random(const size_t numSamples, arma::mat& samples) const;
+
   /**
    * Estimate the probability distribution directly from the given observations,
    * using the given algorithm in the FittingType class to fit the data.
@@ -311,6 +380,9 @@ class GMM
    * The fitting will be performed 'trials' times; from these trials, the model
    * with the greatest log-likelihood will be selected.  By default, only one
    * trial is performed.  The log-likelihood of the best fitting is returned.
+   * The trials are independent, so when OpenMP is available they are
+   * dispatched across the threads, and a trial falling clearly behind the
+   * best finished trial is abandoned before convergence (see EMFit).
    *
    * Optionally, the existing model can be used as an initial model for the
    * estimation by setting 'useExistingModel' to true.  If the fitting procedure
@@ -359,6 +431,28 @@ class GMM
                   const size_t trials = 1,
                   const bool useExistingModel = false);
 
+  /**
+   * Estimate the probability distribution from a stream of observations,
+   * using the stochastic (stepwise) EM mode of the fitting mechanism, so the
+   * observations never need to be resident in memory at once and the model
+   * updates after every batch.  This requires a FittingType that provides
+   * EstimateStreaming() (EMFit does); see EMFit::EstimateStreaming() for the
+   * algorithm and its knobs.
+   *
+   * Since the mode is single-pass, no trials are performed.  Optionally, the
+   * existing model can be used as the starting point by setting
+   * 'useExistingModel' to true; otherwise the model is initialized from the
+   * first batch of the stream.
+   *
+   * @param loader Stream to read observation batches from.
+   * @param useExistingModel If true, the existing model is used as the
+   *      starting point for the estimation.
+   * @return The average per-point log-likelihood of the stream (recent
+   *      batches weigh more; see EMFit::EstimateStreaming()).
+   */
+  double EstimateStreaming(data::StreamingLoader<>& loader,
+                           const bool useExistingModel = false);
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
@@ -399,7 +493,7 @@ class GMM
    * @param weights Weights of the given mixture model.
    */
   double LogLikelihood(const arma::mat& dataPoints,
-                       const std::vector<distribution::GaussianDistribution>& distsL,
+                       const std::vector<DistributionType>& distsL,
                        const arma::vec& weights) const;
 
   //! Locally-stored fitting object; in case the user did not pass one.
@@ -24,11 +24,12 @@ namespace gmm {
  * @param gaussians Number of Gaussians in this GMM.
  * @param dimensionality Dimensionality of each Gaussian.
  */
-template<typename FittingType>
-GMM<FittingType>::GMM(const size_t gaussians, const size_t dimensionality) :
+template<typename FittingType, typename DistributionType>
+GMM<FittingType, DistributionType>::GMM(const size_t gaussians,
+                                        const size_t dimensionality) :
     gaussians(gaussians),
     dimensionality(dimensionality),
-    dists(gaussians, distribution::GaussianDistribution(dimensionality)),
+    dists(gaussians, DistributionType(dimensionality)),
     weights(gaussians),
     localFitter(FittingType()),
     fitter(localFitter)
@@ -47,13 +48,13 @@ GMM<FittingType>::GMM(const size_t gaussians, const size_t dimensionality) :
  * @param dimensionality Dimensionality of each Gaussian.
  * @param fitter Initialized fitting mechanism.
  */
-template<typename FittingType>
-GMM<FittingType>::GMM(const size_t gaussians,
+template<typename FittingType, typename DistributionType>
+GMM<FittingType, DistributionType>::GMM(const size_t gaussians,
                       const size_t dimensionality,
                       FittingType& fitter) :
     gaussians(gaussians),
     dimensionality(dimensionality),
-    dists(gaussians, distribution::GaussianDistribution(dimensionality)),
+    dists(gaussians, DistributionType(dimensionality)),
     weights(gaussians),
     fitter(fitter)
 {
@@ -63,9 +64,10 @@ GMM<FittingType>::GMM(const size_t gaussians,
 
 
 // Copy constructor.
-template<typename FittingType>
+template<typename FittingType, typename DistributionType>
 template<typename OtherFittingType>
-GMM<FittingType>::GMM(const GMM<OtherFittingType>& other) :
+GMM<FittingType, DistributionType>::GMM(
+    const GMM<OtherFittingType, DistributionType>& other) :
     gaussians(other.gaussians),
     dimensionality(other.dimensionality),
     dists(other.dists),
@@ -74,8 +76,9 @@ GMM<FittingType>::GMM(const GMM<OtherFittingType>& other) :
     fitter(localFitter) { /* Nothing to do. */ }
 
 // Copy constructor for when the other GMM uses the same fitting type.
-template<typename FittingType>
-GMM<FittingType>::GMM(const GMM<FittingType>& other) :
+template<typename FittingType, typename DistributionType>
+GMM<FittingType, DistributionType>::GMM(
+    const GMM<FittingType, DistributionType>& other) :
     gaussians(other.Gaussians()),
     dimensionality(other.dimensionality),
     dists(other.dists),
@@ -83,10 +86,10 @@ GMM<FittingType>::GMM(const GMM<FittingType>& other) :
     localFitter(other.fitter),
     fitter(localFitter) { /* Nothing to do. */ }
 
-template<typename FittingType>
+template<typename FittingType, typename DistributionType>
 template<typename OtherFittingType>
-GMM<FittingType>& GMM<FittingType>::operator=(
-    const GMM<OtherFittingType>& other)
+GMM<FittingType, DistributionType>& GMM<FittingType, DistributionType>::
+operator=(const GMM<OtherFittingType, DistributionType>& other)
 {
   gaussians = other.gaussians;
   dimensionality = other.dimensionality;
@@ -96,8 +99,9 @@ GMM<FittingType>& GMM<FittingType>::operator=(
   return *this;
 }
 
-template<typename FittingType>
-GMM<FittingType>& GMM<FittingType>::operator=(const GMM<FittingType>& other)
+template<typename FittingType, typename DistributionType>
+GMM<FittingType, DistributionType>& GMM<FittingType, DistributionType>::
+operator=(const GMM<FittingType, DistributionType>& other)
 {
   gaussians = other.gaussians;
   dimensionality = other.dimensionality;
@@ -109,8 +113,8 @@ GMM<FittingType>& GMM<FittingType>::operator=(const GMM<FittingType>& other)
 }
 
 // Load a GMM from file.
-template<typename FittingType>
-void GMM<FittingType>::Load(const std::string& filename)
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Load(const std::string& filename)
 {
   util::SaveRestoreUtility load;
 
@@ -120,8 +124,8 @@ void GMM<FittingType>::Load(const std::string& filename)
 }
 
 // Save a GMM to a file.
-template<typename FittingType>
-void GMM<FittingType>::Save(const std::string& filename) const
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Save(const std::string& filename) const
 {
   util::SaveRestoreUtility save;
   Save(save);
@@ -132,8 +136,9 @@ void GMM<FittingType>::Save(const std::string& filename) const
 
 
 // Save a GMM to a SaveRestoreUtility.
-template<typename FittingType>
-void GMM<FittingType>::Save(util::SaveRestoreUtility& sr) const
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Save(
+    util::SaveRestoreUtility& sr) const
 {
   sr.SaveParameter(Type(), "type");
   sr.SaveParameter(gaussians, "gaussians");
@@ -155,8 +160,9 @@ void GMM<FittingType>::Save(util::SaveRestoreUtility& sr) const
 }
 
 // Load a GMM from SaveRestoreUtility.
-template<typename FittingType>
-void GMM<FittingType>::Load(const util::SaveRestoreUtility& sr)
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Load(
+    const util::SaveRestoreUtility& sr)
 {
     sr.LoadParameter(gaussians, "gaussians");
     sr.LoadParameter(dimensionality, "dimensionality");
@@ -183,8 +189,9 @@ void GMM<FittingType>::Load(const util::SaveRestoreUtility& sr)
 /**
  * Return the probability of the given observation being from this GMM.
  */
-template<typename FittingType>
-double GMM<FittingType>::Probability(const arma::vec& observation) const
+template<typename FittingType, typename DistributionType>
+double GMM<FittingType, DistributionType>::Probability(
+    const arma::vec& observation) const
 {
   // Sum the probability for each Gaussian in our mixture (and we have to
   // multiply by the prior for each Gaussian too).
@@ -199,21 +206,90 @@ double GMM<FittingType>::Probability(const arma::vec& observation) const
  * Return the probability of the given observation being from the given
  * component in the mixture.
  */
-template<typename FittingType>
-double GMM<FittingType>::Probability(const arma::vec& observation,
-                                     const size_t component) const
+template<typename FittingType, typename DistributionType>
+double GMM<FittingType, DistributionType>::Probability(
+    const arma::vec& observation,
+    const size_t component) const
 {
   // We are only considering one Gaussian component -- so we only need to call
   // Probability() once.  We do consider the prior probability!
   return weights[component] * dists[component].Probability(observation);
 }
 
+/**
+ * Return the probability of each of the given observations being from this
+ * GMM.
+ */
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Probability(
+    const arma::mat& observations,
+    arma::vec& probs) const
+{
+  // Evaluate each component over the whole block at once; the batched
+  // distribution path reuses its cached factorization and evaluates all of
+  // the Mahalanobis terms with a single triangular solve.
+  probs.zeros(observations.n_cols);
+
+  arma::vec phis;
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    dists[i].Probability(observations, phis);
+    probs += weights[i] * phis;
+  }
+}
+
+/**
+ * Return the probability of each of the given observations being from the
+ * given component in the mixture.
+ */
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Probability(
+    const arma::mat& observations,
+    const size_t component,
+    arma::vec& probs) const
+{
+  // We do consider the prior probability!
+  dists[component].Probability(observations, probs);
+  probs *= weights[component];
+}
+
+/**
+ * Compute the responsibility of each component for each of the given
+ * observations.
+ */
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Responsibilities(
+    const arma::mat& observations,
+    arma::mat& responsibilities) const
+{
+  responsibilities.set_size(gaussians, observations.n_cols);
+
+  arma::vec phis;
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    dists[i].Probability(observations, phis);
+    responsibilities.row(i) = weights[i] * trans(phis);
+  }
+
+  // Normalize each column so that it sums to one.  If every component
+  // underflowed to zero for some observation, fall back to a uniform
+  // assignment instead of dividing by zero.
+  for (size_t j = 0; j < observations.n_cols; j++)
+  {
+    const double total = accu(responsibilities.col(j));
+    if (total > 0.0)
+      responsibilities.col(j) /= total;
+    else
+      responsibilities.col(j).fill(1.0 / gaussians);
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
  */
-template<typename FittingType>
-arma::vec GMM<FittingType>::Random() const
+template<typename FittingType, typename DistributionType>
+arma::vec GMM<FittingType, DistributionType>::Random() const
 {
   // Determine which Gaussian it will be coming from.
   double gaussRand = math::Random();
@@ -230,17 +306,66 @@ arma::vec GMM<FittingType>::Random() const
     }
   }
 
-  return trans(chol(dists[gaussian].Covariance())) *
-      arma::randn<arma::vec>(dimensionality) + dists[gaussian].Mean();
+  // Sampling depends on the covariance representation, so let the component
+  // distribution handle it (this also reuses its cached factorization).
+  return dists[gaussian].Random();
+}
+
+/**
+ * Generate numSamples random observations, one per column of the output
+ * matrix.
+ */
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Random(const size_t numSamples,
+                                                arma::mat& samples) const
+{
+  samples.set_size(dimensionality, numSamples);
+
+  // First determine how many samples will come from each component, so that
+  // each component's share can be generated with one batched draw.
+  arma::Col<size_t> counts(gaussians);
+  counts.zeros();
+  for (size_t i = 0; i < numSamples; i++)
+  {
+    const double gaussRand = math::Random();
+    size_t gaussian = 0;
+
+    double sumProb = 0;
+    for (size_t g = 0; g < gaussians; g++)
+    {
+      sumProb += weights(g);
+      if (gaussRand <= sumProb)
+      {
+        gaussian = g;
+        break;
+      }
+    }
+
+    counts[gaussian]++;
+  }
+
+  // Now let each component generate its share of the samples at once.
+  size_t offset = 0;
+  for (size_t g = 0; g < gaussians; g++)
+  {
+    if (counts[g] == 0)
+      continue;
+
+    arma::mat block;
+    dists[g].Random(counts[g], block);
+    samples.cols(offset, offset + counts[g] - 1) = block;
+    offset += counts[g];
+  }
 }
 
 /**
  * Fit the GMM to the given observations.
  */
-template<typename FittingType>
-double GMM<FittingType>::Estimate(const arma::mat& observations,
-                                  const size_t trials,
-                                  const bool useExistingModel)
+template<typename FittingType, typename DistributionType>
+double GMM<FittingType, DistributionType>::Estimate(
+    const arma::mat& observations,
+    const size_t trials,
+    const bool useExistingModel)
 {
   double bestLikelihood; // This will be reported later.
 
@@ -259,7 +384,7 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
       return -DBL_MAX; // It's what they asked for...
 
     // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
+    std::vector<DistributionType> distsOrig;
     arma::vec weightsOrig;
     if (useExistingModel)
     {
@@ -267,45 +392,52 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
       weightsOrig = weights;
     }
 
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, dists, weights,
-        useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Info << "GMM::Estimate(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
+    // The trials are independent, so they are dispatched across the threads,
+    // each working on its own copy of the model and the fitting mechanism.
+    // The best final log-likelihood so far is shared between the trials, so
+    // that a trial falling hopelessly behind it can be abandoned inside the
+    // fitter instead of being run to convergence.  The loop index is signed
+    // for OpenMP.
+    bestLikelihood = -DBL_MAX;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long trial = 0; trial < (long) trials; ++trial)
     {
+      std::vector<DistributionType> distsTrial(gaussians,
+          DistributionType(dimensionality));
+      arma::vec weightsTrial(gaussians);
+
       if (useExistingModel)
       {
         distsTrial = distsOrig;
         weightsTrial = weightsOrig;
       }
 
-      fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
+      // Thread-local copy of the fitting mechanism, in case it has state.
+      FittingType trialFitter(fitter);
+      trialFitter.Estimate(observations, distsTrial, weightsTrial,
+          useExistingModel, &bestLikelihood);
 
       // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
+      const double newLikelihood = LogLikelihood(observations, distsTrial,
           weightsTrial);
 
-      Log::Info << "GMM::Estimate(): Log-likelihood of trial " << trial
-          << " is " << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
+#ifdef _OPENMP
+      #pragma omp critical (gmmTrialBest)
+#endif
       {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
+        Log::Info << "GMM::Estimate(): Log-likelihood of trial " << trial
+            << " is " << newLikelihood << "." << std::endl;
+
+        if (newLikelihood > bestLikelihood)
+        {
+          // Save new likelihood and copy new model.
+          bestLikelihood = newLikelihood;
 
-        dists = distsTrial;
-        weights = weightsTrial;
+          dists = distsTrial;
+          weights = weightsTrial;
+        }
       }
     }
   }
@@ -320,11 +452,12 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
  * Fit the GMM to the given observations, each of which has a certain
  * probability of being from this distribution.
  */
-template<typename FittingType>
-double GMM<FittingType>::Estimate(const arma::mat& observations,
-                                  const arma::vec& probabilities,
-                                  const size_t trials,
-                                  const bool useExistingModel)
+template<typename FittingType, typename DistributionType>
+double GMM<FittingType, DistributionType>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    const size_t trials,
+    const bool useExistingModel)
 {
   double bestLikelihood; // This will be reported later.
 
@@ -343,7 +476,7 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
       return -DBL_MAX; // It's what they asked for...
 
     // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
+    std::vector<DistributionType> distsOrig;
     arma::vec weightsOrig;
     if (useExistingModel)
     {
@@ -351,46 +484,49 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
       weightsOrig = weights;
     }
 
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Debug << "GMM::Estimate(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
+    // The trials are independent, so they are dispatched across the threads;
+    // see the unweighted overload above for the scheme.  The loop index is
+    // signed for OpenMP.
+    bestLikelihood = -DBL_MAX;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (long trial = 0; trial < (long) trials; ++trial)
     {
+      std::vector<DistributionType> distsTrial(gaussians,
+          DistributionType(dimensionality));
+      arma::vec weightsTrial(gaussians);
+
       if (useExistingModel)
       {
         distsTrial = distsOrig;
         weightsTrial = weightsOrig;
       }
 
-      fitter.Estimate(observations, distsTrial, weightsTrial,
-          useExistingModel);
+      // Thread-local copy of the fitting mechanism, in case it has state.
+      FittingType trialFitter(fitter);
+      trialFitter.Estimate(observations, probabilities, distsTrial,
+          weightsTrial, useExistingModel, &bestLikelihood);
 
       // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
+      const double newLikelihood = LogLikelihood(observations, distsTrial,
           weightsTrial);
 
-      Log::Debug << "GMM::Estimate(): Log-likelihood of trial " << trial
-          << " is " << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
+#ifdef _OPENMP
+      #pragma omp critical (gmmTrialBest)
+#endif
       {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
+        Log::Debug << "GMM::Estimate(): Log-likelihood of trial " << trial
+            << " is " << newLikelihood << "." << std::endl;
+
+        if (newLikelihood > bestLikelihood)
+        {
+          // Save new likelihood and copy new model.
+          bestLikelihood = newLikelihood;
 
-        dists = distsTrial;
-        weights = weightsTrial;
+          dists = distsTrial;
+          weights = weightsTrial;
+        }
       }
     }
   }
@@ -401,15 +537,36 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Fit the GMM to a stream of observations with stochastic EM.
+ */
+template<typename FittingType, typename DistributionType>
+double GMM<FittingType, DistributionType>::EstimateStreaming(
+    data::StreamingLoader<>& loader,
+    const bool useExistingModel)
+{
+  // The streaming mode is single-pass, so there is nothing to do here beyond
+  // handing our model to the fitting mechanism.
+  return fitter.EstimateStreaming(loader, dists, weights, useExistingModel);
+}
+
 /**
  * Classify the given observations as being from an individual component in this
  * GMM.
  */
-template<typename FittingType>
-void GMM<FittingType>::Classify(const arma::mat& observations,
+template<typename FittingType, typename DistributionType>
+void GMM<FittingType, DistributionType>::Classify(const arma::mat& observations,
                                 arma::Col<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Evaluate every component over the whole block with the batched path,
+  // then take the best component for each observation.
+  arma::mat likelihoods(gaussians, observations.n_cols);
+  arma::vec phis;
+  for (size_t j = 0; j < gaussians; ++j)
+  {
+    dists[j].Probability(observations, phis);
+    likelihoods.row(j) = weights[j] * trans(phis);
+  }
 
   // We should not have to fill this with values, because each one should be
   // overwritten.
@@ -420,10 +577,9 @@ void GMM<FittingType>::Classify(const arma::mat& observations,
     double probability = 0;
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (likelihoods(j, i) >= probability)
       {
-        probability = newProb;
+        probability = likelihoods(j, i);
         labels[i] = j;
       }
     }
@@ -433,10 +589,10 @@ void GMM<FittingType>::Classify(const arma::mat& observations,
 /**
  * Get the log-likelihood of this data's fit to the model.
  */
-template<typename FittingType>
-double GMM<FittingType>::LogLikelihood(
+template<typename FittingType, typename DistributionType>
+double GMM<FittingType, DistributionType>::LogLikelihood(
     const arma::mat& data,
-    const std::vector<distribution::GaussianDistribution>& distsL,
+    const std::vector<DistributionType>& distsL,
     const arma::vec& weightsL) const
 {
   double loglikelihood = 0;
@@ -458,8 +614,8 @@ double GMM<FittingType>::LogLikelihood(
 /**
 * Returns a string representation of this object.
 */
-template<typename FittingType>
-std::string GMM<FittingType>::ToString() const
+template<typename FittingType, typename DistributionType>
+std::string GMM<FittingType, DistributionType>::ToString() const
 {
   std::ostringstream convert;
   std::ostringstream data;
@@ -10,6 +10,7 @@
 #define __MLPACK_METHODS_HMM_HMM_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
@@ -253,6 +254,23 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Col<size_t>& stateSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given
+   * data sequences, using the Viterbi algorithm.  The sequences are
+   * independent and only read the model state, so they are divided among the
+   * threads when OpenMP is available; use this overload instead of calling
+   * Predict() once per sequence when scoring large batches.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    observation sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each observation sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Col<size_t> >& stateSeq,
+               arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -261,6 +279,20 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are independent and only read the model state, so they are
+   * divided among the threads when OpenMP is available; use this overload
+   * instead of calling LogLikelihood() once per sequence when scoring large
+   * batches.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param logLikelihoods Vector in which the log-likelihood of each
+   *    observation sequence will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * HMM filtering. Computes the k-step-ahead expected emission at each time
    * conditioned only on prior observations. That is
@@ -369,6 +401,66 @@ class HMM
   arma::mat transition;
   
  private:
+  /**
+   * Compute the probability of every observation in the given data sequence
+   * under every emission distribution, storing the result in the given matrix
+   * (rows are states, columns are observations).  Precomputing this matrix
+   * lets each step of the Forward and Backward recursions be a single
+   * matrix-vector product, and avoids recomputing the same emission
+   * probability for every state in the Backward recursion.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionProb Matrix in which emission probabilities will be saved.
+   */
+  void EmissionProbabilities(const arma::mat& dataSeq,
+                             arma::mat& emissionProb) const;
+
+  /**
+   * Evaluate each emission distribution once against the given observation.
+   * Some distributions cache derived quantities (such as Cholesky factors of
+   * their covariances) lazily, rebuilding them on the first evaluation after
+   * a modification; calling this before a parallel region makes those
+   * rebuilds happen serially, so the threads then see the distributions as
+   * genuinely read-only.
+   *
+   * @param observation Observation to evaluate each distribution against.
+   */
+  void WarmEmissionCaches(const arma::vec& observation) const;
+
+  HAS_MEM_FUNC(Probability, HasBatchProbability)
+
+  //! Fill one row of the emission probability matrix using the batched
+  //! Probability() overload of the distribution, if it has one; this
+  //! evaluates the whole sequence in one call (for RegressionDistribution,
+  //! for instance, that is a single matrix-vector product).
+  template<typename Dist>
+  void StateEmissionProbabilities(const Dist& distribution,
+      const arma::mat& dataSeq,
+      const size_t state,
+      arma::mat& emissionProb,
+      typename boost::enable_if<HasBatchProbability<Dist,
+          void(Dist::*)(const arma::mat&, arma::vec&) const>
+      >::type* = 0) const
+  {
+    arma::vec probs;
+    distribution.Probability(dataSeq, probs);
+    emissionProb.row(state) = probs.t();
+  }
+
+  //! With any other distribution type, evaluate one observation at a time.
+  template<typename Dist>
+  void StateEmissionProbabilities(const Dist& distribution,
+      const arma::mat& dataSeq,
+      const size_t state,
+      arma::mat& emissionProb,
+      typename boost::disable_if<HasBatchProbability<Dist,
+          void(Dist::*)(const arma::mat&, arma::vec&) const>
+      >::type* = 0) const
+  {
+    for (size_t t = 0; t < dataSeq.n_cols; t++)
+      emissionProb(state, t) = distribution.Probability(dataSeq.unsafe_col(t));
+  }
+
   //! Initial state probability vector.
   arma::vec initial;
 
@@ -81,10 +81,14 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
+  // Find length of all sequences and ensure they are the correct size.  We
+  // also store the starting position of each sequence in the emission list,
+  // so that the sequences can later be processed independently.
   size_t totalLength = 0;
+  std::vector<size_t> seqOffsets(dataSeq.size());
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
+    seqOffsets[seq] = totalLength;
     totalLength += dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
@@ -113,48 +117,87 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The sequences are independent given the current model, so the E-step
+    // and the accumulation of the sufficient statistics can be divided among
+    // the threads.  Each thread accumulates into its own copies of the
+    // initial-probability and transition statistics, which are combined at
+    // the end; the emission list entries of each sequence occupy a disjoint
+    // column range (given by seqOffsets), so they are written in place.
+    //
+    // The distributions cache some derived quantities lazily, and the M-step
+    // at the end of each iteration leaves those caches stale, so they must be
+    // rebuilt serially here before every pass.
+    if (dataSeq.size() > 0 && dataSeq[0].n_cols > 0)
+      WarmEmissionCaches(dataSeq[0].unsafe_col(0));
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
     {
-      arma::mat stateProb;
-      arma::mat forward;
-      arma::mat backward;
-      arma::vec scales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; t++)
+      arma::vec threadInitial(transition.n_rows);
+      threadInitial.zeros();
+      arma::mat threadTransition(transition.n_rows, transition.n_cols);
+      threadTransition.zeros();
+      double threadLoglik = 0;
+
+      // Loop over each sequence (the loop index is signed for OpenMP).
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (long seq = 0; seq < (long) dataSeq.size(); seq++)
       {
-        for (size_t j = 0; j < transition.n_cols; j++)
+        arma::mat stateProb;
+        arma::mat forward;
+        arma::mat backward;
+        arma::vec scales;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        threadLoglik += Estimate(dataSeq[seq], stateProb, forward, backward,
+            scales);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        size_t sumTime = seqOffsets[seq];
+        for (size_t t = 0; t < dataSeq[seq].n_cols; t++)
         {
-          // Add to estimate of initial probability for state j.
-          newInitial[j] = stateProb(j, 0);
+          // Add to list of emission observations, for
+          // Distribution::Estimate().
+          emissionList.col(sumTime) = dataSeq[seq].col(t);
 
-          if (t < dataSeq[seq].n_cols - 1)
+          for (size_t j = 0; j < transition.n_cols; j++)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
+            // Add to estimate of initial probability for state j.
+            threadInitial[j] = stateProb(j, 0);
+
+            if (t < dataSeq[seq].n_cols - 1)
+            {
+              // Estimate of T_ij (probability of transition from state j to
+              // state i).  We postpone multiplication of the old T_ij until
+              // later.
+              for (size_t i = 0; i < transition.n_rows; i++)
+                threadTransition(i, j) += forward(j, t) * backward(i, t + 1) *
+                    emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
+                    scales[t + 1];
+            }
+
+            emissionProb[j][sumTime] = stateProb(j, t);
           }
-
-          // Add to list of emission observations, for Distribution::Estimate().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+          sumTime++;
         }
-        sumTime++;
+      }
+
+      // Combine the per-thread accumulators.
+#ifdef _OPENMP
+      #pragma omp critical (hmmTrainAccumulate)
+#endif
+      {
+        newInitial += threadInitial;
+        newTransition += threadTransition;
+        loglik += threadLoglik;
       }
     }
 
@@ -420,6 +463,33 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
+/**
+ * Compute the most probable hidden state sequence for each of the given data
+ * sequences.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Col<size_t> >& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  // Decoding only reads the model state, and each sequence writes only its
+  // own output slots, so the sequences are divided among the threads; each
+  // call allocates its own Viterbi workspace.  Sequence lengths may vary
+  // wildly, so the schedule is dynamic.  The loop index is signed for OpenMP.
+  // Warming the lazily-cached parts of the emission distributions first makes
+  // the model state truly read-only for the threads.
+  if (dataSeq.size() > 0 && dataSeq[0].n_cols > 0)
+    WarmEmissionCaches(dataSeq[0].unsafe_col(0));
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long i = 0; i < (long) dataSeq.size(); ++i)
+    logLikelihoods[i] = Predict(dataSeq[i], stateSeq[i]);
+}
+
 /**
  * Compute the log-likelihood of the given data sequence.
  */
@@ -435,6 +505,27 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   return accu(log(scales));
 }
 
+/**
+ * Compute the log-likelihood of each of the given data sequences.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  logLikelihoods.set_size(dataSeq.size());
+
+  // As in the batch Predict() overload, the sequences are independent and
+  // the model state is read-only (after the emission caches are warmed), so
+  // they are divided among the threads.
+  if (dataSeq.size() > 0 && dataSeq[0].n_cols > 0)
+    WarmEmissionCaches(dataSeq[0].unsafe_col(0));
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long i = 0; i < (long) dataSeq.size(); ++i)
+    logLikelihoods[i] = LogLikelihood(dataSeq[i]);
+}
+
 /**
  * HMM filtering.
  */
@@ -490,14 +581,18 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
   scales.zeros(dataSeq.n_cols);
 
+  // Precompute the emission probability of every state for every observation,
+  // so that each step of the recursion below is a single matrix-vector
+  // product against the transition matrix.
+  arma::mat emissionProb;
+  EmissionProbabilities(dataSeq, emissionProb);
+
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  forwardProb.col(0) = initial % emissionProb.unsafe_col(0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
@@ -506,15 +601,13 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // Now compute the probabilities for each successive observation.
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation; for all states at once, that
+    // is the product of the transition matrix with the previous column,
+    // multiplied elementwise by the emission probabilities.
+    forwardProb.col(t) = (transition * forwardProb.col(t - 1)) %
+        emissionProb.unsafe_col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
@@ -531,28 +624,60 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
   backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
 
+  // Precompute the emission probability of every state for every observation.
+  // In addition to making each step of the recursion below a single
+  // matrix-vector product, this avoids recomputing each emission probability
+  // once per state.
+  arma::mat emissionProb;
+  EmissionProbabilities(dataSeq, emissionProb);
+
   // The last element probability is 1.
   backwardProb.col(dataSeq.n_cols - 1).fill(1);
 
   // Now step backwards through all other observations.
   for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      backwardProb(j, t) /= scales[t + 1];
-    }
+    // The backward probability of state j at time t is the sum over all
+    // states of the probability of the next state having been a transition
+    // from the current state multiplied by the probability of each of those
+    // states emitting the given observation; for all states at once, that is
+    // the product of the transposed transition matrix with the next column
+    // weighted elementwise by the emission probabilities.
+    backwardProb.col(t) = trans(transition) *
+        (backwardProb.col(t + 1) % emissionProb.unsafe_col(t + 1));
+
+    // Normalize by the weights from the forward algorithm.
+    backwardProb.col(t) /= scales[t + 1];
   }
 }
 
+/**
+ * Compute the probability of every observation under every emission
+ * distribution.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbabilities(const arma::mat& dataSeq,
+                                              arma::mat& emissionProb) const
+{
+  emissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+
+  // Each state's row is filled by StateEmissionProbabilities(), which uses
+  // the batched Probability() overload of the distribution if one exists.
+  for (size_t state = 0; state < transition.n_rows; state++)
+    StateEmissionProbabilities(emission[state], dataSeq, state, emissionProb);
+}
+
+/**
+ * Evaluate each emission distribution once so that any lazily-cached derived
+ * quantities are rebuilt before the distributions are shared across threads.
+ */
+template<typename Distribution>
+void HMM<Distribution>::WarmEmissionCaches(const arma::vec& observation) const
+{
+  for (size_t state = 0; state < emission.size(); state++)
+    emission[state].Probability(observation);
+}
+
 template<typename Distribution>
 std::string HMM<Distribution>::ToString() const
 {
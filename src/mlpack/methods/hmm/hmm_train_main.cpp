@@ -11,6 +11,10 @@
 
 #include <mlpack/methods/gmm/gmm.hpp>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 PROGRAM_INFO("Hidden Markov Model (HMM) Training", "This program allows a "
     "Hidden Markov Model to be trained on labeled or unlabeled data.  It "
     "support three types of HMMs: discrete HMMs, Gaussian HMMs, or GMM HMMs."
@@ -28,7 +32,14 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Training", "This program allows a "
     "\n\n"
     "Optionally, a pre-created HMM model can be used as a guess for the "
     "transition matrix and emission probabilities; this is specifiable with "
-    "--model_file.");
+    "--model_file."
+    "\n\n"
+    "For corpora too large to fit in memory, --streaming (used with --batch) "
+    "trains on the sequence files in fixed-size chunks, so only --chunk_size "
+    "sequences are held in memory at a time; while one chunk is being trained "
+    "on, the next chunk is loaded from disk.  The model is updated "
+    "incrementally chunk by chunk, which approximates training on the whole "
+    "corpus at once.  Streaming training is unsupervised only.");
 
 PARAM_STRING_REQ("input_file", "File containing input observations.", "i");
 PARAM_STRING_REQ("type", "Type of HMM: discrete | gaussian | gmm.", "t");
@@ -47,6 +58,12 @@ PARAM_STRING("output_file", "File to save trained HMM to (XML).", "o",
     "output_hmm.xml");
 PARAM_INT("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_DOUBLE("tolerance", "Tolerance of the Baum-Welch algorithm.", "T", 1e-5);
+PARAM_FLAG("streaming", "If true (and --batch is given), train on the "
+    "sequence files in chunks of --chunk_size sequences instead of loading "
+    "the whole corpus into memory.  Only unsupervised training is supported.",
+    "S");
+PARAM_INT("chunk_size", "Number of sequences to hold in memory at once when "
+    "--streaming is given.", "c", 256);
 
 using namespace mlpack;
 using namespace mlpack::hmm;
@@ -57,6 +74,122 @@ using namespace mlpack::math;
 using namespace arma;
 using namespace std;
 
+/**
+ * Read the list of sequence file names from the given batch file.
+ */
+void ReadFileList(const string& inputFile, vector<string>& files)
+{
+  fstream f(inputFile.c_str(), ios_base::in);
+
+  if (!f.is_open())
+    Log::Fatal << "Could not open '" << inputFile << "' for reading." << endl;
+
+  // Now read each line in.
+  char lineBuf[1024]; // Max 1024 characters... hopefully that is long enough.
+  f.getline(lineBuf, 1024, '\n');
+  while (!f.eof())
+  {
+    files.push_back(string(lineBuf));
+    f.getline(lineBuf, 1024, '\n');
+  }
+
+  f.close();
+}
+
+/**
+ * Load the next chunk of up to chunkSize sequences from the file list,
+ * starting at fileIndex (which is advanced past the consumed files).
+ * Sequences that fail to load are skipped with a warning, matching the
+ * unlabeled batch loading behavior.
+ */
+void LoadSequenceChunk(const vector<string>& files,
+                       size_t& fileIndex,
+                       const size_t chunkSize,
+                       const string& type,
+                       vector<mat>& chunk)
+{
+  chunk.clear();
+
+  while ((fileIndex < files.size()) && (chunk.size() < chunkSize))
+  {
+    Log::Info << "Adding training sequence from '" << files[fileIndex] << "'."
+        << endl;
+
+    chunk.push_back(mat());
+    if (!data::Load(files[fileIndex], chunk.back(), false))
+    {
+      Log::Warn << "Loading training sequence from '" << files[fileIndex]
+          << "' failed.  Sequence ignored." << endl;
+      chunk.pop_back(); // Remove last element which we did not use.
+    }
+    else if (type == "discrete")
+    {
+      // See if we need to transpose the data.
+      if (chunk.back().n_cols == 1)
+        chunk.back() = trans(chunk.back());
+    }
+
+    ++fileIndex;
+  }
+}
+
+/**
+ * Train the given HMM incrementally on chunks of sequences read from the
+ * given list of files, so that only about two chunks of the corpus are in
+ * memory at any time.  The reads are double-buffered: while Train() runs on
+ * the current chunk, the next chunk is loaded from disk, overlapping I/O
+ * with compute.
+ */
+template<typename HMMType>
+void StreamingTrain(HMMType& hmm,
+                    const vector<string>& files,
+                    const size_t chunkSize,
+                    const string& type)
+{
+#ifdef _OPENMP
+  // Training is parallel internally, so the loader section below must be
+  // able to run alongside a nested parallel region.
+  omp_set_nested(1);
+#endif
+
+  vector<mat> chunk;
+  vector<mat> nextChunk;
+  size_t fileIndex = 0;
+
+  LoadSequenceChunk(files, fileIndex, chunkSize, type, chunk);
+
+  size_t chunksTrained = 0;
+  while (!chunk.empty())
+  {
+    // Train on the current chunk while the next chunk loads.  Without
+    // OpenMP, the sections simply run one after the other.
+#ifdef _OPENMP
+    #pragma omp parallel sections num_threads(2)
+#endif
+    {
+#ifdef _OPENMP
+      #pragma omp section
+#endif
+      {
+        hmm.Train(chunk);
+      }
+#ifdef _OPENMP
+      #pragma omp section
+#endif
+      {
+        LoadSequenceChunk(files, fileIndex, chunkSize, type, nextChunk);
+      }
+    }
+
+    chunk.swap(nextChunk);
+    nextChunk.clear();
+    ++chunksTrained;
+  }
+
+  Log::Info << "Trained on " << chunksTrained << " chunks of (up to) "
+      << chunkSize << " sequences." << endl;
+}
+
 int main(int argc, char** argv)
 {
   // Parse command line options.
@@ -77,6 +210,22 @@ int main(int argc, char** argv)
   const int states = CLI::GetParam<int>("states");
   const bool batch = CLI::HasParam("batch");
   const double tolerance = CLI::GetParam<double>("tolerance");
+  const bool streaming = CLI::HasParam("streaming");
+  const int chunkSizeParam = CLI::GetParam<int>("chunk_size");
+
+  if (streaming && !batch)
+    Log::Fatal << "--streaming requires --batch (a list of sequence files)."
+        << endl;
+
+  if (streaming && labelsFile != "")
+    Log::Fatal << "--streaming only supports unsupervised training; "
+        << "--labels_file cannot be used." << endl;
+
+  if (streaming && chunkSizeParam <= 0)
+    Log::Fatal << "Invalid chunk size (" << chunkSizeParam << "); must be "
+        << "greater than or equal to 1." << endl;
+
+  const size_t chunkSize = size_t(chunkSizeParam);
 
   // Validate number of states.
   if (states == 0 && modelFile == "")
@@ -94,38 +243,40 @@ int main(int argc, char** argv)
   // Load the dataset(s) and labels.
   vector<mat> trainSeq;
   vector<arma::Col<size_t> > labelSeq; // May be empty.
+  vector<string> sequenceFiles; // Only used in batch mode.
   if (batch)
   {
     // The input file contains a list of files to read.
     Log::Info << "Reading list of training sequences from '" << inputFile
         << "'." << endl;
 
-    fstream f(inputFile.c_str(), ios_base::in);
+    ReadFileList(inputFile, sequenceFiles);
 
-    if (!f.is_open())
-      Log::Fatal << "Could not open '" << inputFile << "' for reading." << endl;
+    if (sequenceFiles.empty())
+      Log::Fatal << "No sequence files listed in '" << inputFile << "'."
+          << endl;
 
-    // Now read each line in.
-    char lineBuf[1024]; // Max 1024 characters... hopefully that is long enough.
-    f.getline(lineBuf, 1024, '\n');
-    while (!f.eof())
+    // In streaming mode, the sequences are loaded chunk by chunk during
+    // training instead of all up front.
+    for (size_t i = 0; !streaming && i < sequenceFiles.size(); ++i)
     {
-      Log::Info << "Adding training sequence from '" << lineBuf << "'." << endl;
+      Log::Info << "Adding training sequence from '" << sequenceFiles[i]
+          << "'." << endl;
 
       // Now read the matrix.
       trainSeq.push_back(mat());
       if (labelsFile == "") // Nonfatal in this case.
       {
-        if (!data::Load(lineBuf, trainSeq.back(), false))
+        if (!data::Load(sequenceFiles[i], trainSeq.back(), false))
         {
-          Log::Warn << "Loading training sequence from '" << lineBuf << "' "
-              << "failed.  Sequence ignored." << endl;
+          Log::Warn << "Loading training sequence from '" << sequenceFiles[i]
+              << "' failed.  Sequence ignored." << endl;
           trainSeq.pop_back(); // Remove last element which we did not use.
         }
       }
       else
       {
-        data::Load(lineBuf, trainSeq.back(), true);
+        data::Load(sequenceFiles[i], trainSeq.back(), true);
       }
 
       // See if we need to transpose the data.
@@ -134,16 +285,13 @@ int main(int argc, char** argv)
         if (trainSeq.back().n_cols == 1)
           trainSeq.back() = trans(trainSeq.back());
       }
-
-      f.getline(lineBuf, 1024, '\n');
     }
 
-    f.close();
-
     // Now load labels, if we need to.
     if (labelsFile != "")
     {
-      f.open(labelsFile.c_str(), ios_base::in);
+      char lineBuf[1024]; // Max 1024 characters... hopefully long enough.
+      fstream f(labelsFile.c_str(), ios_base::in);
 
       if (!f.is_open())
         Log::Fatal << "Could not open '" << labelsFile << "' for reading."
@@ -226,12 +374,33 @@ int main(int argc, char** argv)
       // Maximum observation is necessary so we know how to train the discrete
       // distribution.
       size_t maxEmission = 0;
-      for (vector<mat>::iterator it = trainSeq.begin(); it != trainSeq.end();
-           ++it)
+      if (streaming)
       {
-        size_t maxSeq = size_t(as_scalar(max(trainSeq[0], 1))) + 1;
-        if (maxSeq > maxEmission)
-          maxEmission = maxSeq;
+        // One cheap pass over the corpus (the observations are
+        // one-dimensional) to find the number of distinct emissions.
+        for (size_t i = 0; i < sequenceFiles.size(); ++i)
+        {
+          mat seq;
+          if (!data::Load(sequenceFiles[i], seq, false))
+            continue; // It will be warned about (and skipped) during training.
+
+          if (seq.n_cols == 1)
+            seq = trans(seq);
+
+          const size_t maxSeq = size_t(as_scalar(max(seq, 1))) + 1;
+          if (maxSeq > maxEmission)
+            maxEmission = maxSeq;
+        }
+      }
+      else
+      {
+        for (vector<mat>::iterator it = trainSeq.begin(); it != trainSeq.end();
+             ++it)
+        {
+          size_t maxSeq = size_t(as_scalar(max(*it, 1))) + 1;
+          if (maxSeq > maxEmission)
+            maxEmission = maxSeq;
+        }
       }
 
       Log::Info << maxEmission << " discrete observations in the input data."
@@ -243,7 +412,9 @@ int main(int argc, char** argv)
     }
 
     // Do we have labels?
-    if (labelsFile == "")
+    if (streaming)
+      StreamingTrain(hmm, sequenceFiles, chunkSize, type);
+    else if (labelsFile == "")
       hmm.Train(trainSeq); // Unsupervised training.
     else
       hmm.Train(trainSeq, labelSeq); // Supervised training.
@@ -272,7 +443,17 @@ int main(int argc, char** argv)
     else
     {
       // Find dimension of the data.
-      dimensionality = trainSeq[0].n_rows;
+      if (streaming)
+      {
+        // Peek at the first sequence; the corpus is not held in memory.
+        mat peek;
+        data::Load(sequenceFiles[0], peek, true);
+        dimensionality = peek.n_rows;
+      }
+      else
+      {
+        dimensionality = trainSeq[0].n_rows;
+      }
 
       hmm = HMM<GaussianDistribution>(size_t(states),
           GaussianDistribution(dimensionality), tolerance);
@@ -286,7 +467,9 @@ int main(int argc, char** argv)
             << dimensionality << ")!" << endl;
 
     // Now run the training.
-    if (labelsFile == "")
+    if (streaming)
+      StreamingTrain(hmm, sequenceFiles, chunkSize, type);
+    else if (labelsFile == "")
       hmm.Train(trainSeq); // Unsupervised training.
     else
       hmm.Train(trainSeq, labelSeq); // Supervised training.
@@ -315,7 +498,17 @@ int main(int argc, char** argv)
     else
     {
       // Find dimension of the data.
-      dimensionality = trainSeq[0].n_rows;
+      if (streaming)
+      {
+        // Peek at the first sequence; the corpus is not held in memory.
+        mat peek;
+        data::Load(sequenceFiles[0], peek, true);
+        dimensionality = peek.n_rows;
+      }
+      else
+      {
+        dimensionality = trainSeq[0].n_rows;
+      }
 
       const int gaussians = CLI::GetParam<int>("gaussians");
 
@@ -343,7 +536,11 @@ int main(int argc, char** argv)
     {
       Log::Warn << "Unlabeled training of GMM HMMs is almost certainly not "
           << "going to produce good results!" << endl;
-      hmm.Train(trainSeq);
+
+      if (streaming)
+        StreamingTrain(hmm, sequenceFiles, chunkSize, type);
+      else
+        hmm.Train(trainSeq);
     }
     else
     {
@@ -0,0 +1,132 @@
+/**
+ * @file online_viterbi.hpp
+ * @author Ryan Curtin
+ *
+ * Streaming (fixed-lag) Viterbi decoder for hidden Markov models.
+ */
+#ifndef __MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+#define __MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+
+#include <mlpack/core.hpp>
+
+#include "hmm.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * A streaming Viterbi decoder for hidden Markov models.  Whereas
+ * HMM::Predict() requires the complete observation sequence up front and
+ * materializes the full state-probability and backtracking matrices (O(T)
+ * memory for a sequence of length T), this class accepts one observation at a
+ * time through Step() and keeps only a ring buffer of the last 'lag'
+ * backpointer columns, so its memory use and per-observation cost are
+ * independent of the length of the stream.
+ *
+ * The decoder uses fixed-lag traceback: once 'lag' further observations have
+ * been seen, the state decision at the oldest buffered time step is emitted
+ * by backtracking from the currently most likely state.  For lags of a few
+ * times the model's mixing time this matches the full Viterbi path in
+ * practice, but it is an approximation; if the lag is at least as long as the
+ * complete sequence, the decoded path (obtained entirely from Flush()) is
+ * exactly the full Viterbi path.
+ *
+ * Example use, decoding an endless stream of observations:
+ *
+ * @code
+ * HMM<DiscreteDistribution> hmm(initial, transition, emission);
+ * OnlineViterbi<DiscreteDistribution> decoder(hmm, 64);
+ *
+ * size_t state;
+ * while (stream.HasMoreObservations())
+ *   if (decoder.Step(stream.NextObservation(), state))
+ *     HandleDecodedState(state);
+ *
+ * // At the end of the stream, the last 'lag' decisions are still pending.
+ * arma::Col<size_t> tail;
+ * decoder.Flush(tail);
+ * @endcode
+ *
+ * @tparam Distribution Emission distribution type of the HMM.
+ */
+template<typename Distribution = distribution::DiscreteDistribution>
+class OnlineViterbi
+{
+ public:
+  /**
+   * Create the decoder for the given HMM.  The decoder takes a snapshot of
+   * the model parameters, so later modifications of the HMM do not affect an
+   * in-progress decode; construct a new decoder (or call Reset()) after
+   * retraining.
+   *
+   * @param hmm Model to decode observations with.
+   * @param lag Number of observations by which state decisions trail the most
+   *     recent observation.
+   */
+  OnlineViterbi(const HMM<Distribution>& hmm, const size_t lag = 64);
+
+  /**
+   * Process a single observation.  If at least 'lag' observations have been
+   * seen before this one, the state decision for the oldest pending time step
+   * becomes final and is stored in decodedState; the return value indicates
+   * whether that happened.  After the warm-up period, exactly one state is
+   * emitted per call, lagging 'lag' steps behind the input.
+   *
+   * @param observation Next observation of the stream.
+   * @param decodedState Storage for the finalized state, if any.
+   * @return True if a state decision was emitted.
+   */
+  bool Step(const arma::vec& observation, size_t& decodedState);
+
+  /**
+   * Finish the stream: decode the pending time steps (at most 'lag' of them,
+   * in order) by a full traceback from the most likely current state, and
+   * then reset the decoder for a new stream.
+   *
+   * @param decodedStates Vector to store the remaining state decisions in.
+   */
+  void Flush(arma::Col<size_t>& decodedStates);
+
+  /**
+   * Reset the decoder to the beginning of a new stream, re-reading the model
+   * parameters from the HMM.
+   */
+  void Reset();
+
+  //! Return the traceback lag.
+  size_t Lag() const { return lag; }
+
+  //! Return the number of observations seen since the last reset.
+  size_t Time() const { return time; }
+
+ private:
+  //! Model to decode with.
+  const HMM<Distribution>& hmm;
+
+  //! Number of observations by which decisions trail the stream.
+  size_t lag;
+
+  //! Log of the transposed transition matrix (column j holds the log
+  //! probabilities of moving to state j from each state).
+  arma::mat logTransition;
+
+  //! Log-probability of the most likely path ending in each state at the
+  //! current time step, normalized so the largest entry is 0 (the shift is
+  //! shared by all states, so it does not affect any argmax).
+  arma::vec logStateProb;
+
+  //! Ring buffer of backpointers; column (t mod lag) holds, for each state,
+  //! the most likely predecessor state at time step t - 1.
+  arma::Mat<size_t> backpointers;
+
+  //! Number of observations seen since the last reset.
+  size_t time;
+};
+
+}; // namespace hmm
+}; // namespace mlpack
+
+// Include implementation.
+#include "online_viterbi_impl.hpp"
+
+#endif
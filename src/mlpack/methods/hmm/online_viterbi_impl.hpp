@@ -0,0 +1,135 @@
+/**
+ * @file online_viterbi_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the streaming (fixed-lag) Viterbi decoder.
+ */
+#ifndef __MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+#define __MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+
+// Just in case...
+#include "online_viterbi.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+template<typename Distribution>
+OnlineViterbi<Distribution>::OnlineViterbi(const HMM<Distribution>& hmm,
+                                           const size_t lag) :
+    hmm(hmm),
+    lag(lag)
+{
+  if (lag == 0)
+    Log::Fatal << "OnlineViterbi::OnlineViterbi(): lag must be at least 1."
+        << std::endl;
+
+  Reset();
+}
+
+template<typename Distribution>
+void OnlineViterbi<Distribution>::Reset()
+{
+  const size_t states = hmm.Transition().n_rows;
+
+  // Store the logs of the transposed transition matrix, because we will be
+  // using the rows of the transition matrix (as in HMM::Predict()).
+  logTransition = log(trans(hmm.Transition()));
+
+  logStateProb.zeros(states);
+  backpointers.zeros(states, lag);
+  time = 0;
+}
+
+template<typename Distribution>
+bool OnlineViterbi<Distribution>::Step(const arma::vec& observation,
+                                       size_t& decodedState)
+{
+  const size_t states = logTransition.n_rows;
+
+  // Emission log-probability of this observation for every state.
+  arma::vec logEmission(states);
+  for (size_t state = 0; state < states; state++)
+    logEmission[state] = log(hmm.Emission()[state].Probability(observation));
+
+  if (time == 0)
+  {
+    // The first time step uses the initial state probabilities and produces
+    // no backpointers.
+    logStateProb = log(hmm.Initial()) + logEmission;
+  }
+  else
+  {
+    // The probability of ending in state j is the probability of the best
+    // path ending in the most favorable previous state, extended by a
+    // transition to j; the predecessor is remembered in the ring buffer.
+    arma::vec newLogStateProb(states);
+    arma::uword index;
+    for (size_t j = 0; j < states; j++)
+    {
+      arma::vec prob = logStateProb + logTransition.col(j);
+      newLogStateProb[j] = prob.max(index) + logEmission[j];
+      backpointers(j, time % lag) = index;
+    }
+
+    logStateProb = newLogStateProb;
+  }
+
+  // Renormalize so the log-probabilities do not drift towards -infinity on an
+  // unbounded stream.  The shift is shared by all states, so no argmax (and
+  // hence no decision) is affected.
+  logStateProb -= logStateProb.max();
+
+  time++;
+
+  // Once the ring buffer holds a full lag of backpointers beyond the oldest
+  // pending time step, that step's decision is emitted by backtracking from
+  // the currently most likely state.
+  if (time > lag)
+  {
+    arma::uword index;
+    logStateProb.max(index);
+
+    // The backpointer stored at time step s gives the most likely predecessor
+    // at time step s - 1, so lag applications starting from the most recent
+    // step (time - 1) yield the state at time step time - 1 - lag.
+    size_t state = index;
+    for (size_t s = time - 1; s > time - 1 - lag; s--)
+      state = backpointers(state, s % lag);
+
+    decodedState = state;
+    return true;
+  }
+
+  return false;
+}
+
+template<typename Distribution>
+void OnlineViterbi<Distribution>::Flush(arma::Col<size_t>& decodedStates)
+{
+  const size_t remaining = std::min(time, lag);
+  decodedStates.set_size(remaining);
+
+  if (remaining > 0)
+  {
+    // Trace the best path backwards from the most likely current state,
+    // filling in the pending decisions from newest to oldest.
+    arma::uword index;
+    logStateProb.max(index);
+
+    size_t state = index;
+    decodedStates[remaining - 1] = state;
+    for (size_t i = 1; i < remaining; i++)
+    {
+      state = backpointers(state, (time - i) % lag);
+      decodedStates[remaining - 1 - i] = state;
+    }
+  }
+
+  // The stream is finished; prepare for a new one.
+  Reset();
+}
+
+}; // namespace hmm
+}; // namespace mlpack
+
+#endif
@@ -110,6 +110,14 @@ class KernelPCA
   bool CenterTransformedData() const { return centerTransformedData; }
   //! Return whether or not the transformed data is centered.
   bool& CenterTransformedData() { return centerTransformedData; }
+
+  //! Get the kernel matrix cache directory ("" means caching is disabled).
+  const std::string& CacheDirectory() const { return cacheDirectory; }
+  //! Modify the kernel matrix cache directory.  If set to an existing
+  //! directory, Apply() looks the kernel matrix up in (and stores it to) a
+  //! disk-backed cache instead of always recomputing it; see
+  //! kernel::KernelMatrixCache.
+  std::string& CacheDirectory() { return cacheDirectory; }
    
   // Returns a string representation of this object. 
   std::string ToString() const;
@@ -120,6 +128,8 @@ class KernelPCA
   //! If true, the data will be scaled (by standard deviation) when Apply() is
   //! run.
   bool centerTransformedData;
+  //! Directory of the kernel matrix cache ("" disables caching).
+  std::string cacheDirectory;
 
 }; // class KernelPCA
 
@@ -19,7 +19,8 @@ template <typename KernelType, typename KernelRule>
 KernelPCA<KernelType, KernelRule>::KernelPCA(const KernelType kernel,
                                  const bool centerTransformedData) :
       kernel(kernel),
-      centerTransformedData(centerTransformedData)
+      centerTransformedData(centerTransformedData),
+      cacheDirectory("")
 { }
 
 //! Apply Kernel Principal Component Analysis to the provided data set.
@@ -31,7 +32,8 @@ void KernelPCA<KernelType, KernelRule>::Apply(const arma::mat& data,
                                   const size_t newDimension)
 {
   KernelRule::ApplyKernelMatrix(data, transformedData, eigval,
-                                eigvec, newDimension, kernel);
+                                eigvec, newDimension, kernel,
+                                cacheDirectory);
 
   // Center the transformed data, if the user asked for it.
   if (centerTransformedData)
@@ -26,36 +26,29 @@ class NaiveKernelRule
      * @param eigvec KPCA eigenvectors will be written to this matrix.
      * @param rank Rank to be used for matrix approximation.
      * @param kernel Kernel to be used for computation.
+     * @param cacheDirectory Kernel matrix cache directory ("" disables
+     *      caching; see KernelMatrixCache).
      */
     static void ApplyKernelMatrix(const arma::mat& data,
                                   arma::mat& transformedData,
                                   arma::vec& eigval,
                                   arma::mat& eigvec,
                                   const size_t /* unused */,
-                                  KernelType kernel = KernelType())
+                                  KernelType kernel = KernelType(),
+                                  const std::string& cacheDirectory = "")
   {
-    // Construct the kernel matrix.
+    // Construct the kernel matrix.  The shared utility only computes the
+    // upper triangular part (the matrix is symmetric), blocks the
+    // evaluations for cache reuse and divides them among the threads.
     arma::mat kernelMatrix;
-    // Resize the kernel matrix to the right size.
-    kernelMatrix.set_size(data.n_cols, data.n_cols);
-
-    // Note that we only need to calculate the upper triangular part of the 
-    // kernel matrix, since it is symmetric. This helps minimize the number of
-    // kernel evaluations.
-    for (size_t i = 0; i < data.n_cols; ++i)
+    if (cacheDirectory != "")
     {
-      for (size_t j = i; j < data.n_cols; ++j)
-      {
-        // Evaluate the kernel on these two points.
-        kernelMatrix(i, j) = kernel.Evaluate(data.unsafe_col(i),
-                                             data.unsafe_col(j));
-      }
+      // Consult the disk-backed cache before computing.
+      kernel::KernelMatrixCache<KernelType> cache(cacheDirectory, kernel);
+      cache.Symmetric(data, kernelMatrix);
     }
-
-    // Copy to the lower triangular part of the matrix.
-    for (size_t i = 1; i < data.n_cols; ++i)
-      for (size_t j = 0; j < i; ++j)
-        kernelMatrix(i, j) = kernelMatrix(j, i);
+    else
+      kernel::ComputeKernelMatrix(data, kernelMatrix, kernel);
 
     // For PCA the data has to be centered, even if the data is centered. But it
     // is not guaranteed that the data, when mapped to the kernel space, is also
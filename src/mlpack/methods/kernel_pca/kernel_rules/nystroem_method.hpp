@@ -31,17 +31,21 @@ class NystroemKernelRule
      * @param eigvec KPCA eigenvectors will be written to this matrix.
      * @param rank Rank to be used for matrix approximation.
      * @param kernel Kernel to be used for computation.
+     * @param cacheDirectory Kernel matrix cache directory ("" disables
+     *      caching; see KernelMatrixCache).
      */
     static void ApplyKernelMatrix(const arma::mat& data,
                                   arma::mat& transformedData,
                                   arma::vec& eigval,
                                   arma::mat& eigvec,
                                   const size_t rank,
-                                  KernelType kernel = KernelType())
+                                  KernelType kernel = KernelType(),
+                                  const std::string& cacheDirectory = "")
     {
       arma::mat G, v;
       kernel::NystroemMethod<KernelType, PointSelectionPolicy> nm(data, kernel,
                                                         rank);
+      nm.CacheDirectory() = cacheDirectory;
       nm.Apply(G);
       transformedData = G.t() * G;
 
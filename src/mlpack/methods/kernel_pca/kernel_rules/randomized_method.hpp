@@ -0,0 +1,93 @@
+/**
+ * @file randomized_method.hpp
+ * @author Ryan Curtin
+ *
+ * Use a randomized decomposition to construct the transformation from the
+ * kernel matrix, computing only the requested number of components.
+ */
+
+#ifndef __MLPACK_METHODS_KERNEL_PCA_RANDOMIZED_METHOD_HPP
+#define __MLPACK_METHODS_KERNEL_PCA_RANDOMIZED_METHOD_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/naive_method.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * This rule builds the full kernel matrix, like NaiveKernelRule, but then
+ * only extracts the requested number of components with a randomized
+ * eigendecomposition (see math::RandomizedEigSym()) instead of a full
+ * eigendecomposition.  When only a few components of a large problem are
+ * kept, this turns the O(n^3) decomposition into roughly O(n^2 rank), at the
+ * cost of a small approximation error.
+ */
+template<typename KernelType>
+class RandomizedKernelRule
+{
+  public:
+    /**
+     * Construct the kernel matrix and decompose it with the randomized
+     * eigendecomposition, keeping only the requested number of components.
+     *
+     * @param data Input data points.
+     * @param transformedData Matrix to output results into.
+     * @param eigval KPCA eigenvalues will be written to this vector.
+     * @param eigvec KPCA eigenvectors will be written to this matrix.
+     * @param rank Number of components to compute.
+     * @param kernel Kernel to be used for computation.
+     * @param cacheDirectory Kernel matrix cache directory ("" disables
+     *      caching; see KernelMatrixCache).
+     */
+    static void ApplyKernelMatrix(const arma::mat& data,
+                                  arma::mat& transformedData,
+                                  arma::vec& eigval,
+                                  arma::mat& eigvec,
+                                  const size_t rank,
+                                  KernelType kernel = KernelType(),
+                                  const std::string& cacheDirectory = "")
+  {
+    // If all (or more) of the components are wanted anyway, the full
+    // decomposition is both faster and exact.
+    if (rank >= data.n_cols)
+    {
+      NaiveKernelRule<KernelType>::ApplyKernelMatrix(data, transformedData,
+          eigval, eigvec, rank, kernel, cacheDirectory);
+      return;
+    }
+
+    // Construct the kernel matrix.
+    arma::mat kernelMatrix;
+    if (cacheDirectory != "")
+    {
+      // Consult the disk-backed cache before computing.
+      kernel::KernelMatrixCache<KernelType> cache(cacheDirectory, kernel);
+      cache.Symmetric(data, kernelMatrix);
+    }
+    else
+      kernel::ComputeKernelMatrix(data, kernelMatrix, kernel);
+
+    // For PCA the data has to be centered, even if the data is centered. But
+    // it is not guaranteed that the data, when mapped to the kernel space, is
+    // also centered. Since we actually never work in the feature space we
+    // cannot center the data. So, we perform a "psuedo-centering" using the
+    // kernel matrix.
+    arma::rowvec rowMean = arma::sum(kernelMatrix, 0) / kernelMatrix.n_cols;
+    kernelMatrix.each_col() -= arma::sum(kernelMatrix, 1) / kernelMatrix.n_cols;
+    kernelMatrix.each_row() -= rowMean;
+    kernelMatrix += arma::sum(rowMean) / kernelMatrix.n_cols;
+
+    // Eigendecompose the centered kernel matrix; the randomized decomposition
+    // already returns the eigenvalues in descending order.
+    math::RandomizedEigSym(eigval, eigvec, kernelMatrix, rank);
+
+    transformedData = eigvec.t() * kernelMatrix;
+    transformedData.each_col() /= arma::sqrt(eigval);
+  }
+};
+
+}; // namespace kpca
+}; // namespace mlpack
+
+#endif
@@ -47,6 +47,18 @@ class DualTreeKMeans
   //! The tree built on the points.
   TreeType* tree;
 
+  //! The tree built on the centroids.  This is built on the first call to
+  //! Iterate() and reused afterwards; only the centroid positions and bounds
+  //! are refreshed between iterations, since the centroids move very little
+  //! once the algorithm is underway.
+  TreeType* centroidTree;
+  //! The centroid matrix the centroid tree is built on (in tree order, if the
+  //! tree rearranges its dataset).
+  arma::mat treeCentroids;
+  //! Mappings from tree order to the order of the centroid matrix given to
+  //! Iterate().
+  std::vector<size_t> oldFromNewCentroids;
+
   arma::vec clusterDistances;
   arma::Col<size_t> assignments;
   arma::vec distances;
@@ -57,6 +69,14 @@ class DualTreeKMeans
 
   //! Track distance calculations.
   size_t distanceCalculations;
+
+  /**
+   * Refresh the bounds and statistics of the given node (and its children)
+   * after the points of its dataset have been moved, without changing the
+   * structure of the tree.  The per-iteration statistic members are reset to
+   * the values a freshly built statistic would hold.
+   */
+  void UpdateTree(TreeType& node);
 };
 
 template<typename MetricType, typename MatType>
@@ -22,6 +22,7 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     dataset(tree::TreeTraits<TreeType>::RearrangesDataset ? datasetCopy :
         datasetOrig),
     metric(metric),
+    centroidTree(NULL),
     iteration(0),
     distanceCalculations(0)
 {
@@ -47,6 +48,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::~DualTreeKMeans()
 {
   if (tree)
     delete tree;
+  if (centroidTree)
+    delete centroidTree;
 }
 
 template<typename MetricType, typename MatType, typename TreeType>
@@ -63,16 +66,42 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     clusterDistances.fill(DBL_MAX / 2.0); // To prevent overflow.
   }
 
-  // Build a tree on the centroids.
-  std::vector<size_t> oldFromNewCentroids;
-  TreeType* centroidTree = BuildTree<TreeType>(
-      const_cast<typename TreeType::Mat&>(centroids), oldFromNewCentroids);
+  // Build a tree on the centroids on the first iteration.  On subsequent
+  // iterations, the structure of the tree is kept; the centroid positions are
+  // copied into the tree's dataset and the bounds and statistics refreshed,
+  // which is far cheaper than a rebuild and is valid because the centroids
+  // move very little between late iterations.
+  if (centroidTree == NULL)
+  {
+    Timer::Start("tree_building");
+    treeCentroids = centroids;
+    centroidTree = BuildTree<TreeType>(treeCentroids, oldFromNewCentroids);
+    Timer::Stop("tree_building");
+  }
+  else
+  {
+    // Move each point of the centroid tree's dataset to the new position of
+    // its centroid; the mappings from the original build still apply, since
+    // the structure of the tree does not change.
+    if (tree::TreeTraits<TreeType>::RearrangesDataset)
+    {
+      for (size_t i = 0; i < centroids.n_cols; ++i)
+        treeCentroids.col(i) = centroids.col(oldFromNewCentroids[i]);
+    }
+    else
+    {
+      treeCentroids = centroids;
+    }
 
-  // Now run the dual-tree algorithm.
+    UpdateTree(*centroidTree);
+  }
+
+  // Now run the dual-tree algorithm.  The rules expect the centroids in tree
+  // order, which is what treeCentroids holds.
   typedef DualTreeKMeansRules<MetricType, TreeType> RulesType;
-  RulesType rules(dataset, centroids, newCentroids, counts, oldFromNewCentroids,
-      iteration, clusterDistances, distances, assignments, distanceIteration,
-      metric);
+  RulesType rules(dataset, treeCentroids, newCentroids, counts,
+      oldFromNewCentroids, iteration, clusterDistances, distances, assignments,
+      distanceIteration, metric);
 
   // Use the dual-tree traverser.
 //typename TreeType::template DualTreeTraverser<RulesType> traverser(rules);
@@ -96,7 +125,7 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     {
       const size_t oldCluster = oldFromNewCentroids[c];
       newCentroids.col(oldCluster) /= counts(oldCluster);
-      const double dist = metric.Evaluate(centroids.col(c),
+      const double dist = metric.Evaluate(treeCentroids.col(c),
                                           newCentroids.col(oldCluster));
       if (dist > clusterDistances[centroids.n_cols])
         clusterDistances[centroids.n_cols] = dist;
@@ -106,12 +135,44 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   Log::Info << clusterDistances.t();
 
-  delete centroidTree;
-
   ++iteration;
   return std::sqrt(residual);
 }
 
+template<typename MetricType, typename MatType, typename TreeType>
+void DualTreeKMeans<MetricType, MatType, TreeType>::UpdateTree(TreeType& node)
+{
+  // Update the children first, so that their bounds and statistics are
+  // current when this node's are recalculated.
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    UpdateTree(node.Child(i));
+
+  // Refit the bound to the new positions of the points.
+  node.Bound().Clear();
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+    node.Bound() |= node.Dataset().col(node.Point(i));
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    node.Bound() |= node.Child(i).Bound();
+
+  // Reset the per-iteration statistics to the values a freshly built
+  // statistic would hold.
+  node.Stat().ClosestQueryNode() = NULL;
+  node.Stat().MinQueryNodeDistance() = DBL_MAX;
+  node.Stat().MaxQueryNodeDistance() = DBL_MAX;
+  node.Stat().ClustersPruned() = 0;
+  node.Stat().Iteration() = size_t() - 1;
+
+  // Recalculate the centroid of the node, the same way the statistic
+  // constructor does.
+  node.Stat().Centroid().zeros(node.Dataset().n_rows);
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+    node.Stat().Centroid() += node.Dataset().col(node.Point(i));
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    node.Stat().Centroid() += node.Child(i).NumDescendants() *
+        node.Child(i).Stat().Centroid();
+  node.Stat().Centroid() /= node.NumDescendants();
+}
+
 } // namespace kmeans
 } // namespace mlpack
 
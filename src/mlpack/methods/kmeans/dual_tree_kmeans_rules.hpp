@@ -28,6 +28,23 @@ class DualTreeKMeansRules
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case over a contiguous block of reference points (the points
+   * of a leaf node).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point in the block.
+   * @param referenceEnd Index one past the last reference point in the block.
+   */
+  void BaseCases(const size_t queryIndex,
+                 const size_t referenceBegin,
+                 const size_t referenceEnd)
+  {
+    for (size_t i = referenceBegin; i < referenceEnd; ++i)
+      BaseCase(queryIndex, i);
+  }
+
+
   double Score(const size_t queryIndex, TreeType& referenceNode);
 
   double Score(TreeType& queryNode, TreeType& referenceNode);
@@ -71,6 +88,16 @@ class DualTreeKMeansRules
   bool IsDescendantOf(const TreeType& potentialParent, const TreeType&
       potentialChild) const;
 
+  /**
+   * Update the pruned-cluster bookkeeping of the reference node after the
+   * given query node has been pruned against it, accumulating the reference
+   * node's points into the new centroids when every cluster has been pruned.
+   *
+   * @param queryNode Query node that was pruned.
+   * @param referenceNode Reference node it was pruned against.
+   */
+  void UpdatePrunedCounts(TreeType& queryNode, TreeType& referenceNode);
+
   /**
    * See if an Elkan-type prune can be performed.  If so, return DBL_MAX;
    * otherwise, return a score.  The Elkan-type prune can occur when the minimum
@@ -116,9 +116,43 @@ double DualTreeKMeansRules<MetricType, TreeType>::Score(
 
   traversalInfo.LastReferenceNode() = &referenceNode;
 
+  // Before paying for MinDistance(), see whether the bound inherited from the
+  // parent combination already decides the Pelleg-Moore prune.  Every point
+  // pair of this combination is a point pair of the parent combination, so
+  // the parent's minimum distance (stashed in LastScore()) is a valid lower
+  // bound on this combination's minimum distance.  The prune is decided by
+  // the inherited bound when neither of the statistic updates below could
+  // fire: the first cannot if the inherited bound is already at least the
+  // stored minimum query node distance, and the second is a cheap pointer
+  // walk.
+  if ((traversalInfo.LastQueryNode() != NULL) &&
+      ((traversalInfo.LastQueryNode() == queryNode.Parent()) ||
+       (traversalInfo.LastQueryNode() == &queryNode)) &&
+      (referenceNode.Stat().ClosestQueryNode() != NULL))
+  {
+    const double inheritedMin = traversalInfo.LastScore();
+    if ((inheritedMin >= referenceNode.Stat().MinQueryNodeDistance()) &&
+        (inheritedMin > referenceNode.Stat().MaxQueryNodeDistance()) &&
+        !IsDescendantOf(*((TreeType*) referenceNode.Stat().ClosestQueryNode()),
+            queryNode))
+    {
+      // The Pelleg-Moore prune holds for the inherited lower bound, so it
+      // holds for the true minimum distance too; take the prune bookkeeping
+      // path below without computing any distances.
+      UpdatePrunedCounts(queryNode, referenceNode);
+      return DBL_MAX;
+    }
+  }
+
   // Can we update the minimum query node distance for this reference node?
   const double minDistance = referenceNode.MinDistance(&queryNode);
   ++distanceCalculations;
+
+  // Stash this combination's bound for its children (only read if this
+  // combination is recursed into).
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastScore() = minDistance;
+
   if (minDistance < referenceNode.Stat().MinQueryNodeDistance())
   {
     referenceNode.Stat().ClosestQueryNode() = (void*) &queryNode;
@@ -145,36 +179,42 @@ double DualTreeKMeansRules<MetricType, TreeType>::Score(
     score = PellegMooreScore(queryNode, referenceNode, minDistance);
 
   if (score == DBL_MAX)
-  {
-    referenceNode.Stat().ClustersPruned() += queryNode.NumDescendants();
+    UpdatePrunedCounts(queryNode, referenceNode);
 
-    // Have we pruned everything?
-    if (referenceNode.Stat().ClustersPruned() == centroids.n_cols - 1)
-    {
-      // Then the best query node must contain just one point.
-      const TreeType* bestQueryNode = (TreeType*)
-          referenceNode.Stat().ClosestQueryNode();
-      const size_t cluster = mappings[bestQueryNode->Descendant(0)];
-
-      referenceNode.Stat().Owner() = cluster;
-      newCentroids.col(cluster) += referenceNode.NumDescendants() *
-          referenceNode.Stat().Centroid();
-      counts(cluster) += referenceNode.NumDescendants();
-      referenceNode.Stat().ClustersPruned()++;
-    }
-    else if (referenceNode.Stat().ClustersPruned() +
-        visited[referenceNode.Descendant(0)] == centroids.n_cols)
+  return score;
+}
+
+template<typename MetricType, typename TreeType>
+void DualTreeKMeansRules<MetricType, TreeType>::UpdatePrunedCounts(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  referenceNode.Stat().ClustersPruned() += queryNode.NumDescendants();
+
+  // Have we pruned everything?
+  if (referenceNode.Stat().ClustersPruned() == centroids.n_cols - 1)
+  {
+    // Then the best query node must contain just one point.
+    const TreeType* bestQueryNode = (TreeType*)
+        referenceNode.Stat().ClosestQueryNode();
+    const size_t cluster = mappings[bestQueryNode->Descendant(0)];
+
+    referenceNode.Stat().Owner() = cluster;
+    newCentroids.col(cluster) += referenceNode.NumDescendants() *
+        referenceNode.Stat().Centroid();
+    counts(cluster) += referenceNode.NumDescendants();
+    referenceNode.Stat().ClustersPruned()++;
+  }
+  else if (referenceNode.Stat().ClustersPruned() +
+      visited[referenceNode.Descendant(0)] == centroids.n_cols)
+  {
+    for (size_t i = 0; i < referenceNode.NumPoints(); ++i)
     {
-      for (size_t i = 0; i < referenceNode.NumPoints(); ++i)
-      {
-        const size_t cluster = assignments[referenceNode.Point(i)];
-        newCentroids.col(cluster) += dataset.col(referenceNode.Point(i));
-        counts(cluster)++;
-      }
+      const size_t cluster = assignments[referenceNode.Point(i)];
+      newCentroids.col(cluster) += dataset.col(referenceNode.Point(i));
+      counts(cluster)++;
     }
   }
-
-  return score;
 }
 
 template<typename MetricType, typename TreeType>
@@ -7,6 +7,8 @@
 #ifndef __MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 #define __MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 
+#include "hamerly_kmeans.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -19,6 +21,12 @@ class ElkanKMeans
    */
   ElkanKMeans(const MatType& dataset, MetricType& metric);
 
+  /**
+   * Destroy the ElkanKMeans object, deleting the Hamerly fallback object if
+   * one was created.
+   */
+  ~ElkanKMeans();
+
   /**
    * Run a single iteration of Elkan's algorithm, updating the given centroids
    * into the newCentroids matrix.
@@ -31,7 +39,19 @@ class ElkanKMeans
                  arma::mat& newCentroids,
                  arma::Col<size_t>& counts);
 
-  size_t DistanceCalculations() const { return distanceCalculations; }
+  size_t DistanceCalculations() const
+  {
+    return (hamerly != NULL) ? hamerly->DistanceCalculations()
+        : distanceCalculations;
+  }
+
+  //! Get the bound memory budget, in bytes (0 means no limit).
+  size_t MaxBoundMemory() const { return maxBoundMemory; }
+  //! Modify the bound memory budget, in bytes.  If the n x k lower bound
+  //! matrix would exceed this, iterations fall back to Hamerly's algorithm,
+  //! which keeps a single lower bound per point (still exact, but with fewer
+  //! pruning opportunities).
+  size_t& MaxBoundMemory() { return maxBoundMemory; }
 
  private:
   //! The dataset.
@@ -54,6 +74,12 @@ class ElkanKMeans
 
   //! Track distance calculations.
   size_t distanceCalculations;
+
+  //! Bound memory budget, in bytes (0 means no limit).
+  size_t maxBoundMemory;
+  //! Hamerly fallback, created when the lower bound matrix would exceed the
+  //! memory budget (NULL otherwise).
+  HamerlyKMeans<MetricType, MatType>* hamerly;
 };
 
 } // namespace kmeans
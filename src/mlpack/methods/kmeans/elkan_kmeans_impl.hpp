@@ -18,17 +18,43 @@ ElkanKMeans<MetricType, MatType>::ElkanKMeans(const MatType& dataset,
                                               MetricType& metric) :
     dataset(dataset),
     metric(metric),
-    distanceCalculations(0)
+    distanceCalculations(0),
+    maxBoundMemory(0),
+    hamerly(NULL)
 {
 
 }
 
+template<typename MetricType, typename MatType>
+ElkanKMeans<MetricType, MatType>::~ElkanKMeans()
+{
+  if (hamerly != NULL)
+    delete hamerly;
+}
+
 // Run a single iteration of Elkan's algorithm for Lloyd iterations.
 template<typename MetricType, typename MatType>
 double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                                  arma::mat& newCentroids,
                                                  arma::Col<size_t>& counts)
 {
+  // If the full n x k lower bound matrix does not fit into the memory budget,
+  // fall back to Hamerly's algorithm, which keeps a single lower bound per
+  // point (still exact, but with fewer pruning opportunities).
+  if ((maxBoundMemory > 0) &&
+      (dataset.n_cols * centroids.n_cols * sizeof(double) > maxBoundMemory))
+  {
+    if (hamerly == NULL)
+    {
+      Log::Warn << "ElkanKMeans: the lower bound matrix (" << dataset.n_cols
+          << " x " << centroids.n_cols << ") exceeds the bound memory budget; "
+          << "falling back to Hamerly's single-bound algorithm." << std::endl;
+      hamerly = new HamerlyKMeans<MetricType, MatType>(dataset, metric);
+    }
+
+    return hamerly->Iterate(centroids, newCentroids, counts);
+  }
+
   // Clear new centroids.
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
@@ -41,9 +67,6 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
@@ -51,101 +74,145 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     assignments.set_size(dataset.n_cols);
     upperBounds.set_size(dataset.n_cols);
 
-    lowerBounds.fill(0);
-    upperBounds.fill(DBL_MAX);
+    // Initialize the bounds with a parallel first touch, so on NUMA systems
+    // their pages are spread across the memory nodes in the same static
+    // decomposition the parallel loops below use.
+    util::FirstTouchFill(lowerBounds, 0.0);
+    util::FirstTouchFill(upperBounds, DBL_MAX);
     assignments.fill(0);
   }
 
   // Step 1: for all centers, compute between-cluster distances.  For all
-  // centers, compute s(c) = 1/2 min d(c, c').
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  // centers, compute s(c) = 1/2 min d(c, c').  The rows are divided among the
+  // threads; each pair is written to both halves of the matrix by the
+  // iteration that computes it, so the writes do not collide.  The loop index
+  // is signed for OpenMP, and the schedule is dynamic because later rows
+  // contain fewer pairs.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long i = 0; i < (long) centroids.n_cols; i++)
   {
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double distance = metric.Evaluate(centroids.col(i),
                                               centroids.col(j));
-      distanceCalculations++;
       clusterDistances(i, j) = distance;
       clusterDistances(j, i) = distance;
     }
   }
+  distanceCalculations += (centroids.n_cols * (centroids.n_cols - 1)) / 2;
 
   // Now find the closest cluster to each other cluster.  We multiply by 0.5 so
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  The
+  // points are divided among the threads, each of which accumulates into its
+  // own copies of the centroid sums and counts; these are combined at the
+  // end.  All the per-point state (bounds, assignment) is only touched by the
+  // thread that owns the point.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
-    {
-      for (size_t c = 0; c < centroids.n_cols; ++c)
-      {
-        // Step 3: for all remaining points x and centers c such that c != c(x),
-        // u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
-        if (assignments[i] == c)
-          continue; // Pruned because this cluster is already the assignment.
+    arma::mat threadCentroids(centroids.n_rows, centroids.n_cols);
+    threadCentroids.zeros();
+    arma::Col<size_t> threadCounts(centroids.n_cols);
+    threadCounts.zeros();
+    size_t threadDistanceCalculations = 0;
 
-        if (upperBounds(i) <= lowerBounds(c, i))
-          continue; // Pruned by triangle inequality on lower bound.
-
-        if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
-          continue; // Pruned by triangle inequality on cluster distances.
+    // The loop index is signed for OpenMP; the schedule is dynamic because
+    // the amount of work per point varies wildly with how much gets pruned.
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 64)
+#endif
+    for (long i = 0; i < (long) dataset.n_cols; i++)
+    {
+      // Initially set r(x) to true.
+      bool mustRecalculate = true;
 
-        // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
-        // Otherwise, d(x, c(x)) = u(x).
-        double dist;
-        if (mustRecalculate[i])
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
+      {
+        // No change needed.  This point must still belong to that cluster.
+        threadCounts(assignments[i])++;
+        threadCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+        continue;
+      }
+      else
+      {
+        for (size_t c = 0; c < centroids.n_cols; ++c)
         {
-          mustRecalculate[i] = false;
-          dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
-          lowerBounds(assignments[i], i) = dist;
-          upperBounds(i) = dist;
-          distanceCalculations++;
+          // Step 3: for all remaining points x and centers c such that
+          // c != c(x), u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
+          if (assignments[i] == c)
+            continue; // Pruned because this cluster is already the assignment.
 
-          // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
             continue; // Pruned by triangle inequality on lower bound.
 
           if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
             continue; // Pruned by triangle inequality on cluster distances.
-        }
-        else
-        {
-          dist = upperBounds(i); // This is equivalent to d(x, c(x)).
-        }
 
-        // Step 3b: if d(x, c(x)) > l(x, c) or d(x, c(x)) > 0.5 d(c(x), c)...
-        if (dist > lowerBounds(c, i) ||
-            dist > 0.5 * clusterDistances(assignments[i], c))
-        {
-          // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
-          const double pointDist = metric.Evaluate(dataset.col(i),
-                                                   centroids.col(c));
-          lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
-          if (pointDist < dist)
+          // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
+          // Otherwise, d(x, c(x)) = u(x).
+          double dist;
+          if (mustRecalculate)
+          {
+            mustRecalculate = false;
+            dist = metric.Evaluate(dataset.col(i),
+                                   centroids.col(assignments[i]));
+            lowerBounds(assignments[i], i) = dist;
+            upperBounds(i) = dist;
+            threadDistanceCalculations++;
+
+            // Check if we can prune again.
+            if (upperBounds(i) <= lowerBounds(c, i))
+              continue; // Pruned by triangle inequality on lower bound.
+
+            if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
+              continue; // Pruned by triangle inequality on cluster distances.
+          }
+          else
+          {
+            dist = upperBounds(i); // This is equivalent to d(x, c(x)).
+          }
+
+          // Step 3b: if d(x, c(x)) > l(x, c) or d(x, c(x)) > 0.5 d(c(x), c)...
+          if (dist > lowerBounds(c, i) ||
+              dist > 0.5 * clusterDistances(assignments[i], c))
           {
-            upperBounds(i) = pointDist;
-            assignments[i] = c;
+            // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
+            const double pointDist = metric.Evaluate(dataset.col(i),
+                                                     centroids.col(c));
+            lowerBounds(c, i) = pointDist;
+            threadDistanceCalculations++;
+            if (pointDist < dist)
+            {
+              upperBounds(i) = pointDist;
+              assignments[i] = c;
+            }
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points assigned
+      // to c.
+      threadCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      threadCounts[assignments[i]]++;
     }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    // Combine the per-thread accumulators.
+#ifdef _OPENMP
+    #pragma omp critical (elkanKMeansAccumulate)
+#endif
+    {
+      newCentroids += threadCentroids;
+      counts += threadCounts;
+      distanceCalculations += threadDistanceCalculations;
+    }
   }
 
   // Now, normalize and calculate the distance each cluster has moved.
@@ -163,13 +230,18 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Steps 5 and 6 stream through the bound matrix exactly once.  Each point's
+  // lower bounds are one contiguous column, so the writes are sequential; the
+  // points are divided among the threads.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long i = 0; i < (long) dataset.n_cols; i++)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
     // But it doesn't actually matter if l(x, c) is positive.
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-      lowerBounds(c, i) -= moveDistances(c);
+    lowerBounds.col(i) -= moveDistances;
 
     // Step 6: for each point x, assign
     //   u(x) = u(x) + d(m(c(x)), c(x))
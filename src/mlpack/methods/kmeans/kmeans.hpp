@@ -10,9 +10,11 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include "random_partition.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "kmeans_telemetry.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -50,8 +52,9 @@ namespace kmeans /** K-Means clustering. */ {
  *     default constructor and 'void Cluster(const arma::mat&, const size_t,
  *     arma::Col<size_t>&)'.
  * @tparam EmptyClusterPolicy Policy for what to do on an empty cluster; must
- *     implement a default constructor and 'void EmptyCluster(const arma::mat&,
- *     arma::Col<size_t&)'.
+ *     implement a default constructor and 'size_t EmptyCluster(const MatType&,
+ *     const size_t, arma::mat&, arma::Col<size_t>&, MetricType&, const
+ *     size_t)'.
  * @tparam LloydStepType Implementation of single Lloyd step to use.
  *
  * @see RandomPartition, RefinedStart, AllowEmptyClusters,
@@ -168,10 +171,50 @@ class KMeans
   //! Modify the empty cluster policy.
   EmptyClusterPolicy& EmptyClusterAction() { return emptyClusterAction; }
 
+  //! Get the point weights (an empty vector means every point has weight 1).
+  const arma::vec& Weights() const { return weights; }
+  //! Modify the point weights.  If set, one weight per point is required,
+  //! and the Lloyd step type must support weighted points (as NaiveKMeans
+  //! does); weighted coresets (see math::Coreset()) are the typical source.
+  arma::vec& Weights() { return weights; }
+
+  //! Get the telemetry callback (NULL if none is attached).
+  const KMeansTelemetryCallback* Telemetry() const { return telemetry; }
+  //! Set the telemetry callback, which is called after every Lloyd iteration
+  //! (see KMeansTelemetryCallback); set to NULL to detach.  The caller keeps
+  //! ownership of the callback.
+  KMeansTelemetryCallback*& Telemetry() { return telemetry; }
+
   // Returns a string representation of this object.
   std::string ToString() const;
 
  private:
+  HAS_MEM_FUNC(Weights, HasWeights)
+
+  //! Hand the point weights to a Lloyd step type that supports them (one
+  //! with a Weights() modifier, such as NaiveKMeans).
+  template<typename LloydType>
+  void PassWeights(LloydType& lloydStep,
+      typename boost::enable_if<
+          HasWeights<LloydType, arma::vec&(LloydType::*)()>
+      >::type* = 0) const
+  {
+    if (weights.n_elem > 0)
+      lloydStep.Weights() = weights;
+  }
+
+  //! With any other Lloyd step type, giving weights is an error.
+  template<typename LloydType>
+  void PassWeights(LloydType& /* lloydStep */,
+      typename boost::disable_if<
+          HasWeights<LloydType, arma::vec&(LloydType::*)()>
+      >::type* = 0) const
+  {
+    if (weights.n_elem > 0)
+      Log::Fatal << "KMeans::Cluster(): point weights were given, but this "
+          << "Lloyd step type does not support weighted points!" << std::endl;
+  }
+
   //! Maximum number of iterations before giving up.
   size_t maxIterations;
   //! Instantiated distance metric.
@@ -180,6 +223,11 @@ class KMeans
   InitialPartitionPolicy partitioner;
   //! Instantiated empty cluster policy.
   EmptyClusterPolicy emptyClusterAction;
+  //! Weight of each point (empty means unweighted).
+  arma::vec weights;
+  //! Telemetry callback called after every Lloyd iteration (not owned; NULL
+  //! if none is attached).
+  KMeansTelemetryCallback* telemetry;
 };
 
 }; // namespace kmeans
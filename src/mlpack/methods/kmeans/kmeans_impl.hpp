@@ -34,7 +34,8 @@ KMeans(const size_t maxIterations,
     maxIterations(maxIterations),
     metric(metric),
     partitioner(partitioner),
-    emptyClusterAction(emptyClusterAction)
+    emptyClusterAction(emptyClusterAction),
+    telemetry(NULL)
 {
   // Nothing to do.
 }
@@ -141,8 +142,22 @@ Cluster(const MatType& data,
   arma::mat centroidsOther;
   double cNorm;
 
+  // Hand any point weights to the Lloyd step (this fails for Lloyd step
+  // types without weighted-point support).
+  if (weights.n_elem > 0 && weights.n_elem != data.n_cols)
+    Log::Fatal << "KMeans::Cluster(): one weight per point is required ("
+        << weights.n_elem << " given, " << data.n_cols << " points)!"
+        << std::endl;
+  PassWeights(lloydStep);
+
+  // Only used when a telemetry callback is attached.
+  arma::wall_clock lloydStepClock;
+
   do
   {
+    if (telemetry != NULL)
+      lloydStepClock.tic();
+
     // We have two centroid matrices.  We don't want to copy anything, so,
     // depending on the iteration number, we use a different centroid matrix...
     if (iteration % 2 == 0)
@@ -150,18 +165,24 @@ Cluster(const MatType& data,
     else
       cNorm = lloydStep.Iterate(centroidsOther, centroids, counts);
 
+    const double lloydStepTime = (telemetry != NULL) ? lloydStepClock.toc()
+        : 0.0;
+
     // If we are not allowing empty clusters, then check that all of our
     // clusters have points.
+    size_t emptyClustersRepaired = 0;
     for (size_t i = 0; i < clusters; i++)
     {
       if (counts[i] == 0)
       {
         Log::Info << "Cluster " << i << " is empty.\n";
+        emptyClustersRepaired++;
         if (iteration % 2 == 0)
           emptyClusterAction.EmptyCluster(data, i, centroidsOther, counts,
-              metric);
+              metric, iteration);
         else
-          emptyClusterAction.EmptyCluster(data, i, centroids, counts, metric);
+          emptyClusterAction.EmptyCluster(data, i, centroids, counts, metric,
+              iteration);
       }
     }
 
@@ -169,6 +190,46 @@ Cluster(const MatType& data,
     Log::Info << "KMeans::Cluster(): iteration " << iteration << ", residual "
         << cNorm << ".\n";
 
+    // Report this iteration to the telemetry callback, if one is attached;
+    // the callback may request an early stop.
+    if (telemetry != NULL)
+    {
+      // The newly computed centroids are in the matrix the step just wrote.
+      const arma::mat& newCentroids = ((iteration - 1) % 2 == 0) ?
+          centroidsOther : centroids;
+
+      // Assemble the objective with one pass over the data.  This is only
+      // done when telemetry is wanted; runs without a callback pay nothing.
+      double wcss = 0.0;
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        double minDistance = std::numeric_limits<double>::infinity();
+        for (size_t j = 0; j < newCentroids.n_cols; ++j)
+        {
+          const double distance = metric.Evaluate(data.col(i),
+              newCentroids.col(j));
+          if (distance < minDistance)
+            minDistance = distance;
+        }
+        wcss += minDistance * minDistance;
+      }
+
+      KMeansIterationTelemetry info;
+      info.iteration = iteration;
+      info.centroidMovement = cNorm;
+      info.withinClusterSumOfSquares = wcss;
+      info.emptyClustersRepaired = emptyClustersRepaired;
+      info.lloydStepTime = lloydStepTime;
+      info.distanceCalculations = lloydStep.DistanceCalculations();
+
+      if (!telemetry->Iteration(info))
+      {
+        Log::Info << "KMeans::Cluster(): stopped by telemetry callback after "
+            << iteration << " iterations." << std::endl;
+        break;
+      }
+    }
+
   } while (cNorm > 1e-5 && iteration != maxIterations);
 
   // If we ended on an even iteration, then the centroids are in the
@@ -0,0 +1,69 @@
+/**
+ * @file kmeans_plus_plus.hpp
+ * @author Ryan Curtin
+ *
+ * An implementation of the k-means++ seeding strategy of Arthur and
+ * Vassilvitskii, as an initial partitioning policy for use with the KMeans
+ * class.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_HPP
+#define __MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means++ strategy for choosing initial points for k-means clustering.
+ * The first center is chosen uniformly at random from the dataset, and each
+ * subsequent center is chosen with probability proportional to the squared
+ * distance between the point and the closest already-chosen center (D^2
+ * sampling).  This spreads the initial centers out over the dataset, which
+ * generally reduces the number of Lloyd iterations needed for convergence
+ * considerably compared to random partitioning, and bounds the expected
+ * distortion of the result.  It is an implementation of the following paper:
+ *
+ * @inproceedings{arthur2007kmeans,
+ *   title={k-means++: the advantages of careful seeding},
+ *   author={Arthur, David and Vassilvitskii, Sergei},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA 2007)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ *
+ * The distances to each candidate center are computed for all points at once
+ * with a single matrix-vector product, using the expansion of the squared
+ * Euclidean distance.
+ */
+class KMeansPlusPlus
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy policy.
+  KMeansPlusPlus() { }
+
+  /**
+   * Partition the given dataset into the given number of clusters using the
+   * k-means++ seeding strategy.  Each point is assigned to the closest of the
+   * chosen centers.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset to partition.
+   * @param clusters Number of clusters to split dataset into.
+   * @param assignments Vector to store cluster assignments into.  Values will
+   *     be between 0 and (clusters - 1).
+   */
+  template<typename MatType>
+  static void Cluster(const MatType& data,
+                      const size_t clusters,
+                      arma::Col<size_t>& assignments);
+};
+
+}; // namespace kmeans
+}; // namespace mlpack
+
+// Include implementation.
+#include "kmeans_plus_plus_impl.hpp"
+
+#endif
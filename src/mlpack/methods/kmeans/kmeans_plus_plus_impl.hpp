@@ -0,0 +1,91 @@
+/**
+ * @file kmeans_plus_plus_impl.hpp
+ * @author Ryan Curtin
+ *
+ * An implementation of the k-means++ seeding strategy of Arthur and
+ * Vassilvitskii, as an initial partitioning policy for use with the KMeans
+ * class.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_IMPL_HPP
+#define __MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_plus_plus.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansPlusPlus::Cluster(const MatType& data,
+                             const size_t clusters,
+                             arma::Col<size_t>& assignments)
+{
+  // Cache the squared norm of every point; with these, the squared distance
+  // to a center c is ||x||^2 - 2 x^T c + ||c||^2, so the distances from all
+  // points to a candidate center reduce to one matrix-vector product.
+  arma::vec pointNorms(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; i++)
+    pointNorms[i] = arma::dot(data.col(i), data.col(i));
+
+  // The squared distance from each point to its closest chosen center.
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(std::numeric_limits<double>::max());
+
+  assignments.zeros(data.n_cols);
+
+  // The first center is chosen uniformly at random.
+  size_t center = (size_t) math::RandInt(data.n_cols);
+  for (size_t c = 0; c < clusters; c++)
+  {
+    // Update the minimum distances and assignments with the new center.
+    const arma::vec centerVec(data.col(center));
+    const double centerNorm = arma::dot(centerVec, centerVec);
+    const arma::vec dots = arma::trans(arma::trans(centerVec) * data);
+
+    for (size_t i = 0; i < data.n_cols; i++)
+    {
+      // Guard against slightly negative values caused by roundoff error.
+      const double distance = std::max(0.0,
+          pointNorms[i] - 2.0 * dots[i] + centerNorm);
+
+      if (distance < minDistances[i])
+      {
+        minDistances[i] = distance;
+        assignments[i] = c;
+      }
+    }
+
+    // No more centers need to be chosen after the last one.
+    if (c == clusters - 1)
+      break;
+
+    // Sample the next center with probability proportional to the squared
+    // distance to the closest chosen center (D^2 sampling).
+    const double totalDistance = arma::accu(minDistances);
+    if (totalDistance > 0.0)
+    {
+      double target = math::Random() * totalDistance;
+      center = data.n_cols - 1; // In case of roundoff error.
+      for (size_t i = 0; i < data.n_cols; i++)
+      {
+        target -= minDistances[i];
+        if (target <= 0.0)
+        {
+          center = i;
+          break;
+        }
+      }
+    }
+    else
+    {
+      // Every point coincides with an already-chosen center, so D^2 sampling
+      // is degenerate; fall back to a uniformly random choice.
+      center = (size_t) math::RandInt(data.n_cols);
+    }
+  }
+}
+
+}; // namespace kmeans
+}; // namespace mlpack
+
+#endif
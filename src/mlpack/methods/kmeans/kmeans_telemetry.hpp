@@ -0,0 +1,70 @@
+/**
+ * @file kmeans_telemetry.hpp
+ * @author Ryan Curtin
+ *
+ * Optional per-iteration telemetry interface for KMeans::Cluster(), so that
+ * callers can watch convergence and stop or re-seed a run programmatically
+ * instead of waiting for the iteration limit.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_KMEANS_TELEMETRY_HPP
+#define __MLPACK_METHODS_KMEANS_KMEANS_TELEMETRY_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The measurements reported to a KMeansTelemetryCallback after each Lloyd
+ * iteration of KMeans::Cluster().
+ */
+struct KMeansIterationTelemetry
+{
+  //! The iteration that just completed (starting from 1).
+  size_t iteration;
+  //! Movement of the centroids in this iteration (the residual the
+  //! convergence check uses).
+  double centroidMovement;
+  //! Sum over all points of the squared metric distance to the closest
+  //! centroid.  For the default Euclidean metric this is the usual
+  //! within-cluster sum of squares objective.
+  double withinClusterSumOfSquares;
+  //! Number of empty clusters that were repaired this iteration.
+  size_t emptyClustersRepaired;
+  //! Wall-clock time of the Lloyd step for this iteration, in seconds.
+  double lloydStepTime;
+  //! Total number of distance calculations performed by the Lloyd steps so
+  //! far.
+  size_t distanceCalculations;
+};
+
+/**
+ * Interface for receiving per-iteration telemetry from KMeans::Cluster().
+ * Attach an implementation with KMeans::Telemetry(); by default no callback
+ * is attached and no telemetry is gathered.
+ *
+ * The within-cluster sum of squares is assembled by the driver loop with one
+ * pass over the data, but only when a callback is attached, so runs without
+ * telemetry pay nothing.
+ */
+class KMeansTelemetryCallback
+{
+ public:
+  virtual ~KMeansTelemetryCallback() { }
+
+  /**
+   * Called after every Lloyd iteration with the measurements of that
+   * iteration.  Return false to stop the clustering early; the centroids
+   * (and assignments, if requested) are then produced from the current
+   * state, exactly as if the convergence tolerance had been reached.
+   *
+   * @param telemetry Measurements of the iteration that just completed.
+   * @return True to continue iterating, false to stop early.
+   */
+  virtual bool Iteration(const KMeansIterationTelemetry& telemetry) = 0;
+};
+
+}; // namespace kmeans
+}; // namespace mlpack
+
+#endif // __MLPACK_METHODS_KMEANS_KMEANS_TELEMETRY_HPP
@@ -17,12 +17,19 @@ namespace kmeans {
 /**
  * When an empty cluster is detected, this class takes the point furthest from
  * the centroid of the cluster with maximum variance as a new cluster.
+ *
+ * The per-cluster variance sufficient statistics (and the assignment and
+ * distance of each point) are cached: they are computed from scratch at most
+ * once per iteration, and any further empty clusters in the same iteration are
+ * repaired using incremental updates of the cached statistics, which is far
+ * cheaper than a pass over the dataset.  This makes the policy stateful, so a
+ * single object should be used for the duration of a clustering.
  */
 class MaxVarianceNewCluster
 {
  public:
   //! Default constructor required by EmptyClusterPolicy.
-  MaxVarianceNewCluster() { }
+  MaxVarianceNewCluster() : iteration(size_t(-1)) { }
 
   /**
    * Take the point furthest from the centroid of the cluster with maximum
@@ -33,16 +40,38 @@ class MaxVarianceNewCluster
    * @param emptyCluster Index of cluster which is empty.
    * @param centroids Centroids of each cluster (one per column).
    * @param clusterCounts Number of points in each cluster.
-   * @param assignments Cluster assignments of each point.
+   * @param metric The metric to use.
+   * @param iteration Number of iteration.
    *
    * @return Number of points changed.
    */
   template<typename MetricType, typename MatType>
-  static size_t EmptyCluster(const MatType& data,
-                             const size_t emptyCluster,
-                             arma::mat& centroids,
-                             arma::Col<size_t>& clusterCounts,
-                             MetricType& metric);
+  size_t EmptyCluster(const MatType& data,
+                      const size_t emptyCluster,
+                      arma::mat& centroids,
+                      arma::Col<size_t>& clusterCounts,
+                      MetricType& metric,
+                      const size_t iteration);
+
+ private:
+  //! Index of the iteration for which the cached statistics are valid.
+  size_t iteration;
+  //! Cached sum of point-to-centroid distances for each cluster.
+  arma::vec sumDistances;
+  //! Cached cluster assignments of each point.
+  arma::Col<size_t> assignments;
+  //! Cached distance of each point to its assigned centroid.
+  arma::vec distances;
+
+  /**
+   * Recompute the cached sufficient statistics from scratch with a single pass
+   * over the dataset.
+   */
+  template<typename MetricType, typename MatType>
+  void Precalculate(const MatType& data,
+                    const arma::mat& centroids,
+                    arma::Col<size_t>& clusterCounts,
+                    MetricType& metric);
 };
 
 }; // namespace kmeans
@@ -21,65 +21,39 @@ size_t MaxVarianceNewCluster::EmptyCluster(const MatType& data,
                                            const size_t emptyCluster,
                                            arma::mat& centroids,
                                            arma::Col<size_t>& clusterCounts,
-                                           MetricType& metric)
+                                           MetricType& metric,
+                                           const size_t iteration)
 {
-  // First, we need to find the cluster with maximum variance (by which I mean
-  // the sum of the covariance matrices).
-  arma::vec variances;
-  variances.zeros(clusterCounts.n_elem); // Start with 0.
-  arma::Col<size_t> assignments(data.n_cols);
-
-  // Add the variance of each point's distance away from the cluster.  I think
-  // this is the sensible thing to do.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Find the closest centroid to this point.
-    double minDistance = std::numeric_limits<double>::infinity();
-    size_t closestCluster = centroids.n_cols; // Invalid value.
-
-    for (size_t j = 0; j < centroids.n_cols; j++)
-    {
-      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
-
-      if (distance < minDistance)
-      {
-        minDistance = distance;
-        closestCluster = j;
-      }
-    }
-
-    assignments[i] = closestCluster;
-    variances[closestCluster] += metric.Evaluate(data.col(i),
-        centroids.col(closestCluster));
-  }
-
-  // Divide by the number of points in the cluster to produce the variance.
-  // Although a -nan will occur here for the empty cluster(s), this doesn't
-  // matter because variances.max() won't pick it up.  If the number of points
-  // in the cluster is 1, we ensure that cluster is not selected by forcing the
-  // variance to 0.
+  // The Lloyd step invalidates the cached statistics, so refresh them the
+  // first time an empty cluster appears in an iteration.  Any further empty
+  // clusters in the same iteration reuse the cache.
+  if (iteration != this->iteration ||
+      sumDistances.n_elem != clusterCounts.n_elem)
+    Precalculate(data, centroids, clusterCounts, metric);
+  this->iteration = iteration;
+
+  // Now find the cluster with maximum variance.  Although a -nan will occur
+  // here for the empty cluster(s), this doesn't matter because max() won't
+  // pick it up.  If the number of points in the cluster is 1, we ensure that
+  // cluster is not selected by forcing the variance to 0.
+  arma::vec variances(clusterCounts.n_elem);
   for (size_t i = 0; i < clusterCounts.n_elem; ++i)
-    variances[i] /= (clusterCounts[i] == 1) ? DBL_MAX : clusterCounts[i];
+    variances[i] = sumDistances[i] /
+        ((clusterCounts[i] == 1) ? DBL_MAX : clusterCounts[i]);
 
-  // Now find the cluster with maximum variance.
   arma::uword maxVarCluster;
   variances.max(maxVarCluster);
 
-  // Now, inside this cluster, find the point which is furthest away.
+  // Now, inside this cluster, find the point which is furthest away, using the
+  // cached per-point distances.
   size_t furthestPoint = data.n_cols;
   double maxDistance = -DBL_MAX;
   for (size_t i = 0; i < data.n_cols; ++i)
   {
-    if (assignments[i] == maxVarCluster)
+    if (assignments[i] == maxVarCluster && distances[i] > maxDistance)
     {
-      const double distance = metric.Evaluate(data.col(i),
-          centroids.col(maxVarCluster));
-
-      if (distance > maxDistance)
-      {
-        maxDistance = distance;
-        furthestPoint = i;
-      }
+      maxDistance = distances[i];
+      furthestPoint = i;
     }
   }
 
@@ -93,6 +67,14 @@ size_t MaxVarianceNewCluster::EmptyCluster(const MatType& data,
   centroids.col(emptyCluster) = arma::vec(data.col(furthestPoint));
   assignments[furthestPoint] = emptyCluster;
 
+  // Maintain the sufficient statistics: the moved point no longer contributes
+  // to its old cluster, and it sits exactly on the centroid of its new one.
+  // The slight drift of the donor centroid is not accounted for; the next
+  // Lloyd step refreshes the statistics anyway.
+  sumDistances[maxVarCluster] -= maxDistance;
+  sumDistances[emptyCluster] = 0.0;
+  distances[furthestPoint] = 0.0;
+
   // Output some debugging information.
   Log::Debug << "Point " << furthestPoint << " assigned to empty cluster " <<
       emptyCluster << ".\n";
@@ -100,6 +82,41 @@ size_t MaxVarianceNewCluster::EmptyCluster(const MatType& data,
   return 1; // We only changed one point.
 }
 
+template<typename MetricType, typename MatType>
+void MaxVarianceNewCluster::Precalculate(const MatType& data,
+                                         const arma::mat& centroids,
+                                         arma::Col<size_t>& clusterCounts,
+                                         MetricType& metric)
+{
+  sumDistances.zeros(clusterCounts.n_elem);
+  assignments.set_size(data.n_cols);
+  distances.set_size(data.n_cols);
+
+  // Add the distance of each point away from its cluster.  I think this is the
+  // sensible thing to do.
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    assignments[i] = closestCluster;
+    distances[i] = minDistance;
+    sumDistances[closestCluster] += minDistance;
+  }
+}
+
 }; // namespace kmeans
 }; // namespace mlpack
 
@@ -0,0 +1,105 @@
+/**
+ * @file minibatch_kmeans.hpp
+ * @author Ryan Curtin
+ *
+ * An implementation of mini-batch k-means, which updates the centroids using
+ * only a random sample of the dataset at each iteration.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_HPP
+#define __MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_HPP
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This is an implementation of a single iteration of the mini-batch k-means
+ * algorithm of Sculley.  Instead of assigning every point in the dataset at
+ * each iteration, a random batch of points is sampled, and each sampled point
+ * moves its closest centroid towards it with a per-centroid learning rate
+ * that decays as more points are assigned to that centroid.  This makes each
+ * iteration independent of the dataset size, which can be orders of magnitude
+ * faster than full-batch Lloyd iterations on large datasets, generally at a
+ * small cost in cluster quality.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title = {Web-scale k-means clustering},
+ *   author = {Sculley, D.},
+ *   booktitle = {Proceedings of the 19th International Conference on the
+ *       World Wide Web (WWW '10)},
+ *   pages = {1177--1178},
+ *   year = {2010}
+ * }
+ * @endcode
+ *
+ * Because the KMeans class constructs its Lloyd step with only the dataset and
+ * the metric, the batch size is set to a default in the constructor (1000, or
+ * the size of the dataset if it is smaller); it can be modified through the
+ * BatchSize() accessor if this class is used directly.
+ *
+ * Note that because only a sample of the dataset is seen at each iteration, a
+ * cluster may go several iterations without being the closest cluster to any
+ * sampled point.  Therefore the counts reported to KMeans are the cumulative
+ * number of points that have been assigned to each cluster across all
+ * iterations, so that the empty cluster policy only fires for clusters that
+ * have never claimed a point.
+ *
+ * @param MetricType Type of metric used with this implementation.
+ * @param MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  MiniBatchKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of mini-batch k-means, updating the given
+   * centroids into the newCentroids matrix using a random batch of points.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Cumulative number of points assigned to each cluster.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of points sampled at each iteration.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled at each iteration.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! Number of points sampled at each iteration.
+  size_t batchSize;
+  //! Cumulative number of points assigned to each cluster; this determines
+  //! the per-cluster learning rate.
+  arma::Col<size_t> centroidCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "minibatch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file minibatch_kmeans_impl.hpp
+ * @author Ryan Curtin
+ *
+ * An implementation of mini-batch k-means, which updates the centroids using
+ * only a random sample of the dataset at each iteration.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_IMPL_HPP
+#define __MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "minibatch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(std::min((size_t) 1000, (size_t) dataset.n_cols)),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // On the first iteration, initialize the cumulative per-cluster counts.
+  if (centroidCounts.n_elem != centroids.n_cols)
+    centroidCounts.zeros(centroids.n_cols);
+
+  // Centroids that are not moved by this batch keep their old positions.
+  newCentroids = centroids;
+
+  // Sample the batch and cache the closest centroid to each sampled point.
+  // The assignments are computed against the centroids as they were at the
+  // start of the iteration, before any of them are moved.
+  arma::Col<size_t> batchPoints(batchSize);
+  arma::Col<size_t> assignments(batchSize);
+  for (size_t i = 0; i < batchSize; i++)
+  {
+    const size_t point = (size_t) math::RandInt(dataset.n_cols);
+    batchPoints[i] = point;
+
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(dataset.col(point),
+          centroids.col(j));
+      distanceCalculations++;
+
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+
+  // Now apply the updates.  Each point moves its centroid towards it with a
+  // learning rate of (1 / n_c), where n_c is the total number of points that
+  // have ever been assigned to that centroid; so, the step sizes shrink as
+  // the centroids accumulate points.
+  for (size_t i = 0; i < batchSize; i++)
+  {
+    const size_t cluster = assignments[i];
+    centroidCounts(cluster)++;
+
+    const double eta = 1.0 / centroidCounts(cluster);
+    newCentroids.col(cluster) = (1.0 - eta) * newCentroids.col(cluster) +
+        eta * arma::vec(dataset.col(batchPoints[i]));
+  }
+
+  // Report the cumulative counts, so that the empty cluster policy only fires
+  // for clusters that have never claimed a point (and not for clusters that
+  // merely did not appear in this batch).
+  counts = centroidCounts;
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
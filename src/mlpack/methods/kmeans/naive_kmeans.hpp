@@ -9,6 +9,8 @@
 #ifndef __MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define __MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 
+#include <mlpack/core/metrics/lmetric.hpp>
+
 namespace mlpack {
 namespace kmeans {
 
@@ -46,11 +48,124 @@ class NaiveKMeans
 
   size_t DistanceCalculations() const { return distanceCalculations; }
 
+  //! Get the point weights (an empty vector means every point has weight 1).
+  const arma::vec& Weights() const { return weights; }
+  //! Modify the point weights.  If set, one weight per point of the dataset
+  //! is required; weighted coresets (see math::Coreset()) are the typical
+  //! source.
+  arma::vec& Weights() { return weights; }
+
  private:
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! Weight of each point (empty means unweighted).
+  arma::vec weights;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+/**
+ * A specialization of the Lloyd iteration for sparse data under the Euclidean
+ * metric.  The generic implementation forms a dense difference vector for
+ * every point-centroid pair, which costs O(d) per distance regardless of
+ * sparsity.  This specialization instead expands the squared distance as
+ * ||x||^2 + ||c||^2 - 2 x.c, so each distance only touches the nonzero
+ * elements of the point; an iteration then costs O(k * nnz) instead of
+ * O(k * n * d).
+ */
+template<>
+class NaiveKMeans<metric::EuclideanDistance, arma::sp_mat>
+{
+ public:
+  /**
+   * Construct the NaiveKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  NaiveKMeans(const arma::sp_mat& dataset, metric::EuclideanDistance& metric);
+
+  /**
+   * Run a single iteration of the Lloyd algorithm, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the point weights (empty means unweighted).
+  const arma::vec& Weights() const { return weights; }
+  //! Modify the point weights (one per point if set).
+  arma::vec& Weights() { return weights; }
+
+ private:
+  //! The dataset.
+  const arma::sp_mat& dataset;
+  //! The instantiated metric.
+  metric::EuclideanDistance& metric;
+  //! Weight of each point (empty means unweighted).
+  arma::vec weights;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+/**
+ * A specialization of the Lloyd iteration for dense data under the Euclidean
+ * metric.  The generic implementation evaluates every point-centroid
+ * distance with its own vector pass; this specialization instead expands the
+ * squared distances of a whole block of points at once as
+ * ||x||^2 + ||c||^2 - 2 C^T X, so the dominant cost of an iteration is one
+ * matrix-matrix product (gemm) per block.  A gemm goes through whatever BLAS
+ * the library is linked against, so it benefits from vendor-tuned and
+ * accelerator-backed implementations (for example, a GPU-offloading BLAS)
+ * without any changes here.
+ */
+template<>
+class NaiveKMeans<metric::EuclideanDistance, arma::mat>
+{
+ public:
+  /**
+   * Construct the NaiveKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  NaiveKMeans(const arma::mat& dataset, metric::EuclideanDistance& metric);
+
+  /**
+   * Run a single iteration of the Lloyd algorithm, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the point weights (empty means unweighted).
+  const arma::vec& Weights() const { return weights; }
+  //! Modify the point weights (one per point if set).
+  arma::vec& Weights() { return weights; }
+
+ private:
+  //! The dataset.
+  const arma::mat& dataset;
+  //! The instantiated metric.
+  metric::EuclideanDistance& metric;
+  //! Weight of each point (empty means unweighted).
+  arma::vec weights;
 
   //! Number of distance calculations.
   size_t distanceCalculations;
@@ -32,39 +32,373 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
 
+  // Each centroid is normalized by the total weight assigned to it; with no
+  // weights set, every weight is 1 and the weight sums equal the counts.
+  const bool weighted = (weights.n_elem > 0);
+  if (weighted && weights.n_elem != dataset.n_cols)
+    Log::Fatal << "NaiveKMeans::Iterate(): one weight per point is required ("
+        << weights.n_elem << " given, " << dataset.n_cols << " points)!"
+        << std::endl;
+  arma::vec weightSums(centroids.n_cols);
+  weightSums.zeros();
+
+  // Cache the distance of each centroid from the origin.  By the triangle
+  // inequality, a centroid whose origin distance differs from the point's
+  // origin distance by at least the best distance found so far cannot be
+  // closer, and can be eliminated without evaluating the full distance.
+  const arma::vec origin = arma::zeros<arma::vec>(centroids.n_rows);
+  arma::vec centroidNorms(centroids.n_cols);
+  for (size_t j = 0; j < centroids.n_cols; j++)
+    centroidNorms[j] = metric.Evaluate(centroids.col(j), origin);
+  distanceCalculations += centroids.n_cols;
+
   // Find the closest centroid to each point and update the new centroids.
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  // The points are divided among the threads, each of which accumulates into
+  // its own copies of the centroid sums and counts; these are combined at the
+  // end.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
   {
-    // Find the closest centroid to this point.
-    double minDistance = std::numeric_limits<double>::infinity();
-    size_t closestCluster = centroids.n_cols; // Invalid value.
+    arma::mat threadCentroids(centroids.n_rows, centroids.n_cols);
+    threadCentroids.zeros();
+    arma::Col<size_t> threadCounts(centroids.n_cols);
+    threadCounts.zeros();
+    arma::vec threadWeightSums(centroids.n_cols);
+    threadWeightSums.zeros();
+    size_t threadDistanceCalculations = 0;
 
-    for (size_t j = 0; j < centroids.n_cols; j++)
+    // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (long i = 0; i < (long) dataset.n_cols; i++)
     {
-      const double distance = metric.Evaluate(dataset.col(i), centroids.col(j));
+      const double pointNorm = metric.Evaluate(dataset.col(i), origin);
+      threadDistanceCalculations++;
+
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
 
-      if (distance < minDistance)
+      for (size_t j = 0; j < centroids.n_cols; j++)
       {
-        minDistance = distance;
-        closestCluster = j;
+        // Eliminate the centroid with the cached origin distances, if
+        // possible.
+        if (std::abs(pointNorm - centroidNorms[j]) >= minDistance)
+          continue;
+
+        const double distance = metric.Evaluate(dataset.col(i),
+            centroids.col(j));
+        threadDistanceCalculations++;
+
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
       }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      // We now have the minimum distance centroid index.  Update that
+      // centroid.
+      const double weight = weighted ? weights[i] : 1.0;
+      threadCentroids.col(closestCluster) +=
+          weight * arma::vec(dataset.col(i));
+      threadWeightSums(closestCluster) += weight;
+      threadCounts(closestCluster)++;
     }
 
-    Log::Assert(closestCluster != centroids.n_cols);
+    // Combine the per-thread accumulators.
+#ifdef _OPENMP
+    #pragma omp critical (naiveKMeansAccumulate)
+#endif
+    {
+      newCentroids += threadCentroids;
+      counts += threadCounts;
+      weightSums += threadWeightSums;
+      distanceCalculations += threadDistanceCalculations;
+    }
+  }
+
+  // Now normalize the centroid.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (weightSums(i) > 0.0)
+      newCentroids.col(i) /= weightSums(i);
+    else
+      newCentroids.col(i).fill(DBL_MAX); // Invalid value.
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+inline NaiveKMeans<metric::EuclideanDistance, arma::mat>::NaiveKMeans(
+    const arma::mat& dataset,
+    metric::EuclideanDistance& metric) :
+    dataset(dataset),
+    metric(metric),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration over dense data, expanding the squared Euclidean
+// distances of a whole block of points at once so that the dominant cost is
+// one gemm per block.
+inline double NaiveKMeans<metric::EuclideanDistance, arma::mat>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // See the generic Iterate() for the weighting scheme.
+  const bool weighted = (weights.n_elem > 0);
+  if (weighted && weights.n_elem != dataset.n_cols)
+    Log::Fatal << "NaiveKMeans::Iterate(): one weight per point is required ("
+        << weights.n_elem << " given, " << dataset.n_cols << " points)!"
+        << std::endl;
+  arma::vec weightSums(centroids.n_cols);
+  weightSums.zeros();
+
+  // Cache the squared norm of each centroid.
+  arma::vec centroidNorms = arma::trans(arma::sum(centroids % centroids, 0));
+  distanceCalculations += centroids.n_cols;
+
+  // The number of points whose centroid dot products are staged per gemm; a
+  // block should be large enough for the gemm to run at full speed but small
+  // enough that the staging buffer stays modest.
+  const size_t blockSize = 256;
+
+  // The blocks are divided among the threads, each of which accumulates into
+  // its own copies of the centroid sums and counts; these are combined at
+  // the end.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    arma::mat threadCentroids(centroids.n_rows, centroids.n_cols);
+    threadCentroids.zeros();
+    arma::Col<size_t> threadCounts(centroids.n_cols);
+    threadCounts.zeros();
+    arma::vec threadWeightSums(centroids.n_cols);
+    threadWeightSums.zeros();
+    size_t threadDistanceCalculations = 0;
+
+    // Staging buffer for the centroid-point dot products of one block,
+    // allocated once per thread instead of once per block.
+    arma::mat dots(centroids.n_cols, blockSize);
+
+    // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (long b = 0; b < (long) dataset.n_cols; b += (long) blockSize)
+    {
+      const size_t end = std::min((size_t) b + blockSize,
+          (size_t) dataset.n_cols);
+      const size_t width = end - (size_t) b;
+
+      // One gemm gives the dot product of every centroid with every point of
+      // the block; with the cached norms, the squared distance to centroid j
+      // is then ||x||^2 + ||c_j||^2 - 2 x.c_j.
+      dots.cols(0, width - 1) = arma::trans(centroids) *
+          dataset.cols(b, end - 1);
+
+      for (size_t i = 0; i < width; ++i)
+      {
+        const size_t point = (size_t) b + i;
+        const double pointNorm = arma::dot(dataset.col(point),
+            dataset.col(point));
+
+        // Find the closest centroid to this point.
+        double minDistance = std::numeric_limits<double>::infinity();
+        size_t closestCluster = centroids.n_cols; // Invalid value.
+
+        for (size_t j = 0; j < centroids.n_cols; j++)
+        {
+          // Guard against slightly negative values caused by roundoff error.
+          const double distance = std::max(0.0,
+              pointNorm + centroidNorms[j] - 2.0 * dots(j, i));
+
+          if (distance < minDistance)
+          {
+            minDistance = distance;
+            closestCluster = j;
+          }
+        }
+        threadDistanceCalculations += centroids.n_cols + 1;
 
-    // We now have the minimum distance centroid index.  Update that centroid.
-    newCentroids.col(closestCluster) += arma::vec(dataset.col(i));
-    counts(closestCluster)++;
+        Log::Assert(closestCluster != centroids.n_cols);
+
+        // We now have the minimum distance centroid index.  Update that
+        // centroid.
+        const double weight = weighted ? weights[point] : 1.0;
+        threadCentroids.col(closestCluster) += weight * dataset.col(point);
+        threadWeightSums(closestCluster) += weight;
+        threadCounts(closestCluster)++;
+      }
+    }
+
+    // Combine the per-thread accumulators.
+#ifdef _OPENMP
+    #pragma omp critical (naiveKMeansAccumulate)
+#endif
+    {
+      newCentroids += threadCentroids;
+      counts += threadCounts;
+      weightSums += threadWeightSums;
+      distanceCalculations += threadDistanceCalculations;
+    }
   }
 
   // Now normalize the centroid.
   for (size_t i = 0; i < centroids.n_cols; ++i)
-    if (counts(i) != 0)
-      newCentroids.col(i) /= counts(i);
+    if (weightSums(i) > 0.0)
+      newCentroids.col(i) /= weightSums(i);
     else
       newCentroids.col(i).fill(DBL_MAX); // Invalid value.
 
-  distanceCalculations += centroids.n_cols * dataset.n_cols;
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+inline NaiveKMeans<metric::EuclideanDistance, arma::sp_mat>::NaiveKMeans(
+    const arma::sp_mat& dataset,
+    metric::EuclideanDistance& metric) :
+    dataset(dataset),
+    metric(metric),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration over sparse data, expanding the squared Euclidean
+// distance so that only the nonzero elements of each point are touched.
+inline double NaiveKMeans<metric::EuclideanDistance, arma::sp_mat>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // See the generic Iterate() for the weighting scheme.
+  const bool weighted = (weights.n_elem > 0);
+  if (weighted && weights.n_elem != dataset.n_cols)
+    Log::Fatal << "NaiveKMeans::Iterate(): one weight per point is required ("
+        << weights.n_elem << " given, " << dataset.n_cols << " points)!"
+        << std::endl;
+  arma::vec weightSums(centroids.n_cols);
+  weightSums.zeros();
+
+  // Cache the squared norm of each centroid; the centroids are dense, so
+  // these are computed directly.
+  arma::vec centroidNorms(centroids.n_cols);
+  for (size_t j = 0; j < centroids.n_cols; j++)
+    centroidNorms[j] = arma::dot(centroids.col(j), centroids.col(j));
+
+  // Find the closest centroid to each point and update the new centroids.
+  // The points are divided among the threads, each of which accumulates into
+  // its own copies of the centroid sums and counts; these are combined at the
+  // end.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    arma::mat threadCentroids(centroids.n_rows, centroids.n_cols);
+    threadCentroids.zeros();
+    arma::Col<size_t> threadCounts(centroids.n_cols);
+    threadCounts.zeros();
+    arma::vec threadWeightSums(centroids.n_cols);
+    threadWeightSums.zeros();
+    size_t threadDistanceCalculations = 0;
+
+    // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (long i = 0; i < (long) dataset.n_cols; i++)
+    {
+      // One pass over the nonzero elements of the point gives its squared
+      // norm and its dot product with every centroid; with those, the
+      // squared distance to centroid j is
+      //   ||x||^2 + ||c_j||^2 - 2 x.c_j.
+      double pointNorm = 0.0;
+      arma::vec dots(centroids.n_cols);
+      dots.zeros();
+
+      for (arma::sp_mat::const_col_iterator it = dataset.begin_col(i);
+           it != dataset.end_col(i); ++it)
+      {
+        const double value = (*it);
+        pointNorm += value * value;
+        for (size_t j = 0; j < centroids.n_cols; j++)
+          dots[j] += value * centroids(it.row(), j);
+      }
+
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; j++)
+      {
+        // Guard against slightly negative values caused by roundoff error.
+        const double distance = std::max(0.0,
+            pointNorm + centroidNorms[j] - 2.0 * dots[j]);
+
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+      threadDistanceCalculations += centroids.n_cols;
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      // We now have the minimum distance centroid index.  Update that
+      // centroid, again touching only the nonzero elements of the point.
+      const double weight = weighted ? weights[i] : 1.0;
+      for (arma::sp_mat::const_col_iterator it = dataset.begin_col(i);
+           it != dataset.end_col(i); ++it)
+        threadCentroids(it.row(), closestCluster) += weight * (*it);
+      threadWeightSums(closestCluster) += weight;
+      threadCounts(closestCluster)++;
+    }
+
+    // Combine the per-thread accumulators.
+#ifdef _OPENMP
+    #pragma omp critical (naiveKMeansAccumulate)
+#endif
+    {
+      newCentroids += threadCentroids;
+      counts += threadCounts;
+      weightSums += threadWeightSums;
+      distanceCalculations += threadDistanceCalculations;
+    }
+  }
+
+  // Now normalize the centroid.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (weightSums(i) > 0.0)
+      newCentroids.col(i) /= weightSums(i);
+    else
+      newCentroids.col(i).fill(DBL_MAX); // Invalid value.
 
   // Calculate cluster distortion for this iteration.
   double cNorm = 0.0;
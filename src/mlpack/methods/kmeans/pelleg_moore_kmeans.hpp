@@ -64,6 +64,12 @@ class PellegMooreKMeans
   //! Modify the number of distance calculations.
   size_t& DistanceCalculations() { return distanceCalculations; }
 
+  //! Return the clustering objective (sum of squared distances of each point
+  //! to the centroid it was assigned to) of the last call to Iterate().  This
+  //! is exact, and whole nodes contribute in O(d) through the sufficient
+  //! statistics cached in the tree.
+  double Objective() const { return objective; }
+
   //! Convenience typedef for the tree.
   typedef tree::BinarySpaceTree<bound::HRectBound<2, true>,
       PellegMooreKMeansStatistic, MatType> TreeType;
@@ -83,6 +89,8 @@ class PellegMooreKMeans
 
   //! Track distance calculations.
   size_t distanceCalculations;
+  //! The clustering objective of the last iteration.
+  double objective;
 };
 
 } // namespace kmeans
@@ -22,7 +22,8 @@ PellegMooreKMeans<MetricType, MatType>::PellegMooreKMeans(
     dataset(tree::TreeTraits<TreeType>::RearrangesDataset ? datasetCopy :
         datasetOrig),
     metric(metric),
-    distanceCalculations(0)
+    distanceCalculations(0),
+    objective(0.0)
 {
   Timer::Start("tree_building");
 
@@ -65,6 +66,7 @@ double PellegMooreKMeans<MetricType, MatType>::Iterate(
   traverser.Traverse(0, *tree);
 
   distanceCalculations += rules.DistanceCalculations();
+  objective = rules.Objective();
 
   // Now, calculate how far the clusters moved, after normalizing them.
   double residual = 0.0;
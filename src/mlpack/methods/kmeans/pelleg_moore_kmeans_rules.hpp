@@ -55,6 +55,23 @@ class PellegMooreKMeansRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case over a contiguous block of reference points (the points
+   * of a leaf node).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point in the block.
+   * @param referenceEnd Index one past the last reference point in the block.
+   */
+  void BaseCases(const size_t queryIndex,
+                 const size_t referenceBegin,
+                 const size_t referenceEnd)
+  {
+    for (size_t i = referenceBegin; i < referenceEnd; ++i)
+      BaseCase(queryIndex, i);
+  }
+
+
   /**
    * Determine if a cluster can be pruned, and if not, perform point-to-cluster
    * comparisons.  The point-to-cluster comparisons are performed here and not
@@ -82,6 +99,12 @@ class PellegMooreKMeansRules
   //! Modify the number of distance calculations that have been performed.
   size_t& DistanceCalculations() { return distanceCalculations; }
 
+  //! Get the clustering objective (sum of squared distances of each point to
+  //! the centroid it was assigned to) of the traversal's assignment.
+  double Objective() const { return objective; }
+  //! Modify the clustering objective.
+  double& Objective() { return objective; }
+
  private:
   //! The dataset.
   const typename TreeType::Mat& dataset;
@@ -96,6 +119,8 @@ class PellegMooreKMeansRules
 
   //! The number of O(d) distance calculations that have been performed.
   size_t distanceCalculations;
+  //! The clustering objective of the assignment made by the traversal.
+  double objective;
 };
 
 }; // namespace kmeans
@@ -27,7 +27,8 @@ PellegMooreKMeansRules<MetricType, TreeType>::PellegMooreKMeansRules(
     newCentroids(newCentroids),
     counts(counts),
     metric(metric),
-    distanceCalculations(0)
+    distanceCalculations(0),
+    objective(0.0)
 {
   // Nothing to do.
 }
@@ -46,21 +47,31 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
     const size_t /* queryIndex */,
     TreeType& referenceNode)
 {
-  // Obtain the parent's blacklist.  If this is the root node, we'll start with
-  // an empty blacklist.  This means that after each iteration, we don't need to
-  // reset any statistics.
+  // Obtain the blacklist in effect for this node.  The root resets its own
+  // blacklist, which means that after each iteration, we don't need to reset
+  // any statistics.  Other nodes inherit their parent's blacklist by
+  // reference, and only materialize a private copy if they blacklist further
+  // clusters themselves (copy-on-write); at large k, copying the blacklist
+  // into every node costs more memory traffic than the distance calculations
+  // it saves.
   if (referenceNode.Parent() == NULL ||
-      referenceNode.Parent()->Stat().Blacklist().n_elem == 0)
+      referenceNode.Parent()->Stat().EffectiveBlacklist() == NULL)
+  {
     referenceNode.Stat().Blacklist().zeros(centroids.n_cols);
+    referenceNode.Stat().EffectiveBlacklist() =
+        &referenceNode.Stat().Blacklist();
+  }
   else
-    referenceNode.Stat().Blacklist() =
-        referenceNode.Parent()->Stat().Blacklist();
+  {
+    referenceNode.Stat().EffectiveBlacklist() =
+        referenceNode.Parent()->Stat().EffectiveBlacklist();
+  }
+  const arma::uvec* blacklist = referenceNode.Stat().EffectiveBlacklist();
 
   // The query index is a fake index that we won't use, and the reference node
   // holds all of the points in the dataset.  Our goal is to determine whether
   // or not this node is dominated by a single cluster.
-  const size_t whitelisted = centroids.n_cols -
-      arma::accu(referenceNode.Stat().Blacklist());
+  const size_t whitelisted = centroids.n_cols - arma::accu(*blacklist);
 
   distanceCalculations += whitelisted;
 
@@ -69,7 +80,7 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
   double minMinDistance = DBL_MAX;
   for (size_t i = 0; i < centroids.n_cols; ++i)
   {
-    if (referenceNode.Stat().Blacklist()[i] == 0)
+    if ((*blacklist)[i] == 0)
     {
       const double minDistance = referenceNode.MinDistance(centroids.col(i));
       if (minDistance < minMinDistance)
@@ -88,7 +99,7 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
   size_t newBlacklisted = 0;
   for (size_t c = 0; c < centroids.n_cols; ++c)
   {
-    if (referenceNode.Stat().Blacklist()[c] == 1 || c == closestCluster)
+    if ((*blacklist)[c] == 1 || c == closestCluster)
       continue;
 
     // This algorithm comes from the proof of Lemma 4 in the extended version
@@ -112,7 +123,15 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
     if (closestDist < otherDist)
     {
       // The closest cluster dominates the node with respect to the cluster c.
-      // So we can blacklist c.
+      // So we can blacklist c.  First materialize a private copy of the
+      // inherited blacklist, if we do not have one already.
+      if (blacklist != &referenceNode.Stat().Blacklist())
+      {
+        referenceNode.Stat().Blacklist() = *blacklist;
+        referenceNode.Stat().EffectiveBlacklist() =
+            &referenceNode.Stat().Blacklist();
+        blacklist = referenceNode.Stat().EffectiveBlacklist();
+      }
       referenceNode.Stat().Blacklist()[c] = 1;
       ++newBlacklisted;
     }
@@ -120,10 +139,21 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
 
   if (whitelisted - newBlacklisted == 1)
   {
-    // This node is dominated by the closest cluster.
-    counts[closestCluster] += referenceNode.NumDescendants();
-    newCentroids.col(closestCluster) += referenceNode.NumDescendants() *
-        referenceNode.Stat().Centroid();
+    // This node is dominated by the closest cluster.  Assign the node's whole
+    // mass using the cached sufficient statistics: the centroid gives the sum
+    // of the points in O(d), and together with the sum of squared norms it
+    // gives the node's objective contribution in O(d) too, via
+    //   sum_i || x_i - c ||^2 = sumSq - 2 n (c . com) + n || c ||^2,
+    // where com is the node's center of mass and n its number of descendants.
+    const size_t n = referenceNode.NumDescendants();
+    counts[closestCluster] += n;
+    newCentroids.col(closestCluster) += n * referenceNode.Stat().Centroid();
+
+    objective += referenceNode.Stat().SumOfSquaredNorms() -
+        2.0 * n * arma::dot(centroids.col(closestCluster),
+            referenceNode.Stat().Centroid()) +
+        n * arma::dot(centroids.col(closestCluster),
+            centroids.col(closestCluster));
 
     return DBL_MAX;
   }
@@ -135,7 +165,7 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
     double bestDistance = DBL_MAX;
     for (size_t c = 0; c < centroids.n_cols; ++c)
     {
-      if (referenceNode.Stat().Blacklist()[c] == 1)
+      if ((*blacklist)[c] == 1)
         continue;
 
       ++distanceCalculations;
@@ -154,6 +184,7 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
     // Add to resulting centroid.
     newCentroids.col(bestCluster) += dataset.col(referenceNode.Point(i));
     ++counts(bestCluster);
+    objective += bestDistance * bestDistance;
   }
 
   // Otherwise, we're not sure, so we can't prune.  Recursion order doesn't make
@@ -20,14 +20,17 @@ class PellegMooreKMeansStatistic
 {
  public:
   //! Initialize the statistic without a node (this does nothing).
-  PellegMooreKMeansStatistic() { }
+  PellegMooreKMeansStatistic() : effectiveBlacklist(NULL),
+      sumOfSquaredNorms(0.0) { }
 
-  //! Initialize the statistic for a node; this calculates the centroid and
-  //! caches it.
+  //! Initialize the statistic for a node; this calculates the sufficient
+  //! statistics of the node's points (the centroid and the sum of squared
+  //! norms, in the style of the mrkd-tree) and caches them.
   template<typename TreeType>
-  PellegMooreKMeansStatistic(TreeType& node)
+  PellegMooreKMeansStatistic(TreeType& node) : effectiveBlacklist(NULL)
   {
     centroid.zeros(node.Dataset().n_rows);
+    sumOfSquaredNorms = 0.0;
 
     // Hope it's a depth-first build procedure.  Also, this won't work right for
     // trees that have self-children or stuff like that.
@@ -35,11 +38,14 @@ class PellegMooreKMeansStatistic
     {
       centroid += node.Child(i).NumDescendants() *
           node.Child(i).Stat().Centroid();
+      sumOfSquaredNorms += node.Child(i).Stat().SumOfSquaredNorms();
     }
 
     for (size_t i = 0; i < node.NumPoints(); ++i)
     {
       centroid += node.Dataset().col(node.Point(i));
+      sumOfSquaredNorms += arma::dot(node.Dataset().col(node.Point(i)),
+          node.Dataset().col(node.Point(i)));
     }
 
     if (node.NumDescendants() > 0)
@@ -53,11 +59,24 @@ class PellegMooreKMeansStatistic
   //! Modify the cluster blacklist.
   arma::uvec& Blacklist() { return blacklist; }
 
+  //! Get the pointer to the blacklist in effect for this node.  This may point
+  //! at an ancestor's blacklist if this node has not blacklisted any clusters
+  //! of its own (copy-on-write inheritance); it is only valid during a
+  //! traversal, which re-establishes it before use.
+  const arma::uvec* EffectiveBlacklist() const { return effectiveBlacklist; }
+  //! Modify the pointer to the blacklist in effect for this node.
+  const arma::uvec*& EffectiveBlacklist() { return effectiveBlacklist; }
+
   //! Get the node's centroid.
   const arma::vec& Centroid() const { return centroid; }
   //! Modify the node's centroid (be careful!).
   arma::vec& Centroid() { return centroid; }
 
+  //! Get the sum of squared norms of the node's points.
+  double SumOfSquaredNorms() const { return sumOfSquaredNorms; }
+  //! Modify the sum of squared norms of the node's points (be careful!).
+  double& SumOfSquaredNorms() { return sumOfSquaredNorms; }
+
   //! Return the object as a string.
   std::string ToString() const
   {
@@ -69,10 +88,17 @@ class PellegMooreKMeansStatistic
   }
 
  private:
-  //! The cluster blacklist for the node.
+  //! The cluster blacklist for the node, materialized only if the node
+  //! blacklists clusters beyond those its parent already blacklisted.
   arma::uvec blacklist;
+  //! The blacklist in effect for the node; either &blacklist or an ancestor's.
+  const arma::uvec* effectiveBlacklist;
   //! The centroid of the node, cached for use during prunes.
   arma::vec centroid;
+  //! The sum of squared norms of the node's points; together with the
+  //! centroid, this is the sufficient statistic needed to accumulate the
+  //! clustering objective of a whole node in O(d).
+  double sumOfSquaredNorms;
 };
 
 }; // namespace kmeans
@@ -23,21 +23,28 @@ void RefinedStart::Cluster(const MatType& data,
 {
   math::RandomSeed(std::time(NULL));
 
-  // This will hold the sampled datasets.
+  // The number of points to sample for each trial, and the shared buffer the
+  // trials write their centroids into (each trial owns a disjoint block of
+  // columns).
   const size_t numPoints = size_t(percentage * data.n_cols);
-  MatType sampledData(data.n_rows, numPoints);
-  // vector<bool> is packed so each bool is 1 bit.
-  std::vector<bool> pointsUsed(data.n_cols, false);
   arma::mat sampledCentroids(data.n_rows, samplings * clusters);
 
-  // We will use these objects repeatedly for clustering.
-  arma::Col<size_t> sampledAssignments;
-  arma::mat centroids;
-  KMeans<> kmeans;
-
-  for (size_t i = 0; i < samplings; ++i)
+  // The sampling trials are independent: each one draws its own subsample,
+  // clusters it, and writes its centroids into its own column block of the
+  // shared buffer, so the trials are divided among the threads.  Every
+  // thread draws from its own random stream (see math::RandGen()), and each
+  // trial allocates its own sampling and clustering workspace.  The loop
+  // index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (long i = 0; i < (long) samplings; ++i)
   {
     // First, assemble the sampled dataset.
+    MatType sampledData(data.n_rows, numPoints);
+    // vector<bool> is packed so each bool is 1 bit.
+    std::vector<bool> pointsUsed(data.n_cols, false);
+
     size_t curSample = 0;
     while (curSample < numPoints)
     {
@@ -57,15 +64,19 @@ void RefinedStart::Cluster(const MatType& data,
     // cluster, we re-initialize that cluster as the point furthest away from
     // the cluster with maximum variance.  This is not *exactly* what the paper
     // implements, but it is quite similar, and we'll call it "good enough".
+    arma::Col<size_t> sampledAssignments;
+    arma::mat centroids;
+    KMeans<> kmeans;
     kmeans.Cluster(sampledData, clusters, sampledAssignments, centroids);
 
     // Store the sampled centroids.
     sampledCentroids.cols(i * clusters, (i + 1) * clusters - 1) = centroids;
-
-    pointsUsed.assign(data.n_cols, false);
   }
 
   // Now, we run k-means on the sampled centroids to get our final clusters.
+  arma::Col<size_t> sampledAssignments;
+  arma::mat centroids;
+  KMeans<> kmeans;
   kmeans.Cluster(sampledCentroids, clusters, sampledAssignments, centroids);
 
   // Turn the final centroids into assignments.
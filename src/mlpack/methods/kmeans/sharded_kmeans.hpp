@@ -0,0 +1,222 @@
+/**
+ * @file sharded_kmeans.hpp
+ *
+ * K-Means clustering over a dataset that is split into shards, built on
+ * per-shard sufficient statistics.  The worker and coordinator steps are
+ * exposed separately so that the shards can live on different machines.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_SHARDED_KMEANS_HPP
+#define __MLPACK_METHODS_KMEANS_SHARDED_KMEANS_HPP
+
+#include <mlpack/core.hpp>
+
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "random_partition.hpp"
+#include "max_variance_new_cluster.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The sufficient statistics of one Lloyd iteration over one shard: the sum of
+ * the points assigned to each cluster and the number of points assigned to
+ * each cluster.  The statistics of any number of shards combine by simple
+ * addition (operator+=()), and the combined statistics determine the centroid
+ * update exactly -- the update computed from them is identical to the one a
+ * single-machine Lloyd step would compute over the concatenated shards.
+ */
+struct KMeansSufficientStatistics
+{
+  //! Sum of the points assigned to each cluster (one column per cluster).
+  arma::mat sums;
+  //! Number of points assigned to each cluster.
+  arma::Col<size_t> counts;
+
+  //! Reset the statistics to zero for the given problem size.
+  void Zeros(const size_t dimensionality, const size_t clusters)
+  {
+    sums.zeros(dimensionality, clusters);
+    counts.zeros(clusters);
+  }
+
+  //! Combine the statistics of another shard into these.
+  KMeansSufficientStatistics& operator+=(
+      const KMeansSufficientStatistics& other)
+  {
+    sums += other.sums;
+    counts += other.counts;
+    return *this;
+  }
+};
+
+/**
+ * This class implements K-Means clustering for a dataset that is split into
+ * shards.  Each Lloyd iteration is decomposed into a worker step
+ * (ComputeStatistics()), which assigns the points of one shard to the current
+ * centroids and accumulates the per-cluster sufficient statistics, and a
+ * coordinator step (UpdateCentroids()), which turns the combined statistics
+ * into the new centroids.  Because the statistics combine by addition, the
+ * result is identical to running K-Means on the concatenated shards.
+ *
+ * Cluster() drives both steps locally, processing the shards in parallel when
+ * OpenMP is available.  A distributed deployment instead calls
+ * ComputeStatistics() on each worker, ships the statistics to the
+ * coordinator, combines them with operator+=(), and calls UpdateCentroids()
+ * there; Cluster() then documents the iteration structure such a driver
+ * should follow.
+ *
+ * The template parameters mirror those of KMeans; there is no Lloyd step
+ * policy, since the sufficient-statistic decomposition is itself the Lloyd
+ * step.  Note that the empty cluster policy is applied to a single shard (the
+ * largest), since no node holds the whole dataset.
+ *
+ * @tparam MetricType The distance metric to use for this ShardedKMeans; see
+ *     metric::LMetric for an example.
+ * @tparam InitialPartitionPolicy Initial partitioning policy; must implement
+ *     a default constructor and 'void Cluster(const arma::mat&, const size_t,
+ *     arma::Col<size_t>&)'.  It is run on the first shard only.
+ * @tparam EmptyClusterPolicy Policy for what to do on an empty cluster; must
+ *     implement a default constructor and 'size_t EmptyCluster(const MatType&,
+ *     const size_t, arma::mat&, arma::Col<size_t>&, MetricType&, const
+ *     size_t)'.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ *
+ * @see KMeans, NaiveKMeans
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename InitialPartitionPolicy = RandomPartition,
+         typename EmptyClusterPolicy = MaxVarianceNewCluster,
+         typename MatType = arma::mat>
+class ShardedKMeans
+{
+ public:
+  /**
+   * Create a ShardedKMeans object and (optionally) set the parameters which
+   * it will be run with.
+   *
+   * @param maxIterations Maximum number of iterations allowed before giving
+   *     up (0 is valid, but the algorithm may never terminate).
+   * @param metric Optional MetricType object; for when the metric has state
+   *     it needs to store.
+   * @param partitioner Optional InitialPartitionPolicy object; for when a
+   *     specially initialized partitioning policy is required.
+   * @param emptyClusterAction Optional EmptyClusterPolicy object; for when a
+   *     specially initialized empty cluster policy is required.
+   */
+  ShardedKMeans(const size_t maxIterations = 1000,
+                const MetricType metric = MetricType(),
+                const InitialPartitionPolicy partitioner =
+                    InitialPartitionPolicy(),
+                const EmptyClusterPolicy emptyClusterAction =
+                    EmptyClusterPolicy());
+
+  /**
+   * Perform k-means clustering on the sharded data, returning the centroids
+   * of each cluster in the centroids matrix.  Optionally, the initial
+   * centroids can be specified by filling the centroids matrix with the
+   * initial centroids and specifying initialGuess = true; otherwise the
+   * initial centroids are computed from the first shard with the initial
+   * partitioning policy.
+   *
+   * @param shards The shards of the dataset (all with the same
+   *     dimensionality; none may be NULL).
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains
+   *     the initial cluster centroids.
+   */
+  void Cluster(const std::vector<const MatType*>& shards,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Perform k-means clustering on the sharded data, returning the centroids
+   * and the cluster assignments of every shard (assignments[s][i] is the
+   * cluster of point i of shard s).
+   *
+   * @param shards The shards of the dataset.
+   * @param clusters Number of clusters to compute.
+   * @param assignments Vector to store the per-shard cluster assignments in.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains
+   *     the initial cluster centroids.
+   */
+  void Cluster(const std::vector<const MatType*>& shards,
+               const size_t clusters,
+               std::vector<arma::Col<size_t> >& assignments,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * The worker step: assign every point of the given shard to its closest
+   * centroid and accumulate the per-cluster sufficient statistics.  The
+   * statistics are reset first, so they describe only this shard; combine
+   * the statistics of several shards with
+   * KMeansSufficientStatistics::operator+=().
+   *
+   * @param shard One shard of the dataset.
+   * @param centroids Current cluster centroids.
+   * @param statistics Statistics of this shard (overwritten).
+   */
+  void ComputeStatistics(const MatType& shard,
+                         const arma::mat& centroids,
+                         KMeansSufficientStatistics& statistics);
+
+  /**
+   * The coordinator step: turn the combined sufficient statistics of all
+   * shards into the new centroids.  The centroid of an empty cluster is set
+   * to DBL_MAX (the empty cluster policy is the caller's responsibility, as
+   * in the Lloyd step types).  Returns the residual (the norm of the centroid
+   * movement), which drives the convergence check.
+   *
+   * @param statistics Combined statistics of all shards.
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids (overwritten).
+   */
+  double UpdateCentroids(const KMeansSufficientStatistics& statistics,
+                         const arma::mat& centroids,
+                         arma::mat& newCentroids);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Set the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the initial partitioning policy.
+  const InitialPartitionPolicy& Partitioner() const { return partitioner; }
+  //! Modify the initial partitioning policy.
+  InitialPartitionPolicy& Partitioner() { return partitioner; }
+
+  //! Get the empty cluster policy.
+  const EmptyClusterPolicy& EmptyClusterAction() const
+  { return emptyClusterAction; }
+  //! Modify the empty cluster policy.
+  EmptyClusterPolicy& EmptyClusterAction() { return emptyClusterAction; }
+
+  // Returns a string representation of this object.
+  std::string ToString() const;
+
+ private:
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Instantiated initial partitioning policy.
+  InitialPartitionPolicy partitioner;
+  //! Instantiated empty cluster policy.
+  EmptyClusterPolicy emptyClusterAction;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "sharded_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,355 @@
+/**
+ * @file sharded_kmeans_impl.hpp
+ *
+ * Implementation of K-Means clustering over sharded data.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_SHARDED_KMEANS_IMPL_HPP
+#define __MLPACK_METHODS_KMEANS_SHARDED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sharded_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Construct the ShardedKMeans object.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename MatType>
+ShardedKMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    MatType>::
+ShardedKMeans(const size_t maxIterations,
+              const MetricType metric,
+              const InitialPartitionPolicy partitioner,
+              const EmptyClusterPolicy emptyClusterAction) :
+    maxIterations(maxIterations),
+    metric(metric),
+    partitioner(partitioner),
+    emptyClusterAction(emptyClusterAction)
+{
+  // Nothing to do.
+}
+
+/**
+ * Perform k-means clustering on the sharded data, returning the centroids of
+ * each cluster.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename MatType>
+void ShardedKMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    MatType>::
+Cluster(const std::vector<const MatType*>& shards,
+        const size_t clusters,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  if (shards.size() == 0)
+    Log::Fatal << "ShardedKMeans::Cluster(): no shards given!" << std::endl;
+
+  // Check that the shards agree on the dimensionality, count the points, and
+  // find the largest shard (the empty cluster policy is applied to it).
+  const size_t dimensionality = shards[0]->n_rows;
+  size_t points = 0;
+  size_t largestShard = 0;
+  for (size_t s = 0; s < shards.size(); ++s)
+  {
+    if (shards[s] == NULL)
+      Log::Fatal << "ShardedKMeans::Cluster(): shard " << s << " is NULL!"
+          << std::endl;
+    if (shards[s]->n_rows != dimensionality)
+      Log::Fatal << "ShardedKMeans::Cluster(): shard " << s << " has "
+          << "dimensionality " << shards[s]->n_rows << ", but shard 0 has "
+          << "dimensionality " << dimensionality << "!" << std::endl;
+
+    points += shards[s]->n_cols;
+    if (shards[s]->n_cols > shards[largestShard]->n_cols)
+      largestShard = s;
+  }
+
+  if (clusters > points)
+    Log::Warn << "ShardedKMeans::Cluster(): more clusters requested than "
+        << "points given." << std::endl;
+
+  // Check validity of initial guess.
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "ShardedKMeans::Cluster(): wrong number of initial "
+          << "cluster centroids (" << centroids.n_cols << ", should be "
+          << clusters << ")!" << std::endl;
+
+    if (centroids.n_rows != dimensionality)
+      Log::Fatal << "ShardedKMeans::Cluster(): initial cluster centroids "
+          << "have wrong dimensionality (" << centroids.n_rows << ", should "
+          << "be " << dimensionality << ")!" << std::endl;
+  }
+
+  // Without an initial guess, use the partitioner to compute initial
+  // centroids from the first shard; one shard is all any single node holds.
+  if (!initialGuess)
+  {
+    const MatType& first = *shards[0];
+
+    arma::Col<size_t> assignments;
+    partitioner.Cluster(first, clusters, assignments);
+
+    arma::Col<size_t> counts;
+    counts.zeros(clusters);
+    centroids.zeros(dimensionality, clusters);
+    for (size_t i = 0; i < first.n_cols; ++i)
+    {
+      centroids.col(assignments[i]) += arma::vec(first.col(i));
+      counts[assignments[i]]++;
+    }
+
+    for (size_t i = 0; i < clusters; ++i)
+      if (counts[i] != 0)
+        centroids.col(i) /= counts[i];
+  }
+
+  // One statistics object per shard; a distributed driver would instead
+  // receive these from the workers.
+  std::vector<KMeansSufficientStatistics> shardStatistics(shards.size());
+
+  size_t iteration = 0;
+
+  arma::mat centroidsOther;
+  double cNorm;
+
+  do
+  {
+    // The two centroid matrices alternate roles between iterations, exactly
+    // as in KMeans::Cluster(), to avoid copying.
+    const arma::mat& oldCentroids = (iteration % 2 == 0) ? centroids
+        : centroidsOther;
+    arma::mat& newCentroids = (iteration % 2 == 0) ? centroidsOther
+        : centroids;
+
+    // The worker step: each shard computes its own statistics, independently
+    // of the others.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    // The loop index is signed for OpenMP.
+    for (long s = 0; s < (long) shards.size(); ++s)
+      ComputeStatistics(*shards[s], oldCentroids, shardStatistics[s]);
+
+    // The coordinator step: combine the statistics and update the centroids.
+    KMeansSufficientStatistics total = shardStatistics[0];
+    for (size_t s = 1; s < shards.size(); ++s)
+      total += shardStatistics[s];
+
+    cNorm = UpdateCentroids(total, oldCentroids, newCentroids);
+
+    // Repair any empty clusters.  No node holds the whole dataset, so the
+    // policy sees only the largest shard; this is an approximation of what
+    // the policy would do with all of the points.
+    arma::Col<size_t> counts = total.counts;
+    for (size_t i = 0; i < clusters; ++i)
+    {
+      if (counts[i] == 0)
+      {
+        Log::Info << "Cluster " << i << " is empty.\n";
+        emptyClusterAction.EmptyCluster(*shards[largestShard], i,
+            newCentroids, counts, metric, iteration);
+      }
+    }
+
+    iteration++;
+    Log::Info << "ShardedKMeans::Cluster(): iteration " << iteration
+        << ", residual " << cNorm << ".\n";
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  // If we ended on an even iteration, then the centroids are in the
+  // centroidsOther matrix, and we need to steal its memory.
+  if ((iteration - 1) % 2 == 0)
+    centroids.steal_mem(centroidsOther);
+
+  if (iteration != maxIterations)
+  {
+    Log::Info << "ShardedKMeans::Cluster(): converged after " << iteration
+        << " iterations." << std::endl;
+  }
+  else
+  {
+    Log::Info << "ShardedKMeans::Cluster(): terminated after limit of "
+        << iteration << " iterations." << std::endl;
+  }
+}
+
+/**
+ * Perform k-means clustering on the sharded data, returning the centroids
+ * and the per-shard cluster assignments.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename MatType>
+void ShardedKMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    MatType>::
+Cluster(const std::vector<const MatType*>& shards,
+        const size_t clusters,
+        std::vector<arma::Col<size_t> >& assignments,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  Cluster(shards, clusters, centroids, initialGuess);
+
+  // Calculate final assignments for every shard.
+  assignments.resize(shards.size());
+  for (size_t s = 0; s < shards.size(); ++s)
+  {
+    const MatType& shard = *shards[s];
+    assignments[s].set_size(shard.n_cols);
+
+    for (size_t i = 0; i < shard.n_cols; ++i)
+    {
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; j++)
+      {
+        const double distance = metric.Evaluate(shard.col(i),
+            centroids.col(j));
+
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+      assignments[s][i] = closestCluster;
+    }
+  }
+}
+
+/**
+ * The worker step: accumulate the sufficient statistics of one shard.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename MatType>
+void ShardedKMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    MatType>::
+ComputeStatistics(const MatType& shard,
+                  const arma::mat& centroids,
+                  KMeansSufficientStatistics& statistics)
+{
+  statistics.Zeros(centroids.n_rows, centroids.n_cols);
+
+  // Cache the distance of each centroid from the origin.  By the triangle
+  // inequality, a centroid whose origin distance differs from the point's
+  // origin distance by at least the best distance found so far cannot be
+  // closer, and can be eliminated without evaluating the full distance.
+  const arma::vec origin = arma::zeros<arma::vec>(centroids.n_rows);
+  arma::vec centroidNorms(centroids.n_cols);
+  for (size_t j = 0; j < centroids.n_cols; j++)
+    centroidNorms[j] = metric.Evaluate(centroids.col(j), origin);
+
+  for (size_t i = 0; i < shard.n_cols; ++i)
+  {
+    const double pointNorm = metric.Evaluate(shard.col(i), origin);
+
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      // Eliminate the centroid with the cached origin distances, if possible.
+      if (std::abs(pointNorm - centroidNorms[j]) >= minDistance)
+        continue;
+
+      const double distance = metric.Evaluate(shard.col(i), centroids.col(j));
+
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+
+    statistics.sums.col(closestCluster) += arma::vec(shard.col(i));
+    statistics.counts(closestCluster)++;
+  }
+}
+
+/**
+ * The coordinator step: turn the combined statistics into new centroids.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename MatType>
+double ShardedKMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    MatType>::
+UpdateCentroids(const KMeansSufficientStatistics& statistics,
+                const arma::mat& centroids,
+                arma::mat& newCentroids)
+{
+  newCentroids.set_size(centroids.n_rows, centroids.n_cols);
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (statistics.counts[i] > 0)
+      newCentroids.col(i) = statistics.sums.col(i) / statistics.counts[i];
+    else
+      newCentroids.col(i).fill(DBL_MAX); // Invalid value.
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename MatType>
+std::string ShardedKMeans<MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    MatType>::ToString() const
+{
+  std::ostringstream convert;
+  convert << "ShardedKMeans [" << this << "]" << std::endl;
+  convert << "  Max Iterations: " << maxIterations << std::endl;
+  convert << "  Metric: " << std::endl;
+  convert << mlpack::util::Indent(metric.ToString(), 2);
+  convert << std::endl;
+  return convert.str();
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -43,6 +43,17 @@ void LARS::Regress(const arma::mat& matX,
 {
   Timer::Start("lars_regression");
 
+  // Clear any state from a previous solve, so that a single LARS object may
+  // be reused for many problems.  The Gram matrix depends only on the data,
+  // so it is retained across calls.
+  betaPath.clear();
+  lambdaPath.clear();
+  activeSet.clear();
+  isActive.clear();
+  ignoreSet.clear();
+  isIgnored.clear();
+  matUtriCholFactor.reset();
+
   // This matrix may end up holding the transpose -- if necessary.
   arma::mat dataTrans;
   // dataRef is row-major.
@@ -92,8 +103,11 @@ void LARS::Regress(const arma::mat& matX,
   }
 
   // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram.n_elem == 0)
+  // lambda2 * I_n to the matrix.  If the Gram matrix was computed by a
+  // previous call and has the right size, it is reused; so, when solving
+  // against the same data many times, the Gram matrix is only built once.
+  if ((&matGram == &matGramInternal) &&
+      (matGram.n_elem != dataRef.n_cols * dataRef.n_cols))
   {
     // In this case, matGram should reference matGramInternal.
     matGramInternal = trans(dataRef) * dataRef;
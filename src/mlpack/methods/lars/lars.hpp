@@ -53,6 +53,13 @@ namespace regression {
  * Note: This algorithm is not recommended for use (in terms of efficiency)
  * when \f$ \lambda_1 \f$ = 0.
  *
+ * A single LARS object can be reused to solve many problems against the same
+ * data (or the same precomputed Gram matrix), as SparseCoding does during its
+ * alternations: each call to Regress() clears the state of the previous
+ * solve, but the Gram matrix is computed only once and retained across calls.
+ * When solving against different data without a precomputed Gram matrix, use
+ * a fresh object.
+ *
  * For more details, see the following papers:
  *
  * @code
@@ -125,6 +132,10 @@ class LARS
    * necessary (i.e., you want to pass in a row-major matrix), pass 'false' for
    * the transposeData parameter.
    *
+   * This method may be called many times on the same object; the solution
+   * path, active set, and Cholesky factor of the previous call are cleared,
+   * and the Gram matrix is reused if it has the right size.
+   *
    * @param data Column-major input data (or row-major input data if rowMajor =
    *     true).
    * @param responses A vector of targets.
@@ -46,6 +46,17 @@ LinearRegression::LinearRegression(const arma::mat& predictors,
     r =  sqrt(weights) % responses;
   }
 
+  // Accumulate the normal-equation terms, so that the model can be cheaply
+  // retrained when new points are appended later.  The intercept row is not
+  // penalized.
+  xtx = p * arma::trans(p);
+  xty = p * r;
+  if (lambda != 0.0)
+  {
+    for (size_t i = (intercept ? 1 : 0); i < xtx.n_rows; ++i)
+      xtx(i, i) += lambda;
+  }
+
   if (lambda != 0.0)
   {
     // Add the identity matrix to the predictors (this is equivalent to ridge
@@ -88,9 +99,49 @@ LinearRegression::LinearRegression(const std::string& filename) :
 
 LinearRegression::LinearRegression(const LinearRegression& linearRegression) :
     parameters(linearRegression.parameters),
-    lambda(linearRegression.lambda)
+    lambda(linearRegression.lambda),
+    intercept(linearRegression.intercept),
+    xtx(linearRegression.xtx),
+    xty(linearRegression.xty)
 { /* Nothing to do. */ }
 
+void LinearRegression::Append(const arma::mat& predictors,
+                              const arma::vec& responses,
+                              const arma::vec& weights)
+{
+  // The normal-equation terms are only available if the model was trained
+  // with data.
+  if (xtx.n_elem == 0)
+  {
+    Log::Fatal << "LinearRegression::Append(): the model was not trained with "
+        << "data, so new points cannot be appended to it." << std::endl;
+  }
+
+  arma::mat p = predictors;
+  arma::vec r = responses;
+
+  // Here we add the row of ones to the new predictors, as in the constructor.
+  if (intercept)
+  {
+    p.insert_rows(0, arma::ones<arma::mat>(1, predictors.n_cols));
+  }
+
+  if (weights.n_elem > 0)
+  {
+    p = p * diagmat(sqrt(weights));
+    r = sqrt(weights) % responses;
+  }
+
+  // Fold the new points into the accumulated normal-equation terms, then
+  // re-solve.  The solve works on the square system of size equal to the
+  // dimensionality, so the cost of retraining does not depend on the number
+  // of points seen before.
+  xtx += p * arma::trans(p);
+  xty += p * r;
+
+  arma::solve(parameters, xtx, xty);
+}
+
 void LinearRegression::Predict(const arma::mat& points, arma::vec& predictions)
     const
 {
@@ -56,6 +56,22 @@ class LinearRegression
    */
   LinearRegression() { }
 
+  /**
+   * Append new points to the model and retrain.  The model maintains the
+   * normal-equation terms X^T X and X^T y, so folding in new points and
+   * re-solving costs time proportional to the number of new points and the
+   * dimensionality -- not the number of points the model has already seen.
+   * The model must have been trained with data (not loaded from a parameters
+   * file) for this to be possible.
+   *
+   * @param predictors X, matrix of new data points.
+   * @param responses y, the measured data for each new point.
+   * @param weights observation weights for the new points
+   */
+  void Append(const arma::mat& predictors,
+              const arma::vec& responses,
+              const arma::vec& weights = arma::vec());
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -110,6 +126,14 @@ class LinearRegression
   double lambda;
   //! Indicates whether first parameter is intercept.
   bool intercept;
+  /**
+   * Accumulated normal-equation matrix X^T X (including the intercept row and
+   * the ridge penalty, if any), maintained so that the model can be cheaply
+   * retrained when new points are appended.
+   */
+  arma::mat xtx;
+  //! Accumulated right-hand side X^T y of the normal equations.
+  arma::vec xty;
 };
 
 }; // namespace linear_regression
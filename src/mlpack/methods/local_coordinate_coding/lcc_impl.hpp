@@ -97,14 +97,23 @@ void LocalCoordinateCoding<DictionaryInitializer>::Encode(
 template<typename DictionaryInitializer>
 void LocalCoordinateCoding<DictionaryInitializer>::OptimizeCode()
 {
-  arma::mat invSqDists = 1.0 / (repmat(trans(sum(square(dictionary))), 1,
-      data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
-      * data);
+  // Squared distances from every atom to every point, computed once for this
+  // alternation with a single gemm.
+  arma::mat sqDists;
+  math::PairwiseDistances(dictionary, data, sqDists);
+
+  arma::mat invSqDists = 1.0 / sqDists;
 
   arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
-  for (size_t i = 0; i < data.n_cols; i++)
+  // Each point is coded independently, so the loop can be parallelized.  The
+  // weighted dictionary and Gram matrix differ for every point, so unlike
+  // sparse coding, the LARS solver cannot be hoisted out of the loop.  The
+  // number of LARS steps varies between points, so use dynamic scheduling.
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (long i = 0; i < (long) data.n_cols; i++)
   {
     // report progress
     if ((i % 100) == 0)
@@ -63,7 +63,7 @@ class LogisticRegression
    *
    * @param optimizer Instantiated optimizer with instantiated error function.
    */
-  LogisticRegression(OptimizerType<LogisticRegressionFunction>& optimizer);
+  LogisticRegression(OptimizerType<LogisticRegressionFunction<> >& optimizer);
 
   /**
    * Construct a logistic regression model from the given parameters, without
@@ -93,6 +93,11 @@ class LogisticRegression
    * the decision boundary, the response is taken to be 1; otherwise, it is 0.
    * By default the decision boundary is 0.5.
    *
+   * If the responses vector is already of the correct length, it is reused
+   * without reallocation, and the internal scratch vector is likewise reused,
+   * so predicting many same-sized batches performs no allocation after the
+   * first call.
+   *
    * @param predictors Input predictors.
    * @param responses Vector to put output predictions of responses into.
    * @param decisionBoundary Decision boundary (default 0.5).
@@ -138,6 +143,11 @@ class LogisticRegression
   arma::vec parameters;
   //! L2-regularization penalty parameter.
   double lambda;
+  //! Scratch vector of decision values used by Predict().  Kept as a
+  //! (mutable) member so that repeated predictions do not reallocate it.
+  mutable arma::vec decisionScores;
+  //! Scratch vector of predictions used by ComputeAccuracy().
+  mutable arma::vec predictionsBuffer;
 };
 
 }; // namespace regression
@@ -18,15 +18,20 @@ namespace regression {
  * The log-likelihood function for the logistic regression objective function.
  * This is used by various mlpack optimizers to train a logistic regression
  * model.
+ *
+ * @tparam MatType Type of the predictor matrix (arma::mat or arma::sp_mat).
+ *     A specialization for sparse predictors evaluates the objective and
+ *     gradient over the nonzero elements only; see below.
  */
+template<typename MatType = arma::mat>
 class LogisticRegressionFunction
 {
  public:
-  LogisticRegressionFunction(const arma::mat& predictors,
+  LogisticRegressionFunction(const MatType& predictors,
                              const arma::vec& responses,
                              const double lambda = 0);
 
-  LogisticRegressionFunction(const arma::mat& predictors,
+  LogisticRegressionFunction(const MatType& predictors,
                              const arma::vec& responses,
                              const arma::mat& initialPoint,
                              const double lambda = 0);
@@ -42,7 +47,7 @@ class LogisticRegressionFunction
   double& Lambda() { return lambda; }
 
   //! Return the matrix of predictors.
-  const arma::mat& Predictors() const { return predictors; }
+  const MatType& Predictors() const { return predictors; }
   //! Return the vector of responses.
   const arma::vec& Responses() const { return responses; }
 
@@ -75,6 +80,22 @@ class LogisticRegressionFunction
    */
   double Evaluate(const arma::mat& parameters, const size_t i) const;
 
+  /**
+   * Evaluate the logistic regression log-likelihood function with the given
+   * parameters, using a contiguous mini-batch of points.  This is a middle
+   * ground between the full-batch and single-point overloads: the batch is
+   * processed with one matrix-vector product, and the regularization term is
+   * scaled so that the sum of the objectives of all batches is equal to the
+   * full-batch objective.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters.
@@ -84,6 +105,23 @@ class LogisticRegressionFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, with respect to a contiguous mini-batch of
+   * points.  The batch is processed with two matrix-vector products, and the
+   * regularization term is scaled so that the sum of the gradients of all
+   * batches is equal to the full-batch gradient.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param gradient Vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one point in the
@@ -108,7 +146,171 @@ class LogisticRegressionFunction
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
   //! The matrix of data points (predictors).
-  const arma::mat& predictors;
+  const MatType& predictors;
+  //! The vector of responses to the input data points.
+  const arma::vec& responses;
+  //! The regularization parameter for L2-regularization.
+  double lambda;
+};
+
+/**
+ * A specialization of the logistic regression function for sparse predictors,
+ * such as hashed one-hot features with a handful of nonzeros in millions of
+ * dimensions.  Every evaluation touches only the nonzero elements of the
+ * points involved, so the cost of an SGD step depends on the number of active
+ * features of the sampled point, not on the dimensionality.
+ *
+ * Two things differ from the dense implementation.  First, the class declares
+ * a sparse GradientType, so that optimizers which honor it (such as SGD)
+ * update only the active coordinates of the sampled point.  Second, the
+ * single-point overloads regularize only the active coordinates of the point
+ * (the "lazy" regularization customary for sparse stochastic training);
+ * touching the whole dense parameter vector per point would defeat the
+ * purpose of the specialization.  The full-batch and mini-batch overloads use
+ * the exact regularizer.
+ */
+template<>
+class LogisticRegressionFunction<arma::sp_mat>
+{
+ public:
+  //! Sparse per-point gradients; optimizers which honor this type update
+  //! only the active coordinates.
+  typedef arma::sp_mat GradientType;
+
+  LogisticRegressionFunction(const arma::sp_mat& predictors,
+                             const arma::vec& responses,
+                             const double lambda = 0);
+
+  LogisticRegressionFunction(const arma::sp_mat& predictors,
+                             const arma::vec& responses,
+                             const arma::mat& initialPoint,
+                             const double lambda = 0);
+
+  //! Return the initial point for the optimization.
+  const arma::mat& InitialPoint() const { return initialPoint; }
+  //! Modify the initial point for the optimization.
+  arma::mat& InitialPoint() { return initialPoint; }
+
+  //! Return the regularization parameter (lambda).
+  const double& Lambda() const { return lambda; }
+  //! Modify the regularization parameter (lambda).
+  double& Lambda() { return lambda; }
+
+  //! Return the matrix of predictors.
+  const arma::sp_mat& Predictors() const { return predictors; }
+  //! Return the vector of responses.
+  const arma::vec& Responses() const { return responses; }
+
+  /**
+   * Evaluate the logistic regression log-likelihood function with the given
+   * parameters, accumulating the exponents over the nonzero elements of the
+   * predictors.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   */
+  double Evaluate(const arma::mat& parameters) const;
+
+  /**
+   * Evaluate the logistic regression log-likelihood function with the given
+   * parameters, but using only one data point.  Only the nonzero elements of
+   * the point are touched; accordingly, the regularization term covers only
+   * the active coordinates of the point (see the class comment).
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param i Index of point to use for objective function evaluation.
+   */
+  double Evaluate(const arma::mat& parameters, const size_t i) const;
+
+  /**
+   * Evaluate the logistic regression log-likelihood function with the given
+   * parameters, using a contiguous mini-batch of points.  The regularization
+   * term is exact, scaled so that the sum over all batches is equal to the
+   * full-batch objective.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, accumulating over the nonzero elements of the
+   * predictors.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param gradient Vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
+
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, with respect to a contiguous mini-batch of
+   * points.  The regularization term is exact, scaled so that the sum over
+   * all batches is equal to the full-batch gradient.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param gradient Vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
+
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, and with respect to only one point in the
+   * dataset.  The nonzero entries of the output are the intercept and the
+   * active coordinates of the point; the regularization covers the active
+   * coordinates only (see the class comment).
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param i Index of points to use for objective function gradient evaluation.
+   * @param gradient Dense vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::mat& gradient) const;
+
+  /**
+   * Sparse form of the single-point gradient, holding only the intercept and
+   * the active coordinates of the point.  Optimizers which honor the
+   * GradientType typedef (such as SGD) call this overload, so their parameter
+   * updates touch only the active coordinates.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param i Index of points to use for objective function gradient evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::sp_mat& gradient) const;
+
+  //! Return the initial point for the optimization.
+  const arma::mat& GetInitialPoint() const { return initialPoint; }
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return predictors.n_cols; }
+
+ private:
+  /**
+   * Compute the decision function value (intercept plus the dot product of
+   * the point with the non-intercept parameters) of the given point, touching
+   * only its nonzero elements.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param i Index of the point.
+   */
+  double PointExponent(const arma::mat& parameters, const size_t i) const;
+
+  //! The initial point, from which to start the optimization.
+  arma::mat initialPoint;
+  //! The matrix of data points (predictors).
+  const arma::sp_mat& predictors;
   //! The vector of responses to the input data points.
   const arma::vec& responses;
   //! The regularization parameter for L2-regularization.
@@ -118,4 +320,7 @@ class LogisticRegressionFunction
 }; // namespace regression
 }; // namespace mlpack
 
+// Include implementation.
+#include "logistic_regression_function_impl.hpp"
+
 #endif // __MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_FUNCTION_HPP
@@ -0,0 +1,478 @@
+/**
+ * @file logistic_regression_function_impl.hpp
+ * @author Sumedh Ghaisas
+ *
+ * Implementation of the LogisticRegressionFunction class.
+ */
+#ifndef __MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_FUNCTION_IMPL_HPP
+#define __MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "logistic_regression_function.hpp"
+
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
+    const MatType& predictors,
+    const arma::vec& responses,
+    const double lambda) :
+    predictors(predictors),
+    responses(responses),
+    lambda(lambda)
+{
+  initialPoint = arma::zeros<arma::mat>(predictors.n_rows + 1, 1);
+}
+
+template<typename MatType>
+LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
+    const MatType& predictors,
+    const arma::vec& responses,
+    const arma::mat& initialPoint,
+    const double lambda) :
+    initialPoint(initialPoint),
+    predictors(predictors),
+    responses(responses),
+    lambda(lambda)
+{
+  //to check if initialPoint is compatible with predictors
+  if (initialPoint.n_rows != (predictors.n_rows + 1) ||
+      initialPoint.n_cols != 1)
+    this->initialPoint = arma::zeros<arma::mat>(predictors.n_rows + 1, 1);
+}
+
+/**
+ * Evaluate the logistic regression objective function given the estimated
+ * parameters.
+ */
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
+{
+  // The objective function is the log-likelihood function (w is the parameters
+  // vector for the model; y is the responses; x is the predictors; sig() is the
+  // sigmoid function):
+  //   f(w) = sum(y log(sig(w'x)) + (1 - y) log(sig(1 - w'x))).
+  // We want to minimize this function.  L2-regularization is just lambda
+  // multiplied by the squared l2-norm of the parameters then divided by two.
+
+  // For the regularization, we ignore the first term, which is the intercept
+  // term.
+  const double regularization = 0.5 * lambda *
+      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
+                parameters.col(0).subvec(1, parameters.n_elem - 1));
+
+  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
+  // does not need to be multiplied by any of the predictors.
+  const arma::vec exponents = parameters(0, 0) + predictors.t() *
+      parameters.col(0).subvec(1, parameters.n_elem - 1);
+  const arma::vec sigmoid = 1.0 / (1.0 + arma::exp(-exponents));
+
+  // Assemble full objective function.  Often the objective function and the
+  // regularization as given are divided by the number of features, but this
+  // doesn't actually affect the optimization result, so we'll just ignore those
+  // terms for computational efficiency.
+  double result = 0.0;
+  for (size_t i = 0; i < responses.n_elem; ++i)
+  {
+    if (responses[i] == 1)
+      result += log(sigmoid[i]);
+    else
+      result += log(1.0 - sigmoid[i]);
+  }
+
+  // Invert the result, because it's a minimization.
+  return -result + regularization;
+}
+
+/**
+ * Evaluate the logistic regression objective function, but with only one point.
+ * This is useful for optimizers that use a separable objective function, such
+ * as SGD.
+ */
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t i) const
+{
+  // Calculate the regularization term.  We must divide by the number of points,
+  // so that sum(Evaluate(parameters, [1:points])) == Evaluate(parameters).
+  const double regularization = lambda * (1.0 / (2.0 * predictors.n_cols)) *
+      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
+                parameters.col(0).subvec(1, parameters.n_elem - 1));
+
+  // Calculate sigmoid.
+  const double exponent = parameters(0, 0) + arma::dot(predictors.col(i),
+      parameters.col(0).subvec(1, parameters.n_elem - 1));
+  const double sigmoid = 1.0 / (1.0 + std::exp(-exponent));
+
+  if (responses[i] == 1)
+    return -log(sigmoid) + regularization;
+  else
+    return -log(1.0 - sigmoid) + regularization;
+}
+
+/**
+ * Evaluate the logistic regression objective function for a contiguous
+ * mini-batch of points.
+ */
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize) const
+{
+  // Calculate the regularization term, scaled by the fraction of the dataset
+  // in this batch, so that the sum of the objectives of all batches is the
+  // full-batch objective.
+  const double regularization = lambda *
+      ((double) batchSize / (2.0 * predictors.n_cols)) *
+      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
+                parameters.col(0).subvec(1, parameters.n_elem - 1));
+
+  // Calculate vectors of sigmoids for the batch, with one matrix-vector
+  // product.
+  const arma::vec exponents = parameters(0, 0) +
+      predictors.cols(begin, begin + batchSize - 1).t() *
+      parameters.col(0).subvec(1, parameters.n_elem - 1);
+  const arma::vec sigmoid = 1.0 / (1.0 + arma::exp(-exponents));
+
+  double result = 0.0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    if (responses[begin + i] == 1)
+      result += log(sigmoid[i]);
+    else
+      result += log(1.0 - sigmoid[i]);
+  }
+
+  // Invert the result, because it's a minimization.
+  return -result + regularization;
+}
+
+//! Evaluate the gradient of the logistic regression objective function.
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+#ifdef _OPENMP
+  // Accumulate mini-batch gradients over contiguous column slices in
+  // parallel.  Each slice is a pair of matrix-vector products, and the batch
+  // regularization terms sum to the full regularization term.
+  const long batchSize = 4096;
+
+  gradient = arma::zeros<arma::mat>(parameters.n_elem, 1);
+
+  #pragma omp parallel
+  {
+    arma::mat threadGradient = arma::zeros<arma::mat>(parameters.n_elem, 1);
+    arma::mat batchGradient;
+
+    #pragma omp for schedule(static) nowait
+    for (long begin = 0; begin < (long) predictors.n_cols; begin += batchSize)
+    {
+      const size_t size = std::min((size_t) batchSize,
+          (size_t) (predictors.n_cols - begin));
+      Gradient(parameters, (size_t) begin, size, batchGradient);
+      threadGradient += batchGradient;
+    }
+
+    #pragma omp critical
+    {
+      gradient += threadGradient;
+    }
+  }
+#else
+  // Regularization term.
+  arma::mat regularization;
+  regularization = lambda * parameters.col(0).subvec(1, parameters.n_elem - 1);
+
+  const arma::vec sigmoids = 1 / (1 + arma::exp(-parameters(0, 0)
+      - predictors.t() * parameters.col(0).subvec(1, parameters.n_elem - 1)));
+
+  gradient.set_size(parameters.n_elem);
+  gradient[0] = -arma::accu(responses - sigmoids);
+  gradient.col(0).subvec(1, parameters.n_elem - 1) = -predictors * (responses -
+      sigmoids) + regularization;
+#endif
+}
+
+/**
+ * Evaluate the gradient of the logistic regression objective function for a
+ * contiguous mini-batch of points.
+ */
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& gradient) const
+{
+  // Regularization term, scaled by the fraction of the dataset in this batch.
+  arma::mat regularization;
+  regularization = lambda * ((double) batchSize / predictors.n_cols) *
+      parameters.col(0).subvec(1, parameters.n_elem - 1);
+
+  const arma::vec sigmoids = 1 / (1 + arma::exp(-parameters(0, 0)
+      - predictors.cols(begin, begin + batchSize - 1).t() *
+        parameters.col(0).subvec(1, parameters.n_elem - 1)));
+  const arma::vec diffs = responses.subvec(begin, begin + batchSize - 1)
+      - sigmoids;
+
+  gradient.set_size(parameters.n_elem);
+  gradient[0] = -arma::accu(diffs);
+  gradient.col(0).subvec(1, parameters.n_elem - 1) =
+      -predictors.cols(begin, begin + batchSize - 1) * diffs + regularization;
+}
+
+/**
+ * Evaluate the individual gradients of the logistic regression objective
+ * function with respect to individual points.  This is useful for optimizers
+ * that use a separable objective function, such as SGD.
+ */
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t i,
+    arma::mat& gradient) const
+{
+  // Calculate the regularization term.
+  arma::mat regularization;
+  regularization = lambda * parameters.col(0).subvec(1, parameters.n_elem - 1)
+      / predictors.n_cols;
+
+  const double sigmoid = 1.0 / (1.0 + std::exp(-parameters(0, 0)
+      - arma::dot(predictors.col(i), parameters.col(0).subvec(1,
+      parameters.n_elem - 1))));
+
+  gradient.set_size(parameters.n_elem);
+  gradient[0] = -(responses[i] - sigmoid);
+  gradient.col(0).subvec(1, parameters.n_elem - 1) = -predictors.col(i)
+      * (responses[i] - sigmoid) + regularization;
+}
+
+//
+// Sparse specialization.  Every pass below runs over the nonzero elements of
+// the predictors, so nothing costs more than the number of active features.
+//
+
+inline LogisticRegressionFunction<arma::sp_mat>::LogisticRegressionFunction(
+    const arma::sp_mat& predictors,
+    const arma::vec& responses,
+    const double lambda) :
+    predictors(predictors),
+    responses(responses),
+    lambda(lambda)
+{
+  initialPoint = arma::zeros<arma::mat>(predictors.n_rows + 1, 1);
+}
+
+inline LogisticRegressionFunction<arma::sp_mat>::LogisticRegressionFunction(
+    const arma::sp_mat& predictors,
+    const arma::vec& responses,
+    const arma::mat& initialPoint,
+    const double lambda) :
+    initialPoint(initialPoint),
+    predictors(predictors),
+    responses(responses),
+    lambda(lambda)
+{
+  //to check if initialPoint is compatible with predictors
+  if (initialPoint.n_rows != (predictors.n_rows + 1) ||
+      initialPoint.n_cols != 1)
+    this->initialPoint = arma::zeros<arma::mat>(predictors.n_rows + 1, 1);
+}
+
+inline double LogisticRegressionFunction<arma::sp_mat>::PointExponent(
+    const arma::mat& parameters,
+    const size_t i) const
+{
+  double exponent = parameters(0, 0);
+  for (arma::sp_mat::const_col_iterator it = predictors.begin_col(i);
+       it != predictors.end_col(i); ++it)
+    exponent += (*it) * parameters(it.row() + 1, 0);
+  return exponent;
+}
+
+inline double LogisticRegressionFunction<arma::sp_mat>::Evaluate(
+    const arma::mat& parameters) const
+{
+  // The regularization ignores the intercept term, as in the dense
+  // implementation.
+  const double regularization = 0.5 * lambda *
+      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
+                parameters.col(0).subvec(1, parameters.n_elem - 1));
+
+  // Accumulate the exponent of every point with one pass over the nonzero
+  // elements of the predictors.
+  arma::vec exponents(predictors.n_cols);
+  exponents.fill(parameters(0, 0));
+  for (arma::sp_mat::const_iterator it = predictors.begin();
+       it != predictors.end(); ++it)
+    exponents[it.col()] += (*it) * parameters(it.row() + 1, 0);
+
+  const arma::vec sigmoid = 1.0 / (1.0 + arma::exp(-exponents));
+
+  double result = 0.0;
+  for (size_t i = 0; i < responses.n_elem; ++i)
+  {
+    if (responses[i] == 1)
+      result += log(sigmoid[i]);
+    else
+      result += log(1.0 - sigmoid[i]);
+  }
+
+  // Invert the result, because it's a minimization.
+  return -result + regularization;
+}
+
+inline double LogisticRegressionFunction<arma::sp_mat>::Evaluate(
+    const arma::mat& parameters,
+    const size_t i) const
+{
+  // Regularize only the active coordinates of the point, so the evaluation
+  // touches nothing but the nonzero elements (see the class comment).
+  double regularization = 0.0;
+  for (arma::sp_mat::const_col_iterator it = predictors.begin_col(i);
+       it != predictors.end_col(i); ++it)
+  {
+    const double value = parameters(it.row() + 1, 0);
+    regularization += value * value;
+  }
+  regularization *= lambda / (2.0 * predictors.n_cols);
+
+  const double sigmoid = 1.0 /
+      (1.0 + std::exp(-PointExponent(parameters, i)));
+
+  if (responses[i] == 1)
+    return -log(sigmoid) + regularization;
+  else
+    return -log(1.0 - sigmoid) + regularization;
+}
+
+inline double LogisticRegressionFunction<arma::sp_mat>::Evaluate(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize) const
+{
+  // The exact regularization term is O(dimensions), but a batch amortizes it;
+  // it is scaled so that the sum over all batches is the full-batch
+  // objective.
+  const double regularization = lambda *
+      ((double) batchSize / (2.0 * predictors.n_cols)) *
+      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
+                parameters.col(0).subvec(1, parameters.n_elem - 1));
+
+  double result = 0.0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const double sigmoid = 1.0 /
+        (1.0 + std::exp(-PointExponent(parameters, begin + i)));
+
+    if (responses[begin + i] == 1)
+      result += log(sigmoid);
+    else
+      result += log(1.0 - sigmoid);
+  }
+
+  // Invert the result, because it's a minimization.
+  return -result + regularization;
+}
+
+inline void LogisticRegressionFunction<arma::sp_mat>::Gradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  // Accumulate the exponent of every point with one pass over the nonzero
+  // elements of the predictors.
+  arma::vec exponents(predictors.n_cols);
+  exponents.fill(parameters(0, 0));
+  for (arma::sp_mat::const_iterator it = predictors.begin();
+       it != predictors.end(); ++it)
+    exponents[it.col()] += (*it) * parameters(it.row() + 1, 0);
+
+  const arma::vec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
+  const arma::vec diffs = responses - sigmoids;
+
+  // Start from the (exact) regularization term, then accumulate the
+  // likelihood part over the nonzero elements.
+  gradient.set_size(parameters.n_elem, 1);
+  gradient[0] = -arma::accu(diffs);
+  gradient.col(0).subvec(1, parameters.n_elem - 1) =
+      lambda * parameters.col(0).subvec(1, parameters.n_elem - 1);
+  for (arma::sp_mat::const_iterator it = predictors.begin();
+       it != predictors.end(); ++it)
+    gradient[it.row() + 1] -= (*it) * diffs[it.col()];
+}
+
+inline void LogisticRegressionFunction<arma::sp_mat>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& gradient) const
+{
+  // Start from the regularization term, scaled by the fraction of the
+  // dataset in this batch, then accumulate the likelihood part over the
+  // nonzero elements of the batch columns.
+  gradient.set_size(parameters.n_elem, 1);
+  gradient[0] = 0.0;
+  gradient.col(0).subvec(1, parameters.n_elem - 1) =
+      lambda * ((double) batchSize / predictors.n_cols) *
+      parameters.col(0).subvec(1, parameters.n_elem - 1);
+
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const double sigmoid = 1.0 /
+        (1.0 + std::exp(-PointExponent(parameters, begin + i)));
+    const double diff = responses[begin + i] - sigmoid;
+
+    gradient[0] -= diff;
+    for (arma::sp_mat::const_col_iterator it = predictors.begin_col(begin + i);
+         it != predictors.end_col(begin + i); ++it)
+      gradient[it.row() + 1] -= (*it) * diff;
+  }
+}
+
+inline void LogisticRegressionFunction<arma::sp_mat>::Gradient(
+    const arma::mat& parameters,
+    const size_t i,
+    arma::mat& gradient) const
+{
+  const double sigmoid = 1.0 /
+      (1.0 + std::exp(-PointExponent(parameters, i)));
+
+  // Only the intercept and the active coordinates of the point are nonzero;
+  // the regularization covers the active coordinates only (see the class
+  // comment).
+  gradient.zeros(parameters.n_elem, 1);
+  gradient[0] = -(responses[i] - sigmoid);
+  for (arma::sp_mat::const_col_iterator it = predictors.begin_col(i);
+       it != predictors.end_col(i); ++it)
+    gradient[it.row() + 1] = -(*it) * (responses[i] - sigmoid)
+        + (lambda / predictors.n_cols) * parameters(it.row() + 1, 0);
+}
+
+inline void LogisticRegressionFunction<arma::sp_mat>::Gradient(
+    const arma::mat& parameters,
+    const size_t i,
+    arma::sp_mat& gradient) const
+{
+  const double sigmoid = 1.0 /
+      (1.0 + std::exp(-PointExponent(parameters, i)));
+
+  // Same values as the dense single-point overload, but stored sparsely, so
+  // an optimizer applying this gradient touches only the active coordinates.
+  gradient.zeros(parameters.n_elem, 1);
+  gradient(0, 0) = -(responses[i] - sigmoid);
+  for (arma::sp_mat::const_col_iterator it = predictors.begin_col(i);
+       it != predictors.end_col(i); ++it)
+    gradient(it.row() + 1, 0) = -(*it) * (responses[i] - sigmoid)
+        + (lambda / predictors.n_cols) * parameters(it.row() + 1, 0);
+}
+
+}; // namespace regression
+}; // namespace mlpack
+
+#endif // __MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_FUNCTION_IMPL_HPP
@@ -22,8 +22,8 @@ LogisticRegression<OptimizerType>::LogisticRegression(
     parameters(arma::zeros<arma::vec>(predictors.n_rows + 1)),
     lambda(lambda)
 {
-  LogisticRegressionFunction errorFunction(predictors, responses, lambda);
-  OptimizerType<LogisticRegressionFunction> optimizer(errorFunction);
+  LogisticRegressionFunction<> errorFunction(predictors, responses, lambda);
+  OptimizerType<LogisticRegressionFunction<> > optimizer(errorFunction);
 
   // Train the model.
   Timer::Start("logistic_regression_optimization");
@@ -43,9 +43,9 @@ LogisticRegression<OptimizerType>::LogisticRegression(
     parameters(arma::zeros<arma::vec>(predictors.n_rows + 1)),
     lambda(lambda)
 {
-  LogisticRegressionFunction errorFunction(predictors, responses, lambda);
+  LogisticRegressionFunction<> errorFunction(predictors, responses, lambda);
   errorFunction.InitialPoint() = initialPoint;
-  OptimizerType<LogisticRegressionFunction> optimizer(errorFunction);
+  OptimizerType<LogisticRegressionFunction<> > optimizer(errorFunction);
 
   // Train the model.
   Timer::Start("logistic_regression_optimization");
@@ -58,7 +58,7 @@ LogisticRegression<OptimizerType>::LogisticRegression(
 
 template<template<typename> class OptimizerType>
 LogisticRegression<OptimizerType>::LogisticRegression(
-    OptimizerType<LogisticRegressionFunction>& optimizer) :
+    OptimizerType<LogisticRegressionFunction<> >& optimizer) :
     parameters(optimizer.Function().GetInitialPoint()),
     lambda(optimizer.Function().Lambda())
 {
@@ -86,11 +86,18 @@ void LogisticRegression<OptimizerType>::Predict(const arma::mat& predictors,
                                                 const double decisionBoundary)
     const
 {
+  // Calculate the decision value of each point with a single matrix
+  // multiplication; the scratch vector only reallocates when the batch size
+  // changes.
+  decisionScores = predictors.t() * parameters.subvec(1, parameters.n_elem - 1);
+
   // Calculate sigmoid function for each point.  The (1.0 - decisionBoundary)
   // term correctly sets an offset so that floor() returns 0 or 1 correctly.
+  // This is a pure elementwise expression, so it writes straight into the
+  // responses vector, which only reallocates if it is not already the correct
+  // length.
   responses = arma::floor((1.0 / (1.0 + arma::exp(-parameters(0)
-      - predictors.t() * parameters.subvec(1, parameters.n_elem - 1))))
-      + (1.0 - decisionBoundary));
+      - decisionScores))) + (1.0 - decisionBoundary));
 }
 
 template <template<typename> class OptimizerType>
@@ -99,7 +106,7 @@ double LogisticRegression<OptimizerType>::ComputeError(
     const arma::vec& responses) const
 {
   // Construct a new error function.
-  LogisticRegressionFunction newErrorFunction(predictors, responses,
+  LogisticRegressionFunction<> newErrorFunction(predictors, responses,
       lambda);
 
   return newErrorFunction.Evaluate(parameters);
@@ -111,14 +118,13 @@ double LogisticRegression<OptimizerType>::ComputeAccuracy(
     const arma::vec& responses,
     const double decisionBoundary) const
 {
-  // Predict responses using the current model.
-  arma::vec tempResponses;
-  Predict(predictors, tempResponses, decisionBoundary);
+  // Predict responses using the current model, into the reusable buffer.
+  Predict(predictors, predictionsBuffer, decisionBoundary);
 
   // Count the number of responses that were correct.
   size_t count = 0;
   for (size_t i = 0; i < responses.n_elem; i++)
-    if (responses(i) == tempResponses(i))
+    if (responses(i) == predictionsBuffer(i))
       count++;
 
   return (double) (count * 100) / responses.n_rows;
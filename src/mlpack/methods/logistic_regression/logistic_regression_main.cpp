@@ -188,7 +188,7 @@ int main(int argc, char** argv)
   {
     // We need to train the model.  Prepare the optimizers.
     arma::vec responsesVec = responses.unsafe_col(0);
-    LogisticRegressionFunction lrf(regressors, responsesVec, lambda);
+    LogisticRegressionFunction<> lrf(regressors, responsesVec, lambda);
     // Set the initial point, if necessary.
     if (!model.empty())
     {
@@ -199,7 +199,7 @@ int main(int argc, char** argv)
 
     if (optimizerType == "lbfgs")
     {
-      L_BFGS<LogisticRegressionFunction> lbfgsOpt(lrf);
+      L_BFGS<LogisticRegressionFunction<> > lbfgsOpt(lrf);
       lbfgsOpt.MaxIterations() = maxIterations;
       lbfgsOpt.MinGradientNorm() = tolerance;
       Log::Info << "Training model with L-BFGS optimizer." << endl;
@@ -211,7 +211,7 @@ int main(int argc, char** argv)
     }
     else if (optimizerType == "sgd")
     {
-      SGD<LogisticRegressionFunction> sgdOpt(lrf);
+      SGD<LogisticRegressionFunction<> > sgdOpt(lrf);
       sgdOpt.MaxIterations() = maxIterations;
       sgdOpt.Tolerance() = tolerance;
       sgdOpt.StepSize() = stepSize;
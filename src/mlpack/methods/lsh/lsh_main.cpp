@@ -56,6 +56,9 @@ PARAM_STRING("query_file", "File containing query points (optional).", "q", "");
 PARAM_INT("projections", "The number of hash functions for each table", "K",
     10);
 PARAM_INT("tables", "The number of hash tables to be used.", "L", 30);
+PARAM_INT("probes", "The number of additional buckets to probe in each table "
+    "(multi-probe LSH); 0 only inspects the bucket the query hashes to.", "T",
+    0);
 PARAM_DOUBLE("hash_width", "The hash width for the first-level hashing in the "
     "LSH preprocessing. By default, the LSH class automatically estimates a "
     "hash width for its use.", "H", 0.0);
@@ -103,6 +106,7 @@ int main(int argc, char *argv[])
   // Pick up the LSH-specific parameters.
   const size_t numProj = CLI::GetParam<int>("projections");
   const size_t numTables = CLI::GetParam<int>("tables");
+  const size_t numProbes = CLI::GetParam<int>("probes");
   const double hashWidth = CLI::GetParam<double>("hash_width");
 
   arma::Mat<size_t> neighbors;
@@ -139,7 +143,7 @@ int main(int argc, char *argv[])
 
   Log::Info << "Computing " << k << " distance approximate nearest neighbors "
       << endl;
-  allkann->Search(k, neighbors, distances);
+  allkann->Search(k, neighbors, distances, 0 /* all tables */, numProbes);
 
   Log::Info << "Neighbors computed." << endl;
 
@@ -117,13 +117,64 @@ class LSHSearch
    *     available without having to build hashing for every table size.
    *     By default, this is set to zero in which case all tables are
    *     considered.
+   * @param numProbes Number of additional buckets to probe in each table
+   *     (multi-probe LSH).  For each table, the query's own bucket plus the
+   *     numProbes perturbed buckets closest to the query's projection are
+   *     inspected, so fewer tables are needed for the same recall.  By
+   *     default, this is set to zero, in which case only the query's own
+   *     bucket is inspected.
    */
   void Search(const size_t k,
               arma::Mat<size_t>& resultingNeighbors,
               arma::mat& distances,
-              const size_t numTablesToSearch = 0);
+              const size_t numTablesToSearch = 0,
+              const size_t numProbes = 0);
 
-  // Returns a string representation of this object. 
+  /**
+   * Insert new points into the existing hash tables, so that the index can
+   * ingest a stream of points without ever being rebuilt from scratch.  Only
+   * the new points are hashed (with the projections drawn at construction
+   * time); the packed second hash table is then laid out again in a single
+   * pass to make room in the affected buckets.
+   *
+   * The new points are appended to the reference set in place, so the matrix
+   * given at construction time grows by points.n_cols columns (just as the
+   * tree-based methods permute their datasets in place).  If this object was
+   * constructed without a separate query set, the new points thereby also
+   * become queries.  Neighbor indices returned by Search() refer to the
+   * grown set; the new points receive the indices following the old ones.
+   *
+   * @param points Points to insert, one per column.
+   */
+  void Insert(const arma::mat& points);
+
+  /**
+   * Compute the keys of the additional buckets to probe for a query in one
+   * table, in order of increasing distance of the query's projection from
+   * the perturbed bucket (following the multi-probe scheme of Lv et al.,
+   * "Multi-probe LSH: efficient indexing for high-dimensional similarity
+   * search", 2007).  A perturbation moves one or more dimensions of the
+   * query's key to an adjacent value; the sets of perturbations are scored
+   * by the squared distance of the projection from the boundaries they
+   * cross, and the numProbes best valid sets are returned.
+   *
+   * This is called by Search() for each table; it is public so the probing
+   * sequence can be inspected directly.
+   *
+   * @param queryCode The query's key in this table (floored projection).
+   * @param queryCodeNotFloored The query's projection in this table, before
+   *    flooring.
+   * @param numProbes The number of additional keys to generate.
+   * @param additionalProbingBins Matrix to store the additional keys in, one
+   *    per column; it may have fewer than numProbes columns if not enough
+   *    valid perturbation sets exist.
+   */
+  void GetAdditionalProbingBins(const arma::vec& queryCode,
+                                const arma::vec& queryCodeNotFloored,
+                                const size_t numProbes,
+                                arma::mat& additionalProbingBins) const;
+
+  // Returns a string representation of this object.
   std::string ToString() const;
 
  private:
@@ -143,19 +194,47 @@ class LSHSearch
   void BuildHash();
 
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Hash each of the given points into its bucket of the second hash table
+   * in every table.  This is the first-level hashing (projection, offset,
+   * flooring) followed by the second-level hashing, shared by BuildHash()
+   * and Insert().  The tables are processed across threads; each table's
+   * work is dominated by a single matrix-matrix product.
+   *
+   * @param points Points to hash, one per column.
+   * @param secondHashVectors Matrix to store the bucket of each point in
+   *    each table in; it must already be of size points.n_cols x numTables.
+   */
+  void HashPoints(const arma::mat& points,
+                  arma::Mat<size_t>& secondHashVectors) const;
+
+  /**
+   * This function takes a query, looks up its precomputed keys in each of the
+   * hash tables, hashes each key to a bucket of the second hash table, and
+   * collects all the points (if any) in those buckets as the potential
+   * neighbor candidates.  The first-level projections are not computed here;
+   * Search() computes them for a whole block of queries at once (one
+   * matrix-matrix product per table instead of a matrix-vector product per
+   * query per table) and passes them in.
    *
    * @param queryIndex The index of the query currently being processed.
+   * @param projectedQueries For each table to search, the projections of the
+   *    current block of queries into that table (already offset and scaled,
+   *    but not floored), one query per column.
+   * @param blockOffset The index of the query stored in the first column of
+   *    the projectedQueries matrices.
    * @param referenceIndices The list of neighbor candidates obtained from
    *    hashing the query into all the hash tables and eventually into
    *    multiple buckets of the second hash table.
+   * @param numProbes The number of additional perturbed buckets to inspect
+   *    in each table (multi-probe LSH); 0 inspects only the query's own
+   *    bucket.
    */
   void ReturnIndicesFromTable(const size_t queryIndex,
+                              const std::vector<arma::mat>& projectedQueries,
+                              const size_t blockOffset,
                               arma::uvec& referenceIndices,
-                              size_t numTablesToSearch);
+                              const size_t numTablesToSearch,
+                              const size_t numProbes) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -214,15 +293,16 @@ class LSHSearch
   //! Instantiation of the metric.
   metric::SquaredEuclideanDistance metric;
 
-  //! The final hash table; should be (< secondHashSize) x bucketSize.
-  arma::Mat<size_t> secondHashTable;
+  //! The final hash table: the contents of all buckets packed back to back,
+  //! so its length is the total number of (point, bucket) assignments.
+  arma::Col<size_t> secondHashTable;
 
   //! The number of elements present in each hash bucket; should be
   //! secondHashSize.
   arma::Col<size_t> bucketContentSize;
 
-  //! For a particular hash value, points to the row in secondHashTable
-  //! corresponding to this value.  Should be secondHashSize.
+  //! For a particular hash value, points to the offset in secondHashTable at
+  //! which the contents of this bucket start.  Should be secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
   //! The pointer to the nearest neighbor distances.
@@ -9,6 +9,8 @@
 
 #include <mlpack/core.hpp>
 
+#include <queue>
+
 namespace mlpack {
 namespace neighbor {
 
@@ -139,61 +141,159 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
 
 template<typename SortPolicy>
 void LSHSearch<SortPolicy>::
-ReturnIndicesFromTable(const size_t queryIndex,
-                       arma::uvec& referenceIndices,
-                       size_t numTablesToSearch)
+GetAdditionalProbingBins(const arma::vec& queryCode,
+                         const arma::vec& queryCodeNotFloored,
+                         const size_t numProbes,
+                         arma::mat& additionalProbingBins) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
+  if (numProbes == 0)
+  {
+    additionalProbingBins.set_size(numProj, 0);
+    return;
+  }
 
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
-  // vector.
+  // Each dimension of the key can be perturbed either downwards or upwards;
+  // the score of such a perturbation is the squared distance of the query's
+  // projection from the boundary the perturbation crosses, so low-score
+  // perturbations are the most likely to still hold the query's neighbors.
+  arma::vec scores(2 * numProj);
+  arma::Col<size_t> actionDims(2 * numProj);
+  arma::vec actionDeltas(2 * numProj);
 
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; i++)
+  for (size_t j = 0; j < numProj; ++j)
   {
-    allProjInTables.unsafe_col(i) = projections[i].t() *
-        querySet.unsafe_col(queryIndex);
+    // The fractional position of the projection inside its bucket.
+    const double frac = queryCodeNotFloored[j] - queryCode[j];
+
+    actionDims[2 * j] = j;
+    actionDeltas[2 * j] = -1.0;
+    scores[2 * j] = frac * frac;
+
+    actionDims[2 * j + 1] = j;
+    actionDeltas[2 * j + 1] = 1.0;
+    scores[2 * j + 1] = (1.0 - frac) * (1.0 - frac);
   }
-  allProjInTables += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables /= hashWidth;
 
-  // Compute the hash value of each key of the query into a bucket of the
-  // 'secondHashTable' using the 'secondHashWeights'.
-  arma::rowvec hashVec = secondHashWeights.t() * arma::floor(allProjInTables);
+  // Sort the actions by score, so that a perturbation set can be represented
+  // as a set of indices into the sorted order, and the sets can be
+  // enumerated in order of increasing score with a heap and the shift/expand
+  // operations of Lv et al.
+  arma::uvec sortedActions = arma::sort_index(scores);
+
+  typedef std::pair<double, std::vector<size_t> > ProbeCandidate;
+  std::priority_queue<ProbeCandidate, std::vector<ProbeCandidate>,
+      std::greater<ProbeCandidate> > candidates;
+
+  std::vector<size_t> initialSet(1, 0);
+  candidates.push(std::make_pair(scores[sortedActions[0]], initialSet));
+
+  additionalProbingBins.set_size(numProj, numProbes);
+  size_t probe = 0;
+  while ((probe < numProbes) && !candidates.empty())
+  {
+    const ProbeCandidate current = candidates.top();
+    candidates.pop();
+    const std::vector<size_t>& actionSet = current.second;
+
+    // Generate the two successors of this set: "shift" moves the largest
+    // index one step up the sorted order, and "expand" adds the next index.
+    // Together these enumerate every set exactly once.
+    const size_t last = actionSet.back();
+    if (last + 1 < 2 * numProj)
+    {
+      std::vector<size_t> shifted(actionSet);
+      shifted.back() = last + 1;
+      candidates.push(std::make_pair(current.first -
+          scores[sortedActions[last]] + scores[sortedActions[last + 1]],
+          shifted));
+
+      std::vector<size_t> expanded(actionSet);
+      expanded.push_back(last + 1);
+      candidates.push(std::make_pair(current.first +
+          scores[sortedActions[last + 1]], expanded));
+    }
 
-  for (size_t i = 0; i < hashVec.n_elem; i++)
-    hashVec[i] = (double) ((size_t) hashVec[i] % secondHashSize);
+    // A set that perturbs the same dimension twice is not valid (the two
+    // actions would cancel or step two buckets away).
+    bool valid = true;
+    for (size_t i = 1; (i < actionSet.size()) && valid; ++i)
+      for (size_t j = 0; (j < i) && valid; ++j)
+        if (actionDims[sortedActions[actionSet[i]]] ==
+            actionDims[sortedActions[actionSet[j]]])
+          valid = false;
+    if (!valid)
+      continue;
+
+    // Build the perturbed key.
+    additionalProbingBins.col(probe) = queryCode;
+    for (size_t i = 0; i < actionSet.size(); ++i)
+    {
+      additionalProbingBins(actionDims[sortedActions[actionSet[i]]], probe) +=
+          actionDeltas[sortedActions[actionSet[i]]];
+    }
+    ++probe;
+  }
 
-  Log::Assert(hashVec.n_elem == numTablesToSearch);
+  // If the heap ran out of valid sets, shrink the result.
+  if (probe < numProbes)
+    additionalProbingBins.resize(numProj, probe);
+}
 
-  // For all the buckets that the query is hashed into, sequentially
-  // collect the indices in those buckets.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::
+ReturnIndicesFromTable(const size_t queryIndex,
+                       const std::vector<arma::mat>& projectedQueries,
+                       const size_t blockOffset,
+                       arma::uvec& referenceIndices,
+                       const size_t numTablesToSearch,
+                       const size_t numProbes) const
+{
+  // The query's projections into each table were computed by Search() for the
+  // whole block of queries at once; this query's keys are in column
+  // (queryIndex - blockOffset) of each table's projection matrix.
+  const size_t blockColumn = queryIndex - blockOffset;
+
+  // For all the buckets that the query is hashed into (and, with
+  // multi-probe, the additional perturbed buckets of each table),
+  // sequentially collect the indices in those buckets.
   arma::Col<size_t> refPointsConsidered;
   refPointsConsidered.zeros(referenceSet.n_cols);
 
-  for (size_t i = 0; i < hashVec.n_elem; i++) // For all tables.
+  for (size_t i = 0; i < numTablesToSearch; i++) // For all tables.
   {
-    size_t hashInd = (size_t) hashVec[i];
-
-    if (bucketContentSize[hashInd] > 0)
+    // The query's key in this table is the floored projection; with
+    // multi-probe, the keys of the closest perturbed buckets are also
+    // inspected.
+    const arma::vec queryCodeNotFloored =
+        projectedQueries[i].col(blockColumn);
+    const arma::vec queryCode = arma::floor(queryCodeNotFloored);
+
+    arma::mat additionalProbingBins;
+    GetAdditionalProbingBins(queryCode, queryCodeNotFloored, numProbes,
+        additionalProbingBins);
+
+    for (size_t p = 0; p < additionalProbingBins.n_cols + 1; p++)
     {
-      // Pick the indices in the bucket corresponding to 'hashInd'.
-      size_t tableRow = bucketRowInHashTable[hashInd];
-      assert(tableRow < secondHashSize);
-      assert(tableRow < secondHashTable.n_rows);
+      // Probe the query's own bucket first, then the perturbed buckets.
+      const arma::vec code = (p == 0) ? queryCode :
+          arma::vec(additionalProbingBins.col(p - 1));
+
+      // Compute the hash value of the key into a bucket of the
+      // 'secondHashTable' using the 'secondHashWeights'.
+      const double hashValue = arma::dot(secondHashWeights, code);
+      const size_t hashInd = (size_t) hashValue % secondHashSize;
 
-      for (size_t j = 0; j < bucketContentSize[hashInd]; j++)
-        refPointsConsidered[secondHashTable(tableRow, j)]++;
+      if (bucketContentSize[hashInd] > 0)
+      {
+        // Pick the indices in the bucket corresponding to 'hashInd'; its
+        // contents are stored contiguously starting at 'tableOffset'.
+        size_t tableOffset = bucketRowInHashTable[hashInd];
+        assert(tableOffset + bucketContentSize[hashInd] <=
+            secondHashTable.n_elem);
+
+        for (size_t j = 0; j < bucketContentSize[hashInd]; j++)
+          refPointsConsidered[secondHashTable[tableOffset + j]]++;
+      }
     }
   }
 
@@ -206,7 +306,8 @@ void LSHSearch<SortPolicy>::
 Search(const size_t k,
        arma::Mat<size_t>& resultingNeighbors,
        arma::mat& distances,
-       const size_t numTablesToSearch)
+       const size_t numTablesToSearch,
+       const size_t numProbes)
 {
   neighborPtr = &resultingNeighbors;
   distancePtr = &distances;
@@ -221,22 +322,77 @@ Search(const size_t k,
 
   Timer::Start("computing_neighbors");
 
-  // Go through every query point sequentially.
-  for (size_t i = 0; i < querySet.n_cols; i++)
+  // Decide on the number of tables to look into.
+  size_t tablesToSearch = (numTablesToSearch == 0) ? numTables :
+      numTablesToSearch;
+
+  // Sanity check to make sure that the existing number of tables is not
+  // exceeded.
+  if (tablesToSearch > numTables)
+    tablesToSearch = numTables;
+
+  // Go through the query set in blocks.  For each block, the projections of
+  // all its queries into each table are computed as a single matrix-matrix
+  // product (instead of one matrix-vector product per query per table), and
+  // then the queries of the block are processed in parallel.  The block size
+  // bounds the memory spent on the precomputed projections.
+  const size_t blockSize = 1024;
+
+  std::vector<arma::mat> projectedQueries(tablesToSearch);
+  for (size_t blockStart = 0; blockStart < querySet.n_cols;
+       blockStart += blockSize)
   {
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(i, refIndices, numTablesToSearch);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    for (size_t j = 0; j < refIndices.n_elem; j++)
-      BaseCase(i, (size_t) refIndices[j]);
+    const size_t blockEnd = std::min(blockStart + blockSize,
+        (size_t) querySet.n_cols); // One past the last query of the block.
+
+    // Project the whole block into each table, then apply the offsets and
+    // the hash width.
+    for (size_t i = 0; i < tablesToSearch; i++)
+    {
+      projectedQueries[i] = projections[i].t() *
+          querySet.cols(blockStart, blockEnd - 1);
+      projectedQueries[i] += arma::repmat(offsets.unsafe_col(i), 1,
+          blockEnd - blockStart);
+      projectedQueries[i] /= hashWidth;
+    }
+
+    // Each query writes only its own column of the result matrices, so the
+    // queries of the block can be processed across threads; only the
+    // candidate counter has to be combined at the end.
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      size_t threadIndicesReturned = 0;
+
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (long i = (long) blockStart; i < (long) blockEnd; i++)
+      {
+        // Hash every query into every hash table and eventually into the
+        // 'secondHashTable' to obtain the neighbor candidates.
+        arma::uvec refIndices;
+        ReturnIndicesFromTable(i, projectedQueries, blockStart, refIndices,
+            tablesToSearch, numProbes);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        threadIndicesReturned += refIndices.n_elem;
+
+        // Sequentially go through all the candidates and save the best 'k'
+        // candidates.
+        for (size_t j = 0; j < refIndices.n_elem; j++)
+          BaseCase(i, (size_t) refIndices[j]);
+      }
+
+#ifdef _OPENMP
+      #pragma omp critical (lshSearchAccumulate)
+#endif
+      {
+        avgIndicesReturned += threadIndicesReturned;
+      }
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -271,123 +427,214 @@ BuildHash()
   secondHashWeights = arma::floor(arma::randu(numProj) *
                                   (double) secondHashSize);
 
-  // The 'secondHashTable' is initially an empty matrix of size
-  // ('secondHashSize' x 'bucketSize'). But by only filling the buckets
-  // as points land in them allows us to shrink the size of the
-  // 'secondHashTable' at the end of the hashing.
-
-  // Fill the second hash table n = referenceSet.n_cols.  This is because no
-  // point has index 'n' so the presence of this in the bucket denotes that
-  // there are no more points in this bucket.
-  secondHashTable.set_size(secondHashSize, bucketSize);
-  secondHashTable.fill(referenceSet.n_cols);
+  // The 'secondHashTable' holds the contents of all buckets packed back to
+  // back, in order of increasing hash value; 'bucketRowInHashTable' gives the
+  // offset at which each bucket's contents start.  This way the index costs
+  // O(n * numTables) memory regardless of 'secondHashSize', and scanning a
+  // bucket touches contiguous memory.
 
   // Keep track of the size of each bucket in the hash.  At the end of hashing
   // most buckets will be empty.
   bucketContentSize.zeros(secondHashSize);
 
-  // Instead of putting the points in the row corresponding to the bucket, we
-  // chose the next empty row and keep track of the row in which the bucket
-  // lies. This allows us to stack together and slice out the empty buckets at
-  // the end of the hashing.
-  bucketRowInHashTable.set_size(secondHashSize);
-  bucketRowInHashTable.fill(secondHashSize);
-
-  // Keep track of number of non-empty rows in the 'secondHashTable'.
-  size_t numRowsInTable = 0;
-
   // Step II: The offsets for all projections in all tables.
   // Since the 'offsets' are in [0, hashWidth], we obtain the 'offsets'
   // as randu(numProj, numTables) * hashWidth.
   offsets.randu(numProj, numTables);
   offsets *= hashWidth;
 
-  // Step III: Create each hash table in the first level hash one by one and
-  // putting them directly into the 'secondHashTable' for memory efficiency.
+  // Step IV: Obtain the 'numProj' projections for each table.
+
+  // For L2 metric, 2-stable distributions are used, and
+  // the normal Z ~ N(0, 1) is a 2-stable distribution.  The projection
+  // matrices are drawn serially so that the stream of random numbers (and
+  // thus the hash) does not depend on the number of threads.
+  projections.resize(numTables);
   for (size_t i = 0; i < numTables; i++)
+    projections[i].randn(referenceSet.n_rows, numProj);
+
+  // Step V: create the 'numProj'-dimensional key for each point in each
+  // table, and hash each key into a bucket of the second hash.
+  arma::Mat<size_t> secondHashVectors(referenceSet.n_cols, numTables);
+  HashPoints(referenceSet, secondHashVectors);
+
+  // Step VI: Putting the points in the 'secondHashTable' by hashing the key.
+
+  // First, a counting pass: find the size of each bucket, capped at
+  // 'bucketSize' (as before, points hashing to an already-full bucket are
+  // simply dropped).
+  for (size_t i = 0; i < numTables; i++)
+    for (size_t j = 0; j < secondHashVectors.n_rows; j++)
+      if (bucketContentSize[secondHashVectors(j, i)] < bucketSize)
+        bucketContentSize[secondHashVectors(j, i)]++;
+
+  // Now lay the buckets out back to back: the offset of each bucket is the
+  // running sum of the sizes of the buckets before it.
+  bucketRowInHashTable.set_size(secondHashSize);
+  bucketRowInHashTable.fill(secondHashSize);
+  size_t totalSize = 0;
+  size_t numNonEmptyBuckets = 0;
+  for (size_t i = 0; i < secondHashSize; i++)
   {
-    // Step IV: Obtain the 'numProj' projections for each table.
+    if (bucketContentSize[i] > 0)
+    {
+      bucketRowInHashTable[i] = totalSize;
+      totalSize += bucketContentSize[i];
+      numNonEmptyBuckets++;
+    }
+  }
 
-    // For L2 metric, 2-stable distributions are used, and
-    // the normal Z ~ N(0, 1) is a 2-stable distribution.
-    arma::mat projMat;
-    projMat.randn(referenceSet.n_rows, numProj);
+  // Finally, a filling pass: insert each point at the next free position of
+  // its bucket.
+  secondHashTable.set_size(totalSize);
+  arma::Col<size_t> bucketFillCount;
+  bucketFillCount.zeros(secondHashSize);
+  for (size_t i = 0; i < numTables; i++)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_rows; j++)
+    {
+      // This is the bucket number; the point ID is 'j'.
+      const size_t hashInd = secondHashVectors(j, i);
 
-    // Save the projection matrix for querying.
-    projections.push_back(projMat);
+      // Insert the point unless the bucket is full.
+      if (bucketFillCount[hashInd] < bucketContentSize[hashInd])
+      {
+        secondHashTable[bucketRowInHashTable[hashInd] +
+            bucketFillCount[hashInd]] = j;
+        bucketFillCount[hashInd]++;
+      }
+    } // Loop over all points in the reference set.
+  } // Loop over tables.
 
-    // Step V: create the 'numProj'-dimensional key for each point in each
-    // table.
+  Log::Info << "Final hash table size: " << totalSize << " entries in "
+            << numNonEmptyBuckets << " buckets." << std::endl;
+}
 
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::
+HashPoints(const arma::mat& points,
+           arma::Mat<size_t>& secondHashVectors) const
+{
+  // The tables are independent of each other, so they can be processed
+  // across threads; each table's work is dominated by a single matrix-matrix
+  // product.
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+  #endif
+  for (long i = 0; i < (long) numTables; i++)
+  {
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor( (<proj_i, point> + offset_i) / 'hashWidth' ) forall i }
     arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       referenceSet.n_cols);
-    arma::mat hashMat = projMat.t() * referenceSet;
+                                       points.n_cols);
+    arma::mat hashMat = projections[i].t() * points;
     hashMat += offsetMat;
     hashMat /= hashWidth;
 
-    // Step VI: Putting the points in the 'secondHashTable' by hashing the key.
     // Now we hash every key, point ID to its corresponding bucket.
     arma::rowvec secondHashVec = secondHashWeights.t()
       * arma::floor(hashMat);
 
     // This gives us the bucket for the corresponding point ID.
     for (size_t j = 0; j < secondHashVec.n_elem; j++)
-      secondHashVec[j] = (double)((size_t) secondHashVec[j] % secondHashSize);
+      secondHashVectors(j, i) = (size_t) secondHashVec[j] % secondHashSize;
 
-    Log::Assert(secondHashVec.n_elem == referenceSet.n_cols);
+    Log::Assert(secondHashVec.n_elem == points.n_cols);
+  }
+}
 
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVec.n_elem; j++)
-    {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVec[j];
-      // The point ID is 'j'.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::
+Insert(const arma::mat& points)
+{
+  if (points.n_rows != referenceSet.n_rows)
+  {
+    Log::Fatal << "LSHSearch::Insert(): points have dimensionality "
+        << points.n_rows << ", but the reference set has dimensionality "
+        << referenceSet.n_rows << "!" << std::endl;
+  }
 
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      if (bucketContentSize[hashInd] == 0)
-      {
-        // Start a new row for hash.
-        bucketRowInHashTable[hashInd] = numRowsInTable;
-        secondHashTable(numRowsInTable, 0) = j;
+  if (points.n_cols == 0)
+    return; // Nothing to do.
 
-        numRowsInTable++;
-      }
+  const size_t oldSize = referenceSet.n_cols;
+
+  // Hash only the new points; the assignments already stored in
+  // 'secondHashTable' stay valid, because the indices of the old points do
+  // not change.
+  arma::Mat<size_t> secondHashVectors(points.n_cols, numTables);
+  HashPoints(points, secondHashVectors);
+
+  // Append the new points to the reference set.  The set is held by
+  // reference, so this grows the matrix that was handed to the constructor
+  // (see the documentation of Insert()).
+  arma::mat& set = const_cast<arma::mat&>(referenceSet);
+  set.insert_cols(oldSize, points);
+
+  // Counting pass: decide how large each bucket becomes.  As at construction
+  // time, points hashing to an already-full bucket are simply dropped.
+  arma::Col<size_t> oldContentSize = bucketContentSize;
+  for (size_t i = 0; i < numTables; i++)
+    for (size_t j = 0; j < secondHashVectors.n_rows; j++)
+      if (bucketContentSize[secondHashVectors(j, i)] < bucketSize)
+        bucketContentSize[secondHashVectors(j, i)]++;
+
+  // Lay the grown buckets out back to back again.  This single pass over the
+  // index is what makes room in the affected buckets; the packed layout has
+  // no per-bucket slack to append into, so insertion cost is amortized over
+  // the batch.
+  arma::Col<size_t> oldRowInHashTable = bucketRowInHashTable;
+  bucketRowInHashTable.fill(secondHashSize);
+  size_t totalSize = 0;
+  for (size_t i = 0; i < secondHashSize; i++)
+  {
+    if (bucketContentSize[i] > 0)
+    {
+      bucketRowInHashTable[i] = totalSize;
+      totalSize += bucketContentSize[i];
+    }
+  }
 
-      else
+  // Copy each old bucket's contents to its new offset.
+  arma::Col<size_t> newSecondHashTable(totalSize);
+  arma::Col<size_t> bucketFillCount;
+  bucketFillCount.zeros(secondHashSize);
+  for (size_t i = 0; i < secondHashSize; i++)
+  {
+    for (size_t j = 0; j < oldContentSize[i]; j++)
+    {
+      newSecondHashTable[bucketRowInHashTable[i] + j] =
+          secondHashTable[oldRowInHashTable[i] + j];
+    }
+    bucketFillCount[i] = oldContentSize[i];
+  }
+
+  // Filling pass: insert each new point at the next free position of its
+  // bucket, unless the bucket is full.
+  for (size_t i = 0; i < numTables; i++)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_rows; j++)
+    {
+      const size_t hashInd = secondHashVectors(j, i);
+      if (bucketFillCount[hashInd] < bucketContentSize[hashInd])
       {
-        // If bucket is already present in the 'secondHashTable', find the
-        // corresponding row and insert the point ID in this row unless the
-        // bucket is full, in which case, do nothing.
-        if (bucketContentSize[hashInd] < bucketSize)
-          secondHashTable(bucketRowInHashTable[hashInd],
-                          bucketContentSize[hashInd]) = j;
+        newSecondHashTable[bucketRowInHashTable[hashInd] +
+            bucketFillCount[hashInd]] = oldSize + j;
+        bucketFillCount[hashInd]++;
       }
+    }
+  }
 
-      // Increment the count of the points in this bucket.
-      if (bucketContentSize[hashInd] < bucketSize)
-        bucketContentSize[hashInd]++;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
-
-  // Step VII: Condensing the 'secondHashTable'.
-  size_t maxBucketSize = 0;
-  for (size_t i = 0; i < bucketContentSize.n_elem; i++)
-    if (bucketContentSize[i] > maxBucketSize)
-      maxBucketSize = bucketContentSize[i];
+  secondHashTable = newSecondHashTable;
 
-  Log::Info << "Final hash table size: (" << numRowsInTable << " x "
-            << maxBucketSize << ")" << std::endl;
-  secondHashTable.resize(numRowsInTable, maxBucketSize);
+  Log::Info << "LSHSearch::Insert(): inserted " << points.n_cols << " points; "
+      << "hash table now holds " << totalSize << " entries." << std::endl;
 }
 
 template<typename SortPolicy>
@@ -28,6 +28,11 @@ namespace naive_bayes /** The Naive Bayes Classifier. */ {
  * For classifying a data point (x_1, x_2, ..., x_n), it computes the following:
  * arg max_y(P(Y = y)*P(X_1 = x_1 | Y = y) * ... * P(X_n = x_n | Y = y))
  *
+ * The classifier maintains running moments of the training data, so it can be
+ * trained incrementally: after construction, additional labeled points can be
+ * folded in with Update() or UpdateBatch() without retraining on the full
+ * history.
+ *
  * Example use:
  *
  * @code
@@ -51,6 +56,48 @@ class NaiveBayesClassifier
   //! Class probabilities.
   arma::vec probabilities;
 
+  //! Number of training points seen for each class.
+  arma::vec counts;
+
+  //! Summed squared deviations from the mean for each class (the "M2"
+  //! quantity of Welford's algorithm), from which the variances are computed.
+  MatType m2;
+
+  //! Total number of training points seen.
+  size_t trainingPoints;
+
+  //! Cached log of the class probabilities, used by Classify().
+  arma::vec logProbabilities;
+  //! Cached elementwise inverse of the variances, used by Classify().
+  MatType invVariances;
+  //! Cached log of the Gaussian normalization constant of each class.
+  arma::vec logNormalization;
+  //! If true, the cached quantities above must be recomputed before use (the
+  //! model may have been modified since they were last computed).
+  bool cacheStale;
+
+  //! Reusable classification workspace: joint log-probability of each test
+  //! point under each class.  Kept as a member so that repeated calls to
+  //! Classify() do not reallocate it.
+  arma::mat testProbs;
+  //! Reusable classification workspace: difference of a test point from a
+  //! class mean.
+  arma::vec diff;
+
+  /**
+   * Recompute the variances of the given class from the running moments, and
+   * ensure they are invertible.
+   *
+   * @param label Class whose variances should be recomputed.
+   */
+  void FinalizeVariances(const size_t label);
+
+  /**
+   * Recompute the cached quantities used by Classify() (the log-priors, the
+   * inverse variances, and the log-normalization constants).
+   */
+  void RefreshCache();
+
  public:
   /**
    * Initializes the classifier as per the input and then trains it by
@@ -77,9 +124,34 @@ class NaiveBayesClassifier
                        const size_t classes,
                        const bool incrementalVariance = false);
 
+  /**
+   * Update the model with a single additional labeled training point,
+   * maintaining the running moments with Welford's algorithm.  The point must
+   * have the same dimensionality as the training data, and the label must be
+   * smaller than the number of classes.
+   *
+   * @param point Additional training point.
+   * @param label Label of the training point.
+   */
+  template<typename VecType>
+  void Update(const VecType& point, const size_t label);
+
+  /**
+   * Update the model with a batch of additional labeled training points.  This
+   * is equivalent to calling Update() with each point in turn, but the
+   * variances and class probabilities are only recomputed once.
+   *
+   * @param data Additional training points.
+   * @param labels Labels corresponding to the additional training points.
+   */
+  void UpdateBatch(const MatType& data, const arma::Col<size_t>& labels);
+
   /**
    * Given a bunch of data points, this function evaluates the class of each of
-   * those data points, and puts it in the vector 'results'.
+   * those data points, and puts it in the vector 'results'.  If 'results' is
+   * already of the correct length, it is reused without reallocation, and the
+   * internal workspace is likewise reused across calls, so classifying many
+   * same-sized batches performs no allocation after the first call.
    *
    * @code
    * arma::mat test_data; // each column is a test point
@@ -96,17 +168,17 @@ class NaiveBayesClassifier
   //! Get the sample means for each class.
   const MatType& Means() const { return means; }
   //! Modify the sample means for each class.
-  MatType& Means() { return means; }
+  MatType& Means() { cacheStale = true; return means; }
 
   //! Get the sample variances for each class.
   const MatType& Variances() const { return variances; }
   //! Modify the sample variances for each class.
-  MatType& Variances() { return variances; }
+  MatType& Variances() { cacheStale = true; return variances; }
 
   //! Get the prior probabilities for each class.
   const arma::vec& Probabilities() const { return probabilities; }
   //! Modify the prior probabilities for each class.
-  arma::vec& Probabilities() { return probabilities; }
+  arma::vec& Probabilities() { cacheStale = true; return probabilities; }
 };
 
 }; // namespace naive_bayes
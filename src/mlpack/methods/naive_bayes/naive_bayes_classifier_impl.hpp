@@ -31,8 +31,12 @@ NaiveBayesClassifier<MatType>::NaiveBayesClassifier(
   // Update the variables according to the number of features and classes
   // present in the data.
   probabilities.zeros(classes);
+  counts.zeros(classes);
   means.zeros(dimensionality, classes);
   variances.zeros(dimensionality, classes);
+  m2.zeros(dimensionality, classes);
+  trainingPoints = 0;
+  cacheStale = true;
 
   Log::Info << "Training Naive Bayes classifier on " << data.n_cols
       << " examples with " << dimensionality << " features each." << std::endl;
@@ -41,22 +45,9 @@ NaiveBayesClassifier<MatType>::NaiveBayesClassifier(
   // for each of the features with respect to each of the labels.
   if (incrementalVariance)
   {
-    // Use incremental algorithm.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
-
-    for (size_t i = 0; i < classes; ++i)
-    {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
-    }
+    // Use incremental (Welford's) algorithm; this is the same algorithm used
+    // for streaming updates.
+    UpdateBatch(data, labels);
   }
   else
   {
@@ -70,34 +61,104 @@ NaiveBayesClassifier<MatType>::NaiveBayesClassifier(
     for (size_t j = 0; j < data.n_cols; ++j)
     {
       const size_t label = labels[j];
-      ++probabilities[label];
+      ++counts[label];
       means.col(label) += data.col(j);
     }
 
     // Normalize means.
     for (size_t i = 0; i < classes; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+      if (counts[i] != 0.0)
+        means.col(i) /= counts[i];
 
-    // Calculate variances.
+    // Calculate the summed squared deviations from the means.
     for (size_t j = 0; j < data.n_cols; ++j)
     {
       const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      m2.col(label) += square(data.col(j) - means.col(label));
     }
 
+    trainingPoints = data.n_cols;
+
     // Normalize variances.
     for (size_t i = 0; i < classes; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+      FinalizeVariances(i);
+
+    if (trainingPoints > 0)
+      probabilities = counts / trainingPoints;
   }
+}
+
+template<typename MatType>
+template<typename VecType>
+void NaiveBayesClassifier<MatType>::Update(const VecType& point,
+                                           const size_t label)
+{
+  ++counts[label];
+  ++trainingPoints;
+
+  // Update the running moments of the point's class with Welford's algorithm.
+  arma::vec delta = point - means.col(label);
+  means.col(label) += delta / counts[label];
+  m2.col(label) += delta % (point - means.col(label));
+
+  FinalizeVariances(label);
+  probabilities = counts / trainingPoints;
+  cacheStale = true;
+}
+
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::UpdateBatch(
+    const MatType& data,
+    const arma::Col<size_t>& labels)
+{
+  // Update the running moments with each point in turn; the variances and
+  // class probabilities are only recomputed at the end.
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    const size_t label = labels[j];
+    ++counts[label];
+    ++trainingPoints;
+
+    arma::vec delta = data.col(j) - means.col(label);
+    means.col(label) += delta / counts[label];
+    m2.col(label) += delta % (data.col(j) - means.col(label));
+  }
+
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    FinalizeVariances(i);
+
+  if (trainingPoints > 0)
+    probabilities = counts / trainingPoints;
+  cacheStale = true;
+}
+
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::FinalizeVariances(const size_t label)
+{
+  if (counts[label] > 1)
+    variances.col(label) = m2.col(label) / (counts[label] - 1);
+  else
+    variances.col(label) = m2.col(label);
 
   // Ensure that the variances are invertible.
-  for (size_t i = 0; i < variances.n_elem; ++i)
-    if (variances[i] == 0.0)
-      variances[i] = 1e-50;
+  for (size_t i = 0; i < variances.n_rows; ++i)
+    if (variances(i, label) == 0.0)
+      variances(i, label) = 1e-50;
+}
 
-  probabilities /= data.n_cols;
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::RefreshCache()
+{
+  logProbabilities = arma::log(probabilities);
+  invVariances = 1.0 / variances;
+
+  // Log of the normalization constant of each class's Gaussian.
+  logNormalization.set_size(means.n_cols);
+  for (size_t i = 0; i < means.n_cols; ++i)
+    logNormalization[i] = ((double) means.n_rows / -2.0) * log(2 * M_PI) -
+        0.5 * arma::accu(arma::log(invVariances.col(i)));
+
+  cacheStale = false;
 }
 
 template<typename MatType>
@@ -108,11 +169,14 @@ void NaiveBayesClassifier<MatType>::Classify(const MatType& data,
   // training data.
   Log::Assert(data.n_rows == means.n_rows);
 
-  arma::vec probs = arma::log(probabilities);
-  arma::mat invVar = 1.0 / variances;
-
-  arma::mat testProbs = arma::repmat(probs.t(), data.n_cols, 1);
+  // Recompute the log-priors, inverse variances, and normalization constants
+  // only if the model has changed since the last classification.
+  if (cacheStale)
+    RefreshCache();
 
+  // These only reallocate if the batch shape has changed since the last call.
+  testProbs.set_size(data.n_cols, means.n_cols);
+  diff.set_size(data.n_rows);
   results.set_size(data.n_cols); // No need to fill with anything yet.
 
   Log::Info << "Running Naive Bayes classifier on " << data.n_cols
@@ -125,24 +189,30 @@ void NaiveBayesClassifier<MatType>::Classify(const MatType& data,
   for (size_t i = 0; i < means.n_cols; i++)
   {
     // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    arma::mat diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    arma::mat rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::vec exponents(diffs.n_cols);
-    for (size_t j = 0; j < diffs.n_cols; ++j)
-      exponents(j) = std::exp(arma::accu(diffs.col(j) % rhs.unsafe_col(j)));
-
-    testProbs.col(i) += log(pow(2 * M_PI, (double) data.n_rows / -2.0) *
-        pow(det(arma::diagmat(invVar.col(i))), -0.5) * exponents);
+    // a diagonal matrix, evaluated in the log domain so that no per-class
+    // temporaries (or exponentiations) are needed.
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      diff = data.col(j) - means.col(i);
+      testProbs(j, i) = logProbabilities[i] + logNormalization[i] -
+          0.5 * arma::dot(invVariances.col(i), arma::square(diff));
+    }
   }
 
   // Now calculate the label.
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     // Find the index of the class with maximum probability for this point.
-    arma::uword maxIndex = 0;
-    arma::vec pointProbs = testProbs.row(i).t();
-    pointProbs.max(maxIndex);
+    size_t maxIndex = 0;
+    double maxProb = testProbs(i, 0);
+    for (size_t j = 1; j < testProbs.n_cols; ++j)
+    {
+      if (testProbs(i, j) > maxProb)
+      {
+        maxProb = testProbs(i, j);
+        maxIndex = j;
+      }
+    }
 
     results[i] = maxIndex;
   }
@@ -32,6 +32,16 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * The separable Evaluate() and Gradient() scan the entire dataset to compute
+ * the softmax denominator of one point, so even stochastic optimization is
+ * O(n) per iteration.  For large datasets, a sampled mode can be enabled by
+ * setting NumNeighbors() to a nonzero value k; then, the denominator of each
+ * point is approximated using only its k nearest neighbors in the input
+ * space (found once with AllkNN).  Because exp(-d) decays very quickly with
+ * the distance, far-away points contribute almost nothing to the softmax
+ * sums, so moderate values of k give a good approximation at O(k) cost per
+ * iteration.  The sampled mode only affects the separable overloads.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -108,6 +118,13 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors used for the sampled objective (0 means the
+  //! exact objective is used).
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Modify the number of neighbors used for the sampled objective (set to 0
+  //! to use the exact objective).
+  size_t& NumNeighbors() { return numNeighbors; }
+
   // convert the obkect into a string
   std::string ToString() const;
 
@@ -133,6 +150,12 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! Number of neighbors for the sampled objective; 0 means exact.
+  size_t numNeighbors;
+  //! Candidate sets for the sampled objective; column i holds the indices of
+  //! the nearest neighbors of point i in the input space.
+  arma::Mat<size_t> neighborhood;
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
@@ -147,6 +170,13 @@ class SoftmaxErrorFunction
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Build the nearest-neighbor candidate sets for the sampled objective, if
+   * they have not been built for the current value of numNeighbors.  This
+   * runs one AllkNN search on the input dataset.
+   */
+  void BuildNeighborhood();
 };
 
 }; // namespace nca
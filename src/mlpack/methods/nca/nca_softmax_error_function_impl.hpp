@@ -10,6 +10,8 @@
 // In case it hasn't been included already.
 #include "nca_softmax_error_function.hpp"
 
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
 namespace mlpack {
 namespace nca {
 
@@ -22,7 +24,8 @@ SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     dataset(dataset),
     labels(labels),
     metric(metric),
-    precalculated(false)
+    precalculated(false),
+    numNeighbors(0)
 { /* nothing to do */ }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -43,9 +46,41 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
 {
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
+  // In sampled mode, only the candidate set of point i is scanned instead,
+  // so the evaluation takes O(k) time.
   double denominator = 0;
   double numerator = 0;
 
+  if (numNeighbors > 0 && numNeighbors < dataset.n_cols - 1)
+  {
+    BuildNeighborhood();
+
+    // Only the points that are actually used get stretched.
+    const arma::vec stretchedI = coordinates * dataset.col(i);
+    for (size_t j = 0; j < numNeighbors; ++j)
+    {
+      const size_t k = neighborhood(j, i);
+      const arma::vec stretchedK = coordinates * dataset.col(k);
+
+      // We want to evaluate exp(-D(A x_i, A x_k)).
+      double eval = std::exp(-metric.Evaluate(stretchedI, stretchedK));
+
+      if (labels[i] == labels[k])
+        numerator += eval;
+
+      denominator += eval;
+    }
+
+    if (denominator == 0.0)
+    {
+      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+      return 0;
+    }
+
+    return -(numerator / denominator); // Negate because the optimizer is a
+                                       // minimizer.
+  }
+
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
 
@@ -145,33 +180,65 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
   secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
 
-  // Compute the stretched dataset.
-  stretchedDataset = coordinates * dataset;
-
-  for (size_t k = 0; k < dataset.n_cols; ++k)
+  if (numNeighbors > 0 && numNeighbors < dataset.n_cols - 1)
   {
-    // Don't consider the case where the points are the same.
-    if (i == k)
-      continue;
+    // Sampled mode: only the candidate set of point i contributes, so only
+    // those points get stretched.
+    BuildNeighborhood();
 
-    // Calculate the numerator of p_ik.
-    double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                       stretchedDataset.unsafe_col(k)));
-
-    // If the points are in the same class, we must add to the second term of
-    // the gradient as well as the numerator of p_i.  We will divide by the
-    // denominator of p_ik later.  For x_ik we are not using stretched points.
-    arma::vec x_ik = dataset.col(i) - dataset.col(k);
-    if (labels[i] == labels[k])
+    const arma::vec stretchedI = coordinates * dataset.col(i);
+    for (size_t j = 0; j < numNeighbors; ++j)
     {
-      numerator += eval;
-      secondTerm += eval * x_ik * trans(x_ik);
+      const size_t k = neighborhood(j, i);
+      const arma::vec stretchedK = coordinates * dataset.col(k);
+
+      // Calculate the numerator of p_ik.
+      double eval = exp(-metric.Evaluate(stretchedI, stretchedK));
+
+      // For x_ik we are not using stretched points.
+      arma::vec x_ik = dataset.col(i) - dataset.col(k);
+      if (labels[i] == labels[k])
+      {
+        numerator += eval;
+        secondTerm += eval * x_ik * trans(x_ik);
+      }
+
+      denominator += eval;
+      firstTerm += eval * x_ik * trans(x_ik);
     }
+  }
+  else
+  {
+    // Compute the stretched dataset.
+    stretchedDataset = coordinates * dataset;
 
-    // We always have to add to the denominator of p_i and the first term of the
-    // gradient computation.  We will divide by the denominator of p_ik later.
-    denominator += eval;
-    firstTerm += eval * x_ik * trans(x_ik);
+    for (size_t k = 0; k < dataset.n_cols; ++k)
+    {
+      // Don't consider the case where the points are the same.
+      if (i == k)
+        continue;
+
+      // Calculate the numerator of p_ik.
+      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                         stretchedDataset.unsafe_col(k)));
+
+      // If the points are in the same class, we must add to the second term of
+      // the gradient as well as the numerator of p_i.  We will divide by the
+      // denominator of p_ik later.  For x_ik we are not using stretched
+      // points.
+      arma::vec x_ik = dataset.col(i) - dataset.col(k);
+      if (labels[i] == labels[k])
+      {
+        numerator += eval;
+        secondTerm += eval * x_ik * trans(x_ik);
+      }
+
+      // We always have to add to the denominator of p_i and the first term of
+      // the gradient computation.  We will divide by the denominator of p_ik
+      // later.
+      denominator += eval;
+      firstTerm += eval * x_ik * trans(x_ik);
+    }
   }
 
   // Calculate p_i.
@@ -267,6 +334,23 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::BuildNeighborhood()
+{
+  // The candidate sets only need to be rebuilt if the number of neighbors has
+  // changed since they were last built.
+  if (neighborhood.n_rows == numNeighbors)
+    return;
+
+  // The search is done in the input space; the candidate sets then stay fixed
+  // during the optimization.
+  Timer::Start("nca_neighborhood_construction");
+  neighbor::AllkNN knn(dataset);
+  arma::mat neighborDistances;
+  knn.Search(numNeighbors, neighborhood, neighborDistances);
+  Timer::Stop("nca_neighborhood_construction");
+}
+
 template<typename MetricType>
 std::string SoftmaxErrorFunction<MetricType>::ToString() const{
   std::ostringstream convert;
@@ -11,6 +11,8 @@
 #include <fstream>
 #include <iostream>
 
+#include <mlpack/core/data/streaming_writer.hpp>
+
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 
@@ -54,6 +56,76 @@ PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "s");
 PARAM_FLAG("r_tree", "If true, use an R-Tree to perform the search "
     "(experimental, may be slow.).", "T");
+PARAM_INT("stream_block_size", "If greater than 0, process the query set in "
+    "blocks of this many points and append each block's results to the output "
+    "files as it completes, instead of materializing the full result matrices "
+    "in memory.  Requires --query_file; not available with --r_tree.", "B", 0);
+
+/**
+ * Process the query set in blocks against a prebuilt reference tree,
+ * appending each block's results to the output files as it completes, so
+ * result memory is bounded by the block size (see the same scheme in
+ * allknn_main.cpp).
+ */
+template<typename TreeType>
+void StreamingSearch(TreeType& refTree,
+                     const arma::mat& referenceData,
+                     const std::vector<size_t>& oldFromNewRefs,
+                     const arma::mat& queryData,
+                     const size_t k,
+                     const bool singleMode,
+                     const size_t leafSize,
+                     const size_t blockSize,
+                     const string& neighborsFile,
+                     const string& distancesFile)
+{
+  typedef NeighborSearch<FurthestNeighborSort, metric::LMetric<2, true>,
+      TreeType> SearchType;
+
+  data::StreamingWriter<size_t> neighborWriter(neighborsFile);
+  data::StreamingWriter<double> distanceWriter(distancesFile);
+
+  for (size_t begin = 0; begin < queryData.n_cols; begin += blockSize)
+  {
+    const size_t blockCols = std::min(blockSize,
+        (size_t) queryData.n_cols - begin);
+
+    // The tree build rearranges its dataset, so the block is a copy.
+    arma::mat queryBlock = queryData.cols(begin, begin + blockCols - 1);
+
+    std::vector<size_t> oldFromNewQueries;
+    TreeType* queryTree = NULL;
+    if (!singleMode)
+      queryTree = new TreeType(queryBlock, oldFromNewQueries, leafSize);
+
+    SearchType allkfn(&refTree, queryTree, referenceData, queryBlock,
+        singleMode);
+
+    arma::Mat<size_t> neighborsOut;
+    arma::mat distancesOut;
+    allkfn.Search(k, neighborsOut, distancesOut);
+
+    // Map the block's results back to the original point orderings before
+    // they are written out.
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    if (!singleMode)
+      Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewQueries,
+          blockNeighbors, blockDistances);
+    else
+      Unmap(neighborsOut, distancesOut, oldFromNewRefs, blockNeighbors,
+          blockDistances);
+
+    neighborWriter.Append(blockNeighbors);
+    distanceWriter.Append(blockDistances);
+
+    if (queryTree)
+      delete queryTree;
+
+    Log::Info << "Wrote results for queries " << begin << " to "
+        << (begin + blockCols - 1) << "." << endl;
+  }
+}
 
 int main(int argc, char *argv[])
 {
@@ -106,6 +178,27 @@ int main(int argc, char *argv[])
   if (naive)
     leafSize = referenceData.n_cols;
 
+  // Check the streaming-output options.
+  const int streamBlockInt = CLI::GetParam<int>("stream_block_size");
+  if (streamBlockInt < 0)
+    Log::Fatal << "Invalid stream block size: " << streamBlockInt << ".  Must "
+        "be non-negative." << endl;
+  size_t streamBlockSize = streamBlockInt;
+
+  if (streamBlockSize > 0 && CLI::GetParam<string>("query_file") == "")
+  {
+    // Block-wise search cannot reproduce the monochromatic semantics, which
+    // exclude each point from its own result list.
+    Log::Warn << "--stream_block_size ignored: no --query_file given." << endl;
+    streamBlockSize = 0;
+  }
+  if (streamBlockSize > 0 && CLI::HasParam("r_tree"))
+  {
+    Log::Warn << "--stream_block_size ignored: streaming output is not "
+        << "available with --r_tree." << endl;
+    streamBlockSize = 0;
+  }
+
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
@@ -140,6 +233,16 @@ int main(int argc, char *argv[])
       Log::Info << "Loaded query data from '" << queryFile << "' ("
           << queryData.n_rows << " x " << queryData.n_cols << ")." << endl;
 
+      if (streamBlockSize > 0)
+      {
+        Log::Info << "Computing " << k << " furthest neighbors in query "
+            << "blocks of " << streamBlockSize << "..." << endl;
+        StreamingSearch(refTree, referenceData, oldFromNewRefs, queryData, k,
+            singleMode, leafSize, streamBlockSize, neighborsFile,
+            distancesFile);
+        return 0;
+      }
+
       Log::Info << "Building query tree..." << endl;
 
       if (naive && leafSize < queryData.n_cols)
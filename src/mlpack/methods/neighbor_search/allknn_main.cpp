@@ -7,10 +7,14 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/util/profiler.hpp>
 
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+
+#include <mlpack/core/data/streaming_writer.hpp>
 
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
@@ -23,8 +27,8 @@ using namespace mlpack::tree;
 // Information about the program itself.
 PROGRAM_INFO("All K-Nearest-Neighbors",
     "This program will calculate the all k-nearest-neighbors of a set of "
-    "points using kd-trees or cover trees (cover tree support is experimental "
-    "and may be slow). You may specify a separate set of "
+    "points using kd-trees, ball trees, or cover trees (cover tree support is "
+    "experimental and may be slow). You may specify a separate set of "
     "reference points and query points, or just a reference set which will be "
     "used as both the reference and query set."
     "\n\n"
@@ -52,6 +56,9 @@ PARAM_INT_REQ("k", "Number of nearest neighbors to find.", "k");
 PARAM_STRING("query_file", "File containing query points (optional).", "q", "");
 
 PARAM_INT("leaf_size", "Leaf size for tree building.", "l", 20);
+PARAM_DOUBLE("epsilon", "If specified, the search returns approximate nearest "
+    "neighbors with relative error at most epsilon (0 means the search is "
+    "exact).", "e", 0.0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
@@ -59,9 +66,257 @@ PARAM_FLAG("cover_tree", "If true, use cover trees to perform the search "
     "(experimental, may be slow).", "c");
 PARAM_FLAG("r_tree", "If true, use an R-Tree to perform the search "
     "(experimental, may be slow.).", "T");
+PARAM_FLAG("ball_tree", "If true, use a ball tree to perform the search; for "
+    "high-dimensional data, ball bounds may prune better than "
+    "hyperrectangles.", "b");
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
 PARAM_INT("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
+PARAM_FLAG("tree_order", "If true, do not unmap the results to the original "
+    "point ordering; emit neighbors and distances in tree order instead, and "
+    "save the permutations (see --reference_map_file and --query_map_file) so "
+    "that consumers can apply the mapping lazily.  Only meaningful for tree "
+    "types that rearrange the dataset (kd-trees and ball trees).", "t");
+PARAM_STRING("reference_map_file", "If --tree_order is given, file to save "
+    "the reference set permutation into (element i is the original index of "
+    "the point at tree-order index i).", "M", "");
+PARAM_STRING("query_map_file", "If --tree_order is given, file to save the "
+    "query set permutation into (only written when a query tree was built).",
+    "Q", "");
+PARAM_FLAG("tune_leaf_size", "If true, choose the leaf size empirically "
+    "before the full build: trees are built on a sample of the data at "
+    "several candidate leaf sizes, a representative batch of queries is "
+    "timed against each, and the fastest candidate is used (this overrides "
+    "--leaf_size).  Only meaningful for kd-trees and ball trees.", "u");
+PARAM_INT("tune_sample_size", "Number of reference points to sample when "
+    "--tune_leaf_size is given.", "z", 2000);
+PARAM_INT("stream_block_size", "If greater than 0, process the query set in "
+    "blocks of this many points and append each block's results to the output "
+    "files as it completes, instead of materializing the full result matrices "
+    "in memory.  Requires --query_file; only available for kd-trees and ball "
+    "trees.  Streamed results are always emitted in the original query order.",
+    "B", 0);
+
+/**
+ * Save a point index permutation (old index from new index) as a single
+ * column, if a filename was given for the named parameter.
+ */
+void SaveMap(const std::string& paramName, const std::vector<size_t>& map)
+{
+  const std::string file = CLI::GetParam<std::string>(paramName);
+  if (file == "")
+    return;
+
+  arma::Col<size_t> out(map.size());
+  for (size_t i = 0; i < map.size(); ++i)
+    out[i] = map[i];
+
+  data::Save(file, out);
+}
+
+/**
+ * Empirically choose a leaf size: for each candidate, build a kd-tree on a
+ * sample of the reference set, time a batch of representative queries against
+ * it, and return the candidate with the smallest combined build and search
+ * time.  The build time is included because the leaf size changes the tree
+ * size, and on large jobs the build is not free.
+ *
+ * The sample is a random subset, so the measured per-query costs are not the
+ * costs on the full set -- but the ranking of leaf sizes is driven by the
+ * dimensionality and local geometry of the data, which the sample preserves.
+ *
+ * @param referenceData Full reference dataset.
+ * @param queryData Full query dataset (may be empty; the reference sample is
+ *     then queried against itself, matching the monochromatic search).
+ * @param k Number of neighbors that will be searched for.
+ * @param singleMode Whether single-tree search will be used.
+ * @param sampleSize Maximum number of reference points to sample.
+ */
+size_t TuneLeafSize(const arma::mat& referenceData,
+                    const arma::mat& queryData,
+                    const size_t k,
+                    const bool singleMode,
+                    const size_t sampleSize)
+{
+  const size_t candidates[] = { 8, 16, 32, 64, 128 };
+  const size_t numCandidates = 5;
+
+  // Sample the reference set (without replacement, via a shuffle).
+  std::vector<size_t> order(referenceData.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::random_shuffle(order.begin(), order.end());
+
+  const size_t refSamples = std::min(sampleSize,
+      (size_t) referenceData.n_cols);
+
+  // If the sample cannot even hold k neighbors, tuning is meaningless.
+  if (k >= refSamples)
+  {
+    Log::Warn << "Tuning sample (" << refSamples << " points) is too small "
+        << "for k = " << k << "; keeping the default leaf size." << endl;
+    return 20;
+  }
+  arma::mat refSample(referenceData.n_rows, refSamples);
+  for (size_t i = 0; i < refSamples; ++i)
+    refSample.col(i) = referenceData.col(order[i]);
+
+  // A few hundred queries are plenty to rank the candidates.
+  arma::mat querySample;
+  if (queryData.n_cols > 0)
+  {
+    std::vector<size_t> queryOrder(queryData.n_cols);
+    for (size_t i = 0; i < queryOrder.size(); ++i)
+      queryOrder[i] = i;
+    std::random_shuffle(queryOrder.begin(), queryOrder.end());
+
+    const size_t querySamples = std::min((size_t) 300,
+        (size_t) queryData.n_cols);
+    querySample.set_size(queryData.n_rows, querySamples);
+    for (size_t i = 0; i < querySamples; ++i)
+      querySample.col(i) = queryData.col(queryOrder[i]);
+  }
+
+  size_t bestLeafSize = 20; // The default, if no candidate can be timed.
+  uint64_t bestTime = 0;
+  bool haveBest = false;
+
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    // A leaf size at or past the sample size degenerates to a naive scan on
+    // the sample and would not reflect the full build.
+    if (candidates[c] >= refSamples)
+      continue;
+
+    typedef BinarySpaceTree<bound::HRectBound<2>,
+        NeighborSearchStat<NearestNeighborSort> > TreeType;
+
+    // Tree building rearranges the matrices, so work on copies (made outside
+    // the timed region) to keep the candidates comparable.
+    arma::mat refCopy(refSample);
+    arma::mat queryCopy(querySample);
+
+    const uint64_t start = util::Profiler::Timestamp();
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
+    std::vector<size_t> oldFromNewRefs;
+    TreeType refTree(refCopy, oldFromNewRefs, candidates[c]);
+
+    if (queryCopy.n_cols > 0)
+    {
+      std::vector<size_t> oldFromNewQueries;
+      TreeType* queryTree = NULL;
+      if (!singleMode)
+        queryTree = new TreeType(queryCopy, oldFromNewQueries, candidates[c]);
+
+      AllkNN allknn(&refTree, queryTree, refCopy, queryCopy, singleMode);
+      allknn.Search(k, neighbors, distances);
+
+      if (queryTree)
+        delete queryTree;
+    }
+    else
+    {
+      AllkNN allknn(&refTree, refCopy, singleMode);
+      allknn.Search(k, neighbors, distances);
+    }
+
+    const uint64_t elapsed = util::Profiler::Timestamp() - start;
+    Log::Info << "Leaf size " << candidates[c] << ": "
+        << (elapsed / 1e6) << "ms on the sample." << std::endl;
+
+    if (!haveBest || elapsed < bestTime)
+    {
+      bestLeafSize = candidates[c];
+      bestTime = elapsed;
+      haveBest = true;
+    }
+  }
+
+  return bestLeafSize;
+}
+
+/**
+ * Process the query set in blocks against a prebuilt reference tree,
+ * appending each block's results to the output files as it completes.
+ * Result memory is bounded by the block size, and the StreamingWriter
+ * overlaps the disk write of each block with the computation of the next.
+ *
+ * @param refTree Prebuilt reference tree.
+ * @param referenceData Reference dataset (as rearranged by the tree build).
+ * @param oldFromNewRefs Reference set permutation from the tree build.
+ * @param queryData Full query dataset.
+ * @param k Number of neighbors to search for.
+ * @param singleMode Whether to use single-tree search.
+ * @param epsilon Allowed relative approximation error.
+ * @param leafSize Leaf size for the per-block query trees.
+ * @param blockSize Number of query points per block.
+ * @param neighborsFile File to append neighbor indices to.
+ * @param distancesFile File to append neighbor distances to.
+ */
+template<typename TreeType>
+void StreamingSearch(TreeType& refTree,
+                     const arma::mat& referenceData,
+                     const std::vector<size_t>& oldFromNewRefs,
+                     const arma::mat& queryData,
+                     const size_t k,
+                     const bool singleMode,
+                     const double epsilon,
+                     const size_t leafSize,
+                     const size_t blockSize,
+                     const string& neighborsFile,
+                     const string& distancesFile)
+{
+  typedef NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>,
+      TreeType> SearchType;
+
+  data::StreamingWriter<size_t> neighborWriter(neighborsFile);
+  data::StreamingWriter<double> distanceWriter(distancesFile);
+
+  for (size_t begin = 0; begin < queryData.n_cols; begin += blockSize)
+  {
+    const size_t blockCols = std::min(blockSize,
+        (size_t) queryData.n_cols - begin);
+
+    // The tree build rearranges its dataset, so the block is a copy.
+    arma::mat queryBlock = queryData.cols(begin, begin + blockCols - 1);
+
+    std::vector<size_t> oldFromNewQueries;
+    TreeType* queryTree = NULL;
+    if (!singleMode)
+      queryTree = new TreeType(queryBlock, oldFromNewQueries, leafSize);
+
+    SearchType allknn(&refTree, queryTree, referenceData, queryBlock,
+        singleMode);
+    allknn.Epsilon() = epsilon;
+
+    arma::Mat<size_t> neighborsOut;
+    arma::mat distancesOut;
+    allknn.Search(k, neighborsOut, distancesOut);
+
+    // Map the block's results back to the original point orderings before
+    // they are written out.
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    if (!singleMode)
+      Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewQueries,
+          blockNeighbors, blockDistances);
+    else
+      Unmap(neighborsOut, distancesOut, oldFromNewRefs, blockNeighbors,
+          blockDistances);
+
+    neighborWriter.Append(blockNeighbors);
+    distanceWriter.Append(blockDistances);
+
+    if (queryTree)
+      delete queryTree;
+
+    Log::Info << "Wrote results for queries " << begin << " to "
+        << (begin + blockCols - 1) << "." << endl;
+  }
+}
 
 int main(int argc, char *argv[])
 {
@@ -86,6 +341,10 @@ int main(int argc, char *argv[])
 
   bool naive = CLI::HasParam("naive");
   bool singleMode = CLI::HasParam("single_mode");
+  const double epsilon = CLI::GetParam<double>("epsilon");
+  if (epsilon < 0)
+    Log::Fatal << "Invalid epsilon: " << epsilon << "; must be non-negative."
+        << endl;
   const bool randomBasis = CLI::HasParam("random_basis");
 
   arma::mat referenceData;
@@ -130,7 +389,54 @@ int main(int argc, char *argv[])
   {
     Log::Warn << "--cover_tree overrides --r_tree." << endl;
   }
-  
+
+  // cover_tree overrides ball_tree, and ball_tree overrides r_tree.
+  if (CLI::HasParam("cover_tree") && CLI::HasParam("ball_tree"))
+  {
+    Log::Warn << "--cover_tree overrides --ball_tree." << endl;
+  }
+  if (CLI::HasParam("ball_tree") && CLI::HasParam("r_tree"))
+  {
+    Log::Warn << "--ball_tree overrides --r_tree." << endl;
+  }
+
+  // Check the streaming-output options.
+  const int streamBlockInt = CLI::GetParam<int>("stream_block_size");
+  if (streamBlockInt < 0)
+    Log::Fatal << "Invalid stream block size: " << streamBlockInt << ".  Must "
+        "be non-negative." << endl;
+  size_t streamBlockSize = streamBlockInt;
+
+  if (streamBlockSize > 0 && queryFile == "")
+  {
+    // Block-wise search cannot reproduce the monochromatic semantics: each
+    // query block would find its own points as neighbors at distance zero,
+    // while the monochromatic search excludes them.
+    Log::Warn << "--stream_block_size ignored: no --query_file given." << endl;
+    streamBlockSize = 0;
+  }
+  if (streamBlockSize > 0 && (CLI::HasParam("cover_tree") ||
+      (CLI::HasParam("r_tree") && !CLI::HasParam("ball_tree"))))
+  {
+    Log::Warn << "--stream_block_size ignored: streaming output is only "
+        << "available for kd-trees and ball trees." << endl;
+    streamBlockSize = 0;
+  }
+  if (streamBlockSize > 0 && CLI::HasParam("tree_order"))
+  {
+    Log::Warn << "--tree_order ignored with --stream_block_size; streamed "
+        << "results are always in the original order." << endl;
+  }
+
+  // Tree-order output only makes sense for tree types that rearrange the
+  // dataset during construction.
+  if (CLI::HasParam("tree_order") && (CLI::HasParam("cover_tree") ||
+      (CLI::HasParam("r_tree") && !CLI::HasParam("ball_tree"))))
+  {
+    Log::Warn << "--tree_order has no effect: the selected tree type does not "
+        << "rearrange the dataset." << endl;
+  }
+
   if (naive)
     leafSize = referenceData.n_cols;
 
@@ -171,12 +477,161 @@ int main(int argc, char *argv[])
     }
   }
 
+  // Empirically choose the leaf size, if requested.  This happens after the
+  // random basis projection so the tuning sample sees the same geometry the
+  // full build will.
+  if (CLI::HasParam("tune_leaf_size"))
+  {
+    if (naive)
+    {
+      Log::Warn << "--tune_leaf_size ignored because --naive is present."
+          << endl;
+    }
+    else if (CLI::HasParam("cover_tree"))
+    {
+      Log::Warn << "--tune_leaf_size ignored: cover trees have no leaf size."
+          << endl;
+    }
+    else
+    {
+      const int sampleInt = CLI::GetParam<int>("tune_sample_size");
+      if (sampleInt < 1)
+        Log::Fatal << "Invalid tuning sample size: " << sampleInt << ".  Must "
+            "be greater than 0." << endl;
+
+      Log::Info << "Tuning leaf size on a sample of up to " << sampleInt
+          << " reference points..." << endl;
+      Timer::Start("leaf_size_tuning");
+
+      leafSize = TuneLeafSize(referenceData, queryData, k, singleMode,
+          (size_t) sampleInt);
+
+      Timer::Stop("leaf_size_tuning");
+      Log::Info << "Tuned leaf size: " << leafSize << "." << endl;
+    }
+  }
+
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
   if (!CLI::HasParam("cover_tree"))
   {
-    if(!CLI::HasParam("r_tree"))
+    if (CLI::HasParam("ball_tree"))
+    {
+      // Make sure to notify the user that they are using a ball tree.
+      Log::Info << "Using ball tree for nearest-neighbor calculation." << endl;
+
+      typedef BinarySpaceTree<bound::BallBound<arma::vec,
+          metric::LMetric<2, true> >,
+          NeighborSearchStat<NearestNeighborSort> > TreeType;
+      typedef NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>,
+          TreeType> AllkNNBallTree;
+
+      // Because we may construct it differently, we need a pointer.
+      AllkNNBallTree* allknn = NULL;
+
+      // Mappings for when we build the tree.
+      std::vector<size_t> oldFromNewRefs;
+
+      // Build trees by hand, so we can save memory: if we pass a tree to
+      // NeighborSearch, it does not copy the matrix.
+      Log::Info << "Building reference tree..." << endl;
+      Timer::Start("tree_building");
+
+      TreeType refTree(referenceData, oldFromNewRefs, leafSize);
+      TreeType* queryTree = NULL; // Empty for now.
+
+      Timer::Stop("tree_building");
+
+      if (streamBlockSize > 0)
+      {
+        Log::Info << "Computing " << k << " nearest neighbors in query blocks "
+            << "of " << streamBlockSize << "..." << endl;
+        StreamingSearch(refTree, referenceData, oldFromNewRefs, queryData, k,
+            singleMode, epsilon, leafSize, streamBlockSize, neighborsFile,
+            distancesFile);
+        return 0;
+      }
+
+      std::vector<size_t> oldFromNewQueries;
+
+      if (CLI::GetParam<string>("query_file") != "")
+      {
+        if (naive && leafSize < queryData.n_cols)
+          leafSize = queryData.n_cols;
+
+        Log::Info << "Building query tree..." << endl;
+
+        if (!singleMode)
+        {
+          Timer::Start("tree_building");
+
+          queryTree = new TreeType(queryData, oldFromNewQueries, leafSize);
+
+          Timer::Stop("tree_building");
+        }
+
+        allknn = new AllkNNBallTree(&refTree, queryTree, referenceData,
+            queryData, singleMode);
+        allknn->Epsilon() = epsilon;
+
+        Log::Info << "Tree built." << endl;
+      }
+      else
+      {
+        allknn = new AllkNNBallTree(&refTree, referenceData, singleMode);
+        allknn->Epsilon() = epsilon;
+
+        Log::Info << "Trees built." << endl;
+      }
+
+      arma::mat distancesOut;
+      arma::Mat<size_t> neighborsOut;
+
+      Log::Info << "Computing " << k << " nearest neighbors..." << endl;
+      allknn->Search(k, neighborsOut, distancesOut);
+
+      Log::Info << "Neighbors computed." << endl;
+
+      if (CLI::HasParam("tree_order"))
+      {
+        // Skip the unmapping pass entirely; emit the results in tree order
+        // along with the permutations, so the mapping can be applied lazily.
+        Log::Info << "Emitting results in tree order." << endl;
+
+        neighbors = neighborsOut;
+        distances = distancesOut;
+
+        SaveMap("reference_map_file", oldFromNewRefs);
+        if ((CLI::GetParam<string>("query_file") != "") && !singleMode)
+          SaveMap("query_map_file", oldFromNewQueries);
+        else if (CLI::GetParam<string>("query_file") == "")
+          SaveMap("query_map_file", oldFromNewRefs);
+      }
+      else
+      {
+        // We have to map back to the original indices from before the tree
+        // construction.
+        Log::Info << "Re-mapping indices..." << endl;
+
+        if ((CLI::GetParam<string>("query_file") != "") && !singleMode)
+          Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewQueries,
+              neighbors, distances);
+        else if ((CLI::GetParam<string>("query_file") != "") && singleMode)
+          Unmap(neighborsOut, distancesOut, oldFromNewRefs, neighbors,
+              distances);
+        else
+          Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewRefs,
+              neighbors, distances);
+      }
+
+      // Clean up.
+      if (queryTree)
+        delete queryTree;
+
+      delete allknn;
+    }
+    else if (!CLI::HasParam("r_tree"))
     {
       // Because we may construct it differently, we need a pointer.
       AllkNN* allknn = NULL;
@@ -198,6 +653,16 @@ int main(int argc, char *argv[])
 
       Timer::Stop("tree_building");
 
+      if (streamBlockSize > 0)
+      {
+        Log::Info << "Computing " << k << " nearest neighbors in query blocks "
+            << "of " << streamBlockSize << "..." << endl;
+        StreamingSearch(refTree, referenceData, oldFromNewRefs, queryData, k,
+            singleMode, epsilon, leafSize, streamBlockSize, neighborsFile,
+            distancesFile);
+        return 0;
+      }
+
       std::vector<size_t> oldFromNewQueries;
 
       if (CLI::GetParam<string>("query_file") != "")
@@ -225,12 +690,14 @@ int main(int argc, char *argv[])
 
 	allknn = new AllkNN(&refTree, queryTree, referenceData, queryData,
 	    singleMode);
+	allknn->Epsilon() = epsilon;
 
 	Log::Info << "Tree built." << endl;
       }
       else
       {
 	allknn = new AllkNN(&refTree, referenceData, singleMode);
+	allknn->Epsilon() = epsilon;
 
 	Log::Info << "Trees built." << endl;
       }
@@ -243,19 +710,38 @@ int main(int argc, char *argv[])
 
       Log::Info << "Neighbors computed." << endl;
 
-      // We have to map back to the original indices from before the tree
-      // construction.
-      Log::Info << "Re-mapping indices..." << endl;
-
-      // Map the results back to the correct places.
-      if ((CLI::GetParam<string>("query_file") != "") && !singleMode)
-	Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewQueries,
-	    neighbors, distances);
-      else if ((CLI::GetParam<string>("query_file") != "") && singleMode)
-	Unmap(neighborsOut, distancesOut, oldFromNewRefs, neighbors, distances);
+      if (CLI::HasParam("tree_order"))
+      {
+        // Skip the unmapping pass entirely; emit the results in tree order
+        // along with the permutations, so the mapping can be applied lazily.
+        Log::Info << "Emitting results in tree order." << endl;
+
+        neighbors = neighborsOut;
+        distances = distancesOut;
+
+        SaveMap("reference_map_file", oldFromNewRefs);
+        if ((CLI::GetParam<string>("query_file") != "") && !singleMode)
+          SaveMap("query_map_file", oldFromNewQueries);
+        else if (CLI::GetParam<string>("query_file") == "")
+          SaveMap("query_map_file", oldFromNewRefs);
+      }
       else
-	Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewRefs,
-	    neighbors, distances);
+      {
+        // We have to map back to the original indices from before the tree
+        // construction.
+        Log::Info << "Re-mapping indices..." << endl;
+
+        // Map the results back to the correct places.
+        if ((CLI::GetParam<string>("query_file") != "") && !singleMode)
+          Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewQueries,
+              neighbors, distances);
+        else if ((CLI::GetParam<string>("query_file") != "") && singleMode)
+          Unmap(neighborsOut, distancesOut, oldFromNewRefs, neighbors,
+              distances);
+        else
+          Unmap(neighborsOut, distancesOut, oldFromNewRefs, oldFromNewRefs,
+              neighbors, distances);
+      }
 
       // Clean up.
       if (queryTree)
@@ -318,6 +804,7 @@ int main(int argc, char *argv[])
           NeighborSearchStat<NearestNeighborSort>,
           arma::mat> >(&refTree, queryTree,
           referenceData, queryData, singleMode);
+        allknn->Epsilon() = epsilon;
       } else
       {
         allknn = new NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>,
@@ -326,6 +813,7 @@ int main(int argc, char *argv[])
           NeighborSearchStat<NearestNeighborSort>,
           arma::mat> >(&refTree,
           referenceData, singleMode);
+        allknn->Epsilon() = epsilon;
       }
       Log::Info << "Tree built." << endl;
       
@@ -379,6 +867,7 @@ int main(int argc, char *argv[])
           CoverTree<metric::LMetric<2, true>, tree::FirstPointIsRoot,
           NeighborSearchStat<NearestNeighborSort> > >(&referenceTree, queryTree,
           referenceData, queryData, singleMode);
+      allknn->Epsilon() = epsilon;
     }
     else
     {
@@ -386,6 +875,7 @@ int main(int argc, char *argv[])
           CoverTree<metric::LMetric<2, true>, tree::FirstPointIsRoot,
           NeighborSearchStat<NearestNeighborSort> > >(&referenceTree,
           referenceData, singleMode);
+      allknn->Epsilon() = epsilon;
     }
 
     Log::Info << "Computing " << k << " nearest neighbors..." << endl;
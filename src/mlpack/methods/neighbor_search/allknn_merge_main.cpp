@@ -0,0 +1,126 @@
+/**
+ * @file allknn_merge_main.cpp
+ * @author Ryan Curtin
+ *
+ * Merge per-shard neighbor search results into exact global results.
+ */
+#include <mlpack/core.hpp>
+
+#include <string>
+#include <sstream>
+#include <vector>
+
+#include "shard_merge.hpp"
+#include "sort_policies/nearest_neighbor_sort.hpp"
+#include "sort_policies/furthest_neighbor_sort.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+// Information about the program itself.
+PROGRAM_INFO("Merge Sharded All-K-Neighbors Results",
+    "This program merges the results of neighbor searches run against "
+    "disjoint shards of one reference set into exact global results.  It is "
+    "the gather step of a scatter/gather workflow for reference sets too "
+    "large for one machine: partition the reference set into contiguous "
+    "shards, search each shard in its own process or on its own node (for "
+    "example with the allknn executable, passing the full query set and one "
+    "shard as the reference set), and then merge the per-shard outputs here."
+    "\n\n"
+    "The per-shard neighbors and distances files are given as comma-"
+    "separated lists, in the same shard order as the offsets.  The offset of "
+    "a shard is the index of its first point in the full reference set, so "
+    "that shard-local neighbor indices can be translated back to global "
+    "ones.  For example, to merge two shards where the second shard started "
+    "at reference point 50000:"
+    "\n\n"
+    "$ allknn_merge --shard_neighbors_files=n0.csv,n1.csv\n"
+    "  --shard_distances_files=d0.csv,d1.csv --shard_offsets=0,50000\n"
+    "  --neighbors_file=neighbors.csv --distances_file=distances.csv"
+    "\n\n"
+    "Because each shard reports its k best candidates for every query point, "
+    "the merged results are exactly what a search against the whole "
+    "reference set would return.  Pass --furthest to merge all-k-furthest-"
+    "neighbors (allkfn) results instead.");
+
+// Define our input parameters that this program will take.
+PARAM_STRING_REQ("shard_neighbors_files", "Comma-separated list of per-shard "
+    "neighbors files.", "i");
+PARAM_STRING_REQ("shard_distances_files", "Comma-separated list of per-shard "
+    "distances files.", "t");
+PARAM_STRING_REQ("shard_offsets", "Comma-separated list of the global index "
+    "of each shard's first reference point.", "o");
+PARAM_STRING_REQ("distances_file", "File to output merged distances into.",
+    "d");
+PARAM_STRING_REQ("neighbors_file", "File to output merged neighbors into.",
+    "n");
+
+PARAM_INT("k", "Number of neighbors to emit per query point (0 means as many "
+    "as the shard results hold).", "k", 0);
+PARAM_FLAG("furthest", "If true, merge all-k-furthest-neighbors results "
+    "(larger distances are better) instead of nearest.", "f");
+
+//! Split a comma-separated parameter value into its fields.
+void SplitFields(const string& value, vector<string>& fields)
+{
+  istringstream stream(value);
+  string field;
+  while (getline(stream, field, ','))
+    fields.push_back(field);
+}
+
+int main(int argc, char* argv[])
+{
+  // Give CLI the command line parameters the user passed in.
+  CLI::ParseCommandLine(argc, argv);
+
+  vector<string> neighborsFiles;
+  vector<string> distancesFiles;
+  vector<string> offsetFields;
+  SplitFields(CLI::GetParam<string>("shard_neighbors_files"), neighborsFiles);
+  SplitFields(CLI::GetParam<string>("shard_distances_files"), distancesFiles);
+  SplitFields(CLI::GetParam<string>("shard_offsets"), offsetFields);
+
+  if ((distancesFiles.size() != neighborsFiles.size()) ||
+      (offsetFields.size() != neighborsFiles.size()))
+    Log::Fatal << "The lists of shard neighbors files, distances files, and "
+        << "offsets must all have the same length!" << endl;
+  if (neighborsFiles.empty())
+    Log::Fatal << "No shard results given!" << endl;
+
+  // Load each shard's results.
+  const size_t shards = neighborsFiles.size();
+  vector<arma::Mat<size_t> > shardNeighbors(shards);
+  vector<arma::mat> shardDistances(shards);
+  vector<size_t> shardOffsets(shards);
+  for (size_t s = 0; s < shards; ++s)
+  {
+    data::Load(neighborsFiles[s], shardNeighbors[s], true);
+    data::Load(distancesFiles[s], shardDistances[s], true);
+
+    istringstream offsetStream(offsetFields[s]);
+    if (!(offsetStream >> shardOffsets[s]))
+      Log::Fatal << "Bad shard offset '" << offsetFields[s] << "'!" << endl;
+  }
+
+  // By default, emit as many neighbors as the shard results hold.
+  size_t k = (size_t) CLI::GetParam<int>("k");
+  if (k == 0)
+    k = shardNeighbors[0].n_rows;
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  if (CLI::HasParam("furthest"))
+    MergeShardResults<FurthestNeighborSort>(shardNeighbors, shardDistances,
+        shardOffsets, k, neighbors, distances);
+  else
+    MergeShardResults<NearestNeighborSort>(shardNeighbors, shardDistances,
+        shardOffsets, k, neighbors, distances);
+
+  // Save output.
+  data::Save(CLI::GetParam<string>("distances_file"), distances);
+  data::Save(CLI::GetParam<string>("neighbors_file"), neighbors);
+
+  return 0;
+}
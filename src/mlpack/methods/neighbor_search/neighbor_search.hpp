@@ -14,6 +14,7 @@
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include "neighbor_search_stat.hpp"
@@ -49,6 +50,31 @@ template<typename SortPolicy = NearestNeighborSort,
 class NeighborSearch
 {
  public:
+  /**
+   * Ownership policies for datasets given to the constructors that build
+   * trees.  These only matter for tree types that rearrange the dataset
+   * during building (see tree::TreeTraits); other tree types never modify or
+   * copy the dataset, and the policy has no effect.
+   */
+  enum DatasetOwnership
+  {
+    /**
+     * Copy the dataset and rearrange the copy, leaving the caller's matrix
+     * untouched.  Results are mapped back to the original point ordering.
+     * This is the behavior of the constructors that take no policy argument.
+     */
+    COPY_ON_REORDER,
+    /**
+     * Rearrange the caller's matrix in place instead of copying it, so that
+     * no second copy of the dataset ever exists.  The matrix must outlive
+     * this object, and its point ordering changes during construction;
+     * results are still mapped back to the original ordering.  Incremental
+     * updates (InsertPoint(), DeletePoint(), Rebuild()) are not available
+     * with this policy, since folding updates in must rewrite the dataset.
+     */
+    REARRANGE_IN_PLACE
+  };
+
   /**
    * Initialize the NeighborSearch object, passing both a query and reference
    * dataset.  Optionally, perform the computation in naive mode or single-tree
@@ -66,6 +92,8 @@ class NeighborSearch
    *      dual-tree search).  This overrides singleMode (if it is set to true).
    * @param singleMode If true, single-tree search will be used (as opposed to
    *      dual-tree search).
+   * @param epsilon Allowed relative error for approximate search (0 means the
+   *      search is exact).
    * @param leafSize Leaf size for tree construction (ignored if tree is given).
    * @param metric An optional instance of the MetricType class.
    */
@@ -73,6 +101,7 @@ class NeighborSearch
                  const typename TreeType::Mat& querySet,
                  const bool naive = false,
                  const bool singleMode = false,
+                 const double epsilon = 0.0,
                  const MetricType metric = MetricType());
 
   /**
@@ -93,12 +122,67 @@ class NeighborSearch
    *      dual-tree search).  This overrides singleMode (if it is set to true).
    * @param singleMode If true, single-tree search will be used (as opposed to
    *      dual-tree search).
+   * @param epsilon Allowed relative error for approximate search (0 means the
+   *      search is exact).
    * @param leafSize Leaf size for tree construction (ignored if tree is given).
    * @param metric An optional instance of the MetricType class.
    */
   NeighborSearch(const typename TreeType::Mat& referenceSet,
                  const bool naive = false,
                  const bool singleMode = false,
+                 const double epsilon = 0.0,
+                 const MetricType metric = MetricType());
+
+  /**
+   * Initialize the NeighborSearch object with an explicit dataset ownership
+   * policy, passing both a query and reference dataset.  With
+   * REARRANGE_IN_PLACE, the given matrices are permuted in place during tree
+   * building instead of being copied, so no duplicate of the data is made;
+   * with COPY_ON_REORDER this behaves exactly like the constructor above.
+   * The matrices must outlive this object in either case.
+   *
+   * @param referenceSet Set of reference points.
+   * @param querySet Set of query points.
+   * @param ownership Dataset ownership policy (see DatasetOwnership).
+   * @param naive If true, O(n^2) naive search will be used (as opposed to
+   *      dual-tree search).  This overrides singleMode (if it is set to true).
+   * @param singleMode If true, single-tree search will be used (as opposed to
+   *      dual-tree search).
+   * @param epsilon Allowed relative error for approximate search (0 means the
+   *      search is exact).
+   * @param metric An optional instance of the MetricType class.
+   */
+  NeighborSearch(typename TreeType::Mat& referenceSet,
+                 typename TreeType::Mat& querySet,
+                 const DatasetOwnership ownership,
+                 const bool naive = false,
+                 const bool singleMode = false,
+                 const double epsilon = 0.0,
+                 const MetricType metric = MetricType());
+
+  /**
+   * Initialize the NeighborSearch object with an explicit dataset ownership
+   * policy, passing only one dataset, which is used as both the query and the
+   * reference dataset.  With REARRANGE_IN_PLACE, the given matrix is permuted
+   * in place during tree building instead of being copied, so no duplicate of
+   * the data is made; with COPY_ON_REORDER this behaves exactly like the
+   * constructor above.  The matrix must outlive this object in either case.
+   *
+   * @param referenceSet Set of reference points.
+   * @param ownership Dataset ownership policy (see DatasetOwnership).
+   * @param naive If true, O(n^2) naive search will be used (as opposed to
+   *      dual-tree search).  This overrides singleMode (if it is set to true).
+   * @param singleMode If true, single-tree search will be used (as opposed to
+   *      dual-tree search).
+   * @param epsilon Allowed relative error for approximate search (0 means the
+   *      search is exact).
+   * @param metric An optional instance of the MetricType class.
+   */
+  NeighborSearch(typename TreeType::Mat& referenceSet,
+                 const DatasetOwnership ownership,
+                 const bool naive = false,
+                 const bool singleMode = false,
+                 const double epsilon = 0.0,
                  const MetricType metric = MetricType());
 
   /**
@@ -128,6 +212,8 @@ class NeighborSearch
    * @param querySet Set of query points corresponding to queryTree.
    * @param singleMode Whether single-tree computation should be used (as
    *      opposed to dual-tree computation).
+   * @param epsilon Allowed relative error for approximate search (0 means the
+   *      search is exact).
    * @param metric Instantiated distance metric.
    */
   NeighborSearch(TreeType* referenceTree,
@@ -135,6 +221,7 @@ class NeighborSearch
                  const typename TreeType::Mat& referenceSet,
                  const typename TreeType::Mat& querySet,
                  const bool singleMode = false,
+                 const double epsilon = 0.0,
                  const MetricType metric = MetricType());
 
   /**
@@ -162,11 +249,14 @@ class NeighborSearch
    * @param referenceSet Set of reference points corresponding to referenceTree.
    * @param singleMode Whether single-tree computation should be used (as
    *      opposed to dual-tree computation).
+   * @param epsilon Allowed relative error for approximate search (0 means the
+   *      search is exact).
    * @param metric Instantiated distance metric.
    */
   NeighborSearch(TreeType* referenceTree,
                  const typename TreeType::Mat& referenceSet,
                  const bool singleMode = false,
+                 const double epsilon = 0.0,
                  const MetricType metric = MetricType());
 
 
@@ -192,6 +282,159 @@ class NeighborSearch
               arma::Mat<size_t>& resultingNeighbors,
               arma::mat& distances);
 
+  /**
+   * Compute the nearest neighbors for several values of k at once, with a
+   * single traversal.  The candidate list of a search with the largest
+   * requested k contains the answer for every smaller k in its first rows
+   * (the lists are kept sorted by distance), so one traversal with
+   * max(ks) satisfies all of the consumers; the per-k results are then
+   * sliced out without re-sorting.
+   *
+   * Note that the traversal's pruning bound is necessarily the one of the
+   * largest requested k -- the candidate list must be complete at that k --
+   * so this costs the same as a single search with max(ks), but saves every
+   * additional traversal.
+   *
+   * @param ks Values of k to search for; need not be sorted.
+   * @param resultingNeighbors Vector of matrices to store the lists of
+   *     neighbors in (resultingNeighbors[i] has ks[i] rows).
+   * @param distances Vector of matrices to store the neighbor distances in
+   *     (distances[i] has ks[i] rows).
+   */
+  void Search(const std::vector<size_t>& ks,
+              std::vector<arma::Mat<size_t> >& resultingNeighbors,
+              std::vector<arma::mat>& distances);
+
+  /**
+   * Compute the nearest neighbors as Search(), but warm-start the pruning
+   * bound of every query point from the results of a previous search.  The
+   * distance of each seed is verified against the current reference set (so
+   * the seeds stay usable even if the reference points have moved), and the
+   * k'th best verified distance becomes the query's initial candidate bound
+   * -- padded by a tiny slack so candidates tying it exactly are still
+   * admitted.  The traversal re-finds the actual neighbors under that
+   * bound; since no node holding an unfound neighbor can be pruned while a
+   * placeholder entry remains, the results match a cold Search(), but the
+   * bounds are tight from the first node visit.  On a reference set that
+   * has changed only slightly since the seeds were computed, this prunes
+   * most of the tree immediately.
+   *
+   * Seed indices at or beyond the reference set size (including the
+   * 'unfilled' marker in previous results) are ignored; a query with fewer
+   * than k usable seeds starts with the usual infinite bound.  If there are
+   * pending insertions or deletions, the seeds are ignored entirely and a
+   * plain Search() runs instead.
+   *
+   * @param k Number of neighbors to search for.
+   * @param seeds Matrix of candidate reference indices, one column per query
+   *     point (any number of rows); typically the neighbors output of a
+   *     previous search.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each
+   *     query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const size_t k,
+              const arma::Mat<size_t>& seeds,
+              arma::Mat<size_t>& resultingNeighbors,
+              arma::mat& distances);
+
+  /**
+   * Perform defeatist (no-backtrack) approximate search, emulating search on
+   * a spill tree: each query point descends the reference tree greedily, and
+   * the worse-scoring child of a node is visited only when it scores within
+   * overlap of the better child -- just as a spill tree with that overlap
+   * buffer would have duplicated the nearby points into both children.  An
+   * overlap of 0 visits a single root-to-leaf path per query; larger overlaps
+   * trade speed for recall, and a very large overlap visits everything that
+   * scoring cannot prune outright (making the results exact).
+   *
+   * The results are approximate: the true nearest neighbors of a query may be
+   * missed.  This requires a built reference tree (so it is not available in
+   * naive mode) and a TreeType that provides a GreedySingleTreeTraverser
+   * (BinarySpaceTree does).  Any pending insertions or deletions are folded
+   * into the tree first, since defeatist search cannot merge with the
+   * insertion buffer.
+   *
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each
+   *     query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param overlap Width of the emulated spill-tree overlap buffer.
+   */
+  void SearchDefeatist(const size_t k,
+                       arma::Mat<size_t>& resultingNeighbors,
+                       arma::mat& distances,
+                       const double overlap = 0.0);
+
+  /**
+   * Insert a new reference point without rebuilding the tree.  The point is
+   * held in a side buffer that is scanned exhaustively at search time, and is
+   * assigned the next free index (the number of reference points plus the
+   * number of points inserted since the last rebuild).  Once the accumulated
+   * insertions and deletions exceed RebuildThreshold() (as a fraction of the
+   * reference set), the changes are folded into a freshly built tree; see
+   * Rebuild() for the effect on point indices.
+   *
+   * Incremental updates are only available if this object built (and owns)
+   * its own tree, since folding the changes in requires rebuilding it.
+   *
+   * @param point New reference point.
+   */
+  template<typename VecType>
+  void InsertPoint(const VecType& point);
+
+  /**
+   * Delete the reference point with the given index without rebuilding the
+   * tree.  The point is tombstoned: it stays in the tree (so the bounds
+   * remain valid and pruning stays correct) but is filtered out of search
+   * results, until the accumulated changes exceed RebuildThreshold() and the
+   * tree is rebuilt without it.  In monochromatic mode (no separate query
+   * set), a deleted point still acts as a query point until the next rebuild.
+   *
+   * Incremental updates are only available if this object built (and owns)
+   * its own tree.
+   *
+   * @param index Index of the reference point to delete (or of a point
+   *     inserted since the last rebuild).
+   */
+  void DeletePoint(const size_t index);
+
+  /**
+   * Fold all pending insertions and deletions into a freshly built reference
+   * tree immediately, instead of waiting for the rebuild threshold.  This
+   * renumbers the reference points: the surviving original points (in order)
+   * are followed by the surviving inserted points (in insertion order).
+   *
+   * This is called automatically when the pending changes exceed
+   * RebuildThreshold() times the number of reference points.
+   */
+  void Rebuild();
+
+  //! Return the fraction of the reference set that may change before the
+  //! pending updates are folded into a rebuilt tree.
+  double RebuildThreshold() const { return rebuildThreshold; }
+  //! Modify the rebuild threshold.
+  double& RebuildThreshold() { return rebuildThreshold; }
+
+  //! Return whether the execution mode (naive, single-tree, or dual-tree) is
+  //! chosen automatically per Search() call; if false, the construction-time
+  //! flags are used.
+  bool AutoMode() const { return autoMode; }
+  //! Modify whether the execution mode is chosen automatically.
+  bool& AutoMode() { return autoMode; }
+
+  //! Return whether automatic mode selection calibrates its cost model by
+  //! probing a small sample of queries instead of using static estimates.
+  bool AutoProbes() const { return autoProbes; }
+  //! Modify whether automatic mode selection runs calibration probes.
+  bool& AutoProbes() { return autoProbes; }
+
+  //! Return the number of insertions and deletions not yet folded into the
+  //! reference tree.
+  size_t PendingChanges() const { return insertedPoints.n_cols + numDeleted; }
+
   //! Returns a string representation of this object.
   std::string ToString() const;
 
@@ -206,6 +449,11 @@ class NeighborSearch
   //! Modify the number of node combination scores.
   size_t& Scores() { return scores; }
 
+  //! Return the allowed relative error for approximate search.
+  double Epsilon() const { return epsilon; }
+  //! Modify the allowed relative error for approximate search.
+  double& Epsilon() { return epsilon; }
+
  private:
   //! Copy of reference dataset (if we need it, because tree building modifies
   //! it).
@@ -227,6 +475,10 @@ class NeighborSearch
   bool treeOwner;
   //! Indicates if a separate query set was passed.
   bool hasQuerySet;
+  //! If true, the reference set is our own copy (or was never rearranged), so
+  //! incremental updates may rewrite it; false with REARRANGE_IN_PLACE and
+  //! when pre-built trees were passed.
+  bool ownsDataset;
 
   //! Indicates if O(n^2) naive search is being used.
   bool naive;
@@ -236,6 +488,9 @@ class NeighborSearch
   //! Instantiation of metric.
   MetricType metric;
 
+  //! Allowed relative error for approximate search (0 means exact search).
+  double epsilon;
+
   //! Permutations of reference points during tree building.
   std::vector<size_t> oldFromNewReferences;
   //! Permutations of query points during tree building.
@@ -246,6 +501,96 @@ class NeighborSearch
   //! The total number of scores (applicable for non-naive search).
   size_t scores;
 
+  //! Points inserted since the last rebuild; these are scanned exhaustively
+  //! at search time, and their indices follow those of the reference set.
+  typename TreeType::Mat insertedPoints;
+  //! Tombstones for deleted points: first the reference set, then the
+  //! insertion buffer.  Empty means no point has been deleted or inserted.
+  std::vector<bool> deleted;
+  //! The number of tombstoned points.
+  size_t numDeleted;
+  //! The fraction of the reference set that may change before the pending
+  //! updates are folded into a rebuilt tree.
+  double rebuildThreshold;
+
+  //! Whether the execution mode is chosen automatically per Search() call.
+  bool autoMode;
+  //! Whether automatic mode selection calibrates its estimates with sampled
+  //! probe queries.
+  bool autoProbes;
+
+  /**
+   * Run the search against the reference tree (or naively), ignoring any
+   * pending insertions and deletions.  This is the body of Search() from
+   * before incremental updates existed; Search() merges its results with the
+   * insertion buffer and filters out tombstoned points.
+   *
+   * If seeds is non-NULL, the candidate lists are warm-started from it
+   * before the traversal (see the warm-start Search() overload); the seed
+   * indices refer to the original point orderings.
+   */
+  void SearchTree(const size_t k,
+                  arma::Mat<size_t>& resultingNeighbors,
+                  arma::mat& distances,
+                  const arma::Mat<size_t>* seeds = NULL);
+
+  /**
+   * Choose the execution mode for one search from a cost model over the
+   * reference set size, query set size, dimension, and k, used when
+   * AutoMode() is set.  With AutoProbes() set, the tree-based estimates are
+   * calibrated by running a small sample of queries through the actual
+   * traversals and extrapolating; otherwise crude static estimates are used.
+   * Modes whose structures are not available (no reference tree after naive
+   * construction, no query tree in single-tree construction) are never
+   * chosen.
+   *
+   * @param k Number of neighbors to search for.
+   * @param useNaive Will be set to whether brute-force search should run.
+   * @param useSingle Will be set to whether single-tree search should run.
+   */
+  void SelectMode(const size_t k, bool& useNaive, bool& useSingle) const;
+
+  /**
+   * Map the results of a search back to the original point indices, if tree
+   * building rearranged the datasets.  The pointers must be the ones prepared
+   * by the caller before the search: when mapping is needed they point to
+   * freshly allocated temporaries, which this method reads from and deletes;
+   * otherwise they point directly at the output matrices and there is nothing
+   * to do.
+   */
+  void MapResults(const size_t k,
+                  arma::Mat<size_t>* neighborPtr,
+                  arma::mat* distancePtr,
+                  arma::Mat<size_t>& resultingNeighbors,
+                  arma::mat& distances);
+
+  //! If incremental updates are not possible for this object, die with an
+  //! error message naming the offending function.
+  void CheckUpdateSupport(const char* functionName) const;
+
+  //! Rebuild the tree if the pending changes exceed the rebuild threshold.
+  void CheckRebuild();
+
+  //! Reset the cached search statistics of every node in the given tree.
+  //! This is needed when the effective reference set changes, since bounds
+  //! cached by earlier searches no longer apply.
+  static void ResetStatistics(TreeType& node);
+
+  /**
+   * Sort each column of the results.  During the search the candidate list of
+   * each query point is kept as a binary heap with the worst candidate first
+   * (see NeighborSearchRules::InsertNeighbor()), so the lists must be sorted
+   * before they are returned to the user.
+   */
+  static void SortResults(arma::Mat<size_t>& neighbors, arma::mat& distances);
+
+  //! Comparator for SortResults(); orders candidates by SortPolicy.
+  static bool CandidateIsBetter(const std::pair<double, size_t>& a,
+                                const std::pair<double, size_t>& b)
+  {
+    return SortPolicy::IsBetter(a.first, b.first);
+  }
+
 }; // class NeighborSearch
 
 }; // namespace neighbor
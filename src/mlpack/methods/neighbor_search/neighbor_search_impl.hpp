@@ -46,6 +46,7 @@ NeighborSearch(const typename TreeType::Mat& referenceSetIn,
                const typename TreeType::Mat& querySetIn,
                const bool naive,
                const bool singleMode,
+               const double epsilon,
                const MetricType metric) :
     referenceSet(tree::TreeTraits<TreeType>::RearrangesDataset ? referenceCopy
         : referenceSetIn),
@@ -55,12 +56,21 @@ NeighborSearch(const typename TreeType::Mat& referenceSetIn,
     queryTree(NULL),
     treeOwner(!naive), // False if a tree was passed.  If naive, then no trees.
     hasQuerySet(true),
+    ownsDataset(true),
     naive(naive),
     singleMode(!naive && singleMode), // No single mode if naive.
     metric(metric),
+    epsilon(epsilon),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numDeleted(0),
+    rebuildThreshold(0.1),
+    autoMode(false),
+    autoProbes(false)
 {
+  if (epsilon < 0)
+    Log::Fatal << "NeighborSearch: epsilon must be non-negative!" << std::endl;
+
   // C++11 will allow us to call out to other constructors so we can avoid this
   // copypasta problem.
 
@@ -99,6 +109,7 @@ NeighborSearch<SortPolicy, MetricType, TreeType>::
 NeighborSearch(const typename TreeType::Mat& referenceSetIn,
                const bool naive,
                const bool singleMode,
+               const double epsilon,
                const MetricType metric) :
     referenceSet(tree::TreeTraits<TreeType>::RearrangesDataset ? referenceCopy
         : referenceSetIn),
@@ -108,12 +119,21 @@ NeighborSearch(const typename TreeType::Mat& referenceSetIn,
     queryTree(NULL),
     treeOwner(!naive), // If naive, then we are not building any trees.
     hasQuerySet(false),
+    ownsDataset(true),
     naive(naive),
     singleMode(!naive && singleMode), // No single mode if naive.
     metric(metric),
+    epsilon(epsilon),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numDeleted(0),
+    rebuildThreshold(0.1),
+    autoMode(false),
+    autoProbes(false)
 {
+  if (epsilon < 0)
+    Log::Fatal << "NeighborSearch: epsilon must be non-negative!" << std::endl;
+
   // We'll time tree building, but only if we are building trees.
   Timer::Start("tree_building");
 
@@ -139,6 +159,129 @@ NeighborSearch(const typename TreeType::Mat& referenceSetIn,
   Timer::Stop("tree_building");
 }
 
+// Construct the object with an explicit dataset ownership policy.
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearch<SortPolicy, MetricType, TreeType>::
+NeighborSearch(typename TreeType::Mat& referenceSetIn,
+               typename TreeType::Mat& querySetIn,
+               const DatasetOwnership ownership,
+               const bool naive,
+               const bool singleMode,
+               const double epsilon,
+               const MetricType metric) :
+    referenceSet((tree::TreeTraits<TreeType>::RearrangesDataset &&
+        (ownership == COPY_ON_REORDER)) ? referenceCopy : referenceSetIn),
+    querySet((tree::TreeTraits<TreeType>::RearrangesDataset &&
+        (ownership == COPY_ON_REORDER)) ? queryCopy : querySetIn),
+    referenceTree(NULL),
+    queryTree(NULL),
+    treeOwner(!naive), // False if a tree was passed.  If naive, then no trees.
+    hasQuerySet(true),
+    ownsDataset(ownership == COPY_ON_REORDER),
+    naive(naive),
+    singleMode(!naive && singleMode), // No single mode if naive.
+    metric(metric),
+    epsilon(epsilon),
+    baseCases(0),
+    scores(0),
+    numDeleted(0),
+    rebuildThreshold(0.1),
+    autoMode(false),
+    autoProbes(false)
+{
+  if (epsilon < 0)
+    Log::Fatal << "NeighborSearch: epsilon must be non-negative!" << std::endl;
+
+  // We'll time tree building, but only if we are building trees.
+  Timer::Start("tree_building");
+
+  // Copy the datasets only if the caller asked for it; with
+  // REARRANGE_IN_PLACE, tree building permutes the caller's matrices
+  // directly and no duplicate of the data is ever made.
+  if (tree::TreeTraits<TreeType>::RearrangesDataset &&
+      (ownership == COPY_ON_REORDER))
+  {
+    referenceCopy = referenceSetIn;
+    queryCopy = querySetIn;
+  }
+
+  // If not in naive mode, then we need to build trees.
+  if (!naive)
+  {
+    // The const_cast is safe; referenceSet points either to referenceCopy or
+    // to the caller's non-const matrix.
+    referenceTree = BuildTree<TreeType>(
+        const_cast<typename TreeType::Mat&>(referenceSet),
+        oldFromNewReferences);
+
+    if (!singleMode)
+      queryTree = BuildTree<TreeType>(
+          const_cast<typename TreeType::Mat&>(querySet), oldFromNewQueries);
+  }
+
+  // Stop the timer we started above (if we need to).
+  Timer::Stop("tree_building");
+}
+
+// Construct the object with an explicit dataset ownership policy.
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearch<SortPolicy, MetricType, TreeType>::
+NeighborSearch(typename TreeType::Mat& referenceSetIn,
+               const DatasetOwnership ownership,
+               const bool naive,
+               const bool singleMode,
+               const double epsilon,
+               const MetricType metric) :
+    referenceSet((tree::TreeTraits<TreeType>::RearrangesDataset &&
+        (ownership == COPY_ON_REORDER)) ? referenceCopy : referenceSetIn),
+    querySet((tree::TreeTraits<TreeType>::RearrangesDataset &&
+        (ownership == COPY_ON_REORDER)) ? referenceCopy : referenceSetIn),
+    referenceTree(NULL),
+    queryTree(NULL),
+    treeOwner(!naive), // If naive, then we are not building any trees.
+    hasQuerySet(false),
+    ownsDataset(ownership == COPY_ON_REORDER),
+    naive(naive),
+    singleMode(!naive && singleMode), // No single mode if naive.
+    metric(metric),
+    epsilon(epsilon),
+    baseCases(0),
+    scores(0),
+    numDeleted(0),
+    rebuildThreshold(0.1),
+    autoMode(false),
+    autoProbes(false)
+{
+  if (epsilon < 0)
+    Log::Fatal << "NeighborSearch: epsilon must be non-negative!" << std::endl;
+
+  // We'll time tree building, but only if we are building trees.
+  Timer::Start("tree_building");
+
+  // Copy the dataset only if the caller asked for it; with
+  // REARRANGE_IN_PLACE, tree building permutes the caller's matrix directly
+  // and no duplicate of the data is ever made.
+  if (tree::TreeTraits<TreeType>::RearrangesDataset &&
+      (ownership == COPY_ON_REORDER))
+    referenceCopy = referenceSetIn;
+
+  // If not in naive mode, then we may need to construct trees.
+  if (!naive)
+  {
+    // The const_cast is safe; referenceSet points either to referenceCopy or
+    // to the caller's non-const matrix.
+    referenceTree = BuildTree<TreeType>(
+        const_cast<typename TreeType::Mat&>(referenceSet),
+        oldFromNewReferences);
+
+    if (!singleMode)
+      queryTree = new TreeType(*referenceTree);
+  }
+
+  // Stop the timer we started above.
+  Timer::Stop("tree_building");
+}
+
 // Construct the object.
 template<typename SortPolicy, typename MetricType, typename TreeType>
 NeighborSearch<SortPolicy, MetricType, TreeType>::NeighborSearch(
@@ -147,6 +290,7 @@ NeighborSearch<SortPolicy, MetricType, TreeType>::NeighborSearch(
     const typename TreeType::Mat& referenceSet,
     const typename TreeType::Mat& querySet,
     const bool singleMode,
+    const double epsilon,
     const MetricType metric) :
     referenceSet(referenceSet),
     querySet(querySet),
@@ -154,12 +298,21 @@ NeighborSearch<SortPolicy, MetricType, TreeType>::NeighborSearch(
     queryTree(queryTree),
     treeOwner(false),
     hasQuerySet(true),
+    ownsDataset(false),
     naive(false),
     singleMode(singleMode),
     metric(metric),
+    epsilon(epsilon),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numDeleted(0),
+    rebuildThreshold(0.1),
+    autoMode(false),
+    autoProbes(false)
 {
+  if (epsilon < 0)
+    Log::Fatal << "NeighborSearch: epsilon must be non-negative!" << std::endl;
+
   // Nothing else to initialize.
 }
 
@@ -169,6 +322,7 @@ NeighborSearch<SortPolicy, MetricType, TreeType>::NeighborSearch(
     TreeType* referenceTree,
     const typename TreeType::Mat& referenceSet,
     const bool singleMode,
+    const double epsilon,
     const MetricType metric) :
     referenceSet(referenceSet),
     querySet(referenceSet),
@@ -176,12 +330,21 @@ NeighborSearch<SortPolicy, MetricType, TreeType>::NeighborSearch(
     queryTree(NULL),
     treeOwner(false),
     hasQuerySet(false), // In this case we will own a tree, if singleMode.
+    ownsDataset(false),
     naive(false),
     singleMode(singleMode),
     metric(metric),
+    epsilon(epsilon),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numDeleted(0),
+    rebuildThreshold(0.1),
+    autoMode(false),
+    autoProbes(false)
 {
+  if (epsilon < 0)
+    Log::Fatal << "NeighborSearch: epsilon must be non-negative!" << std::endl;
+
   Timer::Start("tree_building");
 
   // The query tree cannot be the same as the reference tree.
@@ -214,13 +377,275 @@ NeighborSearch<SortPolicy, MetricType, TreeType>::~NeighborSearch()
 
 /**
  * Computes the best neighbors and stores them in resultingNeighbors and
- * distances.
+ * distances.  If there are pending insertions or deletions, the tree search
+ * is widened so that filtering the tombstoned points still leaves k live
+ * candidates, and the insertion buffer is scanned exhaustively.
  */
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearch<SortPolicy, MetricType, TreeType>::Search(
     const size_t k,
     arma::Mat<size_t>& resultingNeighbors,
     arma::mat& distances)
+{
+  // The common case: no pending changes to the reference set.
+  if ((insertedPoints.n_cols == 0) && (numDeleted == 0))
+  {
+    SearchTree(k, resultingNeighbors, distances);
+    return;
+  }
+
+  // Ask the tree for enough extra candidates that, even if every tombstoned
+  // point shows up in a candidate list, k live candidates remain.
+  const size_t kInternal = std::min(k + numDeleted, referenceSet.n_cols);
+
+  // Bounds cached in the query tree by an earlier (narrower) search would
+  // wrongly prune the widened search, so reset them.
+  if (queryTree)
+    ResetStatistics(*queryTree);
+
+  arma::Mat<size_t> treeNeighbors;
+  arma::mat treeDistances;
+  SearchTree(kInternal, treeNeighbors, treeDistances);
+
+  resultingNeighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // The results of SearchTree() are in the original point order, but the
+  // query set may have been rearranged during tree building; map each output
+  // column back to its column in querySet.
+  std::vector<size_t> queryMap(querySet.n_cols);
+  if (treeOwner && tree::TreeTraits<TreeType>::RearrangesDataset &&
+      !(singleMode && hasQuerySet))
+  {
+    const std::vector<size_t>& oldFromNew = hasQuerySet ? oldFromNewQueries :
+        oldFromNewReferences;
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      queryMap[oldFromNew[i]] = i;
+  }
+  else
+  {
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      queryMap[i] = i;
+  }
+
+  std::vector<std::pair<double, size_t> > candidates;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    candidates.clear();
+
+    // Take the candidates found in the tree, skipping tombstoned points.
+    for (size_t j = 0; j < kInternal; ++j)
+    {
+      const size_t index = treeNeighbors(j, i);
+      if (!deleted[index])
+        candidates.push_back(std::make_pair(treeDistances(j, i), index));
+    }
+
+    // Scan the insertion buffer; these points take the indices following the
+    // reference set.
+    for (size_t j = 0; j < insertedPoints.n_cols; ++j)
+    {
+      if (deleted[referenceSet.n_cols + j])
+        continue;
+
+      const double distance = metric.Evaluate(querySet.col(queryMap[i]),
+          insertedPoints.col(j));
+      candidates.push_back(std::make_pair(distance,
+          referenceSet.n_cols + j));
+    }
+
+    std::sort(candidates.begin(), candidates.end(), CandidateIsBetter);
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (j < candidates.size())
+      {
+        distances(j, i) = candidates[j].first;
+        resultingNeighbors(j, i) = candidates[j].second;
+      }
+      else
+      {
+        // Fewer than k live reference points exist.
+        distances(j, i) = SortPolicy::WorstDistance();
+        resultingNeighbors(j, i) = size_t() - 1;
+      }
+    }
+  }
+}
+
+/**
+ * Compute the results for several values of k from one traversal with the
+ * largest of them.
+ */
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::Search(
+    const std::vector<size_t>& ks,
+    std::vector<arma::Mat<size_t> >& resultingNeighbors,
+    std::vector<arma::mat>& distances)
+{
+  if (ks.empty())
+    Log::Fatal << "NeighborSearch::Search(): no values of k given!"
+        << std::endl;
+
+  size_t maxK = 0;
+  for (size_t i = 0; i < ks.size(); ++i)
+  {
+    if (ks[i] == 0)
+      Log::Fatal << "NeighborSearch::Search(): requested k of 0!"
+          << std::endl;
+    maxK = std::max(maxK, ks[i]);
+  }
+
+  // One traversal with the largest k satisfies every consumer: the candidate
+  // lists are ordered best-to-worst by SortPolicy, so the answer for each
+  // smaller k is simply the first k rows.
+  arma::Mat<size_t> allNeighbors;
+  arma::mat allDistances;
+  Search(maxK, allNeighbors, allDistances);
+
+  resultingNeighbors.resize(ks.size());
+  distances.resize(ks.size());
+  for (size_t i = 0; i < ks.size(); ++i)
+  {
+    resultingNeighbors[i] = allNeighbors.rows(0, ks[i] - 1);
+    distances[i] = allDistances.rows(0, ks[i] - 1);
+  }
+}
+
+/**
+ * Warm-started search: seed the pruning bounds from a previous result before
+ * traversing.
+ */
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::Search(
+    const size_t k,
+    const arma::Mat<size_t>& seeds,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances)
+{
+  // With pending reference-set changes the widened merge search runs; its
+  // interaction with seeded bounds (seeds may be tombstoned, and the search
+  // is widened past k) is not worth the complexity, so start cold.
+  if ((insertedPoints.n_cols > 0) || (numDeleted > 0))
+  {
+    Log::Warn << "NeighborSearch::Search(): warm-start seeds ignored because "
+        << "there are pending insertions or deletions." << std::endl;
+    Search(k, resultingNeighbors, distances);
+    return;
+  }
+
+  // Bounds cached in the query tree by an earlier search belong to that
+  // search's candidates; reset them.
+  if (queryTree)
+    ResetStatistics(*queryTree);
+
+  SearchTree(k, resultingNeighbors, distances, &seeds);
+}
+
+/**
+ * Choose the execution mode for one search from a cost model, optionally
+ * calibrated by probe queries.
+ */
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::SelectMode(
+    const size_t k,
+    bool& useNaive,
+    bool& useSingle) const
+{
+  // Without a usable reference tree (naive-mode construction), there is
+  // nothing to choose.
+  if ((referenceTree == NULL) || referenceTree->IsLeaf())
+  {
+    useNaive = true;
+    useSingle = false;
+    return;
+  }
+
+  const double d = (double) referenceSet.n_rows;
+  const double nr = (double) referenceSet.n_cols;
+  const double nq = (double) querySet.n_cols;
+
+  // Brute force evaluates one distance per query-reference pair; the GEMM
+  // formulation used for the L2 metrics (see SearchTree()) makes each pair
+  // considerably cheaper.
+  double naiveCost = nq * nr * d;
+  if (boost::is_same<MetricType, metric::EuclideanDistance>::value ||
+      boost::is_same<MetricType, metric::SquaredEuclideanDistance>::value)
+    naiveCost /= 8.0;
+
+  double singleCost;
+  double dualCost;
+
+  // Probes only pay off when they are a small part of the total work.
+  const size_t probes = 16;
+  if (autoProbes && querySet.n_cols >= 4 * probes)
+  {
+    // Run a sample of evenly spaced queries through the actual single-tree
+    // traversal and extrapolate the measured work (scores and base cases,
+    // each costing about one distance evaluation) to the whole query set.
+    arma::Mat<size_t> probeNeighbors(k, querySet.n_cols);
+    probeNeighbors.fill(size_t() - 1);
+    arma::mat probeDistances(k, querySet.n_cols);
+    probeDistances.fill(SortPolicy::WorstDistance());
+
+    typedef NeighborSearchRules<SortPolicy, MetricType, TreeType> RuleType;
+    RuleType probeRules(referenceSet, querySet, probeNeighbors,
+        probeDistances, metric, epsilon);
+    typename TreeType::template SingleTreeTraverser<RuleType>
+        probeTraverser(probeRules);
+
+    const size_t stride = querySet.n_cols / probes;
+    for (size_t i = 0; i < probes; ++i)
+      probeTraverser.Traverse(i * stride, *referenceTree);
+
+    const double perQuery = d *
+        (probeRules.Scores() + probeRules.BaseCases()) / (double) probes;
+    singleCost = nq * perQuery;
+  }
+  else
+  {
+    // Crude static model: the fraction of the reference set a tree-based
+    // query visits grows with k, shrinks with the reference set size, and
+    // pruning degrades exponentially with dimension (past a few tens of
+    // dimensions a tree-based query visits nearly everything).
+    const double visitedFraction = std::min(1.0,
+        ((k + 10.0) * (std::log(nr) / std::log(2.0)) / nr) *
+        std::pow(2.0, d / 10.0));
+    singleCost = nq * visitedFraction * nr * d;
+  }
+
+  // There is no comparably cheap probe for the dual-tree traversal (its
+  // benefit comes from the structure of the whole query tree), so its
+  // estimate is scaled from the single-tree cost: scoring work is shared
+  // between nearby queries once the query set is large enough to have
+  // structure of its own, and the traversal adds overhead when it is not.
+  dualCost = singleCost * (0.3 + 3.0 / std::sqrt(nq));
+
+  // Dual-tree traversal needs a query tree, which single-tree construction
+  // does not build.
+  if (queryTree == NULL)
+    dualCost = std::numeric_limits<double>::max();
+
+  useNaive = (naiveCost <= singleCost) && (naiveCost <= dualCost);
+  useSingle = !useNaive && (singleCost <= dualCost);
+
+  Log::Info << "NeighborSearch::SelectMode(): estimated costs: naive "
+      << naiveCost << ", single-tree " << singleCost << ", dual-tree "
+      << dualCost << "; using "
+      << (useNaive ? "naive" : (useSingle ? "single-tree" : "dual-tree"))
+      << " mode." << std::endl;
+}
+
+/**
+ * The tree-based (or naive) search, without regard for pending insertions or
+ * deletions.
+ */
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::SearchTree(
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    const arma::Mat<size_t>* seeds)
 {
   Timer::Start("computing_neighbors");
 
@@ -247,25 +672,246 @@ void NeighborSearch<SortPolicy, MetricType, TreeType>::Search(
   distancePtr->set_size(k, querySet.n_cols);
   distancePtr->fill(SortPolicy::WorstDistance());
 
+  // Seed the pruning bounds from prior results, if any were given.  The seeds
+  // are indexed like the user-facing results, so they must be translated into
+  // the internal (rearranged) point order before they can be used.
+  if (seeds != NULL)
+  {
+    if (seeds->n_cols != querySet.n_cols)
+      Log::Fatal << "NeighborSearch::Search(): seed matrix must have one "
+          << "column per query point!" << std::endl;
+
+    const bool refsMapped = treeOwner &&
+        tree::TreeTraits<TreeType>::RearrangesDataset;
+    const bool queriesMapped = refsMapped && !(singleMode && hasQuerySet);
+
+    // Invert the mappings once, instead of searching them per seed.
+    std::vector<size_t> newFromOldRefs;
+    std::vector<size_t> newFromOldQueries;
+    if (refsMapped)
+    {
+      newFromOldRefs.resize(oldFromNewReferences.size());
+      for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+        newFromOldRefs[oldFromNewReferences[i]] = i;
+    }
+    if (queriesMapped)
+    {
+      const std::vector<size_t>& oldFromNew = hasQuerySet ?
+          oldFromNewQueries : oldFromNewReferences;
+      newFromOldQueries.resize(oldFromNew.size());
+      for (size_t i = 0; i < oldFromNew.size(); ++i)
+        newFromOldQueries[oldFromNew[i]] = i;
+    }
+
+    std::vector<double> verified;
+    for (size_t i = 0; i < seeds->n_cols; ++i)
+    {
+      const size_t queryIndex = queriesMapped ? newFromOldQueries[i] : i;
+
+      // Verify each seed against the current reference set; a stale or
+      // invalid index (such as the placeholder size_t() - 1) is skipped.
+      verified.clear();
+      for (size_t j = 0; j < seeds->n_rows; ++j)
+      {
+        const size_t seed = (*seeds)(j, i);
+        if (seed >= referenceSet.n_cols)
+          continue;
+        const size_t refIndex = refsMapped ? newFromOldRefs[seed] : seed;
+        if ((&querySet == &referenceSet) && (queryIndex == refIndex))
+          continue; // Monochromatic searches exclude the point itself.
+
+        verified.push_back(metric.Evaluate(querySet.unsafe_col(queryIndex),
+            referenceSet.unsafe_col(refIndex)));
+      }
+
+      // Fewer than k usable seeds cannot bound the k'th neighbor.
+      if (verified.size() < k)
+        continue;
+
+      std::sort(verified.begin(), verified.end(), SortPolicy::IsBetter);
+
+      // The k'th best verified distance bounds the true k'th neighbor, but an
+      // exact bound would prune nodes holding candidates tied with it, and
+      // the traversal still has to re-find every candidate (the lists below
+      // hold only placeholders).  Pad the bound by a slack term covering ties
+      // and floating-point error, exactly as the GEMM prefilter does.
+      const double kthBest = verified[k - 1];
+      const double slack = 1e-10 * (std::abs(kthBest) + 1.0);
+      distancePtr->col(queryIndex).fill(
+          SortPolicy::CombineWorst(kthBest, slack));
+    }
+  }
+
   // Create the helper object for the tree traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, TreeType> RuleType;
-  RuleType rules(referenceSet, querySet, *neighborPtr, *distancePtr, metric);
+  RuleType rules(referenceSet, querySet, *neighborPtr, *distancePtr, metric,
+      epsilon);
+
+  // Choose the execution mode for this call, if automatic dispatch is
+  // enabled; the construction-time flags are the defaults.  The choice only
+  // affects the traversal below -- the result mapping depends on how the
+  // datasets were rearranged at construction time, which does not change.
+  bool useNaive = naive;
+  bool useSingle = singleMode;
+  if (autoMode)
+    SelectMode(k, useNaive, useSingle);
 
-  if (naive)
+  if (useNaive)
   {
-    // The naive brute-force traversal.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet.n_cols; ++j)
-        rules.BaseCase(i, j);
+    // For the L2 metrics, the squared distances of a whole tile of
+    // query-reference pairs can be assembled at once from the squared norms
+    // and the inner products (||a - b||^2 = ||a||^2 + ||b||^2 - 2 a'b), with
+    // the inner products computed by one matrix product per tile.  This
+    // replaces the per-pair distance loop with GEMM, which is far faster for
+    // the small reference sets naive mode is used on.  The tiled values only
+    // prefilter: any pair that could make the candidate list (allowing a
+    // slack term covering the floating-point error of the decomposition) is
+    // handed to BaseCase(), which evaluates the metric directly, so the
+    // results are identical to those of the plain loop.
+    const bool gemmCompatible =
+        boost::is_same<MetricType, metric::EuclideanDistance>::value ||
+        boost::is_same<MetricType, metric::SquaredEuclideanDistance>::value;
+
+    if (gemmCompatible)
+    {
+      // Whether the candidate list holds rooted distances, which must be
+      // squared before they can be compared with the tiled values.
+      const bool takeRoot =
+          boost::is_same<MetricType, metric::EuclideanDistance>::value;
+
+      // Precompute the squared norm of every point.
+      arma::vec refNorms(referenceSet.n_cols);
+      for (size_t i = 0; i < referenceSet.n_cols; ++i)
+        refNorms[i] = arma::dot(referenceSet.unsafe_col(i),
+                                referenceSet.unsafe_col(i));
+      arma::vec queryNorms(querySet.n_cols);
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+        queryNorms[i] = arma::dot(querySet.unsafe_col(i),
+                                  querySet.unsafe_col(i));
+
+      // Tile sizes chosen so a tile of inner products (and the running tiles
+      // of both operands) stays cache-resident.
+      static const size_t queryTileSize = 64;
+      static const size_t refTileSize = 256;
+      const size_t numQueryTiles = (querySet.n_cols + queryTileSize - 1) /
+          queryTileSize;
+
+      // Each query point writes only to its own column of the results, so
+      // the query tiles can be handled in parallel; each thread uses its own
+      // rule set to keep the internal bookkeeping of the rules thread-local.
+      #ifdef _OPENMP
+      #pragma omp parallel
+      #endif
+      {
+        RuleType threadRules(referenceSet, querySet, *neighborPtr,
+            *distancePtr, metric, epsilon);
+
+        #ifdef _OPENMP
+        #pragma omp for schedule(dynamic)
+        #endif
+        // The loop index is signed for OpenMP.
+        for (long tile = 0; tile < (long) numQueryTiles; ++tile)
+        {
+          const size_t qStart = tile * queryTileSize;
+          const size_t qEnd = std::min(qStart + queryTileSize,
+              (size_t) querySet.n_cols);
+
+          for (size_t rStart = 0; rStart < referenceSet.n_cols;
+               rStart += refTileSize)
+          {
+            const size_t rEnd = std::min(rStart + refTileSize,
+                (size_t) referenceSet.n_cols);
+
+            // One GEMM for all inner products of the tile.
+            const arma::mat products =
+                arma::trans(querySet.cols(qStart, qEnd - 1)) *
+                referenceSet.cols(rStart, rEnd - 1);
+
+            for (size_t q = qStart; q < qEnd; ++q)
+            {
+              for (size_t r = rStart; r < rEnd; ++r)
+              {
+                const double tileDistance = queryNorms[q] + refNorms[r] -
+                    2.0 * products(q - qStart, r - rStart);
+
+                // Compare against the worst kept candidate, moved in the
+                // candidate's favor by a slack covering the floating-point
+                // error of the decomposition, so no pair that the exact
+                // distance would admit is ever filtered out.
+                double bound = (*distancePtr)(0, q);
+                if (takeRoot)
+                  bound *= bound;
+                const double slack = 1e-10 *
+                    (queryNorms[q] + refNorms[r] + 1.0);
+
+                if (!SortPolicy::IsBetter(
+                    SortPolicy::CombineWorst(bound, slack), tileDistance))
+                  threadRules.BaseCase(q, r);
+              }
+            }
+          }
+        }
+      }
+    }
+    else
+    {
+      // The naive brute-force traversal for metrics without a GEMM
+      // formulation.  Each query point writes only to its own column of the
+      // results, so the queries can be handled in parallel; each thread uses
+      // its own rule set to keep the internal bookkeeping of the rules
+      // thread-local.
+      #ifdef _OPENMP
+      #pragma omp parallel
+      {
+        RuleType threadRules(referenceSet, querySet, *neighborPtr,
+            *distancePtr, metric, epsilon);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < querySet.n_cols; ++i)
+          for (size_t j = 0; j < referenceSet.n_cols; ++j)
+            threadRules.BaseCase(i, j);
+      }
+      #else
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+        for (size_t j = 0; j < referenceSet.n_cols; ++j)
+          rules.BaseCase(i, j);
+      #endif
+    }
 
     baseCases += querySet.n_cols * referenceSet.n_cols;
   }
-  else if (singleMode)
+  else if (useSingle)
   {
     // The search doesn't work if the root node is also a leaf node.
     // If this is the case, it is suggested that you use the naive method.
     Log::Assert(!(referenceTree->IsLeaf()));
 
+    size_t localScores = 0;
+    size_t localBaseCases = 0;
+
+    // Each query point traverses the reference tree independently and writes
+    // only to its own column of the results, so the queries can be handled in
+    // parallel with one traverser (and rule set) per thread.
+    #ifdef _OPENMP
+    #pragma omp parallel
+    {
+      RuleType threadRules(referenceSet, querySet, *neighborPtr, *distancePtr,
+          metric, epsilon);
+      typename TreeType::template SingleTreeTraverser<RuleType>
+          threadTraverser(threadRules);
+
+      // Dynamic scheduling, since different query points can take very
+      // different amounts of pruning work.
+      #pragma omp for schedule(dynamic, 64)
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+        threadTraverser.Traverse(i, *referenceTree);
+
+      #pragma omp atomic
+      localScores += threadRules.Scores();
+      #pragma omp atomic
+      localBaseCases += threadRules.BaseCases();
+    }
+    #else
     // Create the traverser.
     typename TreeType::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -273,16 +919,23 @@ void NeighborSearch<SortPolicy, MetricType, TreeType>::Search(
     for (size_t i = 0; i < querySet.n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
 
-    scores += rules.Scores();
-    baseCases += rules.BaseCases();
+    localScores += rules.Scores();
+    localBaseCases += rules.BaseCases();
+    #endif
 
-    Log::Info << rules.Scores() << " node combinations were scored.\n";
-    Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+    scores += localScores;
+    baseCases += localBaseCases;
+
+    Log::Info << localScores << " node combinations were scored.\n";
+    Log::Info << localBaseCases << " base cases were calculated.\n";
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename TreeType::template DualTreeTraverser<RuleType> traverser(rules);
+    // Create the traverser.  When OpenMP is available, this splits the query
+    // tree into disjoint subtrees that are traversed against the reference
+    // tree as parallel tasks; without OpenMP it runs the ordinary serial
+    // dual-tree traversal.
+    tree::ParallelDualTreeTraverser<TreeType, RuleType> traverser(rules);
 
     traverser.Traverse(*queryTree, *referenceTree);
 
@@ -293,8 +946,121 @@ void NeighborSearch<SortPolicy, MetricType, TreeType>::Search(
     Log::Info << rules.BaseCases() << " base cases were calculated.\n";
   }
 
+  // The candidate list of each query point is stored as a heap with the worst
+  // candidate first; sort each list so the best neighbor comes first.
+  SortResults(*neighborPtr, *distancePtr);
+
+  Timer::Stop("computing_neighbors");
+
+  MapResults(k, neighborPtr, distancePtr, resultingNeighbors, distances);
+} // SearchTree
+
+/**
+ * Defeatist search, emulating a spill tree with the given overlap buffer; see
+ * GreedySingleTreeTraverser for the traversal semantics.
+ */
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::SearchDefeatist(
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    const double overlap)
+{
+  if (naive || (referenceTree == NULL))
+    Log::Fatal << "NeighborSearch::SearchDefeatist(): defeatist search "
+        << "requires a built reference tree!" << std::endl;
+
+  // Defeatist search has no mechanism for merging with the insertion buffer,
+  // so fold any pending reference set updates in first.
+  if ((insertedPoints.n_cols > 0) || (numDeleted > 0))
+    Rebuild();
+
+  Timer::Start("computing_neighbors");
+
+  // As in SearchTree(), results are computed into temporary matrices if the
+  // indices will need to be mapped back afterwards.
+  arma::Mat<size_t>* neighborPtr = &resultingNeighbors;
+  arma::mat* distancePtr = &distances;
+
+  if (tree::TreeTraits<TreeType>::RearrangesDataset)
+  {
+    if (treeOwner && !(singleMode && hasQuerySet))
+      distancePtr = new arma::mat; // Query indices need to be mapped.
+
+    if (treeOwner)
+      neighborPtr = new arma::Mat<size_t>; // All indices need mapping.
+  }
+
+  neighborPtr->set_size(k, querySet.n_cols);
+  neighborPtr->fill(size_t() - 1);
+  distancePtr->set_size(k, querySet.n_cols);
+  distancePtr->fill(SortPolicy::WorstDistance());
+
+  typedef NeighborSearchRules<SortPolicy, MetricType, TreeType> RuleType;
+  RuleType rules(referenceSet, querySet, *neighborPtr, *distancePtr, metric,
+      epsilon);
+
+  // The search doesn't work if the root node is also a leaf node.
+  Log::Assert(!(referenceTree->IsLeaf()));
+
+  size_t localScores = 0;
+  size_t localBaseCases = 0;
+
+  // As with the exact single-tree search, each query point writes only to its
+  // own column of the results, so the queries can be handled in parallel.
+  #ifdef _OPENMP
+  #pragma omp parallel
+  {
+    RuleType threadRules(referenceSet, querySet, *neighborPtr, *distancePtr,
+        metric, epsilon);
+    typename TreeType::template GreedySingleTreeTraverser<RuleType>
+        threadTraverser(threadRules, overlap);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      threadTraverser.Traverse(i, *referenceTree);
+
+    #pragma omp atomic
+    localScores += threadRules.Scores();
+    #pragma omp atomic
+    localBaseCases += threadRules.BaseCases();
+  }
+  #else
+  typename TreeType::template GreedySingleTreeTraverser<RuleType>
+      traverser(rules, overlap);
+
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    traverser.Traverse(i, *referenceTree);
+
+  localScores += rules.Scores();
+  localBaseCases += rules.BaseCases();
+  #endif
+
+  scores += localScores;
+  baseCases += localBaseCases;
+
+  Log::Info << localScores << " node combinations were scored.\n";
+  Log::Info << localBaseCases << " base cases were calculated.\n";
+
+  SortResults(*neighborPtr, *distancePtr);
+
   Timer::Stop("computing_neighbors");
 
+  MapResults(k, neighborPtr, distancePtr, resultingNeighbors, distances);
+}
+
+/**
+ * Map search results held in the given (possibly temporary) matrices back to
+ * the original point indices.
+ */
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::MapResults(
+    const size_t k,
+    arma::Mat<size_t>* neighborPtr,
+    arma::mat* distancePtr,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances)
+{
   // Now, do we need to do mapping of indices?
   if (!treeOwner || !tree::TreeTraits<TreeType>::RearrangesDataset)
   {
@@ -363,10 +1129,170 @@ void NeighborSearch<SortPolicy, MetricType, TreeType>::Search(
     // Finished with temporary matrix.
     delete neighborPtr;
   }
-} // Search
+} // MapResults
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename VecType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::InsertPoint(
+    const VecType& point)
+{
+  CheckUpdateSupport("InsertPoint()");
+
+  if (point.n_elem != referenceSet.n_rows)
+    Log::Fatal << "NeighborSearch::InsertPoint(): point dimensionality ("
+        << point.n_elem << ") does not match the reference set ("
+        << referenceSet.n_rows << ")!" << std::endl;
+
+  if (deleted.empty())
+    deleted.resize(referenceSet.n_cols, false);
+
+  const size_t col = insertedPoints.n_cols;
+  insertedPoints.resize(referenceSet.n_rows, col + 1);
+  insertedPoints.col(col) = point;
+  deleted.push_back(false);
+
+  CheckRebuild();
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::DeletePoint(
+    const size_t index)
+{
+  CheckUpdateSupport("DeletePoint()");
+
+  if (deleted.empty())
+    deleted.resize(referenceSet.n_cols + insertedPoints.n_cols, false);
+
+  if (index >= deleted.size())
+    Log::Fatal << "NeighborSearch::DeletePoint(): index " << index
+        << " is out of range (" << deleted.size() << " points)!" << std::endl;
+
+  if (deleted[index])
+    Log::Fatal << "NeighborSearch::DeletePoint(): point " << index
+        << " has already been deleted!" << std::endl;
+
+  deleted[index] = true;
+  ++numDeleted;
+
+  CheckRebuild();
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::Rebuild()
+{
+  CheckUpdateSupport("Rebuild()");
+
+  if ((insertedPoints.n_cols == 0) && (numDeleted == 0))
+    return; // Nothing to fold in.
+
+  Timer::Start("tree_building");
+
+  // Assemble the surviving points into a new reference set: first the
+  // surviving original points, then the surviving inserted points.
+  const size_t total = referenceSet.n_cols + insertedPoints.n_cols;
+  typename TreeType::Mat newSet(referenceSet.n_rows, total - numDeleted);
+  size_t current = 0;
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+    if (!deleted[i])
+      newSet.col(current++) = referenceSet.col(i);
+  for (size_t i = 0; i < insertedPoints.n_cols; ++i)
+    if (!deleted[referenceSet.n_cols + i])
+      newSet.col(current++) = insertedPoints.col(i);
+
+  referenceCopy = newSet;
+  insertedPoints.set_size(referenceSet.n_rows, 0);
+  deleted.clear();
+  numDeleted = 0;
+
+  // Rebuild the trees over the new set (in naive mode there are none).
+  if (referenceTree)
+  {
+    delete referenceTree;
+
+    if (queryTree && !hasQuerySet)
+    {
+      // The query tree was a replica of the reference tree.
+      delete queryTree;
+      queryTree = NULL;
+    }
+
+    oldFromNewReferences.clear();
+    referenceTree = BuildTree<TreeType>(
+        const_cast<typename TreeType::Mat&>(referenceSet),
+        oldFromNewReferences);
+
+    if (!singleMode && !hasQuerySet)
+      queryTree = new TreeType(*referenceTree);
+
+    // Bounds cached in an existing query tree by earlier searches do not
+    // apply to the new reference set.
+    if (queryTree && hasQuerySet)
+      ResetStatistics(*queryTree);
+  }
+
+  Timer::Stop("tree_building");
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::CheckUpdateSupport(
+    const char* functionName) const
+{
+  // We must be able to rewrite the reference set (it has to point to our own
+  // referenceCopy), and any tree must be our own so we can rebuild it.
+  if (!(treeOwner || naive) ||
+      !tree::TreeTraits<TreeType>::RearrangesDataset)
+    Log::Fatal << "NeighborSearch::" << functionName << ": incremental "
+        << "reference set updates are only available when this object built "
+        << "(and owns) its own tree!" << std::endl;
+
+  if (!ownsDataset)
+    Log::Fatal << "NeighborSearch::" << functionName << ": incremental "
+        << "reference set updates are not available with REARRANGE_IN_PLACE, "
+        << "since folding updates in must rewrite the dataset!" << std::endl;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::ResetStatistics(
+    TreeType& node)
+{
+  node.Stat() = NeighborSearchStat<SortPolicy>(node);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    ResetStatistics(node.Child(i));
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::CheckRebuild()
+{
+  if ((double) (insertedPoints.n_cols + numDeleted) >
+      rebuildThreshold * referenceSet.n_cols)
+    Rebuild();
+}
 
 
 //Return a String of the Object.
+// Sort each column of the results; the search leaves each column in heap
+// order with the worst candidate first.
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearch<SortPolicy, MetricType, TreeType>::SortResults(
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  std::vector<std::pair<double, size_t> > candidates(distances.n_rows);
+  for (size_t i = 0; i < distances.n_cols; ++i)
+  {
+    for (size_t j = 0; j < distances.n_rows; ++j)
+      candidates[j] = std::make_pair(distances(j, i), neighbors(j, i));
+
+    std::sort(candidates.begin(), candidates.end(), CandidateIsBetter);
+
+    for (size_t j = 0; j < distances.n_rows; ++j)
+    {
+      distances(j, i) = candidates[j].first;
+      neighbors(j, i) = candidates[j].second;
+    }
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 std::string NeighborSearch<SortPolicy, MetricType, TreeType>::ToString() const
 {
@@ -21,7 +21,8 @@ class NeighborSearchRules
                       const typename TreeType::Mat& querySet,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
-                      MetricType& metric);
+                      MetricType& metric,
+                      const double epsilon = 0.0);
   /**
    * Get the distance from the query point to the reference point.
    * This will update the "neighbor" matrix with the new point if appropriate
@@ -32,6 +33,21 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Get the distance from the query point to each point in a contiguous block
+   * of reference points (the points of a leaf node), updating the list of
+   * candidates as necessary.  This is a batched form of BaseCase() that skips
+   * the per-pair bookkeeping, so the inner loop reduces to the distance
+   * evaluation and one comparison against the worst candidate.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point in the block.
+   * @param referenceEnd Index one past the last reference point in the block.
+   */
+  void BaseCases(const size_t queryIndex,
+                 const size_t referenceBegin,
+                 const size_t referenceEnd);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -92,6 +108,18 @@ class NeighborSearchRules
   //! Modify the number of scores that have been performed.
   size_t& Scores() { return scores; }
 
+  /**
+   * Merge the statistics of a thread-local copy of the rules back into this
+   * object.  This is required by tree::ParallelDualTreeTraverser; the results
+   * themselves need no merging, since each query point owns its column of the
+   * output matrices.
+   */
+  void Merge(const NeighborSearchRules& other)
+  {
+    baseCases += other.baseCases;
+    scores += other.scores;
+  }
+
   //! Convenience typedef.
   typedef NeighborSearchTraversalInfo<TreeType> TraversalInfoType;
 
@@ -116,6 +144,9 @@ class NeighborSearchRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! The allowed relative error for approximate search (0 means exact).
+  const double epsilon;
+
   //! The last query point BaseCase() was called with.
   size_t lastQueryIndex;
   //! The last reference point BaseCase() was called with.
@@ -139,15 +170,15 @@ class NeighborSearchRules
 
   /**
    * Insert a point into the neighbors and distances matrices; this is a helper
-   * function.
+   * function.  The candidate list of each query point is a binary heap with
+   * the worst candidate at the top; the new candidate replaces the top and is
+   * sifted down in O(log k).
    *
    * @param queryIndex Index of point whose neighbors we are inserting into.
-   * @param pos Position in list to insert into.
    * @param neighbor Index of reference point which is being inserted.
    * @param distance Distance from query point to reference point.
    */
   void InsertNeighbor(const size_t queryIndex,
-                      const size_t pos,
                       const size_t neighbor,
                       const double distance);
 };
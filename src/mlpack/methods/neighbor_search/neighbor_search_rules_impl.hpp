@@ -19,12 +19,14 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const typename TreeType::Mat& querySet,
     arma::Mat<size_t>& neighbors,
     arma::mat& distances,
-    MetricType& metric) :
+    MetricType& metric,
+    const double epsilon) :
     referenceSet(referenceSet),
     querySet(querySet),
     neighbors(neighbors),
     distances(distances),
     metric(metric),
+    epsilon(epsilon),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
@@ -55,16 +57,11 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
                                     referenceSet.col(referenceIndex));
   ++baseCases;
 
-  // If this distance is better than any of the current candidates, the
-  // SortDistance() function will give us the position to insert it into.
-  arma::vec queryDist = distances.unsafe_col(queryIndex);
-  arma::Col<size_t> queryIndices = neighbors.unsafe_col(queryIndex);
-  const size_t insertPosition = SortPolicy::SortDistance(queryDist,
-      queryIndices, distance);
-
-  // SortDistance() returns (size_t() - 1) if we shouldn't add it.
-  if (insertPosition != (size_t() - 1))
-    InsertNeighbor(queryIndex, insertPosition, referenceIndex, distance);
+  // The candidate list of each query point is kept as a binary heap with the
+  // worst candidate on top, so a single O(1) comparison against the top tells
+  // us whether this point belongs in the list at all.
+  if (!SortPolicy::IsBetter(distances(0, queryIndex), distance))
+    InsertNeighbor(queryIndex, referenceIndex, distance);
 
   // Cache this information for the next time BaseCase() is called.
   lastQueryIndex = queryIndex;
@@ -74,6 +71,64 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCases(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceEnd)
+{
+  // The caching done by BaseCase() is not needed here: a pair's distance never
+  // changes, so a stale cache entry can never become incorrect, and skipping
+  // the cache update leaves only the distance evaluation and the bound check
+  // in the inner loop.
+  //
+  // The bound check itself is done a block at a time through the sort
+  // policy's CandidateMask(), whose branch-free comparison loop the compiler
+  // can vectorize; almost all points fail the bound, so the unpredictable
+  // per-point branch is replaced by one well-predicted branch per block.
+  static const size_t blockSize = 8;
+  double distBlock[blockSize];
+  size_t indexBlock[blockSize];
+  unsigned char mask[blockSize];
+
+  size_t i = referenceBegin;
+  while (i < referenceEnd)
+  {
+    // Evaluate distances for the next block of reference points.
+    size_t filled = 0;
+    while ((filled < blockSize) && (i < referenceEnd))
+    {
+      // Do not return identical points if the sets are the same.
+      if ((&querySet == &referenceSet) && (queryIndex == i))
+      {
+        ++i;
+        continue;
+      }
+
+      distBlock[filled] = metric.Evaluate(querySet.col(queryIndex),
+                                          referenceSet.col(i));
+      indexBlock[filled] = i;
+      ++filled;
+      ++i;
+    }
+
+    if (SortPolicy::CandidateMask(distBlock, filled, distances(0, queryIndex),
+        mask) == 0)
+      continue; // Nothing in this block can make the candidate list.
+
+    // The bound tightens as candidates are inserted, so the flagged entries
+    // are re-checked against the live bound before insertion.
+    for (size_t j = 0; j < filled; ++j)
+    {
+      if (mask[j] &&
+          !SortPolicy::IsBetter(distances(0, queryIndex), distBlock[j]))
+        InsertNeighbor(queryIndex, indexBlock[j], distBlock[j]);
+    }
+  }
+
+  baseCases += (referenceEnd - referenceBegin);
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -107,10 +162,27 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   {
     distance = SortPolicy::BestPointToNodeDistance(querySet.col(queryIndex),
         &referenceNode);
+
+    // If the sort policy uses the auxiliary centroid bound (furthest neighbor
+    // search), the distance through the cached centroid and descendant
+    // distance is also a valid best-case distance, and is often far tighter
+    // than the bound-based distance; take whichever prunes more.
+    if (SortPolicy::NeedsAuxiliaryBound &&
+        (referenceNode.Stat().AuxDescendantDistance() >= 0.0))
+    {
+      const double auxDistance = metric.Evaluate(querySet.col(queryIndex),
+          referenceNode.Stat().Centroid()) +
+          referenceNode.Stat().AuxDescendantDistance();
+      if (SortPolicy::IsBetter(distance, auxDistance))
+        distance = auxDistance;
+    }
   }
 
-  // Compare against the best k'th distance for this query point so far.
-  const double bestDistance = distances(distances.n_rows - 1, queryIndex);
+  // Compare against the best k'th distance for this query point so far; that
+  // is the worst candidate, which sits on top of the heap.  For approximate
+  // search the bound is relaxed by epsilon.
+  const double bestDistance = SortPolicy::Relax(distances(0, queryIndex),
+      epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? distance : DBL_MAX;
 }
@@ -125,8 +197,11 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   if (oldScore == DBL_MAX)
     return oldScore;
 
-  // Just check the score again against the distances.
-  const double bestDistance = distances(distances.n_rows - 1, queryIndex);
+  // Just check the score again against the distances.  The worst candidate
+  // sits on top of the heap.  For approximate search the bound is relaxed by
+  // epsilon.
+  const double bestDistance = SortPolicy::Relax(distances(0, queryIndex),
+      epsilon);
 
   return (SortPolicy::IsBetter(oldScore, bestDistance)) ? oldScore : DBL_MAX;
 }
@@ -138,8 +213,10 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
 {
   ++scores; // Count number of Score() calls.
 
-  // Update our bound.
-  const double bestDistance = CalculateBound(queryNode);
+  // Update our bound.  For approximate search the bound is relaxed by
+  // epsilon; the bound cached in the statistic stays exact.
+  const double bestDistance = SortPolicy::Relax(CalculateBound(queryNode),
+      epsilon);
 
   // Use the traversal info to see if a parent-child or parent-parent prune is
   // possible.  This is a looser bound than we could make, but it might be
@@ -272,6 +349,22 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   else
   {
     distance = SortPolicy::BestNodeToNodeDistance(&queryNode, &referenceNode);
+
+    // If the sort policy uses the auxiliary centroid bound (furthest neighbor
+    // search), the distance through the cached centroids and descendant
+    // distances is also a valid best-case distance, and is often far tighter
+    // than the bound-based distance; take whichever prunes more.
+    if (SortPolicy::NeedsAuxiliaryBound &&
+        (queryNode.Stat().AuxDescendantDistance() >= 0.0) &&
+        (referenceNode.Stat().AuxDescendantDistance() >= 0.0))
+    {
+      const double auxDistance = metric.Evaluate(queryNode.Stat().Centroid(),
+          referenceNode.Stat().Centroid()) +
+          queryNode.Stat().AuxDescendantDistance() +
+          referenceNode.Stat().AuxDescendantDistance();
+      if (SortPolicy::IsBetter(distance, auxDistance))
+        distance = auxDistance;
+    }
   }
 
   if (SortPolicy::IsBetter(distance, bestDistance))
@@ -301,8 +394,10 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   if (oldScore == DBL_MAX)
     return oldScore;
 
-  // Update our bound.
-  const double bestDistance = CalculateBound(queryNode);
+  // Update our bound.  For approximate search the bound is relaxed by
+  // epsilon; the bound cached in the statistic stays exact.
+  const double bestDistance = SortPolicy::Relax(CalculateBound(queryNode),
+      epsilon);
 
   return (SortPolicy::IsBetter(oldScore, bestDistance)) ? oldScore : DBL_MAX;
 }
@@ -346,7 +441,8 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = distances(distances.n_rows - 1, queryNode.Point(i));
+    // The worst candidate of each point sits on top of its heap.
+    const double distance = distances(0, queryNode.Point(i));
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestDistance))
@@ -406,34 +502,49 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
 
 /**
  * Helper function to insert a point into the neighbors and distances matrices.
+ * The candidate list of each query point is a binary heap with the worst
+ * candidate at the top, so insertion replaces the top and sifts the new
+ * candidate down in O(log k) instead of shifting the list in O(k).  The lists
+ * are sorted once, after the search finishes.
  *
  * @param queryIndex Index of point whose neighbors we are inserting into.
- * @param pos Position in list to insert into.
  * @param neighbor Index of reference point which is being inserted.
  * @param distance Distance from query point to reference point.
  */
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::InsertNeighbor(
     const size_t queryIndex,
-    const size_t pos,
     const size_t neighbor,
     const double distance)
 {
-  // We only memmove() if there is actually a need to shift something.
-  if (pos < (distances.n_rows - 1))
+  double* dist = distances.colptr(queryIndex);
+  size_t* ind = neighbors.colptr(queryIndex);
+  const size_t k = distances.n_rows;
+
+  // Replace the worst candidate, then sift it down to restore the heap
+  // property (no element is better than its children).
+  dist[0] = distance;
+  ind[0] = neighbor;
+
+  size_t i = 0;
+  while (true)
   {
-    int len = (distances.n_rows - 1) - pos;
-    memmove(distances.colptr(queryIndex) + (pos + 1),
-        distances.colptr(queryIndex) + pos,
-        sizeof(double) * len);
-    memmove(neighbors.colptr(queryIndex) + (pos + 1),
-        neighbors.colptr(queryIndex) + pos,
-        sizeof(size_t) * len);
-  }
+    const size_t left = 2 * i + 1;
+    const size_t right = left + 1;
+    size_t worst = i;
 
-  // Now put the new information in the right index.
-  distances(pos, queryIndex) = distance;
-  neighbors(pos, queryIndex) = neighbor;
+    if ((left < k) && SortPolicy::IsBetter(dist[worst], dist[left]))
+      worst = left;
+    if ((right < k) && SortPolicy::IsBetter(dist[worst], dist[right]))
+      worst = right;
+
+    if (worst == i)
+      break;
+
+    std::swap(dist[i], dist[worst]);
+    std::swap(ind[i], ind[worst]);
+    i = worst;
+  }
 }
 
 }; // namespace neighbor
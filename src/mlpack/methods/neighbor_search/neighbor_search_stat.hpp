@@ -37,6 +37,17 @@ class NeighborSearchStat
   //! The last distance evaluation.
   double lastDistance;
 
+  //! The centroid of the node's bound, cached for the auxiliary bound below
+  //! (only filled when the sort policy uses the auxiliary bound).
+  arma::vec centroid;
+  //! An upper bound on the distance from the centroid to any descendant point
+  //! of the node, or -1 if it is not available.  This is typically far
+  //! smaller than the distance from the centroid to the corner of the bound,
+  //! so it gives a much tighter upper bound on the distance to any point the
+  //! node actually holds (see the traversal tightening in
+  //! NeighborSearchRules::Score()).
+  double auxDescendantDistance;
+
  public:
   /**
    * Initialize the statistic with the worst possible distance according to
@@ -47,19 +58,67 @@ class NeighborSearchStat
       secondBound(SortPolicy::WorstDistance()),
       bound(SortPolicy::WorstDistance()),
       lastDistanceNode(NULL),
-      lastDistance(0.0) { }
+      lastDistance(0.0),
+      auxDescendantDistance(-1.0) { }
 
   /**
-   * Initialization for a fully initialized node.  In this case, we don't need
-   * to worry about the node.
+   * Initialize the statistic for the given node.  If the sort policy uses the
+   * auxiliary centroid bound, it is assembled here: directly from the points
+   * for a node without children, and from the children's statistics
+   * otherwise.  Statistics are built from the leaves up, so the children's
+   * auxiliary bounds are complete by the time the parent's is assembled; if a
+   * child's bound is missing (as for trees that build statistics on empty
+   * nodes and then insert points, like the rectangle trees), the sentinel is
+   * kept and the traversal falls back to plain bound-based distances.
    */
   template<typename TreeType>
-  NeighborSearchStat(TreeType& /* node */) :
+  NeighborSearchStat(TreeType& node) :
       firstBound(SortPolicy::WorstDistance()),
       secondBound(SortPolicy::WorstDistance()),
       bound(SortPolicy::WorstDistance()),
       lastDistanceNode(NULL),
-      lastDistance(0.0) { }
+      lastDistance(0.0),
+      auxDescendantDistance(-1.0)
+  {
+    if (!SortPolicy::NeedsAuxiliaryBound)
+      return;
+
+    node.Centroid(centroid);
+
+    // Bound the distance from the centroid to each point the node holds
+    // itself.
+    double maxDistance = 0.0;
+    bool complete = (node.NumPoints() > 0) || (node.NumChildren() > 0);
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+    {
+      const double distance = node.Metric().Evaluate(centroid,
+          node.Dataset().col(node.Point(i)));
+      if (distance > maxDistance)
+        maxDistance = distance;
+    }
+
+    // Bound the distance to the descendants of each child through the
+    // child's own auxiliary bound and the distance between the centroids.
+    arma::vec childCentroid;
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const double childAux = node.Child(i).Stat().AuxDescendantDistance();
+      if (childAux < 0.0)
+      {
+        complete = false;
+        break;
+      }
+
+      node.Child(i).Centroid(childCentroid);
+      const double distance = node.Metric().Evaluate(centroid, childCentroid)
+          + childAux;
+      if (distance > maxDistance)
+        maxDistance = distance;
+    }
+
+    if (complete)
+      auxDescendantDistance = maxDistance;
+  }
 
   //! Get the first bound.
   double FirstBound() const { return firstBound; }
@@ -81,6 +140,10 @@ class NeighborSearchStat
   double LastDistance() const { return lastDistance; }
   //! Modify the last distance calculation.
   double& LastDistance() { return lastDistance; }
+  //! Get the cached centroid of the node's bound.
+  const arma::vec& Centroid() const { return centroid; }
+  //! Get the auxiliary descendant distance bound (-1 if not available).
+  double AuxDescendantDistance() const { return auxDescendantDistance; }
 };
 
 }; // namespace neighbor
@@ -0,0 +1,114 @@
+/**
+ * @file quantized_knn.hpp
+ * @author Ryan Curtin
+ *
+ * Approximate k-nearest-neighbor search over an 8-bit quantized copy of the
+ * reference set, with exact re-ranking of the top candidates.
+ */
+#ifndef __MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_KNN_HPP
+#define __MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_KNN_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * This class performs approximate k-nearest-neighbor search by scanning an
+ * 8-bit quantized copy of the reference set instead of the original
+ * double-precision data.  Each dimension is affinely quantized to a byte with
+ * its own offset and scale (taken from the dimension's range), which shrinks
+ * the scanned representation by a factor of 8 relative to an arma::mat and by
+ * the same factor cuts the memory bandwidth of the scan, which is what bounds
+ * a flat scan's speed on large reference sets.
+ *
+ * The search itself is a two-phase scan: the quantized distances rank every
+ * reference point and keep the best k * rerankFactor candidates, and the
+ * candidates are then re-ranked exactly against the original reference set,
+ * so the only approximation error is a true neighbor whose quantized distance
+ * falls outside the candidate set.  Larger rerank factors make that less
+ * likely at the cost of more exact evaluations.  The inner scan loop is plain
+ * elementwise arithmetic over contiguous bytes, which compilers vectorize;
+ * this tree deliberately carries no instruction-set-specific kernels.
+ *
+ * The original reference set is held by reference for the re-ranking phase
+ * and the quantized copy is built in the constructor.  Queries are quantized
+ * with the reference set's offsets and scales (clamped to the byte range), so
+ * query points need not lie inside the reference set's bounding box.
+ */
+class QuantizedKNN
+{
+ public:
+  /**
+   * Construct the QuantizedKNN object with the given reference set, building
+   * the quantized copy.
+   *
+   * @param referenceSet Set of reference points (one point per column).
+   * @param rerankFactor The scan keeps k * rerankFactor candidates for exact
+   *     re-ranking.
+   */
+  QuantizedKNN(const arma::mat& referenceSet, const size_t rerankFactor = 8);
+
+  /**
+   * For each query point, compute the approximate k nearest neighbors and
+   * store the indices and (exact) distances of the re-ranked results.
+   *
+   * @param querySet Set of query points (one point per column).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store neighbor indices into.
+   * @param distances Matrix to store neighbor distances into.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the quantized reference set.
+  const arma::Mat<unsigned char>& QuantizedSet() const
+  {
+    return quantizedSet;
+  }
+  //! Get the per-dimension quantization offsets.
+  const arma::vec& Offsets() const { return offsets; }
+  //! Get the per-dimension quantization scales.
+  const arma::vec& Scales() const { return scales; }
+
+  //! Get the re-ranking factor.
+  size_t RerankFactor() const { return rerankFactor; }
+  //! Modify the re-ranking factor.
+  size_t& RerankFactor() { return rerankFactor; }
+
+  // Convert the object into a string.
+  std::string ToString() const;
+
+ private:
+  //! The original reference set (used for exact re-ranking).
+  const arma::mat& referenceSet;
+  //! The 8-bit quantized copy of the reference set.
+  arma::Mat<unsigned char> quantizedSet;
+  //! Per-dimension quantization offsets.
+  arma::vec offsets;
+  //! Per-dimension quantization scales.
+  arma::vec scales;
+  //! The scan keeps k * rerankFactor candidates for exact re-ranking.
+  size_t rerankFactor;
+
+  /**
+   * Helper function to insert a candidate into a sorted (best-first)
+   * distance/index list, shifting worse candidates down.
+   *
+   * @param distance Distance of the candidate.
+   * @param index Index of the candidate.
+   * @param candidateDistances Sorted candidate distances.
+   * @param candidateIndices Sorted candidate indices.
+   */
+  static void InsertCandidate(const double distance,
+                              const size_t index,
+                              arma::vec& candidateDistances,
+                              arma::Col<size_t>& candidateIndices);
+};
+
+}; // namespace neighbor
+}; // namespace mlpack
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file shard_merge.hpp
+ * @author Ryan Curtin
+ *
+ * Merge per-shard neighbor search results into exact global results.
+ */
+#ifndef __MLPACK_METHODS_NEIGHBOR_SEARCH_SHARD_MERGE_HPP
+#define __MLPACK_METHODS_NEIGHBOR_SEARCH_SHARD_MERGE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * Merge the results of neighbor searches run against disjoint shards of one
+ * reference set into exact global results.  This is the gather step of a
+ * scatter/gather workflow for reference sets too large for one machine: the
+ * reference set is partitioned into contiguous shards, each shard is searched
+ * independently (in a separate process or on a separate node, for example
+ * with the allknn executable), and the per-query candidate lists are merged
+ * here.  Because each shard returns its k best candidates for every query,
+ * the k best of the union of the candidate lists are exactly the k best of
+ * the whole reference set.
+ *
+ * Each column of a shard's result matrices must be sorted best-first, which
+ * is how NeighborSearch emits its results.  shardOffsets[s] gives the global
+ * index of shard s's first reference point, so that shard-local neighbor
+ * indices can be translated back to the full reference set.  The merge is a
+ * k-way merge on distances under SortPolicy::IsBetter(), run in parallel
+ * over the query points; the per-thread cursor workspace is allocated once,
+ * not per query.
+ *
+ * If the shards together hold fewer than k candidates for a query, the
+ * remaining output slots are filled with SortPolicy::WorstDistance() and an
+ * invalid index of (size_t() - 1).
+ *
+ * @tparam SortPolicy The sort policy the per-shard searches were run with.
+ *
+ * @param shardNeighbors Per-shard neighbor matrices (shard-local indices).
+ * @param shardDistances Per-shard distance matrices.
+ * @param shardOffsets Global index of each shard's first reference point.
+ * @param k Number of neighbors to emit per query point.
+ * @param neighbors Matrix to store merged global neighbor indices into.
+ * @param distances Matrix to store merged distances into.
+ */
+template<typename SortPolicy>
+void MergeShardResults(const std::vector<arma::Mat<size_t> >& shardNeighbors,
+                       const std::vector<arma::mat>& shardDistances,
+                       const std::vector<size_t>& shardOffsets,
+                       const size_t k,
+                       arma::Mat<size_t>& neighbors,
+                       arma::mat& distances)
+{
+  const size_t shards = shardNeighbors.size();
+  if (shards == 0)
+    Log::Fatal << "MergeShardResults(): no shard results given!" << std::endl;
+  if ((shardDistances.size() != shards) || (shardOffsets.size() != shards))
+    Log::Fatal << "MergeShardResults(): shardNeighbors, shardDistances, and "
+        << "shardOffsets must all have one entry per shard!" << std::endl;
+
+  const size_t queries = shardNeighbors[0].n_cols;
+  for (size_t s = 0; s < shards; ++s)
+  {
+    if ((shardNeighbors[s].n_cols != queries) ||
+        (shardDistances[s].n_cols != queries))
+      Log::Fatal << "MergeShardResults(): shard " << s << " holds results "
+          << "for a different number of query points!" << std::endl;
+    if (shardNeighbors[s].n_rows != shardDistances[s].n_rows)
+      Log::Fatal << "MergeShardResults(): shard " << s << "'s neighbor and "
+          << "distance matrices have different numbers of rows!" << std::endl;
+  }
+
+  neighbors.set_size(k, queries);
+  distances.set_size(k, queries);
+
+  // The queries are independent, so the merge is simply divided among the
+  // threads.  The loop index is signed for OpenMP.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    // Per-thread cursors into each shard's candidate list, allocated once
+    // per thread instead of once per query.
+    arma::Col<size_t> cursors(shards);
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (long q = 0; q < (long) queries; ++q)
+    {
+      cursors.zeros();
+      for (size_t j = 0; j < k; ++j)
+      {
+        // Pick the best candidate among the heads of the shard lists.
+        size_t bestShard = shards;
+        double bestDistance = SortPolicy::WorstDistance();
+        for (size_t s = 0; s < shards; ++s)
+        {
+          if (cursors[s] >= shardDistances[s].n_rows)
+            continue; // This shard's candidates are exhausted.
+
+          const double distance = shardDistances[s](cursors[s], q);
+          if ((bestShard == shards) ||
+              SortPolicy::IsBetter(distance, bestDistance))
+          {
+            bestShard = s;
+            bestDistance = distance;
+          }
+        }
+
+        if (bestShard == shards)
+        {
+          // The shards hold fewer than k candidates for this query.
+          neighbors(j, q) = (size_t() - 1);
+          distances(j, q) = SortPolicy::WorstDistance();
+        }
+        else
+        {
+          neighbors(j, q) = shardNeighbors[bestShard](cursors[bestShard], q) +
+              shardOffsets[bestShard];
+          distances(j, q) = bestDistance;
+          ++cursors[bestShard];
+        }
+      }
+    }
+  }
+}
+
+}; // namespace neighbor
+}; // namespace mlpack
+
+#endif
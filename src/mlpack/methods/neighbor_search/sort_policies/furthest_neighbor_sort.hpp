@@ -54,6 +54,48 @@ class FurthestNeighborSort
     return (value > ref);
   }
 
+  /**
+   * Vector form of the candidate test '!IsBetter(bound, value)' used by leaf
+   * scans: for each of the given candidate distances, set mask[i] to 1 if a
+   * point at that distance should be considered for insertion given the
+   * current worst kept candidate, and to 0 otherwise.  The loop body is a
+   * bare comparison with no branches, so the compiler can vectorize it over
+   * the block.
+   *
+   * @param values Block of candidate distances.
+   * @param count Number of candidate distances in the block.
+   * @param bound Current worst kept candidate distance.
+   * @param mask Output mask; mask[i] is 1 if values[i] passes the bound.
+   *
+   * @return The number of candidates that passed the bound.
+   */
+  static inline size_t CandidateMask(const double* values,
+                                     const size_t count,
+                                     const double bound,
+                                     unsigned char* mask)
+  {
+    size_t passed = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      mask[i] = (values[i] >= bound) ? 1 : 0;
+      passed += mask[i];
+    }
+    return passed;
+  }
+
+  /**
+   * Relax a pruning bound by the given epsilon, for approximate search: the
+   * relaxed bound admits any point whose distance is within a relative factor
+   * of (1 + epsilon) of a true furthest neighbor.
+   *
+   * @param value Bound to relax.
+   * @param epsilon Allowed relative error (>= 0).
+   */
+  static inline double Relax(const double value, const double epsilon)
+  {
+    return (1.0 + epsilon) * value;
+  }
+
   /**
    * Return the best possible distance between two nodes.  In our case, this is
    * the maximum distance between the two tree nodes using the given distance
@@ -145,6 +187,14 @@ class FurthestNeighborSort
    */
   static inline double CombineWorst(const double a, const double b)
   { return std::max(a - b, 0.0); }
+
+  //! Whether the traversal should tighten node-to-node distances with the
+  //! auxiliary centroid bound cached in NeighborSearchStat.  For furthest
+  //! neighbor search, the distance to the farthest corner of a bound badly
+  //! overestimates the distance to the points actually inside it, so the
+  //! centroid bound prunes far more node combinations than MaxDistance()
+  //! alone.
+  static const bool NeedsAuxiliaryBound = true;
 };
 
 }; // namespace neighbor
@@ -58,6 +58,51 @@ class NearestNeighborSort
     return (value < ref);
   }
 
+  /**
+   * Vector form of the candidate test '!IsBetter(bound, value)' used by leaf
+   * scans: for each of the given candidate distances, set mask[i] to 1 if a
+   * point at that distance should be considered for insertion given the
+   * current worst kept candidate, and to 0 otherwise.  The loop body is a
+   * bare comparison with no branches, so the compiler can vectorize it over
+   * the block; callers filter candidates through the mask instead of
+   * branching on the bound once per point.
+   *
+   * @param values Block of candidate distances.
+   * @param count Number of candidate distances in the block.
+   * @param bound Current worst kept candidate distance.
+   * @param mask Output mask; mask[i] is 1 if values[i] passes the bound.
+   *
+   * @return The number of candidates that passed the bound.
+   */
+  static inline size_t CandidateMask(const double* values,
+                                     const size_t count,
+                                     const double bound,
+                                     unsigned char* mask)
+  {
+    size_t passed = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      mask[i] = (values[i] <= bound) ? 1 : 0;
+      passed += mask[i];
+    }
+    return passed;
+  }
+
+  /**
+   * Relax a pruning bound by the given epsilon, for approximate search: the
+   * relaxed bound admits any point whose distance is within a relative factor
+   * of (1 + epsilon) of a true nearest neighbor.
+   *
+   * @param value Bound to relax.
+   * @param epsilon Allowed relative error (>= 0).
+   */
+  static inline double Relax(const double value, const double epsilon)
+  {
+    if (value == DBL_MAX)
+      return DBL_MAX;
+    return (1.0 / (1.0 + epsilon)) * value;
+  }
+
   /**
    * Return the best possible distance between two nodes.  In our case, this is
    * the minimum distance between the two tree nodes using the given distance
@@ -150,6 +195,12 @@ class NearestNeighborSort
       return DBL_MAX;
     return a + b;
   }
+
+  //! Whether the traversal should tighten node-to-node distances with the
+  //! auxiliary centroid bound cached in NeighborSearchStat.  For nearest
+  //! neighbor search the minimum bound distance is already tight, so the
+  //! extra distance evaluation does not pay for itself.
+  static const bool NeedsAuxiliaryBound = false;
 };
 
 }; // namespace neighbor
@@ -6,6 +6,8 @@
  */
 #include "unmap.hpp"
 
+#include <algorithm>
+
 namespace mlpack {
 namespace neighbor {
 
@@ -22,19 +24,35 @@ void Unmap(const arma::Mat<size_t>& neighbors,
   neighborsOut.set_size(neighbors.n_rows, neighbors.n_cols);
   distancesOut.set_size(distances.n_rows, distances.n_cols);
 
-  // Unmap distances.
-  for (size_t i = 0; i < distances.n_cols; ++i)
+  // Unmap the results.  This is blocked over the columns so each thread reads
+  // a contiguous chunk of the input matrices; the writes scatter through
+  // queryMap, but queryMap is a permutation, so each output column is written
+  // by exactly one block and the blocks are independent.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (distances.n_cols + blockSize - 1) / blockSize;
+
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+  #endif
+  for (long block = 0; block < (long) numBlocks; ++block)
   {
-    // Map columns to the correct place.  The ternary operator does not work
-    // here...
-    if (squareRoot)
-      distancesOut.col(queryMap[i]) = sqrt(distances.col(i));
-    else
-      distancesOut.col(queryMap[i]) = distances.col(i);
+    const size_t blockBegin = ((size_t) block) * blockSize;
+    const size_t blockEnd = std::min(blockBegin + blockSize,
+        (size_t) distances.n_cols);
 
-    // Map indices of neighbors.
-    for (size_t j = 0; j < distances.n_rows; ++j)
-      neighborsOut(j, queryMap[i]) = referenceMap[neighbors(j, i)];
+    for (size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      // Map columns to the correct place.  The ternary operator does not work
+      // here...
+      if (squareRoot)
+        distancesOut.col(queryMap[i]) = sqrt(distances.col(i));
+      else
+        distancesOut.col(queryMap[i]) = distances.col(i);
+
+      // Map indices of neighbors.
+      for (size_t j = 0; j < distances.n_rows; ++j)
+        neighborsOut(j, queryMap[i]) = referenceMap[neighbors(j, i)];
+    }
   }
 }
 
@@ -55,9 +73,23 @@ void Unmap(const arma::Mat<size_t>& neighbors,
   else
     distancesOut = distances;
 
-  // Map neighbors back to original locations.
-  for (size_t j = 0; j < neighbors.n_elem; ++j)
-    neighborsOut[j] = referenceMap[neighbors[j]];
+  // Map neighbors back to original locations, in parallel blocks (the query
+  // set is not rearranged here, so this is a pure gather).
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (neighbors.n_elem + blockSize - 1) / blockSize;
+
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+  #endif
+  for (long block = 0; block < (long) numBlocks; ++block)
+  {
+    const size_t blockBegin = ((size_t) block) * blockSize;
+    const size_t blockEnd = std::min(blockBegin + blockSize,
+        (size_t) neighbors.n_elem);
+
+    for (size_t j = blockBegin; j < blockEnd; ++j)
+      neighborsOut[j] = referenceMap[neighbors[j]];
+  }
 }
 
 }; // namespace neighbor
@@ -59,10 +59,18 @@ class NystroemMethod
    * @param miniKernel to store the constructed mini-kernel matrix in.
    * @param miniKernel to store the constructed semi-kernel matrix in.
    */
-  void GetKernelMatrix(const arma::Col<size_t>& selectedPoints, 
-                       arma::mat& miniKernel, 
+  void GetKernelMatrix(const arma::Col<size_t>& selectedPoints,
+                       arma::mat& miniKernel,
                        arma::mat& semiKernel);
 
+  //! Get the kernel matrix cache directory ("" means caching is disabled).
+  const std::string& CacheDirectory() const { return cacheDirectory; }
+  //! Modify the kernel matrix cache directory.  If set to an existing
+  //! directory, the kernel matrices are looked up in (and stored to) a
+  //! disk-backed cache instead of always being recomputed; see
+  //! KernelMatrixCache.
+  std::string& CacheDirectory() { return cacheDirectory; }
+
  private:
   //! The reference dataset.
   const arma::mat& data;
@@ -70,6 +78,8 @@ class NystroemMethod
   KernelType& kernel;
   //! Rank used for matrix approximation.
   const size_t rank;
+  //! Directory of the kernel matrix cache ("" disables caching).
+  std::string cacheDirectory;
 };
 
 }; // namespace kernel
@@ -21,27 +21,34 @@ NystroemMethod<KernelType, PointSelectionPolicy>::NystroemMethod(
     const size_t rank) :
     data(data),
     kernel(kernel),
-    rank(rank)
+    rank(rank),
+    cacheDirectory("")
 { }
 
 template<typename KernelType, typename PointSelectionPolicy>
 void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
-    const arma::mat* selectedData, 
-    arma::mat& miniKernel, 
+    const arma::mat* selectedData,
+    arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
-  // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  if (cacheDirectory != "")
+  {
+    // Consult the disk-backed cache before computing; with a deterministic
+    // point selection policy and unchanged data, both matrices are hits.
+    KernelMatrixCache<KernelType> cache(cacheDirectory, kernel);
+    cache.Symmetric(*selectedData, miniKernel);
+    cache.Rectangular(data, *selectedData, semiKernel);
+  }
+  else
+  {
+    // Assemble mini-kernel matrix.
+    ComputeKernelMatrix(*selectedData, miniKernel, kernel);
+
+    // Construct semi-kernel matrix with interactions between selected data
+    // and all points.
+    ComputeKernelMatrix(data, *selectedData, semiKernel, kernel);
+  }
 
-  // Construct semi-kernel matrix with interactions between selected data and
-  // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i), 
-                                         selectedData->col(j));
   // Clean the memory.
   delete selectedData;
 }
@@ -52,18 +59,29 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
-  // Assemble mini-kernel matrix.
+  // Gather the selected points into one matrix, so that the shared kernel
+  // matrix utility can be used.
+  arma::mat selectedData(data.n_rows, rank);
   for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
+    selectedData.col(i) = data.col(selectedPoints(i));
+
+  if (cacheDirectory != "")
+  {
+    // Consult the disk-backed cache before computing; with a deterministic
+    // point selection policy and unchanged data, both matrices are hits.
+    KernelMatrixCache<KernelType> cache(cacheDirectory, kernel);
+    cache.Symmetric(selectedData, miniKernel);
+    cache.Rectangular(data, selectedData, semiKernel);
+  }
+  else
+  {
+    // Assemble mini-kernel matrix.
+    ComputeKernelMatrix(selectedData, miniKernel, kernel);
 
-  // Construct semi-kernel matrix with interactions between selected points and
-  // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+    // Construct semi-kernel matrix with interactions between selected points
+    // and all points.
+    ComputeKernelMatrix(data, selectedData, semiKernel, kernel);
+  }
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
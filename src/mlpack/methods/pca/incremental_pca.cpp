@@ -0,0 +1,130 @@
+/**
+ * @file incremental_pca.cpp
+ * @author Ajinkya Kale
+ *
+ * Implementation of the IncrementalPCA class.
+ */
+#include "incremental_pca.hpp"
+#include <mlpack/core.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::pca;
+
+IncrementalPCA::IncrementalPCA(const size_t rank) :
+    rank(rank),
+    numPoints(0)
+{
+  if (rank == 0)
+    Log::Fatal << "IncrementalPCA::IncrementalPCA(): rank cannot be zero!"
+        << endl;
+}
+
+void IncrementalPCA::Update(const arma::mat& batch)
+{
+  if (batch.n_cols == 0)
+    return; // Nothing to do.
+
+  if (numPoints > 0 && batch.n_rows != mean.n_elem)
+    Log::Fatal << "IncrementalPCA::Update(): batch dimensionality ("
+        << batch.n_rows << ") does not match the dimensionality of earlier "
+        << "batches (" << mean.n_elem << ")!" << endl;
+
+  const size_t n = numPoints;
+  const size_t b = batch.n_cols;
+
+  // Update the running mean.
+  const arma::vec batchMean = arma::mean(batch, 1);
+  const arma::vec newMean = (numPoints == 0) ? batchMean :
+      arma::vec((n * mean + b * batchMean) / (double) (n + b));
+
+  // Center the batch around its own mean.  The shift of the global mean is
+  // accounted for by one extra correction column (Ross et al., "Incremental
+  // learning for robust visual tracking", IJCV 2008), so the maintained
+  // decomposition is that of the centered data.
+  arma::mat centered = batch - arma::repmat(batchMean, 1, b);
+  if (numPoints > 0)
+    centered.insert_cols(b, arma::vec(std::sqrt((double) n * b / (n + b)) *
+        (mean - batchMean)));
+
+  if (numPoints == 0)
+  {
+    // The first batch seeds the decomposition directly.
+    arma::mat v;
+    arma::svd_econ(basis, singularValues, v, centered, 'l');
+
+    if (singularValues.n_elem > rank)
+    {
+      basis = basis.cols(0, rank - 1);
+      singularValues = singularValues.subvec(0, rank - 1);
+    }
+  }
+  else
+  {
+    // Project the batch onto the current subspace, and orthogonalize what is
+    // left over against it.
+    const arma::mat proj = basis.t() * centered;
+    arma::mat q, r;
+    arma::qr_econ(q, r, arma::mat(centered - basis * proj));
+
+    // Build the small middle matrix
+    //   [ diag(s)  proj ]
+    //   [    0      r   ]
+    // whose decomposition combines the old subspace with the new directions.
+    const size_t k = singularValues.n_elem;
+    const size_t m = centered.n_cols;
+    arma::mat middle(k + m, k + m);
+    middle.zeros();
+    middle.submat(0, 0, k - 1, k - 1) = arma::diagmat(singularValues);
+    middle.submat(0, k, k - 1, k + m - 1) = proj;
+    middle.submat(k, k, k + m - 1, k + m - 1) = r;
+
+    arma::mat u, v;
+    arma::vec s;
+    arma::svd(u, s, v, middle);
+
+    // Rotate the enlarged basis and truncate back to the maintained rank.
+    const size_t newRank = std::min(rank, (size_t) s.n_elem);
+    basis = arma::join_rows(basis, q) * u.cols(0, newRank - 1);
+    singularValues = s.subvec(0, newRank - 1);
+  }
+
+  mean = newMean;
+  numPoints += b;
+}
+
+void IncrementalPCA::Transform(const arma::mat& data,
+                               arma::mat& transformedData) const
+{
+  if (numPoints == 0)
+    Log::Fatal << "IncrementalPCA::Transform(): no points have been seen yet!"
+        << endl;
+  if (data.n_rows != mean.n_elem)
+    Log::Fatal << "IncrementalPCA::Transform(): data dimensionality ("
+        << data.n_rows << ") does not match the dimensionality of the "
+        << "training data (" << mean.n_elem << ")!" << endl;
+
+  transformedData = basis.t() *
+      (data - arma::repmat(mean, 1, data.n_cols));
+}
+
+arma::vec IncrementalPCA::Eigenvalues() const
+{
+  // The eigenvalues of the covariance matrix are the squared singular values
+  // divided by (N - 1).
+  if (numPoints < 2)
+    return arma::zeros<arma::vec>(singularValues.n_elem);
+
+  return singularValues % singularValues / (numPoints - 1);
+}
+
+// Return a string of this object.
+std::string IncrementalPCA::ToString() const
+{
+  std::ostringstream convert;
+  convert << "Incremental Principal Component Analysis  [" << this << "]"
+      << std::endl;
+  convert << "  Rank: " << rank << std::endl;
+  convert << "  Points seen: " << numPoints << std::endl;
+  return convert.str();
+}
@@ -0,0 +1,124 @@
+/**
+ * @file incremental_pca.hpp
+ * @author Ajinkya Kale
+ *
+ * Defines the IncrementalPCA class, which maintains the top principal
+ * components of a dataset that is consumed in column batches, so that PCA can
+ * be performed on datasets far larger than available memory.
+ */
+#ifndef __MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+#define __MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * This class implements incremental principal components analysis.  Instead of
+ * decomposing the full data matrix at once (as the PCA class does), it
+ * maintains a rank-k singular value decomposition of the data seen so far,
+ * which is updated for each batch of points: the batch is projected onto the
+ * current subspace, the residual is orthogonalized, and a small
+ * (k + b) x (k + b) decomposition combines the two (where b is the batch
+ * size).  The running mean is folded into each update with a correction
+ * column, so the components are those of the centered data even though no
+ * pass over the full dataset is ever made.
+ *
+ * Because the decomposition is truncated back to rank k after every update,
+ * the result is an approximation of the top k components of a batch PCA; the
+ * approximation is exact when the data has rank at most k, and is generally
+ * very close when the discarded singular values are small.
+ *
+ * Batches may come from anywhere, but the natural source is a
+ * data::StreamingLoader, which Train() consumes directly:
+ *
+ * @code
+ * data::StreamingLoader<> loader("features.csv", 10000);
+ * IncrementalPCA ipca(50); // Maintain the top 50 components.
+ * ipca.Train(loader); // One pass over the file.
+ * @endcode
+ */
+class IncrementalPCA
+{
+ public:
+  /**
+   * Create the IncrementalPCA object, maintaining the given number of
+   * principal components.
+   *
+   * @param rank Number of principal components to maintain (must be nonzero).
+   */
+  IncrementalPCA(const size_t rank);
+
+  /**
+   * Update the maintained components with one batch of points (one point per
+   * column).  Batches must all have the same dimensionality.  Larger batches
+   * give both better throughput and a slightly better approximation; the cost
+   * of an update is O(d * (k + b)^2) for d dimensions, k components, and b
+   * points in the batch.
+   *
+   * @param batch Batch of points to fold into the decomposition.
+   */
+  void Update(const arma::mat& batch);
+
+  /**
+   * Consume every batch of the given loader (anything with a
+   * bool Next(arma::mat&) method, such as data::StreamingLoader), updating
+   * the maintained components with each batch.
+   *
+   * @param loader Loader to read batches from.
+   */
+  template<typename LoaderType>
+  void Train(LoaderType& loader)
+  {
+    arma::mat batch;
+    while (loader.Next(batch))
+      Update(batch);
+  }
+
+  /**
+   * Project the given points onto the maintained principal components,
+   * centering them with the running mean.  The result has Rank() rows (or
+   * fewer, if fewer points than Rank() have been seen).
+   *
+   * @param data Points to project (one point per column).
+   * @param transformedData Matrix to store the projected points in.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const;
+
+  //! Get the eigenvalues of the covariance matrix corresponding to the
+  //! maintained components (largest first).
+  arma::vec Eigenvalues() const;
+
+  //! Get the maintained principal components (one component per column).
+  const arma::mat& Basis() const { return basis; }
+  //! Get the singular values of the (centered) data seen so far.
+  const arma::vec& SingularValues() const { return singularValues; }
+  //! Get the running mean of the data seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the number of components that are maintained.
+  size_t Rank() const { return rank; }
+
+  // Returns a string representation of this object.
+  std::string ToString() const;
+
+ private:
+  //! The number of components to maintain.
+  size_t rank;
+  //! The number of points seen so far.
+  size_t numPoints;
+  //! The running mean of the data seen so far.
+  arma::vec mean;
+  //! The maintained left singular vectors (one component per column).
+  arma::mat basis;
+  //! The maintained singular values.
+  arma::vec singularValues;
+
+}; // class IncrementalPCA
+
+}; // namespace pca
+}; // namespace mlpack
+
+#endif
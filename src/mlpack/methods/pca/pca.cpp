@@ -12,8 +12,9 @@ using namespace std;
 using namespace mlpack;
 using namespace mlpack::pca;
 
-PCA::PCA(const bool scaleData) :
-    scaleData(scaleData)
+PCA::PCA(const bool scaleData, const size_t rank) :
+    scaleData(scaleData),
+    rank(rank)
 { }
 
 /**
@@ -52,9 +53,15 @@ void PCA::Apply(const arma::mat& data,
     centeredData /= arma::repmat(stdDev, 1, centeredData.n_cols);
   }
 
-  // Do singular value decomposition.  Use the economical singular value
-  // decomposition if the columns are much larger than the rows.
-  if (data.n_rows < data.n_cols)
+  // Do singular value decomposition.  If a rank was specified, use the
+  // randomized decomposition, which only computes that many components.
+  // Otherwise, use the economical singular value decomposition if the columns
+  // are much larger than the rows.
+  if (rank > 0 && rank < std::min(data.n_rows, data.n_cols))
+  {
+    math::RandomizedSvd(coeff, eigVal, v, centeredData, rank);
+  }
+  else if (data.n_rows < data.n_cols)
   {
     // Do economical singular value decomposition and compute only the left
     // singular vectors.
@@ -116,9 +123,17 @@ double PCA::Apply(arma::mat& data, const size_t newDimension) const
   arma::mat coeffs;
   arma::vec eigVal;
 
+  // The randomized decomposition only returns the top `rank` eigenvalues, so
+  // the total variance must be calculated from the data beforehand.  When the
+  // data is scaled, every dimension has unit variance.
+  double totalVariance = 0.0;
+  if (rank > 0)
+    totalVariance = scaleData ? (double) data.n_rows :
+        arma::accu(arma::var(data, 0, 1));
+
   Apply(data, data, eigVal, coeffs);
 
-  if (newDimension < coeffs.n_rows)
+  if (newDimension < data.n_rows)
     // Drop unnecessary rows.
     data.shed_rows(newDimension, data.n_rows - 1);
 
@@ -127,7 +142,10 @@ double PCA::Apply(arma::mat& data, const size_t newDimension) const
   double eigDim = std::min(newDimension - 1, (size_t) eigVal.n_elem - 1);
 
   // Calculate the total amount of variance retained.
-  return (sum(eigVal.subvec(0, eigDim)) / sum(eigVal));
+  if (rank > 0)
+    return (sum(eigVal.subvec(0, eigDim)) / totalVariance);
+  else
+    return (sum(eigVal.subvec(0, eigDim)) / sum(eigVal));
 }
 
 /**
@@ -153,12 +171,23 @@ double PCA::Apply(arma::mat& data, const double varRetained) const
   arma::mat coeffs;
   arma::vec eigVal;
 
+  // As above, the randomized decomposition only returns the top `rank`
+  // eigenvalues, so the total variance must be calculated beforehand.
+  double totalVariance = 0.0;
+  if (rank > 0)
+    totalVariance = scaleData ? (double) data.n_rows :
+        arma::accu(arma::var(data, 0, 1));
+
   Apply(data, data, eigVal, coeffs);
 
   // Calculate the dimension we should keep.
   size_t newDimension = 0;
   double varSum = 0.0;
-  eigVal /= arma::sum(eigVal); // Normalize eigenvalues.
+  // Normalize the eigenvalues.
+  if (rank > 0)
+    eigVal /= totalVariance;
+  else
+    eigVal /= arma::sum(eigVal);
   while ((varSum < varRetained) && (newDimension < eigVal.n_elem))
   {
     varSum += eigVal[newDimension];
@@ -177,7 +206,9 @@ std::string PCA::ToString() const
 {
   std::ostringstream convert;
   convert << "Principal Component Analysis  [" << this << "]" << std::endl;
-  if (scaleData)  
+  if (scaleData)
     convert << "  Scaling Data: TRUE" << std::endl;
+  if (rank > 0)
+    convert << "  Randomized decomposition rank: " << rank << std::endl;
   return convert.str();
 }
@@ -25,11 +25,18 @@ class PCA
  public:
   /**
    * Create the PCA object, specifying if the data should be scaled in each
-   * dimension by standard deviation when PCA is performed.
+   * dimension by standard deviation when PCA is performed.  Optionally, a
+   * rank may be given; if it is nonzero, only that many principal components
+   * are computed, using a randomized decomposition (see
+   * math::RandomizedSvd()) instead of a full singular value decomposition.
+   * This is much faster when only a few components of a high-dimensional
+   * problem are kept, at the cost of a small approximation error.
    *
    * @param scaleData Whether or not to scale the data.
+   * @param rank Number of principal components to compute with the
+   *     randomized decomposition, or 0 for a full (exact) decomposition.
    */
-  PCA(const bool scaleData = false);
+  PCA(const bool scaleData = false, const size_t rank = 0);
 
   /**
    * Apply Principal Component Analysis to the provided data set.  It is safe to
@@ -100,6 +107,13 @@ class PCA
   //! the data when PCA is performed.
   bool& ScaleData() { return scaleData; }
 
+  //! Get the number of components the randomized decomposition will compute
+  //! (0 means a full, exact decomposition is performed).
+  size_t Rank() const { return rank; }
+  //! Modify the number of components the randomized decomposition will
+  //! compute (set to 0 for a full, exact decomposition).
+  size_t& Rank() { return rank; }
+
   // Returns a string representation of this object. 
   std::string ToString() const;
 
@@ -108,6 +122,10 @@ class PCA
   //! performed.
   bool scaleData;
 
+  //! The number of components the randomized decomposition will compute, or 0
+  //! if a full (exact) decomposition should be performed.
+  size_t rank;
+
 }; // class PCA
 
 }; // namespace pca
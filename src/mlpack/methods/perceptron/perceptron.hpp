@@ -47,6 +47,11 @@ class Perceptron
    * Classification function. After training, use the weightVectors matrix to
    * classify test, and put the predicted classes in predictedLabels.
    *
+   * If predictedLabels is already of the correct length, it is reused without
+   * reallocation, and the internal score matrix is likewise reused, so
+   * classifying many same-sized batches performs no allocation after the
+   * first call.
+   *
    * @param test Testing data or data to classify.
    * @param predictedLabels Vector to store the predicted classes after
    *     classifying test.
@@ -78,12 +83,30 @@ private:
   //! Stores the training data to be used later on in UpdateWeights.
   arma::mat trainData;
 
+  //! Reusable classification workspace holding the score of each class for
+  //! each test point, so that repeated Classify() calls do not reallocate.
+  arma::mat classifyScores;
+
   /**
    *  Training Function. It trains on trainData using the cost matrix D
-   *  
+   *
    *  @param D Cost matrix. Stores the cost of mispredicting instances
    */
   void Train(const arma::rowvec& D);
+
+  /**
+   *  Epoch-batched training function. Each epoch classifies the whole
+   *  dataset with a single matrix multiplication, then applies the
+   *  accumulated weighted updates of all misclassified points at once (using
+   *  the simple Rosenblatt rule, regardless of the LearnPolicy).  The updates
+   *  of an epoch are computed from the weights at the start of the epoch, so
+   *  the result differs from the point-at-a-time rule of Train(); the batched
+   *  rule is much faster on large datasets, which is why the boosting
+   *  constructor uses it.
+   *
+   *  @param D Cost matrix. Stores the cost of mispredicting instances
+   */
+  void TrainBatch(const arma::rowvec& D);
 };
 
 } // namespace perceptron
@@ -66,15 +66,22 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::mat tempLabelMat;
-  arma::uword maxIndexRow, maxIndexCol;
+  // Score every test point against every class with a single matrix
+  // multiplication, then take the per-column maximum.  The score matrix is a
+  // member, so it only reallocates when the batch size changes; the bias
+  // column is added in place to avoid the temporary that repmat() would make.
+  classifyScores = weightVectors.submat(0, 1, weightVectors.n_rows - 1,
+      weightVectors.n_cols - 1) * test;
+  for (size_t i = 0; i < test.n_cols; i++)
+    classifyScores.col(i) += weightVectors.col(0);
 
+  predictedLabels.set_size(1, test.n_cols);
+
+  arma::uword maxIndexRow;
   for (size_t i = 0; i < test.n_cols; i++)
   {
-    tempLabelMat = weightVectors.submat(0, 1, weightVectors.n_rows - 1,
-                                        weightVectors.n_cols - 1) * 
-                                        test.col(i) + weightVectors.col(0);
-    tempLabelMat.max(maxIndexRow, maxIndexCol);
+    arma::vec score = classifyScores.unsafe_col(i);
+    score.max(maxIndexRow);
     predictedLabels(0, i) = maxIndexRow;
   }
   // predictedLabels.print("These are the labels predicted by the perceptron");
@@ -107,7 +114,10 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
   WeightInitializationPolicy WIP;
   WIP.Initialize(weightVectors, arma::max(labels) + 1, data.n_rows + 1);
 
-  Train(D);
+  // Boosting retrains the perceptron many times, so use the epoch-batched
+  // training rule, which classifies the whole dataset with one matrix
+  // multiplication per epoch.
+  TrainBatch(D);
 }
 
 /**
@@ -162,6 +172,65 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
   }
 }
 
+/**
+ *  Epoch-batched training function. It trains on trainData using the cost
+ *  matrix D.
+ *
+ *  @param D Cost matrix. Stores the cost of mispredicting instances
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::TrainBatch(
+     const arma::rowvec& D)
+{
+  size_t i = 0;
+  bool converged = false;
+  arma::uword maxIndexRow;
+
+  arma::mat scores;
+  // Signed update coefficient of each (class, point) pair; the accumulated
+  // weight update of an epoch is coefficients * trainData.t().
+  arma::mat coefficients(weightVectors.n_rows, trainData.n_cols);
+
+  while ((i < iter) && (!converged))
+  {
+    // This outer loop is for each iteration, and we use the 'converged'
+    // variable for noting whether or not convergence has been reached.
+    i++;
+    converged = true;
+
+    // Classify the whole dataset with a single matrix multiplication.
+    scores = weightVectors * trainData;
+
+    // Collect the weighted updates of all misclassified points: the weight
+    // vector of the predicted class loses the point and the weight vector of
+    // the correct class gains it, both scaled by the cost of the point.
+    coefficients.zeros();
+    for (size_t j = 0; j < trainData.n_cols; j++)
+    {
+      arma::vec score = scores.unsafe_col(j);
+      score.max(maxIndexRow);
+
+      // Check whether prediction is correct.
+      if (maxIndexRow != classLabels(0, j))
+      {
+        // Due to incorrect prediction, convergence set to false.
+        converged = false;
+        coefficients(maxIndexRow, j) -= D(j);
+        coefficients(classLabels(0, j), j) += D(j);
+      }
+    }
+
+    // Apply the updates accumulated over this epoch, again with a single
+    // matrix multiplication.
+    if (!converged)
+      weightVectors += coefficients * trainData.t();
+  }
+}
+
 }; // namespace perceptron
 }; // namespace mlpack
 
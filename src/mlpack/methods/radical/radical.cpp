@@ -63,9 +63,11 @@ double Radical::DoRadical2D(const mat& matX)
 {
   CopyAndPerturb(perturbed, matX);
 
-  mat::fixed<2, 2> matJacobi;
-
-  vec values(angles);
+  // Place the Jacobi rotation matrices of all candidate angles side by side,
+  // so that every candidate rotation is applied with a single matrix
+  // multiplication; columns 2i and 2i + 1 of the result hold the projections
+  // for angle i.
+  mat matJacobi(2, 2 * angles);
 
   for (size_t i = 0; i < angles; i++)
   {
@@ -73,14 +75,25 @@ double Radical::DoRadical2D(const mat& matX)
     const double cosTheta = cos(theta);
     const double sinTheta = sin(theta);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    matJacobi(0, 2 * i) = cosTheta;
+    matJacobi(1, 2 * i) = -sinTheta;
+    matJacobi(0, 2 * i + 1) = sinTheta;
+    matJacobi(1, 2 * i + 1) = cosTheta;
+  }
 
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+  candidate = perturbed * matJacobi;
+
+  // The entropy estimates of the candidate angles are independent of each
+  // other (each sorts its own pair of columns), so they can be computed in
+  // parallel.
+  vec values(angles);
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long i = 0; i < (long) angles; i++)
+  {
+    vec candidateY1 = candidate.unsafe_col(2 * i);
+    vec candidateY2 = candidate.unsafe_col(2 * i + 1);
 
     values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
   }
@@ -127,8 +140,6 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
 
   mat matYSubspace(nPoints, 2);
 
-  mat matJ = eye(nDims, nDims);
-
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
@@ -148,19 +159,14 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
         const double cosThetaOpt = cos(thetaOpt);
         const double sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
-
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        // The rotation is the identity on every dimension other than i and j,
+        // so apply it to those two columns directly instead of multiplying
+        // matY by a full nDims x nDims transformation matrix.  The original
+        // values of both columns are in matYSubspace.
+        matY.col(i) = cosThetaOpt * matYSubspace.col(0) -
+            sinThetaOpt * matYSubspace.col(1);
+        matY.col(j) = sinThetaOpt * matYSubspace.col(0) +
+            cosThetaOpt * matYSubspace.col(1);
       }
     }
   }
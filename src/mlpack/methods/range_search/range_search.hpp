@@ -12,6 +12,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_result_set.hpp"
 
 namespace mlpack {
 namespace range /** Range-search routines. */ {
@@ -181,10 +182,57 @@ class RangeSearch
               std::vector<std::vector<size_t> >& neighbors,
               std::vector<std::vector<double> >& distances);
 
-  // Returns a string representation of this object. 
+  /**
+   * Search for all points in the given range, returning the results in a
+   * CompactResultSet.  This stores all results in a few contiguous buffers
+   * rather than one std::vector per query point, which avoids millions of
+   * small allocations when the ranges are dense; see CompactResultSet for the
+   * details of the storage and how to access the results.  Any contents of
+   * the result set are cleared first.
+   *
+   * @param range Range of distances in which to search.
+   * @param results Result set which will hold the results of the search.
+   */
+  void Search(const math::Range& range, CompactResultSet& results);
+
+  /**
+   * Search for all points within several radii at once, returning the results
+   * binned by radius band.  A single traversal with the largest radius is
+   * performed, and each result is placed into the band of the smallest radius
+   * not less than its distance, so neighbors[b][i] holds the indices of the
+   * reference points whose distance to query point i lies in
+   * (radii[b - 1], radii[b]] (band 0 holds [0, radii[0]]).  This is much
+   * cheaper than one Search() call per radius, which would repeat the
+   * traversal work of every smaller radius.
+   *
+   * In naive and single-tree mode, the query points are divided among the
+   * OpenMP threads; dual-tree mode performs its one traversal serially.
+   *
+   * @param radii Radii to search within, sorted in ascending order.
+   * @param neighbors Object which will hold the list of neighbors for each
+   *      radius band, for each query point.
+   * @param distances Object which will hold the list of distances for each
+   *      radius band, for each query point.
+   */
+  void Search(const std::vector<double>& radii,
+              std::vector<std::vector<std::vector<size_t> > >& neighbors,
+              std::vector<std::vector<std::vector<double> > >& distances);
+
+  // Returns a string representation of this object.
   std::string ToString() const;
 
  private:
+  /**
+   * Run the search itself (naive, single-tree, or dual-tree), writing results
+   * through the given result set.  Called by the Search() overloads, which
+   * handle the mapping of the results back to the original point indices.
+   *
+   * @param range Range of distances in which to search.
+   * @param results Result set to write results through.
+   */
+  template<typename ResultSetType>
+  void SearchInternal(const math::Range& range, ResultSetType& results);
+
   //! Copy of reference matrix; used when a tree is built internally.
   typename TreeType::Mat referenceCopy;
   //! Copy of query matrix; used when a tree is built internally.
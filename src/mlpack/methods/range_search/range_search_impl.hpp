@@ -187,43 +187,19 @@ RangeSearch<MetricType, TreeType>::~RangeSearch()
 }
 
 template<typename MetricType, typename TreeType>
-void RangeSearch<MetricType, TreeType>::Search(
+template<typename ResultSetType>
+void RangeSearch<MetricType, TreeType>::SearchInternal(
     const math::Range& range,
-    std::vector<std::vector<size_t> >& neighbors,
-    std::vector<std::vector<double> >& distances)
+    ResultSetType& results)
 {
   Timer::Start("range_search/computing_neighbors");
 
   // Set size of prunes to 0.
   numPrunes = 0;
 
-  // If we have built the trees ourselves, then we will have to map all the
-  // indices back to their original indices when this computation is finished.
-  // To avoid extra copies, we will store the unmapped neighbors and distances
-  // in a separate object.
-  std::vector<std::vector<size_t> >* neighborPtr = &neighbors;
-  std::vector<std::vector<double> >* distancePtr = &distances;
-
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<TreeType>::RearrangesDataset)
-  {
-    if (treeOwner && !(singleMode && hasQuerySet))
-      distancePtr = new std::vector<std::vector<double> >; // Query indices need to be mapped.
-
-    if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t> >; // All indices need mapping.
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distancePtr->clear();
-  distancePtr->resize(querySet.n_cols);
-
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, TreeType> RuleType;
-  RuleType rules(referenceSet, querySet, range, *neighborPtr, *distancePtr,
-      metric);
+  typedef RangeSearchRules<MetricType, TreeType, ResultSetType> RuleType;
+  RuleType rules(referenceSet, querySet, range, results, metric);
 
   if (naive)
   {
@@ -258,6 +234,40 @@ void RangeSearch<MetricType, TreeType>::Search(
   // Output number of prunes.
   Log::Info << "Number of pruned nodes during computation: " << numPrunes
       << "." << std::endl;
+}
+
+template<typename MetricType, typename TreeType>
+void RangeSearch<MetricType, TreeType>::Search(
+    const math::Range& range,
+    std::vector<std::vector<size_t> >& neighbors,
+    std::vector<std::vector<double> >& distances)
+{
+  // If we have built the trees ourselves, then we will have to map all the
+  // indices back to their original indices when this computation is finished.
+  // To avoid extra copies, we will store the unmapped neighbors and distances
+  // in a separate object.
+  std::vector<std::vector<size_t> >* neighborPtr = &neighbors;
+  std::vector<std::vector<double> >* distancePtr = &distances;
+
+  // Mapping is only necessary if the tree rearranges points.
+  if (tree::TreeTraits<TreeType>::RearrangesDataset)
+  {
+    if (treeOwner && !(singleMode && hasQuerySet))
+      distancePtr = new std::vector<std::vector<double> >; // Query indices need to be mapped.
+
+    if (treeOwner)
+      neighborPtr = new std::vector<std::vector<size_t> >; // All indices need mapping.
+  }
+
+  // Resize each vector.
+  neighborPtr->clear(); // Just in case there was anything in it.
+  neighborPtr->resize(querySet.n_cols);
+  distancePtr->clear();
+  distancePtr->resize(querySet.n_cols);
+
+  // Run the search, appending to the per-query vectors.
+  VectorResultSet results(*neighborPtr, *distancePtr);
+  SearchInternal(range, results);
 
   // Map points back to original indices, if necessary.
 
@@ -336,6 +346,177 @@ void RangeSearch<MetricType, TreeType>::Search(
   }
 }
 
+template<typename MetricType, typename TreeType>
+void RangeSearch<MetricType, TreeType>::Search(
+    const math::Range& range,
+    CompactResultSet& results)
+{
+  results.Clear(); // Just in case there was anything in it.
+
+  // Run the search, collecting (query, neighbor, distance) triples in the
+  // result set's buffers.
+  SearchInternal(range, results);
+
+  // Group the results by query point, mapping points back to their original
+  // indices if we built trees that rearranged the datasets.
+  if (!treeOwner || !tree::TreeTraits<TreeType>::RearrangesDataset)
+    results.Finalize(querySet.n_cols); // No mapping needed.
+  else if (hasQuerySet && !singleMode) // Map both sets.
+    results.Finalize(querySet.n_cols, oldFromNewQueries,
+        oldFromNewReferences);
+  else if (!hasQuerySet) // Both sets are mapped through the references.
+    results.Finalize(querySet.n_cols, oldFromNewReferences,
+        oldFromNewReferences);
+  else // Map only references.
+    results.Finalize(querySet.n_cols, std::vector<size_t>(),
+        oldFromNewReferences);
+}
+
+template<typename MetricType, typename TreeType>
+void RangeSearch<MetricType, TreeType>::Search(
+    const std::vector<double>& radii,
+    std::vector<std::vector<std::vector<size_t> > >& neighbors,
+    std::vector<std::vector<std::vector<double> > >& distances)
+{
+  if (radii.empty())
+    Log::Fatal << "RangeSearch::Search(): at least one radius must be given!"
+        << std::endl;
+  for (size_t b = 1; b < radii.size(); ++b)
+    if (radii[b] <= radii[b - 1])
+      Log::Fatal << "RangeSearch::Search(): the radii must be distinct and "
+          << "sorted in ascending order!" << std::endl;
+
+  // As in the single-range Search(), the results are collected into separate
+  // objects if the indices will need to be mapped back afterwards.
+  std::vector<std::vector<std::vector<size_t> > >* neighborPtr = &neighbors;
+  std::vector<std::vector<std::vector<double> > >* distancePtr = &distances;
+
+  if (tree::TreeTraits<TreeType>::RearrangesDataset)
+  {
+    if (treeOwner && !(singleMode && hasQuerySet))
+      distancePtr = new std::vector<std::vector<std::vector<double> > >;
+
+    if (treeOwner)
+      neighborPtr = new std::vector<std::vector<std::vector<size_t> > >;
+  }
+
+  // Resize each band.
+  neighborPtr->clear(); // Just in case there was anything in it.
+  neighborPtr->resize(radii.size(),
+      std::vector<std::vector<size_t> >(querySet.n_cols));
+  distancePtr->clear();
+  distancePtr->resize(radii.size(),
+      std::vector<std::vector<double> >(querySet.n_cols));
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // Set size of prunes to 0.
+  numPrunes = 0;
+
+  // One traversal with the largest radius answers every band at once; the
+  // result set bins each result by its distance.
+  const math::Range range(0.0, radii[radii.size() - 1]);
+  typedef RangeSearchRules<MetricType, TreeType, BandedResultSet> RuleType;
+
+  if (naive || singleMode)
+  {
+    // The query points are independent, and each thread writes only to the
+    // per-query vectors of its own query points, so the queries can be
+    // divided among the threads, each of which uses its own rules object.
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      BandedResultSet results(radii, *neighborPtr, *distancePtr);
+      RuleType rules(referenceSet, querySet, range, results, metric);
+
+      if (naive)
+      {
+        // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+        #pragma omp for schedule(static)
+#endif
+        for (long i = 0; i < (long) querySet.n_cols; ++i)
+          for (size_t j = 0; j < referenceSet.n_cols; ++j)
+            rules.BaseCase((size_t) i, j);
+      }
+      else
+      {
+        typename TreeType::template SingleTreeTraverser<RuleType>
+            traverser(rules);
+
+        // The loop index is signed for OpenMP.
+#ifdef _OPENMP
+        #pragma omp for schedule(static)
+#endif
+        for (long i = 0; i < (long) querySet.n_cols; ++i)
+          traverser.Traverse((size_t) i, *referenceTree);
+
+#ifdef _OPENMP
+        #pragma omp critical (rangeSearchPrunes)
+#endif
+        numPrunes += traverser.NumPrunes();
+      }
+    }
+  }
+  else // Dual-tree recursion; its single traversal runs serially.
+  {
+    BandedResultSet results(radii, *neighborPtr, *distancePtr);
+    RuleType rules(referenceSet, querySet, range, results, metric);
+
+    typename TreeType::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    numPrunes = traverser.NumPrunes();
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+
+  // Output number of prunes.
+  Log::Info << "Number of pruned nodes during computation: " << numPrunes
+      << "." << std::endl;
+
+  // Map the points of each band back to original indices, if necessary.
+  if (!treeOwner || !tree::TreeTraits<TreeType>::RearrangesDataset)
+    return; // No mapping needed.  We are done.
+
+  neighbors.clear();
+  neighbors.resize(radii.size(),
+      std::vector<std::vector<size_t> >(querySet.n_cols));
+  if (distancePtr != &distances)
+  {
+    distances.clear();
+    distances.resize(radii.size(),
+        std::vector<std::vector<double> >(querySet.n_cols));
+  }
+
+  for (size_t b = 0; b < radii.size(); ++b)
+  {
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      // Map the query index, unless only the references were rearranged.
+      const size_t queryMapping = (singleMode && hasQuerySet) ? i :
+          (hasQuerySet ? oldFromNewQueries[i] : oldFromNewReferences[i]);
+
+      // Map distances (copy a vector), unless they are already in place.
+      if (distancePtr != &distances)
+        distances[b][queryMapping] = (*distancePtr)[b][i];
+
+      // Copy each neighbor individually, because we need to map it.
+      neighbors[b][queryMapping].resize((*neighborPtr)[b][i].size());
+      for (size_t j = 0; j < (*neighborPtr)[b][i].size(); ++j)
+        neighbors[b][queryMapping][j] =
+            oldFromNewReferences[(*neighborPtr)[b][i][j]];
+    }
+  }
+
+  // Finished with temporary objects.
+  delete neighborPtr;
+  if (distancePtr != &distances)
+    delete distancePtr;
+}
+
 template<typename MetricType, typename TreeType>
 std::string RangeSearch<MetricType, TreeType>::ToString() const
 {
@@ -0,0 +1,265 @@
+/**
+ * @file range_search_result_set.hpp
+ * @author Ryan Curtin
+ *
+ * Result set classes for range search.  The RangeSearchRules class writes its
+ * results through one of these, so that the storage strategy can be chosen
+ * independently of the traversal.
+ */
+#ifndef __MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULT_SET_HPP
+#define __MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULT_SET_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * A result set that appends each result to per-query std::vector objects.
+ * This is the storage strategy behind the classical
+ * std::vector<std::vector<size_t> > output of RangeSearch::Search().
+ */
+class VectorResultSet
+{
+ public:
+  /**
+   * Construct the result set around the given output objects.  Both vectors
+   * must already be sized to the number of query points.
+   *
+   * @param neighbors Vector of vectors to store neighbor indices in.
+   * @param distances Vector of vectors to store distances in.
+   */
+  VectorResultSet(std::vector<std::vector<size_t> >& neighbors,
+                  std::vector<std::vector<double> >& distances) :
+      neighbors(neighbors),
+      distances(distances)
+  { /* Nothing to do. */ }
+
+  //! Add a single result for the given query point.
+  void Insert(const size_t queryIndex,
+              const size_t neighbor,
+              const double distance)
+  {
+    neighbors[queryIndex].push_back(neighbor);
+    distances[queryIndex].push_back(distance);
+  }
+
+  //! Reserve space for a number of additional results for the given query
+  //! point.
+  void Reserve(const size_t queryIndex, const size_t numExtra)
+  {
+    neighbors[queryIndex].reserve(neighbors[queryIndex].size() + numExtra);
+    distances[queryIndex].reserve(distances[queryIndex].size() + numExtra);
+  }
+
+ private:
+  //! The vector the resultant neighbor indices are stored in.
+  std::vector<std::vector<size_t> >& neighbors;
+  //! The vector the resultant neighbor distances are stored in.
+  std::vector<std::vector<double> >& distances;
+};
+
+/**
+ * A result set that stores all results in a handful of contiguous growing
+ * buffers, avoiding the per-query vector allocations of VectorResultSet.
+ * During the search, each result is appended as a (query, neighbor, distance)
+ * triple; Finalize() then groups the triples by query point in a single
+ * counting pass, leaving the neighbors and distances of each query stored
+ * back to back with an offset array (in the manner of a compressed sparse row
+ * matrix).
+ *
+ * After Finalize() has been called, the results of query point i are
+ * Neighbor(i, 0) through Neighbor(i, Count(i) - 1) and the matching
+ * Distance(i, j) values; they are not sorted in any particular order.
+ */
+class CompactResultSet
+{
+ public:
+  //! Construct an empty result set.
+  CompactResultSet() { /* Nothing to do. */ }
+
+  //! Add a single result for the given query point.
+  void Insert(const size_t queryIndex,
+              const size_t neighbor,
+              const double distance)
+  {
+    hitQueries.push_back(queryIndex);
+    neighbors.push_back(neighbor);
+    distances.push_back(distance);
+  }
+
+  //! Reserve space for a number of additional results.  The query index is
+  //! ignored, because all results share the same buffers.
+  void Reserve(const size_t /* queryIndex */, const size_t numExtra)
+  {
+    hitQueries.reserve(hitQueries.size() + numExtra);
+    neighbors.reserve(neighbors.size() + numExtra);
+    distances.reserve(distances.size() + numExtra);
+  }
+
+  /**
+   * Group the collected results by query point.  This is called by
+   * RangeSearch::Search() when the search is complete; after it returns, the
+   * per-query accessors below may be used.  The optional mappings are applied
+   * to the stored query and neighbor indices (an empty mapping is the
+   * identity); they are used to map the indices of tree-rearranged datasets
+   * back to the original indices.
+   *
+   * @param numQueries Number of query points.
+   * @param queryMap Mapping to apply to query indices (may be empty).
+   * @param referenceMap Mapping to apply to neighbor indices (may be empty).
+   */
+  void Finalize(const size_t numQueries,
+                const std::vector<size_t>& queryMap = std::vector<size_t>(),
+                const std::vector<size_t>& referenceMap =
+                    std::vector<size_t>())
+  {
+    // Count the number of results of each (mapped) query point; offsets[i + 1]
+    // temporarily holds the count of query point i.
+    offsets.assign(numQueries + 1, 0);
+    for (size_t i = 0; i < hitQueries.size(); ++i)
+    {
+      const size_t query = queryMap.empty() ? hitQueries[i] :
+          queryMap[hitQueries[i]];
+      hitQueries[i] = query; // Store the mapped index for the filling pass.
+      offsets[query + 1]++;
+    }
+
+    // Turn the counts into offsets.
+    for (size_t i = 1; i <= numQueries; ++i)
+      offsets[i] += offsets[i - 1];
+
+    // Now place each result into its query point's block.  The offset array
+    // doubles as the fill cursor; afterwards offsets[i] has advanced to what
+    // was offsets[i + 1], so it is shifted back in one pass.
+    std::vector<size_t> groupedNeighbors(neighbors.size());
+    std::vector<double> groupedDistances(distances.size());
+    for (size_t i = 0; i < hitQueries.size(); ++i)
+    {
+      const size_t pos = offsets[hitQueries[i]]++;
+      groupedNeighbors[pos] = referenceMap.empty() ? neighbors[i] :
+          referenceMap[neighbors[i]];
+      groupedDistances[pos] = distances[i];
+    }
+    for (size_t i = numQueries; i > 0; --i)
+      offsets[i] = offsets[i - 1];
+    offsets[0] = 0;
+
+    neighbors.swap(groupedNeighbors);
+    distances.swap(groupedDistances);
+
+    // The query index buffer is no longer needed; release its memory.
+    std::vector<size_t>().swap(hitQueries);
+  }
+
+  //! Clear the result set, so that it can be used for another search.
+  void Clear()
+  {
+    hitQueries.clear();
+    neighbors.clear();
+    distances.clear();
+    offsets.clear();
+  }
+
+  //! Get the number of query points (only valid after Finalize()).
+  size_t NumQueries() const
+  { return (offsets.empty() ? 0 : offsets.size() - 1); }
+
+  //! Get the total number of results, over all query points.
+  size_t NumResults() const { return neighbors.size(); }
+
+  //! Get the number of results of the given query point (only valid after
+  //! Finalize()).
+  size_t Count(const size_t queryIndex) const
+  { return offsets[queryIndex + 1] - offsets[queryIndex]; }
+
+  //! Get the index of the j'th neighbor of the given query point (only valid
+  //! after Finalize()).
+  size_t Neighbor(const size_t queryIndex, const size_t j) const
+  { return neighbors[offsets[queryIndex] + j]; }
+
+  //! Get the distance to the j'th neighbor of the given query point (only
+  //! valid after Finalize()).
+  double Distance(const size_t queryIndex, const size_t j) const
+  { return distances[offsets[queryIndex] + j]; }
+
+  //! Get the offset array; entry i is the position in the packed buffers at
+  //! which the results of query point i start.
+  const std::vector<size_t>& Offsets() const { return offsets; }
+  //! Get the packed neighbor index buffer.
+  const std::vector<size_t>& Neighbors() const { return neighbors; }
+  //! Get the packed distance buffer.
+  const std::vector<double>& Distances() const { return distances; }
+
+ private:
+  //! The query point of each result, in insertion order; emptied by
+  //! Finalize().
+  std::vector<size_t> hitQueries;
+  //! The neighbor indices (packed by query point after Finalize()).
+  std::vector<size_t> neighbors;
+  //! The distances (packed by query point after Finalize()).
+  std::vector<double> distances;
+  //! The position at which each query point's results start; length is one
+  //! more than the number of query points.
+  std::vector<size_t> offsets;
+};
+
+/**
+ * A result set that bins each result into one of several radius bands.  Band
+ * b receives the results whose distance lies in (radii[b - 1], radii[b]]
+ * (band 0 receives [0, radii[0]]), so that a single traversal with the
+ * largest radius can answer a whole sweep of radii at once.
+ */
+class BandedResultSet
+{
+ public:
+  /**
+   * Construct the result set around the given output objects.  The radii must
+   * be sorted in ascending order, and the outer vectors must already be sized
+   * to the number of bands, with each band sized to the number of query
+   * points.
+   *
+   * @param radii Upper boundary of each radius band, in ascending order.
+   * @param neighbors Per-band, per-query vectors to store neighbor indices in.
+   * @param distances Per-band, per-query vectors to store distances in.
+   */
+  BandedResultSet(const std::vector<double>& radii,
+                  std::vector<std::vector<std::vector<size_t> > >& neighbors,
+                  std::vector<std::vector<std::vector<double> > >& distances) :
+      radii(radii),
+      neighbors(neighbors),
+      distances(distances)
+  { /* Nothing to do. */ }
+
+  //! Add a single result for the given query point, binning it by distance.
+  void Insert(const size_t queryIndex,
+              const size_t neighbor,
+              const double distance)
+  {
+    // There are typically only a handful of bands, so a linear scan for the
+    // first radius not less than the distance is cheapest.
+    size_t band = 0;
+    while (radii[band] < distance)
+      ++band;
+
+    neighbors[band][queryIndex].push_back(neighbor);
+    distances[band][queryIndex].push_back(distance);
+  }
+
+  //! Reserve space for a number of additional results.  The band of a result
+  //! is not known until the result is inserted, so this does nothing.
+  void Reserve(const size_t /* queryIndex */, const size_t /* numExtra */) { }
+
+ private:
+  //! The upper boundary of each radius band.
+  const std::vector<double>& radii;
+  //! The per-band vectors the resultant neighbor indices are stored in.
+  std::vector<std::vector<std::vector<size_t> > >& neighbors;
+  //! The per-band vectors the resultant distances are stored in.
+  std::vector<std::vector<std::vector<double> > >& distances;
+};
+
+}; // namespace range
+}; // namespace mlpack
+
+#endif
@@ -8,12 +8,26 @@
 #define __MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include "../neighbor_search/ns_traversal_info.hpp"
+#include "range_search_result_set.hpp"
 
 namespace mlpack {
 namespace range {
 
 
-template<typename MetricType, typename TreeType>
+/**
+ * The rules for range search with generic trees.  The results are written
+ * through a ResultSetType object, which must implement
+ *
+ *  - 'void Insert(const size_t queryIndex, const size_t neighbor,
+ *        const double distance)', which adds a single result; and
+ *  - 'void Reserve(const size_t queryIndex, const size_t numExtra)', which
+ *    reserves space for additional results (and may do nothing).
+ *
+ * See VectorResultSet and CompactResultSet for the available strategies.
+ */
+template<typename MetricType,
+         typename TreeType,
+         typename ResultSetType = VectorResultSet>
 class RangeSearchRules
 {
  public:
@@ -24,15 +38,13 @@ class RangeSearchRules
    * @param referenceSet Set of reference data.
    * @param querySet Set of query data.
    * @param range Range to search for.
-   * @param neighbors Vector to store resulting neighbors in.
-   * @param distances Vector to store resulting distances in.
+   * @param results Result set to store the results in.
    * @param metric Instantiated metric.
    */
   RangeSearchRules(const arma::mat& referenceSet,
                    const arma::mat& querySet,
                    const math::Range& range,
-                   std::vector<std::vector<size_t> >& neighbors,
-                   std::vector<std::vector<double> >& distances,
+                   ResultSetType& results,
                    MetricType& metric);
 
   /**
@@ -43,6 +55,23 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case over a contiguous block of reference points (the points
+   * of a leaf node).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point in the block.
+   * @param referenceEnd Index one past the last reference point in the block.
+   */
+  void BaseCases(const size_t queryIndex,
+                 const size_t referenceBegin,
+                 const size_t referenceEnd)
+  {
+    for (size_t i = referenceBegin; i < referenceEnd; ++i)
+      BaseCase(queryIndex, i);
+  }
+
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -108,11 +137,8 @@ class RangeSearchRules
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The result set the results should be stored in.
+  ResultSetType& results;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -13,19 +13,17 @@
 namespace mlpack {
 namespace range {
 
-template<typename MetricType, typename TreeType>
-RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
+template<typename MetricType, typename TreeType, typename ResultSetType>
+RangeSearchRules<MetricType, TreeType, ResultSetType>::RangeSearchRules(
     const arma::mat& referenceSet,
     const arma::mat& querySet,
     const math::Range& range,
-    std::vector<std::vector<size_t> >& neighbors,
-    std::vector<std::vector<double> >& distances,
+    ResultSetType& results,
     MetricType& metric) :
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    results(results),
     metric(metric),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols)
@@ -35,9 +33,9 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
 
 //! The base case.  Evaluate the distance between the two points and add to the
 //! results if necessary.
-template<typename MetricType, typename TreeType>
+template<typename MetricType, typename TreeType, typename ResultSetType>
 inline force_inline
-double RangeSearchRules<MetricType, TreeType>::BaseCase(
+double RangeSearchRules<MetricType, TreeType, ResultSetType>::BaseCase(
     const size_t queryIndex,
     const size_t referenceIndex)
 {
@@ -57,18 +55,16 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   lastReferenceIndex = referenceIndex;
 
   if (range.Contains(distance))
-  {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(distance);
-  }
+    results.Insert(queryIndex, referenceIndex, distance);
 
   return distance;
 }
 
 //! Single-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultSetType>
+double RangeSearchRules<MetricType, TreeType, ResultSetType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // We must get the minimum and maximum distances and store them in this
   // object.
@@ -125,8 +121,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
 }
 
 //! Single-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename ResultSetType>
+double RangeSearchRules<MetricType, TreeType, ResultSetType>::Rescore(
     const size_t /* queryIndex */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -136,9 +132,10 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
 }
 
 //! Dual-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultSetType>
+double RangeSearchRules<MetricType, TreeType, ResultSetType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
 {
   math::Range distances;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -172,8 +169,52 @@ double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
   }
   else
   {
-    // Just perform the calculation.
-    distances = referenceNode.RangeDistance(&queryNode);
+    // Before paying for the full RangeDistance() calculation, see whether the
+    // bounds inherited from the parent combination already decide one side of
+    // the range test.  Every point pair of this combination is a point pair
+    // of the parent combination, so the parent's minimum distance is still a
+    // valid lower bound here and the parent's maximum distance is still a
+    // valid upper bound.  When one side is decided, only the other bound
+    // needs to be computed, which is half the work.
+    bool loDecided = false;
+    bool hiDecided = false;
+    if ((traversalInfo.LastQueryNode() != NULL) &&
+        (traversalInfo.LastReferenceNode() != NULL) &&
+        ((traversalInfo.LastQueryNode() == queryNode.Parent()) ||
+         (traversalInfo.LastQueryNode() == &queryNode)) &&
+        ((traversalInfo.LastReferenceNode() == referenceNode.Parent()) ||
+         (traversalInfo.LastReferenceNode() == &referenceNode)))
+    {
+      // The parent's bounds are stashed in LastScore() (minimum) and
+      // LastBaseCase() (maximum); those members are otherwise unused on this
+      // code path (LastBaseCase() only carries a base case for trees where
+      // the first point is the centroid, which is the other branch).
+      loDecided = (traversalInfo.LastScore() >= range.Lo());
+      hiDecided = (traversalInfo.LastBaseCase() <= range.Hi());
+    }
+
+    if (loDecided && hiDecided)
+    {
+      // Inherited bounds decide everything (this can only happen on edge
+      // cases; normally the parent combination was already fully absorbed).
+      distances.Lo() = traversalInfo.LastScore();
+      distances.Hi() = traversalInfo.LastBaseCase();
+    }
+    else if (loDecided)
+    {
+      distances.Lo() = traversalInfo.LastScore();
+      distances.Hi() = referenceNode.MaxDistance(&queryNode);
+    }
+    else if (hiDecided)
+    {
+      distances.Lo() = referenceNode.MinDistance(&queryNode);
+      distances.Hi() = traversalInfo.LastBaseCase();
+    }
+    else
+    {
+      // Just perform the calculation.
+      distances = referenceNode.RangeDistance(&queryNode);
+    }
   }
 
   // If the ranges do not overlap, prune this node.
@@ -193,12 +234,20 @@ double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
   // search.
   traversalInfo.LastQueryNode() = &queryNode;
   traversalInfo.LastReferenceNode() = &referenceNode;
+  if (!tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    // Stash the bounds for the children (see above); note that these may be
+    // partially inherited themselves, which is fine -- they remain valid
+    // bounds for every descendant combination.
+    traversalInfo.LastScore() = distances.Lo();
+    traversalInfo.LastBaseCase() = distances.Hi();
+  }
   return 0.0;
 }
 
 //! Dual-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename ResultSetType>
+double RangeSearchRules<MetricType, TreeType, ResultSetType>::Rescore(
     TreeType& /* queryNode */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -209,9 +258,10 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
 
 //! Add all the points in the given node to the results for the given query
 //! point.
-template<typename MetricType, typename TreeType>
-void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
-                                                       TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultSetType>
+void RangeSearchRules<MetricType, TreeType, ResultSetType>::AddResult(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // Some types of trees calculate the base case evaluation before Score() is
   // called, so if the base case has already been calculated, then we must avoid
@@ -224,14 +274,10 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     baseCaseMod = 1;
   }
 
-  // Resize distances and neighbors vectors appropriately.  We have to use
-  // reserve() and not resize(), because we don't know if we will encounter the
-  // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  // Reserve space in the result set.  We cannot simply add all the results,
+  // because we don't know if we will encounter the case where the datasets
+  // and points are the same (and we skip in that case).
+  results.Reserve(queryIndex, referenceNode.NumDescendants() - baseCaseMod);
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
@@ -242,8 +288,7 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
         referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(distance);
+    results.Insert(queryIndex, referenceNode.Descendant(i), distance);
   }
 }
 
@@ -230,23 +230,48 @@ Search(const size_t k,
     // points; we can achieve the rank approximation guarantee with probability
     // alpha by sampling the reference set.
     typedef RASearchRules<SortPolicy, MetricType, TreeType> RuleType;
+    // Pass false for the naive parameter so that the sampling is done here
+    // (possibly in parallel) instead of in the constructor.
     RuleType rules(referenceSet, querySet, *neighborPtr, *distancePtr,
-                   metric, tau, alpha, naive, sampleAtLeaves, firstLeafExact,
+                   metric, tau, alpha, false, sampleAtLeaves, firstLeafExact,
                    singleSampleLimit);
 
-    // Find how many samples from the reference set we need and sample uniformly
-    // from the reference set without replacement.
+    // Find how many samples from the reference set we need, then sample a
+    // distinct set of reference points for each query point and run the base
+    // case on each combination.  The queries are independent, so they can be
+    // handled in parallel with a thread-local copy of the rules; each thread
+    // samples from its own random stream (see math::RandGen()).
     const size_t numSamples = rules.MinimumSamplesReqd(referenceSet.n_cols, k,
         tau, alpha);
-    arma::uvec distinctSamples;
-    rules.ObtainDistinctSamples(numSamples, referenceSet.n_cols,
-        distinctSamples);
 
-    // Run the base case on each combination of query point and sampled
-    // reference point.
+    #ifdef _OPENMP
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(dynamic, 64)
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+      {
+        arma::uvec distinctSamples;
+        threadRules.ObtainDistinctSamples(numSamples, referenceSet.n_cols,
+            distinctSamples);
+        for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+          threadRules.BaseCase(i, (size_t) distinctSamples[j]);
+      }
+
+      #pragma omp critical (raSearchMerge)
+      rules.Merge(threadRules);
+    }
+    #else
     for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      arma::uvec distinctSamples;
+      rules.ObtainDistinctSamples(numSamples, referenceSet.n_cols,
+          distinctSamples);
       for (size_t j = 0; j < distinctSamples.n_elem; ++j)
         rules.BaseCase(i, (size_t) distinctSamples[j]);
+    }
+    #endif
   }
   else if (singleMode)
   {
@@ -263,6 +288,30 @@ Search(const size_t k,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
+      // Each query point traverses the reference tree independently and
+      // writes only to its own column of the results, so the queries can be
+      // handled in parallel with one traverser (and thread-local copy of the
+      // rules) per thread.
+      #ifdef _OPENMP
+      #pragma omp parallel
+      {
+        RuleType threadRules(rules);
+        typename TreeType::template SingleTreeTraverser<RuleType>
+            threadTraverser(threadRules);
+
+        // Dynamic scheduling, since different query points can take very
+        // different amounts of sampling and pruning work.
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < querySet.n_cols; ++i)
+          threadTraverser.Traverse(i, *referenceTree);
+
+        #pragma omp atomic
+        numPrunes += threadTraverser.NumPrunes();
+
+        #pragma omp critical (raSearchMerge)
+        rules.Merge(threadRules);
+      }
+      #else
       // Create the traverser.
       typename TreeType::template SingleTreeTraverser<RuleType>
         traverser(rules);
@@ -272,6 +321,7 @@ Search(const size_t k,
         traverser.Traverse(i, *referenceTree);
 
       numPrunes = traverser.NumPrunes();
+      #endif
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -31,10 +31,51 @@ class RASearchRules
                 const bool firstLeafExact = false,
                 const size_t singleSampleLimit = 20);
 
+  /**
+   * Create a thread-local copy of another RASearchRules object, for use
+   * inside an OpenMP parallel region.  The copy shares the datasets, the
+   * result matrices and the metric with the original, and reuses its sampling
+   * parameters (so no revalidation or recomputation of the required number of
+   * samples is done), but starts with fresh per-query sample counts and a
+   * fresh distance-computation counter.  After the parallel work is done, the
+   * statistics can be folded back into the original with Merge().
+   *
+   * This is only safe when each query point is handled by exactly one of the
+   * copies.
+   *
+   * @param other RASearchRules object to copy sampling parameters from.
+   */
+  RASearchRules(const RASearchRules& other);
 
+  /**
+   * Merge the sampling statistics of a thread-local copy (made with the copy
+   * constructor) back into this object.  Since each query is handled by
+   * exactly one copy, the per-query sample counts are disjoint and simple
+   * addition is exact.
+   *
+   * @param other Thread-local copy whose statistics should be merged in.
+   */
+  void Merge(const RASearchRules& other);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case over a contiguous block of reference points (the points
+   * of a leaf node).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point in the block.
+   * @param referenceEnd Index one past the last reference point in the block.
+   */
+  void BaseCases(const size_t queryIndex,
+                 const size_t referenceBegin,
+                 const size_t referenceEnd)
+  {
+    for (size_t i = referenceBegin; i < referenceEnd; ++i)
+      BaseCase(queryIndex, i);
+  }
+
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -79,6 +79,35 @@ RASearchRules(const arma::mat& referenceSet,
   }
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+RASearchRules<SortPolicy, MetricType, TreeType>::
+RASearchRules(const RASearchRules& other) :
+  referenceSet(other.referenceSet),
+  querySet(other.querySet),
+  neighbors(other.neighbors),
+  distances(other.distances),
+  metric(other.metric),
+  sampleAtLeaves(other.sampleAtLeaves),
+  firstLeafExact(other.firstLeafExact),
+  singleSampleLimit(other.singleSampleLimit),
+  numSamplesReqd(other.numSamplesReqd),
+  samplingRatio(other.samplingRatio)
+{
+  // Start with fresh statistics; the original's are not copied, so that the
+  // statistics of several copies can simply be added back with Merge().
+  numSamplesMade = arma::zeros<arma::Col<size_t> >(querySet.n_cols);
+  numDistComputations = 0;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::
+Merge(const RASearchRules& other)
+{
+  // Each query is handled by exactly one copy, so the entries of
+  // numSamplesMade are disjoint between the copies and addition is exact.
+  numSamplesMade += other.numSamplesMade;
+  numDistComputations += other.numDistComputations;
+}
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline force_inline
@@ -91,8 +120,11 @@ ObtainDistinctSamples(const size_t numSamples,
   arma::Col<size_t> sampledPoints;
   sampledPoints.zeros(rangeUpperBound);
 
+  // Draw all the samples for this call in one batch.
+  arma::Col<size_t> samples;
+  math::RandIntVec(rangeUpperBound, numSamples, samples);
   for (size_t i = 0; i < numSamples; i++)
-    sampledPoints[(size_t) math::RandInt(rangeUpperBound)]++;
+    sampledPoints[samples[i]]++;
 
   distinctSamples = arma::find(sampledPoints > 0);
   return;
@@ -129,16 +129,62 @@ double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(arma::mat& parameters)
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
 
-  // To keep track of where we are and how things are going.
-  size_t currentFunction = 0;
+  // To keep track of how things are going.
   double overallObjective = 0;
 
   // Calculate the first objective function.
   for(size_t i = 0; i < numFunctions; i++)
     overallObjective += function.Evaluate(parameters, i);
-    
+
   const arma::mat data = function.Dataset();
 
+#ifdef _OPENMP
+  // Lock-free (Hogwild-style) parallel SGD.  Each rating only touches the two
+  // parameter columns of its user and its item, so updates to ratings with
+  // disjoint (user, item) pairs never conflict, and with many users and items
+  // the occasional unsynchronized update of a shared column perturbs the
+  // stochastic updates far less than the gradient noise already does.  The
+  // iterations are split into full passes over the ratings (and one partial
+  // pass for the remainder), each parallelized over the ratings.
+  const size_t numUsers = function.NumUsers();
+  const double lambda = function.Lambda();
+  const size_t totalIterations = maxIterations - 1;
+  const size_t fullPasses = totalIterations / numFunctions;
+  const size_t remainder = totalIterations % numFunctions;
+
+  for(size_t pass = 0; pass <= fullPasses; pass++)
+  {
+    const size_t passLength = (pass < fullPasses) ? numFunctions : remainder;
+
+    #pragma omp parallel for schedule(static)
+    for(long j = 0; j < (long) passLength; j++)
+    {
+      // Indices for accessing the the correct parameter columns.
+      const size_t user = data(0, j);
+      const size_t item = data(1, j) + numUsers;
+
+      // Prediction error for the example.
+      const double rating = data(2, j);
+      double ratingError = rating - arma::dot(parameters.col(user),
+                                              parameters.col(item));
+
+      // Gradient is non-zero only for the parameter columns corresponding to
+      // the example.
+      parameters.col(user) -= stepSize * (lambda * parameters.col(user) -
+                                          ratingError * parameters.col(item));
+      parameters.col(item) -= stepSize * (lambda * parameters.col(item) -
+                                          ratingError * parameters.col(user));
+    }
+  }
+
+  // Calculate the final objective.
+  overallObjective = 0;
+  for(size_t i = 0; i < numFunctions; i++)
+    overallObjective += function.Evaluate(parameters, i);
+#else
+  // To keep track of where we are.
+  size_t currentFunction = 0;
+
   // Now iterate!
   for(size_t i = 1; i != maxIterations; i++, currentFunction++)
   {
@@ -173,6 +219,7 @@ double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(arma::mat& parameters)
     // Now add that to the overall objective function.
     overallObjective += function.Evaluate(parameters, currentFunction);
   }
+#endif
 
   return overallObjective;
 }
@@ -103,7 +103,10 @@ namespace optimization {
   /**
    * Template specialization for SGD optimizer. Used because the gradient
    * affects only a small number of parameters per example, and thus the normal
-   * abstraction does not work as fast as we might like it to.
+   * abstraction does not work as fast as we might like it to.  When OpenMP is
+   * enabled, the updates are applied in parallel over the ratings without
+   * locks (Hogwild-style), which is safe for the same reason: each update
+   * only touches the parameter columns of its own user and item.
    */
   template<>
   double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(
@@ -77,6 +77,43 @@ void SoftmaxRegressionFunction::GetGroundTruthMatrix(const arma::vec& labels,
                              labels.n_elem);
 }
 
+/**
+ * Computes the class probabilities of a contiguous batch of training examples.
+ */
+void SoftmaxRegressionFunction::GetProbabilities(const arma::mat& parameters,
+                                                 const size_t begin,
+                                                 const size_t batchSize,
+                                                 arma::mat& probabilities)
+    const
+{
+  // One matrix product for the logits of the whole batch; everything after
+  // this is performed in-place on the result.
+  probabilities = parameters * data.cols(begin, begin + batchSize - 1);
+
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    double* col = probabilities.colptr(j);
+
+    // Subtract the maximum logit of the example from all of its logits before
+    // exponentiating. This does not change the probabilities, but keeps the
+    // exponentials from overflowing.
+    double colMax = col[0];
+    for (size_t i = 1; i < numClasses; ++i)
+      if (col[i] > colMax)
+        colMax = col[i];
+
+    double colSum = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      col[i] = std::exp(col[i] - colMax);
+      colSum += col[i];
+    }
+
+    for (size_t i = 0; i < numClasses; ++i)
+      col[i] /= colSum;
+  }
+}
+
 /**
  * Evaluates the objective function given the parameters.
  */
@@ -98,26 +135,56 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
   // The sum is calculated over all the classes.
   // x_i is the input vector for a particular training example.
   // theta_j is the parameter vector associated with a particular class.
-  arma::mat hypothesis, probabilities;
-  
-  hypothesis = arma::exp(parameters * data);
-  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
-                                            numClasses, 1);
-                                            
+  GetProbabilities(parameters, 0, data.n_cols, probabilities);
+
   // Calculate the log likelihood and regularization terms.
   double logLikelihood, weightDecay, cost;
-  
+
   logLikelihood = arma::accu(groundTruth % arma::log(probabilities)) /
       data.n_cols;
   weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
-  
+
   // The cost is the sum of the negative log likelihood and the regularization
-  // terms. 
+  // terms.
   cost = -logLikelihood + weightDecay;
-      
+
   return cost;
 }
 
+/**
+ * Evaluates the objective function for one training example.
+ */
+double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t i) const
+{
+  return Evaluate(parameters, i, 1);
+}
+
+/**
+ * Evaluates the objective function for a contiguous batch of training
+ * examples.
+ */
+double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  GetProbabilities(parameters, begin, batchSize, probabilities);
+
+  // Sum the log probabilities of the labelled classes of the batch. Dividing
+  // by the total number of examples and scaling the regularization term by
+  // the fraction of the dataset in the batch makes the objectives of all
+  // batches sum to the full objective.
+  double logLikelihood = 0.0;
+  for (size_t j = 0; j < batchSize; ++j)
+    logLikelihood += std::log(probabilities((size_t) labels(begin + j), j));
+  logLikelihood /= data.n_cols;
+
+  const double weightDecay = 0.5 * lambda *
+      ((double) batchSize / data.n_cols) * arma::accu(parameters % parameters);
+
+  return -logLikelihood + weightDecay;
+}
+
 /**
  * Calculates and stores the gradient values given a set of parameters.
  */
@@ -130,13 +197,42 @@ void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
   // The sum is calculated over all the classes.
   // x_i is the input vector for a particular training example.
   // theta_j is the parameter vector associated with a particular class.
-  arma::mat hypothesis, probabilities;
-  
-  hypothesis = arma::exp(parameters * data);
-  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
-                                            numClasses, 1);
-                                            
+  GetProbabilities(parameters, 0, data.n_cols, probabilities);
+
   // Calculate the parameter gradients.
   gradient = (probabilities - groundTruth) * data.t() / data.n_cols +
       lambda * parameters;
 }
+
+/**
+ * Calculates and stores the gradient values for one training example.
+ */
+void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
+                                         const size_t i,
+                                         arma::mat& gradient) const
+{
+  Gradient(parameters, i, 1, gradient);
+}
+
+/**
+ * Calculates and stores the gradient values for a contiguous batch of training
+ * examples.
+ */
+void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         const size_t batchSize,
+                                         arma::mat& gradient) const
+{
+  GetProbabilities(parameters, begin, batchSize, probabilities);
+
+  // Subtract the ground truth of the batch in-place, instead of materializing
+  // a slice of the ground truth matrix.
+  for (size_t j = 0; j < batchSize; ++j)
+    probabilities((size_t) labels(begin + j), j) -= 1.0;
+
+  // As with the batch objective, dividing by the total number of examples and
+  // scaling the regularization term makes the gradients of all batches sum to
+  // the full gradient.
+  gradient = probabilities * data.cols(begin, begin + batchSize - 1).t() /
+      data.n_cols + lambda * ((double) batchSize / data.n_cols) * parameters;
+}
@@ -53,7 +53,32 @@ class SoftmaxRegressionFunction
    * @param parameters Current values of the model parameters.
    */
   double Evaluate(const arma::mat& parameters) const;
-  
+
+  /**
+   * Evaluates the objective function using only one training example. This is
+   * useful for optimizers which require a separable objective function, such
+   * as SGD.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param i Index of the training example to be used.
+   */
+  double Evaluate(const arma::mat& parameters, const size_t i) const;
+
+  /**
+   * Evaluates the objective function using a contiguous mini-batch of training
+   * examples. The probabilities of the batch are calculated with a single
+   * matrix product, and the regularization term is scaled by the fraction of
+   * the dataset in the batch, so that the objectives of all batches sum to the
+   * full objective.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first training example of the batch.
+   * @param batchSize Number of training examples in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters. The function calculates the probabilities for each class
@@ -64,9 +89,40 @@ class SoftmaxRegressionFunction
    * @param gradient Matrix where gradient values will be stored.
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
-  
+
+  /**
+   * Evaluates the gradient of the objective function using only one training
+   * example. This is useful for optimizers which require a separable objective
+   * function, such as SGD.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param i Index of the training example to be used.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::mat& gradient) const;
+
+  /**
+   * Evaluates the gradient of the objective function using a contiguous
+   * mini-batch of training examples. The gradients of all batches sum to the
+   * full gradient.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first training example of the batch.
+   * @param batchSize Number of training examples in the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
+
+  //! Return the number of separable functions (the number of training points).
+  size_t NumFunctions() const { return data.n_cols; }
   
   //! Sets the size of the input vector.
   void InputSize(const size_t input)
@@ -105,6 +161,24 @@ class SoftmaxRegressionFunction
   }
                             
  private:
+  /**
+   * Computes the class probabilities of a contiguous batch of training
+   * examples. The logits of the batch are calculated with a single matrix
+   * product, and the exponentiation and normalization are performed in-place
+   * on that result; the maximum logit of each example is subtracted before
+   * exponentiating, which does not change the probabilities but keeps the
+   * exponentials from overflowing.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first training example of the batch.
+   * @param batchSize Number of training examples in the batch.
+   * @param probabilities Matrix to store the calculated probabilities in.
+   */
+  void GetProbabilities(const arma::mat& parameters,
+                        const size_t begin,
+                        const size_t batchSize,
+                        arma::mat& probabilities) const;
+
   //! Training data matrix.
   const arma::mat& data;
   //! Labels associated with the training data.
@@ -113,6 +187,9 @@ class SoftmaxRegressionFunction
   arma::sp_mat groundTruth;
   //! Initial parameter point.
   arma::mat initialPoint;
+  //! Workspace for the probability calculations; kept as a member so that
+  //! repeated calls to Evaluate() and Gradient() do not reallocate it.
+  mutable arma::mat probabilities;
   //! Size of input feature vector.
   size_t inputSize;
   //! Number of classes.
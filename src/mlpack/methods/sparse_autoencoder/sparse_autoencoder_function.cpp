@@ -69,6 +69,15 @@ const arma::mat SparseAutoencoderFunction::InitializeWeights()
 /** Evaluates the objective function given the parameters.
   */
 double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Evaluate(parameters, 0, data.n_cols);
+}
+
+/** Evaluates the objective function on a mini-batch of the data.
+  */
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -83,6 +92,9 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   const size_t l2 = visibleSize;
   const size_t l3 = 2 * hiddenSize;
 
+  // The last column of the mini-batch.
+  const size_t lastCol = begin + batchSize - 1;
+
   // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
   // used in their place to avoid copying data. The following representations
   // are used:
@@ -91,23 +103,24 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
+  // Compute activations of the hidden and output layers.  The activation
+  // matrices are member variables, so repeated calls with the same batch size
+  // do not reallocate them.
+  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) *
+      data.cols(begin, lastCol) +
+      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, batchSize),
       hiddenLayer);
 
   Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
+      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, batchSize),
       outputLayer);
 
-  arma::mat rhoCap, diff;
+  arma::mat rhoCap;
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
+  rhoCap = arma::sum(hiddenLayer, 1) / batchSize;
   // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
+  diff = outputLayer - data.cols(begin, lastCol);
 
   double wL2SquaredNorm;
 
@@ -123,9 +136,14 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
+  // The regularization and sparsity terms are scaled by the fraction of the
+  // dataset in the mini-batch, so the mini-batch costs approximately sum to
+  // the cost of the whole dataset.
   sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
+  weightDecay = 0.5 * lambda * wL2SquaredNorm *
+      ((double) batchSize / data.n_cols);
+  klDivergence = beta * ((double) batchSize / data.n_cols) *
+      arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
       arma::log((1 - rho) / (1 - rhoCap)));
 
   // The cost is the sum of the terms calculated above.
@@ -138,6 +156,16 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   */
 void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
                                          arma::mat& gradient) const
+{
+  Gradient(parameters, 0, data.n_cols, gradient);
+}
+
+/** Calculates the gradient values on a mini-batch of the data.
+  */
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         const size_t batchSize,
+                                         arma::mat& gradient) const
 {
   // Performs a feedforward pass of the neural network, and computes the
   // activations of the output layer as in the Evaluate() method. It uses the
@@ -150,6 +178,9 @@ void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
   const size_t l2 = visibleSize;
   const size_t l3 = 2 * hiddenSize;
 
+  // The last column of the mini-batch.
+  const size_t lastCol = begin + batchSize - 1;
+
   // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
   // used in their place to avoid copying data. The following representations
   // are used:
@@ -158,25 +189,26 @@ void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
+  // Compute activations of the hidden and output layers.  The activation and
+  // delta matrices are member variables, so repeated calls with the same
+  // batch size do not reallocate them.
+  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) *
+      data.cols(begin, lastCol) +
+      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, batchSize),
       hiddenLayer);
 
   Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
+      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, batchSize),
       outputLayer);
 
-  arma::mat rhoCap, diff;
+  arma::mat rhoCap;
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
+  rhoCap = arma::sum(hiddenLayer, 1) / batchSize;
   // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
+  diff = outputLayer - data.cols(begin, lastCol);
 
-  arma::mat klDivGrad, delOut, delHid;
+  arma::mat klDivGrad;
 
   // The delta vector for the output layer is given by diff * f'(z), where z is
   // the preactivation and f is the activation function. The derivative of the
@@ -187,19 +219,25 @@ void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
   klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
   delOut = diff % outputLayer % (1 - outputLayer);
   delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
+      arma::repmat(klDivGrad, 1, batchSize)) % hiddenLayer %
       (1 - hiddenLayer);
 
   gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
 
+  // The regularization terms are scaled by the fraction of the dataset in the
+  // mini-batch, matching the scaling of the mini-batch objective.
+  const double batchFactor = (double) batchSize / data.n_cols;
+
   // Compute the gradient values using the activations and the delta values. The
   // formula also accounts for the regularization terms in the objective.
   // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
+  gradient.submat(0, 0, l1 - 1, l2 - 1) =
+      delHid * data.cols(begin, lastCol).t() / data.n_cols +
+      batchFactor * lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
   gradient.submat(l1, 0, l3 - 1, l2 - 1) =
       (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
+      batchFactor * lambda *
+      parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
   gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
   gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
 }
@@ -54,6 +54,22 @@ class SparseAutoencoderFunction
    */
   double Evaluate(const arma::mat& parameters) const;
 
+  /**
+   * Evaluates the objective function on a mini-batch of batchSize contiguous
+   * data points, starting with the point indexed by begin. The reconstruction
+   * error is divided by the total number of points and the regularization and
+   * sparsity terms are scaled down accordingly, so the mini-batch objectives
+   * approximately sum to the full objective (the sparsity term uses the
+   * average activations of the mini-batch, so the sum is not exact).
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the mini-batch.
+   * @param batchSize Number of points in the mini-batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters. The function performs a feedforward pass and computes
@@ -65,6 +81,21 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluates the gradient of the objective function on a mini-batch of
+   * batchSize contiguous data points, starting with the point indexed by
+   * begin. The gradient is scaled in the same way as the mini-batch objective.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the mini-batch.
+   * @param batchSize Number of points in the mini-batch.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -154,6 +185,20 @@ class SparseAutoencoderFunction
   double beta;
   //! Sparsity parameter.
   double rho;
+
+  // Workspace matrices for the forward and backward passes, held as member
+  // variables so that repeated Evaluate() and Gradient() calls with the same
+  // batch size do not reallocate them.
+  //! Activations of the hidden layer.
+  mutable arma::mat hiddenLayer;
+  //! Activations of the output layer.
+  mutable arma::mat outputLayer;
+  //! Difference between the reconstructed data and the original data.
+  mutable arma::mat diff;
+  //! Delta values of the output layer.
+  mutable arma::mat delOut;
+  //! Delta values of the hidden layer.
+  mutable arma::mat delHid;
 };
 
 }; // namespace nn
@@ -98,20 +98,33 @@ void SparseCoding<DictionaryInitializer>::OptimizeCode()
   // lambda2 > 0.
   arma::mat matGram = trans(dictionary) * dictionary;
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  // Each point is coded independently, so the loop can be parallelized.  The
+  // Gram matrix is shared (read-only) between the threads, and each thread
+  // keeps a single LARS solver which is reused for every point that thread
+  // codes.  The number of LARS steps varies between points, so use dynamic
+  // scheduling.
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
   {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    lars.Regress(dictionary, data.unsafe_col(i), code, false);
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 16)
+#endif
+    for (long i = 0; i < (long) data.n_cols; ++i)
+    {
+      // Report progress.
+      if ((i % 100) == 0)
+        Log::Debug << "Optimization at point " << i << "." << std::endl;
+
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      arma::vec code = codes.unsafe_col(i);
+      lars.Regress(dictionary, data.unsafe_col(i), code, false);
+    }
   }
 }
 
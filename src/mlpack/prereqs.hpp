@@ -45,6 +45,15 @@ problems.  It should only be necessary to include <mlpack/core.hpp> and not\
   #define force_inline __forceinline
 #endif
 
+// Also give ourselves a way to hint that an address is about to be read, so
+// the processor can start pulling it toward the cache while other work runs.
+// This is only a hint, and expands to nothing where no intrinsic exists.
+#if defined(__GNUG__)
+  #define mlpack_prefetch(address) __builtin_prefetch(address)
+#else
+  #define mlpack_prefetch(address) ((void) (address))
+#endif
+
 // Now include Armadillo through the special mlpack extensions.
 #include <mlpack/core/arma_extend/arma_extend.hpp>
 
@@ -6,6 +6,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
+#include <mlpack/methods/neighbor_search/shard_merge.hpp>
+#include <mlpack/methods/neighbor_search/quantized_knn.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
@@ -587,6 +589,62 @@ BOOST_AUTO_TEST_CASE(SingleTreeVsNaive)
   }
 }
 
+/**
+ * Test defeatist (spill-emulating) search.  With a very large overlap buffer
+ * no child within reach is ever skipped, so the results must match the exact
+ * search; with no overlap the search is a single root-to-leaf descent per
+ * query, which is approximate but must still produce valid results with
+ * reasonable recall.
+ */
+BOOST_AUTO_TEST_CASE(DefeatistSearchTest)
+{
+  arma::mat dataset;
+  dataset.randu(10, 1000);
+
+  AllkNN allknn(dataset, false, true);
+
+  arma::Mat<size_t> exactNeighbors;
+  arma::mat exactDistances;
+  allknn.Search(5, exactNeighbors, exactDistances);
+
+  // A very large overlap buffer degenerates to exact search (everything that
+  // scoring cannot prune outright is visited).
+  arma::Mat<size_t> wideNeighbors;
+  arma::mat wideDistances;
+  allknn.SearchDefeatist(5, wideNeighbors, wideDistances, DBL_MAX);
+
+  for (size_t i = 0; i < exactNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(wideNeighbors[i], exactNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(wideDistances[i], exactDistances[i], 1e-5);
+  }
+
+  // Pure defeatist search: one root-to-leaf path per query.
+  arma::Mat<size_t> greedyNeighbors;
+  arma::mat greedyDistances;
+  allknn.SearchDefeatist(1, greedyNeighbors, greedyDistances);
+
+  BOOST_REQUIRE_EQUAL(greedyNeighbors.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(greedyNeighbors.n_cols, dataset.n_cols);
+
+  size_t hits = 0;
+  for (size_t i = 0; i < greedyNeighbors.n_cols; ++i)
+  {
+    // The result must be a valid point, and an approximate search cannot do
+    // better than the exact one.
+    BOOST_REQUIRE_LT(greedyNeighbors(0, i), dataset.n_cols);
+    BOOST_REQUIRE_GE(greedyDistances(0, i), exactDistances(0, i) - 1e-10);
+
+    if (greedyNeighbors(0, i) == exactNeighbors(0, i))
+      ++hits;
+  }
+
+  // Defeatist recall on uniform data is imperfect but substantial (each query
+  // point descends into its own leaf); anything below half suggests the
+  // descent is broken.
+  BOOST_REQUIRE_GT(hits, greedyNeighbors.n_cols / 2);
+}
+
 /**
  * Test the cover tree single-tree nearest-neighbors method against the naive
  * method.  This uses only a random reference dataset.
@@ -777,6 +835,302 @@ BOOST_AUTO_TEST_CASE(SparseAllkNNKDTreeTest)
   }
 }
 
+/**
+ * Make sure single-precision search with a kd-tree works, using single
+ * precision for the dataset and for the bounds of the tree.
+ */
+BOOST_AUTO_TEST_CASE(FloatAllkNNKDTreeTest)
+{
+  typedef BinarySpaceTree<HRectBound<2, true, float>,
+      NeighborSearchStat<NearestNeighborSort>, arma::fmat> FloatKDTree;
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, FloatKDTree>
+      FloatAllkNN;
+
+  arma::fmat queryDataset(10, 500);
+  queryDataset.randu();
+  arma::fmat referenceDataset(10, 800);
+  referenceDataset.randu();
+
+  arma::fmat naiveQuery(queryDataset);
+  arma::fmat naiveReference(referenceDataset);
+
+  FloatAllkNN a(queryDataset, referenceDataset);
+  FloatAllkNN naive(naiveQuery, naiveReference, true);
+
+  arma::mat treeDistances;
+  arma::Mat<size_t> treeNeighbors;
+  a.Search(10, treeNeighbors, treeDistances);
+
+  arma::mat naiveDistances;
+  arma::Mat<size_t> naiveNeighbors;
+  naive.Search(10, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < naiveNeighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < naiveNeighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(naiveNeighbors(j, i), treeNeighbors(j, i));
+      BOOST_REQUIRE_CLOSE(naiveDistances(j, i), treeDistances(j, i), 1e-3);
+    }
+  }
+}
+
+/**
+ * Make sure the batched single-tree traversal gives the same results as
+ * traversing the reference tree once per query point.
+ */
+BOOST_AUTO_TEST_CASE(SingleTreeTraverserBatchTest)
+{
+  typedef BinarySpaceTree<HRectBound<2>,
+      NeighborSearchStat<NearestNeighborSort> > TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RuleType;
+
+  arma::mat referenceData(8, 800);
+  referenceData.randu();
+  arma::mat queryData(8, 150);
+  queryData.randu();
+
+  // Build the tree; this rearranges referenceData, so both traversals see the
+  // same point ordering.
+  TreeType tree(referenceData, 20);
+
+  EuclideanDistance metric;
+
+  // One query point at a time.
+  arma::Mat<size_t> neighbors(5, queryData.n_cols);
+  neighbors.fill(size_t() - 1);
+  arma::mat distances(5, queryData.n_cols);
+  distances.fill(NearestNeighborSort::WorstDistance());
+
+  RuleType rules(referenceData, queryData, neighbors, distances, metric);
+  TreeType::SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    traverser.Traverse(i, tree);
+
+  // The whole query set as one block.
+  arma::Mat<size_t> batchNeighbors(5, queryData.n_cols);
+  batchNeighbors.fill(size_t() - 1);
+  arma::mat batchDistances(5, queryData.n_cols);
+  batchDistances.fill(NearestNeighborSort::WorstDistance());
+
+  RuleType batchRules(referenceData, queryData, batchNeighbors,
+      batchDistances, metric);
+  TreeType::SingleTreeTraverser<RuleType> batchTraverser(batchRules);
+  std::vector<size_t> block(queryData.n_cols);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    block[i] = i;
+  batchTraverser.Traverse(block, tree);
+
+  // The candidate lists are heaps, and the two traversals fill them in
+  // different orders, so compare the sorted lists.
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    arma::vec dist = arma::sort(distances.col(i));
+    arma::vec batchDist = arma::sort(batchDistances.col(i));
+    arma::Col<size_t> neigh = arma::sort(neighbors.col(i));
+    arma::Col<size_t> batchNeigh = arma::sort(batchNeighbors.col(i));
+
+    for (size_t j = 0; j < dist.n_elem; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neigh[j], batchNeigh[j]);
+      BOOST_REQUIRE_EQUAL(dist[j], batchDist[j]);
+    }
+  }
+}
+
+/**
+ * Make sure the breadth-first dual-tree traversal gives the same results as
+ * the single-tree traversal.
+ */
+BOOST_AUTO_TEST_CASE(BreadthFirstDualTreeTraverserTest)
+{
+  typedef BinarySpaceTree<HRectBound<2>,
+      NeighborSearchStat<NearestNeighborSort> > TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RuleType;
+
+  arma::mat referenceData(8, 800);
+  referenceData.randu();
+  arma::mat queryData(8, 150);
+  queryData.randu();
+
+  // Build both trees first; this rearranges the datasets, so both traversals
+  // see the same point ordering.
+  TreeType referenceTree(referenceData, 20);
+  TreeType queryTree(queryData, 20);
+
+  EuclideanDistance metric;
+
+  // Single-tree traversal, one query point at a time.
+  arma::Mat<size_t> neighbors(5, queryData.n_cols);
+  neighbors.fill(size_t() - 1);
+  arma::mat distances(5, queryData.n_cols);
+  distances.fill(NearestNeighborSort::WorstDistance());
+
+  RuleType rules(referenceData, queryData, neighbors, distances, metric);
+  TreeType::SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    traverser.Traverse(i, referenceTree);
+
+  // Breadth-first dual-tree traversal.
+  arma::Mat<size_t> bfNeighbors(5, queryData.n_cols);
+  bfNeighbors.fill(size_t() - 1);
+  arma::mat bfDistances(5, queryData.n_cols);
+  bfDistances.fill(NearestNeighborSort::WorstDistance());
+
+  RuleType bfRules(referenceData, queryData, bfNeighbors, bfDistances,
+      metric);
+  TreeType::BreadthFirstDualTreeTraverser<RuleType> bfTraverser(bfRules);
+  bfTraverser.Traverse(queryTree, referenceTree);
+
+  // The candidate lists are heaps, and the two traversals fill them in
+  // different orders, so compare the sorted lists.
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    arma::vec dist = arma::sort(distances.col(i));
+    arma::vec bfDist = arma::sort(bfDistances.col(i));
+    arma::Col<size_t> neigh = arma::sort(neighbors.col(i));
+    arma::Col<size_t> bfNeigh = arma::sort(bfNeighbors.col(i));
+
+    for (size_t j = 0; j < dist.n_elem; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neigh[j], bfNeigh[j]);
+      BOOST_REQUIRE_EQUAL(dist[j], bfDist[j]);
+    }
+  }
+}
+
+/**
+ * Make sure the REARRANGE_IN_PLACE dataset ownership policy gives the same
+ * results as the default copying constructor.
+ */
+BOOST_AUTO_TEST_CASE(RearrangeInPlaceTest)
+{
+  arma::mat dataset(5, 300);
+  dataset.randu();
+  arma::mat datasetCopy(dataset);
+
+  AllkNN copying(dataset);
+  arma::Mat<size_t> copyNeighbors;
+  arma::mat copyDistances;
+  copying.Search(5, copyNeighbors, copyDistances);
+
+  // The copying constructor must not have touched the caller's matrix.
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(dataset[i], datasetCopy[i]);
+
+  // This permutes the caller's matrix in place instead of copying it.
+  AllkNN inPlace(dataset, AllkNN::REARRANGE_IN_PLACE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  inPlace.Search(5, neighbors, distances);
+
+  // The results are mapped back to the original point ordering, so they must
+  // match the copying search exactly.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), copyNeighbors(j, i));
+      BOOST_REQUIRE_CLOSE(distances(j, i), copyDistances(j, i), 1e-10);
+    }
+  }
+
+  // Incremental updates are not available with a borrowed dataset; that is
+  // checked by CheckUpdateSupport(), which calls Log::Fatal, so it cannot be
+  // exercised here.
+}
+
+/**
+ * Test incremental reference set updates: insert and delete points without a
+ * rebuild, verify the results against a brute-force search over the effective
+ * reference set, then fold the changes in with Rebuild() and verify again.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalReferenceUpdateTest)
+{
+  arma::mat referenceData(8, 500);
+  referenceData.randu();
+  arma::mat queryData(8, 100);
+  queryData.randu();
+  const size_t k = 5;
+
+  AllkNN allknn(referenceData, queryData);
+
+  // Delete some points and insert some new ones; too few to trigger the
+  // automatic rebuild (the default threshold is 10% of 500 points).
+  arma::mat newPoints(8, 10);
+  newPoints.randu();
+  for (size_t i = 0; i < 10; ++i)
+  {
+    allknn.DeletePoint(7 * i); // Arbitrary original indices.
+    allknn.InsertPoint(newPoints.col(i));
+  }
+  BOOST_REQUIRE_EQUAL(allknn.PendingChanges(), 20);
+
+  // Assemble the effective reference set the same way Rebuild() will:
+  // surviving original points in order, then the inserted points.
+  arma::mat effectiveData(8, 500);
+  size_t current = 0;
+  for (size_t i = 0; i < 500; ++i)
+    if (i % 7 != 0 || i / 7 >= 10)
+      effectiveData.col(current++) = referenceData.col(i);
+  for (size_t i = 0; i < 10; ++i)
+    effectiveData.col(current++) = newPoints.col(i);
+  BOOST_REQUIRE_EQUAL(current, 500);
+
+  AllkNN naive(effectiveData, queryData, true);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  allknn.Search(k, neighbors, distances);
+  naive.Search(k, naiveNeighbors, naiveDistances);
+
+  metric::EuclideanDistance metric;
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      // The distances must match the brute-force search.
+      BOOST_REQUIRE_CLOSE(distances(j, i), naiveDistances(j, i), 1e-10);
+
+      // The indices use the pre-rebuild numbering (original indices, then
+      // 500 + position for buffered insertions), so check that each index
+      // resolves to a point at the reported distance and that no deleted
+      // point is returned.
+      const size_t index = neighbors(j, i);
+      BOOST_REQUIRE_LT(index, 510);
+      if (index < 500)
+        BOOST_REQUIRE(index % 7 != 0 || index / 7 >= 10);
+
+      const double distance = (index < 500) ?
+          metric.Evaluate(queryData.col(i), referenceData.col(index)) :
+          metric.Evaluate(queryData.col(i), newPoints.col(index - 500));
+      BOOST_REQUIRE_CLOSE(distances(j, i), distance, 1e-10);
+    }
+  }
+
+  // Now fold the changes in; the points are renumbered to match
+  // effectiveData, so the results must agree with the naive search exactly.
+  allknn.Rebuild();
+  BOOST_REQUIRE_EQUAL(allknn.PendingChanges(), 0);
+
+  allknn.Search(k, neighbors, distances);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), naiveNeighbors(j, i));
+      BOOST_REQUIRE_CLOSE(distances(j, i), naiveDistances(j, i), 1e-10);
+    }
+  }
+
+  // A small threshold makes the next insertion fold itself in immediately.
+  allknn.RebuildThreshold() = 0.001;
+  allknn.InsertPoint(queryData.col(0));
+  BOOST_REQUIRE_EQUAL(allknn.PendingChanges(), 0);
+}
+
 /*
 BOOST_AUTO_TEST_CASE(SparseAllkNNCoverTreeTest)
 {
@@ -816,4 +1170,307 @@ BOOST_AUTO_TEST_CASE(SparseAllkNNCoverTreeTest)
 }
 */
 
+/**
+ * Test the epsilon-approximate search mode.  Each approximate neighbor
+ * distance must be within a relative factor of (1 + epsilon) of the true
+ * nearest neighbor distance.
+ */
+BOOST_AUTO_TEST_CASE(ApproximateSearchTest)
+{
+  arma::mat dataset;
+  dataset.randu(5, 1000);
+
+  arma::mat exactQuery(dataset);
+  arma::mat approxQuery(dataset);
+
+  AllkNN exact(exactQuery);
+  AllkNN approx(approxQuery, false, false, 0.2);
+
+  arma::Mat<size_t> exactNeighbors;
+  arma::mat exactDistances;
+  exact.Search(5, exactNeighbors, exactDistances);
+
+  arma::Mat<size_t> approxNeighbors;
+  arma::mat approxDistances;
+  approx.Search(5, approxNeighbors, approxDistances);
+
+  for (size_t i = 0; i < exactDistances.n_cols; ++i)
+  {
+    for (size_t j = 0; j < exactDistances.n_rows; ++j)
+    {
+      // The approximate distance may not be more than (1 + epsilon) times the
+      // exact distance (AllkNN uses the squared Euclidean distance, so square
+      // the allowed relative error too).
+      BOOST_REQUIRE_LE(approxDistances(j, i),
+          std::pow(1.2, 2.0) * exactDistances(j, i) + 1e-10);
+    }
+  }
+}
+
+/**
+ * Test that merging per-shard search results (see shard_merge.hpp) gives
+ * exactly the results of a search against the whole reference set.
+ */
+BOOST_AUTO_TEST_CASE(ShardMergeTest)
+{
+  arma::mat references = arma::randu<arma::mat>(5, 500);
+  arma::mat queries = arma::randu<arma::mat>(5, 120);
+
+  // Search the whole reference set.
+  AllkNN allknn(references, queries);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  allknn.Search(9, neighbors, distances);
+
+  // Now search three contiguous shards of different sizes independently.
+  const size_t shardStarts[3] = { 0, 150, 370 };
+  const size_t shardEnds[3] = { 149, 369, 499 };
+  std::vector<arma::Mat<size_t> > shardNeighbors(3);
+  std::vector<arma::mat> shardDistances(3);
+  std::vector<size_t> shardOffsets(3);
+  for (size_t s = 0; s < 3; ++s)
+  {
+    arma::mat shard = references.cols(shardStarts[s], shardEnds[s]);
+    AllkNN shardSearch(shard, queries);
+    shardSearch.Search(9, shardNeighbors[s], shardDistances[s]);
+    shardOffsets[s] = shardStarts[s];
+  }
+
+  // Merge the shard results and make sure they match the whole-set search.
+  arma::Mat<size_t> mergedNeighbors;
+  arma::mat mergedDistances;
+  MergeShardResults<NearestNeighborSort>(shardNeighbors, shardDistances,
+      shardOffsets, 9, mergedNeighbors, mergedDistances);
+
+  BOOST_REQUIRE_EQUAL(mergedNeighbors.n_rows, neighbors.n_rows);
+  BOOST_REQUIRE_EQUAL(mergedNeighbors.n_cols, neighbors.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(mergedNeighbors[i], neighbors[i]);
+    BOOST_REQUIRE_CLOSE(mergedDistances[i], distances[i], 1e-5);
+  }
+}
+
+/**
+ * Test that the quantized copy built by QuantizedKNN reconstructs every
+ * reference value to within half a quantization step.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedKNNReconstructionTest)
+{
+  arma::mat references = arma::randu<arma::mat>(8, 300);
+
+  QuantizedKNN quantized(references);
+
+  BOOST_REQUIRE_EQUAL(quantized.QuantizedSet().n_rows, references.n_rows);
+  BOOST_REQUIRE_EQUAL(quantized.QuantizedSet().n_cols, references.n_cols);
+
+  for (size_t i = 0; i < references.n_cols; ++i)
+  {
+    for (size_t d = 0; d < references.n_rows; ++d)
+    {
+      const double reconstructed = quantized.Offsets()[d] +
+          quantized.Scales()[d] * (double) quantized.QuantizedSet()(d, i);
+      BOOST_REQUIRE_LE(std::abs(reconstructed - references(d, i)),
+          0.5 * quantized.Scales()[d] + 1e-10);
+    }
+  }
+}
+
+/**
+ * Test that quantized search with exact re-ranking (see quantized_knn.hpp)
+ * recovers the exact nearest neighbors.  The quantization error of random
+ * uniform data is far smaller than the distance gaps between neighbors, so
+ * with a reasonable rerank factor the candidate set should never miss a true
+ * neighbor here.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedKNNSearchTest)
+{
+  arma::mat references = arma::randu<arma::mat>(10, 1000);
+  arma::mat queries = arma::randu<arma::mat>(10, 75);
+
+  // Exact search for ground truth; AllkNN reports squared distances when run
+  // this way, so compare against the square roots below.
+  arma::mat exactReferences(references);
+  arma::mat exactQueries(queries);
+  AllkNN exact(exactReferences, exactQueries);
+  arma::Mat<size_t> exactNeighbors;
+  arma::mat exactDistances;
+  exact.Search(5, exactNeighbors, exactDistances);
+
+  QuantizedKNN quantized(references, 10 /* rerank factor */);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  quantized.Search(queries, 5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, exactNeighbors.n_rows);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, exactNeighbors.n_cols);
+  for (size_t i = 0; i < exactNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], exactNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], sqrt(exactDistances[i]), 1e-5);
+  }
+}
+
+/**
+ * Test that automatic mode selection gives exactly the same results as every
+ * manually chosen mode, with and without probe calibration.  Whichever mode
+ * the cost model picks, it runs an exact search.
+ */
+BOOST_AUTO_TEST_CASE(AutoModeSelectionTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 500);
+
+  arma::mat dualData(dataset);
+  AllkNN dual(dualData);
+  arma::Mat<size_t> dualNeighbors;
+  arma::mat dualDistances;
+  dual.Search(5, dualNeighbors, dualDistances);
+
+  // Run the same search with automatic dispatch; results must be identical
+  // no matter which mode the cost model selects.
+  arma::mat autoData(dataset);
+  AllkNN autoSearch(autoData);
+  autoSearch.AutoMode() = true;
+  arma::Mat<size_t> autoNeighbors;
+  arma::mat autoDistances;
+  autoSearch.Search(5, autoNeighbors, autoDistances);
+
+  for (size_t i = 0; i < dualNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(autoNeighbors[i], dualNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(autoDistances[i], dualDistances[i], 1e-10);
+  }
+
+  // Again, with the cost model calibrated by probe queries.
+  arma::mat probeData(dataset);
+  AllkNN probeSearch(probeData);
+  probeSearch.AutoMode() = true;
+  probeSearch.AutoProbes() = true;
+  arma::Mat<size_t> probeNeighbors;
+  arma::mat probeDistances;
+  probeSearch.Search(5, probeNeighbors, probeDistances);
+
+  for (size_t i = 0; i < dualNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(probeNeighbors[i], dualNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(probeDistances[i], dualDistances[i], 1e-10);
+  }
+
+  // Automatic dispatch after naive construction must still work (no tree
+  // exists, so only the brute-force scan is available).
+  arma::mat naiveData(dataset);
+  AllkNN naiveSearch(naiveData, true);
+  naiveSearch.AutoMode() = true;
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naiveSearch.Search(5, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < dualNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(naiveNeighbors[i], dualNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(naiveDistances[i], dualDistances[i], 1e-10);
+  }
+}
+
+/**
+ * Test that the multi-k overload of Search() returns, for every requested k,
+ * exactly what a separate search with that k would have returned.
+ */
+BOOST_AUTO_TEST_CASE(MultiKSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 300);
+
+  std::vector<size_t> ks;
+  ks.push_back(10);
+  ks.push_back(3); // Not sorted, on purpose.
+  ks.push_back(25);
+
+  arma::mat dataCopy = dataset;
+  AllkNN multiSearch(dataCopy);
+
+  std::vector<arma::Mat<size_t> > multiNeighbors;
+  std::vector<arma::mat> multiDistances;
+  multiSearch.Search(ks, multiNeighbors, multiDistances);
+
+  BOOST_REQUIRE_EQUAL(multiNeighbors.size(), ks.size());
+  BOOST_REQUIRE_EQUAL(multiDistances.size(), ks.size());
+
+  for (size_t i = 0; i < ks.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(multiNeighbors[i].n_rows, ks[i]);
+    BOOST_REQUIRE_EQUAL(multiDistances[i].n_rows, ks[i]);
+
+    arma::mat refCopy = dataset;
+    AllkNN refSearch(refCopy);
+
+    arma::Mat<size_t> refNeighbors;
+    arma::mat refDistances;
+    refSearch.Search(ks[i], refNeighbors, refDistances);
+
+    for (size_t j = 0; j < refNeighbors.n_elem; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(multiNeighbors[i][j], refNeighbors[j]);
+      BOOST_REQUIRE_CLOSE(multiDistances[i][j], refDistances[j], 1e-10);
+    }
+  }
+}
+
+/**
+ * Test that warm-starting a search with the results of a previous run gives
+ * exactly the results of a cold search, even after the points have moved.
+ */
+BOOST_AUTO_TEST_CASE(WarmStartSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 400);
+
+  // Run a cold search on the original dataset to obtain the seeds.
+  arma::mat seedCopy = dataset;
+  AllkNN seedSearch(seedCopy);
+
+  arma::Mat<size_t> seeds;
+  arma::mat seedDistances;
+  seedSearch.Search(10, seeds, seedDistances);
+
+  // Perturb the dataset slightly, as if the points had moved between runs.
+  arma::mat perturbed = dataset + 0.01 * arma::randn<arma::mat>(5, 400);
+
+  arma::mat coldCopy = perturbed;
+  AllkNN coldSearch(coldCopy);
+
+  arma::Mat<size_t> coldNeighbors;
+  arma::mat coldDistances;
+  coldSearch.Search(10, coldNeighbors, coldDistances);
+
+  arma::mat warmCopy = perturbed;
+  AllkNN warmSearch(warmCopy);
+
+  arma::Mat<size_t> warmNeighbors;
+  arma::mat warmDistances;
+  warmSearch.Search(10, seeds, warmNeighbors, warmDistances);
+
+  for (size_t i = 0; i < coldNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(warmNeighbors[i], coldNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(warmDistances[i], coldDistances[i], 1e-10);
+  }
+
+  // A seed matrix with fewer rows than k cannot bound the k'th neighbor, so
+  // the search must fall back to infinite initial bounds -- and still return
+  // the cold results.
+  arma::Mat<size_t> fewSeeds = seeds.rows(0, 2);
+
+  arma::mat fewCopy = perturbed;
+  AllkNN fewSearch(fewCopy);
+
+  arma::Mat<size_t> fewNeighbors;
+  arma::mat fewDistances;
+  fewSearch.Search(10, fewSeeds, fewNeighbors, fewDistances);
+
+  for (size_t i = 0; i < coldNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(fewNeighbors[i], coldNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(fewDistances[i], coldDistances[i], 1e-10);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
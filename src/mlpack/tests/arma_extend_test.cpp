@@ -260,4 +260,80 @@ BOOST_AUTO_TEST_CASE(SpRowColIteratorTest)
 
 #endif
 
+/**
+ * Test that the blocked ccov() implementation matches the naive centered
+ * computation.  The number of columns is chosen so that the last block of the
+ * accumulation is a partial one.
+ */
+BOOST_AUTO_TEST_CASE(CcovTest)
+{
+  mat X = randu<mat>(6, 1000);
+
+  // Naive centered computation.
+  const mat centered = X - repmat(mean(X, 1), 1, X.n_cols);
+  const mat naive = centered * trans(centered) / (X.n_cols - 1);
+
+  const mat blocked = ccov(X);
+
+  BOOST_REQUIRE_EQUAL(blocked.n_rows, 6);
+  BOOST_REQUIRE_EQUAL(blocked.n_cols, 6);
+  for (size_t i = 0; i < naive.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(blocked[i], naive[i], 1e-8);
+
+  // The biased estimator should divide by N instead.
+  const mat biased = ccov(X, 1);
+  for (size_t i = 0; i < naive.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(biased[i], naive[i] * (X.n_cols - 1) / X.n_cols, 1e-8);
+}
+
+/**
+ * Test that ScratchMat hands out working matrices and recycles their buffers.
+ */
+BOOST_AUTO_TEST_CASE(ScratchMatTest)
+{
+  const double* firstBuffer = NULL;
+  {
+    ScratchMat<double> scratch(10, 10);
+    BOOST_REQUIRE_EQUAL(scratch.M.n_rows, 10);
+    BOOST_REQUIRE_EQUAL(scratch.M.n_cols, 10);
+
+    // The wrapped matrix must behave like any other matrix.
+    scratch.M.fill(3.0);
+    BOOST_REQUIRE_CLOSE(accu(scratch.M), 300.0, 1e-10);
+
+    firstBuffer = scratch.M.memptr();
+  }
+
+  // A second scratch matrix that fits must reuse the released buffer.
+  {
+    ScratchMat<double> scratch(5, 8);
+    BOOST_REQUIRE_EQUAL(scratch.M.memptr(), firstBuffer);
+  }
+
+  // Two live scratch matrices must not share memory.
+  ScratchMat<double> a(4, 4);
+  ScratchMat<double> b(4, 4);
+  BOOST_REQUIRE(a.M.memptr() != b.M.memptr());
+}
+
+/**
+ * Test the two-matrix cross-covariance against the naive centered computation.
+ */
+BOOST_AUTO_TEST_CASE(CrossCcovTest)
+{
+  mat X = randu<mat>(4, 700);
+  mat Y = randu<mat>(5, 700);
+
+  const mat xCentered = X - repmat(mean(X, 1), 1, X.n_cols);
+  const mat yCentered = Y - repmat(mean(Y, 1), 1, Y.n_cols);
+  const mat naive = xCentered * trans(yCentered) / (X.n_cols - 1);
+
+  const mat blocked = cov(X, Y);
+
+  BOOST_REQUIRE_EQUAL(blocked.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(blocked.n_cols, 5);
+  for (size_t i = 0; i < naive.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(blocked[i], naive[i], 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -175,4 +175,54 @@ BOOST_AUTO_TEST_CASE(RecommendationAccuracyTest)
   BOOST_REQUIRE_LT(failures, 100);
 }
 
+/**
+ * Make sure AddRating() and AddUser() grow the model correctly and that
+ * recommendations can still be generated, including for the new user.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInTest)
+{
+  // Load GroupLens data.
+  arma::mat dataset;
+  data::Load("GroupLens100k.csv", dataset);
+
+  CF<> c(dataset);
+
+  const size_t items = c.CleanedData().n_rows;
+  const size_t users = c.CleanedData().n_cols;
+
+  // Fold in a rating for an existing user and item.
+  c.AddRating(0, 0, 4.0);
+  BOOST_REQUIRE_CLOSE((double) c.CleanedData()(0, 0), 4.0, 1e-10);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_rows, items);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, users);
+
+  // Fold in a new user with a handful of ratings.
+  arma::mat ratings(2, 4);
+  ratings << 0 << 10 << 25 << 50 << arma::endr
+          << 5 << 4 << 3 << 5 << arma::endr;
+  const size_t newUser = c.AddUser(ratings);
+
+  BOOST_REQUIRE_EQUAL(newUser, users);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, users + 1);
+  BOOST_REQUIRE_EQUAL(c.W().n_rows, items);
+  BOOST_REQUIRE_EQUAL(c.H().n_cols, users + 1);
+  BOOST_REQUIRE_CLOSE((double) c.CleanedData()(10, newUser), 4.0, 1e-10);
+
+  // The new user should get recommendations like anyone else, and should not
+  // be recommended items they have already rated.
+  arma::Col<size_t> query(1);
+  query(0) = newUser;
+  arma::Mat<size_t> recommendations;
+  const size_t numRecs = 5;
+  c.GetRecommendations(numRecs, recommendations, query);
+
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, 1);
+  for (size_t j = 0; j < numRecs; ++j)
+  {
+    const size_t item = recommendations(j, 0);
+    BOOST_REQUIRE_EQUAL((double) c.CleanedData()(item, newUser), 0.0);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -90,6 +90,51 @@ BOOST_AUTO_TEST_CASE(TestPrefixedOutStreamBasic)
       BASH_GREEN "[INFO ] " BASH_CLEAR "");
 }
 
+/**
+ * Output written from inside a parallel region must come out in whole lines:
+ * every line must start with the prefix and match exactly one of the lines
+ * that was written.  (Without OpenMP this degenerates to a serial test.)
+ */
+BOOST_AUTO_TEST_CASE(TestPrefixedOutStreamParallelLines)
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR);
+
+#ifdef _OPENMP
+  #pragma omp parallel for
+#endif
+  for (long i = 0; i < 50; ++i)
+    pss << "line " << i << std::endl;
+
+  const std::string prefix = BASH_GREEN "[INFO ] " BASH_CLEAR;
+  const std::string output = ss.str();
+
+  arma::Col<size_t> counts(50);
+  counts.zeros();
+
+  size_t nl;
+  size_t pos = 0;
+  while ((nl = output.find('\n', pos)) != std::string::npos)
+  {
+    const std::string fullLine = output.substr(pos, nl - pos);
+    BOOST_REQUIRE_EQUAL(fullLine.substr(0, prefix.length()), prefix);
+
+    std::istringstream lineStream(fullLine.substr(prefix.length()));
+    std::string word;
+    size_t value;
+    lineStream >> word >> value;
+    BOOST_REQUIRE_EQUAL(word, "line");
+    BOOST_REQUIRE_LT(value, 50);
+    counts[value]++;
+
+    pos = nl + 1;
+  }
+
+  // Every line must have been written exactly once.
+  for (size_t i = 0; i < 50; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
 /**
  * Tests that the various PARAM_* macros work properly.
  */
@@ -269,4 +314,95 @@ BOOST_AUTO_TEST_CASE(MultiRunTimerTest)
   BOOST_REQUIRE_GE(Timer::Get("test_timer").tv_usec, 40000);
 }
 
+/**
+ * The profiler should build a tree of regions with correct call counts and
+ * parent/child attribution.
+ */
+BOOST_AUTO_TEST_CASE(ProfilerTest)
+{
+  for (size_t i = 0; i < 3; ++i)
+  {
+    MLPACK_PROFILE("outer_region");
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      MLPACK_PROFILE("inner_region");
+    }
+  }
+
+  // Find the outer region in the profile tree.
+  const util::ProfileNode& root = util::Profiler::Root();
+  const util::ProfileNode* outer = NULL;
+  for (size_t i = 0; i < root.children.size(); ++i)
+    if (std::string(root.children[i]->name) == "outer_region")
+      outer = root.children[i];
+
+  BOOST_REQUIRE(outer != NULL);
+  BOOST_REQUIRE_EQUAL(outer->calls, 3);
+  BOOST_REQUIRE_GE(outer->totalTime, outer->minTime * 3);
+  BOOST_REQUIRE_GE(outer->maxTime, outer->minTime);
+
+  // The inner region must be attributed to the outer region, not the root.
+  BOOST_REQUIRE_EQUAL(outer->children.size(), 1);
+  const util::ProfileNode* inner = outer->children[0];
+  BOOST_REQUIRE_EQUAL(std::string(inner->name), "inner_region");
+  BOOST_REQUIRE_EQUAL(inner->calls, 15);
+  BOOST_REQUIRE_LE(inner->totalTime, outer->totalTime);
+}
+
+/**
+ * Allocation counters should observe heap traffic inside their region (on
+ * platforms with malloc hooks), be additive across runs, and nest.
+ */
+BOOST_AUTO_TEST_CASE(AllocationCounterTest)
+{
+  AllocationCounter::Start("alloc_test");
+  {
+    std::vector<double>* v = new std::vector<double>(4096);
+    delete v;
+  }
+  AllocationCounter::Stop("alloc_test");
+
+  const AllocationInfo first = AllocationCounter::Get("alloc_test");
+
+// Only glibc older than 2.32 still has malloc hooks.
+#if defined(__GLIBC__) && (__GLIBC__ == 2) && (__GLIBC_MINOR__ < 32)
+  BOOST_REQUIRE_GE(first.count, 2); // The vector object and its storage.
+  BOOST_REQUIRE_GE(first.bytes, 4096 * sizeof(double));
+#else
+  // Without malloc hooks the counters exist but report zero.
+  BOOST_REQUIRE_EQUAL(first.count, 0);
+  BOOST_REQUIRE_EQUAL(first.bytes, 0);
+#endif
+
+  // Nothing may be counted while no region is active.
+  std::vector<double>* untracked = new std::vector<double>(4096);
+  delete untracked;
+  const AllocationInfo between = AllocationCounter::Get("alloc_test");
+  BOOST_REQUIRE_EQUAL(between.count, first.count);
+  BOOST_REQUIRE_EQUAL(between.bytes, first.bytes);
+
+  // A second run is additive, and a nested region observes the same
+  // allocations as its enclosing region.
+  AllocationCounter::Start("alloc_test");
+  AllocationCounter::Start("alloc_test_inner");
+  {
+    std::vector<double>* v = new std::vector<double>(4096);
+    delete v;
+  }
+  AllocationCounter::Stop("alloc_test_inner");
+  AllocationCounter::Stop("alloc_test");
+
+  const AllocationInfo second = AllocationCounter::Get("alloc_test");
+  const AllocationInfo inner = AllocationCounter::Get("alloc_test_inner");
+
+#if defined(__GLIBC__) && (__GLIBC__ == 2) && (__GLIBC_MINOR__ < 32)
+  BOOST_REQUIRE_GE(second.count, first.count + 2);
+  BOOST_REQUIRE_GE(second.bytes, first.bytes + 4096 * sizeof(double));
+  BOOST_REQUIRE_GE(inner.count, 2);
+#endif
+  BOOST_REQUIRE_LE(inner.count, second.count - first.count);
+  BOOST_REQUIRE_LE(inner.bytes, second.bytes - first.bytes);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
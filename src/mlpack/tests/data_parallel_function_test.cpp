@@ -0,0 +1,91 @@
+/**
+ * @file data_parallel_function_test.cpp
+ * @author Ryan Curtin
+ *
+ * Test file for the data-parallel decomposable function adapter.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/data_parallel/data_parallel_function.hpp>
+#include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+using namespace std;
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(DataParallelFunctionTest);
+
+/**
+ * The adapted Evaluate() and Gradient() must match the serial sums over the
+ * individual functions.
+ */
+BOOST_AUTO_TEST_CASE(DataParallelSumsTest)
+{
+  // Random logistic regression problem.
+  arma::mat data = arma::randu<arma::mat>(4, 500);
+  arma::vec responses(500);
+  for (size_t i = 0; i < 500; ++i)
+    responses[i] = (i % 2);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.01);
+  DataParallelFunction<LogisticRegressionFunction<> > parallelLrf(lrf);
+
+  arma::mat coordinates = arma::randu<arma::mat>(5, 1);
+
+  // Serial sums over the individual functions.
+  double objective = 0;
+  arma::mat gradient(coordinates.n_rows, coordinates.n_cols);
+  gradient.zeros();
+  arma::mat funcGradient;
+  for (size_t i = 0; i < 500; ++i)
+  {
+    objective += lrf.Evaluate(coordinates, i);
+    lrf.Gradient(coordinates, i, funcGradient);
+    gradient += funcGradient;
+  }
+
+  BOOST_REQUIRE_CLOSE(parallelLrf.Evaluate(coordinates), objective, 1e-8);
+
+  arma::mat parallelGradient;
+  parallelLrf.Gradient(coordinates, parallelGradient);
+  BOOST_REQUIRE_EQUAL(parallelGradient.n_elem, gradient.n_elem);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelGradient[i], gradient[i], 1e-8);
+}
+
+/**
+ * Training through the adapter must give a model as good as training the
+ * wrapped function directly.
+ */
+BOOST_AUTO_TEST_CASE(DataParallelLBFGSTest)
+{
+  // A separable two-Gaussian problem.
+  arma::mat data = arma::randu<arma::mat>(3, 400);
+  arma::vec responses(400);
+  for (size_t i = 200; i < 400; ++i)
+  {
+    data.col(i) += 3.0;
+    responses[i] = 1;
+  }
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.01);
+  L_BFGS<LogisticRegressionFunction<> > direct(lrf);
+  arma::mat directParameters = lrf.GetInitialPoint();
+  const double directObjective = direct.Optimize(directParameters);
+
+  DataParallelFunction<LogisticRegressionFunction<> > parallelLrf(lrf);
+  L_BFGS<DataParallelFunction<LogisticRegressionFunction<> > >
+      parallel(parallelLrf);
+  arma::mat parallelParameters = parallelLrf.GetInitialPoint();
+  const double parallelObjective = parallel.Optimize(parallelParameters);
+
+  // Both runs minimize the same convex objective, so the optima must agree.
+  BOOST_REQUIRE_CLOSE(parallelObjective, directObjective, 1e-3);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
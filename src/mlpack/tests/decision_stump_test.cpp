@@ -175,6 +175,55 @@ BOOST_AUTO_TEST_CASE(PerfectMultiClassSplit)
   BOOST_CHECK_EQUAL(predictedLabels(0, 3), 3);
 }
 
+/**
+ * The same perfectly split dataset, but trained with histogram-based split
+ * finding; the bins line up with the classes, so the stump should classify
+ * perfectly.  The histogram stump is then retrained with uniform weights via
+ * the boosting constructor (which reuses the bin assignments), and should
+ * give the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(PerfectMultiClassSplitHistogram)
+{
+  const size_t numClasses = 4;
+  const size_t inpBucketSize = 3;
+  const size_t numBins = 4;
+
+  mat trainingData;
+  trainingData << -8 << -7 << -6 << -5 << -4 << -3 << -2 << -1
+               << 0  << 1  << 2  << 3  << 4  << 5  << 6  << 7;
+
+  // No need to normalize labels here.
+  Mat<size_t> labelsIn;
+  labelsIn << 0 << 0 << 0 << 0 << 1 << 1 << 1 << 1
+           << 2 << 2 << 2 << 2 << 3 << 3 << 3 << 3;
+
+  mat testingData;
+  testingData << -6.1 << -2.1 << 1.1 << 5.1;
+
+  DecisionStump<> ds(trainingData, labelsIn.row(0), numClasses, inpBucketSize,
+      numBins);
+
+  Row<size_t> predictedLabels(testingData.n_cols);
+  ds.Classify(testingData, predictedLabels);
+
+  BOOST_CHECK_EQUAL(predictedLabels(0, 0), 0);
+  BOOST_CHECK_EQUAL(predictedLabels(0, 1), 1);
+  BOOST_CHECK_EQUAL(predictedLabels(0, 2), 2);
+  BOOST_CHECK_EQUAL(predictedLabels(0, 3), 3);
+
+  // Retrain with uniform weights, as boosting would.
+  rowvec weights(trainingData.n_cols);
+  weights.fill(1.0 / trainingData.n_cols);
+
+  DecisionStump<> wds(ds, trainingData, weights, labelsIn.row(0));
+  wds.Classify(testingData, predictedLabels);
+
+  BOOST_CHECK_EQUAL(predictedLabels(0, 0), 0);
+  BOOST_CHECK_EQUAL(predictedLabels(0, 1), 1);
+  BOOST_CHECK_EQUAL(predictedLabels(0, 2), 2);
+  BOOST_CHECK_EQUAL(predictedLabels(0, 3), 3);
+}
+
 /**
  * This test is for the case when reasonably overlapping, multiple classes are
  * provided in the input label set. It tests whether classification takes place
@@ -277,6 +277,39 @@ BOOST_AUTO_TEST_CASE(TestComputeValue)
   BOOST_REQUIRE_CLOSE(0.0, testDTree.ComputeValue(q4), 1e-10);
 }
 
+BOOST_AUTO_TEST_CASE(TestComputeValueBatch)
+{
+  arma::mat testData(3, 5);
+
+  testData << 4 << 5 << 7 << 3 << 5 << arma::endr
+           << 5 << 0 << 1 << 7 << 1 << arma::endr
+           << 5 << 6 << 7 << 1 << 8 << arma::endr;
+
+  // The same queries as in TestComputeValue, as columns of one matrix.
+  arma::mat queries(3, 4);
+
+  queries << 4 << 5 << 5 << 2 << arma::endr
+          << 2 << 0.25 << 3 << 3 << arma::endr
+          << 2 << 6 << 7 << 3 << arma::endr;
+
+  arma::Col<size_t> oTest(5);
+  oTest << 0 << 1 << 2 << 3 << 4;
+
+  DTree testDTree(testData);
+  testDTree.Grow(testData, oTest, false, 2, 1);
+
+  // The batched estimates must match the per-point estimates.
+  arma::vec densities;
+  testDTree.ComputeValue(queries, densities);
+
+  BOOST_REQUIRE_EQUAL(densities.n_elem, queries.n_cols);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    arma::vec query = queries.unsafe_col(i);
+    BOOST_REQUIRE_CLOSE(densities[i], testDTree.ComputeValue(query), 1e-10);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestVariableImportance)
 {
   arma::mat testData(3, 5);
@@ -357,4 +390,67 @@ BOOST_AUTO_TEST_CASE(TestPrintLeafMembership)
 }
 */
 
+BOOST_AUTO_TEST_CASE(TestSaveLoad)
+{
+  // Build and tag a tree on random data, save it, load it into a fresh tree,
+  // and check that the loaded tree gives the same estimates and bucket tags.
+  arma::mat testData = arma::randu<arma::mat>(3, 300);
+  arma::mat queries(testData); // Grow() will reorder testData.
+
+  arma::Col<size_t> oTest(testData.n_cols);
+  for (size_t i = 0; i < oTest.n_elem; ++i)
+    oTest[i] = i;
+
+  DTree tree(testData);
+  tree.Grow(testData, oTest, false, 10, 5);
+  tree.TagTree();
+
+  tree.Save("det_tree_test.xml");
+
+  DTree tree2;
+  tree2.Load("det_tree_test.xml");
+
+  remove("det_tree_test.xml");
+
+  BOOST_REQUIRE_EQUAL(tree.SubtreeLeaves(), tree2.SubtreeLeaves());
+
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.unsafe_col(i);
+
+    // The values pass through a text representation, so allow a small
+    // tolerance.
+    BOOST_REQUIRE_CLOSE(tree.ComputeValue(query), tree2.ComputeValue(query),
+        1e-8);
+    BOOST_REQUIRE_EQUAL(tree.FindBucket(query), tree2.FindBucket(query));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestTagTable)
+{
+  // The compact descent table must return the same bucket tags as the
+  // pointer-linked tree it was built from.
+  arma::mat testData = arma::randu<arma::mat>(3, 300);
+  arma::mat queries(testData); // Grow() will reorder testData.
+
+  arma::Col<size_t> oTest(testData.n_cols);
+  for (size_t i = 0; i < oTest.n_elem; ++i)
+    oTest[i] = i;
+
+  DTree tree(testData);
+  tree.Grow(testData, oTest, false, 10, 5);
+  tree.TagTree();
+
+  DTreeTagTable table(tree);
+
+  // A full binary tree with L leaves has (2L - 1) nodes.
+  BOOST_REQUIRE_EQUAL(table.NumNodes(), 2 * tree.SubtreeLeaves() - 1);
+
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.unsafe_col(i);
+    BOOST_REQUIRE_EQUAL(table.FindBucket(query), tree.FindBucket(query));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -5,6 +5,7 @@
  * Test for the mlpack::distribution::DiscreteDistribution class.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/dists/regression_distribution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
@@ -70,6 +71,50 @@ BOOST_AUTO_TEST_CASE(DiscreteDistributionRandomTest)
   BOOST_REQUIRE_CLOSE(actualProb(2), 0.1, 8.0);
 }
 
+/**
+ * Make sure batch sampling gives the correct observation frequencies, and
+ * that the alias table is rebuilt when the probabilities change.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteDistributionBatchRandomTest)
+{
+  DiscreteDistribution d(3);
+
+  d.Probabilities() = "0.3 0.6 0.1";
+
+  arma::mat observations;
+  d.Random(50000, observations);
+
+  BOOST_REQUIRE_EQUAL(observations.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(observations.n_cols, 50000);
+
+  arma::vec actualProb(3);
+  actualProb.zeros();
+  for (size_t i = 0; i < observations.n_cols; i++)
+    actualProb((size_t) (observations(0, i) + 0.5))++;
+
+  // Normalize.
+  actualProb /= accu(actualProb);
+
+  // 8% tolerance, because this can be a noisy process.
+  BOOST_REQUIRE_CLOSE(actualProb(0), 0.3, 8.0);
+  BOOST_REQUIRE_CLOSE(actualProb(1), 0.6, 8.0);
+  BOOST_REQUIRE_CLOSE(actualProb(2), 0.1, 8.0);
+
+  // Changing the probabilities through the accessor must invalidate the
+  // cached alias table.
+  d.Probabilities() = "0.1 0.1 0.8";
+  d.Random(50000, observations);
+
+  actualProb.zeros();
+  for (size_t i = 0; i < observations.n_cols; i++)
+    actualProb((size_t) (observations(0, i) + 0.5))++;
+  actualProb /= accu(actualProb);
+
+  BOOST_REQUIRE_CLOSE(actualProb(0), 0.1, 8.0);
+  BOOST_REQUIRE_CLOSE(actualProb(1), 0.1, 8.0);
+  BOOST_REQUIRE_CLOSE(actualProb(2), 0.8, 8.0);
+}
+
 /**
  * Make sure we can estimate from observations correctly.
  */
@@ -158,19 +203,19 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionProbabilityTest)
 {
   arma::vec mean("5 6 3 3 2");
   arma::mat cov("6 1 1 0 2;"
-                "0 7 1 0 1;"
+                "1 7 1 0 1;"
                 "1 1 4 1 1;"
-                "1 0 1 7 0;"
-                "2 0 1 1 6");
+                "0 0 1 7 0;"
+                "2 1 1 0 6");
 
   GaussianDistribution d(mean, cov);
 
-  BOOST_REQUIRE_CLOSE(d.Probability("0 1 2 3 4"), 1.02531207499358e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(d.Probability("3 2 3 7 8"), 1.82353695848039e-7, 1e-5);
-  BOOST_REQUIRE_CLOSE(d.Probability("2 2 0 8 1"), 1.29759261892949e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(d.Probability("2 1 5 0 1"), 1.33218060268258e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(d.Probability("3 0 5 1 0"), 1.12120427975708e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(d.Probability("4 0 6 1 0"), 4.57951032485297e-7, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("0 1 2 3 4"), 1.00045989905946e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("3 2 3 7 8"), 1.04482372777734e-7, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("2 2 0 8 1"), 1.42564801825359e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("2 1 5 0 1"), 1.44721565867444e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("3 0 5 1 0"), 1.30576440750675e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("4 0 6 1 0"), 5.22599644545646e-7, 1e-5);
 }
 
 /**
@@ -230,33 +275,33 @@ BOOST_AUTO_TEST_CASE(GaussianMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(g.Probability(-x), 0.0795774715459477, 1e-5);
 
   g.Mean() = "1 1";
-  g.Covariance() = "2 1.5; 1 4";
+  g.Covariance() = "2 1.5; 1.5 4";
 
-  BOOST_REQUIRE_CLOSE(g.Probability(x), 0.0624257046546403, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(x), 0.0663721994061873, 1e-5);
   g.Mean() *= -1;
-  BOOST_REQUIRE_CLOSE(g.Probability(-x), 0.0624257046546403, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(-x), 0.0663721994061873, 1e-5);
 
   g.Mean() = "1 1";
   x = "-1 4";
 
-  BOOST_REQUIRE_CLOSE(g.Probability(x), 0.00144014867515135, 1e-5);
-  BOOST_REQUIRE_CLOSE(g.Probability(-x), 0.00133352162064845, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(x), 0.000721472623563794, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(-x), 0.000858517854286744, 1e-5);
 
   // Higher-dimensional case.
   x = "0 1 2 3 4";
   g.Mean() = "5 6 3 3 2";
   g.Covariance() = "6 1 1 0 2;"
-                   "0 7 1 0 1;"
+                   "1 7 1 0 1;"
                    "1 1 4 1 1;"
-                   "1 0 1 7 0;"
-                   "2 0 1 1 6";
+                   "0 0 1 7 0;"
+                   "2 1 1 0 6";
 
-  BOOST_REQUIRE_CLOSE(g.Probability(x), 1.02531207499358e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(g.Probability(-x), 1.06784794079363e-8, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(x), 1.00045989905946e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(-x), 1.13331787011632e-8, 1e-5);
 
   g.Mean() *= -1;
-  BOOST_REQUIRE_CLOSE(g.Probability(-x), 1.02531207499358e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(g.Probability(x), 1.06784794079363e-8, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(-x), 1.00045989905946e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(g.Probability(x), 1.13331787011632e-8, 1e-5);
 
 }
 
@@ -268,7 +313,7 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
 {
   // Same case as before.
   arma::vec mean = "5 6 3 3 2";
-  arma::mat cov = "6 1 1 0 2; 0 7 1 0 1; 1 1 4 1 1; 1 0 1 7 0; 2 0 1 1 6";
+  arma::mat cov = "6 1 1 0 2; 1 7 1 0 1; 1 1 4 1 1; 0 0 1 7 0; 2 1 1 0 6";
 
   arma::mat points = "0 3 2 2 3 4;"
                      "1 2 2 1 0 0;"
@@ -282,12 +327,49 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
 
   BOOST_REQUIRE_EQUAL(phis.n_elem, 6);
 
-  BOOST_REQUIRE_CLOSE(phis(0), 1.02531207499358e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(phis(1), 1.82353695848039e-7, 1e-5);
-  BOOST_REQUIRE_CLOSE(phis(2), 1.29759261892949e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(phis(3), 1.33218060268258e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(phis(4), 1.12120427975708e-6, 1e-5);
-  BOOST_REQUIRE_CLOSE(phis(5), 4.57951032485297e-7, 1e-5);
+  BOOST_REQUIRE_CLOSE(phis(0), 1.00045989905946e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(phis(1), 1.04482372777734e-7, 1e-5);
+  BOOST_REQUIRE_CLOSE(phis(2), 1.42564801825359e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(phis(3), 1.44721565867444e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(phis(4), 1.30576440750675e-6, 1e-5);
+  BOOST_REQUIRE_CLOSE(phis(5), 5.22599644545646e-7, 1e-5);
+}
+
+/**
+ * Test that LogProbability() agrees with Probability(), both for a single
+ * observation and for a batch of observations, and that modifying the
+ * covariance through Covariance() refreshes the cached Cholesky
+ * factorization.
+ */
+BOOST_AUTO_TEST_CASE(GaussianDistributionLogProbabilityTest)
+{
+  arma::vec mean = "5 6 3 3 2";
+  arma::mat cov = "6 1 1 0 2; 1 7 1 0 1; 1 1 4 1 1; 0 0 1 7 0; 2 1 1 0 6";
+
+  GaussianDistribution g(mean, cov);
+
+  arma::mat points = "0 3;"
+                     "1 2;"
+                     "2 3;"
+                     "3 7;"
+                     "4 8;";
+
+  arma::vec logPhis;
+  g.LogProbability(points, logPhis);
+
+  BOOST_REQUIRE_EQUAL(logPhis.n_elem, 2);
+  BOOST_REQUIRE_CLOSE(logPhis(0), std::log(1.00045989905946e-6), 1e-5);
+  BOOST_REQUIRE_CLOSE(logPhis(1), std::log(1.04482372777734e-7), 1e-5);
+
+  BOOST_REQUIRE_CLOSE(g.LogProbability((arma::vec) points.col(0)),
+      std::log(1.00045989905946e-6), 1e-5);
+
+  // Modifying the covariance through the non-const accessor must invalidate
+  // the cached factorization; compare against a freshly built distribution.
+  g.Covariance() = 2.0 * cov;
+  GaussianDistribution g2(mean, 2.0 * cov);
+  BOOST_REQUIRE_CLOSE(g.LogProbability((arma::vec) points.col(0)),
+      g2.LogProbability((arma::vec) points.col(0)), 1e-10);
 }
 
 /**
@@ -356,4 +438,118 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionEstimateTest)
       BOOST_REQUIRE_SMALL(d.Covariance()(i, j) - actualCov(i, j), 1e-5);
 }
 
+/**
+ * Make sure the diagonal Gaussian distribution gives the same probabilities
+ * as a full-covariance Gaussian with a diagonal covariance matrix.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionProbabilityTest)
+{
+  arma::vec mean("2.5 1.25 -0.5");
+  arma::vec variances("1.2 3.1 0.8");
+
+  DiagonalGaussianDistribution d(mean, variances);
+  GaussianDistribution g(mean, arma::diagmat(variances));
+
+  // Check a handful of random observations, one at a time.
+  arma::mat points(3, 25);
+  points.randn();
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d.Probability(points.col(i)),
+        g.Probability(points.col(i)), 1e-8);
+    BOOST_REQUIRE_CLOSE(d.LogProbability(points.col(i)),
+        g.LogProbability(points.col(i)), 1e-8);
+  }
+
+  // Now check the batch versions against the single-observation versions.
+  arma::vec probabilities;
+  arma::vec logProbabilities;
+  d.Probability(points, probabilities);
+  d.LogProbability(points, logProbabilities);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(probabilities[i], d.Probability(points.col(i)), 1e-8);
+    BOOST_REQUIRE_CLOSE(logProbabilities[i],
+        d.LogProbability(points.col(i)), 1e-8);
+  }
+
+  // Modifying the covariance through the accessor must invalidate the cached
+  // inverse and log-determinant.
+  d.Covariance() = 2.0 * variances;
+  DiagonalGaussianDistribution d2(mean, 2.0 * variances);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(d.LogProbability(points.col(i)),
+        d2.LogProbability(points.col(i)), 1e-8);
+}
+
+/**
+ * Make sure that we can properly estimate a diagonal Gaussian from given
+ * observations, with and without per-observation probabilities.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionEstimateTest)
+{
+  arma::vec mean("1.0 3.0 0.0 2.5");
+  arma::vec variances("3.0 2.4 6.3 9.1");
+
+  // Now generate the observations.
+  arma::mat observations(4, 10000);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    observations.col(i) = arma::sqrt(variances) %
+        arma::randn<arma::vec>(4) + mean;
+
+  // Find actual mean and covariance of data.
+  arma::vec actualMean = arma::mean(observations, 1);
+  arma::mat actualCov = ccov(observations);
+
+  DiagonalGaussianDistribution d;
+  d.Estimate(observations);
+
+  // Check that everything is estimated right.
+  for (size_t i = 0; i < 4; i++)
+  {
+    BOOST_REQUIRE_SMALL(d.Mean()[i] - actualMean[i], 1e-5);
+    BOOST_REQUIRE_SMALL(d.Covariance()[i] - actualCov(i, i), 1e-5);
+  }
+
+  // The weighted estimate must agree with the diagonal of the weighted
+  // full-covariance estimate, since the same formula is used per dimension.
+  arma::vec probabilities(observations.n_cols);
+  probabilities.randu();
+
+  GaussianDistribution g;
+  d.Estimate(observations, probabilities);
+  g.Estimate(observations, probabilities);
+
+  for (size_t i = 0; i < 4; i++)
+  {
+    BOOST_REQUIRE_SMALL(d.Mean()[i] - g.Mean()[i], 1e-10);
+    BOOST_REQUIRE_SMALL(d.Covariance()[i] - g.Covariance()(i, i), 1e-10);
+  }
+}
+
+/**
+ * Make sure the batched RegressionDistribution::Probability() overload agrees
+ * with the single-observation overload.
+ */
+BOOST_AUTO_TEST_CASE(RegressionDistributionBatchProbabilityTest)
+{
+  // Generate a linear relationship with some noise; the first row of the
+  // observations is the response.
+  arma::mat observations(4, 100);
+  observations.randu();
+  observations.row(0) = 2.0 * observations.row(1) - observations.row(2) +
+      0.5 * observations.row(3) + 0.05 * arma::randn<arma::rowvec>(100);
+
+  RegressionDistribution d;
+  d.Estimate(observations);
+
+  arma::vec probs;
+  d.Probability(observations, probs);
+
+  BOOST_REQUIRE_EQUAL(probs.n_elem, observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(probs[i],
+        d.Probability(observations.unsafe_col(i)), 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
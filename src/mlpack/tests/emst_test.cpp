@@ -277,4 +277,40 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
 
 }
 
+/**
+ * Make sure the approximate mode still produces a spanning tree, and that its
+ * total length is within the (1 + epsilon) guarantee of the exact MST.
+ */
+BOOST_AUTO_TEST_CASE(ApproximateModeTest)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  arma::mat exactData = inputData;
+  arma::mat approxData = inputData;
+
+  const double epsilon = 0.1;
+
+  DualTreeBoruvka<> exact(exactData);
+  DualTreeBoruvka<> approx(approxData, false, epsilon);
+
+  arma::mat exactResults;
+  arma::mat approxResults;
+
+  exact.ComputeMST(exactResults);
+  approx.ComputeMST(approxResults);
+
+  // The approximate result must still be a spanning tree.
+  BOOST_REQUIRE_EQUAL(approxResults.n_cols, inputData.n_cols - 1);
+
+  // Any spanning tree is at least as long as the MST, and the approximation
+  // guarantee bounds it from above.
+  const double exactLength = arma::accu(exactResults.row(2));
+  const double approxLength = arma::accu(approxResults.row(2));
+
+  BOOST_REQUIRE_GE(approxLength, exactLength * (1.0 - 1e-10));
+  BOOST_REQUIRE_LE(approxLength, exactLength * (1.0 + epsilon) + 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
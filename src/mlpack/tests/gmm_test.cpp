@@ -73,6 +73,71 @@ BOOST_AUTO_TEST_CASE(GMMProbabilityComponentTest)
   BOOST_REQUIRE_CLOSE(gmm.Probability("1.4 0", 1), 0.0067568972024, 1e-5);
 }
 
+/**
+ * Test that the batched GMM::Probability() overloads agree with the
+ * single-observation versions.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchedProbabilityTest)
+{
+  // Create a GMM (same as the last test).
+  GMM<> gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Weights() = "0.3 0.7";
+
+  arma::mat observations = arma::randu<arma::mat>(2, 500) * 4.0;
+
+  arma::vec probs;
+  gmm.Probability(observations, probs);
+
+  BOOST_REQUIRE_EQUAL(probs.n_elem, 500);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(probs[i], gmm.Probability(observations.col(i)), 1e-8);
+
+  // The per-component overload must agree too.
+  for (size_t j = 0; j < 2; ++j)
+  {
+    gmm.Probability(observations, j, probs);
+    for (size_t i = 0; i < observations.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(probs[i],
+          gmm.Probability(observations.col(i), j), 1e-8);
+  }
+}
+
+/**
+ * Test that GMM::Responsibilities() produces normalized posterior component
+ * probabilities.
+ */
+BOOST_AUTO_TEST_CASE(GMMResponsibilitiesTest)
+{
+  GMM<> gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Weights() = "0.3 0.7";
+
+  arma::mat observations = arma::randu<arma::mat>(2, 300) * 4.0;
+
+  arma::mat responsibilities;
+  gmm.Responsibilities(observations, responsibilities);
+
+  BOOST_REQUIRE_EQUAL(responsibilities.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(responsibilities.n_cols, 300);
+
+  arma::vec totalProbs;
+  gmm.Probability(observations, totalProbs);
+
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    // Each column must sum to one.
+    BOOST_REQUIRE_CLOSE(accu(responsibilities.col(i)), 1.0, 1e-8);
+
+    // Each entry must be the weighted component density over the total.
+    for (size_t j = 0; j < 2; ++j)
+      BOOST_REQUIRE_CLOSE(responsibilities(j, i),
+          gmm.Probability(observations.col(i), j) / totalProbs[i], 1e-8);
+  }
+}
+
 /**
  * Test training a model on only one Gaussian (randomly generated) in two
  * dimensions.  We will vary the dataset size from small to large.  The EM
@@ -433,6 +498,33 @@ BOOST_AUTO_TEST_CASE(GMMRandomTest)
       gmm2.Component(sortedIndices[1]).Covariance()(1, 1), 13.0);
 }
 
+/**
+ * Test that batched sampling draws from the same distribution as Random().
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchedRandomTest)
+{
+  GMM<> gmm(2, 2);
+  gmm.Weights() = arma::vec("0.40 0.60");
+  gmm.Component(0) = distribution::GaussianDistribution("2.25 3.10",
+      "1.00 0.60; 0.60 0.89");
+  gmm.Component(1) = distribution::GaussianDistribution("4.10 1.01",
+      "1.00 0.70; 0.70 1.01");
+
+  arma::mat samples;
+  gmm.Random(10000, samples);
+
+  BOOST_REQUIRE_EQUAL(samples.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(samples.n_cols, 10000);
+
+  // The sample mean must be near the weighted mean of the component means.
+  const arma::vec expectedMean = 0.40 * gmm.Component(0).Mean() +
+      0.60 * gmm.Component(1).Mean();
+  const arma::vec sampleMean = arma::mean(samples, 1);
+
+  BOOST_REQUIRE_CLOSE(sampleMean[0], expectedMean[0], 5.0);
+  BOOST_REQUIRE_CLOSE(sampleMean[1], expectedMean[1], 5.0);
+}
+
 /**
  * Test classification of observations by component.
  */
@@ -524,6 +616,92 @@ BOOST_AUTO_TEST_CASE(GMMLoadSaveTest)
   }
 }
 
+BOOST_AUTO_TEST_CASE(EMFitCheckpointTest)
+{
+  // Generate a simple two-Gaussian dataset.
+  arma::mat observations(2, 500);
+  observations.cols(0, 249) = arma::randn(2, 250);
+  observations.cols(250, 499) = arma::randn(2, 250) + 6.0;
+
+  // Fit with checkpointing after every EM iteration; the last checkpoint must
+  // then hold the final model.
+  EMFit<> fitter;
+  fitter.CheckpointFile() = "test-em-checkpoint.xml";
+  fitter.CheckpointIterations() = 1;
+
+  std::vector<distribution::GaussianDistribution> dists(2,
+      distribution::GaussianDistribution(2));
+  arma::vec weights(2);
+  fitter.Estimate(observations, dists, weights);
+
+  // Load the checkpoint back and compare it against the final model.
+  std::vector<distribution::GaussianDistribution> checkpointDists;
+  arma::vec checkpointWeights;
+  BOOST_REQUIRE_EQUAL(fitter.LoadCheckpoint(checkpointDists,
+      checkpointWeights), true);
+
+  BOOST_REQUIRE_EQUAL(checkpointDists.size(), dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(checkpointWeights[i], weights[i], 1e-3);
+    for (size_t j = 0; j < dists[i].Mean().n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(checkpointDists[i].Mean()[j], dists[i].Mean()[j],
+          1e-3);
+  }
+
+  // The checkpoint uses the same layout as GMM::Save(), so GMM::Load() must
+  // be able to read it (for resuming via GMM::Estimate() with an initial
+  // model).
+  GMM<> gmm;
+  gmm.Load("test-em-checkpoint.xml");
+  BOOST_REQUIRE_EQUAL(gmm.Gaussians(), 2);
+
+  // Remove clutter.
+  remove("test-em-checkpoint.xml");
+}
+
+/**
+ * Train a GMM with the streaming (stochastic EM) mode on a two-Gaussian
+ * dataset read in batches from a file, and check that it recovers the
+ * mixture.
+ */
+BOOST_AUTO_TEST_CASE(GMMEstimateStreamingTest)
+{
+  // Generate a well-separated two-Gaussian dataset, shuffled so that every
+  // batch holds points from both components.
+  arma::mat data(2, 2000);
+  data.cols(0, 999) = arma::randn(2, 1000);
+  data.cols(1000, 1999) = arma::randn(2, 1000) + 6.0;
+  data = arma::shuffle(data, 1);
+
+  data::Save("gmm_stream_test.csv", data);
+
+  data::StreamingLoader<> loader("gmm_stream_test.csv", 250);
+
+  GMM<> gmm(2, 2);
+  const double avgLogLikelihood = gmm.EstimateStreaming(loader);
+
+  // The interpolated log-likelihood must be finite and plausible for this
+  // mixture (each point is about 2-D standard normal around its mean).
+  BOOST_REQUIRE_GT(avgLogLikelihood, -5.0);
+
+  // Identify the components by their first mean coordinate.
+  const size_t low = (gmm.Component(0).Mean()[0] <
+      gmm.Component(1).Mean()[0]) ? 0 : 1;
+  const size_t high = 1 - low;
+
+  // Stochastic EM is noisier than batch EM, so the tolerances are loose.
+  BOOST_REQUIRE_SMALL(gmm.Component(low).Mean()[0], 0.5);
+  BOOST_REQUIRE_SMALL(gmm.Component(low).Mean()[1], 0.5);
+  BOOST_REQUIRE_CLOSE(gmm.Component(high).Mean()[0], 6.0, 10.0);
+  BOOST_REQUIRE_CLOSE(gmm.Component(high).Mean()[1], 6.0, 10.0);
+
+  BOOST_REQUIRE_CLOSE(gmm.Weights()[low], 0.5, 20.0);
+  BOOST_REQUIRE_CLOSE(gmm.Weights()[high], 0.5, 20.0);
+
+  remove("gmm_stream_test.csv");
+}
+
 BOOST_AUTO_TEST_CASE(NoConstraintTest)
 {
   // Generate random matrices and make sure they end up the same.
@@ -758,5 +936,51 @@ BOOST_AUTO_TEST_CASE(UseExistingModelTest)
   }
 }
 
+/**
+ * Make sure a GMM with diagonal Gaussian components can be trained with EM,
+ * and that it recovers the parameters of a single diagonal Gaussian.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGMMTrainEMOneGaussian)
+{
+  for (size_t iterations = 0; iterations < 4; iterations++)
+  {
+    // Determine random covariance and mean.
+    arma::vec mean;
+    mean.randu(2);
+    arma::vec covar;
+    covar.randu(2);
+
+    arma::mat data;
+    data.randn(2 /* dimension */, 150 * pow(10, (iterations / 3.0)));
+
+    // Now apply mean and covariance.
+    data.row(0) *= covar(0);
+    data.row(1) *= covar(1);
+
+    data.row(0) += mean(0);
+    data.row(1) += mean(1);
+
+    // Now, train the model with diagonal Gaussian components.
+    GMM<EMFit<>, distribution::DiagonalGaussianDistribution> gmm(1, 2);
+    gmm.Estimate(data, 10);
+
+    arma::vec actualMean = arma::mean(data, 1);
+    arma::mat actualCovar = ccov(data, 1 /* biased estimator */);
+
+    // Check the model to see that it is correct.
+    BOOST_REQUIRE_CLOSE(gmm.Component(0).Mean()[0], actualMean(0), 1e-5);
+    BOOST_REQUIRE_CLOSE(gmm.Component(0).Mean()[1], actualMean(1), 1e-5);
+
+    // Only the variances are estimated; the off-diagonal elements of the
+    // actual covariance are not represented in the model.
+    BOOST_REQUIRE_CLOSE(gmm.Component(0).Covariance()[0],
+        actualCovar(0, 0), 1e-5);
+    BOOST_REQUIRE_CLOSE(gmm.Component(0).Covariance()[1],
+        actualCovar(1, 1), 1e-5);
+
+    BOOST_REQUIRE_CLOSE(gmm.Weights()[0], 1.0, 1e-5);
+  }
+}
+
 
 BOOST_AUTO_TEST_SUITE_END();
@@ -5,6 +5,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/online_viterbi.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -98,6 +99,61 @@ BOOST_AUTO_TEST_CASE(BorodovskyHMMTestViterbi)
   BOOST_REQUIRE_EQUAL(states[8], 2);
 }
 
+/**
+ * The streaming decoder must reproduce the full Viterbi path when the lag is
+ * at least as long as the sequence, and on the simple umbrella example even a
+ * short lag gives the same decisions.
+ */
+BOOST_AUTO_TEST_CASE(OnlineViterbiTest)
+{
+  // The same model and sequence as SimpleDiscreteHMMTestViterbi.
+  arma::vec initial("1 0");
+  arma::mat transition("0.7 0.3; 0.3 0.7");
+  std::vector<DiscreteDistribution> emission(2);
+  emission[0] = DiscreteDistribution("0.9 0.1");
+  emission[1] = DiscreteDistribution("0.2 0.8");
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  arma::mat observation = "0 0 1 0 0";
+  arma::Col<size_t> states;
+  hmm.Predict(observation, states);
+
+  // With a lag longer than the sequence, no state is emitted by Step() and
+  // Flush() performs a full traceback, which is exactly the Viterbi path.
+  OnlineViterbi<DiscreteDistribution> decoder(hmm, 10);
+  size_t state;
+  for (size_t t = 0; t < observation.n_cols; t++)
+    BOOST_REQUIRE_EQUAL(decoder.Step(observation.unsafe_col(t), state), false);
+
+  arma::Col<size_t> streamed;
+  decoder.Flush(streamed);
+
+  BOOST_REQUIRE_EQUAL(streamed.n_elem, states.n_elem);
+  for (size_t t = 0; t < states.n_elem; t++)
+    BOOST_REQUIRE_EQUAL(streamed[t], states[t]);
+
+  // Now decode with a short lag of 2: the first decision arrives with the
+  // third observation, and the decisions match the full Viterbi path on this
+  // well-separated example.
+  OnlineViterbi<DiscreteDistribution> lagged(hmm, 2);
+  size_t emitted = 0;
+  for (size_t t = 0; t < observation.n_cols; t++)
+  {
+    if (lagged.Step(observation.unsafe_col(t), state))
+    {
+      BOOST_REQUIRE_EQUAL(state, states[emitted]);
+      emitted++;
+    }
+  }
+  BOOST_REQUIRE_EQUAL(emitted, observation.n_cols - 2);
+
+  lagged.Flush(streamed);
+  BOOST_REQUIRE_EQUAL(streamed.n_elem, 2);
+  for (size_t t = 0; t < streamed.n_elem; t++)
+    BOOST_REQUIRE_EQUAL(streamed[t], states[emitted + t]);
+}
+
 /**
  * Ensure that the forward-backward algorithm is correct.
  */
@@ -1132,5 +1188,52 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLoadSaveTest)
   }
 }
 
+/**
+ * The batch Predict() and LogLikelihood() overloads must agree with the
+ * single-sequence versions for every sequence.
+ */
+BOOST_AUTO_TEST_CASE(BatchPredictLogLikelihoodTest)
+{
+  // A simple two-state Gaussian HMM.
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0"));
+  emission.push_back(GaussianDistribution("4.0 4.0", "1.0 0.0; 0.0 1.0"));
+
+  arma::mat transition("0.7 0.3; 0.3 0.7");
+
+  HMM<GaussianDistribution> hmm(transition, emission);
+
+  // Generate sequences of varying lengths.
+  std::vector<arma::mat> sequences;
+  for (size_t i = 0; i < 12; ++i)
+  {
+    arma::mat sequence;
+    arma::Col<size_t> states;
+    hmm.Generate(20 + 15 * i, sequence, states);
+    sequences.push_back(sequence);
+  }
+
+  std::vector<arma::Col<size_t> > batchStates;
+  arma::vec batchPredictLL;
+  hmm.Predict(sequences, batchStates, batchPredictLL);
+
+  arma::vec batchLL;
+  hmm.LogLikelihood(sequences, batchLL);
+
+  BOOST_REQUIRE_EQUAL(batchStates.size(), sequences.size());
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Col<size_t> states;
+    const double predictLL = hmm.Predict(sequences[i], states);
+
+    BOOST_REQUIRE_CLOSE(batchPredictLL[i], predictLL, 1e-10);
+    BOOST_REQUIRE_EQUAL(batchStates[i].n_elem, states.n_elem);
+    for (size_t t = 0; t < states.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(batchStates[i][t], states[t]);
+
+    BOOST_REQUIRE_CLOSE(batchLL[i], hmm.LogLikelihood(sequences[i]), 1e-10);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
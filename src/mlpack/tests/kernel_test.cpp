@@ -9,6 +9,7 @@
 #include <mlpack/core/kernels/epanechnikov_kernel.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/kernels/laplacian_kernel.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
@@ -114,7 +115,7 @@ BOOST_AUTO_TEST_CASE(lmetric_zeros)
 BOOST_AUTO_TEST_CASE(md_unset_covariance)
 {
   MahalanobisDistance<false> md;
-  md.Covariance() = arma::eye<arma::mat>(4, 4);
+  md.Covariance(arma::eye<arma::mat>(4, 4));
   arma::vec a = "1.0 2.0 2.0 3.0";
   arma::vec b = "0.0 0.0 1.0 3.0";
 
@@ -129,7 +130,7 @@ BOOST_AUTO_TEST_CASE(md_unset_covariance)
 BOOST_AUTO_TEST_CASE(md_root_unset_covariance)
 {
   MahalanobisDistance<true> md;
-  md.Covariance() = arma::eye<arma::mat>(4, 4);
+  md.Covariance(arma::eye<arma::mat>(4, 4));
   arma::vec a = "1.0 2.0 2.5 5.0";
   arma::vec b = "0.0 2.0 0.5 8.0";
 
@@ -203,6 +204,24 @@ BOOST_AUTO_TEST_CASE(md_full_covariance)
   BOOST_REQUIRE_CLOSE(md.Evaluate(b, a), 15.7, 1e-5);
 }
 
+/**
+ * Setting a new covariance matrix must recompute the cached Cholesky factor,
+ * so later evaluations use the new covariance.
+ */
+BOOST_AUTO_TEST_CASE(md_modified_covariance)
+{
+  MahalanobisDistance<false> md(4);
+  arma::vec a = "1.0 2.0 2.0 3.0";
+  arma::vec b = "0.0 0.0 1.0 3.0";
+
+  // Identity covariance first.
+  BOOST_REQUIRE_CLOSE(md.Evaluate(a, b), 6.0, 1e-5);
+
+  // Now scale the covariance and evaluate again.
+  md.Covariance(2.0 * md.Covariance());
+  BOOST_REQUIRE_CLOSE(md.Evaluate(a, b), 12.0, 1e-5);
+}
+
 /**
  * Simple test case for the cosine distance.
  */
@@ -408,129 +427,129 @@ BOOST_AUTO_TEST_CASE(PSpectrumSubstringExtractionTest)
 
   // herpgle: her, erp, rpg, pgl, gle
   BOOST_REQUIRE_EQUAL(p.Counts()[0][0].size(), 5);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["her"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["erp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["rpg"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["pgl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["gle"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "her"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "erp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "rpg"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "pgl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "gle"), 1);
 
   // herpagkle: her, erp, rpa, pag, agk, gkl, kle
   BOOST_REQUIRE_EQUAL(p.Counts()[0][1].size(), 7);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["her"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["erp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["rpa"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["pag"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["agk"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["gkl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["kle"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "her"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "erp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "rpa"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "pag"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "agk"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "gkl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "kle"), 1);
 
   // klunktor: klu, lun, unk, nkt, kto, tor
   BOOST_REQUIRE_EQUAL(p.Counts()[0][2].size(), 6);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["klu"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["lun"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["unk"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["nkt"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["kto"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["tor"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "klu"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "lun"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "unk"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "nkt"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "kto"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "tor"), 1);
 
   // flibbynopple: fli lib ibb bby byn yno nop opp ppl ple
   BOOST_REQUIRE_EQUAL(p.Counts()[0][3].size(), 10);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["fli"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["lib"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["ibb"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["bby"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["byn"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["yno"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["nop"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["opp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["ppl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["ple"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "fli"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "lib"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "ibb"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "bby"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "byn"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "yno"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "nop"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "opp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "ppl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "ple"), 1);
 
   // floggy3245: flo log ogg ggy gy3 y32 324 245
   BOOST_REQUIRE_EQUAL(p.Counts()[1][0].size(), 8);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["flo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["log"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["ogg"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["ggy"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["gy3"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["y32"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["324"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["245"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "flo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "log"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "ogg"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "ggy"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "gy3"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "y32"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "324"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "245"), 1);
 
   // flippydopflip: fli lip ipp ppy pyd ydo dop opf pfl fli lip
   // fli(2) lip(2) ipp ppy pyd ydo dop opf pfl
   BOOST_REQUIRE_EQUAL(p.Counts()[1][1].size(), 9);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["fli"], 2);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["lip"], 2);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["ipp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["ppy"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["pyd"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["ydo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["dop"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["opf"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["pfl"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "fli"), 2);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "lip"), 2);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "ipp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "ppy"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "pyd"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "ydo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "dop"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "opf"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "pfl"), 1);
 
   // stupid fricking cat: stu tup upi pid fri ric ick cki kin ing cat
   BOOST_REQUIRE_EQUAL(p.Counts()[1][2].size(), 11);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["stu"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["tup"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["upi"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["pid"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["fri"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["ric"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["ick"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["cki"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["kin"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["ing"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["cat"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "stu"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "tup"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "upi"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "pid"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "fri"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "ric"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "ick"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "cki"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "kin"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "ing"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "cat"), 1);
 
   // food time isn't until later: foo ood tim ime isn unt nti til lat ate ter
   BOOST_REQUIRE_EQUAL(p.Counts()[1][3].size(), 11);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["foo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ood"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["tim"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ime"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["isn"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["unt"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["nti"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["til"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["lat"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ate"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ter"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "foo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ood"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "tim"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ime"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "isn"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "unt"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "nti"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "til"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "lat"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ate"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ter"), 1);
 
   // leave me alone until 6:00: lea eav ave alo lon one unt nti til
   BOOST_REQUIRE_EQUAL(p.Counts()[1][4].size(), 9);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["lea"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["eav"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["ave"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["alo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["lon"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["one"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["unt"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["nti"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["til"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "lea"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "eav"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "ave"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "alo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "lon"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "one"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "unt"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "nti"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "til"), 1);
 
   // only after that do you get any food.:
   // onl nly aft fte ter tha hat you get any foo ood
   BOOST_REQUIRE_EQUAL(p.Counts()[1][5].size(), 12);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["onl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["nly"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["aft"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["fte"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["ter"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["tha"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["hat"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["you"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["get"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["any"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["foo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["ood"], 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "onl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "nly"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "aft"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "fte"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "ter"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "tha"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "hat"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "you"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "get"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "any"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "foo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "ood"), 1);
 
   // obloblobloblobloblobloblob: obl(8) blo(8) lob(8)
   BOOST_REQUIRE_EQUAL(p.Counts()[1][6].size(), 3);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][6]["obl"], 8);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][6]["blo"], 8);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][6]["lob"], 8);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 6, "obl"), 8);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 6, "blo"), 8);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 6, "lob"), 8);
 }
 
 BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
@@ -590,4 +609,151 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Make sure the blocked kernel matrix utility agrees with direct evaluation,
+ * for both the symmetric and the rectangular case (with sizes that do not
+ * divide evenly into tiles).
+ */
+BOOST_AUTO_TEST_CASE(ComputeKernelMatrixTest)
+{
+  arma::mat data(5, 137);
+  data.randu();
+
+  GaussianKernel gk(0.5);
+  arma::mat kernelMatrix;
+  ComputeKernelMatrix(data, kernelMatrix, gk);
+
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, data.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, data.n_cols);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+    for (size_t j = 0; j < data.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j),
+          gk.Evaluate(data.col(i), data.col(j)), 1e-10);
+
+  // Now the rectangular case.
+  arma::mat otherData(5, 71);
+  otherData.randu();
+
+  ComputeKernelMatrix(data, otherData, kernelMatrix, gk);
+
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, data.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, otherData.n_cols);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+    for (size_t j = 0; j < otherData.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j),
+          gk.Evaluate(data.col(i), otherData.col(j)), 1e-10);
+
+  // The linear kernel takes a separate path (a single matrix-matrix product).
+  LinearKernel lk;
+  ComputeKernelMatrix(data, kernelMatrix, lk);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+    for (size_t j = 0; j < data.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j),
+          lk.Evaluate(data.col(i), data.col(j)), 1e-10);
+}
+
+/**
+ * The disk-backed kernel matrix cache must return exactly the matrices the
+ * direct computation produces, both on a miss (compute and store) and on a
+ * hit (load), and must not hit when the kernel parameters differ.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixCacheTest)
+{
+  arma::mat data(5, 90);
+  data.randu();
+  arma::mat otherData(5, 40);
+  otherData.randu();
+
+  GaussianKernel gk(2.0);
+  arma::mat direct;
+  ComputeKernelMatrix(data, direct, gk);
+
+  // First call misses and stores; second call loads the stored entry.
+  KernelMatrixCache<GaussianKernel> cache(".", gk);
+  arma::mat first, second;
+  cache.Symmetric(data, first);
+  cache.Symmetric(data, second);
+
+  for (size_t i = 0; i < direct.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(first[i], direct[i], 1e-10);
+    BOOST_REQUIRE_EQUAL(second[i], first[i]);
+  }
+
+  // The rectangular case.
+  arma::mat rectDirect;
+  ComputeKernelMatrix(data, otherData, rectDirect, gk);
+  arma::mat rectFirst, rectSecond;
+  cache.Rectangular(data, otherData, rectFirst);
+  cache.Rectangular(data, otherData, rectSecond);
+
+  for (size_t i = 0; i < rectDirect.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(rectFirst[i], rectDirect[i], 1e-10);
+    BOOST_REQUIRE_EQUAL(rectSecond[i], rectFirst[i]);
+  }
+
+  // A kernel with different parameters must not hit the stored entry.
+  GaussianKernel narrow(0.25);
+  KernelMatrixCache<GaussianKernel> narrowCache(".", narrow);
+  BOOST_REQUIRE_NE(narrowCache.FileName(data), cache.FileName(data));
+
+  arma::mat narrowDirect, narrowCached;
+  ComputeKernelMatrix(data, narrowDirect, narrow);
+  narrowCache.Symmetric(data, narrowCached);
+  for (size_t i = 0; i < narrowDirect.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(narrowCached[i], narrowDirect[i], 1e-10);
+
+  // Clean the cache entries up.
+  remove(cache.FileName(data).c_str());
+  remove(cache.FileName(data, &otherData).c_str());
+  remove(narrowCache.FileName(data).c_str());
+}
+
+/**
+ * The batched Evaluate() overloads must agree with the scalar Evaluate().
+ */
+BOOST_AUTO_TEST_CASE(BatchedKernelEvaluateTest)
+{
+  arma::mat data(5, 113);
+  data.randu();
+  arma::vec point(5);
+  point.randu();
+
+  arma::vec batched;
+
+  GaussianKernel gk(0.5);
+  gk.Evaluate(data, point, batched);
+  BOOST_REQUIRE_EQUAL(batched.n_elem, data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(batched[i],
+        gk.Evaluate(data.unsafe_col(i), point), 1e-10);
+
+  LaplacianKernel lapk(0.7);
+  lapk.Evaluate(data, point, batched);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(batched[i],
+        lapk.Evaluate(data.unsafe_col(i), point), 1e-10);
+
+  LinearKernel::Evaluate(data, point, batched);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(batched[i],
+        LinearKernel::Evaluate(data.unsafe_col(i), point), 1e-10);
+
+  PolynomialKernel pk(3.0, 1.0);
+  pk.Evaluate(data, point, batched);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(batched[i],
+        pk.Evaluate(data.unsafe_col(i), point), 1e-10);
+
+  HyperbolicTangentKernel htk(2.0, 0.5);
+  htk.Evaluate(data, point, batched);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(batched[i],
+        htk.Evaluate(data.unsafe_col(i), point), 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
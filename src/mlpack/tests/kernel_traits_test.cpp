@@ -56,4 +56,34 @@ BOOST_AUTO_TEST_CASE(IsNormalizedTest)
       false);
 }
 
+BOOST_AUTO_TEST_CASE(IsVectorizedTest)
+{
+  // See the comment in IsNormalizedTest about the explicit bool casts.
+
+  // If the type is not a valid kernel, it should be false (default value).
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<int>::IsVectorized, false);
+
+  // Kernels with a batched Evaluate().
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<GaussianKernel>::IsVectorized, true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<LaplacianKernel>::IsVectorized,
+      true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<LinearKernel>::IsVectorized, true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<PolynomialKernel>::IsVectorized,
+      true);
+  BOOST_REQUIRE_EQUAL(
+      (bool) KernelTraits<HyperbolicTangentKernel>::IsVectorized, true);
+
+  // Kernels without a batched Evaluate().
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<CosineDistance>::IsVectorized,
+      false);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<EpanechnikovKernel>::IsVectorized,
+      false);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<SphericalKernel>::IsVectorized,
+      false);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<TriangularKernel>::IsVectorized,
+      false);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<PSpectrumStringKernel>::IsVectorized,
+      false);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
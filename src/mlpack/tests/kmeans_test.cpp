@@ -6,12 +6,15 @@
 
 #include <mlpack/methods/kmeans/kmeans.hpp>
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/minibatch_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dtnn_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/sharded_kmeans.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 
@@ -110,8 +113,9 @@ BOOST_AUTO_TEST_CASE(AllowEmptyClusterTest)
 
   // Make sure the method doesn't modify any points.
   metric::LMetric<2, true> metric;
+  // (A fake iteration number is passed; AllowEmptyClusters ignores it.)
   BOOST_REQUIRE_EQUAL(AllowEmptyClusters::EmptyCluster(kMeansData, 2, centroids,
-      counts, metric), 0);
+      counts, metric, 0), 0);
 
   // Make sure no assignments were changed.
   for (size_t i = 0; i < assignments.n_elem; i++)
@@ -145,8 +149,9 @@ BOOST_AUTO_TEST_CASE(MaxVarianceNewClusterTest)
   metric::LMetric<2, true> metric;
 
   // This should only change one point.
-  BOOST_REQUIRE_EQUAL(MaxVarianceNewCluster::EmptyCluster(data, 2, centroids,
-      counts, metric), 1);
+  MaxVarianceNewCluster mvnc;
+  BOOST_REQUIRE_EQUAL(mvnc.EmptyCluster(data, 2, centroids, counts, metric, 0),
+      1);
 
   // Add the variance of each point's distance away from the cluster.  I think
   // this is the sensible thing to do.
@@ -182,6 +187,47 @@ BOOST_AUTO_TEST_CASE(MaxVarianceNewClusterTest)
   BOOST_REQUIRE_EQUAL(counts[2], 1);
 }
 
+/**
+ * Make sure the max variance method repairs several empty clusters in the same
+ * iteration correctly, using its cached variance statistics.
+ */
+BOOST_AUTO_TEST_CASE(MaxVarianceNewClusterCacheTest)
+{
+  // Six points; points 2 and 3 are far from the rest of cluster 0.
+  arma::mat data("0.0 0.1 5.0 -5.0 10.0 10.1;"
+                 "0.0 0.1 0.0  0.0  0.0  0.1");
+
+  arma::mat centroids(2, 4);
+  centroids.col(0) = 0.25 * (data.col(0) + data.col(1) + data.col(2) +
+      data.col(3));
+  centroids.col(1) = 0.5 * (data.col(4) + data.col(5));
+  centroids.col(2).fill(DBL_MAX);
+  centroids.col(3).fill(DBL_MAX);
+
+  arma::Col<size_t> counts("4 2 0 0");
+
+  metric::LMetric<2, true> metric;
+
+  // Repair both empty clusters in the same iteration; the second call must use
+  // the cached statistics.  Cluster 0 has by far the largest variance, so each
+  // repair should take one of its two outlying points.
+  MaxVarianceNewCluster mvnc;
+  BOOST_REQUIRE_EQUAL(mvnc.EmptyCluster(data, 2, centroids, counts, metric, 0),
+      1);
+  BOOST_REQUIRE_EQUAL(mvnc.EmptyCluster(data, 3, centroids, counts, metric, 0),
+      1);
+
+  // Point 3 is slightly further from the old centroid than point 2, so it
+  // should have been taken first.
+  BOOST_REQUIRE_SMALL(metric.Evaluate(centroids.col(2), data.col(3)), 1e-10);
+  BOOST_REQUIRE_SMALL(metric.Evaluate(centroids.col(3), data.col(2)), 1e-10);
+
+  BOOST_REQUIRE_EQUAL(counts[0], 2);
+  BOOST_REQUIRE_EQUAL(counts[1], 2);
+  BOOST_REQUIRE_EQUAL(counts[2], 1);
+  BOOST_REQUIRE_EQUAL(counts[3], 1);
+}
+
 /**
  * Make sure the random partitioner seems to return valid results.
  */
@@ -488,9 +534,104 @@ BOOST_AUTO_TEST_CASE(SparseKMeansTest)
   BOOST_REQUIRE_EQUAL(assignments[11], clusterTwo);
 }
 
+/**
+ * Make sure the sparse specialization of NaiveKMeans returns the same results
+ * as the generic dense implementation.
+ */
+BOOST_AUTO_TEST_CASE(SparseNaiveKMeansConsistencyTest)
+{
+  // Build a dataset that is about 10% dense.
+  arma::mat denseData(50, 300);
+  denseData.randu();
+  for (size_t i = 0; i < denseData.n_elem; ++i)
+    if (denseData[i] < 0.9)
+      denseData[i] = 0.0;
+
+  arma::sp_mat sparseData(denseData);
+
+  arma::mat centroids(50, 5);
+  centroids.randu();
+
+  // Run the generic dense implementation.
+  KMeans<> km;
+  arma::Col<size_t> assignments;
+  arma::mat denseCentroids(centroids);
+  km.Cluster(denseData, 5, assignments, denseCentroids, false, true);
+
+  // Now run the sparse specialization with the same initial centroids.
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      NaiveKMeans, arma::sp_mat> sparseKm;
+  arma::Col<size_t> sparseAssignments;
+  arma::mat sparseCentroids(centroids);
+  sparseKm.Cluster(sparseData, 5, sparseAssignments, sparseCentroids, false,
+      true);
+
+  for (size_t i = 0; i < denseData.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], sparseAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(denseCentroids[i], sparseCentroids[i], 1e-5);
+}
+
 #endif // Exclude Armadillo 3.4.
 #endif // ARMA_HAS_SPMAT
 
+/**
+ * Make sure the gemm-based dense Euclidean specialization of NaiveKMeans
+ * computes the same Lloyd iteration as a brute-force pass over the
+ * point-centroid distances.
+ */
+BOOST_AUTO_TEST_CASE(DenseNaiveKMeansConsistencyTest)
+{
+  arma::mat data(25, 800);
+  data.randu();
+
+  arma::mat centroids(25, 6);
+  centroids.randu();
+
+  // Run one iteration of the dense Euclidean specialization.
+  metric::EuclideanDistance metric;
+  NaiveKMeans<metric::EuclideanDistance, arma::mat> lloyd(data, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  lloyd.Iterate(centroids, newCentroids, counts);
+
+  // Compute the same iteration by brute force.
+  arma::mat expectedCentroids(25, 6);
+  expectedCentroids.zeros();
+  arma::Col<size_t> expectedCounts(6);
+  expectedCounts.zeros();
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = 6;
+    for (size_t j = 0; j < 6; ++j)
+    {
+      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    expectedCentroids.col(closestCluster) += data.col(i);
+    expectedCounts(closestCluster)++;
+  }
+  for (size_t j = 0; j < 6; ++j)
+    if (expectedCounts(j) != 0)
+      expectedCentroids.col(j) /= expectedCounts(j);
+
+  for (size_t j = 0; j < 6; ++j)
+    BOOST_REQUIRE_EQUAL(counts(j), expectedCounts(j));
+
+  for (size_t i = 0; i < expectedCentroids.n_elem; ++i)
+    if (expectedCentroids[i] != 0.0)
+      BOOST_REQUIRE_CLOSE(newCentroids[i], expectedCentroids[i], 1e-5);
+    else
+      BOOST_REQUIRE_SMALL(newCentroids[i], 1e-10);
+}
+
 BOOST_AUTO_TEST_CASE(ElkanTest)
 {
   const size_t trials = 5;
@@ -525,6 +666,51 @@ BOOST_AUTO_TEST_CASE(ElkanTest)
   }
 }
 
+BOOST_AUTO_TEST_CASE(ElkanHamerlyFallbackTest)
+{
+  arma::mat dataset(10, 1000);
+  dataset.randu();
+
+  const size_t k = 10;
+  arma::mat centroids(10, k);
+  centroids.randu();
+
+  // With a bound memory budget too small for the n x k lower bound matrix,
+  // Elkan's algorithm should delegate to Hamerly's algorithm, so running both
+  // side by side must give identical iterates.
+  metric::EuclideanDistance metric;
+  ElkanKMeans<metric::EuclideanDistance, arma::mat> elkan(dataset, metric);
+  elkan.MaxBoundMemory() = 1; // One byte; certainly too small.
+  HamerlyKMeans<metric::EuclideanDistance, arma::mat> hamerly(dataset, metric);
+
+  arma::mat elkanCentroids(centroids);
+  arma::mat hamerlyCentroids(centroids);
+  for (size_t iteration = 0; iteration < 3; ++iteration)
+  {
+    arma::mat elkanNewCentroids;
+    arma::Col<size_t> elkanCounts;
+    const double elkanResidual = elkan.Iterate(elkanCentroids,
+        elkanNewCentroids, elkanCounts);
+
+    arma::mat hamerlyNewCentroids;
+    arma::Col<size_t> hamerlyCounts;
+    const double hamerlyResidual = hamerly.Iterate(hamerlyCentroids,
+        hamerlyNewCentroids, hamerlyCounts);
+
+    BOOST_REQUIRE_CLOSE(elkanResidual, hamerlyResidual, 1e-10);
+    for (size_t i = 0; i < k; ++i)
+      BOOST_REQUIRE_EQUAL(elkanCounts[i], hamerlyCounts[i]);
+    for (size_t i = 0; i < elkanNewCentroids.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(elkanNewCentroids[i], hamerlyNewCentroids[i], 1e-10);
+
+    elkanCentroids = elkanNewCentroids;
+    hamerlyCentroids = hamerlyNewCentroids;
+  }
+
+  BOOST_REQUIRE_EQUAL(elkan.DistanceCalculations(),
+      hamerly.DistanceCalculations());
+}
+
 BOOST_AUTO_TEST_CASE(HamerlyTest)
 {
   const size_t trials = 5;
@@ -560,6 +746,79 @@ BOOST_AUTO_TEST_CASE(HamerlyTest)
   }
 }
 
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  // Mini-batch k-means is a stochastic approximation, so we cannot expect it
+  // to return exactly the same clusters as the naive method.  Instead, use
+  // three well-separated Gaussians and make sure the centroids end up close
+  // to the true means.
+  arma::mat dataset(3, 1500);
+  dataset.randn();
+
+  arma::mat trueCentroids("  0  10 -10;"
+                          "  0  10   5;"
+                          "  0  10   0");
+
+  for (size_t i = 500; i < 1000; ++i)
+    dataset.col(i) += trueCentroids.col(1);
+  for (size_t i = 1000; i < 1500; ++i)
+    dataset.col(i) += trueCentroids.col(2);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      MiniBatchKMeans> m;
+  arma::Col<size_t> assignments;
+  arma::mat centroids(trueCentroids); // Use the true means as initial guesses.
+  m.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  // The clusters are separated by many standard deviations, so each centroid
+  // should stay close to the mean of its cluster.
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const double distance = metric::EuclideanDistance::Evaluate(
+        centroids.col(i), trueCentroids.col(i));
+    BOOST_REQUIRE_SMALL(distance, 0.5);
+  }
+
+  // Each of the three groups of points should share an assignment.
+  for (size_t i = 0; i < 1500; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[500 * (i / 500)]);
+}
+
+/**
+ * Make sure k-means++ seeding finds the correct clusters on the simple
+ * three-class dataset.  Because the classes are separated by far more than
+ * their internal spread, D^2 sampling should place one initial center in each
+ * class (with overwhelming probability).
+ */
+BOOST_AUTO_TEST_CASE(KMeansPlusPlusTest)
+{
+  KMeans<metric::EuclideanDistance, KMeansPlusPlus> kmeans;
+
+  arma::Col<size_t> assignments;
+  kmeans.Cluster((arma::mat) trans(kMeansData), 3, assignments);
+
+  // The clusters may be ordered arbitrarily, as in KMeansSimpleTest.
+  size_t firstClass = assignments(0);
+
+  for (size_t i = 1; i < 13; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), firstClass);
+
+  size_t secondClass = assignments(13);
+
+  BOOST_REQUIRE_NE(firstClass, secondClass);
+
+  for (size_t i = 13; i < 20; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), secondClass);
+
+  size_t thirdClass = assignments(20);
+
+  BOOST_REQUIRE_NE(firstClass, thirdClass);
+  BOOST_REQUIRE_NE(secondClass, thirdClass);
+
+  for (size_t i = 20; i < 30; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), thirdClass);
+}
+
 BOOST_AUTO_TEST_CASE(PellegMooreTest)
 {
   const size_t trials = 5;
@@ -594,6 +853,45 @@ BOOST_AUTO_TEST_CASE(PellegMooreTest)
   }
 }
 
+/**
+ * Make sure the objective accumulated by the Pelleg-Moore traversal (which
+ * uses the sufficient statistics cached in the tree for whole-node
+ * assignments) matches the brute-force objective of the same assignment.
+ */
+BOOST_AUTO_TEST_CASE(PellegMooreObjectiveTest)
+{
+  arma::mat dataset(8, 800);
+  dataset.randu();
+
+  arma::mat centroids(8, 6);
+  centroids.randu();
+
+  metric::EuclideanDistance metric;
+  PellegMooreKMeans<metric::EuclideanDistance, arma::mat> pellegMoore(dataset,
+      metric);
+
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  pellegMoore.Iterate(centroids, newCentroids, counts);
+
+  // Compute the objective of the exact assignment by brute force.
+  double objective = 0.0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    double bestDistance = DBL_MAX;
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      const double distance = metric.Evaluate(dataset.col(i),
+          centroids.col(c));
+      if (distance < bestDistance)
+        bestDistance = distance;
+    }
+    objective += bestDistance * bestDistance;
+  }
+
+  BOOST_REQUIRE_CLOSE(pellegMoore.Objective(), objective, 1e-8);
+}
+
 BOOST_AUTO_TEST_CASE(DTNNTest)
 {
   const size_t trials = 5;
@@ -690,4 +988,165 @@ BOOST_AUTO_TEST_CASE(DualTreeKMeansTest)
   }
 }
 
+/**
+ * Telemetry callback for the test below; records every iteration and can stop
+ * the clustering after a given number of iterations.
+ */
+class TestTelemetryCallback : public KMeansTelemetryCallback
+{
+ public:
+  TestTelemetryCallback(const size_t stopAfter = 0) :
+      iterations(0), stopAfter(stopAfter),
+      lastWcss(std::numeric_limits<double>::infinity()), wcssIncreased(false)
+  { }
+
+  bool Iteration(const KMeansIterationTelemetry& telemetry)
+  {
+    iterations++;
+
+    // Iterations must be reported in order, with sane measurements.
+    BOOST_REQUIRE_EQUAL(telemetry.iteration, iterations);
+    BOOST_REQUIRE_GE(telemetry.centroidMovement, 0.0);
+    BOOST_REQUIRE_GE(telemetry.withinClusterSumOfSquares, 0.0);
+    BOOST_REQUIRE_GE(telemetry.lloydStepTime, 0.0);
+    BOOST_REQUIRE_GE(telemetry.distanceCalculations, iterations);
+
+    // Lloyd iterations never increase the objective (empty cluster repairs
+    // could, but this test's data does not produce any).
+    if (telemetry.withinClusterSumOfSquares > lastWcss + 1e-10)
+      wcssIncreased = true;
+    lastWcss = telemetry.withinClusterSumOfSquares;
+
+    return (stopAfter == 0) || (iterations < stopAfter);
+  }
+
+  size_t iterations;
+  size_t stopAfter;
+  double lastWcss;
+  bool wcssIncreased;
+};
+
+/**
+ * Make sure the telemetry callback sees every iteration and that returning
+ * false stops the clustering early.
+ */
+BOOST_AUTO_TEST_CASE(TelemetryCallbackTest)
+{
+  arma::mat dataset(10, 500);
+  dataset.randu();
+
+  // First, run with a callback that just watches.
+  KMeans<> kmeans;
+  TestTelemetryCallback watcher;
+  kmeans.Telemetry() = &watcher;
+
+  arma::mat centroids;
+  kmeans.Cluster(dataset, 5, centroids);
+
+  BOOST_REQUIRE_GE(watcher.iterations, 1);
+  BOOST_REQUIRE_EQUAL(watcher.wcssIncreased, false);
+
+  // Now, run with a callback that stops the clustering after one iteration.
+  TestTelemetryCallback stopper(1);
+  kmeans.Telemetry() = &stopper;
+
+  arma::mat stoppedCentroids;
+  kmeans.Cluster(dataset, 5, stoppedCentroids);
+
+  BOOST_REQUIRE_EQUAL(stopper.iterations, 1);
+  BOOST_REQUIRE_EQUAL(stoppedCentroids.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(stoppedCentroids.n_rows, 10);
+}
+
+/**
+ * A point with weight 2 must act like the same point duplicated: clustering a
+ * dataset with every weight set to 2 and clustering the dataset with every
+ * point appearing twice must give (nearly) the same centroids, when both runs
+ * start from the same initial centroids.
+ */
+BOOST_AUTO_TEST_CASE(WeightedPointsTest)
+{
+  // Three well-separated clusters of ten points each.
+  arma::mat dataset(2, 30);
+  dataset.randu();
+  dataset.cols(10, 19) += 5.0;
+  dataset.cols(20, 29) += 10.0;
+
+  // The same dataset with every point appearing twice.
+  arma::mat doubled(2, 60);
+  doubled.cols(0, 29) = dataset;
+  doubled.cols(30, 59) = dataset;
+
+  // Both runs start from the same initial centroids.
+  arma::mat initial(2, 3);
+  initial.col(0).fill(0.5);
+  initial.col(1).fill(5.5);
+  initial.col(2).fill(10.5);
+
+  KMeans<> weighted;
+  weighted.Weights() = 2.0 * arma::ones<arma::vec>(30);
+  arma::mat weightedCentroids = initial;
+  weighted.Cluster(dataset, 3, weightedCentroids, true);
+
+  KMeans<> unweighted;
+  arma::mat doubledCentroids = initial;
+  unweighted.Cluster(doubled, 3, doubledCentroids, true);
+
+  for (size_t i = 0; i < weightedCentroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(weightedCentroids[i], doubledCentroids[i], 1e-5);
+}
+
+/**
+ * The sharded sufficient statistics must determine the centroid update
+ * exactly: clustering shards with ShardedKMeans and clustering the
+ * concatenated shards with KMeans must give (nearly) the same centroids,
+ * when both runs start from the same initial centroids.
+ */
+BOOST_AUTO_TEST_CASE(ShardedKMeansTest)
+{
+  // Three well-separated clusters, split unevenly across three shards.
+  arma::mat dataset(2, 90);
+  dataset.randu();
+  dataset.cols(30, 59) += 5.0;
+  dataset.cols(60, 89) += 10.0;
+  dataset = arma::shuffle(dataset, 1);
+
+  arma::mat shard0 = dataset.cols(0, 14);
+  arma::mat shard1 = dataset.cols(15, 54);
+  arma::mat shard2 = dataset.cols(55, 89);
+
+  std::vector<const arma::mat*> shards;
+  shards.push_back(&shard0);
+  shards.push_back(&shard1);
+  shards.push_back(&shard2);
+
+  // Both runs start from the same initial centroids.
+  arma::mat initial(2, 3);
+  initial.col(0).fill(0.5);
+  initial.col(1).fill(5.5);
+  initial.col(2).fill(10.5);
+
+  ShardedKMeans<> sharded;
+  arma::mat shardedCentroids = initial;
+  std::vector<arma::Col<size_t> > shardedAssignments;
+  sharded.Cluster(shards, 3, shardedAssignments, shardedCentroids, true);
+
+  KMeans<> joined;
+  arma::mat joinedCentroids = initial;
+  arma::Col<size_t> joinedAssignments;
+  joined.Cluster(dataset, 3, joinedAssignments, joinedCentroids, false, true);
+
+  for (size_t i = 0; i < joinedCentroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(shardedCentroids[i], joinedCentroids[i], 1e-5);
+
+  // The per-shard assignments must agree with the assignments of the
+  // concatenated run.
+  BOOST_REQUIRE_EQUAL(shardedAssignments.size(), shards.size());
+  size_t point = 0;
+  for (size_t s = 0; s < shards.size(); ++s)
+    for (size_t i = 0; i < shardedAssignments[s].n_elem; ++i, ++point)
+      BOOST_REQUIRE_EQUAL(shardedAssignments[s][i],
+          joinedAssignments[point]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -155,4 +155,37 @@ BOOST_AUTO_TEST_CASE(NoCholeskySingularityTest)
   }
 }
 
+// Ensure that a single LARS object can be reused for several solves, and
+// gives the same solutions as fresh objects.
+BOOST_AUTO_TEST_CASE(ReuseTest)
+{
+  arma::mat X;
+  arma::vec y;
+  GenerateProblem(X, y, 100, 10);
+  arma::vec y2 = trans(X) * arma::randn(10, 1);
+
+  // Solve both problems with the same object, against a precomputed Gram
+  // matrix (as the dictionary learning methods do).
+  arma::mat matGram = X * trans(X);
+  LARS lars(true, matGram, 0.1);
+
+  arma::vec beta1, beta2;
+  lars.Regress(X, y, beta1);
+  lars.Regress(X, y2, beta2);
+
+  // Now solve each problem with a fresh object.
+  LARS lars1(true, matGram, 0.1);
+  LARS lars2(true, matGram, 0.1);
+
+  arma::vec beta1Fresh, beta2Fresh;
+  lars1.Regress(X, y, beta1Fresh);
+  lars2.Regress(X, y2, beta2Fresh);
+
+  for (size_t i = 0; i < beta1.n_elem; ++i)
+  {
+    BOOST_REQUIRE_SMALL(beta1(i) - beta1Fresh(i), 1e-12);
+    BOOST_REQUIRE_SMALL(beta2(i) - beta2Fresh(i), 1e-12);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
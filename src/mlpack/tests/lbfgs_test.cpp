@@ -37,6 +37,42 @@ BOOST_AUTO_TEST_CASE(RosenbrockFunctionTest)
   BOOST_REQUIRE_CLOSE(coords[1], 1.0, 1e-5);
 }
 
+/**
+ * Tests that a checkpoint written during optimization can be loaded back and
+ * used to resume the optimization.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointTest)
+{
+  RosenbrockFunction f;
+  L_BFGS<RosenbrockFunction> lbfgs(f);
+  lbfgs.CheckpointFile() = "lbfgs_checkpoint_test.xml";
+  lbfgs.CheckpointIterations() = 1; // Checkpoint every iteration.
+
+  // Run a few iterations, so a checkpoint gets written.
+  arma::vec coords = f.GetInitialPoint();
+  lbfgs.Optimize(coords, 5);
+
+  // The checkpoint should hold the last accepted iterate.
+  arma::mat checkpointed;
+  BOOST_REQUIRE_EQUAL(lbfgs.LoadCheckpoint(checkpointed), true);
+  BOOST_REQUIRE_EQUAL(checkpointed.n_elem, coords.n_elem);
+  for (size_t i = 0; i < coords.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(checkpointed(i), coords(i), 1e-10);
+
+  // Resuming from the checkpoint should still reach the minimum.
+  arma::mat resumed;
+  lbfgs.LoadCheckpoint(resumed);
+  lbfgs.CheckpointFile() = ""; // Don't overwrite the checkpoint.
+  lbfgs.Optimize(resumed, 10000);
+
+  BOOST_REQUIRE_SMALL(f.Evaluate(resumed), 1e-5);
+  BOOST_REQUIRE_CLOSE(resumed(0), 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(resumed(1), 1.0, 1e-5);
+
+  // Clean up the checkpoint file.
+  remove("lbfgs_checkpoint_test.xml");
+}
+
 /**
  * Tests the L-BFGS optimizer using the Wood Function.
  */
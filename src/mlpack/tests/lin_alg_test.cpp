@@ -73,6 +73,26 @@ BOOST_AUTO_TEST_CASE(TestCenterB)
       BOOST_REQUIRE_CLOSE(tmp_out(row, col), (double) (col - 2.5) * row, 1e-5);
 }
 
+/**
+ * The in-place Center() must produce the same result as the copying version.
+ */
+BOOST_AUTO_TEST_CASE(TestCenterInPlace)
+{
+  mat tmp(5, 6);
+  for (int row = 0; row < 5; row++)
+    for (int col = 0; col < 6; col++)
+      tmp(row, col) = row * (col + 1);
+
+  mat tmp_out;
+  Center(tmp, tmp_out);
+
+  Center(tmp); // In-place.
+
+  for (int row = 0; row < 5; row++)
+    for (int col = 0; col < 6; col++)
+      BOOST_REQUIRE_SMALL(tmp(row, col) - tmp_out(row, col), 1e-10);
+}
+
 BOOST_AUTO_TEST_CASE(TestWhitenUsingEig)
 {
   // After whitening using eigendecomposition, the covariance of
@@ -104,6 +124,35 @@ BOOST_AUTO_TEST_CASE(TestWhitenUsingEig)
   }
 }
 
+/**
+ * The in-place and fused whitening variants must produce the same result as
+ * Center() followed by the copying WhitenUsingEig().
+ */
+BOOST_AUTO_TEST_CASE(TestWhitenUsingEigInPlace)
+{
+  mat tmp, tmp_centered, whitened, whitening_matrix;
+
+  data::Load("trainSet.csv", tmp);
+  Center(tmp, tmp_centered);
+  WhitenUsingEig(tmp_centered, whitened, whitening_matrix);
+
+  // The in-place variant on the pre-centered data.
+  mat inPlace = tmp_centered;
+  mat inPlaceWhitening;
+  WhitenUsingEig(inPlace, inPlaceWhitening);
+
+  for (size_t i = 0; i < whitened.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(inPlace[i] - whitened[i], 1e-10);
+
+  // The fused variant straight from the uncentered data.
+  mat fused = tmp;
+  mat fusedWhitening;
+  CenterAndWhitenUsingEig(fused, fusedWhitening);
+
+  for (size_t i = 0; i < whitened.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(fused[i] - whitened[i], 1e-10);
+}
+
 BOOST_AUTO_TEST_CASE(TestOrthogonalize)
 {
   // Generate a random matrix; then, orthogonalize it and test if it's
@@ -185,4 +234,69 @@ BOOST_AUTO_TEST_CASE(TestRemoveRows)
   }
 }
 
+/**
+ * Test that PairwiseDistances() agrees with directly evaluated squared
+ * distances, for both the two-matrix and single-matrix overloads.
+ */
+BOOST_AUTO_TEST_CASE(TestPairwiseDistances)
+{
+  mat a(10, 73);
+  a.randu();
+  mat b(10, 42);
+  b.randu();
+
+  mat distances;
+  PairwiseDistances(a, b, distances);
+
+  BOOST_REQUIRE_EQUAL(distances.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, b.n_cols);
+
+  for (size_t i = 0; i < a.n_cols; ++i)
+    for (size_t j = 0; j < b.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(distances(i, j),
+          metric::SquaredEuclideanDistance::Evaluate(a.unsafe_col(i),
+          b.unsafe_col(j)), 1e-8);
+
+  // The single-matrix overload; the diagonal must be exactly zero thanks to
+  // the roundoff clamp.
+  PairwiseDistances(a, distances);
+
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    BOOST_REQUIRE_GE(distances(i, i), 0.0);
+    BOOST_REQUIRE_SMALL(distances(i, i), 1e-12);
+
+    for (size_t j = 0; j < a.n_cols; ++j)
+    {
+      if (i == j)
+        continue;
+
+      BOOST_REQUIRE_CLOSE(distances(i, j),
+          metric::SquaredEuclideanDistance::Evaluate(a.unsafe_col(i),
+          a.unsafe_col(j)), 1e-8);
+    }
+  }
+}
+
+/**
+ * The single-precision instantiation of PairwiseDistances() should also give
+ * correct results (to float precision).
+ */
+BOOST_AUTO_TEST_CASE(TestPairwiseDistancesFloat)
+{
+  fmat a(10, 25);
+  a.randu();
+  fmat b(10, 31);
+  b.randu();
+
+  fmat distances;
+  PairwiseDistances(a, b, distances);
+
+  for (size_t i = 0; i < a.n_cols; ++i)
+    for (size_t j = 0; j < b.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(distances(i, j), (float)
+          metric::SquaredEuclideanDistance::Evaluate(a.unsafe_col(i),
+          b.unsafe_col(j)), 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -173,4 +173,59 @@ BOOST_AUTO_TEST_CASE(RidgeRegressionTestCase)
     BOOST_REQUIRE_SMALL(predictions(i) - responses(i), .05);
 }
 
+/**
+ * Train on part of a dataset and Append() the rest; the resulting parameters
+ * should match a model trained on the whole dataset at once.
+ */
+BOOST_AUTO_TEST_CASE(AppendTest)
+{
+  // Random dataset with exact linear responses, so both models can recover
+  // the generating coefficients exactly.
+  arma::mat predictors;
+  predictors.randu(5, 200);
+
+  arma::vec coeffs;
+  coeffs.randu(6);
+
+  arma::vec responses(200);
+  for (size_t i = 0; i < 200; ++i)
+    responses[i] = coeffs[0] + dot(coeffs.rows(1, 5), predictors.col(i));
+
+  // Train on the whole dataset at once, for reference.
+  LinearRegression lrFull(predictors, responses);
+
+  // Train on the first half, then append the rest.
+  LinearRegression lr(predictors.cols(0, 99), responses.subvec(0, 99));
+  lr.Append(predictors.cols(100, 199), responses.subvec(100, 199));
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, lrFull.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrFull.Parameters()[i], 1e-3);
+}
+
+/**
+ * The same, but for ridge regression.
+ */
+BOOST_AUTO_TEST_CASE(RidgeAppendTest)
+{
+  arma::mat predictors;
+  predictors.randu(5, 200);
+
+  arma::vec coeffs;
+  coeffs.randu(6);
+
+  arma::vec responses(200);
+  for (size_t i = 0; i < 200; ++i)
+    responses[i] = coeffs[0] + dot(coeffs.rows(1, 5), predictors.col(i));
+
+  LinearRegression lrFull(predictors, responses, 0.5);
+
+  LinearRegression lr(predictors.cols(0, 99), responses.subvec(0, 99), 0.5);
+  lr.Append(predictors.cols(100, 199), responses.subvec(100, 199));
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, lrFull.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrFull.Parameters()[i], 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
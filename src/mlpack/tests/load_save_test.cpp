@@ -493,6 +493,53 @@ BOOST_AUTO_TEST_CASE(SaveHDF5Test)
   remove("test_file.hdf5");
   remove("test_file.he5");
 }
+
+/**
+ * Make sure a slab of an HDF5 dataset can be loaded by itself.
+ */
+BOOST_AUTO_TEST_CASE(LoadHDF5SlabTest)
+{
+  // 6 dimensions, 25 points.
+  arma::mat dataset = arma::randu<arma::mat>(6, 25);
+  BOOST_REQUIRE(dataset.quiet_save("test_file.h5", arma::hdf5_binary) == true);
+
+  // Armadillo writes the matrix memory directly, so the on-disk (row-major)
+  // dataset has one point per row: dataset row i is dataset.col(i), and
+  // dataset column j is dataset.row(j).  Load points 5-14, dimensions 1-4.
+  arma::mat slab;
+  BOOST_REQUIRE(data::Load("test_file.h5", "dataset", slab, 5, 14, 1, 4)
+      == true);
+
+  BOOST_REQUIRE_EQUAL(slab.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(slab.n_cols, 10);
+
+  for (size_t j = 0; j < slab.n_cols; ++j)
+    for (size_t i = 0; i < slab.n_rows; ++i)
+      BOOST_REQUIRE_CLOSE(slab(i, j), dataset(i + 1, j + 5), 1e-8);
+
+  // The untransposed orientation should give the slab as stored on disk.
+  arma::mat rawSlab;
+  BOOST_REQUIRE(data::Load("test_file.h5", "dataset", rawSlab, 5, 14, 1, 4,
+      false, false) == true);
+
+  BOOST_REQUIRE_EQUAL(rawSlab.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(rawSlab.n_cols, 4);
+
+  for (size_t j = 0; j < rawSlab.n_cols; ++j)
+    for (size_t i = 0; i < rawSlab.n_rows; ++i)
+      BOOST_REQUIRE_CLOSE(rawSlab(i, j), dataset(j + 1, i + 5), 1e-8);
+
+  // A slab that runs past the dataset extent must fail.
+  arma::mat tooBig;
+  BOOST_REQUIRE(data::Load("test_file.h5", "dataset", tooBig, 5, 25, 1, 4)
+      == false);
+
+  // A missing dataset must fail.
+  BOOST_REQUIRE(data::Load("test_file.h5", "nonexistent", tooBig, 0, 1, 0, 1)
+      == false);
+
+  remove("test_file.h5");
+}
 #else
 /**
  * Ensure saving as HDF5 fails.
@@ -563,4 +610,191 @@ BOOST_AUTO_TEST_CASE(NormalizeLabelTest)
     BOOST_REQUIRE_EQUAL(randLabels[i], revertedLabels[i]);
 }
 
+/**
+ * Make sure a label mapping can be shared and extended across label vectors,
+ * such as a training set and a test set.
+ */
+BOOST_AUTO_TEST_CASE(NormalizeLabelSharedMappingTest)
+{
+  arma::ivec trainLabels("10 10 30 20 10 30");
+  arma::Col<size_t> trainNormalized;
+  arma::ivec mappings;
+
+  data::NormalizeLabels(trainLabels, trainNormalized, mappings);
+
+  BOOST_REQUIRE_EQUAL(mappings.n_elem, 3);
+
+  // The test set reuses the training dictionary; labels seen during training
+  // must keep their values, and the unseen label 40 must be appended.
+  arma::ivec testLabels("30 40 10 20");
+  arma::Col<size_t> testNormalized;
+
+  data::NormalizeLabels(testLabels, testNormalized, mappings, true);
+
+  BOOST_REQUIRE_EQUAL(mappings.n_elem, 4);
+  BOOST_REQUIRE_EQUAL(mappings[3], 40);
+  BOOST_REQUIRE_EQUAL(testNormalized[0], 2);
+  BOOST_REQUIRE_EQUAL(testNormalized[1], 3);
+  BOOST_REQUIRE_EQUAL(testNormalized[2], 0);
+  BOOST_REQUIRE_EQUAL(testNormalized[3], 1);
+
+  // Reverting through the shared dictionary must give the originals back.
+  arma::ivec revertedLabels;
+  data::RevertLabels(testNormalized, mappings, revertedLabels);
+
+  for (size_t i = 0; i < testLabels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(testLabels[i], revertedLabels[i]);
+}
+
+/**
+ * Make sure an mlpack native binary dataset round-trips exactly.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadNativeBinaryTest)
+{
+  arma::mat test;
+  test.randu(10, 500);
+
+  BOOST_REQUIRE(data::Save("test_file.mlb", test) == true);
+
+  arma::mat test2;
+  BOOST_REQUIRE(data::Load("test_file.mlb", test2) == true);
+
+  BOOST_REQUIRE_EQUAL(test2.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(test2.n_cols, 500);
+
+  // The format is lossless, so the values must match exactly.
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(test[i], test2[i]);
+
+  // Loading into a matrix of the wrong element type must fail.
+  arma::fmat test3;
+  BOOST_REQUIRE(data::Load("test_file.mlb", test3) == false);
+
+  // Remove the file.
+  remove("test_file.mlb");
+}
+
+#ifdef MLPACK_HAS_ZLIB
+/**
+ * Make sure a compressed mlpack native binary dataset round-trips exactly,
+ * and that compression actually shrinks a compressible payload.  The matrix
+ * is sized so that the payload spans more than one compression block.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadNativeBinaryCompressedTest)
+{
+  // Repeated columns compress well; 200 x 700 doubles is just over 1MB.
+  arma::mat test = arma::repmat(arma::randu<arma::mat>(200, 7), 1, 100);
+
+  BOOST_REQUIRE(data::Save("test_file.mlb", test, false, true, 6) == true);
+
+  arma::mat test2;
+  BOOST_REQUIRE(data::Load("test_file.mlb", test2) == true);
+
+  BOOST_REQUIRE_EQUAL(test2.n_rows, test.n_rows);
+  BOOST_REQUIRE_EQUAL(test2.n_cols, test.n_cols);
+
+  // Compression is lossless, so the values must match exactly.
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(test[i], test2[i]);
+
+  // The file must be smaller than the raw payload.
+  std::ifstream stream("test_file.mlb",
+      std::ifstream::in | std::ifstream::binary);
+  stream.seekg(0, std::ios::end);
+  BOOST_REQUIRE_LT((size_t) stream.tellg(),
+      test.n_elem * sizeof(double));
+  stream.close();
+
+  // Remove the file.
+  remove("test_file.mlb");
+}
+#endif
+
+/**
+ * Make sure the streaming loader yields the same points as a full load, batch
+ * by batch.
+ */
+BOOST_AUTO_TEST_CASE(StreamingLoaderTest)
+{
+  // Write a dataset whose size is not a multiple of the batch size.
+  arma::mat dataset;
+  dataset.randu(5, 237);
+  BOOST_REQUIRE(data::Save("test_stream_file.csv", dataset) == true);
+
+  data::StreamingLoader<> loader("test_stream_file.csv", 50);
+
+  arma::mat batch;
+  size_t point = 0;
+  while (loader.Next(batch))
+  {
+    BOOST_REQUIRE_EQUAL(batch.n_rows, 5);
+    for (size_t i = 0; i < batch.n_cols; ++i, ++point)
+      for (size_t j = 0; j < batch.n_rows; ++j)
+        BOOST_REQUIRE_CLOSE(batch(j, i), dataset(j, point), 1e-5);
+  }
+
+  BOOST_REQUIRE_EQUAL(point, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(loader.Dimensionality(), 5);
+
+  // A reset loader must yield the whole dataset again.
+  loader.Reset();
+  point = 0;
+  while (loader.Next(batch))
+    point += batch.n_cols;
+  BOOST_REQUIRE_EQUAL(point, dataset.n_cols);
+
+  // Remove the file.
+  remove("test_stream_file.csv");
+}
+
+/**
+ * Make sure a dataset written in batches by the streaming writer loads back
+ * identically to the original.
+ */
+BOOST_AUTO_TEST_CASE(StreamingWriterTest)
+{
+  arma::mat dataset;
+  dataset.randu(4, 237);
+
+  // Append the dataset in uneven batches; the destructor flushes the last
+  // pending batch.
+  {
+    data::StreamingWriter<> writer("test_stream_out.csv");
+    writer.Append(dataset.cols(0, 99));
+    writer.Append(dataset.cols(100, 199));
+    writer.Append(dataset.cols(200, 236));
+    BOOST_REQUIRE_EQUAL(writer.PointsWritten(), dataset.n_cols);
+  }
+
+  arma::mat reloaded;
+  BOOST_REQUIRE(data::Load("test_stream_out.csv", reloaded) == true);
+
+  BOOST_REQUIRE_EQUAL(reloaded.n_rows, dataset.n_rows);
+  BOOST_REQUIRE_EQUAL(reloaded.n_cols, dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(reloaded[i], dataset[i], 1e-8);
+
+  // Integral matrices (neighbor indices, say) must round-trip exactly.
+  arma::Mat<size_t> indices(3, 50);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    indices[i] = i * 7;
+
+  {
+    data::StreamingWriter<size_t> writer("test_stream_out.csv");
+    writer.Append(indices.cols(0, 24));
+    writer.Append(indices.cols(25, 49));
+  }
+
+  arma::Mat<size_t> reloadedIndices;
+  BOOST_REQUIRE(data::Load("test_stream_out.csv", reloadedIndices) == true);
+
+  BOOST_REQUIRE_EQUAL(reloadedIndices.n_rows, indices.n_rows);
+  BOOST_REQUIRE_EQUAL(reloadedIndices.n_cols, indices.n_cols);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(reloadedIndices[i], indices[i]);
+
+  // Remove the file.
+  remove("test_stream_out.csv");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -29,7 +29,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionEvaluate)
   arma::vec responses("1 1 0");
 
   // Create a LogisticRegressionFunction.
-  LogisticRegressionFunction lrf(data, responses, 0.0 /* no regularization */);
+  LogisticRegressionFunction<> lrf(data, responses,
+      0.0 /* no regularization */);
 
   // These were hand-calculated using Octave.
   BOOST_REQUIRE_CLOSE(lrf.Evaluate(arma::vec("1 1 1")), 7.0562141665, 1e-5);
@@ -57,7 +58,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRandomEvaluate)
   for (size_t i = 0; i < points; ++i)
     responses[i] = math::RandInt(0, 2);
 
-  LogisticRegressionFunction lrf(data, responses, 0.0 /* no regularization */);
+  LogisticRegressionFunction<> lrf(data, responses,
+      0.0 /* no regularization */);
 
   // Run a bunch of trials.
   for (size_t i = 0; i < trials; ++i)
@@ -99,9 +101,9 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationEvaluate)
   for (size_t i = 0; i < points; ++i)
     responses[i] = math::RandInt(0, 2);
 
-  LogisticRegressionFunction lrfNoReg(data, responses, 0.0);
-  LogisticRegressionFunction lrfSmallReg(data, responses, 0.5);
-  LogisticRegressionFunction lrfBigReg(data, responses, 20.0);
+  LogisticRegressionFunction<> lrfNoReg(data, responses, 0.0);
+  LogisticRegressionFunction<> lrfSmallReg(data, responses, 0.5);
+  LogisticRegressionFunction<> lrfBigReg(data, responses, 20.0);
 
   for (size_t i = 0; i < trials; ++i)
   {
@@ -133,7 +135,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionGradient)
   arma::vec responses("1 1 0");
 
   // Create a LogisticRegressionFunction.
-  LogisticRegressionFunction lrf(data, responses, 0.0 /* no regularization */);
+  LogisticRegressionFunction<> lrf(data, responses,
+      0.0 /* no regularization */);
   arma::vec gradient;
 
   // If the model is at the optimum, then the gradient should be zero.
@@ -182,7 +185,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSeparableEvaluate)
   arma::vec responses("1 1 0");
 
   // Create a LogisticRegressionFunction.
-  LogisticRegressionFunction lrf(data, responses, 0.0 /* no regularization */);
+  LogisticRegressionFunction<> lrf(data, responses,
+      0.0 /* no regularization */);
 
   // These were hand-calculated using Octave.
   BOOST_REQUIRE_CLOSE(lrf.Evaluate(arma::vec("1 1 1"), 0), 4.85873516e-2, 1e-5);
@@ -231,9 +235,9 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationSeparableEvaluate)
   for (size_t i = 0; i < points; ++i)
     responses[i] = math::RandInt(0, 2);
 
-  LogisticRegressionFunction lrfNoReg(data, responses, 0.0);
-  LogisticRegressionFunction lrfSmallReg(data, responses, 0.5);
-  LogisticRegressionFunction lrfBigReg(data, responses, 20.0);
+  LogisticRegressionFunction<> lrfNoReg(data, responses, 0.0);
+  LogisticRegressionFunction<> lrfSmallReg(data, responses, 0.5);
+  LogisticRegressionFunction<> lrfBigReg(data, responses, 20.0);
 
   // Check that the number of functions is correct.
   BOOST_REQUIRE_EQUAL(lrfNoReg.NumFunctions(), points);
@@ -273,7 +277,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSeparableGradient)
   arma::vec responses("1 1 0");
 
   // Create a LogisticRegressionFunction.
-  LogisticRegressionFunction lrf(data, responses, 0.0 /* no regularization */);
+  LogisticRegressionFunction<> lrf(data, responses,
+      0.0 /* no regularization */);
   arma::vec gradient;
 
   // If the model is at the optimum, then the gradient should be zero.
@@ -354,9 +359,9 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationGradient)
   for (size_t i = 0; i < points; ++i)
     responses[i] = math::RandInt(0, 2);
 
-  LogisticRegressionFunction lrfNoReg(data, responses, 0.0);
-  LogisticRegressionFunction lrfSmallReg(data, responses, 0.5);
-  LogisticRegressionFunction lrfBigReg(data, responses, 20.0);
+  LogisticRegressionFunction<> lrfNoReg(data, responses, 0.0);
+  LogisticRegressionFunction<> lrfSmallReg(data, responses, 0.5);
+  LogisticRegressionFunction<> lrfBigReg(data, responses, 20.0);
 
   for (size_t i = 0; i < trials; ++i)
   {
@@ -416,9 +421,9 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationSeparableGradient)
   for (size_t i = 0; i < points; ++i)
     responses[i] = math::RandInt(0, 2);
 
-  LogisticRegressionFunction lrfNoReg(data, responses, 0.0);
-  LogisticRegressionFunction lrfSmallReg(data, responses, 0.5);
-  LogisticRegressionFunction lrfBigReg(data, responses, 20.0);
+  LogisticRegressionFunction<> lrfNoReg(data, responses, 0.0);
+  LogisticRegressionFunction<> lrfSmallReg(data, responses, 0.5);
+  LogisticRegressionFunction<> lrfBigReg(data, responses, 20.0);
 
   for (size_t i = 0; i < trials; ++i)
   {
@@ -465,6 +470,52 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationSeparableGradient)
   }
 }
 
+/**
+ * Test that the mini-batch Evaluate() and Gradient() overloads decompose the
+ * full-batch objective and gradient, even with uneven batch sizes and
+ * regularization.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionBatchEvaluateGradient)
+{
+  const size_t points = 1000;
+  const size_t dimension = 10;
+  const size_t batchSize = 128; // Does not evenly divide the dataset.
+
+  // Create a random dataset.
+  arma::mat data;
+  data.randu(dimension, points);
+  // Create random responses.
+  arma::vec responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  arma::vec parameters(dimension + 1);
+  parameters.randu();
+
+  // Accumulate the objective and gradient over all batches.
+  double batchObjective = 0.0;
+  arma::mat batchTotalGradient = arma::zeros<arma::mat>(dimension + 1, 1);
+  arma::mat batchGradient;
+  for (size_t begin = 0; begin < points; begin += batchSize)
+  {
+    const size_t size = std::min(batchSize, points - begin);
+
+    batchObjective += lrf.Evaluate(parameters, begin, size);
+
+    lrf.Gradient(parameters, begin, size, batchGradient);
+    batchTotalGradient += batchGradient;
+  }
+
+  BOOST_REQUIRE_CLOSE(batchObjective, lrf.Evaluate(parameters), 1e-5);
+
+  arma::mat gradient;
+  lrf.Gradient(parameters, gradient);
+  for (size_t j = 0; j < gradient.n_elem; ++j)
+    BOOST_REQUIRE_CLOSE(batchTotalGradient[j], gradient[j], 1e-5);
+}
+
 // Test training of logistic regression on a simple dataset.
 BOOST_AUTO_TEST_CASE(LogisticRegressionLBFGSSimpleTest)
 {
@@ -497,8 +548,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSGDSimpleTest)
 
   // Create a logistic regression object using a custom SGD object with a much
   // smaller tolerance.
-  LogisticRegressionFunction lrf(data, responses, 0.001);
-  SGD<LogisticRegressionFunction> sgd(lrf, 0.005, 500000, 1e-10);
+  LogisticRegressionFunction<> lrf(data, responses, 0.001);
+  SGD<LogisticRegressionFunction<> > sgd(lrf, 0.005, 500000, 1e-10);
   LogisticRegression<SGD> lr(sgd);
 
   // Test sigmoid function.
@@ -546,8 +597,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSGDRegularizationSimpleTest)
 
   // Create a logistic regression object using custom SGD with a much smaller
   // tolerance.
-  LogisticRegressionFunction lrf(data, responses, 0.001);
-  SGD<LogisticRegressionFunction> sgd(lrf, 0.005, 500000, 1e-10);
+  LogisticRegressionFunction<> lrf(data, responses, 0.001);
+  SGD<LogisticRegressionFunction<> > sgd(lrf, 0.005, 500000, 1e-10);
   LogisticRegression<SGD> lr(sgd);
 
   // Test sigmoid function.
@@ -666,8 +717,8 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionInstantiatedOptimizer)
   arma::vec responses("1 1 0");
 
   // Create an optimizer and function.
-  LogisticRegressionFunction lrf(data, responses, 0.0005);
-  L_BFGS<LogisticRegressionFunction> lbfgsOpt(lrf);
+  LogisticRegressionFunction<> lrf(data, responses, 0.0005);
+  L_BFGS<LogisticRegressionFunction<> > lbfgsOpt(lrf);
   lbfgsOpt.MinGradientNorm() = 1e-50;
   LogisticRegression<L_BFGS> lr(lbfgsOpt);
 
@@ -681,7 +732,7 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionInstantiatedOptimizer)
   BOOST_REQUIRE_SMALL(sigmoids[2], 0.1);
 
   // Now do the same with SGD.
-  SGD<LogisticRegressionFunction> sgdOpt(lrf);
+  SGD<LogisticRegressionFunction<> > sgdOpt(lrf);
   sgdOpt.StepSize() = 0.15;
   sgdOpt.Tolerance() = 1e-75;
   LogisticRegression<SGD> lr2(sgdOpt);
@@ -696,4 +747,80 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionInstantiatedOptimizer)
   BOOST_REQUIRE_SMALL(sigmoids[2], 0.1);
 }
 
+/**
+ * Test that the sparse specialization of LogisticRegressionFunction gives the
+ * same objective and gradients as the dense implementation on the same data.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSparseEvaluateGradient)
+{
+  // Generate a mostly-sparse random dataset.
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  for (size_t i = 0; i < data.n_elem; ++i)
+    if (data[i] < 0.7)
+      data[i] = 0.0;
+  arma::sp_mat sparseData(data);
+
+  arma::vec responses(50);
+  for (size_t i = 0; i < 50; ++i)
+    responses[i] = math::RandInt(0, 2);
+
+  const arma::mat parameters = arma::randu<arma::mat>(11, 1);
+
+  // Without regularization, every overload must agree exactly.
+  LogisticRegressionFunction<> lrf(data, responses, 0.0);
+  LogisticRegressionFunction<arma::sp_mat> sparseLrf(sparseData, responses,
+      0.0);
+
+  BOOST_REQUIRE_CLOSE(lrf.Evaluate(parameters), sparseLrf.Evaluate(parameters),
+      1e-8);
+
+  arma::mat gradient, sparseGradient;
+  lrf.Gradient(parameters, gradient);
+  sparseLrf.Gradient(parameters, sparseGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(gradient[i], sparseGradient[i], 1e-8);
+
+  for (size_t i = 0; i < 50; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(lrf.Evaluate(parameters, i),
+        sparseLrf.Evaluate(parameters, i), 1e-8);
+
+    lrf.Gradient(parameters, i, gradient);
+    sparseLrf.Gradient(parameters, i, sparseGradient);
+    for (size_t j = 0; j < gradient.n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(gradient[j], sparseGradient[j], 1e-8);
+
+    // The sparse gradient overload must hold the same values, and only the
+    // intercept and the active coordinates of the point may be nonzero.
+    arma::sp_mat pointGradient;
+    sparseLrf.Gradient(parameters, i, pointGradient);
+    for (size_t j = 0; j < gradient.n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(gradient[j], (double) pointGradient(j, 0), 1e-8);
+    for (size_t j = 1; j < gradient.n_elem; ++j)
+      if (data(j - 1, i) == 0.0)
+        BOOST_REQUIRE_EQUAL((double) pointGradient(j, 0), 0.0);
+  }
+
+  // With regularization, the full-batch and mini-batch overloads use the
+  // exact regularizer and must still agree with the dense implementation.
+  LogisticRegressionFunction<> lrfReg(data, responses, 0.5);
+  LogisticRegressionFunction<arma::sp_mat> sparseLrfReg(sparseData, responses,
+      0.5);
+
+  BOOST_REQUIRE_CLOSE(lrfReg.Evaluate(parameters),
+      sparseLrfReg.Evaluate(parameters), 1e-8);
+  BOOST_REQUIRE_CLOSE(lrfReg.Evaluate(parameters, 10, 25),
+      sparseLrfReg.Evaluate(parameters, 10, 25), 1e-8);
+
+  lrfReg.Gradient(parameters, gradient);
+  sparseLrfReg.Gradient(parameters, sparseGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(gradient[i], sparseGradient[i], 1e-8);
+
+  lrfReg.Gradient(parameters, 10, 25, gradient);
+  sparseLrfReg.Gradient(parameters, 10, 25, sparseGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(gradient[i], sparseGradient[i], 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
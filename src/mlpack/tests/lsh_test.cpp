@@ -108,4 +108,158 @@ BOOST_AUTO_TEST_CASE(LSHSearchTest)
   }
 }
 
+/**
+ * Test that points inserted into a live index are found by later searches.
+ */
+BOOST_AUTO_TEST_CASE(LSHInsertTest)
+{
+  arma::mat dataset(10, 200);
+  dataset.randu();
+  const size_t oldSize = dataset.n_cols;
+
+  LSHSearch<> lsh(dataset, 4, 10);
+
+  // Insert exact duplicates of the first five points; a duplicate hashes to
+  // the same bucket as its original in every table, so each pair must find
+  // the other at distance zero.
+  arma::mat duplicates = dataset.cols(0, 4);
+  lsh.Insert(duplicates);
+
+  // The reference set grows in place.
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, oldSize + 5);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(1, neighbors, distances);
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(0, i), oldSize + i);
+    BOOST_REQUIRE_SMALL(distances(0, i), 1e-10);
+    BOOST_REQUIRE_EQUAL(neighbors(0, oldSize + i), i);
+    BOOST_REQUIRE_SMALL(distances(0, oldSize + i), 1e-10);
+  }
+}
+
+/**
+ * The additional probing bins must be the query's key perturbed by the
+ * cheapest valid perturbation sets, in order of increasing score, and sets
+ * that perturb the same dimension twice must be rejected.
+ */
+BOOST_AUTO_TEST_CASE(LSHMultiprobeBinTest)
+{
+  arma::mat dataset(2, 10);
+  dataset.randu();
+
+  // Two projections per table, so there are four possible perturbation
+  // actions (each of the two key dimensions, up or down).
+  LSHSearch<> lsh(dataset, 2, 1);
+
+  // The query projects to (2.9, 3.4), so its own key is (2, 3).  The action
+  // scores are the squared distances to the crossed boundaries:
+  //   dim 0 up: 0.01   dim 1 down: 0.16   dim 1 up: 0.36   dim 0 down: 0.81
+  // and so the perturbation sets in order of increasing total score are
+  //   {0 up}            -> (3, 3)   score 0.01
+  //   {1 down}          -> (2, 2)   score 0.16
+  //   {0 up, 1 down}    -> (3, 2)   score 0.17
+  //   {1 up}            -> (2, 4)   score 0.36
+  //   {0 up, 1 up}      -> (3, 4)   score 0.37
+  //   {0 down}          -> (1, 3)   score 0.81
+  // The sets {1 down, 1 up} (score 0.52) and {0 up, 1 down, 1 up} (score
+  // 0.53) perturb dimension 1 twice and must be skipped.
+  arma::vec queryCode = "2 3";
+  arma::vec queryCodeNotFloored = "2.9 3.4";
+
+  arma::mat bins;
+  lsh.GetAdditionalProbingBins(queryCode, queryCodeNotFloored, 6, bins);
+
+  BOOST_REQUIRE_EQUAL(bins.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(bins.n_cols, 6);
+
+  arma::mat trueBins(2, 6);
+  trueBins << 3 << 2 << 3 << 2 << 3 << 1 << arma::endr
+           << 3 << 2 << 2 << 4 << 4 << 3 << arma::endr;
+
+  for (size_t p = 0; p < 6; ++p)
+    for (size_t j = 0; j < 2; ++j)
+      BOOST_REQUIRE_CLOSE(bins(j, p), trueBins(j, p), 1e-10);
+}
+
+/**
+ * Count how many of the true nearest neighbors appear anywhere in the
+ * returned neighbor lists.
+ */
+size_t FoundNeighbors(const arma::Mat<size_t>& found,
+                      const arma::Mat<size_t>& exact)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < exact.n_cols; ++i)
+  {
+    for (size_t j = 0; j < exact.n_rows; ++j)
+    {
+      for (size_t l = 0; l < found.n_rows; ++l)
+      {
+        if (found(l, i) == exact(j, i))
+        {
+          ++count;
+          break;
+        }
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * With the same tables, multi-probe search inspects a superset of the buckets
+ * that single-bucket search inspects, so every returned distance can only get
+ * better and the recall against the exact neighbors can only grow.
+ */
+BOOST_AUTO_TEST_CASE(LSHMultiprobeRecallTest)
+{
+  math::RandomSeed(42);
+
+  arma::mat dataset(8, 500);
+  dataset.randu();
+  const size_t k = 5;
+
+  // Compute the exact nearest neighbors by brute force, to measure recall
+  // against.
+  arma::Mat<size_t> exact(k, dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    arma::vec pointDistances(dataset.n_cols);
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      pointDistances[j] = metric::SquaredEuclideanDistance::Evaluate(
+          dataset.unsafe_col(i), dataset.unsafe_col(j));
+    pointDistances[i] = arma::datum::inf; // Exclude the point itself.
+
+    arma::uvec sorted = arma::sort_index(pointDistances);
+    for (size_t j = 0; j < k; ++j)
+      exact(j, i) = sorted[j];
+  }
+
+  // Few tables, so that single-bucket probing misses some true neighbors and
+  // multi-probe has room to improve.
+  LSHSearch<> lsh(dataset, 10, 4);
+
+  arma::Mat<size_t> neighbors, probeNeighbors;
+  arma::mat distances, probeDistances;
+  lsh.Search(k, neighbors, distances, 0, 0);
+  lsh.Search(k, probeNeighbors, probeDistances, 0, 10);
+
+  // The multi-probe candidate set of each query is a superset of the
+  // single-bucket candidate set, so at every rank the returned distance is at
+  // least as good.
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < k; ++j)
+      BOOST_REQUIRE_LE(probeDistances(j, i), distances(j, i));
+
+  // For the same reason, a true neighbor found without probes can only be
+  // displaced by another true neighbor, so the recall cannot drop.
+  const size_t recall = FoundNeighbors(neighbors, exact);
+  const size_t probeRecall = FoundNeighbors(probeNeighbors, exact);
+  BOOST_REQUIRE_GE(probeRecall, recall);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
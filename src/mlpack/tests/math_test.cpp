@@ -5,6 +5,7 @@
  * Tests for everything in the math:: namespace.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/coreset.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <boost/test/unit_test.hpp>
@@ -578,4 +579,100 @@ BOOST_AUTO_TEST_CASE(RangeContainsRange)
   BOOST_REQUIRE_EQUAL(b.Contains(a), true);
 }
 
+/**
+ * Basic sanity check that the single-precision instantiation of RangeType
+ * behaves like the double-precision Range.
+ */
+BOOST_AUTO_TEST_CASE(FloatRangeTest)
+{
+  math::RangeType<float> x(0.0f, 2.0f);
+  math::RangeType<float> y(1.0f, 3.0f);
+
+  BOOST_REQUIRE_CLOSE(x.Width(), 2.0f, 1e-5);
+  BOOST_REQUIRE_CLOSE(x.Mid(), 1.0f, 1e-5);
+  BOOST_REQUIRE_EQUAL(x.Contains(y), true);
+
+  x |= y;
+
+  BOOST_REQUIRE_CLOSE(x.Lo(), 0.0f, 1e-5);
+  BOOST_REQUIRE_CLOSE(x.Hi(), 3.0f, 1e-5);
+
+  // An empty float range should contain nothing.
+  math::RangeType<float> z;
+  BOOST_REQUIRE_EQUAL(z.Contains(0.0f), false);
+}
+
+/**
+ * Sanity check for the batched random number generation functions: the output
+ * must have the requested size and every value must lie in the requested
+ * range.
+ */
+BOOST_AUTO_TEST_CASE(RandomVecTest)
+{
+  arma::vec values;
+  math::RandomVec(1000, values);
+  BOOST_REQUIRE_EQUAL(values.n_elem, 1000);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    BOOST_REQUIRE_GE(values[i], 0.0);
+    BOOST_REQUIRE_LT(values[i], 1.0);
+  }
+
+  math::RandomVec(3.0, 7.0, 1000, values);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    BOOST_REQUIRE_GE(values[i], 3.0);
+    BOOST_REQUIRE_LT(values[i], 7.0);
+  }
+
+  arma::Col<size_t> ints;
+  math::RandIntVec(10, 1000, ints);
+  BOOST_REQUIRE_EQUAL(ints.n_elem, 1000);
+  for (size_t i = 0; i < ints.n_elem; ++i)
+    BOOST_REQUIRE_LT(ints[i], 10);
+
+  // The normal batch has no hard range, but it should at least produce both
+  // signs over a large sample.
+  math::RandNormalVec(1000, values);
+  BOOST_REQUIRE_EQUAL(values.n_elem, 1000);
+  BOOST_REQUIRE_LT(values.min(), 0.0);
+  BOOST_REQUIRE_GT(values.max(), 0.0);
+}
+
+/**
+ * Sanity checks for sensitivity-sampled coresets: the coreset has the
+ * requested size, the weights are positive and bounded (every sampling
+ * probability is at least 1/(2n), so no weight exceeds 2n / coresetSize and
+ * the weights sum to at most 2n), and asking for a coreset no smaller than
+ * the dataset returns the dataset with unit weights.
+ */
+BOOST_AUTO_TEST_CASE(CoresetTest)
+{
+  arma::mat dataset(5, 1000);
+  dataset.randu();
+
+  arma::mat coreset;
+  arma::vec weights;
+  math::Coreset(dataset, 100, coreset, weights);
+
+  BOOST_REQUIRE_EQUAL(coreset.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(coreset.n_cols, 100);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 100);
+  for (size_t i = 0; i < weights.n_elem; ++i)
+  {
+    BOOST_REQUIRE_GT(weights[i], 0.0);
+    BOOST_REQUIRE_LE(weights[i], 2.0 * 1000 / 100 + 1e-10);
+  }
+  BOOST_REQUIRE_LE(arma::accu(weights), 2.0 * 1000 + 1e-10);
+
+  // A coreset at least as large as the dataset is the dataset itself.
+  math::Coreset(dataset, 1500, coreset, weights);
+  BOOST_REQUIRE_EQUAL(coreset.n_cols, 1000);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 1000);
+  for (size_t i = 0; i < weights.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(weights[i], 1.0);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(coreset[i], dataset[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -4,7 +4,9 @@
  * Unit tests for the 'LMetric' class.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/metrics/fixed_dim_lmetric.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/ip_metric.hpp>
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
 
@@ -82,4 +84,51 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+BOOST_AUTO_TEST_CASE(FixedDimLMetricTest)
+{
+  arma::vec a(128);
+  a.randn();
+
+  arma::vec b(128);
+  b.randn();
+
+  // The fixed-dimension metric must agree with the generic one for each
+  // power and rooting option.
+  BOOST_REQUIRE_CLOSE((FixedDimLMetric<128, 1, false>::Evaluate(a, b)),
+                      (LMetric<1, false>::Evaluate(a, b)), 1e-5);
+  BOOST_REQUIRE_CLOSE((FixedDimLMetric<128, 2, false>::Evaluate(a, b)),
+                      (LMetric<2, false>::Evaluate(a, b)), 1e-5);
+  BOOST_REQUIRE_CLOSE((FixedDimLMetric<128, 2, true>::Evaluate(a, b)),
+                      (LMetric<2, true>::Evaluate(a, b)), 1e-5);
+  BOOST_REQUIRE_CLOSE((FixedDimLMetric<128, 3, true>::Evaluate(a, b)),
+                      (LMetric<3, true>::Evaluate(a, b)), 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(IPMetricCacheTest)
+{
+  arma::mat dataset(5, 100);
+  dataset.randu();
+
+  mlpack::kernel::GaussianKernel gk(1.5);
+  IPMetric<mlpack::kernel::GaussianKernel> plain(gk);
+  IPMetric<mlpack::kernel::GaussianKernel> cached(gk);
+  cached.BindDataset(dataset);
+
+  // The cached metric must agree with the plain one, both between bound
+  // points and between a bound point and a foreign one.
+  arma::vec foreign(5);
+  foreign.randu();
+  for (size_t i = 0; i < 20; ++i)
+  {
+    const size_t a = mlpack::math::RandInt(dataset.n_cols);
+    const size_t b = mlpack::math::RandInt(dataset.n_cols);
+
+    BOOST_REQUIRE_CLOSE(
+        cached.Evaluate(dataset.unsafe_col(a), dataset.unsafe_col(b)),
+        plain.Evaluate(dataset.unsafe_col(a), dataset.unsafe_col(b)), 1e-10);
+    BOOST_REQUIRE_CLOSE(cached.Evaluate(dataset.unsafe_col(a), foreign),
+        plain.Evaluate(dataset.unsafe_col(a), foreign), 1e-10);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -122,4 +122,107 @@ BOOST_AUTO_TEST_CASE(NaiveBayesClassifierIncrementalTest)
     BOOST_REQUIRE_EQUAL(testRes(i), calcVec(i));
 }
 
+// Train on the first half of the dataset at construction time, and fold in
+// the second half with Update() and UpdateBatch(); the result should match a
+// classifier trained on the whole dataset at once.
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierUpdateTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData;
+  data::Load(trainFilename, trainData, true);
+
+  // Get the labels out.
+  arma::Col<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  // Train on the full dataset at once, for reference.
+  NaiveBayesClassifier<> nbcFull(trainData, labels, classes);
+
+  // Train on the first half, then stream in the rest.
+  const size_t half = trainData.n_cols / 2;
+  arma::mat firstHalf = trainData.cols(0, half - 1);
+  arma::Col<size_t> firstLabels = labels.subvec(0, half - 1);
+
+  NaiveBayesClassifier<> nbcStream(firstHalf, firstLabels, classes);
+
+  // Stream in the third quarter point-by-point, and the rest as a batch.
+  const size_t threeQuarters = half + (trainData.n_cols - half) / 2;
+  for (size_t i = half; i < threeQuarters; ++i)
+    nbcStream.Update(trainData.col(i), labels[i]);
+
+  arma::mat lastBatch = trainData.cols(threeQuarters, trainData.n_cols - 1);
+  arma::Col<size_t> lastLabels = labels.subvec(threeQuarters,
+      trainData.n_cols - 1);
+  nbcStream.UpdateBatch(lastBatch, lastLabels);
+
+  // The streamed model should agree with the batch model.
+  for (size_t i = 0; i < classes; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(nbcStream.Probabilities()[i],
+        nbcFull.Probabilities()[i], 1e-5);
+    for (size_t j = 0; j < trainData.n_rows; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(nbcStream.Means()(j, i), nbcFull.Means()(j, i),
+          1e-5);
+      BOOST_REQUIRE_CLOSE(nbcStream.Variances()(j, i),
+          nbcFull.Variances()(j, i), 1e-5);
+    }
+  }
+}
+
+// Classify twice into the same preallocated results vector, updating the
+// model in between; the cached classification quantities must be refreshed
+// after the update, so the second call should agree with a freshly-trained
+// classifier.
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierCachedClassifyTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  const char* testFilename = "testSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData;
+  data::Load(trainFilename, trainData, true);
+
+  // Get the labels out.
+  arma::Col<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load(testFilename, testData, true);
+  testData.shed_row(testData.n_rows - 1); // Remove the labels.
+
+  // Train on the first half, classify, then fold in the second half and
+  // classify again into the same (already correctly sized) results vector.
+  const size_t half = trainData.n_cols / 2;
+  arma::mat firstHalf = trainData.cols(0, half - 1);
+  arma::Col<size_t> firstLabels = labels.subvec(0, half - 1);
+
+  NaiveBayesClassifier<> nbcStream(firstHalf, firstLabels, classes);
+
+  arma::Col<size_t> results(testData.n_cols);
+  nbcStream.Classify(testData, results);
+
+  arma::mat secondHalf = trainData.cols(half, trainData.n_cols - 1);
+  arma::Col<size_t> secondLabels = labels.subvec(half, trainData.n_cols - 1);
+  nbcStream.UpdateBatch(secondHalf, secondLabels);
+
+  nbcStream.Classify(testData, results);
+
+  // The updated model should classify identically to one trained on the full
+  // dataset at once.
+  NaiveBayesClassifier<> nbcFull(trainData, labels, classes);
+  arma::Col<size_t> fullResults;
+  nbcFull.Classify(testData, fullResults);
+
+  BOOST_REQUIRE_EQUAL(results.n_elem, fullResults.n_elem);
+  for (size_t i = 0; i < results.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(results[i], fullResults[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -244,6 +244,44 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * Ensure the sampled (neighbor-based) objective is a good approximation of the
+ * exact objective when the neglected points are far away.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxSampledObjective)
+{
+  // Two well-separated clusters of three points each; the clusters are far
+  // enough apart that exp(-d^2) between them is effectively zero.
+  arma::mat data           = "-5.0 -5.1 -4.9  5.0  5.1  4.9;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Col<size_t> labels = " 0    0    0    1    1    1   ";
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sampledSef(data, labels);
+  sampledSef.NumNeighbors() = 4; // Each point neglects its farthest point.
+
+  arma::mat coordinates = arma::eye<arma::mat>(2, 2);
+  arma::mat gradient(2, 2);
+  arma::mat sampledGradient(2, 2);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(sampledSef.Evaluate(coordinates, i),
+        sef.Evaluate(coordinates, i), 1e-5);
+
+    sef.Gradient(coordinates, i, gradient);
+    sampledSef.Gradient(coordinates, i, sampledGradient);
+
+    for (size_t j = 0; j < gradient.n_elem; ++j)
+    {
+      if (std::abs(gradient[j]) < 1e-8)
+        BOOST_REQUIRE_SMALL(sampledGradient[j], 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(sampledGradient[j], gradient[j], 1e-5);
+    }
+  }
+}
+
 //
 // Tests for the NCA algorithm.
 //
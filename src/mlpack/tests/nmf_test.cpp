@@ -7,6 +7,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/init_rules/random_acol_init.hpp>
+#include <mlpack/methods/amf/init_rules/nndsvd_init.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
@@ -213,4 +214,33 @@ BOOST_AUTO_TEST_CASE(SparseNMFALSTest)
       1e-5);
 }
 
+/**
+ * Check the if the product of the calculated factorization is close to the
+ * input matrix. NNDSVD initialization distance minimization update.
+ */
+BOOST_AUTO_TEST_CASE(NMFNNDSVDDistTest)
+{
+  mlpack::math::RandomSeed(std::time(NULL));
+  mat w = randu<mat>(20, 12);
+  mat h = randu<mat>(12, 20);
+  mat v = w * h;
+  const size_t r = 12;
+
+  SimpleResidueTermination srt(1e-7, 10000);
+  AMF<SimpleResidueTermination, NNDSVDInitialization> nmf(srt);
+  nmf.Apply(v, r, w, h);
+
+  // The initialization must be strictly positive, so the multiplicative
+  // updates can reach every entry.
+  BOOST_REQUIRE_EQUAL(w.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(w.n_cols, r);
+  BOOST_REQUIRE_EQUAL(h.n_rows, r);
+  BOOST_REQUIRE_EQUAL(h.n_cols, 20);
+
+  mat wh = w * h;
+
+  BOOST_REQUIRE_SMALL(arma::norm(v - wh, "fro") / arma::norm(v, "fro"),
+      0.015);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,39 @@
+/**
+ * @file parallel_sgd_test.cpp
+ * @author Ryan Curtin
+ *
+ * Test file for ParallelSGD (lock-free parallel stochastic gradient descent).
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
+#include <mlpack/core/optimizers/sgd/test_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+using namespace std;
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+
+BOOST_AUTO_TEST_SUITE(ParallelSGDTest);
+
+// The individual functions of SGDTestFunction touch disjoint coordinates, so
+// the lock-free updates cannot collide and the parallel result should match
+// what serial SGD produces.
+BOOST_AUTO_TEST_CASE(SimpleParallelSGDTestFunction)
+{
+  SGDTestFunction f;
+  ParallelSGD<SGDTestFunction> s(f, 0.0003, 5000000, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(coordinates);
+
+  BOOST_REQUIRE_CLOSE(result, -1.0, 0.05);
+  BOOST_REQUIRE_SMALL(coordinates[0], 1e-3);
+  BOOST_REQUIRE_SMALL(coordinates[1], 1e-7);
+  BOOST_REQUIRE_SMALL(coordinates[2], 1e-7);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -6,6 +6,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
+#include <mlpack/methods/pca/incremental_pca.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
@@ -197,5 +198,128 @@ BOOST_AUTO_TEST_CASE(PCAScalingTest)
   BOOST_REQUIRE_CLOSE(accu(eigval), 3.0, 0.1); // 10% tolerance.
 }
 
+/**
+ * Test that the randomized decomposition recovers the components of a
+ * low-rank dataset.  The dataset has exact rank 5, so the randomized
+ * decomposition with rank 5 should agree with the full decomposition to
+ * numerical precision.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedPCATest)
+{
+  // Construct a dataset with exact rank 5.
+  mat data = randn<mat>(25, 5) * randn<mat>(5, 500);
+
+  // Run the full decomposition.
+  PCA exact;
+  mat exactScore, exactCoeff;
+  vec exactEigval;
+  exact.Apply(data, exactScore, exactEigval, exactCoeff);
+
+  // Now run the randomized decomposition with rank 5.
+  PCA randomized(false, 5);
+  mat score, coeff;
+  vec eigval;
+  randomized.Apply(data, score, eigval, coeff);
+
+  BOOST_REQUIRE_EQUAL(eigval.n_elem, 5);
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(eigval[i], exactEigval[i], 1e-5);
+
+    // The eigenvectors may point in opposite directions, so compare the
+    // absolute value of the dot product to 1.
+    const double dot = std::abs(arma::dot(coeff.col(i), exactCoeff.col(i)));
+    BOOST_REQUIRE_CLOSE(dot, 1.0, 1e-5);
+  }
+}
+
+/**
+ * Test that incremental PCA fed in batches agrees with batch PCA when the
+ * maintained rank covers the full dimensionality (then the truncation after
+ * each update discards nothing, so the decomposition is exact).
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAExactTest)
+{
+  mat data = randu<mat>(5, 500);
+
+  // Run the full batch decomposition.
+  PCA exact;
+  mat exactScore, exactCoeff;
+  vec exactEigval;
+  exact.Apply(data, exactScore, exactEigval, exactCoeff);
+
+  // Feed the same data to the incremental decomposition in uneven batches.
+  IncrementalPCA ipca(5);
+  ipca.Update(data.cols(0, 149));
+  ipca.Update(data.cols(150, 399));
+  ipca.Update(data.cols(400, 499));
+
+  BOOST_REQUIRE_EQUAL(ipca.NumPoints(), 500);
+
+  // The running mean must match the batch mean.
+  const vec batchMean = arma::mean(data, 1);
+  for (size_t i = 0; i < batchMean.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(ipca.Mean()[i], batchMean[i], 1e-8);
+
+  const vec eigval = ipca.Eigenvalues();
+  BOOST_REQUIRE_EQUAL(eigval.n_elem, 5);
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(eigval[i], exactEigval[i], 1e-5);
+
+    // The eigenvectors may point in opposite directions, so compare the
+    // absolute value of the dot product to 1.
+    const double dot = std::abs(arma::dot(ipca.Basis().col(i),
+        exactCoeff.col(i)));
+    BOOST_REQUIRE_CLOSE(dot, 1.0, 1e-5);
+  }
+
+  // The projections must also match, up to the same sign ambiguity.
+  mat score;
+  ipca.Transform(data, score);
+  BOOST_REQUIRE_EQUAL(score.n_rows, exactScore.n_rows);
+  BOOST_REQUIRE_EQUAL(score.n_cols, exactScore.n_cols);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    const double sign = (arma::dot(ipca.Basis().col(i), exactCoeff.col(i)) <
+        0.0) ? -1.0 : 1.0;
+    for (size_t j = 0; j < score.n_cols; j += 50)
+      BOOST_REQUIRE_CLOSE(sign * score(i, j), exactScore(i, j), 1e-5);
+  }
+}
+
+/**
+ * Test that incremental PCA with a truncated rank recovers the components of
+ * a low-rank dataset; the dataset has exact rank 3, so maintaining 3
+ * components discards nothing.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCALowRankTest)
+{
+  // Construct a dataset with exact rank 3.
+  mat data = randn<mat>(20, 3) * randn<mat>(3, 600);
+
+  PCA exact;
+  mat exactScore, exactCoeff;
+  vec exactEigval;
+  exact.Apply(data, exactScore, exactEigval, exactCoeff);
+
+  IncrementalPCA ipca(3);
+  for (size_t start = 0; start < 600; start += 200)
+    ipca.Update(data.cols(start, start + 199));
+
+  const vec eigval = ipca.Eigenvalues();
+  BOOST_REQUIRE_EQUAL(eigval.n_elem, 3);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(eigval[i], exactEigval[i], 1e-5);
+
+    const double dot = std::abs(arma::dot(ipca.Basis().col(i),
+        exactCoeff.col(i)));
+    BOOST_REQUIRE_CLOSE(dot, 1.0, 1e-5);
+  }
+}
 
 BOOST_AUTO_TEST_SUITE_END();
@@ -166,4 +166,32 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * The boosting constructor uses the epoch-batched training rule; with uniform
+ * instance weights it should still converge on a linearly separable dataset.
+ */
+BOOST_AUTO_TEST_CASE(BatchTrainingTwoPoints)
+{
+  mat trainData;
+  trainData << 0 << 1 << 1 << 4 << 5 << 4 << endr
+            << 1 << 0 << 1 << 1 << 1 << 2 << endr;
+
+  Mat<size_t> labels;
+  labels << 0 << 0 << 0 << 1 << 1 << 1;
+
+  Perceptron<> p(trainData, labels.row(0), 1000);
+
+  // Uniform instance weights.
+  rowvec weights(trainData.n_cols);
+  weights.fill(1.0);
+
+  Perceptron<> pBatch(p, trainData, weights, labels.row(0));
+
+  Row<size_t> predictedLabels(trainData.n_cols);
+  pBatch.Classify(trainData, predictedLabels);
+
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    BOOST_CHECK_EQUAL(predictedLabels(0, i), labels(0, i));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,49 @@
+#include <mlpack/core.hpp>
+#include <mlpack/methods/cf/svd_wrapper.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+BOOST_AUTO_TEST_SUITE(RandomizedSVDTest);
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::cf;
+using namespace arma;
+
+/**
+ * Test randomized SVD for low rank matrix factorization. The input matrix has
+ * exactly the requested rank, so the sampled subspace captures its range and
+ * the reconstruction error should be negligible.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDLowRankFactorizationTest)
+{
+  mat W_t = randu<mat>(100, 5);
+  mat H_t = randu<mat>(5, 80);
+
+  // create a low-rank matrix
+  mat test = W_t * H_t;
+
+  RandomizedSVDFactorizer svd(RandomizedSVD(5));
+  arma::mat W, H;
+  double result = svd.Apply(test, 5, W, H);
+
+  BOOST_REQUIRE_LT(result, 0.01);
+}
+
+/**
+ * Test that the randomized SVD falls back to the exact factorization when no
+ * rank is given.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDExactFallbackTest)
+{
+  mat test = randu<mat>(20, 20);
+
+  RandomizedSVDFactorizer svd;
+  arma::mat W, H, sigma;
+  double result = svd.Apply(test, W, sigma, H);
+
+  BOOST_REQUIRE_LT(result, 0.01);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
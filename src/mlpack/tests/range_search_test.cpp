@@ -1060,4 +1060,131 @@ BOOST_AUTO_TEST_CASE(DualBallTreeTest2)
   }
 }
 
+/**
+ * Ensure that the compact (CSR-style) result set gives exactly the same
+ * results as the classical vector-of-vectors output, both with one dataset
+ * (where both index mappings go through the reference permutation) and with
+ * a separate query set.
+ */
+BOOST_AUTO_TEST_CASE(CompactResultSetTest)
+{
+  arma::mat data;
+  data.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  arma::mat queries;
+  queries.randu(8, 350); // 350 points in 8 dimensions.
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    // First trial: one dataset; second trial: separate query set.
+    RangeSearch<>* rs;
+    if (trial == 0)
+      rs = new RangeSearch<>(data);
+    else
+      rs = new RangeSearch<>(data, queries);
+
+    const Range range(0.25, 1.05);
+
+    vector<vector<size_t> > neighbors;
+    vector<vector<double> > distances;
+    rs->Search(range, neighbors, distances);
+
+    CompactResultSet results;
+    rs->Search(range, results);
+
+    // The compact results must match the vector results exactly.
+    BOOST_REQUIRE_EQUAL(results.NumQueries(), neighbors.size());
+
+    // Turn the compact results into vectors, then sort both for comparison.
+    vector<vector<size_t> > compactNeighbors(results.NumQueries());
+    vector<vector<double> > compactDistances(results.NumQueries());
+    for (size_t i = 0; i < results.NumQueries(); ++i)
+    {
+      for (size_t j = 0; j < results.Count(i); ++j)
+      {
+        compactNeighbors[i].push_back(results.Neighbor(i, j));
+        compactDistances[i].push_back(results.Distance(i, j));
+      }
+    }
+
+    vector<vector<pair<double, size_t> > > sorted;
+    vector<vector<pair<double, size_t> > > compactSorted;
+    SortResults(neighbors, distances, sorted);
+    SortResults(compactNeighbors, compactDistances, compactSorted);
+
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(sorted[i].size(), compactSorted[i].size());
+
+      for (size_t j = 0; j < sorted[i].size(); ++j)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i][j].second, compactSorted[i][j].second);
+        BOOST_REQUIRE_CLOSE(sorted[i][j].first, compactSorted[i][j].first,
+            1e-5);
+      }
+    }
+
+    delete rs;
+  }
+}
+
+/**
+ * Ensure that the multi-radius search gives exactly the same results as one
+ * single-range search per radius band, in dual-tree, single-tree, and naive
+ * mode.
+ */
+BOOST_AUTO_TEST_CASE(MultiRadiusSearchTest)
+{
+  arma::mat data;
+  data.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  arma::mat queries;
+  queries.randu(8, 350); // 350 points in 8 dimensions.
+
+  vector<double> radii;
+  radii.push_back(0.4);
+  radii.push_back(0.8);
+  radii.push_back(1.3);
+
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    // First trial: dual-tree; second trial: single-tree; third trial: naive.
+    RangeSearch<> rs(data, queries, (trial == 2), (trial == 1));
+
+    vector<vector<vector<size_t> > > neighbors;
+    vector<vector<vector<double> > > distances;
+    rs.Search(radii, neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(neighbors.size(), radii.size());
+    BOOST_REQUIRE_EQUAL(distances.size(), radii.size());
+
+    // Each band must match a single-range search over the same band.
+    double lastRadius = 0.0;
+    for (size_t b = 0; b < radii.size(); ++b)
+    {
+      vector<vector<size_t> > bandNeighbors;
+      vector<vector<double> > bandDistances;
+      rs.Search(Range(lastRadius, radii[b]), bandNeighbors, bandDistances);
+      lastRadius = radii[b];
+
+      vector<vector<pair<double, size_t> > > sorted;
+      vector<vector<pair<double, size_t> > > bandSorted;
+      SortResults(neighbors[b], distances[b], sorted);
+      SortResults(bandNeighbors, bandDistances, bandSorted);
+
+      for (size_t i = 0; i < sorted.size(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i].size(), bandSorted[i].size());
+
+        for (size_t j = 0; j < sorted[i].size(); ++j)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[i][j].second, bandSorted[i][j].second);
+          BOOST_REQUIRE_CLOSE(sorted[i][j].first, bandSorted[i][j].first,
+              1e-5);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
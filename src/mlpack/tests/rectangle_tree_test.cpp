@@ -292,6 +292,62 @@ BOOST_AUTO_TEST_CASE(TreeLocalDatasetInSync)
   CheckSync(tree);
 }
 
+/**
+ * A function to count how many times each dataset index appears at a leaf of
+ * the tree.  It recurses so that it covers each node under (and including)
+ * this one.
+ *
+ * @param tree The tree to check.
+ * @param counts Vector of per-index counts to update.
+ */
+template<typename TreeType>
+void CountPointIndices(const TreeType& tree, std::vector<size_t>& counts)
+{
+  if (tree.IsLeaf())
+  {
+    for (size_t i = 0; i < tree.Count(); i++)
+      counts[tree.Points()[i]]++;
+  }
+  else
+  {
+    for (size_t i = 0; i < tree.NumChildren(); i++)
+      CountPointIndices(*tree.Children()[i], counts);
+  }
+}
+
+// Test that a bulk-loaded (STR-packed) tree holds every point exactly once
+// and satisfies the same containment and synchronization invariants as an
+// insertion-built tree.
+BOOST_AUTO_TEST_CASE(RectangleTreeBulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RectangleTree<
+      RTreeSplit<RTreeDescentHeuristic,
+                 NeighborSearchStat<NearestNeighborSort>,
+                 arma::mat>,
+      RTreeDescentHeuristic,
+      NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+
+  TreeType* tree = TreeType::BulkLoad(dataset, 20, 6, 5, 2, 0);
+
+  BOOST_REQUIRE_EQUAL(tree->NumDescendants(), 1000);
+  CheckContainment(*tree);
+  CheckExactContainment(*tree);
+  CheckHierarchy(*tree);
+  CheckSync(*tree);
+
+  // Each point must appear at exactly one leaf.
+  std::vector<size_t> counts(dataset.n_cols, 0);
+  CountPointIndices(*tree, counts);
+  for (size_t i = 0; i < counts.size(); i++)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  delete tree;
+}
+
 /**
  * A function to check that each of the fill requirements is met.  For a
  * non-leaf node:
@@ -578,6 +634,70 @@ BOOST_AUTO_TEST_CASE(PointDynamicAdd)
   }
 }
 
+// A test to ensure that buffered batch insertion produces a valid tree with
+// the same search results as a naive search.
+BOOST_AUTO_TEST_CASE(BufferedPointAdd)
+{
+  const int numIter = 200;
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RectangleTree<
+      RTreeSplit<RTreeDescentHeuristic,
+                 NeighborSearchStat<NearestNeighborSort>,
+                 arma::mat>,
+      RTreeDescentHeuristic,
+      NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, 20, 6, 5, 2, 0);
+
+  // Add numIter new points to the dataset through the insert buffer.
+  dataset.reshape(8, 1000 + numIter);
+  arma::mat tmpData;
+  tmpData.randu(8, numIter);
+  tree.InsertBufferCapacity() = 64;
+  for (int i = 0; i < numIter; i++)
+  {
+    dataset.col(1000 + i) = tmpData.col(i);
+    tree.BufferInsert(1000 + i);
+  }
+
+  // Any points remaining in the buffer must be flushed before querying.
+  tree.FlushInserts();
+  BOOST_REQUIRE_EQUAL(tree.InsertBufferSize(), 0);
+
+  // Do a few sanity checks.  Ensure the tree has the correct number of
+  // points, the tree has legal containment, and the tree's data is in sync.
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000 + numIter);
+  CheckContainment(tree);
+  CheckSync(tree);
+  CheckExactContainment(tree);
+
+  // Now we will compare the output of the R Tree vs the output of a naive
+  // search.
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  // Nearest neighbor search with the R tree.
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, TreeType>
+      allknn1(&tree, dataset, true);
+
+  allknn1.Search(5, neighbors1, distances1);
+
+  // Nearest neighbor search the naive way.
+  AllkNN allknn2(dataset, true, true);
+
+  allknn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+  }
+}
+
 // A test to ensure that the SingleTreeTraverser is working correctly by
 // comparing its results to the results of a naive search.
 BOOST_AUTO_TEST_CASE(SingleTreeTraverserTest)
@@ -623,6 +743,50 @@ BOOST_AUTO_TEST_CASE(SingleTreeTraverserTest)
   }
 }
 
+// A test to ensure that a tree built with the Hilbert split is valid and
+// returns correct neighbor search results, by comparing to a naive search.
+BOOST_AUTO_TEST_CASE(HilbertRTreeTraverserTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  typedef RectangleTree<
+      HilbertRTreeSplit<RTreeDescentHeuristic,
+                        NeighborSearchStat<NearestNeighborSort>,
+                        arma::mat>,
+      RTreeDescentHeuristic,
+      NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType hTree(dataset, 20, 6, 5, 2, 0);
+
+  // Nearest neighbor search with the Hilbert R tree.
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, TreeType>
+      allknn1(&hTree, dataset, true);
+
+  BOOST_REQUIRE_EQUAL(hTree.NumDescendants(), 1000);
+
+  CheckSync(hTree);
+  CheckContainment(hTree);
+  CheckExactContainment(hTree);
+  CheckHierarchy(hTree);
+
+  allknn1.Search(5, neighbors1, distances1);
+
+  // Nearest neighbor search the naive way.
+  AllkNN allknn2(dataset, true, true);
+
+  allknn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
 
 // A test to ensure that the SingleTreeTraverser is working correctly by
 // comparing its results to the results of a naive search.
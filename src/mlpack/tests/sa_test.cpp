@@ -68,6 +68,23 @@ BOOST_AUTO_TEST_CASE(RosenbrockTest)
   BOOST_REQUIRE_CLOSE(coordinates[1], 1.0, 1e-3);
 }
 
+// The parallel tempering mode should reach the same solution quality as the
+// single chain on the Rosenbrock function.
+BOOST_AUTO_TEST_CASE(RosenbrockTemperedTest)
+{
+  RosenbrockFunction f;
+  ExponentialSchedule schedule(1e-5);
+  SA<RosenbrockFunction>
+      sa(f, schedule, 10000000, 1000., 1000, 100, 1e-11, 3, 20, 0.3, 0.3);
+  arma::mat coordinates = f.GetInitialPoint();
+
+  const double result = sa.OptimizeTempered(coordinates, 4, 100, 2.0);
+
+  BOOST_REQUIRE_SMALL(result, 1e-6);
+  BOOST_REQUIRE_CLOSE(coordinates[0], 1.0, 1e-3);
+  BOOST_REQUIRE_CLOSE(coordinates[1], 1.0, 1e-3);
+}
+
 /**
  * The Rastigrin function, a (not very) simple nonconvex function.  It is
  * defined by
@@ -149,6 +149,45 @@ BOOST_AUTO_TEST_CASE(SaveArmaMat)
   delete sRM;
 }
 
+/**
+ * Test that the binary model format round-trips parameters, matrices, and
+ *   children exactly.
+ */
+BOOST_AUTO_TEST_CASE(SaveRestoreBinaryFormat)
+{
+  arma::mat matrix;
+  matrix.randu(10, 10);
+  size_t anInt = 42;
+
+  SaveRestoreUtility child;
+  child.SaveParameter(ARGSTR(matrix));
+
+  SaveRestoreUtility saver;
+  saver.SaveParameter(ARGSTR(anInt));
+  saver.AddChild(child, "child");
+
+  BOOST_REQUIRE(saver.WriteFile("test_model.bin"));
+
+  SaveRestoreUtility loader;
+  BOOST_REQUIRE(loader.ReadFile("test_model.bin"));
+
+  size_t anInt2 = 0;
+  anInt2 = loader.LoadParameter(anInt2, "anInt");
+  BOOST_REQUIRE_EQUAL(anInt2, anInt);
+
+  arma::mat matrix2;
+  matrix2 = loader.Children()["child"].LoadParameter(matrix2, "matrix");
+
+  BOOST_REQUIRE_EQUAL(matrix2.n_rows, matrix.n_rows);
+  BOOST_REQUIRE_EQUAL(matrix2.n_cols, matrix.n_cols);
+
+  // The binary format is lossless, so the values must match exactly.
+  for (size_t i = 0; i < matrix.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(matrix[i], matrix2[i]);
+
+  remove("test_model.bin");
+}
+
 /**
  * Test SaveRestoreModel proper usage in child classes and loading from
  *   separately defined objects
@@ -166,6 +166,79 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
   }
 }
 
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionBatchEvaluateGradient)
+{
+  const size_t points = 1000;
+  const size_t inputSize = 10;
+  const size_t numClasses = 5;
+  const size_t batchSize = 128; // Does not evenly divide the dataset.
+
+  // Initialize a random dataset.
+  arma::mat data;
+  data.randu(inputSize, points);
+
+  // Create random class labels.
+  arma::vec labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction srf(data, labels, inputSize, numClasses, 0.5);
+
+  // Create a random set of parameters.
+  arma::mat parameters;
+  parameters.randu(numClasses, inputSize);
+
+  // Accumulate the objective and gradient over all batches.
+  double batchObjective = 0.0;
+  arma::mat batchTotalGradient = arma::zeros<arma::mat>(numClasses, inputSize);
+  arma::mat batchGradient;
+  for (size_t begin = 0; begin < points; begin += batchSize)
+  {
+    const size_t size = std::min(batchSize, points - begin);
+
+    batchObjective += srf.Evaluate(parameters, begin, size);
+
+    srf.Gradient(parameters, begin, size, batchGradient);
+    batchTotalGradient += batchGradient;
+  }
+
+  BOOST_REQUIRE_CLOSE(batchObjective, srf.Evaluate(parameters), 1e-5);
+
+  arma::mat gradient;
+  srf.Gradient(parameters, gradient);
+  for (size_t j = 0; j < gradient.n_elem; ++j)
+    BOOST_REQUIRE_CLOSE(batchTotalGradient(j), gradient(j), 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionLargeLogitsEvaluate)
+{
+  const size_t points = 100;
+  const size_t inputSize = 10;
+  const size_t numClasses = 5;
+
+  // Initialize a random dataset.
+  arma::mat data;
+  data.randu(inputSize, points);
+
+  // Create random class labels.
+  arma::vec labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction srf(data, labels, inputSize, numClasses, 0);
+
+  // Use parameters large enough that exp() of the unshifted logits would
+  // overflow; the objective must still be finite.  The parameters of the
+  // classes are kept close together so that no class has probability zero.
+  arma::mat parameters;
+  parameters.randu(numClasses, inputSize);
+  parameters += 500.0;
+
+  const double objective = srf.Evaluate(parameters);
+  BOOST_REQUIRE_EQUAL(objective, objective); // Not NaN.
+  BOOST_REQUIRE_LT(objective, DBL_MAX); // Not infinite.
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTwoClasses)
 {
   const size_t points = 1000;
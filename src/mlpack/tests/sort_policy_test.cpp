@@ -54,6 +54,47 @@ BOOST_AUTO_TEST_CASE(NnsIsBetterNotStrict)
   BOOST_WARN(NearestNeighborSort::IsBetter(6.0, 6.0) == true);
 }
 
+/**
+ * Make sure the blocked candidate mask agrees with the scalar candidate test
+ * for nearest neighbors, including the equality case.
+ */
+BOOST_AUTO_TEST_CASE(NnsCandidateMask)
+{
+  const double values[5] = { 1.0, 6.0, 5.0, 7.0, 0.0 };
+  unsigned char mask[5];
+
+  const size_t passed = NearestNeighborSort::CandidateMask(values, 5, 5.0,
+      mask);
+
+  BOOST_REQUIRE_EQUAL(passed, 3);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    // A point passes exactly when the bound is not better than it.
+    const bool scalar = !NearestNeighborSort::IsBetter(5.0, values[i]);
+    BOOST_REQUIRE_EQUAL(mask[i] == 1, scalar);
+  }
+}
+
+/**
+ * Make sure the blocked candidate mask agrees with the scalar candidate test
+ * for furthest neighbors, including the equality case.
+ */
+BOOST_AUTO_TEST_CASE(FnsCandidateMask)
+{
+  const double values[5] = { 1.0, 6.0, 5.0, 7.0, 0.0 };
+  unsigned char mask[5];
+
+  const size_t passed = FurthestNeighborSort::CandidateMask(values, 5, 5.0,
+      mask);
+
+  BOOST_REQUIRE_EQUAL(passed, 3);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    const bool scalar = !FurthestNeighborSort::IsBetter(5.0, values[i]);
+    BOOST_REQUIRE_EQUAL(mask[i] == 1, scalar);
+  }
+}
+
 /**
  * A simple test case of where to insert when all the values in the list are
  * DBL_MAX.
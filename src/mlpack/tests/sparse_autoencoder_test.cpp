@@ -263,4 +263,47 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionBatchEvaluateGradient)
+{
+  const size_t points = 1000;
+  const size_t batchSize = 100;
+  const size_t vSize = 20;
+  const size_t hSize = 10;
+  const size_t l2 = vSize;
+  const size_t l3 = 2 * hSize;
+
+  // Initialize a random dataset.
+  arma::mat data;
+  data.randu(vSize, points);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 20, 20);
+
+  // Create a random set of parameters.
+  arma::mat parameters;
+  parameters.randu(l3 + 1, l2 + 1);
+
+  // A mini-batch covering the whole dataset must match the full-batch
+  // objective and gradient exactly.
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(parameters),
+      saf.Evaluate(parameters, 0, points), 1e-10);
+
+  arma::mat gradient, batchGradient;
+  saf.Gradient(parameters, gradient);
+  saf.Gradient(parameters, 0, points, batchGradient);
+
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(gradient[i] - batchGradient[i], 1e-12);
+
+  // The reconstruction error term is divided by the total number of points,
+  // so with the sparsity term disabled the mini-batch objectives must sum
+  // exactly to the full objective.
+  SparseAutoencoderFunction safNoKL(data, vSize, hSize, 20, 0);
+
+  double batchSum = 0.0;
+  for (size_t begin = 0; begin < points; begin += batchSize)
+    batchSum += safNoKL.Evaluate(parameters, begin, batchSize);
+
+  BOOST_REQUIRE_CLOSE(safNoKL.Evaluate(parameters), batchSum, 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,86 @@
+/**
+ * @file svrg_test.cpp
+ * @author Ryan Curtin
+ *
+ * Test file for SVRG (stochastic variance reduced gradient).
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/svrg/svrg.hpp>
+#include <mlpack/core/optimizers/lbfgs/test_functions.hpp>
+#include <mlpack/core/optimizers/sgd/test_function.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+using namespace std;
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(SVRGTest);
+
+BOOST_AUTO_TEST_CASE(SimpleSVRGTestFunction)
+{
+  SGDTestFunction f;
+  SVRG<SGDTestFunction> s(f, 0.0003, 5000000, 0, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(coordinates);
+
+  BOOST_REQUIRE_CLOSE(result, -1.0, 0.05);
+  BOOST_REQUIRE_SMALL(coordinates[0], 1e-3);
+  BOOST_REQUIRE_SMALL(coordinates[1], 1e-7);
+  BOOST_REQUIRE_SMALL(coordinates[2], 1e-7);
+}
+
+BOOST_AUTO_TEST_CASE(SVRGGeneralizedRosenbrockTest)
+{
+  // Loop over several variants.
+  for (size_t i = 10; i < 50; i += 5)
+  {
+    // Create the generalized Rosenbrock function.
+    GeneralizedRosenbrockFunction f(i);
+
+    SVRG<GeneralizedRosenbrockFunction> s(f, 0.001, 0, 0, 1e-15, true);
+
+    arma::mat coordinates = f.GetInitialPoint();
+    double result = s.Optimize(coordinates);
+
+    BOOST_REQUIRE_SMALL(result, 1e-10);
+    for (size_t j = 0; j < i; ++j)
+      BOOST_REQUIRE_CLOSE(coordinates[j], (double) 1.0, 1e-3);
+  }
+}
+
+/**
+ * Run SVRG on a convex objective (logistic regression), which is the case the
+ * variance reduction is designed for, and make sure the fitted model is
+ * correct.
+ */
+BOOST_AUTO_TEST_CASE(SVRGLogisticRegressionTest)
+{
+  // Very simple fake dataset.
+  arma::mat data("1 2 3;"
+                 "1 2 3");
+  arma::vec responses("1 1 0");
+
+  // Create a logistic regression object using a custom SVRG object with a
+  // much smaller tolerance.
+  LogisticRegressionFunction<> lrf(data, responses, 0.001);
+  SVRG<LogisticRegressionFunction<> > svrg(lrf, 0.005, 500000, 0, 1e-10);
+  LogisticRegression<SVRG> lr(svrg);
+
+  // Test sigmoid function.
+  arma::vec sigmoids = 1 / (1 + arma::exp(-lr.Parameters()[0]
+      - data.t() * lr.Parameters().subvec(1, lr.Parameters().n_elem - 1)));
+
+  // The tolerances here match the SGD test for the same dataset.
+  BOOST_REQUIRE_CLOSE(sigmoids[0], 1.0, 3.0);
+  BOOST_REQUIRE_CLOSE(sigmoids[1], 1.0, 12.0);
+  BOOST_REQUIRE_SMALL(sigmoids[2], 0.1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
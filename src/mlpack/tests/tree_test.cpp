@@ -9,6 +9,9 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/morton_order.hpp>
+#include <mlpack/core/tree/binary_space_tree/external_binary_space_tree.hpp>
+#include <mlpack/core/tree/tree_statistics.hpp>
 
 #include <queue>
 #include <stack>
@@ -22,8 +25,79 @@ using namespace mlpack::tree;
 using namespace mlpack::metric;
 using namespace mlpack::bound;
 
+/**
+ * A statistic that counts how many times its node constructor has run, used
+ * to test lazy statistic construction (see StatisticTraits).
+ */
+class CountingStatistic
+{
+ public:
+  CountingStatistic() : count(0) { }
+
+  template<typename TreeType>
+  CountingStatistic(TreeType& node) : count(node.Count())
+  {
+    ++constructions;
+  }
+
+  //! Get the number of points of the node this was constructed with.
+  size_t Count() const { return count; }
+
+  //! The number of times the node constructor has run, across all nodes.
+  static size_t constructions;
+
+ private:
+  size_t count;
+};
+
+size_t CountingStatistic::constructions = 0;
+
+namespace mlpack {
+namespace tree {
+
+//! Mark CountingStatistic as lazily built.
+template<>
+class StatisticTraits<CountingStatistic>
+{
+ public:
+  static const bool BuildLazily = true;
+};
+
+}; // namespace tree
+}; // namespace mlpack
+
 BOOST_AUTO_TEST_SUITE(TreeTest);
 
+/**
+ * Test that a lazily-built statistic is not constructed during tree building,
+ * and that it is constructed correctly on the first Stat() access.
+ */
+BOOST_AUTO_TEST_CASE(LazyStatisticTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 400);
+
+  CountingStatistic::constructions = 0;
+  BinarySpaceTree<HRectBound<2>, CountingStatistic> tree(dataset);
+
+  // Building the tree must not have constructed any statistics.
+  BOOST_REQUIRE_EQUAL(CountingStatistic::constructions, 0);
+
+  // The first touch builds the statistic for that node only.
+  BOOST_REQUIRE_EQUAL(tree.Stat().Count(), tree.Count());
+  BOOST_REQUIRE_EQUAL(CountingStatistic::constructions, 1);
+
+  // A second touch must not rebuild it.
+  tree.Stat();
+  BOOST_REQUIRE_EQUAL(CountingStatistic::constructions, 1);
+
+  // Touching a child builds only that child's statistic.
+  if (tree.Left() != NULL)
+  {
+    BOOST_REQUIRE_EQUAL(tree.Left()->Stat().Count(), tree.Left()->Count());
+    BOOST_REQUIRE_EQUAL(CountingStatistic::constructions, 2);
+  }
+}
+
 /**
  * Ensure that a bound, by default, is empty and has no dimensionality.
  */
@@ -575,6 +649,50 @@ BOOST_AUTO_TEST_CASE(HRectBoundOrOperatorBound)
   BOOST_REQUIRE_CLOSE(d.MinWidth(), 1.0, 1e-5);
 }
 
+/**
+ * Test that expanding a bound with a sparse matrix (or a column slice of one)
+ * gives the same bound as expanding with the densified matrix.
+ */
+BOOST_AUTO_TEST_CASE(HRectBoundOrOperatorSparseMatrix)
+{
+  // Generate sparse data with positive and negative nonzeros, an all-zero
+  // dimension, and a dimension with no zeros at all.
+  arma::mat data = arma::randu<arma::mat>(6, 50) - 0.5;
+  for (size_t i = 0; i < data.n_elem; ++i)
+    if (std::abs(data[i]) < 0.2)
+      data[i] = 0.0;
+  data.row(3).zeros();
+  data.row(4) += 2.0; // No zeros in this dimension.
+  arma::sp_mat sparseData(data);
+
+  HRectBound<2> b(6);
+  b |= sparseData;
+
+  HRectBound<2> d(6);
+  d |= data;
+
+  for (size_t i = 0; i < 6; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(b[i].Lo(), d[i].Lo(), 1e-10);
+    BOOST_REQUIRE_CLOSE(b[i].Hi(), d[i].Hi(), 1e-10);
+  }
+  BOOST_REQUIRE_CLOSE(b.MinWidth(), d.MinWidth(), 1e-10);
+
+  // Now the same with a contiguous column slice, as during tree construction.
+  HRectBound<2> bSub(6);
+  bSub |= sparseData.cols(10, 39);
+
+  HRectBound<2> dSub(6);
+  dSub |= data.cols(10, 39);
+
+  for (size_t i = 0; i < 6; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(bSub[i].Lo(), dSub[i].Lo(), 1e-10);
+    BOOST_REQUIRE_CLOSE(bSub[i].Hi(), dSub[i].Hi(), 1e-10);
+  }
+  BOOST_REQUIRE_CLOSE(bSub.MinWidth(), dSub.MinWidth(), 1e-10);
+}
+
 /**
  * Test that the Contains() function correctly figures out whether or not a
  * point is in a bound.
@@ -615,6 +733,34 @@ BOOST_AUTO_TEST_CASE(HRectBoundContains)
   BOOST_REQUIRE(b.Contains(point));
 }
 
+/**
+ * Test that a single-precision bound built from double-precision data rounds
+ * outward, so the stored bound still contains every point it was expanded
+ * with (and pruning with it stays conservative).
+ */
+BOOST_AUTO_TEST_CASE(HRectBoundNarrowedElemTypeTest)
+{
+  // Use values that are not exactly representable as floats, so every
+  // conversion is inexact.
+  arma::mat data(3, 50);
+  data.randu();
+  data += 0.1; // 0.1 is inexact in both precisions.
+  data *= M_PI;
+
+  HRectBound<2, true, float> b(3);
+  b |= data;
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE(b.Contains(data.col(i)));
+
+  // Each narrowed bound must enclose the exact extrema of the data.
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    BOOST_REQUIRE_LE((double) b[d].Lo(), min(data.row(d)));
+    BOOST_REQUIRE_GE((double) b[d].Hi(), max(data.row(d)));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestBallBound)
 {
   BallBound<> b1;
@@ -1322,6 +1468,72 @@ BOOST_AUTO_TEST_CASE(KdTreeTest)
   BOOST_REQUIRE_EQUAL(root.TreeDepth(), 7);
 }
 
+// Recursively check that two trees have identical structure, bounds, and
+// point ranges.
+template<typename TreeType>
+void CheckSameStructure(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL((a.Left() == NULL), (b.Left() == NULL));
+  BOOST_REQUIRE_EQUAL((a.Right() == NULL), (b.Right() == NULL));
+
+  for (size_t i = 0; i < a.Bound().Dim(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(a.Bound()[i].Lo(), b.Bound()[i].Lo(), 1e-10);
+    BOOST_REQUIRE_CLOSE(a.Bound()[i].Hi(), b.Bound()[i].Hi(), 1e-10);
+  }
+
+  if (a.Left() != NULL)
+    CheckSameStructure(*a.Left(), *b.Left());
+  if (a.Right() != NULL)
+    CheckSameStructure(*a.Right(), *b.Right());
+}
+
+/**
+ * Ensure that Flatten() preserves the structure of a kd-tree exactly.
+ */
+BOOST_AUTO_TEST_CASE(KdTreeFlattenTest)
+{
+  typedef BinarySpaceTree<HRectBound<2> > TreeType;
+
+  arma::mat dataset(8, 1500);
+  dataset.randu();
+  arma::mat datacopy = dataset;
+
+  // Build two identical trees, then flatten one of them.
+  TreeType root(dataset);
+  TreeType flatRoot(datacopy);
+  flatRoot.Flatten();
+
+  BOOST_REQUIRE_EQUAL(root.TreeSize(), flatRoot.TreeSize());
+  BOOST_REQUIRE_EQUAL(root.TreeDepth(), flatRoot.TreeDepth());
+  CheckSameStructure(root, flatRoot);
+}
+
+/**
+ * Ensure that a kd-tree survives a SaveBinary()/load round trip.
+ */
+BOOST_AUTO_TEST_CASE(KdTreeBinarySaveLoadTest)
+{
+  typedef BinarySpaceTree<HRectBound<2> > TreeType;
+
+  arma::mat dataset(6, 800);
+  dataset.randu();
+
+  TreeType root(dataset);
+  root.SaveBinary("test_tree_binary.bin");
+
+  // The dataset has already been permuted by the build, so it can be handed
+  // to the loading constructor directly.
+  TreeType loaded(dataset, "test_tree_binary.bin");
+  remove("test_tree_binary.bin");
+
+  BOOST_REQUIRE_EQUAL(root.TreeSize(), loaded.TreeSize());
+  BOOST_REQUIRE_EQUAL(root.TreeDepth(), loaded.TreeDepth());
+  CheckSameStructure(root, loaded);
+}
+
 // Recursively checks that each node contains all points that it claims to have.
 template<typename TreeType, typename MatType>
 bool CheckPointBounds(TreeType& node, const MatType& data)
@@ -1394,6 +1606,51 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Build a tree with random projection splits and make sure it is still a
+ * valid binary space tree: the mappings must be correct and every point must
+ * be contained in the bounds of all of its ancestors.  Searches only depend
+ * on the bounds, not on how the points were partitioned, so these two
+ * properties are all that correctness requires of a split policy.
+ */
+BOOST_AUTO_TEST_CASE(RandomProjectionSplitTreeTest)
+{
+  typedef BinarySpaceTree<HRectBound<2>, EmptyStatistic, arma::mat,
+      RandomProjectionSplit<HRectBound<2>, arma::mat> > TreeType;
+
+  for (size_t run = 0; run < 5; run++)
+  {
+    const size_t dimensions = run + 2;
+    const size_t size = (run + 1) * 1000;
+
+    arma::mat dataset(dimensions, size);
+    dataset.randu();
+    arma::mat datacopy = dataset; // Used to test mappings.
+
+    // Mappings for post-build verification of the data.
+    std::vector<size_t> newToOld;
+    std::vector<size_t> oldToNew;
+
+    TreeType root(dataset, newToOld, oldToNew);
+
+    // Ensure the size of the tree is correct.
+    BOOST_REQUIRE_EQUAL(root.NumDescendants(), size);
+
+    // Check the forward and backward mappings for correctness.
+    for (size_t i = 0; i < size; i++)
+    {
+      for (size_t j = 0; j < dimensions; j++)
+      {
+        BOOST_REQUIRE_EQUAL(dataset(j, i), datacopy(j, newToOld[i]));
+        BOOST_REQUIRE_EQUAL(dataset(j, oldToNew[i]), datacopy(j, i));
+      }
+    }
+
+    // Now check that each point is contained inside of all bounds above it.
+    CheckPointBounds(root, dataset);
+  }
+}
+
 template<int t_pow>
 bool DoBoundsIntersect(HRectBound<t_pow>& a,
                        HRectBound<t_pow>& b,
@@ -1783,6 +2040,76 @@ BOOST_AUTO_TEST_CASE(CoverTreeAlternateMetricTest)
   CheckSeparation<CoverTree<LMetric<1, true> >, LMetric<1, true> >(tree, tree);
 }
 
+/**
+ * Make sure the base tuner produces a sane estimate and that a cover tree
+ * built with an automatically chosen base is still a valid cover tree.
+ */
+BOOST_AUTO_TEST_CASE(CoverTreeBaseTunerTest)
+{
+  arma::mat dataset;
+  // 10-dimensional, 500-point dataset.
+  dataset.randu(10, 500);
+
+  // The tuner must select a base in the range it promises, and the estimated
+  // expansion constant of a dataset with more than one distinct point must
+  // exceed 1.
+  LMetric<2, true> metric;
+  BaseTuner<> tuner(dataset, metric);
+  BOOST_REQUIRE_GT(tuner.ExpansionConstant(), 1.0);
+  BOOST_REQUIRE_GE(tuner.Base(), 1.3);
+  BOOST_REQUIRE_LE(tuner.Base(), 2.0);
+  BOOST_REQUIRE_EQUAL(tuner.Samples(), 50);
+
+  // A base of 0.0 asks the constructor to tune the base itself.
+  CoverTree<> tree(dataset, 0.0);
+  BOOST_REQUIRE_GE(tree.Base(), 1.3);
+  BOOST_REQUIRE_LE(tree.Base(), 2.0);
+
+  // Ensure each leaf is only created once.
+  arma::vec counts;
+  counts.zeros(500);
+  RecurseTreeCountLeaves(tree, counts);
+
+  for (size_t i = 0; i < 500; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  // The tree must still satisfy the cover tree invariants under the tuned
+  // base.
+  CheckSelfChild<CoverTree<> >(tree);
+  CheckCovering<CoverTree<>, LMetric<2, true> >(tree);
+  CheckSeparation<CoverTree<>, LMetric<2, true> >(tree, tree);
+}
+
+/**
+ * Make sure the MiddlePointIsRoot policy avoids a far-away outlier as the
+ * root point.
+ */
+BOOST_AUTO_TEST_CASE(CoverTreeMiddlePointIsRootTest)
+{
+  // A tight cluster of 99 points with a distant outlier as the first point.
+  arma::mat dataset(3, 100);
+  dataset.randu();
+  dataset.col(0).fill(500.0);
+
+  CoverTree<LMetric<2, true>, MiddlePointIsRoot> tree(dataset);
+
+  // The outlier has by far the largest maximum distance to the rest of the
+  // dataset, so it must not be chosen as the root.
+  BOOST_REQUIRE_NE(tree.Point(), 0);
+
+  // The tree must still be valid.
+  arma::vec counts;
+  counts.zeros(100);
+  RecurseTreeCountLeaves(tree, counts);
+
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  CheckSelfChild<CoverTree<LMetric<2, true>, MiddlePointIsRoot> >(tree);
+  CheckCovering<CoverTree<LMetric<2, true>, MiddlePointIsRoot>,
+      LMetric<2, true> >(tree);
+}
+
 /**
  * Make sure copy constructor works for the cover tree.
  */
@@ -1997,4 +2324,194 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+/**
+ * Test that MortonOrder() emits a valid permutation, that the reordered
+ * dataset matches it, and that the ordering actually follows the curve: in
+ * one dimension the curve degenerates to a sort, and in two dimensions the
+ * all-low quadrant precedes the all-high quadrant.
+ */
+BOOST_AUTO_TEST_CASE(MortonOrderTest)
+{
+  // One dimension: the Morton order is just ascending order.
+  arma::mat lineData = arma::randu<arma::mat>(1, 150);
+  arma::mat orderedLine;
+  std::vector<size_t> lineMap;
+  MortonOrder(lineData, orderedLine, lineMap);
+
+  for (size_t i = 1; i < orderedLine.n_cols; ++i)
+    BOOST_REQUIRE_LE(orderedLine(0, i - 1), orderedLine(0, i));
+
+  // Two dimensions; anchor the corners so the normalization range is known.
+  arma::mat dataset = arma::randu<arma::mat>(2, 300);
+  dataset.col(0).zeros();
+  dataset.col(1).ones();
+
+  arma::mat ordered;
+  std::vector<size_t> oldFromNew;
+  MortonOrder(dataset, ordered, oldFromNew);
+
+  // The mapping must be a permutation of the column indices.
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), dataset.n_cols);
+  std::vector<size_t> sortedMap(oldFromNew);
+  std::sort(sortedMap.begin(), sortedMap.end());
+  for (size_t i = 0; i < sortedMap.size(); ++i)
+    BOOST_REQUIRE_EQUAL(sortedMap[i], i);
+
+  // The reordered dataset must be the permuted original.
+  BOOST_REQUIRE_EQUAL(ordered.n_cols, dataset.n_cols);
+  for (size_t i = 0; i < ordered.n_cols; ++i)
+  {
+    BOOST_REQUIRE_SMALL(arma::norm(ordered.col(i) -
+        dataset.col(oldFromNew[i]), 2), 1e-15);
+  }
+
+  // Every point entirely inside the low quadrant must precede every point
+  // entirely inside the high quadrant (the curve visits the low quadrant
+  // first); points near the quadrant boundary are skipped to stay clear of
+  // quantization rounding.
+  size_t lastLow = 0;
+  size_t firstHigh = ordered.n_cols;
+  for (size_t i = 0; i < ordered.n_cols; ++i)
+  {
+    if ((ordered(0, i) < 0.4) && (ordered(1, i) < 0.4))
+      lastLow = i;
+    if ((ordered(0, i) > 0.6) && (ordered(1, i) > 0.6) && (firstHigh > i))
+      firstHigh = i;
+  }
+  BOOST_REQUIRE_LT(lastLow, firstHigh);
+}
+
+/**
+ * Build an ExternalBinarySpaceTree from a file with a tiny block size (so the
+ * tree holds many on-disk blocks and the block cache must evict), and check
+ * its k-nearest-neighbor results against brute-force search on the in-memory
+ * dataset.
+ */
+BOOST_AUTO_TEST_CASE(ExternalBinarySpaceTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 300);
+  const std::string datasetFile = "ebst_test_data.csv";
+  data::Save(datasetFile, dataset);
+
+  const size_t k = 3;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  {
+    // Small blocks and a small cache force multiple blocks and evictions.
+    ExternalBinarySpaceTree tree(datasetFile, "ebst_test", 20, 4);
+
+    BOOST_REQUIRE_EQUAL(tree.NumPoints(), dataset.n_cols);
+    BOOST_REQUIRE_EQUAL(tree.Dimensionality(), dataset.n_rows);
+    BOOST_REQUIRE_GT(tree.NumBlocks(), 4);
+
+    arma::mat querySet = arma::randu<arma::mat>(8, 40);
+    tree.Search(querySet, k, neighbors, distances);
+    BOOST_REQUIRE_GT(tree.BlockFaults(), 0);
+
+    // Brute-force nearest neighbors for every query point.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      arma::vec allDistances(dataset.n_cols);
+      for (size_t j = 0; j < dataset.n_cols; ++j)
+      {
+        allDistances[j] = metric::EuclideanDistance::Evaluate(
+            querySet.col(i), dataset.col(j));
+      }
+
+      arma::uvec ordering = arma::sort_index(allDistances);
+      for (size_t n = 0; n < k; ++n)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(n, i), (size_t) ordering[n]);
+        BOOST_REQUIRE_CLOSE(distances(n, i), allDistances[ordering[n]],
+            1e-10);
+      }
+    }
+  }
+
+  // The destructor has run; its block files must be gone.
+  std::ifstream block0("ebst_test.block0");
+  BOOST_REQUIRE(!block0.is_open());
+
+  remove(datasetFile.c_str());
+}
+
+/**
+ * Check that BuildStatistics() reports a consistent shape for a kd-tree, an
+ * R tree, and a cover tree.
+ */
+BOOST_AUTO_TEST_CASE(TreeBuildStatisticsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+
+  // A kd-tree is binary and its leaves partition the dataset.
+  typedef BinarySpaceTree<HRectBound<2> > TreeType;
+  arma::mat dataCopy = dataset;
+  TreeType tree(dataCopy, 20);
+
+  TreeBuildStatistics stats = BuildStatistics(tree);
+
+  BOOST_REQUIRE_EQUAL(stats.points, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(stats.nodes, 2 * stats.leaves - 1);
+  BOOST_REQUIRE_LE(stats.maxLeafSize, 20);
+  BOOST_REQUIRE_GE(stats.minLeafSize, 1);
+  BOOST_REQUIRE_LE(stats.minLeafSize, stats.maxLeafSize);
+  BOOST_REQUIRE_EQUAL(stats.nodesPerLevel.size(), stats.maxDepth + 1);
+
+  // The per-level counts and the occupancy histogram must add up.
+  size_t levelNodes = 0;
+  size_t levelLeaves = 0;
+  for (size_t i = 0; i < stats.nodesPerLevel.size(); ++i)
+  {
+    levelNodes += stats.nodesPerLevel[i];
+    levelLeaves += stats.leavesPerLevel[i];
+  }
+  BOOST_REQUIRE_EQUAL(levelNodes, stats.nodes);
+  BOOST_REQUIRE_EQUAL(levelLeaves, stats.leaves);
+
+  size_t histogramLeaves = 0;
+  size_t histogramPoints = 0;
+  for (size_t i = 0; i < stats.leafSizeCounts.size(); ++i)
+  {
+    histogramLeaves += stats.leafSizeCounts[i];
+    histogramPoints += i * stats.leafSizeCounts[i];
+  }
+  BOOST_REQUIRE_EQUAL(histogramLeaves, stats.leaves);
+  BOOST_REQUIRE_EQUAL(histogramPoints, dataset.n_cols);
+  BOOST_REQUIRE_CLOSE(stats.meanLeafSize,
+      (double) dataset.n_cols / stats.leaves, 1e-10);
+
+  // The kd-tree has axis-aligned bounds, so it has volumes; its children do
+  // not overlap, and its leaf bounds cannot fill more than the unit cube
+  // they were drawn from.
+  BOOST_REQUIRE(stats.haveVolumes);
+  BOOST_REQUIRE_GT(stats.leafVolume, 0.0);
+  BOOST_REQUIRE_LT(stats.leafVolume, 1.0);
+  BOOST_REQUIRE_SMALL(stats.overlapVolume, 1e-10);
+
+  // An R tree usually has overlapping sibling bounds.
+  typedef RectangleTree<
+      RTreeSplit<RTreeDescentHeuristic, EmptyStatistic, arma::mat>,
+      RTreeDescentHeuristic,
+      EmptyStatistic,
+      arma::mat> RTreeType;
+  RTreeType rTree(dataset, 20, 6, 5, 2, 0);
+
+  TreeBuildStatistics rStats = BuildStatistics(rTree);
+  BOOST_REQUIRE_EQUAL(rStats.points, dataset.n_cols);
+  BOOST_REQUIRE(rStats.haveVolumes);
+  BOOST_REQUIRE_GT(rStats.overlapVolume, 0.0);
+
+  // The cover tree has no bounds, so it reports no volumes; every node holds
+  // one point.
+  CoverTree<> coverTree(dataset);
+  TreeBuildStatistics coverStats = BuildStatistics(coverTree);
+  BOOST_REQUIRE_EQUAL(coverStats.points, dataset.n_cols);
+  BOOST_REQUIRE(!coverStats.haveVolumes);
+  BOOST_REQUIRE_EQUAL(coverStats.maxLeafSize, 1);
+
+  // The string representation must render without trouble.
+  BOOST_REQUIRE_GT(stats.ToString().length(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();